@@ -0,0 +1,253 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * AsyncLogDestination.cpp
+ * A LogDestination that writes from a background thread.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include <sstream>
+#include <string>
+
+#include "ola/AsyncLogDestination.h"
+#include "ola/thread/Thread.h"
+
+namespace ola {
+
+using ola::thread::MutexLocker;
+using std::string;
+
+const char AsyncLogDestination::K_LOG_DROPPED_VAR[] = "log-lines-dropped";
+
+/*
+ * The ring is a bounded queue with a sequence number in each slot, see
+ * http://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+ *
+ * A slot is free for the writer at position pos when its sequence is pos, and
+ * holds a line for the reader when its sequence is pos + 1.
+ */
+struct AsyncLogDestination::Slot {
+  uint32_t sequence;
+  log_level level;
+  unsigned int length;
+  char data[MAX_LINE_LENGTH];
+};
+
+class AsyncLogDestination::DrainThread: public ola::thread::Thread {
+ public:
+  explicit DrainThread(AsyncLogDestination *destination)
+      : Thread(Thread::Options("ola-log")),
+        m_destination(destination) {
+  }
+
+  void *Run() {
+    m_destination->Drain();
+    return NULL;
+  }
+
+ private:
+  AsyncLogDestination *m_destination;
+};
+
+AsyncLogDestination::AsyncLogDestination(LogDestination *destination,
+                                         ExportMap *export_map,
+                                         unsigned int capacity)
+    : m_destination(destination),
+      m_dropped_var(NULL),
+      m_thread(NULL),
+      m_slots(NULL),
+      m_mask(0),
+      m_enqueue_pos(0),
+      m_dequeue_pos(0),
+      m_dropped(0),
+      m_drain_waiting(0),
+      m_exit(false) {
+  unsigned int size = 1;
+  while (size < capacity) {
+    size <<= 1;
+  }
+  m_mask = size - 1;
+  m_slots = new Slot[size];
+  for (unsigned int i = 0; i < size; i++) {
+    m_slots[i].sequence = i;
+  }
+  m_line.reserve(MAX_LINE_LENGTH);
+
+  if (export_map) {
+    m_dropped_var = export_map->GetCounterVar(K_LOG_DROPPED_VAR);
+  }
+}
+
+AsyncLogDestination::~AsyncLogDestination() {
+  if (m_thread) {
+    {
+      MutexLocker lock(&m_mutex);
+      m_exit = true;
+      m_condition.Signal();
+    }
+    m_thread->Join();
+    delete m_thread;
+  }
+
+  // Write anything that was added while the thread was stopping.
+  while (Pop()) {}
+  PublishDrops();
+
+  delete[] m_slots;
+  delete m_destination;
+}
+
+bool AsyncLogDestination::Init() {
+  if (m_thread) {
+    return true;
+  }
+
+  m_thread = new DrainThread(this);
+  if (!m_thread->Start()) {
+    delete m_thread;
+    m_thread = NULL;
+    return false;
+  }
+  return true;
+}
+
+void AsyncLogDestination::Write(log_level level, const string &log_line) {
+  if (!Push(level, log_line)) {
+    __sync_fetch_and_add(&m_dropped, 1);
+    return;
+  }
+
+  // Pairs with the barrier in Drain(), either we see the drain thread is
+  // waiting, or it sees the line we just added.
+  __sync_synchronize();
+  if (m_drain_waiting) {
+    MutexLocker lock(&m_mutex);
+    m_condition.Signal();
+  }
+}
+
+/*
+ * Add a line to the ring.
+ * @returns false if the ring was full.
+ */
+bool AsyncLogDestination::Push(log_level level, const string &log_line) {
+  Slot *slot;
+  uint32_t pos = *static_cast<volatile uint32_t*>(&m_enqueue_pos);
+  while (true) {
+    slot = &m_slots[pos & m_mask];
+    uint32_t sequence = __sync_fetch_and_add(&slot->sequence, 0);
+    int32_t diff = static_cast<int32_t>(sequence - pos);
+    if (diff == 0) {
+      uint32_t previous = __sync_val_compare_and_swap(&m_enqueue_pos, pos,
+                                                      pos + 1);
+      if (previous == pos) {
+        break;
+      }
+      pos = previous;
+    } else if (diff < 0) {
+      return false;
+    } else {
+      pos = *static_cast<volatile uint32_t*>(&m_enqueue_pos);
+    }
+  }
+
+  unsigned int length = log_line.size();
+  if (length > MAX_LINE_LENGTH) {
+    length = MAX_LINE_LENGTH;
+  }
+  memcpy(slot->data, log_line.data(), length);
+  if (length == MAX_LINE_LENGTH) {
+    slot->data[length - 1] = '\n';
+  }
+  slot->length = length;
+  slot->level = level;
+
+  __sync_synchronize();
+  slot->sequence = pos + 1;
+  return true;
+}
+
+/*
+ * Write the next line from the ring.
+ * @returns false if the ring was empty.
+ */
+bool AsyncLogDestination::Pop() {
+  if (Empty()) {
+    return false;
+  }
+
+  Slot *slot = &m_slots[m_dequeue_pos & m_mask];
+  __sync_synchronize();
+  m_line.assign(slot->data, slot->length);
+  log_level level = slot->level;
+
+  // Free the slot before the potentially slow write.
+  __sync_synchronize();
+  slot->sequence = m_dequeue_pos + m_mask + 1;
+  m_dequeue_pos++;
+
+  m_destination->Write(level, m_line);
+  return true;
+}
+
+bool AsyncLogDestination::Empty() const {
+  const Slot *slot = &m_slots[m_dequeue_pos & m_mask];
+  uint32_t sequence = *static_cast<const volatile uint32_t*>(&slot->sequence);
+  return sequence != m_dequeue_pos + 1;
+}
+
+/*
+ * Report any lines that were dropped since we last checked.
+ */
+void AsyncLogDestination::PublishDrops() {
+  uint32_t dropped = __sync_fetch_and_and(&m_dropped, 0);
+  if (!dropped) {
+    return;
+  }
+
+  if (m_dropped_var) {
+    (*m_dropped_var) += dropped;
+  }
+
+  std::ostringstream str;
+  str << "The log ring was full, " << dropped << " lines were dropped\n";
+  m_destination->Write(OLA_LOG_WARN, str.str());
+}
+
+/*
+ * The drain thread. Write lines until the ring is empty, then sleep until a
+ * writer wakes us.
+ */
+void AsyncLogDestination::Drain() {
+  while (true) {
+    while (Pop()) {}
+    PublishDrops();
+
+    MutexLocker lock(&m_mutex);
+    if (m_exit) {
+      return;
+    }
+    __sync_lock_test_and_set(&m_drain_waiting, 1);
+    __sync_synchronize();
+    if (Empty()) {
+      m_condition.Wait(&m_mutex);
+    }
+    __sync_lock_test_and_set(&m_drain_waiting, 0);
+  }
+}
+}  // namespace ola
@@ -194,6 +194,7 @@ bool ServerInit(int argc, char *argv[], ExportMap *export_map) {
   if (export_map) {
     InitExportMap(argc, argv, export_map);
   }
+  InitAsyncLoggingFromFlags(export_map);
   return SetThreadScheduling() && NetworkInit();
 }
 
@@ -37,23 +37,95 @@
 #include <syslog.h>
 #endif  // _WIN32
 
+#include <pthread.h>
 #include <unistd.h>
 
 #include <iostream>
+#include <map>
 #include <string>
+#include <utility>
+#include "ola/AsyncLogDestination.h"
+#include "ola/Clock.h"
 #include "ola/Logging.h"
 #include "ola/base/Flags.h"
+#include "ola/thread/Mutex.h"
 
 /**@private*/
 DEFINE_s_int8(log_level, l, ola::OLA_LOG_WARN, "Set the logging level 0 .. 4.");
 /**@private*/
 DEFINE_default_bool(syslog, false, "Send to syslog rather than stderr.");
+/**@private*/
+DEFINE_default_bool(async_log, false,
+                    "Write log lines from a background thread.");
+/**@private*/
+DEFINE_uint16(log_rate_limit, 0,
+              "The maximum number of lines per second from each log "
+              "statement, 0 means no limit.");
 
 namespace ola {
 
+using ola::thread::MutexLocker;
 using std::ostringstream;
 using std::string;
 
+namespace {
+
+/*
+ * Each thread reuses a stream to build log lines, this saves constructing
+ * an ostringstream for every line.
+ */
+struct LogStream {
+  LogStream() : format(NULL), in_use(false) {
+    format.copyfmt(stream);
+  }
+
+  ostringstream stream;
+  std::ios format;  // the initial format flags of the stream
+  bool in_use;
+};
+
+pthread_key_t log_stream_key;
+pthread_once_t log_stream_once = PTHREAD_ONCE_INIT;
+
+void DeleteLogStream(void *stream) {
+  delete static_cast<LogStream*>(stream);
+}
+
+void CreateLogStreamKey() {
+  pthread_key_create(&log_stream_key, DeleteLogStream);
+}
+
+LogStream *ThreadLogStream() {
+  pthread_once(&log_stream_once, CreateLogStreamKey);
+  LogStream *log_stream = static_cast<LogStream*>(
+      pthread_getspecific(log_stream_key));
+  if (!log_stream) {
+    log_stream = new LogStream();
+    pthread_setspecific(log_stream_key, log_stream);
+  }
+  return log_stream;
+}
+
+/*
+ * The state of a rate limited log statement.
+ */
+struct RateLimitState {
+  RateLimitState() : count(0), suppressed(0) {}
+
+  TimeStamp window_start;
+  unsigned int count;
+  unsigned int suppressed;
+};
+
+typedef std::map<std::pair<const char*, int>, RateLimitState> RateLimitMap;
+
+ola::thread::Mutex rate_limit_mutex;
+RateLimitMap rate_limit_states;
+
+// Set while log_target is the destination from InitAsyncLoggingFromFlags().
+AsyncLogDestination *async_log_target = NULL;
+}  // namespace
+
 /**
  * @cond HIDDEN_SYMBOLS
  * @brief pointer to a log target
@@ -61,6 +133,8 @@ using std::string;
 LogDestination *log_target = NULL;
 
 log_level logging_level = OLA_LOG_WARN;
+
+unsigned int log_rate_limit = 0;
 /**@endcond*/
 
 /**
@@ -79,6 +153,13 @@ void IncrementLogLevel() {
 }
 
 
+void SetLogRateLimit(unsigned int lines_per_second) {
+  MutexLocker lock(&rate_limit_mutex);
+  log_rate_limit = lines_per_second;
+  rate_limit_states.clear();
+}
+
+
 bool InitLoggingFromFlags() {
   log_output output = OLA_LOG_NULL;
   if (FLAGS_syslog) {
@@ -110,10 +191,45 @@ bool InitLoggingFromFlags() {
       break;
   }
 
+  SetLogRateLimit(FLAGS_log_rate_limit);
   return InitLogging(log_level, output);
 }
 
 
+void InitAsyncLoggingFromFlags(ExportMap *export_map) {
+  if (!FLAGS_async_log || !log_target) {
+    return;
+  }
+
+  AsyncLogDestination *async_target = new AsyncLogDestination(log_target,
+                                                              export_map);
+  if (!async_target->Init()) {
+    // The AsyncLogDestination owns the old destination and deletes it, so
+    // set up a new one from the flags.
+    log_target = NULL;
+    delete async_target;
+    InitLoggingFromFlags();
+    OLA_WARN << "Failed to start the logging thread";
+    return;
+  }
+  log_target = async_target;
+  async_log_target = async_target;
+}
+
+
+void StopAsyncLogging() {
+  if (!async_log_target) {
+    return;
+  }
+
+  // Deleting the AsyncLogDestination writes out anything left in the ring.
+  const log_level level = logging_level;
+  InitLogging(level, NULL);
+  InitLoggingFromFlags();
+  SetLogLevel(level);
+}
+
+
 bool InitLogging(log_level level, log_output output) {
   LogDestination *destination;
   if (output == OLA_LOG_SYSLOG) {
@@ -143,6 +259,7 @@ void InitLogging(log_level level, LogDestination *destination) {
     delete log_target;
   }
   log_target = destination;
+  async_log_target = NULL;
 }
 
 /**@}*/
@@ -151,23 +268,41 @@ LogLine::LogLine(const char *file,
                  int line,
                  log_level level):
   m_level(level),
-  m_stream(ostringstream::out) {
-    m_stream << file << ":" << line << ": ";
-    m_prefix_length = m_stream.str().length();
+  m_stream(NULL),
+  m_thread_stream(false) {
+    LogStream *log_stream = ThreadLogStream();
+    if (log_stream->in_use) {
+      // An argument to this line is logging itself.
+      m_stream = new ostringstream(ostringstream::out);
+    } else {
+      log_stream->in_use = true;
+      m_stream = &log_stream->stream;
+      m_stream->str("");
+      m_stream->clear();
+      m_stream->copyfmt(log_stream->format);
+      m_thread_stream = true;
+    }
+    *m_stream << file << ":" << line << ": ";
+    m_prefix_length = m_stream->tellp();
 }
 
 LogLine::~LogLine() {
   Write();
+  if (m_thread_stream) {
+    ThreadLogStream()->in_use = false;
+  } else {
+    delete m_stream;
+  }
 }
 
 void LogLine::Write() {
-  if (m_stream.str().length() == m_prefix_length)
+  if (static_cast<unsigned int>(m_stream->tellp()) == m_prefix_length)
     return;
 
   if (m_level > logging_level)
     return;
 
-  string line = m_stream.str();
+  string line = m_stream->str();
 
   if (line.at(line.length() - 1) != '\n')
     line.append("\n");
@@ -175,6 +310,49 @@ void LogLine::Write() {
   if (log_target)
     log_target->Write(m_level, line);
 }
+
+bool LogRateCheck(const char *file, int line, log_level level) {
+  // Avoid the clock and the lock when there is no limit. This is racy, but
+  // the worst case is one line is checked against a stale limit.
+  if (!log_rate_limit) {
+    return true;
+  }
+
+  TimeStamp now;
+  Clock clock;
+  clock.CurrentTime(&now);
+
+  unsigned int suppressed = 0;
+  {
+    MutexLocker lock(&rate_limit_mutex);
+    if (!log_rate_limit) {
+      return true;
+    }
+
+    RateLimitState &state = rate_limit_states[std::make_pair(file, line)];
+    if (!state.window_start.IsSet() ||
+        now - state.window_start >= TimeInterval(1, 0)) {
+      state.window_start = now;
+      state.count = 0;
+      suppressed = state.suppressed;
+      state.suppressed = 0;
+    }
+
+    if (state.count >= log_rate_limit) {
+      state.suppressed++;
+      return false;
+    }
+    state.count++;
+  }
+
+  if (suppressed && log_target) {
+    ostringstream str;
+    str << file << ":" << line << ": " << suppressed
+        << " lines were suppressed by the rate limit\n";
+    log_target->Write(level, str.str());
+  }
+  return true;
+}
 /**@endcond*/
 
 /**
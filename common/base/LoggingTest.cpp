@@ -19,30 +19,49 @@
  */
 
 #include <cppunit/extensions/HelperMacros.h>
+#include <unistd.h>
 #include <deque>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "ola/AsyncLogDestination.h"
+#include "ola/ExportMap.h"
 #include "ola/Logging.h"
 #include "ola/StringUtils.h"
+#include "ola/base/Flags.h"
 #include "ola/testing/TestUtils.h"
+#include "ola/thread/Mutex.h"
 
 
 using std::deque;
 using std::vector;
 using std::string;
+using ola::AsyncLogDestination;
 using ola::IncrementLogLevel;
 using ola::log_level;
+using ola::thread::Mutex;
+using ola::thread::MutexLocker;
 
+DECLARE_bool(async_log);
 
 class LoggingTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(LoggingTest);
   CPPUNIT_TEST(testLogging);
+  CPPUNIT_TEST(testNestedLogging);
+  CPPUNIT_TEST(testRateLimit);
+  CPPUNIT_TEST(testAsyncLogging);
+  CPPUNIT_TEST(testAsyncLoggingDrops);
+  CPPUNIT_TEST(testStopAsyncLogging);
   CPPUNIT_TEST_SUITE_END();
 
  public:
     void testLogging();
+    void testNestedLogging();
+    void testRateLimit();
+    void testAsyncLogging();
+    void testAsyncLoggingDrops();
+    void testStopAsyncLogging();
 };
 
 
@@ -56,6 +75,64 @@ class MockLogDestination: public ola::LogDestination {
 };
 
 
+/*
+ * The lines written to a RecordingLogDestination. This outlives the
+ * destination, which is deleted by the logging system.
+ */
+class LogRecord {
+ public:
+    void Add(const string &log_line) {
+      MutexLocker lock(&m_mutex);
+      m_log_lines.push_back(log_line);
+    }
+
+    vector<string> Lines() {
+      MutexLocker lock(&m_mutex);
+      return m_log_lines;
+    }
+
+ private:
+    Mutex m_mutex;
+    vector<string> m_log_lines;
+};
+
+
+/*
+ * Records the lines written, optionally blocking until it's released.
+ */
+class RecordingLogDestination: public ola::LogDestination {
+ public:
+    explicit RecordingLogDestination(LogRecord *record, Mutex *block = NULL)
+        : m_record(record),
+          m_block(block) {}
+
+    void Write(log_level level, const string &log_line) {
+      if (m_block) {
+        MutexLocker lock(m_block);
+      }
+      m_record->Add(log_line);
+      (void) level;
+    }
+
+ private:
+    LogRecord *m_record;
+    Mutex *m_block;
+};
+
+
+/*
+ * Logs a line when it's written to a stream.
+ */
+struct NestedLogger {
+  int value;
+};
+
+std::ostream& operator<<(std::ostream &out, const NestedLogger &logger) {
+  OLA_WARN << "nested";
+  return out << std::hex << logger.value;
+}
+
+
 CPPUNIT_TEST_SUITE_REGISTRATION(LoggingTest);
 
 
@@ -125,3 +202,155 @@ void LoggingTest::testLogging() {
   OLA_FATAL << "fatal";
   OLA_ASSERT_EQ(destination->LinesRemaining(), 0);
 }
+
+
+/*
+ * Check that a log line can be built while building another line, and that
+ * the stream format doesn't leak into the next line.
+ */
+void LoggingTest::testNestedLogging() {
+  MockLogDestination *destination = new MockLogDestination();
+  InitLogging(ola::OLA_LOG_DEBUG, destination);
+
+  NestedLogger logger = {255};
+  destination->AddExpected(ola::OLA_LOG_WARN, " nested\n");
+  destination->AddExpected(ola::OLA_LOG_WARN, " outer ff\n");
+  OLA_WARN << "outer " << logger;
+  destination->AddExpected(ola::OLA_LOG_WARN, " 255\n");
+  OLA_WARN << 255;
+  OLA_ASSERT_EQ(destination->LinesRemaining(), 0);
+}
+
+
+/*
+ * Check that the rate limit applies to each log statement.
+ */
+void LoggingTest::testRateLimit() {
+  LogRecord record;
+  InitLogging(ola::OLA_LOG_WARN, new RecordingLogDestination(&record));
+  ola::SetLogRateLimit(2);
+
+  for (unsigned int i = 0; i < 10; i++) {
+    OLA_WARN << "first " << i;
+  }
+  OLA_WARN << "second";
+  vector<string> lines = record.Lines();
+  OLA_ASSERT_EQ((size_t) 3, lines.size());
+  OLA_ASSERT_NE(string::npos, lines[0].find("first 0"));
+  OLA_ASSERT_NE(string::npos, lines[1].find("first 1"));
+  OLA_ASSERT_NE(string::npos, lines[2].find("second"));
+
+  ola::SetLogRateLimit(0);
+  for (unsigned int i = 0; i < 10; i++) {
+    OLA_WARN << "third " << i;
+  }
+  OLA_ASSERT_EQ((size_t) 13, record.Lines().size());
+  InitLogging(ola::OLA_LOG_WARN, ola::OLA_LOG_NULL);
+}
+
+
+/*
+ * Check that the AsyncLogDestination writes all lines, in order.
+ */
+void LoggingTest::testAsyncLogging() {
+  LogRecord record;
+  AsyncLogDestination *async_destination = new AsyncLogDestination(
+      new RecordingLogDestination(&record), NULL, 16);
+  OLA_ASSERT_TRUE(async_destination->Init());
+  InitLogging(ola::OLA_LOG_WARN, async_destination);
+
+  for (unsigned int i = 0; i < 10; i++) {
+    OLA_WARN << "line " << i;
+  }
+  OLA_WARN << string(AsyncLogDestination::MAX_LINE_LENGTH + 10, 'x');
+
+  // Wait for the thread to catch up.
+  for (unsigned int i = 0; i < 1000 && record.Lines().size() < 11; i++) {
+    usleep(1000);
+  }
+
+  vector<string> lines = record.Lines();
+  OLA_ASSERT_EQ((size_t) 11, lines.size());
+  for (unsigned int i = 0; i < 10; i++) {
+    OLA_ASSERT_NE(string::npos,
+                  lines[i].find("line " + ola::strings::IntToString(i)));
+  }
+  OLA_ASSERT_EQ((size_t) AsyncLogDestination::MAX_LINE_LENGTH,
+                lines[10].size());
+  OLA_ASSERT_EQ('\n', lines[10][lines[10].size() - 1]);
+  InitLogging(ola::OLA_LOG_WARN, ola::OLA_LOG_NULL);
+}
+
+
+/*
+ * Check that lines are dropped, and counted, when the ring is full.
+ */
+void LoggingTest::testAsyncLoggingDrops() {
+  ola::ExportMap export_map;
+  LogRecord record;
+  Mutex block;
+  AsyncLogDestination *async_destination = new AsyncLogDestination(
+      new RecordingLogDestination(&record, &block), &export_map, 4);
+  OLA_ASSERT_TRUE(async_destination->Init());
+
+  {
+    MutexLocker lock(&block);
+    for (unsigned int i = 0; i < 20; i++) {
+      async_destination->Write(ola::OLA_LOG_WARN, "line\n");
+    }
+  }
+  // This writes the remaining lines.
+  delete async_destination;
+
+  unsigned int dropped = export_map.GetCounterVar(
+      AsyncLogDestination::K_LOG_DROPPED_VAR)->Get();
+  OLA_ASSERT_GTE(dropped, 15u);
+
+  vector<string> lines = record.Lines();
+  unsigned int written = 0;
+  vector<string>::const_iterator iter = lines.begin();
+  for (; iter != lines.end(); ++iter) {
+    if (*iter == "line\n") {
+      written++;
+    }
+  }
+  OLA_ASSERT_EQ(20u, dropped + written);
+  OLA_ASSERT_GT(lines.size(), written);
+}
+
+
+/*
+ * Check that StopAsyncLogging() writes the queued lines.
+ */
+void LoggingTest::testStopAsyncLogging() {
+  LogRecord record;
+  Mutex block;
+  InitLogging(ola::OLA_LOG_INFO, new RecordingLogDestination(&record, &block));
+  FLAGS_async_log = true;
+  ola::InitAsyncLoggingFromFlags(NULL);
+  FLAGS_async_log = false;
+
+  {
+    // Hold up the logging thread so the lines stay in the ring.
+    MutexLocker lock(&block);
+    for (unsigned int i = 0; i < 10; i++) {
+      OLA_INFO << "line " << i;
+    }
+  }
+  ola::StopAsyncLogging();
+
+  // The logging thread may log when it starts, so check the last 10 lines.
+  vector<string> lines = record.Lines();
+  OLA_ASSERT_GTE(lines.size(), (size_t) 10);
+  const unsigned int offset = lines.size() - 10;
+  for (unsigned int i = 0; i < 10; i++) {
+    OLA_ASSERT_NE(
+        string::npos,
+        lines[offset + i].find("line " + ola::strings::IntToString(i)));
+  }
+  OLA_ASSERT_EQ(ola::OLA_LOG_INFO, ola::LogLevel());
+
+  // A second call does nothing.
+  ola::StopAsyncLogging();
+  InitLogging(ola::OLA_LOG_WARN, ola::OLA_LOG_NULL);
+}
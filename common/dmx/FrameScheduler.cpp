@@ -0,0 +1,485 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * FrameScheduler.cpp
+ * Generates the DMX512 frame timing for serial outputs.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <string>
+
+#include "ola/Logging.h"
+#include "ola/dmx/FrameScheduler.h"
+#include "ola/strings/Format.h"
+#include "ola/thread/Utils.h"
+
+namespace ola {
+namespace dmx {
+
+using ola::thread::ConditionVariable;
+using ola::thread::Mutex;
+using ola::thread::MutexLocker;
+using std::string;
+
+const char FrameScheduler::K_FRAME_VAR[] = "serial-dmx-frames";
+const char FrameScheduler::K_JITTER_VAR_PREFIX[] = "serial-dmx-jitter-";
+
+namespace {
+
+// The upper bound of each jitter bucket in microseconds. Later frames are
+// counted in the last bucket.
+const unsigned int JITTER_BUCKETS[] = {
+  50, 100, 250, 500, 1000, 2500, 5000, 10000
+};
+const unsigned int JITTER_BUCKET_COUNT =
+    sizeof(JITTER_BUCKETS) / sizeof(JITTER_BUCKETS[0]) + 1;
+
+// Each slot is 11 bits at 250kbps.
+const unsigned int SLOT_TIME = 44;
+}  // namespace
+
+/*
+ * Writes the data for a port, so that a blocking write doesn't hold up the
+ * break and mark after break of the other ports.
+ */
+class FrameScheduler::PortWriter: public ola::thread::Thread {
+ public:
+  explicit PortWriter(SerialDmxOutput *output)
+      : Thread(Thread::Options("serial-dmx-write")),
+        m_output(output),
+        m_pending(false),
+        m_finished(false),
+        m_ok(false),
+        m_end(0),
+        m_exit(false) {
+  }
+
+  /*
+   * Stop the thread, once any write in progress has finished.
+   */
+  bool Stop() {
+    if (!IsRunning()) {
+      return true;
+    }
+
+    {
+      MutexLocker lock(&m_mutex);
+      m_exit = true;
+    }
+    m_condition.Signal();
+    return Join();
+  }
+
+  /*
+   * Start writing a frame. The previous write must have finished.
+   */
+  void Write(const DmxBuffer &frame) {
+    if (!IsRunning()) {
+      // The thread failed to start, so write from the calling thread.
+      bool ok = m_output->Write(frame);
+      MutexLocker lock(&m_mutex);
+      m_finished = true;
+      m_ok = ok;
+      m_end = FrameScheduler::Now();
+      return;
+    }
+
+    {
+      MutexLocker lock(&m_mutex);
+      m_frame.Set(frame);
+      m_pending = true;
+      m_finished = false;
+    }
+    m_condition.Signal();
+  }
+
+  /*
+   * Check if the last write has finished.
+   * @param ok set to the result of the write.
+   * @param end set to the time the write returned.
+   * @returns true if the write has finished.
+   */
+  bool Finished(bool *ok, int64_t *end) {
+    MutexLocker lock(&m_mutex);
+    if (!m_finished) {
+      return false;
+    }
+    *ok = m_ok;
+    *end = m_end;
+    return true;
+  }
+
+  void *Run() {
+    MutexLocker lock(&m_mutex);
+    while (true) {
+      while (!m_pending && !m_exit) {
+        m_condition.Wait(&m_mutex);
+      }
+      if (m_exit) {
+        break;
+      }
+
+      // Write() isn't called again until this one has finished, so the frame
+      // can be used without the lock.
+      m_mutex.Unlock();
+      bool ok = m_output->Write(m_frame);
+      int64_t end = FrameScheduler::Now();
+      m_mutex.Lock();
+
+      m_pending = false;
+      m_finished = true;
+      m_ok = ok;
+      m_end = end;
+    }
+    return NULL;
+  }
+
+ private:
+  SerialDmxOutput *m_output;
+  Mutex m_mutex;
+  ConditionVariable m_condition;
+  DmxBuffer m_frame;
+  bool m_pending;
+  bool m_finished;
+  bool m_ok;
+  int64_t m_end;
+  bool m_exit;
+
+  DISALLOW_COPY_AND_ASSIGN(PortWriter);
+};
+
+/*
+ * The state of a port. The fields other than the buffer are only used by the
+ * scheduler thread, with m_mutex held.
+ */
+class FrameScheduler::Port {
+ public:
+  enum State {
+    WAITING_FOR_DATA,
+    FRAME_START,
+    BREAK_END,
+    MAB_END,
+    WRITING
+  };
+
+  Port(SerialDmxOutput *output, const PortOptions &options)
+      : output(output),
+        writer(output),
+        options(options),
+        frame_interval(options.refresh_rate ?
+                       1000000 / options.refresh_rate : 0),
+        has_data(false),
+        state(WAITING_FOR_DATA),
+        frame_start(0),
+        deadline(0),
+        frame_count(NULL) {
+    for (unsigned int i = 0; i < JITTER_BUCKET_COUNT; i++) {
+      jitter[i] = NULL;
+    }
+  }
+
+  SerialDmxOutput *output;
+  PortWriter writer;
+  const PortOptions options;
+  const int64_t frame_interval;
+
+  ola::thread::Mutex buffer_mutex;
+  DmxBuffer buffer;
+  bool has_data;
+
+  DmxBuffer frame;
+  State state;
+  int64_t frame_start;
+  int64_t deadline;
+
+  unsigned int *frame_count;
+  unsigned int *jitter[JITTER_BUCKET_COUNT];
+};
+
+FrameScheduler::FrameScheduler(const Options &options, ExportMap *export_map)
+    : Thread(Thread::Options("serial-dmx")),
+      m_options(options),
+      m_export_map(export_map),
+      m_exit(false) {
+}
+
+FrameScheduler::~FrameScheduler() {
+  Stop();
+  if (!m_ports.empty()) {
+    OLA_WARN << m_ports.size() << " ports remain in the FrameScheduler";
+  }
+}
+
+bool FrameScheduler::Stop() {
+  if (!IsRunning()) {
+    return true;
+  }
+
+  {
+    MutexLocker lock(&m_mutex);
+    m_exit = true;
+  }
+  return Join();
+}
+
+FrameScheduler::Port *FrameScheduler::AddPort(SerialDmxOutput *output,
+                                              const PortOptions &options) {
+  Port *port = new Port(output, options);
+
+  if (m_export_map) {
+    port->frame_count = m_export_map->GetUIntMapVar(
+        K_FRAME_VAR, "port")->Handle(options.name);
+    UIntMap *jitter_map = m_export_map->GetUIntMapVar(
+        K_JITTER_VAR_PREFIX + options.name, "us");
+    for (unsigned int i = 0; i < JITTER_BUCKET_COUNT; i++) {
+      string key = i < JITTER_BUCKET_COUNT - 1 ?
+          ola::strings::IntToString(JITTER_BUCKETS[i]) : "max";
+      port->jitter[i] = jitter_map->Handle(key);
+    }
+  }
+
+  if (!port->writer.Start()) {
+    OLA_WARN << "Failed to start the writer thread for " << options.name
+             << ", writes will block the other ports";
+  }
+
+  MutexLocker lock(&m_mutex);
+  m_ports.push_back(port);
+  return port;
+}
+
+void FrameScheduler::RemovePort(Port *port) {
+  {
+    MutexLocker lock(&m_mutex);
+    PortList::iterator iter = std::find(m_ports.begin(), m_ports.end(), port);
+    if (iter == m_ports.end()) {
+      OLA_WARN << "Port " << port << " isn't in the FrameScheduler";
+      return;
+    }
+    m_ports.erase(iter);
+
+    // The thread holds m_mutex while it uses the output, so it's idle. Don't
+    // leave the line in the break.
+    if (port->state == Port::BREAK_END) {
+      port->output->SetBreak(false);
+    }
+  }
+  port->writer.Stop();
+
+  // Count a frame which finished while we waited.
+  bool ok;
+  int64_t write_end;
+  if (port->state == Port::WRITING &&
+      port->writer.Finished(&ok, &write_end) && ok && port->frame_count) {
+    (*port->frame_count)++;
+  }
+  delete port;
+}
+
+void FrameScheduler::WriteDMX(Port *port, const DmxBuffer &buffer) {
+  MutexLocker lock(&port->buffer_mutex);
+  port->buffer.Set(buffer);
+  port->has_data = true;
+}
+
+void *FrameScheduler::Run() {
+  ConfigureThread();
+
+  while (true) {
+    int64_t deadline;
+    {
+      MutexLocker lock(&m_mutex);
+      if (m_exit) {
+        break;
+      }
+
+      int64_t now = Now();
+      deadline = now + MAX_SLEEP;
+      PortList::iterator iter = m_ports.begin();
+      for (; iter != m_ports.end(); ++iter) {
+        Port *port = *iter;
+        if (port->state == Port::WAITING_FOR_DATA) {
+          MutexLocker buffer_lock(&port->buffer_mutex);
+          if (!port->has_data) {
+            continue;
+          }
+          port->state = Port::FRAME_START;
+          port->frame_start = now;
+          port->deadline = now;
+        }
+
+        if (port->deadline <= now) {
+          RunEvent(port, now);
+          now = Now();
+        }
+        deadline = std::min(deadline, port->deadline);
+      }
+    }
+    SleepUntil(deadline);
+  }
+  return NULL;
+}
+
+/*
+ * Apply the scheduling options to the current thread.
+ */
+void FrameScheduler::ConfigureThread() {
+  if (m_options.realtime_priority) {
+    struct sched_param param;
+    param.sched_priority = m_options.realtime_priority;
+    if (!ola::thread::SetSchedParam(pthread_self(), SCHED_FIFO, param)) {
+      OLA_WARN << "Serial DMX frames will use the default scheduling policy";
+    }
+  }
+
+  if (m_options.cpu >= 0) {
+#ifdef HAVE_PTHREAD_SETAFFINITY_NP
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(m_options.cpu, &cpu_set);
+    int r = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+    if (r) {
+      OLA_WARN << "Failed to run the serial DMX thread on CPU "
+               << m_options.cpu << ": " << strerror(r);
+    }
+#else
+    OLA_WARN << "CPU affinity isn't supported on this platform";
+#endif  // HAVE_PTHREAD_SETAFFINITY_NP
+  }
+}
+
+/*
+ * Move a port to the next part of the frame.
+ */
+void FrameScheduler::RunEvent(Port *port, int64_t now) {
+  int64_t write_end = now;
+  switch (port->state) {
+    case Port::FRAME_START:
+      {
+        int64_t lateness = now - port->deadline;
+        unsigned int bucket = 0;
+        while (bucket < JITTER_BUCKET_COUNT - 1 &&
+               lateness > JITTER_BUCKETS[bucket]) {
+          bucket++;
+        }
+        if (port->jitter[bucket]) {
+          (*port->jitter[bucket])++;
+        }
+      }
+      port->frame_start = port->deadline;
+      // The break and MAB times are minimums, so they're measured from when
+      // the line changed rather than from when the event was due.
+      if (port->output->SetBreak(true)) {
+        port->state = Port::BREAK_END;
+        port->deadline = Now() + port->options.break_time;
+        return;
+      }
+      break;
+    case Port::BREAK_END:
+      if (port->output->SetBreak(false)) {
+        port->state = Port::MAB_END;
+        port->deadline = Now() + port->options.mab_time;
+        return;
+      }
+      break;
+    case Port::MAB_END:
+      {
+        MutexLocker buffer_lock(&port->buffer_mutex);
+        port->frame.Set(port->buffer);
+      }
+      port->writer.Write(port->frame);
+      port->state = Port::WRITING;
+      // The next frame can't start before the data has been sent, so there's
+      // no need to check on the write until then.
+      port->deadline = std::max(
+          port->frame_start + port->frame_interval,
+          Now() + (port->frame.Size() + 1) * SLOT_TIME +
+          port->options.mark_after_frame);
+      return;
+    case Port::WRITING:
+      {
+        bool ok;
+        if (!port->writer.Finished(&ok, &write_end)) {
+          port->deadline = now + WRITE_POLL_INTERVAL;
+          return;
+        }
+        if (ok && port->frame_count) {
+          (*port->frame_count)++;
+        }
+      }
+      break;
+    case Port::WAITING_FOR_DATA:
+      return;
+  }
+
+  // The frame is complete, or failed. The next frame starts once the data
+  // has been sent, and not before the next refresh period.
+  int64_t data_end = write_end + (port->frame.Size() + 1) * SLOT_TIME;
+  int64_t next_start = std::max(
+      port->frame_start + port->frame_interval,
+      data_end + port->options.mark_after_frame);
+  port->state = Port::FRAME_START;
+  port->deadline = next_start;
+}
+
+/*
+ * The current time in microseconds.
+ */
+int64_t FrameScheduler::Now() {
+#ifdef HAVE_CLOCK_NANOSLEEP
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return static_cast<int64_t>(now.tv_sec) * 1000000 + now.tv_nsec / 1000;
+#else
+  struct timeval now;
+  gettimeofday(&now, NULL);
+  return static_cast<int64_t>(now.tv_sec) * 1000000 + now.tv_usec;
+#endif  // HAVE_CLOCK_NANOSLEEP
+}
+
+/*
+ * Sleep until the deadline, a time returned by Now().
+ */
+void FrameScheduler::SleepUntil(int64_t deadline) {
+#ifdef HAVE_CLOCK_NANOSLEEP
+  struct timespec wake_up;
+  wake_up.tv_sec = deadline / 1000000;
+  wake_up.tv_nsec = (deadline % 1000000) * 1000;
+  while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wake_up, NULL) ==
+         EINTR) {
+  }
+#else
+  int64_t delay = deadline - Now();
+  if (delay > 0) {
+    usleep(delay);
+  }
+#endif  // HAVE_CLOCK_NANOSLEEP
+}
+}  // namespace dmx
+}  // namespace ola
@@ -0,0 +1,378 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * FrameSchedulerTest.cpp
+ * Test fixture for the FrameScheduler class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+
+#include "ola/Clock.h"
+#include "ola/DmxBuffer.h"
+#include "ola/ExportMap.h"
+#include "ola/dmx/FrameScheduler.h"
+#include "ola/testing/TestUtils.h"
+#include "ola/thread/Mutex.h"
+
+using ola::Clock;
+using ola::DmxBuffer;
+using ola::ExportMap;
+using ola::TimeInterval;
+using ola::TimeStamp;
+using ola::UIntMap;
+using ola::dmx::FrameScheduler;
+using ola::dmx::SerialDmxOutput;
+using ola::thread::ConditionVariable;
+using ola::thread::Mutex;
+using ola::thread::MutexLocker;
+using std::string;
+using std::vector;
+
+/*
+ * Records the time of each call, and lets the test wait for them.
+ */
+class MockSerialOutput: public SerialDmxOutput {
+ public:
+  enum EventType {
+    BREAK_ON,
+    BREAK_OFF,
+    WRITE
+  };
+
+  struct Event {
+    EventType type;
+    TimeStamp time;
+    unsigned int size;
+  };
+
+  /*
+   * @param write_delay how long each write blocks for, in microseconds.
+   */
+  explicit MockSerialOutput(unsigned int write_delay = 0)
+      : m_write_delay(write_delay) {
+  }
+
+  bool SetBreak(bool on) {
+    AddEvent(on ? BREAK_ON : BREAK_OFF, 0);
+    return true;
+  }
+
+  bool Write(const DmxBuffer &buffer) {
+    AddEvent(WRITE, buffer.Size());
+    if (m_write_delay) {
+      usleep(m_write_delay);
+    }
+    return true;
+  }
+
+  void Events(vector<Event> *events) {
+    MutexLocker lock(&m_mutex);
+    *events = m_events;
+  }
+
+  unsigned int EventCount() {
+    MutexLocker lock(&m_mutex);
+    return m_events.size();
+  }
+
+  /*
+   * Wait until there have been at least count calls.
+   * @returns false if this took more than 5 seconds.
+   */
+  bool WaitForEvents(unsigned int count) {
+    TimeStamp wake_up;
+    m_clock.CurrentTime(&wake_up);
+    wake_up += TimeInterval(5, 0);
+
+    MutexLocker lock(&m_mutex);
+    while (m_events.size() < count) {
+      if (!m_condition.TimedWait(&m_mutex, wake_up)) {
+        return m_events.size() >= count;
+      }
+    }
+    return true;
+  }
+
+ private:
+  const unsigned int m_write_delay;
+  Clock m_clock;
+  Mutex m_mutex;
+  ConditionVariable m_condition;
+  vector<Event> m_events;
+
+  void AddEvent(EventType type, unsigned int size) {
+    Event event;
+    event.type = type;
+    event.size = size;
+    m_clock.CurrentTime(&event.time);
+    MutexLocker lock(&m_mutex);
+    m_events.push_back(event);
+    m_condition.Broadcast();
+  }
+};
+
+
+class FrameSchedulerTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(FrameSchedulerTest);
+  CPPUNIT_TEST(testFrameTiming);
+  CPPUNIT_TEST(testRefreshRate);
+  CPPUNIT_TEST(testExportMap);
+  CPPUNIT_TEST(testRemovePort);
+  CPPUNIT_TEST(testRemovePortInBreak);
+  CPPUNIT_TEST(testSlowWrite);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    void testFrameTiming();
+    void testRefreshRate();
+    void testExportMap();
+    void testRemovePort();
+    void testRemovePortInBreak();
+    void testSlowWrite();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(FrameSchedulerTest);
+
+
+/*
+ * Check that each frame is a break, mark after break and then the data.
+ */
+void FrameSchedulerTest::testFrameTiming() {
+  FrameScheduler scheduler(FrameScheduler::Options(), NULL);
+  OLA_ASSERT_TRUE(scheduler.Start());
+
+  MockSerialOutput output, idle_output;
+  FrameScheduler::PortOptions options;
+  options.name = "test";
+  options.break_time = 200;
+  options.mab_time = 50;
+  options.mark_after_frame = 1000;
+  FrameScheduler::Port *port = scheduler.AddPort(&output, options);
+  options.name = "idle";
+  FrameScheduler::Port *idle_port = scheduler.AddPort(&idle_output, options);
+
+  DmxBuffer buffer;
+  buffer.SetFromString("1,2,3,4");
+  scheduler.WriteDMX(port, buffer);
+  OLA_ASSERT_TRUE(output.WaitForEvents(9));
+  scheduler.RemovePort(port);
+
+  // The scheduler ran while the frames were sent, but nothing is sent on a
+  // port until it has data.
+  scheduler.RemovePort(idle_port);
+  OLA_ASSERT_EQ(0u, idle_output.EventCount());
+  OLA_ASSERT_TRUE(scheduler.Stop());
+
+  vector<MockSerialOutput::Event> events;
+  output.Events(&events);
+  OLA_ASSERT_GTE(events.size(), 9u);
+
+  for (unsigned int i = 0; i + 2 < events.size(); i += 3) {
+    OLA_ASSERT_EQ(MockSerialOutput::BREAK_ON, events[i].type);
+    OLA_ASSERT_EQ(MockSerialOutput::BREAK_OFF, events[i + 1].type);
+    OLA_ASSERT_EQ(MockSerialOutput::WRITE, events[i + 2].type);
+    OLA_ASSERT_EQ(4u, events[i + 2].size);
+
+    OLA_ASSERT_GTE((events[i + 1].time - events[i].time).AsInt(),
+                   200);
+    OLA_ASSERT_GTE((events[i + 2].time - events[i + 1].time).AsInt(),
+                   50);
+    if (i + 3 < events.size()) {
+      // 5 slots at 44uS each, then the mark after frame.
+      OLA_ASSERT_GTE(
+          (events[i + 3].time - events[i + 2].time).AsInt(),
+          1220);
+    }
+  }
+}
+
+
+/*
+ * Check the refresh rate limits the frames per second.
+ */
+void FrameSchedulerTest::testRefreshRate() {
+  FrameScheduler scheduler(FrameScheduler::Options(), NULL);
+  OLA_ASSERT_TRUE(scheduler.Start());
+
+  MockSerialOutput output;
+  FrameScheduler::PortOptions options;
+  options.name = "test";
+  options.refresh_rate = 50;
+  FrameScheduler::Port *port = scheduler.AddPort(&output, options);
+
+  DmxBuffer buffer;
+  buffer.Blackout();
+  scheduler.WriteDMX(port, buffer);
+  OLA_ASSERT_TRUE(output.WaitForEvents(12));
+  scheduler.RemovePort(port);
+
+  vector<MockSerialOutput::Event> events;
+  output.Events(&events);
+  OLA_ASSERT_GTE(events.size(), 12u);
+
+  // The frames start every 20ms. Since the deadlines are absolute the frame
+  // starts don't drift, so check the spacing over three frames.
+  for (unsigned int i = 0; i + 3 < events.size(); i += 3) {
+    OLA_ASSERT_EQ(MockSerialOutput::BREAK_ON, events[i + 3].type);
+    OLA_ASSERT_GTE(
+        (events[i + 3].time - events[i].time).AsInt(), 19000);
+  }
+  OLA_ASSERT_GTE((events[9].time - events[0].time).AsInt(), 59000);
+}
+
+
+/*
+ * Check the frame count and jitter histogram are published.
+ */
+void FrameSchedulerTest::testExportMap() {
+  ExportMap export_map;
+  FrameScheduler scheduler(FrameScheduler::Options(), &export_map);
+  OLA_ASSERT_TRUE(scheduler.Start());
+
+  MockSerialOutput output;
+  FrameScheduler::PortOptions options;
+  options.name = "port-1";
+  FrameScheduler::Port *port = scheduler.AddPort(&output, options);
+
+  DmxBuffer buffer;
+  buffer.SetFromString("0,255");
+  scheduler.WriteDMX(port, buffer);
+  OLA_ASSERT_TRUE(output.WaitForEvents(30));
+  scheduler.RemovePort(port);
+  OLA_ASSERT_TRUE(scheduler.Stop());
+
+  unsigned int frames = output.EventCount() / 3;
+  UIntMap *frame_var = export_map.GetUIntMapVar(
+      FrameScheduler::K_FRAME_VAR);
+  OLA_ASSERT_EQ(frames, (*frame_var)["port-1"]);
+
+  // Every frame that started is in one of the buckets.
+  UIntMap *jitter_var = export_map.GetUIntMapVar(
+      string(FrameScheduler::K_JITTER_VAR_PREFIX) + "port-1");
+  const char *buckets[] = {
+    "50", "100", "250", "500", "1000", "2500", "5000", "10000", "max"
+  };
+  unsigned int started = 0;
+  for (unsigned int i = 0; i < sizeof(buckets) / sizeof(buckets[0]); i++) {
+    started += (*jitter_var)[buckets[i]];
+  }
+  OLA_ASSERT_EQ((output.EventCount() + 2) / 3, started);
+}
+
+
+/*
+ * Check a port isn't used once it's removed, and the other ports keep
+ * running.
+ */
+void FrameSchedulerTest::testRemovePort() {
+  FrameScheduler scheduler(FrameScheduler::Options(), NULL);
+  OLA_ASSERT_TRUE(scheduler.Start());
+
+  MockSerialOutput output1, output2;
+  FrameScheduler::PortOptions options;
+  options.name = "port-1";
+  FrameScheduler::Port *port1 = scheduler.AddPort(&output1, options);
+  options.name = "port-2";
+  FrameScheduler::Port *port2 = scheduler.AddPort(&output2, options);
+
+  DmxBuffer buffer;
+  buffer.SetFromString("1,2,3");
+  scheduler.WriteDMX(port1, buffer);
+  scheduler.WriteDMX(port2, buffer);
+  OLA_ASSERT_TRUE(output1.WaitForEvents(6));
+  OLA_ASSERT_TRUE(output2.WaitForEvents(6));
+
+  scheduler.RemovePort(port1);
+  unsigned int removed_count = output1.EventCount();
+  unsigned int count = output2.EventCount();
+  OLA_ASSERT_TRUE(output2.WaitForEvents(count + 6));
+  OLA_ASSERT_EQ(removed_count, output1.EventCount());
+
+  scheduler.RemovePort(port2);
+  OLA_ASSERT_TRUE(scheduler.Stop());
+}
+
+
+/*
+ * Check that removing a port during the break ends the break.
+ */
+void FrameSchedulerTest::testRemovePortInBreak() {
+  FrameScheduler scheduler(FrameScheduler::Options(), NULL);
+  OLA_ASSERT_TRUE(scheduler.Start());
+
+  MockSerialOutput output;
+  FrameScheduler::PortOptions options;
+  options.name = "test";
+  // Long enough that the port is still in the break when it's removed.
+  options.break_time = 60000000;
+  FrameScheduler::Port *port = scheduler.AddPort(&output, options);
+
+  DmxBuffer buffer;
+  buffer.SetFromString("1,2,3");
+  scheduler.WriteDMX(port, buffer);
+  OLA_ASSERT_TRUE(output.WaitForEvents(1));
+  scheduler.RemovePort(port);
+  OLA_ASSERT_TRUE(scheduler.Stop());
+
+  vector<MockSerialOutput::Event> events;
+  output.Events(&events);
+  OLA_ASSERT_EQ((size_t) 2, events.size());
+  OLA_ASSERT_EQ(MockSerialOutput::BREAK_ON, events[0].type);
+  OLA_ASSERT_EQ(MockSerialOutput::BREAK_OFF, events[1].type);
+}
+
+
+/*
+ * Check that a write which blocks doesn't hold up the frames on other ports.
+ */
+void FrameSchedulerTest::testSlowWrite() {
+  FrameScheduler scheduler(FrameScheduler::Options(), NULL);
+  OLA_ASSERT_TRUE(scheduler.Start());
+
+  // Roughly the time a full frame takes to write to an FTDI device.
+  MockSerialOutput slow_output(50000), output;
+  FrameScheduler::PortOptions options;
+  options.name = "slow";
+  FrameScheduler::Port *slow_port = scheduler.AddPort(&slow_output, options);
+  options.name = "fast";
+  FrameScheduler::Port *port = scheduler.AddPort(&output, options);
+
+  DmxBuffer buffer;
+  buffer.SetFromString("1,2,3");
+  scheduler.WriteDMX(slow_port, buffer);
+  OLA_ASSERT_TRUE(slow_output.WaitForEvents(3));
+  scheduler.WriteDMX(port, buffer);
+
+  // The next break on the slow port comes after the write returns. By then
+  // the other port has sent many frames.
+  OLA_ASSERT_TRUE(slow_output.WaitForEvents(4));
+  OLA_ASSERT_GTE(output.EventCount(), 30u);
+
+  scheduler.RemovePort(port);
+  scheduler.RemovePort(slow_port);
+  OLA_ASSERT_TRUE(scheduler.Stop());
+
+  // The slow port's frames still follow the write.
+  vector<MockSerialOutput::Event> events;
+  slow_output.Events(&events);
+  OLA_ASSERT_EQ(MockSerialOutput::WRITE, events[2].type);
+  OLA_ASSERT_EQ(MockSerialOutput::BREAK_ON, events[3].type);
+  OLA_ASSERT_GTE((events[3].time - events[2].time).AsInt(), 50000);
+}
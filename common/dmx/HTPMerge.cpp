@@ -0,0 +1,236 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * HTPMerge.cpp
+ * N-way HTP merge kernels.
+ * Copyright (C) 2026 Simon Newton
+ *
+ * Each kernel walks the output once, loading the same block from every
+ * source and keeping the running maximum in a register. This touches each
+ * source slot exactly once, rather than the read-modify-write of the output
+ * per source that pairwise merging requires.
+ */
+
+#include <string.h>
+#include "ola/dmx/HTPMerge.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define OLA_HTP_MERGE_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define OLA_HTP_MERGE_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace ola {
+namespace dmx {
+
+namespace {
+
+typedef void (*MergeFunction)(const uint8_t *const *sources,
+                              unsigned int source_count,
+                              unsigned int length,
+                              uint8_t *output);
+
+/*
+ * Merge the slots in the range [offset, length).
+ */
+void ScalarMerge(const uint8_t *const *sources,
+                 unsigned int source_count,
+                 unsigned int offset,
+                 unsigned int length,
+                 uint8_t *output) {
+  for (unsigned int i = offset; i < length; i++) {
+    uint8_t value = sources[0][i];
+    for (unsigned int j = 1; j < source_count; j++) {
+      if (sources[j][i] > value) {
+        value = sources[j][i];
+      }
+    }
+    output[i] = value;
+  }
+}
+
+void ScalarKernel(const uint8_t *const *sources,
+                  unsigned int source_count,
+                  unsigned int length,
+                  uint8_t *output) {
+  ScalarMerge(sources, source_count, 0, length, output);
+}
+
+#ifdef OLA_HTP_MERGE_X86
+__attribute__((target("sse2")))
+void SSE2Kernel(const uint8_t *const *sources,
+                unsigned int source_count,
+                unsigned int length,
+                uint8_t *output) {
+  static const unsigned int WIDTH = sizeof(__m128i);
+  unsigned int i = 0;
+  for (; i + WIDTH <= length; i += WIDTH) {
+    __m128i value = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(sources[0] + i));
+    for (unsigned int j = 1; j < source_count; j++) {
+      value = _mm_max_epu8(
+          value,
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(sources[j] + i)));
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), value);
+  }
+  ScalarMerge(sources, source_count, i, length, output);
+}
+
+__attribute__((target("avx2")))
+void AVX2Kernel(const uint8_t *const *sources,
+                unsigned int source_count,
+                unsigned int length,
+                uint8_t *output) {
+  static const unsigned int WIDTH = sizeof(__m256i);
+  unsigned int i = 0;
+  for (; i + WIDTH <= length; i += WIDTH) {
+    __m256i value = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i*>(sources[0] + i));
+    for (unsigned int j = 1; j < source_count; j++) {
+      value = _mm256_max_epu8(
+          value,
+          _mm256_loadu_si256(
+              reinterpret_cast<const __m256i*>(sources[j] + i)));
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + i), value);
+  }
+  ScalarMerge(sources, source_count, i, length, output);
+}
+#endif  // OLA_HTP_MERGE_X86
+
+#ifdef OLA_HTP_MERGE_NEON
+void NEONKernel(const uint8_t *const *sources,
+                unsigned int source_count,
+                unsigned int length,
+                uint8_t *output) {
+  static const unsigned int WIDTH = sizeof(uint8x16_t);
+  unsigned int i = 0;
+  for (; i + WIDTH <= length; i += WIDTH) {
+    uint8x16_t value = vld1q_u8(sources[0] + i);
+    for (unsigned int j = 1; j < source_count; j++) {
+      value = vmaxq_u8(value, vld1q_u8(sources[j] + i));
+    }
+    vst1q_u8(output + i, value);
+  }
+  ScalarMerge(sources, source_count, i, length, output);
+}
+#endif  // OLA_HTP_MERGE_NEON
+
+MergeFunction KernelFunction(HTPMergeKernel kernel) {
+  switch (kernel) {
+#ifdef OLA_HTP_MERGE_X86
+    case HTP_MERGE_SSE2:
+      return SSE2Kernel;
+    case HTP_MERGE_AVX2:
+      return AVX2Kernel;
+#endif  // OLA_HTP_MERGE_X86
+#ifdef OLA_HTP_MERGE_NEON
+    case HTP_MERGE_NEON:
+      return NEONKernel;
+#endif  // OLA_HTP_MERGE_NEON
+    default:
+      return ScalarKernel;
+  }
+}
+
+HTPMergeKernel SelectKernel() {
+  const HTPMergeKernel preferred[] = {
+    HTP_MERGE_AVX2, HTP_MERGE_SSE2, HTP_MERGE_NEON
+  };
+  for (unsigned int i = 0; i < sizeof(preferred) / sizeof(preferred[0]);
+       i++) {
+    if (HTPMergeKernelSupported(preferred[i])) {
+      return preferred[i];
+    }
+  }
+  return HTP_MERGE_SCALAR;
+}
+}  // namespace
+
+
+void HTPMergeSlots(const uint8_t *const *sources,
+                   unsigned int source_count,
+                   unsigned int length,
+                   uint8_t *output) {
+  static const MergeFunction merge = KernelFunction(ActiveHTPMergeKernel());
+  if (source_count == 1) {
+    if (sources[0] != output) {
+      memcpy(output, sources[0], length);
+    }
+  } else if (source_count) {
+    merge(sources, source_count, length, output);
+  }
+}
+
+
+void HTPMergeSlotsWithKernel(HTPMergeKernel kernel,
+                             const uint8_t *const *sources,
+                             unsigned int source_count,
+                             unsigned int length,
+                             uint8_t *output) {
+  if (!source_count || !length) {
+    return;
+  }
+  KernelFunction(kernel)(sources, source_count, length, output);
+}
+
+
+bool HTPMergeKernelSupported(HTPMergeKernel kernel) {
+  switch (kernel) {
+    case HTP_MERGE_SCALAR:
+      return true;
+#ifdef OLA_HTP_MERGE_X86
+    case HTP_MERGE_SSE2:
+      return __builtin_cpu_supports("sse2");
+    case HTP_MERGE_AVX2:
+      return __builtin_cpu_supports("avx2");
+#endif  // OLA_HTP_MERGE_X86
+#ifdef OLA_HTP_MERGE_NEON
+    case HTP_MERGE_NEON:
+      return true;
+#endif  // OLA_HTP_MERGE_NEON
+    default:
+      return false;
+  }
+}
+
+
+HTPMergeKernel ActiveHTPMergeKernel() {
+  static const HTPMergeKernel kernel = SelectKernel();
+  return kernel;
+}
+
+
+const char *HTPMergeKernelName(HTPMergeKernel kernel) {
+  switch (kernel) {
+    case HTP_MERGE_SCALAR:
+      return "scalar";
+    case HTP_MERGE_SSE2:
+      return "sse2";
+    case HTP_MERGE_AVX2:
+      return "avx2";
+    case HTP_MERGE_NEON:
+      return "neon";
+    default:
+      return "unknown";
+  }
+}
+}  // namespace dmx
+}  // namespace ola
@@ -0,0 +1,137 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * HTPMergeTest.cpp
+ * Test fixture for the HTP merge kernels.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <string.h>
+#include <algorithm>
+
+#include "ola/Constants.h"
+#include "ola/dmx/HTPMerge.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::dmx::HTPMergeKernel;
+using ola::dmx::HTPMergeKernelSupported;
+using ola::dmx::HTPMergeSlots;
+using ola::dmx::HTPMergeSlotsWithKernel;
+
+class HTPMergeTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(HTPMergeTest);
+  CPPUNIT_TEST(testMerge);
+  CPPUNIT_TEST(testInPlace);
+  CPPUNIT_TEST(testKernelsAgree);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    void testMerge();
+    void testInPlace();
+    void testKernelsAgree();
+
+ private:
+    static const unsigned int MAX_SOURCES = 16;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(HTPMergeTest);
+
+
+/*
+ * Check a simple merge.
+ */
+void HTPMergeTest::testMerge() {
+  const uint8_t source1[] = {1, 20, 3, 40, 5};
+  const uint8_t source2[] = {10, 2, 30, 4, 50};
+  const uint8_t source3[] = {0, 0, 0, 255, 0};
+  const uint8_t expected[] = {10, 20, 30, 255, 50};
+  const uint8_t *sources[] = {source1, source2, source3};
+
+  uint8_t output[sizeof(expected)];
+  HTPMergeSlots(sources, 3, sizeof(output), output);
+  OLA_ASSERT_DATA_EQUALS(expected, sizeof(expected), output, sizeof(output));
+
+  // a single source is copied
+  HTPMergeSlots(sources, 1, sizeof(output), output);
+  OLA_ASSERT_DATA_EQUALS(source1, sizeof(source1), output, sizeof(output));
+
+  // no sources leaves the output untouched
+  HTPMergeSlots(sources, 0, sizeof(output), output);
+  OLA_ASSERT_DATA_EQUALS(source1, sizeof(source1), output, sizeof(output));
+}
+
+
+/*
+ * Check the output can be one of the sources.
+ */
+void HTPMergeTest::testInPlace() {
+  uint8_t output[ola::DMX_UNIVERSE_SIZE];
+  uint8_t source[ola::DMX_UNIVERSE_SIZE];
+  uint8_t expected[ola::DMX_UNIVERSE_SIZE];
+  for (unsigned int i = 0; i < ola::DMX_UNIVERSE_SIZE; i++) {
+    output[i] = i % 2 ? 200 : 0;
+    source[i] = i % 256;
+    expected[i] = std::max(output[i], source[i]);
+  }
+
+  const uint8_t *sources[] = {output, source};
+  HTPMergeSlots(sources, 2, ola::DMX_UNIVERSE_SIZE, output);
+  OLA_ASSERT_DATA_EQUALS(expected, sizeof(expected), output, sizeof(output));
+}
+
+
+/*
+ * Check that every kernel supported on this host produces the same result as
+ * the scalar kernel, for a range of source counts and lengths that exercise
+ * the tail handling.
+ */
+void HTPMergeTest::testKernelsAgree() {
+  const HTPMergeKernel kernels[] = {
+    ola::dmx::HTP_MERGE_SSE2,
+    ola::dmx::HTP_MERGE_AVX2,
+    ola::dmx::HTP_MERGE_NEON,
+  };
+  const unsigned int lengths[] = {1, 15, 16, 17, 31, 33, 100, 511, 512};
+
+  uint8_t data[MAX_SOURCES][ola::DMX_UNIVERSE_SIZE];
+  const uint8_t *sources[MAX_SOURCES];
+  unsigned int seed = 42;
+  for (unsigned int i = 0; i < MAX_SOURCES; i++) {
+    for (unsigned int j = 0; j < ola::DMX_UNIVERSE_SIZE; j++) {
+      seed = seed * 1103515245 + 12345;
+      data[i][j] = (seed >> 16) & 0xff;
+    }
+    sources[i] = data[i];
+  }
+
+  uint8_t expected[ola::DMX_UNIVERSE_SIZE];
+  uint8_t output[ola::DMX_UNIVERSE_SIZE];
+  for (unsigned int k = 0; k < sizeof(kernels) / sizeof(kernels[0]); k++) {
+    if (!HTPMergeKernelSupported(kernels[k])) {
+      continue;
+    }
+    for (unsigned int count = 1; count <= MAX_SOURCES; count++) {
+      for (unsigned int l = 0; l < sizeof(lengths) / sizeof(lengths[0]);
+           l++) {
+        HTPMergeSlotsWithKernel(ola::dmx::HTP_MERGE_SCALAR, sources, count,
+                                lengths[l], expected);
+        HTPMergeSlotsWithKernel(kernels[k], sources, count, lengths[l],
+                                output);
+        OLA_ASSERT_DATA_EQUALS(expected, lengths[l], output, lengths[l]);
+      }
+    }
+  }
+}
@@ -1,11 +1,37 @@
 # LIBRARIES
 ##################################################
-common_libolacommon_la_SOURCES += common/dmx/RunLengthEncoder.cpp
+common_libolacommon_la_SOURCES += \
+    common/dmx/FrameScheduler.cpp \
+    common/dmx/HTPMerge.cpp \
+    common/dmx/RunLengthEncoder.cpp \
+    common/dmx/SharedDmxRegion.cpp
+
+# PROGRAMS
+##################################################
+noinst_PROGRAMS += common/dmx/htp_merge_benchmark
+
+common_dmx_htp_merge_benchmark_SOURCES = common/dmx/htp_merge_benchmark.cpp
+common_dmx_htp_merge_benchmark_LDADD = common/libolacommon.la
 
 # TESTS
 ##################################################
-test_programs += common/dmx/RunLengthEncoderTester
+test_programs += common/dmx/FrameSchedulerTester \
+                 common/dmx/HTPMergeTester \
+                 common/dmx/RunLengthEncoderTester \
+                 common/dmx/SharedDmxRegionTester
+
+common_dmx_FrameSchedulerTester_SOURCES = common/dmx/FrameSchedulerTest.cpp
+common_dmx_FrameSchedulerTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
+common_dmx_FrameSchedulerTester_LDADD = $(COMMON_TESTING_LIBS)
+
+common_dmx_HTPMergeTester_SOURCES = common/dmx/HTPMergeTest.cpp
+common_dmx_HTPMergeTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
+common_dmx_HTPMergeTester_LDADD = $(COMMON_TESTING_LIBS)
 
 common_dmx_RunLengthEncoderTester_SOURCES = common/dmx/RunLengthEncoderTest.cpp
 common_dmx_RunLengthEncoderTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 common_dmx_RunLengthEncoderTester_LDADD = $(COMMON_TESTING_LIBS)
+
+common_dmx_SharedDmxRegionTester_SOURCES = common/dmx/SharedDmxRegionTest.cpp
+common_dmx_SharedDmxRegionTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
+common_dmx_SharedDmxRegionTester_LDADD = $(COMMON_TESTING_LIBS)
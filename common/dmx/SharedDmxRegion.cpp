@@ -0,0 +1,421 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * SharedDmxRegion.cpp
+ * A shared memory region holding the latest DMX frame for many universes.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#ifdef HAVE_SHM_OPEN
+#include <signal.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif  // HAVE_SHM_OPEN
+
+#include <algorithm>
+#include <string>
+
+#include "ola/Logging.h"
+#include "ola/StringUtils.h"
+#include "ola/dmx/SharedDmxRegion.h"
+
+namespace ola {
+namespace dmx {
+
+using std::string;
+
+/*
+ * The layout of the region. Both structures are shared between processes so
+ * they must only contain fixed size types, and new fields must bump
+ * REGION_VERSION.
+ */
+struct SharedDmxRegion::RegionHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t slot_count;
+  volatile uint32_t slots_in_use;
+  volatile uint32_t doorbell;
+  volatile uint32_t active;
+  volatile uint16_t doorbell_port;
+  uint8_t reserved[38];
+};
+
+struct SharedDmxRegion::RegionSlot {
+  // Odd while a writer is updating the slot.
+  volatile uint32_t sequence;
+  // The universe id + 1, or 0 if the slot hasn't been claimed.
+  volatile uint32_t universe;
+  int64_t timestamp;
+  uint16_t length;
+  uint8_t priority;
+  uint8_t padding;
+  // The pid of the last process to lock the slot.
+  volatile int32_t writer;
+  uint8_t reserved[40];
+  uint8_t data[DMX_UNIVERSE_SIZE];
+};
+
+const uint32_t SharedDmxRegion::MAGIC = 0x4f4c4153;  // "OLAS"
+const uint32_t SharedDmxRegion::REGION_VERSION = 2;
+const unsigned int SharedDmxRegion::MAX_WRITE_SPINS = 10000;
+const unsigned int SharedDmxRegion::MAX_READ_RETRIES = 100;
+
+SharedDmxRegion::SharedDmxRegion(const string &name,
+                                 bool owner,
+                                 void *memory,
+                                 size_t size,
+                                 unsigned int slot_count)
+    : m_name(name),
+      m_owner(owner),
+      m_memory(memory),
+      m_size(size),
+      m_header(reinterpret_cast<RegionHeader*>(memory)),
+      m_slots(reinterpret_cast<RegionSlot*>(
+          reinterpret_cast<uint8_t*>(memory) + sizeof(RegionHeader))),
+      m_slot_count(slot_count) {
+}
+
+SharedDmxRegion::~SharedDmxRegion() {
+#ifdef HAVE_SHM_OPEN
+  if (m_owner) {
+    m_header->active = 0;
+    __sync_synchronize();
+    shm_unlink(m_name.c_str());
+  }
+  munmap(m_memory, m_size);
+#endif  // HAVE_SHM_OPEN
+}
+
+SharedDmxRegion* SharedDmxRegion::Create(const string &name,
+                                         unsigned int slot_count) {
+  if (slot_count == 0 || slot_count > MAX_SLOT_COUNT) {
+    OLA_WARN << "Invalid shared memory slot count " << slot_count;
+    return NULL;
+  }
+
+#ifndef HAVE_SHM_OPEN
+  OLA_WARN << "Shared memory regions aren't supported on this platform";
+  (void) name;
+  return NULL;
+#else
+  // Remove any region left behind by an instance that didn't shut down
+  // cleanly.
+  shm_unlink(name.c_str());
+
+  int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+  if (fd < 0) {
+    OLA_WARN << "shm_open(" << name << ") failed: " << strerror(errno);
+    return NULL;
+  }
+
+  // Any local user can already send DMX data over RPC, so don't let the umask
+  // restrict who can use the region.
+  const size_t size = RegionSize(slot_count);
+  if (fchmod(fd, 0666) < 0 || ftruncate(fd, size) < 0) {
+    OLA_WARN << "Failed to size shared memory region " << name << ": "
+             << strerror(errno);
+    close(fd);
+    shm_unlink(name.c_str());
+    return NULL;
+  }
+
+  void *memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (memory == MAP_FAILED) {
+    OLA_WARN << "Failed to map shared memory region " << name << ": "
+             << strerror(errno);
+    shm_unlink(name.c_str());
+    return NULL;
+  }
+
+  // ftruncate() zeros the region, so only the header needs filling in.
+  RegionHeader *header = reinterpret_cast<RegionHeader*>(memory);
+  header->version = REGION_VERSION;
+  header->slot_count = slot_count;
+  header->active = 1;
+  __sync_synchronize();
+  header->magic = MAGIC;
+  return new SharedDmxRegion(name, true, memory, size, slot_count);
+#endif  // HAVE_SHM_OPEN
+}
+
+SharedDmxRegion* SharedDmxRegion::Open(const string &name) {
+#ifndef HAVE_SHM_OPEN
+  (void) name;
+  return NULL;
+#else
+  int fd = shm_open(name.c_str(), O_RDWR, 0);
+  if (fd < 0) {
+    OLA_INFO << "Failed to open shared memory region " << name << ": "
+             << strerror(errno);
+    return NULL;
+  }
+
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) < 0 ||
+      static_cast<size_t>(file_stat.st_size) < RegionSize(1)) {
+    OLA_WARN << "Shared memory region " << name << " is too small";
+    close(fd);
+    return NULL;
+  }
+
+  const size_t size = file_stat.st_size;
+  void *memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (memory == MAP_FAILED) {
+    OLA_WARN << "Failed to map shared memory region " << name << ": "
+             << strerror(errno);
+    return NULL;
+  }
+
+  const RegionHeader *header = reinterpret_cast<RegionHeader*>(memory);
+  if (header->magic != MAGIC || header->version != REGION_VERSION ||
+      header->slot_count == 0 || header->slot_count > MAX_SLOT_COUNT ||
+      RegionSize(header->slot_count) != size) {
+    OLA_WARN << "Shared memory region " << name << " is invalid";
+    munmap(memory, size);
+    return NULL;
+  }
+  return new SharedDmxRegion(name, false, memory, size, header->slot_count);
+#endif  // HAVE_SHM_OPEN
+}
+
+string SharedDmxRegion::NameForPort(uint16_t port) {
+  return "/ola-dmx-" + IntToString(port);
+}
+
+unsigned int SharedDmxRegion::SlotsInUse() const {
+  // The header can be written by any client, so don't trust it.
+  return std::min(static_cast<unsigned int>(m_header->slots_in_use),
+                  m_slot_count);
+}
+
+bool SharedDmxRegion::IsActive() const {
+  return m_header->active;
+}
+
+int SharedDmxRegion::SlotForUniverse(unsigned int universe) {
+  const uint32_t key = universe + 1;
+  if (key == 0) {
+    return -1;
+  }
+
+  // Slots are claimed in order and never released, so the first free slot
+  // marks the end of the claimed ones.
+  for (unsigned int i = 0; i < m_slot_count; i++) {
+    uint32_t current = m_slots[i].universe;
+    if (current == 0) {
+      current = __sync_val_compare_and_swap(&m_slots[i].universe, 0, key);
+      if (current == 0) {
+        // Raise the high water mark so the reader scans this slot.
+        uint32_t in_use = m_header->slots_in_use;
+        while (in_use < i + 1) {
+          uint32_t previous = __sync_val_compare_and_swap(
+              &m_header->slots_in_use, in_use, i + 1);
+          if (previous == in_use) {
+            break;
+          }
+          in_use = previous;
+        }
+        return i;
+      }
+    }
+    if (current == key) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+bool SharedDmxRegion::Write(unsigned int slot_index,
+                            uint8_t priority,
+                            const DmxBuffer &data,
+                            const TimeStamp &timestamp) {
+  uint32_t sequence;
+  if (slot_index >= m_slot_count || !LockSlot(slot_index, &sequence)) {
+    return false;
+  }
+  RegionSlot *slot = &m_slots[slot_index];
+
+  unsigned int length = DMX_UNIVERSE_SIZE;
+  data.Get(slot->data, &length);
+  slot->length = length;
+  slot->priority = priority;
+  slot->timestamp = (timestamp - TimeStamp()).AsInt();
+
+  UnlockSlot(slot_index, sequence);
+  return true;
+}
+
+bool SharedDmxRegion::Read(unsigned int slot_index,
+                           uint32_t *sequence,
+                           SharedDmxFrame *frame) const {
+  if (slot_index >= m_slot_count) {
+    return false;
+  }
+  const RegionSlot *slot = &m_slots[slot_index];
+
+  for (unsigned int i = 0; i < MAX_READ_RETRIES; i++) {
+    const uint32_t start = slot->sequence;
+    if (start == *sequence) {
+      return false;
+    }
+    if (start & 1) {
+      continue;
+    }
+
+    __sync_synchronize();
+    const uint32_t universe = slot->universe;
+    const unsigned int length = std::min(
+        static_cast<unsigned int>(slot->length),
+        static_cast<unsigned int>(DMX_UNIVERSE_SIZE));
+    const int64_t timestamp = slot->timestamp;
+    frame->writer = slot->writer;
+    frame->priority = slot->priority;
+    memcpy(frame->data, slot->data, length);
+    __sync_synchronize();
+
+    if (slot->sequence != start) {
+      continue;
+    }
+
+    *sequence = start;
+    if (universe == 0) {
+      return false;
+    }
+    frame->universe = universe - 1;
+    frame->length = length;
+    frame->timestamp = TimeStamp() + TimeInterval(timestamp);
+    return true;
+  }
+  return false;
+}
+
+bool SharedDmxRegion::RecoverSlot(unsigned int slot_index,
+                                  uint32_t *locked_sequence) {
+  if (slot_index >= m_slot_count) {
+    return false;
+  }
+  RegionSlot *slot = &m_slots[slot_index];
+
+  const uint32_t sequence = slot->sequence;
+  if (!(sequence & 1)) {
+    *locked_sequence = 0;
+    return false;
+  }
+  if (sequence != *locked_sequence) {
+    // Odd numbers are never 0, so this can't be mistaken for the initial
+    // state.
+    *locked_sequence = sequence;
+    return false;
+  }
+
+  // The writer records its pid just after it locks the slot, so by the second
+  // call this is the pid of the process holding the lock.
+  if (WriterIsRunning(slot->writer)) {
+    return false;
+  }
+
+  // Moving to the next even number unlocks the slot. If the writer unlocked
+  // the slot since it was checked, the CAS fails.
+  if (!__sync_bool_compare_and_swap(&slot->sequence, sequence,
+                                    sequence + 1)) {
+    *locked_sequence = 0;
+    return false;
+  }
+  OLA_WARN << "Unlocked shared memory slot " << slot_index << ", writer "
+           << slot->writer << " exited while holding it";
+  *locked_sequence = sequence + 1;
+  return true;
+}
+
+bool SharedDmxRegion::WriterIsRunning(int32_t writer) {
+#ifdef HAVE_SHM_OPEN
+  if (writer <= 0) {
+    return false;
+  }
+  errno = 0;
+  if (kill(writer, 0) == 0) {
+    return true;
+  }
+  // EPERM means the process exists but belongs to another user.
+  return errno != ESRCH;
+#else
+  (void) writer;
+  return false;
+#endif  // HAVE_SHM_OPEN
+}
+
+bool SharedDmxRegion::RingDoorbell() {
+  return __sync_bool_compare_and_swap(&m_header->doorbell, 0, 1);
+}
+
+void SharedDmxRegion::ClearDoorbell() {
+  // The barrier stops the slot reads in the following scan from moving above
+  // the store.
+  m_header->doorbell = 0;
+  __sync_synchronize();
+}
+
+uint16_t SharedDmxRegion::DoorbellPort() const {
+  return m_header->doorbell_port;
+}
+
+void SharedDmxRegion::SetDoorbellPort(uint16_t port) {
+  m_header->doorbell_port = port;
+  __sync_synchronize();
+}
+
+/*
+ * Take the slot by moving the sequence number from even to odd. The CAS is a
+ * full barrier, so the data writes can't move above it.
+ */
+bool SharedDmxRegion::LockSlot(unsigned int slot_index, uint32_t *sequence) {
+  RegionSlot *slot = &m_slots[slot_index];
+  for (unsigned int spins = 0; spins < MAX_WRITE_SPINS; spins++) {
+    *sequence = slot->sequence;
+    if (!(*sequence & 1) &&
+        __sync_bool_compare_and_swap(&slot->sequence, *sequence,
+                                     *sequence + 1)) {
+#ifdef HAVE_SHM_OPEN
+      slot->writer = getpid();
+#endif  // HAVE_SHM_OPEN
+      return true;
+    }
+  }
+  return false;
+}
+
+void SharedDmxRegion::UnlockSlot(unsigned int slot_index, uint32_t sequence) {
+  __sync_synchronize();
+  m_slots[slot_index].sequence = sequence + 2;
+}
+
+size_t SharedDmxRegion::RegionSize(unsigned int slot_count) {
+  return sizeof(RegionHeader) +
+         static_cast<size_t>(slot_count) * sizeof(RegionSlot);
+}
+}  // namespace dmx
+}  // namespace ola
@@ -0,0 +1,301 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * SharedDmxRegionTest.cpp
+ * Test fixture for the SharedDmxRegion class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <memory>
+#include <string>
+
+#include "ola/Clock.h"
+#include "ola/DmxBuffer.h"
+#include "ola/StringUtils.h"
+#include "ola/dmx/SharedDmxRegion.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::DmxBuffer;
+using ola::TimeInterval;
+using ola::TimeStamp;
+using ola::dmx::SharedDmxFrame;
+using ola::dmx::SharedDmxRegion;
+using std::auto_ptr;
+using std::string;
+
+class SharedDmxRegionTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(SharedDmxRegionTest);
+  CPPUNIT_TEST(testCreateAndOpen);
+  CPPUNIT_TEST(testSlots);
+  CPPUNIT_TEST(testWriteAndRead);
+  CPPUNIT_TEST(testDoorbell);
+  CPPUNIT_TEST(testRecoverSlot);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    void setUp();
+    void testCreateAndOpen();
+    void testSlots();
+    void testWriteAndRead();
+    void testDoorbell();
+    void testRecoverSlot();
+
+ private:
+    string m_name;
+
+    // Simulate a writer that is part way through Write().
+    uint32_t LockSlot(SharedDmxRegion *region, unsigned int slot) {
+      uint32_t sequence;
+      OLA_ASSERT_TRUE(region->LockSlot(slot, &sequence));
+      return sequence;
+    }
+
+    void UnlockSlot(SharedDmxRegion *region, unsigned int slot,
+                    uint32_t sequence) {
+      region->UnlockSlot(slot, sequence);
+    }
+
+    // Simulate a writer that exits part way through Write().
+    void LockSlotAndExit(unsigned int slot) {
+      pid_t pid = fork();
+      OLA_ASSERT_TRUE(pid >= 0);
+      if (pid == 0) {
+        SharedDmxRegion *region = SharedDmxRegion::Open(m_name);
+        uint32_t sequence;
+        _exit(region && region->LockSlot(slot, &sequence) ? 0 : 1);
+      }
+      int status;
+      OLA_ASSERT_EQ(pid, waitpid(pid, &status, 0));
+      OLA_ASSERT_TRUE(WIFEXITED(status));
+      OLA_ASSERT_EQ(0, WEXITSTATUS(status));
+    }
+};
+
+#ifdef HAVE_SHM_OPEN
+CPPUNIT_TEST_SUITE_REGISTRATION(SharedDmxRegionTest);
+#endif  // HAVE_SHM_OPEN
+
+
+void SharedDmxRegionTest::setUp() {
+  m_name = "/ola-dmx-test-" + ola::IntToString(getpid());
+}
+
+
+/*
+ * Check regions can be created and opened.
+ */
+void SharedDmxRegionTest::testCreateAndOpen() {
+  OLA_ASSERT_EQ(string("/ola-dmx-9010"), SharedDmxRegion::NameForPort(9010));
+
+  OLA_ASSERT_NULL(SharedDmxRegion::Open(m_name));
+  OLA_ASSERT_NULL(SharedDmxRegion::Create(m_name, 0));
+  OLA_ASSERT_NULL(SharedDmxRegion::Create(
+      m_name, SharedDmxRegion::MAX_SLOT_COUNT + 1));
+
+  auto_ptr<SharedDmxRegion> server(SharedDmxRegion::Create(m_name, 8));
+  OLA_ASSERT_NOT_NULL(server.get());
+  OLA_ASSERT_EQ(8u, server->SlotCount());
+  OLA_ASSERT_EQ(0u, server->SlotsInUse());
+  OLA_ASSERT_TRUE(server->IsActive());
+
+  auto_ptr<SharedDmxRegion> client(SharedDmxRegion::Open(m_name));
+  OLA_ASSERT_NOT_NULL(client.get());
+  OLA_ASSERT_EQ(8u, client->SlotCount());
+  OLA_ASSERT_TRUE(client->IsActive());
+
+  // A stale region is replaced.
+  auto_ptr<SharedDmxRegion> new_server(SharedDmxRegion::Create(m_name, 4));
+  OLA_ASSERT_NOT_NULL(new_server.get());
+  auto_ptr<SharedDmxRegion> new_client(SharedDmxRegion::Open(m_name));
+  OLA_ASSERT_NOT_NULL(new_client.get());
+  OLA_ASSERT_EQ(4u, new_client->SlotCount());
+
+  // Clients see the region close, and it's removed.
+  new_server.reset();
+  OLA_ASSERT_FALSE(new_client->IsActive());
+  OLA_ASSERT_NULL(SharedDmxRegion::Open(m_name));
+}
+
+
+/*
+ * Check universes are assigned slots.
+ */
+void SharedDmxRegionTest::testSlots() {
+  auto_ptr<SharedDmxRegion> server(SharedDmxRegion::Create(m_name, 3));
+  OLA_ASSERT_NOT_NULL(server.get());
+  auto_ptr<SharedDmxRegion> client1(SharedDmxRegion::Open(m_name));
+  auto_ptr<SharedDmxRegion> client2(SharedDmxRegion::Open(m_name));
+  OLA_ASSERT_NOT_NULL(client1.get());
+  OLA_ASSERT_NOT_NULL(client2.get());
+
+  OLA_ASSERT_EQ(0, client1->SlotForUniverse(0));
+  OLA_ASSERT_EQ(1, client1->SlotForUniverse(10));
+  OLA_ASSERT_EQ(0, client1->SlotForUniverse(0));
+  // Clients share slots.
+  OLA_ASSERT_EQ(1, client2->SlotForUniverse(10));
+  OLA_ASSERT_EQ(2, client2->SlotForUniverse(5));
+  OLA_ASSERT_EQ(2, client1->SlotForUniverse(5));
+  OLA_ASSERT_EQ(3u, server->SlotsInUse());
+
+  // The region is full.
+  OLA_ASSERT_EQ(-1, client1->SlotForUniverse(6));
+  // And 0xffffffff can't be stored.
+  OLA_ASSERT_EQ(-1, client1->SlotForUniverse(0xffffffff));
+}
+
+
+/*
+ * Check that frames written by a client can be read by the server.
+ */
+void SharedDmxRegionTest::testWriteAndRead() {
+  auto_ptr<SharedDmxRegion> server(SharedDmxRegion::Create(m_name, 2));
+  OLA_ASSERT_NOT_NULL(server.get());
+  auto_ptr<SharedDmxRegion> client(SharedDmxRegion::Open(m_name));
+  OLA_ASSERT_NOT_NULL(client.get());
+
+  SharedDmxFrame frame;
+  uint32_t sequence = 0;
+  // Nothing has been written.
+  OLA_ASSERT_FALSE(server->Read(0, &sequence, &frame));
+  OLA_ASSERT_FALSE(server->Read(2, &sequence, &frame));
+
+  const TimeStamp timestamp = TimeStamp() + TimeInterval(10, 500);
+  DmxBuffer buffer;
+  buffer.SetFromString("1,2,3,4");
+  int slot = client->SlotForUniverse(42);
+  OLA_ASSERT_EQ(0, slot);
+  OLA_ASSERT_TRUE(client->Write(slot, 120, buffer, timestamp));
+  OLA_ASSERT_FALSE(client->Write(2, 120, buffer, timestamp));
+
+  OLA_ASSERT_TRUE(server->Read(0, &sequence, &frame));
+  OLA_ASSERT_EQ(42u, frame.universe);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(120), frame.priority);
+  OLA_ASSERT_EQ(timestamp, frame.timestamp);
+  OLA_ASSERT_DATA_EQUALS(buffer.GetRaw(), buffer.Size(), frame.data,
+                         frame.length);
+
+  // The slot hasn't changed.
+  OLA_ASSERT_FALSE(server->Read(0, &sequence, &frame));
+
+  // Only the latest frame is kept.
+  DmxBuffer buffer2;
+  buffer2.SetFromString("5,6");
+  DmxBuffer buffer3;
+  buffer3.SetFromString("7,8,9");
+  OLA_ASSERT_TRUE(client->Write(slot, 100, buffer2, timestamp));
+  OLA_ASSERT_TRUE(client->Write(slot, 110, buffer3, timestamp));
+  OLA_ASSERT_TRUE(server->Read(0, &sequence, &frame));
+  OLA_ASSERT_EQ(static_cast<uint8_t>(110), frame.priority);
+  OLA_ASSERT_DATA_EQUALS(buffer3.GetRaw(), buffer3.Size(), frame.data,
+                         frame.length);
+  OLA_ASSERT_FALSE(server->Read(0, &sequence, &frame));
+
+  // A second reader has its own sequence number.
+  uint32_t other_sequence = 0;
+  OLA_ASSERT_TRUE(client->Read(0, &other_sequence, &frame));
+  OLA_ASSERT_EQ(sequence, other_sequence);
+}
+
+
+/*
+ * Check that only the first writer rings the doorbell.
+ */
+void SharedDmxRegionTest::testDoorbell() {
+  auto_ptr<SharedDmxRegion> server(SharedDmxRegion::Create(m_name, 2));
+  OLA_ASSERT_NOT_NULL(server.get());
+  auto_ptr<SharedDmxRegion> client1(SharedDmxRegion::Open(m_name));
+  auto_ptr<SharedDmxRegion> client2(SharedDmxRegion::Open(m_name));
+  OLA_ASSERT_NOT_NULL(client1.get());
+  OLA_ASSERT_NOT_NULL(client2.get());
+
+  OLA_ASSERT_EQ(static_cast<uint16_t>(0), client1->DoorbellPort());
+  server->SetDoorbellPort(5000);
+  OLA_ASSERT_EQ(static_cast<uint16_t>(5000), client1->DoorbellPort());
+
+  OLA_ASSERT_TRUE(client1->RingDoorbell());
+  OLA_ASSERT_FALSE(client1->RingDoorbell());
+  OLA_ASSERT_FALSE(client2->RingDoorbell());
+
+  server->ClearDoorbell();
+  OLA_ASSERT_TRUE(client2->RingDoorbell());
+  OLA_ASSERT_FALSE(client1->RingDoorbell());
+}
+
+
+/*
+ * Check that slots left locked by a writer are recovered.
+ */
+void SharedDmxRegionTest::testRecoverSlot() {
+  auto_ptr<SharedDmxRegion> server(SharedDmxRegion::Create(m_name, 2));
+  OLA_ASSERT_NOT_NULL(server.get());
+  auto_ptr<SharedDmxRegion> client(SharedDmxRegion::Open(m_name));
+  OLA_ASSERT_NOT_NULL(client.get());
+
+  const TimeStamp timestamp = TimeStamp() + TimeInterval(10, 500);
+  DmxBuffer buffer;
+  buffer.SetFromString("1,2,3,4");
+  OLA_ASSERT_EQ(0, client->SlotForUniverse(1));
+  OLA_ASSERT_TRUE(client->Write(0, 100, buffer, timestamp));
+
+  SharedDmxFrame frame;
+  uint32_t sequence = 0;
+  uint32_t locked_sequence = 0;
+  OLA_ASSERT_TRUE(server->Read(0, &sequence, &frame));
+  OLA_ASSERT_FALSE(server->RecoverSlot(0, &locked_sequence));
+  OLA_ASSERT_FALSE(server->RecoverSlot(2, &locked_sequence));
+  OLA_ASSERT_EQ(0u, locked_sequence);
+
+  // A writer that is still running is never interrupted, however long it
+  // holds the slot.
+  uint32_t write_sequence = LockSlot(client.get(), 0);
+  OLA_ASSERT_FALSE(client->Write(0, 100, buffer, timestamp));
+  OLA_ASSERT_FALSE(server->Read(0, &sequence, &frame));
+  OLA_ASSERT_FALSE(server->RecoverSlot(0, &locked_sequence));
+  OLA_ASSERT_FALSE(server->RecoverSlot(0, &locked_sequence));
+  OLA_ASSERT_FALSE(server->RecoverSlot(0, &locked_sequence));
+  UnlockSlot(client.get(), 0, write_sequence);
+
+  // A writer exits while holding the slot, so it can't be read or written.
+  LockSlotAndExit(0);
+  OLA_ASSERT_FALSE(client->Write(0, 100, buffer, timestamp));
+  OLA_ASSERT_FALSE(server->Read(0, &sequence, &frame));
+
+  // The first time it's seen locked it's left alone, in case the writer only
+  // just took the slot.
+  OLA_ASSERT_FALSE(server->RecoverSlot(0, &locked_sequence));
+  OLA_ASSERT_TRUE(server->RecoverSlot(0, &locked_sequence));
+  sequence = locked_sequence;
+  OLA_ASSERT_FALSE(server->Read(0, &sequence, &frame));
+
+  // The slot can be used again.
+  DmxBuffer buffer2;
+  buffer2.SetFromString("5,6");
+  OLA_ASSERT_TRUE(client->Write(0, 100, buffer2, timestamp));
+  OLA_ASSERT_TRUE(server->Read(0, &sequence, &frame));
+  OLA_ASSERT_DATA_EQUALS(buffer2.GetRaw(), buffer2.Size(), frame.data,
+                         frame.length);
+  OLA_ASSERT_EQ(static_cast<int32_t>(getpid()), frame.writer);
+  OLA_ASSERT_FALSE(server->RecoverSlot(0, &locked_sequence));
+  OLA_ASSERT_EQ(0u, locked_sequence);
+}
@@ -0,0 +1,144 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * htp_merge_benchmark.cpp
+ * Measure the per-universe cost of HTP merging 2 to 16 sources.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <stdint.h>
+#include <iomanip>
+#include <iostream>
+#include "ola/Clock.h"
+#include "ola/Constants.h"
+#include "ola/DmxBuffer.h"
+#include "ola/base/Flags.h"
+#include "ola/base/Init.h"
+#include "ola/dmx/HTPMerge.h"
+
+using ola::Clock;
+using ola::DmxBuffer;
+using ola::TimeInterval;
+using ola::TimeStamp;
+using ola::dmx::HTPMergeKernel;
+using std::cout;
+using std::endl;
+
+DEFINE_s_uint32(iterations, i, 100000, "Number of merges per measurement");
+
+static const unsigned int MAX_SOURCES = 16;
+
+/**
+ * Return the number of nanoseconds each merge took.
+ */
+double NanoSecondsPerMerge(const Clock &clock,
+                           const TimeStamp &start,
+                           unsigned int iterations) {
+  TimeStamp end;
+  clock.CurrentTime(&end);
+  TimeInterval elapsed = end - start;
+  return elapsed.AsInt() * 1000.0 / iterations;
+}
+
+/**
+ * Merge the sources pairwise, the way the merge sites used to.
+ */
+double BenchmarkPairwise(const Clock &clock, const DmxBuffer *buffers,
+                         unsigned int source_count, unsigned int iterations) {
+  DmxBuffer output;
+  TimeStamp start;
+  clock.CurrentTime(&start);
+  for (unsigned int i = 0; i < iterations; i++) {
+    output.Reset();
+    for (unsigned int j = 0; j < source_count; j++) {
+      output.HTPMerge(buffers[j]);
+    }
+  }
+  return NanoSecondsPerMerge(clock, start, iterations);
+}
+
+/**
+ * Merge the sources in a single pass with the given kernel.
+ */
+double BenchmarkKernel(const Clock &clock, HTPMergeKernel kernel,
+                       const DmxBuffer *buffers, unsigned int source_count,
+                       unsigned int iterations) {
+  const uint8_t *sources[MAX_SOURCES];
+  for (unsigned int j = 0; j < source_count; j++) {
+    sources[j] = buffers[j].GetRaw();
+  }
+
+  uint8_t output[ola::DMX_UNIVERSE_SIZE];
+  TimeStamp start;
+  clock.CurrentTime(&start);
+  for (unsigned int i = 0; i < iterations; i++) {
+    ola::dmx::HTPMergeSlotsWithKernel(kernel, sources, source_count,
+                                      ola::DMX_UNIVERSE_SIZE, output);
+  }
+  return NanoSecondsPerMerge(clock, start, iterations);
+}
+
+int main(int argc, char *argv[]) {
+  ola::AppInit(&argc, argv, "",
+               "Measure the cost of HTP merging a universe.");
+
+  const unsigned int iterations = FLAGS_iterations;
+  if (!iterations) {
+    return -1;
+  }
+
+  DmxBuffer buffers[MAX_SOURCES];
+  for (unsigned int i = 0; i < MAX_SOURCES; i++) {
+    buffers[i].Blackout();
+    for (unsigned int j = 0; j < ola::DMX_UNIVERSE_SIZE; j++) {
+      buffers[i].SetChannel(j, (i * 31 + j * 7) % 256);
+    }
+  }
+
+  const HTPMergeKernel kernels[] = {
+    ola::dmx::HTP_MERGE_SCALAR,
+    ola::dmx::HTP_MERGE_SSE2,
+    ola::dmx::HTP_MERGE_AVX2,
+    ola::dmx::HTP_MERGE_NEON,
+  };
+  const unsigned int kernel_count = sizeof(kernels) / sizeof(kernels[0]);
+
+  cout << "Active kernel: "
+       << ola::dmx::HTPMergeKernelName(ola::dmx::ActiveHTPMergeKernel())
+       << endl;
+  cout << "ns per universe merge, " << iterations << " iterations" << endl;
+  cout << std::setw(8) << "sources" << std::setw(10) << "pairwise";
+  for (unsigned int k = 0; k < kernel_count; k++) {
+    if (ola::dmx::HTPMergeKernelSupported(kernels[k])) {
+      cout << std::setw(10) << ola::dmx::HTPMergeKernelName(kernels[k]);
+    }
+  }
+  cout << endl;
+
+  Clock clock;
+  cout << std::fixed << std::setprecision(1);
+  for (unsigned int count = 2; count <= MAX_SOURCES; count++) {
+    cout << std::setw(8) << count << std::setw(10)
+         << BenchmarkPairwise(clock, buffers, count, iterations);
+    for (unsigned int k = 0; k < kernel_count; k++) {
+      if (ola::dmx::HTPMergeKernelSupported(kernels[k])) {
+        cout << std::setw(10)
+             << BenchmarkKernel(clock, kernels[k], buffers, count, iterations);
+      }
+    }
+    cout << endl;
+  }
+  return 0;
+}
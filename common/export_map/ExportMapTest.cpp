@@ -33,6 +33,7 @@ using ola::IntMap;
 using ola::IntegerVariable;
 using ola::StringMap;
 using ola::StringVariable;
+using ola::UIntMap;
 using std::string;
 using std::vector;
 
@@ -45,6 +46,7 @@ class ExportMapTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testBoolVariable);
   CPPUNIT_TEST(testStringMapVariable);
   CPPUNIT_TEST(testIntMapVariable);
+  CPPUNIT_TEST(testMapHandle);
   CPPUNIT_TEST(testExportMap);
   CPPUNIT_TEST_SUITE_END();
 
@@ -55,6 +57,7 @@ class ExportMapTest: public CppUnit::TestFixture {
     void testBoolVariable();
     void testStringMapVariable();
     void testIntMapVariable();
+    void testMapHandle();
     void testExportMap();
 };
 
@@ -213,6 +216,33 @@ void ExportMapTest::testIntMapVariable() {
   OLA_ASSERT_EQ(var.Value(), string("map:count key1:1"));
 }
 
+/*
+ * Check that handles to map values stay valid as the map changes.
+ */
+void ExportMapTest::testMapHandle() {
+  UIntMap var("foo", "universe");
+
+  unsigned int *handle = var.Handle("1");
+  OLA_ASSERT_EQ(0u, *handle);
+  (*handle)++;
+  OLA_ASSERT_EQ(1u, var["1"]);
+  OLA_ASSERT_EQ(handle, var.Handle("1"));
+
+  // Adding and removing other keys doesn't invalidate the handle.
+  for (unsigned int i = 2; i < 100; i++) {
+    var.Increment(ola::strings::IntToString(i));
+  }
+  for (unsigned int i = 2; i < 100; i += 2) {
+    var.Remove(ola::strings::IntToString(i));
+  }
+  (*handle)++;
+  OLA_ASSERT_EQ(2u, var["1"]);
+  OLA_ASSERT_EQ(1u, var["3"]);
+
+  var.Remove("1");
+  OLA_ASSERT_EQ(0u, *var.Handle("1"));
+}
+
 /*
  * Check the export map works correctly.
  */
@@ -357,10 +357,17 @@ ssize_t ConnectedDescriptor::Send(const uint8_t *buffer,
 
 #endif  // _WIN32
 
+  // Save errno so the caller sees the error from the write, rather than
+  // anything the logging does.
+  const int error = errno;
   if (bytes_sent < 0 || static_cast<unsigned int>(bytes_sent) != size) {
-    OLA_INFO << "Failed to send on " << WriteDescriptor() << ": " <<
-      strerror(errno);
+    // A full buffer is expected for non-blocking descriptors.
+    if (error != EAGAIN && error != EWOULDBLOCK) {
+      OLA_INFO << "Failed to send on " << WriteDescriptor() << ": " <<
+        strerror(error);
+    }
   }
+  errno = error;
   return bytes_sent;
 }
 
@@ -370,6 +377,19 @@ ssize_t ConnectedDescriptor::Send(IOQueue *ioqueue) {
 
   int iocnt;
   const struct IOVec *iov = ioqueue->AsIOVec(&iocnt);
+  ssize_t bytes_sent = Send(iov, iocnt);
+  const int error = errno;
+  ioqueue->FreeIOVec(iov);
+  if (bytes_sent > 0) {
+    ioqueue->Pop(bytes_sent);
+  }
+  errno = error;
+  return bytes_sent;
+}
+
+ssize_t ConnectedDescriptor::Send(const struct IOVec *iov, int iocnt) {
+  if (!ValidWriteDescriptor())
+    return 0;
 
   ssize_t bytes_sent = 0;
 
@@ -409,13 +429,12 @@ ssize_t ConnectedDescriptor::Send(IOQueue *ioqueue) {
   }
 #endif  // _WIN32
 
-  ioqueue->FreeIOVec(iov);
-  if (bytes_sent < 0) {
+  const int error = errno;
+  if (bytes_sent < 0 && error != EAGAIN && error != EWOULDBLOCK) {
     OLA_INFO << "Failed to send on " << WriteDescriptor() << ": " <<
-      strerror(errno);
-  } else {
-    ioqueue->Pop(bytes_sent);
+      strerror(error);
   }
+  errno = error;
   return bytes_sent;
 }
 
@@ -50,7 +50,8 @@ class EPollData {
         read_descriptor(NULL),
         write_descriptor(NULL),
         connected_descriptor(NULL),
-        delete_connected_on_close(false) {
+        delete_connected_on_close(false),
+        edge_triggered(false) {
   }
 
   void Reset() {
@@ -59,6 +60,19 @@ class EPollData {
     write_descriptor = NULL;
     connected_descriptor = NULL;
     delete_connected_on_close = false;
+    edge_triggered = false;
+  }
+
+  /*
+   * The events to register with epoll. Edge triggering is only used while
+   * there isn't a write descriptor, since PerformWrite() isn't required to
+   * fill the socket buffer.
+   */
+  uint32_t EPollEvents() const {
+    if (edge_triggered && !(events & EPOLLOUT)) {
+      return events | EPOLLET;
+    }
+    return events;
   }
 
   uint32_t events;
@@ -66,6 +80,7 @@ class EPollData {
   WriteFileDescriptor *write_descriptor;
   ConnectedDescriptor *connected_descriptor;
   bool delete_connected_on_close;
+  bool edge_triggered;
 };
 
 namespace {
@@ -76,7 +91,7 @@ namespace {
  */
 bool AddEvent(int epoll_fd, int fd, EPollData *descriptor) {
   epoll_event event;
-  event.events = descriptor->events;
+  event.events = descriptor->EPollEvents();
   event.data.ptr = descriptor;
 
   OLA_DEBUG << "EPOLL_CTL_ADD " << fd << ", events " << std::hex
@@ -95,7 +110,7 @@ bool AddEvent(int epoll_fd, int fd, EPollData *descriptor) {
  */
 bool UpdateEvent(int epoll_fd, int fd, EPollData *descriptor) {
   epoll_event event;
-  event.events = descriptor->events;
+  event.events = descriptor->EPollEvents();
   event.data.ptr = descriptor;
 
   OLA_DEBUG << "EPOLL_CTL_MOD " << fd << ", events " << std::hex
@@ -124,9 +139,9 @@ bool RemoveEvent(int epoll_fd, int fd) {
 }  // namespace
 
 /**
- * @brief The maximum number of events to return in one epoll cycle
+ * @brief The initial size of the event array.
  */
-const int EPoller::MAX_EVENTS = 10;
+const unsigned int EPoller::INITIAL_EVENTS = 16;
 
 
 /**
@@ -143,13 +158,49 @@ EPoller::EPoller(ExportMap *export_map, Clock* clock)
     : m_export_map(export_map),
       m_loop_iterations(NULL),
       m_loop_time(NULL),
+      m_loop_wait_time(NULL),
+      m_loop_events(NULL),
+      m_loop_full_polls(NULL),
+      m_connected_descriptors(NULL),
+      m_epoll_fd(INVALID_DESCRIPTOR),
+      m_clock(clock),
+      m_max_events(DEFAULT_MAX_EVENTS),
+      m_edge_triggered(false) {
+  Init();
+}
+
+EPoller::EPoller(ExportMap *export_map, Clock* clock, const Options &options)
+    : m_export_map(export_map),
+      m_loop_iterations(NULL),
+      m_loop_time(NULL),
+      m_loop_wait_time(NULL),
+      m_loop_events(NULL),
+      m_loop_full_polls(NULL),
+      m_connected_descriptors(NULL),
       m_epoll_fd(INVALID_DESCRIPTOR),
-      m_clock(clock) {
+      m_clock(clock),
+      m_max_events(options.max_events ? options.max_events : 1),
+      m_edge_triggered(options.edge_triggered) {
+  Init();
+}
+
+void EPoller::Init() {
   if (m_export_map) {
     m_loop_time = m_export_map->GetCounterVar(K_LOOP_TIME);
     m_loop_iterations = m_export_map->GetCounterVar(K_LOOP_COUNT);
+    m_loop_wait_time = m_export_map->GetCounterVar(K_LOOP_WAIT_TIME);
+    m_loop_events = m_export_map->GetCounterVar(K_LOOP_EVENTS);
+    m_loop_full_polls = m_export_map->GetCounterVar(K_LOOP_FULL_POLLS);
+    m_connected_descriptors = m_export_map->GetIntegerVar(
+        K_CONNECTED_DESCRIPTORS_VAR);
   }
 
+  unsigned int initial_events = INITIAL_EVENTS;
+  if (initial_events > m_max_events) {
+    initial_events = m_max_events;
+  }
+  m_events.resize(initial_events);
+
   m_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
   if (m_epoll_fd < 0) {
     OLA_FATAL << "Failed to create new epoll instance";
@@ -203,6 +254,8 @@ bool EPoller::AddReadDescriptor(ReadFileDescriptor *descriptor) {
 
   result.first->events |= READ_FLAGS;
   result.first->read_descriptor = descriptor;
+  result.first->edge_triggered = m_edge_triggered &&
+                                 descriptor->DrainsOnRead();
 
   if (result.second) {
     return AddEvent(m_epoll_fd, descriptor->ReadDescriptor(), result.first);
@@ -234,6 +287,8 @@ bool EPoller::AddReadDescriptor(ConnectedDescriptor *descriptor,
   result.first->events |= READ_FLAGS;
   result.first->connected_descriptor = descriptor;
   result.first->delete_connected_on_close = delete_on_close;
+  result.first->edge_triggered = m_edge_triggered &&
+                                 descriptor->DrainsOnRead();
 
   if (result.second) {
     return AddEvent(m_epoll_fd, descriptor->ReadDescriptor(), result.first);
@@ -290,7 +345,6 @@ bool EPoller::Poll(TimeoutManager *timeout_manager,
     return false;
   }
 
-  epoll_event events[MAX_EVENTS];
   TimeInterval sleep_interval = poll_interval;
   TimeStamp now;
   m_clock->CurrentTime(&now);
@@ -310,12 +364,20 @@ bool EPoller::Poll(TimeoutManager *timeout_manager,
       (*m_loop_iterations)++;
   }
 
+  TimeStamp wait_start;
+  if (m_loop_wait_time) {
+    m_clock->CurrentTime(&wait_start);
+  }
+
   int ms_to_sleep = sleep_interval.InMilliSeconds();
-  int ready = epoll_wait(m_epoll_fd, reinterpret_cast<epoll_event*>(&events),
-                         MAX_EVENTS, ms_to_sleep ? ms_to_sleep : 1);
+  int ready = epoll_wait(m_epoll_fd, &m_events[0], m_events.size(),
+                         ms_to_sleep ? ms_to_sleep : 1);
 
   if (ready == 0) {
     m_clock->CurrentTime(&m_wake_up_time);
+    if (m_loop_wait_time) {
+      (*m_loop_wait_time) += (m_wake_up_time - wait_start).AsInt();
+    }
     timeout_manager->ExecuteTimeouts(&m_wake_up_time);
     return true;
   } else if (ready == -1) {
@@ -326,11 +388,34 @@ bool EPoller::Poll(TimeoutManager *timeout_manager,
   }
 
   m_clock->CurrentTime(&m_wake_up_time);
+  if (m_loop_wait_time) {
+    (*m_loop_wait_time) += (m_wake_up_time - wait_start).AsInt();
+  }
+  if (m_loop_events) {
+    (*m_loop_events) += ready;
+  }
 
   for (int i = 0; i < ready; i++) {
     EPollData *descriptor = reinterpret_cast<EPollData*>(
-        events[i].data.ptr);
-    CheckDescriptor(&events[i], descriptor);
+        m_events[i].data.ptr);
+    CheckDescriptor(&m_events[i], descriptor);
+  }
+
+  // If the array was filled there may be more descriptors ready. They'll be
+  // returned by the next call, but make room to handle them in one call from
+  // then on.
+  if (static_cast<unsigned int>(ready) == m_events.size()) {
+    if (m_loop_full_polls) {
+      (*m_loop_full_polls)++;
+    }
+    if (m_events.size() < m_max_events) {
+      unsigned int new_size = m_events.size() * 2;
+      if (new_size > m_max_events) {
+        new_size = m_max_events;
+      }
+      OLA_DEBUG << "Growing epoll event array to " << new_size;
+      m_events.resize(new_size);
+    }
   }
 
   // Now that we're out of the callback phase, clean up descriptors that were
@@ -377,8 +462,8 @@ void EPoller::CheckDescriptor(struct epoll_event *event,
         bool removed = RemoveDescriptor(
             epoll_data->connected_descriptor->ReadDescriptor(), READ_FLAGS,
             false);
-        if (removed && m_export_map) {
-          (*m_export_map->GetIntegerVar(K_CONNECTED_DESCRIPTORS_VAR))--;
+        if (removed && m_connected_descriptors) {
+          (*m_connected_descriptors)--;
         }
         delete epoll_data->connected_descriptor;
         epoll_data->connected_descriptor = NULL;
@@ -444,6 +529,7 @@ bool EPoller::RemoveDescriptor(int fd, int event, bool warn_on_missing) {
   } else if (event & EPOLLIN) {
     epoll_data->read_descriptor = NULL;
     epoll_data->connected_descriptor = NULL;
+    epoll_data->edge_triggered = false;
   }
 
   if (epoll_data->events == 0) {
@@ -47,9 +47,36 @@ class EPollData;
  *
  * epoll() is more efficient than select() but only newer Linux systems support
  * it.
+ *
+ * The array of events passed to epoll_wait() starts small and doubles each
+ * time a wait fills it, up to Options::max_events. This means a busy server
+ * handles all its ready descriptors with one epoll_wait() and one pass of the
+ * TimeoutManager.
  */
 class EPoller : public PollerInterface {
  public :
+  struct Options {
+   public:
+    Options()
+        : max_events(DEFAULT_MAX_EVENTS),
+          edge_triggered(false) {
+    }
+
+    /**
+     * @brief The maximum number of events to handle per epoll_wait() call.
+     */
+    unsigned int max_events;
+
+    /**
+     * @brief Use edge triggered notification for read descriptors where
+     * ReadFileDescriptor::DrainsOnRead() is true.
+     *
+     * Descriptors which are also registered for writes remain level
+     * triggered.
+     */
+    bool edge_triggered;
+  };
+
   /**
    * @brief Create a new EPoller.
    * @param export_map the ExportMap to use
@@ -57,6 +84,14 @@ class EPoller : public PollerInterface {
    */
   EPoller(ExportMap *export_map, Clock *clock);
 
+  /**
+   * @brief Create a new EPoller.
+   * @param export_map the ExportMap to use
+   * @param clock the Clock to use
+   * @param options the Options to use
+   */
+  EPoller(ExportMap *export_map, Clock *clock, const Options &options);
+
   ~EPoller();
 
   bool AddReadDescriptor(class ReadFileDescriptor *descriptor);
@@ -73,6 +108,8 @@ class EPoller : public PollerInterface {
   bool Poll(TimeoutManager *timeout_manager,
             const TimeInterval &poll_interval);
 
+  static const unsigned int DEFAULT_MAX_EVENTS = 256;
+
  private:
   typedef std::map<int, EPollData*> DescriptorMap;
   typedef std::vector<EPollData*> DescriptorList;
@@ -89,16 +126,24 @@ class EPoller : public PollerInterface {
   ExportMap *m_export_map;
   CounterVariable *m_loop_iterations;
   CounterVariable *m_loop_time;
+  CounterVariable *m_loop_wait_time;
+  CounterVariable *m_loop_events;
+  CounterVariable *m_loop_full_polls;
+  IntegerVariable *m_connected_descriptors;
   int m_epoll_fd;
   Clock *m_clock;
   TimeStamp m_wake_up_time;
+  const unsigned int m_max_events;
+  const bool m_edge_triggered;
+  std::vector<struct epoll_event> m_events;
 
+  void Init();
   std::pair<EPollData*, bool> LookupOrCreateDescriptor(int fd);
 
   bool RemoveDescriptor(int fd, int event, bool warn_on_missing);
   void CheckDescriptor(struct epoll_event *event, EPollData *descriptor);
 
-  static const int MAX_EVENTS;
+  static const unsigned int INITIAL_EVENTS;
   static const int READ_FLAGS;
   static const unsigned int MAX_FREE_DESCRIPTORS;
 
@@ -0,0 +1,726 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * IOUringPoller.cpp
+ * A Poller which uses io_uring
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include "common/io/IOUringPoller.h"
+
+#include <endian.h>
+#include <errno.h>
+#include <linux/io_uring.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <utility>
+
+#include "ola/Clock.h"
+#include "ola/Logging.h"
+#include "ola/base/Macro.h"
+#include "ola/io/Descriptor.h"
+#include "ola/stl/STLUtils.h"
+
+namespace ola {
+namespace io {
+
+using std::pair;
+
+/*
+ * The state of a poll request on the ring.
+ */
+struct IOUringRequest {
+  IOUringRequest()
+      : registered(false),
+        armed(false),
+        multishot(false),
+        generation(0) {
+  }
+
+  bool registered;  // true if there is a descriptor for this direction
+  bool armed;  // true if there is a request on the ring
+  bool multishot;
+  // Identifies the registration, so completions for a removed descriptor
+  // are ignored, even if the fd has been reused.
+  uint32_t generation;
+};
+
+/*
+ * Represents a FD
+ */
+class IOUringData {
+ public:
+  IOUringData()
+      : read_descriptor(NULL),
+        write_descriptor(NULL),
+        connected_descriptor(NULL),
+        delete_connected_on_close(false) {
+  }
+
+  bool Empty() const {
+    return !(read.registered || write.registered);
+  }
+
+  IOUringRequest read;
+  IOUringRequest write;
+  ReadFileDescriptor *read_descriptor;
+  WriteFileDescriptor *write_descriptor;
+  ConnectedDescriptor *connected_descriptor;
+  bool delete_connected_on_close;
+};
+
+namespace {
+
+const uint32_t READ_EVENTS = POLLIN | POLLRDHUP;
+const uint32_t WRITE_EVENTS = POLLOUT;
+
+/*
+ * The user data is the fd in the low 32 bits, then 1 bit for the direction
+ * and 31 bits of generation.
+ */
+uint64_t UserData(int fd, bool write, uint32_t generation) {
+  return (static_cast<uint64_t>(generation & 0x7fffffff) << 33) |
+         (static_cast<uint64_t>(write) << 32) |
+         static_cast<uint32_t>(fd);
+}
+
+/*
+ * The kernel expects poll32_events in little endian halfword order.
+ */
+uint32_t PollEvents(uint32_t events) {
+#if __BYTE_ORDER == __BIG_ENDIAN
+  return (events << 16) | (events >> 16);
+#else
+  return events;
+#endif  // __BYTE_ORDER
+}
+
+/*
+ * Reads and writes of the ring indices shared with the kernel.
+ */
+unsigned int LoadAcquire(const unsigned int *value) {
+  unsigned int result = *const_cast<const volatile unsigned int*>(value);
+  __sync_synchronize();
+  return result;
+}
+
+void StoreRelease(unsigned int *location, unsigned int value) {
+  __sync_synchronize();
+  *const_cast<volatile unsigned int*>(location) = value;
+}
+}  // namespace
+
+/**
+ * @brief The user data for POLL_REMOVE requests, the completions are ignored.
+ */
+const uint64_t IOUringPoller::CANCEL_USER_DATA = ~static_cast<uint64_t>(0);
+
+IOUringPoller::IOUringPoller(ExportMap *export_map, Clock* clock,
+                             const Options &options)
+    : m_export_map(export_map),
+      m_loop_iterations(NULL),
+      m_loop_time(NULL),
+      m_loop_wait_time(NULL),
+      m_loop_events(NULL),
+      m_loop_full_polls(NULL),
+      m_connected_descriptors(NULL),
+      m_clock(clock),
+      m_entries(options.entries ? options.entries : DEFAULT_ENTRIES),
+      m_multishot(options.multishot),
+      m_next_generation(0),
+      m_ring_fd(INVALID_DESCRIPTOR),
+      m_sq_ring(MAP_FAILED),
+      m_sq_ring_size(0),
+      m_cq_ring(MAP_FAILED),
+      m_cq_ring_size(0),
+      m_sqes(NULL),
+      m_sqes_size(0),
+      m_sq_head(NULL),
+      m_sq_tail(NULL),
+      m_sq_array(NULL),
+      m_sq_mask(0),
+      m_sq_entries(0),
+      m_cq_head(NULL),
+      m_cq_tail(NULL),
+      m_cqes(NULL),
+      m_cq_mask(0),
+      m_local_sq_tail(0) {
+  if (m_export_map) {
+    m_loop_time = m_export_map->GetCounterVar(K_LOOP_TIME);
+    m_loop_iterations = m_export_map->GetCounterVar(K_LOOP_COUNT);
+    m_loop_wait_time = m_export_map->GetCounterVar(K_LOOP_WAIT_TIME);
+    m_loop_events = m_export_map->GetCounterVar(K_LOOP_EVENTS);
+    m_loop_full_polls = m_export_map->GetCounterVar(K_LOOP_FULL_POLLS);
+    m_connected_descriptors = m_export_map->GetIntegerVar(
+        K_CONNECTED_DESCRIPTORS_VAR);
+  }
+}
+
+IOUringPoller::~IOUringPoller() {
+  ReleaseRings();
+
+  {
+    DescriptorMap::iterator iter = m_descriptor_map.begin();
+    for (; iter != m_descriptor_map.end(); ++iter) {
+      if (iter->second->delete_connected_on_close) {
+        delete iter->second->connected_descriptor;
+      }
+      delete iter->second;
+    }
+  }
+
+  DescriptorList::iterator iter = m_orphaned_descriptors.begin();
+  for (; iter != m_orphaned_descriptors.end(); ++iter) {
+    if ((*iter)->delete_connected_on_close) {
+      delete (*iter)->connected_descriptor;
+    }
+    delete *iter;
+  }
+}
+
+bool IOUringPoller::Init() {
+  if (m_ring_fd != INVALID_DESCRIPTOR) {
+    return true;
+  }
+
+  struct io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  int fd = syscall(__NR_io_uring_setup, m_entries, &params);
+  if (fd < 0) {
+    OLA_INFO << "io_uring_setup failed: " << strerror(errno);
+    return false;
+  }
+  m_ring_fd = fd;
+
+  // We need to wait with a timeout, and not lose completions if the
+  // completion ring fills up.
+  if (!(params.features & IORING_FEAT_EXT_ARG) ||
+      !(params.features & IORING_FEAT_NODROP)) {
+    OLA_INFO << "io_uring is missing required features, have 0x" << std::hex
+             << params.features;
+    ReleaseRings();
+    return false;
+  }
+
+  m_sq_ring_size = params.sq_off.array +
+                   params.sq_entries * sizeof(unsigned int);
+  m_cq_ring_size = params.cq_off.cqes +
+                   params.cq_entries * sizeof(struct io_uring_cqe);
+  if (params.features & IORING_FEAT_SINGLE_MMAP) {
+    m_sq_ring_size = std::max(m_sq_ring_size, m_cq_ring_size);
+  }
+
+  m_sq_ring = mmap(NULL, m_sq_ring_size, PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_POPULATE, m_ring_fd, IORING_OFF_SQ_RING);
+  if (m_sq_ring == MAP_FAILED) {
+    OLA_WARN << "Failed to map the io_uring submission ring: "
+             << strerror(errno);
+    ReleaseRings();
+    return false;
+  }
+
+  if (params.features & IORING_FEAT_SINGLE_MMAP) {
+    m_cq_ring = m_sq_ring;
+  } else {
+    m_cq_ring = mmap(NULL, m_cq_ring_size, PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_POPULATE, m_ring_fd, IORING_OFF_CQ_RING);
+    if (m_cq_ring == MAP_FAILED) {
+      OLA_WARN << "Failed to map the io_uring completion ring: "
+               << strerror(errno);
+      ReleaseRings();
+      return false;
+    }
+  }
+
+  m_sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+  void *sqes = mmap(NULL, m_sqes_size, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE, m_ring_fd, IORING_OFF_SQES);
+  if (sqes == MAP_FAILED) {
+    OLA_WARN << "Failed to map the io_uring submission entries: "
+             << strerror(errno);
+    ReleaseRings();
+    return false;
+  }
+  m_sqes = reinterpret_cast<struct io_uring_sqe*>(sqes);
+
+  uint8_t *sq_ring = reinterpret_cast<uint8_t*>(m_sq_ring);
+  m_sq_head = reinterpret_cast<unsigned int*>(sq_ring + params.sq_off.head);
+  m_sq_tail = reinterpret_cast<unsigned int*>(sq_ring + params.sq_off.tail);
+  m_sq_array = reinterpret_cast<unsigned int*>(sq_ring + params.sq_off.array);
+  m_sq_mask = *reinterpret_cast<unsigned int*>(
+      sq_ring + params.sq_off.ring_mask);
+  m_sq_entries = params.sq_entries;
+  m_local_sq_tail = *m_sq_tail;
+
+  uint8_t *cq_ring = reinterpret_cast<uint8_t*>(m_cq_ring);
+  m_cq_head = reinterpret_cast<unsigned int*>(cq_ring + params.cq_off.head);
+  m_cq_tail = reinterpret_cast<unsigned int*>(cq_ring + params.cq_off.tail);
+  m_cqes = reinterpret_cast<struct io_uring_cqe*>(
+      cq_ring + params.cq_off.cqes);
+  m_cq_mask = *reinterpret_cast<unsigned int*>(
+      cq_ring + params.cq_off.ring_mask);
+  m_completions.reserve(params.cq_entries);
+
+  OLA_DEBUG << "Using io_uring with " << params.sq_entries << " entries"
+            << (m_multishot ? ", multishot" : "");
+  return true;
+}
+
+bool IOUringPoller::AddReadDescriptor(ReadFileDescriptor *descriptor) {
+  if (m_ring_fd == INVALID_DESCRIPTOR) {
+    return false;
+  }
+
+  if (!descriptor->ValidReadDescriptor()) {
+    OLA_WARN << "AddReadDescriptor called with invalid descriptor";
+    return false;
+  }
+
+  pair<IOUringData*, bool> result = LookupOrCreateDescriptor(
+      descriptor->ReadDescriptor());
+  if (result.first->read.registered) {
+    OLA_WARN << "Descriptor " << descriptor->ReadDescriptor()
+             << " already in read set";
+    return false;
+  }
+
+  result.first->read_descriptor = descriptor;
+  result.first->read.multishot = m_multishot && descriptor->DrainsOnRead();
+  return AddRequest(descriptor->ReadDescriptor(), result.first, false);
+}
+
+bool IOUringPoller::AddReadDescriptor(ConnectedDescriptor *descriptor,
+                                      bool delete_on_close) {
+  if (m_ring_fd == INVALID_DESCRIPTOR) {
+    return false;
+  }
+
+  if (!descriptor->ValidReadDescriptor()) {
+    OLA_WARN << "AddReadDescriptor called with invalid descriptor";
+    return false;
+  }
+
+  pair<IOUringData*, bool> result = LookupOrCreateDescriptor(
+      descriptor->ReadDescriptor());
+  if (result.first->read.registered) {
+    OLA_WARN << "Descriptor " << descriptor->ReadDescriptor()
+             << " already in read set";
+    return false;
+  }
+
+  result.first->connected_descriptor = descriptor;
+  result.first->delete_connected_on_close = delete_on_close;
+  result.first->read.multishot = m_multishot && descriptor->DrainsOnRead();
+  return AddRequest(descriptor->ReadDescriptor(), result.first, false);
+}
+
+bool IOUringPoller::RemoveReadDescriptor(ReadFileDescriptor *descriptor) {
+  return RemoveDescriptor(descriptor->ReadDescriptor(), false, true);
+}
+
+bool IOUringPoller::RemoveReadDescriptor(ConnectedDescriptor *descriptor) {
+  return RemoveDescriptor(descriptor->ReadDescriptor(), false, true);
+}
+
+bool IOUringPoller::AddWriteDescriptor(WriteFileDescriptor *descriptor) {
+  if (m_ring_fd == INVALID_DESCRIPTOR) {
+    return false;
+  }
+
+  if (!descriptor->ValidWriteDescriptor()) {
+    OLA_WARN << "AddWriteDescriptor called with invalid descriptor";
+    return false;
+  }
+
+  pair<IOUringData*, bool> result = LookupOrCreateDescriptor(
+      descriptor->WriteDescriptor());
+  if (result.first->write.registered) {
+    OLA_WARN << "Descriptor " << descriptor->WriteDescriptor()
+             << " already in write set";
+    return false;
+  }
+
+  result.first->write_descriptor = descriptor;
+  return AddRequest(descriptor->WriteDescriptor(), result.first, true);
+}
+
+bool IOUringPoller::RemoveWriteDescriptor(WriteFileDescriptor *descriptor) {
+  return RemoveDescriptor(descriptor->WriteDescriptor(), true, true);
+}
+
+bool IOUringPoller::Poll(TimeoutManager *timeout_manager,
+                         const TimeInterval &poll_interval) {
+  if (m_ring_fd == INVALID_DESCRIPTOR) {
+    return false;
+  }
+
+  TimeInterval sleep_interval = poll_interval;
+  TimeStamp now;
+  m_clock->CurrentTime(&now);
+
+  TimeInterval next_event_in = timeout_manager->ExecuteTimeouts(&now);
+  if (!next_event_in.IsZero()) {
+    sleep_interval = std::min(next_event_in, sleep_interval);
+  }
+
+  // take care of stats accounting
+  if (m_wake_up_time.IsSet()) {
+    TimeInterval loop_time = now - m_wake_up_time;
+    OLA_DEBUG << "ss process time was " << loop_time.ToString();
+    if (m_loop_time)
+      (*m_loop_time) += loop_time.AsInt();
+    if (m_loop_iterations)
+      (*m_loop_iterations)++;
+  }
+
+  TimeStamp wait_start;
+  if (m_loop_wait_time) {
+    m_clock->CurrentTime(&wait_start);
+  }
+
+  // Submit the new requests and wait for completions with the one call.
+  int ms_to_sleep = sleep_interval.InMilliSeconds();
+  if (!Enter(PublishSubmissions(), 1, IORING_ENTER_GETEVENTS,
+             ms_to_sleep ? ms_to_sleep : 1)) {
+    return false;
+  }
+
+  m_clock->CurrentTime(&m_wake_up_time);
+  if (m_loop_wait_time) {
+    (*m_loop_wait_time) += (m_wake_up_time - wait_start).AsInt();
+  }
+
+  ReapCompletions();
+  if (m_loop_events) {
+    (*m_loop_events) += m_completions.size();
+  }
+  // A full completion queue means completions may have been held back.
+  if (m_completions.size() > m_cq_mask && m_loop_full_polls) {
+    (*m_loop_full_polls)++;
+  }
+
+  std::vector<struct io_uring_cqe>::const_iterator cqe_iter =
+      m_completions.begin();
+  for (; cqe_iter != m_completions.end(); ++cqe_iter) {
+    HandleCompletion(*cqe_iter);
+  }
+
+  // Re-arm the one-shot requests. These will be submitted with the next wait.
+  std::vector<int> rearm_descriptors;
+  rearm_descriptors.swap(m_rearm_descriptors);
+  std::vector<int>::const_iterator fd_iter = rearm_descriptors.begin();
+  for (; fd_iter != rearm_descriptors.end(); ++fd_iter) {
+    IOUringData *data = STLFindOrNull(m_descriptor_map, *fd_iter);
+    if (!data) {
+      continue;
+    }
+    if (data->read.registered && !data->read.armed) {
+      ArmRequest(*fd_iter, data, false);
+    }
+    if (data->write.registered && !data->write.armed) {
+      ArmRequest(*fd_iter, data, true);
+    }
+  }
+
+  // Now that we're out of the callback phase, clean up descriptors that were
+  // removed.
+  STLDeleteElements(&m_orphaned_descriptors);
+
+  m_clock->CurrentTime(&m_wake_up_time);
+  timeout_manager->ExecuteTimeouts(&m_wake_up_time);
+  return true;
+}
+
+/*
+ * Handle a completed poll request.
+ */
+void IOUringPoller::HandleCompletion(const struct io_uring_cqe &cqe) {
+  if (cqe.user_data == CANCEL_USER_DATA) {
+    return;
+  }
+
+  const int fd = static_cast<int>(cqe.user_data & 0xffffffff);
+  const bool write = (cqe.user_data >> 32) & 1;
+  const uint32_t generation = static_cast<uint32_t>(cqe.user_data >> 33);
+
+  IOUringData *data = STLFindOrNull(m_descriptor_map, fd);
+  if (!data) {
+    // The descriptor was removed.
+    return;
+  }
+  IOUringRequest *request = write ? &data->write : &data->read;
+  if (!request->registered || request->generation != generation) {
+    return;
+  }
+
+  if (!(cqe.flags & IORING_CQE_F_MORE)) {
+    request->armed = false;
+    m_rearm_descriptors.push_back(fd);
+  }
+
+  if (cqe.res < 0) {
+    if (cqe.res == -EINVAL && request->multishot) {
+      OLA_WARN << "Multishot poll isn't supported, using one-shot requests";
+      m_multishot = false;
+      request->multishot = false;
+    } else {
+      OLA_WARN << "Poll request for " << fd << " failed: "
+               << strerror(-cqe.res);
+    }
+    return;
+  }
+
+  const uint32_t revents = static_cast<uint32_t>(cqe.res);
+  if (write) {
+    // data->write_descriptor may be null here if this descriptor was
+    // removed by an earlier callback.
+    if (data->write_descriptor) {
+      data->write_descriptor->PerformWrite();
+    }
+  } else {
+    CheckRead(data, revents);
+  }
+}
+
+/*
+ * Run the read or close handlers for a descriptor.
+ */
+void IOUringPoller::CheckRead(IOUringData *data, uint32_t revents) {
+  if (revents & (POLLHUP | POLLRDHUP)) {
+    if (data->read_descriptor) {
+      data->read_descriptor->PerformRead();
+    } else if (data->connected_descriptor) {
+      ConnectedDescriptor::OnCloseCallback *on_close =
+          data->connected_descriptor->TransferOnClose();
+      if (on_close)
+        on_close->Run();
+
+      // At this point the descriptor may be sitting in the orphan list if the
+      // OnClose handler called into RemoveReadDescriptor()
+      if (data->delete_connected_on_close && data->connected_descriptor) {
+        bool removed = RemoveDescriptor(
+            data->connected_descriptor->ReadDescriptor(), false, false);
+        if (removed && m_connected_descriptors) {
+          (*m_connected_descriptors)--;
+        }
+        delete data->connected_descriptor;
+        data->connected_descriptor = NULL;
+      }
+    }
+    return;
+  }
+
+  if (data->read_descriptor) {
+    data->read_descriptor->PerformRead();
+  } else if (data->connected_descriptor) {
+    data->connected_descriptor->PerformRead();
+  }
+}
+
+std::pair<IOUringData*, bool> IOUringPoller::LookupOrCreateDescriptor(
+    int fd) {
+  pair<DescriptorMap::iterator, bool> result = m_descriptor_map.insert(
+      DescriptorMap::value_type(fd, NULL));
+  bool new_descriptor = result.second;
+
+  if (new_descriptor) {
+    result.first->second = new IOUringData();
+  }
+  return std::make_pair(result.first->second, new_descriptor);
+}
+
+bool IOUringPoller::AddRequest(int fd, IOUringData *data, bool write) {
+  IOUringRequest *request = write ? &data->write : &data->read;
+  request->registered = true;
+  request->generation = m_next_generation++;
+  ArmRequest(fd, data, write);
+  return true;
+}
+
+bool IOUringPoller::RemoveDescriptor(int fd, bool write,
+                                     bool warn_on_missing) {
+  if (fd == INVALID_DESCRIPTOR) {
+    OLA_WARN << "Attempt to remove an invalid file descriptor";
+    return false;
+  }
+
+  IOUringData *data = STLFindOrNull(m_descriptor_map, fd);
+  IOUringRequest *request = NULL;
+  if (data) {
+    request = write ? &data->write : &data->read;
+  }
+  if (!request || !request->registered) {
+    if (warn_on_missing) {
+      OLA_WARN << "Couldn't find IOUringData for " << fd;
+    }
+    return false;
+  }
+
+  CancelRequest(fd, data, write);
+  request->registered = false;
+  request->multishot = false;
+
+  if (write) {
+    data->write_descriptor = NULL;
+  } else {
+    data->read_descriptor = NULL;
+    data->connected_descriptor = NULL;
+  }
+
+  if (data->Empty()) {
+    m_orphaned_descriptors.push_back(
+        STLLookupAndRemovePtr(&m_descriptor_map, fd));
+  }
+  return true;
+}
+
+/*
+ * Queue a poll request for the descriptor.
+ */
+void IOUringPoller::ArmRequest(int fd, IOUringData *data, bool write) {
+  IOUringRequest *request = write ? &data->write : &data->read;
+  struct io_uring_sqe *sqe = GetSQE();
+  if (!sqe) {
+    // This will be retried after the next completion.
+    OLA_WARN << "io_uring submission ring is full, can't poll " << fd;
+    m_rearm_descriptors.push_back(fd);
+    return;
+  }
+
+  sqe->opcode = IORING_OP_POLL_ADD;
+  sqe->fd = fd;
+  sqe->poll32_events = PollEvents(write ? WRITE_EVENTS : READ_EVENTS);
+  if (request->multishot) {
+    sqe->len = IORING_POLL_ADD_MULTI;
+  }
+  sqe->user_data = UserData(fd, write, request->generation);
+  request->armed = true;
+}
+
+/*
+ * Queue the removal of any outstanding poll request. If this fails the
+ * request stays on the ring until it fires, and the completion is ignored.
+ */
+void IOUringPoller::CancelRequest(int fd, IOUringData *data, bool write) {
+  IOUringRequest *request = write ? &data->write : &data->read;
+  if (!request->armed) {
+    return;
+  }
+  request->armed = false;
+
+  struct io_uring_sqe *sqe = GetSQE();
+  if (!sqe) {
+    OLA_WARN << "io_uring submission ring is full, can't cancel " << fd;
+    return;
+  }
+  sqe->opcode = IORING_OP_POLL_REMOVE;
+  sqe->fd = -1;
+  sqe->addr = UserData(fd, write, request->generation);
+  sqe->user_data = CANCEL_USER_DATA;
+}
+
+/*
+ * Return the next free submission entry, or NULL if the ring is full and the
+ * queued entries couldn't be submitted.
+ */
+struct io_uring_sqe *IOUringPoller::GetSQE() {
+  if (m_local_sq_tail - LoadAcquire(m_sq_head) >= m_sq_entries) {
+    if (!Enter(PublishSubmissions(), 0, 0, 0) ||
+        m_local_sq_tail - LoadAcquire(m_sq_head) >= m_sq_entries) {
+      return NULL;
+    }
+  }
+
+  const unsigned int index = m_local_sq_tail & m_sq_mask;
+  struct io_uring_sqe *sqe = &m_sqes[index];
+  memset(sqe, 0, sizeof(*sqe));
+  m_sq_array[index] = index;
+  m_local_sq_tail++;
+  return sqe;
+}
+
+/*
+ * Make the queued entries visible to the kernel.
+ * @returns the number of entries to submit.
+ */
+unsigned int IOUringPoller::PublishSubmissions() {
+  StoreRelease(m_sq_tail, m_local_sq_tail);
+  return m_local_sq_tail - LoadAcquire(m_sq_head);
+}
+
+bool IOUringPoller::Enter(unsigned int to_submit, unsigned int min_complete,
+                          unsigned int flags, int timeout_ms) {
+  struct __kernel_timespec timeout;
+  struct io_uring_getevents_arg arg;
+  memset(&arg, 0, sizeof(arg));
+  if (flags & IORING_ENTER_GETEVENTS) {
+    timeout.tv_sec = timeout_ms / 1000;
+    timeout.tv_nsec = (timeout_ms % 1000) * 1000000;
+    arg.ts = reinterpret_cast<uintptr_t>(&timeout);
+  }
+
+  int r = syscall(__NR_io_uring_enter, m_ring_fd, to_submit, min_complete,
+                  flags | IORING_ENTER_EXT_ARG, &arg, sizeof(arg));
+  if (r < 0) {
+    // ETIME means the wait timed out, EBUSY that completions need to be
+    // reaped before more can be submitted.
+    if (errno == ETIME || errno == EINTR || errno == EBUSY) {
+      return true;
+    }
+    OLA_WARN << "io_uring_enter() error, " << strerror(errno);
+    return false;
+  }
+  return true;
+}
+
+/*
+ * Copy the completions out of the ring, so the callbacks are free to queue
+ * new requests.
+ */
+void IOUringPoller::ReapCompletions() {
+  m_completions.clear();
+  unsigned int head = *m_cq_head;
+  const unsigned int tail = LoadAcquire(m_cq_tail);
+  for (; head != tail; head++) {
+    m_completions.push_back(m_cqes[head & m_cq_mask]);
+  }
+  StoreRelease(m_cq_head, head);
+}
+
+void IOUringPoller::ReleaseRings() {
+  if (m_sqes) {
+    munmap(m_sqes, m_sqes_size);
+    m_sqes = NULL;
+  }
+  if (m_cq_ring != MAP_FAILED && m_cq_ring != m_sq_ring) {
+    munmap(m_cq_ring, m_cq_ring_size);
+  }
+  m_cq_ring = MAP_FAILED;
+  if (m_sq_ring != MAP_FAILED) {
+    munmap(m_sq_ring, m_sq_ring_size);
+    m_sq_ring = MAP_FAILED;
+  }
+  if (m_ring_fd != INVALID_DESCRIPTOR) {
+    close(m_ring_fd);
+    m_ring_fd = INVALID_DESCRIPTOR;
+  }
+}
+}  // namespace io
+}  // namespace ola
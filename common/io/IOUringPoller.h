@@ -0,0 +1,183 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * IOUringPoller.h
+ * A Poller which uses io_uring
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef COMMON_IO_IOURINGPOLLER_H_
+#define COMMON_IO_IOURINGPOLLER_H_
+
+#include <ola/base/Macro.h>
+#include <ola/Clock.h>
+#include <ola/ExportMap.h>
+#include <ola/io/Descriptor.h>
+#include <linux/io_uring.h>
+#include <stdint.h>
+
+#include <map>
+#include <vector>
+
+#include "common/io/PollerInterface.h"
+#include "common/io/TimeoutManager.h"
+
+namespace ola {
+namespace io {
+
+class IOUringData;
+
+/**
+ * @class IOUringPoller
+ * @brief An implementation of PollerInterface that uses io_uring.
+ *
+ * Each registered descriptor has a poll request on the ring for reads and
+ * another for writes. New and re-armed requests are queued on the submission
+ * ring and submitted by the same io_uring_enter() call that waits for
+ * completions, so a loop iteration costs a single system call no matter how
+ * many descriptors were handled.
+ *
+ * Poll requests are one-shot and are re-armed once the descriptor has been
+ * handled, which keeps the level triggered behaviour of the other pollers.
+ * In multishot mode, read descriptors where
+ * ReadFileDescriptor::DrainsOnRead() is true use a multishot poll which stays
+ * armed, so they don't need re-arming at all.
+ *
+ * Init() must be called before use. It fails if the kernel doesn't support
+ * io_uring, or is older than 5.11, in which case the SelectServer falls back
+ * to the EPoller.
+ */
+class IOUringPoller : public PollerInterface {
+ public :
+  struct Options {
+   public:
+    Options()
+        : entries(DEFAULT_ENTRIES),
+          multishot(false) {
+    }
+
+    /**
+     * @brief The size of the submission ring.
+     */
+    unsigned int entries;
+
+    /**
+     * @brief Use multishot poll requests for descriptors which drain on read.
+     */
+    bool multishot;
+  };
+
+  /**
+   * @brief Create a new IOUringPoller.
+   * @param export_map the ExportMap to use
+   * @param clock the Clock to use
+   * @param options the Options to use
+   */
+  IOUringPoller(ExportMap *export_map, Clock *clock, const Options &options);
+
+  ~IOUringPoller();
+
+  /**
+   * @brief Set up the rings.
+   * @returns false if io_uring isn't available.
+   */
+  bool Init();
+
+  bool AddReadDescriptor(class ReadFileDescriptor *descriptor);
+  bool AddReadDescriptor(class ConnectedDescriptor *descriptor,
+                         bool delete_on_close);
+  bool RemoveReadDescriptor(class ReadFileDescriptor *descriptor);
+  bool RemoveReadDescriptor(class ConnectedDescriptor *descriptor);
+
+  bool AddWriteDescriptor(class WriteFileDescriptor *descriptor);
+  bool RemoveWriteDescriptor(class WriteFileDescriptor *descriptor);
+
+  const TimeStamp *WakeUpTime() const { return &m_wake_up_time; }
+
+  bool Poll(TimeoutManager *timeout_manager,
+            const TimeInterval &poll_interval);
+
+  static const unsigned int DEFAULT_ENTRIES = 256;
+
+ private:
+  typedef std::map<int, IOUringData*> DescriptorMap;
+  typedef std::vector<IOUringData*> DescriptorList;
+
+  DescriptorMap m_descriptor_map;
+
+  // As with the EPoller, descriptors removed during the callbacks are moved
+  // here and cleaned up once the callbacks are done.
+  DescriptorList m_orphaned_descriptors;
+  // The descriptors with a one-shot request which completed.
+  std::vector<int> m_rearm_descriptors;
+
+  ExportMap *m_export_map;
+  CounterVariable *m_loop_iterations;
+  CounterVariable *m_loop_time;
+  CounterVariable *m_loop_wait_time;
+  CounterVariable *m_loop_events;
+  CounterVariable *m_loop_full_polls;
+  IntegerVariable *m_connected_descriptors;
+  Clock *m_clock;
+  TimeStamp m_wake_up_time;
+  const unsigned int m_entries;
+  bool m_multishot;
+  uint32_t m_next_generation;
+
+  int m_ring_fd;
+  void *m_sq_ring;
+  size_t m_sq_ring_size;
+  void *m_cq_ring;
+  size_t m_cq_ring_size;
+  struct io_uring_sqe *m_sqes;
+  size_t m_sqes_size;
+
+  // Pointers into the shared rings.
+  unsigned int *m_sq_head;
+  unsigned int *m_sq_tail;
+  unsigned int *m_sq_array;
+  unsigned int m_sq_mask;
+  unsigned int m_sq_entries;
+  unsigned int *m_cq_head;
+  unsigned int *m_cq_tail;
+  struct io_uring_cqe *m_cqes;
+  unsigned int m_cq_mask;
+
+  // Our copy of the submission tail, published before each io_uring_enter().
+  unsigned int m_local_sq_tail;
+  std::vector<struct io_uring_cqe> m_completions;
+
+  std::pair<IOUringData*, bool> LookupOrCreateDescriptor(int fd);
+  bool AddRequest(int fd, IOUringData *data, bool write);
+  bool RemoveDescriptor(int fd, bool write, bool warn_on_missing);
+  void ArmRequest(int fd, IOUringData *data, bool write);
+  void CancelRequest(int fd, IOUringData *data, bool write);
+  void HandleCompletion(const struct io_uring_cqe &cqe);
+  void CheckRead(IOUringData *data, uint32_t revents);
+
+  struct io_uring_sqe *GetSQE();
+  unsigned int PublishSubmissions();
+  bool Enter(unsigned int to_submit, unsigned int min_complete,
+             unsigned int flags, int timeout_ms);
+  void ReapCompletions();
+  void ReleaseRings();
+
+  static const uint64_t CANCEL_USER_DATA;
+
+  DISALLOW_COPY_AND_ASSIGN(IOUringPoller);
+};
+}  // namespace io
+}  // namespace ola
+#endif  // COMMON_IO_IOURINGPOLLER_H_
@@ -90,12 +90,18 @@ KQueuePoller::KQueuePoller(ExportMap *export_map, Clock* clock)
     : m_export_map(export_map),
       m_loop_iterations(NULL),
       m_loop_time(NULL),
+      m_loop_wait_time(NULL),
+      m_loop_events(NULL),
+      m_loop_full_polls(NULL),
       m_kqueue_fd(INVALID_DESCRIPTOR),
       m_next_change_entry(0),
       m_clock(clock) {
   if (m_export_map) {
     m_loop_time = m_export_map->GetCounterVar(K_LOOP_TIME);
     m_loop_iterations = m_export_map->GetCounterVar(K_LOOP_COUNT);
+    m_loop_wait_time = m_export_map->GetCounterVar(K_LOOP_WAIT_TIME);
+    m_loop_events = m_export_map->GetCounterVar(K_LOOP_EVENTS);
+    m_loop_full_polls = m_export_map->GetCounterVar(K_LOOP_FULL_POLLS);
   }
 
   m_kqueue_fd = kqueue();
@@ -254,6 +260,11 @@ bool KQueuePoller::Poll(TimeoutManager *timeout_manager,
   sleep_time.tv_sec = sleep_interval.Seconds();
   sleep_time.tv_nsec = sleep_interval.MicroSeconds() * 1000;
 
+  TimeStamp wait_start;
+  if (m_loop_wait_time) {
+    m_clock->CurrentTime(&wait_start);
+  }
+
   int ready = kevent(
       m_kqueue_fd, reinterpret_cast<struct kevent*>(m_change_set),
       m_next_change_entry, events, MAX_EVENTS, &sleep_time);
@@ -262,6 +273,9 @@ bool KQueuePoller::Poll(TimeoutManager *timeout_manager,
 
   if (ready == 0) {
     m_clock->CurrentTime(&m_wake_up_time);
+    if (m_loop_wait_time) {
+      (*m_loop_wait_time) += (m_wake_up_time - wait_start).AsInt();
+    }
     timeout_manager->ExecuteTimeouts(&m_wake_up_time);
     return true;
   } else if (ready == -1) {
@@ -272,6 +286,15 @@ bool KQueuePoller::Poll(TimeoutManager *timeout_manager,
   }
 
   m_clock->CurrentTime(&m_wake_up_time);
+  if (m_loop_wait_time) {
+    (*m_loop_wait_time) += (m_wake_up_time - wait_start).AsInt();
+  }
+  if (m_loop_events) {
+    (*m_loop_events) += ready;
+  }
+  if (ready == MAX_EVENTS && m_loop_full_polls) {
+    (*m_loop_full_polls)++;
+  }
 
   for (int i = 0; i < ready; i++) {
     if (events[i].flags & EV_ERROR) {
@@ -91,6 +91,9 @@ class KQueuePoller : public PollerInterface {
   ExportMap *m_export_map;
   CounterVariable *m_loop_iterations;
   CounterVariable *m_loop_time;
+  CounterVariable *m_loop_wait_time;
+  CounterVariable *m_loop_events;
+  CounterVariable *m_loop_full_polls;
   int m_kqueue_fd;
 
   struct kevent m_change_set[CHANGE_SET_SIZE];
@@ -14,7 +14,9 @@ common_libolacommon_la_SOURCES += \
     common/io/Serial.cpp \
     common/io/StdinHandler.cpp \
     common/io/TimeoutManager.cpp \
-    common/io/TimeoutManager.h
+    common/io/TimeoutManager.h \
+    common/io/TimerWheel.cpp \
+    common/io/TimerWheel.h
 
 if USING_WIN32
 common_libolacommon_la_SOURCES += \
@@ -32,12 +34,26 @@ common_libolacommon_la_SOURCES += \
     common/io/EPoller.cpp
 endif
 
+if HAVE_IO_URING
+common_libolacommon_la_SOURCES += \
+    common/io/IOUringPoller.h \
+    common/io/IOUringPoller.cpp
+endif
+
 if HAVE_KQUEUE
 common_libolacommon_la_SOURCES += \
     common/io/KQueuePoller.h \
     common/io/KQueuePoller.cpp
 endif
 
+# PROGRAMS
+##################################################
+noinst_PROGRAMS += common/io/timeout_manager_benchmark
+
+common_io_timeout_manager_benchmark_SOURCES = \
+    common/io/timeout_manager_benchmark.cpp
+common_io_timeout_manager_benchmark_LDADD = common/libolacommon.la
+
 # TESTS
 ##################################################
 test_programs += \
@@ -70,6 +86,17 @@ common_io_SelectServerTester_SOURCES = common/io/SelectServerTest.cpp \
 common_io_SelectServerTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 common_io_SelectServerTester_LDADD = $(COMMON_TESTING_LIBS)
 
+if HAVE_IO_URING
+# Run the SelectServer tests again with the io_uring poller.
+test_scripts += common/io/SelectServerIOUringTest.sh
+
+common/io/SelectServerIOUringTest.sh: common/io/Makefile.mk
+	echo "OLA_USE_IO_URING=1 ${top_builddir}/common/io/SelectServerTester${EXEEXT}; exit \$$?" > common/io/SelectServerIOUringTest.sh
+	chmod +x common/io/SelectServerIOUringTest.sh
+
+CLEANFILES += common/io/SelectServerIOUringTest.sh
+endif
+
 common_io_TimeoutManagerTester_SOURCES = common/io/TimeoutManagerTest.cpp
 common_io_TimeoutManagerTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 common_io_TimeoutManagerTester_LDADD = $(COMMON_TESTING_LIBS)
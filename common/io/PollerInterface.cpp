@@ -51,5 +51,26 @@ const char PollerInterface::K_LOOP_TIME[] = "ss-loop-time";
  */
 const char PollerInterface::K_LOOP_COUNT[] = "ss-loop-count";
 
+/**
+ * @brief The time spent blocked waiting for events, in microseconds.
+ */
+const char PollerInterface::K_LOOP_WAIT_TIME[] = "ss-loop-wait-time";
+
+/**
+ * @brief The number of ready descriptors returned by the poll calls.
+ *
+ * Divide by K_LOOP_COUNT for the events per wakeup.
+ */
+const char PollerInterface::K_LOOP_EVENTS[] = "ss-loop-events";
+
+/**
+ * @brief The number of poll calls which returned as many events as they had
+ * room for.
+ *
+ * select() doesn't have an event array, so this is always 0 with the
+ * SelectPoller.
+ */
+const char PollerInterface::K_LOOP_FULL_POLLS[] = "ss-loop-full-polls";
+
 }  // namespace io
 }  // namespace ola
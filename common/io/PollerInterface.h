@@ -147,6 +147,9 @@ class PollerInterface {
  protected:
   static const char K_LOOP_TIME[];
   static const char K_LOOP_COUNT[];
+  static const char K_LOOP_WAIT_TIME[];
+  static const char K_LOOP_EVENTS[];
+  static const char K_LOOP_FULL_POLLS[];
 };
 }  // namespace io
 }  // namespace ola
@@ -101,10 +101,16 @@ SelectPoller::SelectPoller(ExportMap *export_map, Clock* clock)
     : m_export_map(export_map),
       m_loop_iterations(NULL),
       m_loop_time(NULL),
+      m_loop_wait_time(NULL),
+      m_loop_events(NULL),
       m_clock(clock) {
   if (m_export_map) {
     m_loop_time = m_export_map->GetCounterVar(K_LOOP_TIME);
     m_loop_iterations = m_export_map->GetCounterVar(K_LOOP_COUNT);
+    m_loop_wait_time = m_export_map->GetCounterVar(K_LOOP_WAIT_TIME);
+    m_loop_events = m_export_map->GetCounterVar(K_LOOP_EVENTS);
+    // Created so the same variables exist for every poller.
+    m_export_map->GetCounterVar(K_LOOP_FULL_POLLS);
   }
 }
 
@@ -237,11 +243,20 @@ bool SelectPoller::Poll(TimeoutManager *timeout_manager,
       (*m_loop_iterations)++;
   }
 
+  TimeStamp wait_start;
+  if (m_loop_wait_time) {
+    m_clock->CurrentTime(&wait_start);
+  }
+
   sleep_interval.AsTimeval(&tv);
-  switch (select(maxsd + 1, &r_fds, &w_fds, NULL, &tv)) {
+  int ready = select(maxsd + 1, &r_fds, &w_fds, NULL, &tv);
+  switch (ready) {
     case 0:
       // timeout
       m_clock->CurrentTime(&m_wake_up_time);
+      if (m_loop_wait_time) {
+        (*m_loop_wait_time) += (m_wake_up_time - wait_start).AsInt();
+      }
       timeout_manager->ExecuteTimeouts(&m_wake_up_time);
 
       if (closed_descriptors) {
@@ -259,6 +274,12 @@ bool SelectPoller::Poll(TimeoutManager *timeout_manager,
       return false;
     default:
       m_clock->CurrentTime(&m_wake_up_time);
+      if (m_loop_wait_time) {
+        (*m_loop_wait_time) += (m_wake_up_time - wait_start).AsInt();
+      }
+      if (m_loop_events) {
+        (*m_loop_events) += ready;
+      }
       CheckDescriptors(&r_fds, &w_fds);
       m_clock->CurrentTime(&m_wake_up_time);
       timeout_manager->ExecuteTimeouts(&m_wake_up_time);
@@ -78,6 +78,8 @@ class SelectPoller : public PollerInterface {
   ExportMap *m_export_map;
   CounterVariable *m_loop_iterations;
   CounterVariable *m_loop_time;
+  CounterVariable *m_loop_wait_time;
+  CounterVariable *m_loop_events;
   Clock *m_clock;
   TimeStamp m_wake_up_time;
 
@@ -56,8 +56,21 @@
 #include "common/io/EPoller.h"
 DEFINE_default_bool(use_epoll, true,
                     "Disable the use of epoll(), revert to select()");
+DEFINE_uint32(epoll_max_events, ola::io::EPoller::DEFAULT_MAX_EVENTS,
+              "The maximum number of events to handle per epoll() call");
+DEFINE_default_bool(epoll_edge_triggered, false,
+                    "Use edge triggered epoll() for descriptors which are "
+                    "drained on each read. Only the SelectServer's wake-up "
+                    "pipe does this, so other descriptors are unaffected");
 #endif  // HAVE_EPOLL
 
+#ifdef HAVE_IO_URING
+#include "common/io/IOUringPoller.h"
+DEFINE_default_bool(use_io_uring, false,
+                    "Use io_uring rather than epoll(), if the kernel supports "
+                    "it");
+#endif  // HAVE_IO_URING
+
 #ifdef HAVE_KQUEUE
 #include "common/io/KQueuePoller.h"
 DEFINE_default_bool(use_kqueue, false,
@@ -291,20 +304,52 @@ void SelectServer::Init(const Options &options) {
     m_export_map->GetIntegerVar(PollerInterface::K_CONNECTED_DESCRIPTORS_VAR);
   }
 
-  m_timeout_manager.reset(new TimeoutManager(m_export_map, m_clock));
+  m_timeout_manager.reset(new TimeoutManager(m_export_map, m_clock,
+                                             options.use_timer_wheel));
 #ifdef _WIN32
   m_poller.reset(new WindowsPoller(m_export_map, m_clock));
   (void) options;
 #else
 
+  bool force_epoll = false;
+#ifdef HAVE_IO_URING
+  bool using_io_uring = false;
+  if ((options.use_io_uring || FLAGS_use_io_uring) && !options.force_select) {
+    IOUringPoller::Options io_uring_options;
+    io_uring_options.multishot = (options.edge_triggered ||
+                                  FLAGS_epoll_edge_triggered);
+    std::auto_ptr<IOUringPoller> poller(
+        new IOUringPoller(m_export_map, m_clock, io_uring_options));
+    if (poller->Init()) {
+      m_poller.reset(poller.release());
+      using_io_uring = true;
+    } else {
+      OLA_WARN << "io_uring isn't available, falling back to epoll()";
+      force_epoll = true;
+    }
+  }
+  if (m_export_map) {
+    m_export_map->GetBoolVar("using-io-uring")->Set(using_io_uring);
+  }
+#endif  // HAVE_IO_URING
+
 #ifdef HAVE_EPOLL
-  if (FLAGS_use_epoll && !options.force_select) {
-    m_poller.reset(new EPoller(m_export_map, m_clock));
+  bool using_epoll = false;
+  if ((FLAGS_use_epoll || force_epoll) && !m_poller.get() &&
+      !options.force_select) {
+    EPoller::Options epoll_options;
+    epoll_options.max_events = options.max_poll_events ?
+        options.max_poll_events : FLAGS_epoll_max_events;
+    epoll_options.edge_triggered = (options.edge_triggered ||
+                                    FLAGS_epoll_edge_triggered);
+    m_poller.reset(new EPoller(m_export_map, m_clock, epoll_options));
+    using_epoll = true;
   }
   if (m_export_map) {
-    m_export_map->GetBoolVar("using-epoll")->Set(FLAGS_use_epoll);
+    m_export_map->GetBoolVar("using-epoll")->Set(using_epoll);
   }
 #endif  // HAVE_EPOLL
+  (void) force_epoll;
 
 #ifdef HAVE_KQUEUE
   bool using_kqueue = false;
@@ -330,6 +375,7 @@ void SelectServer::Init(const Options &options) {
   }
   m_incoming_descriptor.SetOnData(
       ola::NewCallback(this, &SelectServer::DrainAndExecute));
+  m_incoming_descriptor.SetDrainsOnRead(true);
   AddReadDescriptor(&m_incoming_descriptor);
 }
 
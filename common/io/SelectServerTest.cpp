@@ -23,6 +23,10 @@
  * turn means implementations of PollerInterface also need to be reentrant.
  */
 
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
 #ifdef _WIN32
 #include <ola/win/CleanWinSock2.h>
 #endif  // _WIN32
@@ -38,7 +42,10 @@
 #include "ola/Logging.h"
 #include "ola/base/Array.h"
 #include "ola/io/SelectServer.h"
+#include "ola/network/IPV4Address.h"
 #include "ola/network/Socket.h"
+#include "ola/network/SocketAddress.h"
+#include "ola/network/UDPReceiveRing.h"
 #include "ola/testing/TestUtils.h"
 
 using ola::ExportMap;
@@ -52,6 +59,9 @@ using ola::io::PollerInterface;
 using ola::io::SelectServer;
 using ola::io::UnixSocket;
 using ola::io::WriteFileDescriptor;
+using ola::network::IPV4Address;
+using ola::network::IPV4SocketAddress;
+using ola::network::UDPReceiveRing;
 using ola::network::UDPSocket;
 using std::auto_ptr;
 using std::set;
@@ -95,6 +105,8 @@ class SelectServerTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testTimeout);
   CPPUNIT_TEST(testOffByOneTimeout);
   CPPUNIT_TEST(testLoopCallbacks);
+  CPPUNIT_TEST(testEventBatches);
+  CPPUNIT_TEST(testEdgeTriggeredUDP);
   CPPUNIT_TEST_SUITE_END();
 
  public:
@@ -115,6 +127,8 @@ class SelectServerTest: public CppUnit::TestFixture {
   void testTimeout();
   void testOffByOneTimeout();
   void testLoopCallbacks();
+  void testEventBatches();
+  void testEdgeTriggeredUDP();
 
   void FatalTimeout() {
     OLA_FAIL("Fatal Timeout");
@@ -187,9 +201,29 @@ class SelectServerTest: public CppUnit::TestFixture {
 
   void IncrementLoopCounter() { m_loop_counter++; }
 
+  void DrainDescriptor(ConnectedDescriptor *descriptor) {
+    uint8_t data[10];
+    unsigned int size;
+    while (descriptor->DataRemaining()) {
+      descriptor->Receive(data, arraysize(data), size);
+    }
+    m_read_counter++;
+  }
+
+  void DrainUDPSocket(UDPSocket *socket, UDPReceiveRing *ring) {
+    do {
+      m_datagram_counter += ring->Receive(socket);
+    } while (ring->Full());
+    m_read_counter++;
+  }
+
+  void CheckEventBatches(bool force_select);
+
  private:
   unsigned int m_timeout_counter;
   unsigned int m_loop_counter;
+  unsigned int m_read_counter;
+  unsigned int m_datagram_counter;
   ExportMap m_map;
   IntegerVariable *connected_read_descriptor_count;
   IntegerVariable *read_descriptor_count;
@@ -211,6 +245,8 @@ void SelectServerTest::setUp() {
   m_ss = new SelectServer(&m_map);
   m_timeout_counter = 0;
   m_loop_counter = 0;
+  m_read_counter = 0;
+  m_datagram_counter = 0;
 
 #if _WIN32
   WSADATA wsa_data;
@@ -660,3 +696,126 @@ void SelectServerTest::testLoopCallbacks() {
   // we should have at least 5 calls to IncrementLoopCounter
   OLA_ASSERT_TRUE(m_loop_counter >= 5);
 }
+
+/*
+ * Check that descriptors are handled when there are more ready than the
+ * poller has room for, and that descriptors which drain on read are reported
+ * again when new data arrives.
+ */
+void SelectServerTest::testEventBatches() {
+  CheckEventBatches(false);
+  m_read_counter = 0;
+  CheckEventBatches(true);
+}
+
+void SelectServerTest::CheckEventBatches(bool force_select) {
+  const unsigned int DESCRIPTOR_COUNT = 5;
+  ExportMap export_map;
+  SelectServer::Options options;
+  options.export_map = &export_map;
+  options.force_select = force_select;
+  options.max_poll_events = 2;
+  options.edge_triggered = true;
+  SelectServer ss(options);
+
+  LoopbackDescriptor descriptors[DESCRIPTOR_COUNT];
+  for (unsigned int i = 0; i < DESCRIPTOR_COUNT; i++) {
+    OLA_ASSERT_TRUE(descriptors[i].Init());
+    descriptors[i].SetOnData(
+        NewCallback(this, &SelectServerTest::DrainDescriptor,
+                    static_cast<ConnectedDescriptor*>(&descriptors[i])));
+    descriptors[i].SetDrainsOnRead(true);
+    OLA_ASSERT_TRUE(ss.AddReadDescriptor(&descriptors[i]));
+  }
+
+  const uint8_t data[] = {1, 2, 3};
+  for (unsigned int i = 0; i < DESCRIPTOR_COUNT; i++) {
+    descriptors[i].Send(data, arraysize(data));
+  }
+  for (unsigned int i = 0;
+       i < DESCRIPTOR_COUNT && m_read_counter < DESCRIPTOR_COUNT; i++) {
+    ss.RunOnce();
+  }
+  OLA_ASSERT_EQ(DESCRIPTOR_COUNT, m_read_counter);
+
+  descriptors[2].Send(data, arraysize(data));
+  for (unsigned int i = 0;
+       i < DESCRIPTOR_COUNT && m_read_counter == DESCRIPTOR_COUNT; i++) {
+    ss.RunOnce();
+  }
+  OLA_ASSERT_EQ(DESCRIPTOR_COUNT + 1, m_read_counter);
+
+#ifndef _WIN32
+  OLA_ASSERT_EQ(DESCRIPTOR_COUNT + 1,
+                export_map.GetCounterVar("ss-loop-events")->Get());
+  if (force_select) {
+    OLA_ASSERT_EQ(0u, export_map.GetCounterVar("ss-loop-full-polls")->Get());
+  }
+#endif  // _WIN32
+#ifdef HAVE_EPOLL
+  if (export_map.GetBoolVar("using-epoll")->Get()) {
+    OLA_ASSERT_TRUE(
+        export_map.GetCounterVar("ss-loop-full-polls")->Get() >= 2);
+  }
+#endif  // HAVE_EPOLL
+
+  for (unsigned int i = 0; i < DESCRIPTOR_COUNT; i++) {
+    ss.RemoveReadDescriptor(&descriptors[i]);
+  }
+}
+
+
+/*
+ * Check that an edge triggered UDP socket with several datagrams queued is
+ * drained by a single callback, and is reported again when the next one
+ * arrives.
+ */
+void SelectServerTest::testEdgeTriggeredUDP() {
+  if (!UDPReceiveRing::DrainsSocket()) {
+    return;
+  }
+
+  SelectServer::Options options;
+  options.edge_triggered = true;
+  SelectServer ss(options);
+
+  UDPSocket socket, sender;
+  OLA_ASSERT_TRUE(socket.Init());
+  OLA_ASSERT_TRUE(socket.Bind(IPV4SocketAddress(IPV4Address::Loopback(), 0)));
+  IPV4SocketAddress address;
+  OLA_ASSERT_TRUE(socket.GetSocketAddress(&address));
+  OLA_ASSERT_TRUE(sender.Init());
+
+  // Fewer slots than datagrams, so the callback reads several batches.
+  UDPReceiveRing ring(2, 16);
+  socket.SetOnData(NewCallback(this, &SelectServerTest::DrainUDPSocket,
+                               &socket, &ring));
+  socket.SetDrainsOnRead(true);
+  OLA_ASSERT_TRUE(ss.AddReadDescriptor(&socket));
+
+  const uint8_t data[] = {1, 2, 3};
+  const unsigned int DATAGRAM_COUNT = 5;
+  for (unsigned int i = 0; i < DATAGRAM_COUNT; i++) {
+    OLA_ASSERT_EQ(static_cast<ssize_t>(arraysize(data)),
+                  sender.SendTo(data, arraysize(data), address));
+  }
+  for (unsigned int i = 0; i < 10 && !m_read_counter; i++) {
+    ss.RunOnce(ola::TimeInterval(0, 100000));
+  }
+  OLA_ASSERT_EQ(1u, m_read_counter);
+  OLA_ASSERT_EQ(DATAGRAM_COUNT, m_datagram_counter);
+
+  // Nothing is left to read.
+  ss.RunOnce(ola::TimeInterval(0, 10000));
+  OLA_ASSERT_EQ(1u, m_read_counter);
+
+  OLA_ASSERT_EQ(static_cast<ssize_t>(arraysize(data)),
+                sender.SendTo(data, arraysize(data), address));
+  for (unsigned int i = 0; i < 10 && m_read_counter == 1; i++) {
+    ss.RunOnce(ola::TimeInterval(0, 100000));
+  }
+  OLA_ASSERT_EQ(2u, m_read_counter);
+  OLA_ASSERT_EQ(DATAGRAM_COUNT + 1, m_datagram_counter);
+
+  ss.RemoveReadDescriptor(&socket);
+}
@@ -37,12 +37,16 @@ using ola::thread::INVALID_TIMEOUT;
 using ola::thread::timeout_id;
 
 TimeoutManager::TimeoutManager(ExportMap *export_map,
-                               Clock *clock)
+                               Clock *clock,
+                               bool use_timer_wheel)
     : m_export_map(export_map),
       m_clock(clock) {
   if (m_export_map) {
     m_export_map->GetIntegerVar(K_TIMER_VAR);
   }
+  if (use_timer_wheel) {
+    m_timer_wheel.reset(new TimerWheel(export_map, clock, K_TIMER_VAR));
+  }
 }
 
 TimeoutManager::~TimeoutManager() {
@@ -57,6 +61,9 @@ TimeoutManager::~TimeoutManager() {
 timeout_id TimeoutManager::RegisterRepeatingTimeout(
     const TimeInterval &interval,
     ola::Callback0<bool> *closure) {
+  if (m_timer_wheel.get())
+    return m_timer_wheel->RegisterRepeatingTimeout(interval, closure);
+
   if (!closure)
     return INVALID_TIMEOUT;
 
@@ -71,6 +78,9 @@ timeout_id TimeoutManager::RegisterRepeatingTimeout(
 timeout_id TimeoutManager::RegisterSingleTimeout(
     const TimeInterval &interval,
     ola::SingleUseCallback0<void> *closure) {
+  if (m_timer_wheel.get())
+    return m_timer_wheel->RegisterSingleTimeout(interval, closure);
+
   if (!closure)
     return INVALID_TIMEOUT;
 
@@ -88,11 +98,19 @@ void TimeoutManager::CancelTimeout(timeout_id id) {
   if (id == INVALID_TIMEOUT)
     return;
 
+  if (m_timer_wheel.get()) {
+    m_timer_wheel->CancelTimeout(id);
+    return;
+  }
+
   if (!m_removed_timeouts.insert(id).second)
     OLA_WARN << "timeout " << id << " already in remove set";
 }
 
 TimeInterval TimeoutManager::ExecuteTimeouts(TimeStamp *now) {
+  if (m_timer_wheel.get())
+    return m_timer_wheel->ExecuteTimeouts(now);
+
   Event *e;
   if (m_events.empty())
     return TimeInterval();
@@ -21,6 +21,7 @@
 #ifndef COMMON_IO_TIMEOUTMANAGER_H_
 #define COMMON_IO_TIMEOUTMANAGER_H_
 
+#include <memory>
 #include <queue>
 #include <set>
 #include <vector>
@@ -30,6 +31,7 @@
 #include "ola/ExportMap.h"
 #include "ola/base/Macro.h"
 #include "ola/thread/SchedulerInterface.h"
+#include "common/io/TimerWheel.h"
 
 namespace ola {
 namespace io {
@@ -41,6 +43,10 @@ namespace io {
  *
  * The TimeoutManager allows Callbacks to trigger at some point in the future.
  * Callbacks can be invoked once, or periodically.
+ *
+ * By default the events are held in a priority queue. Alternatively a
+ * TimerWheel can be used, which has O(1) registration and cancellation and
+ * doesn't allocate memory for each event.
  */
 class TimeoutManager {
  public :
@@ -48,8 +54,10 @@ class TimeoutManager {
    * @brief Create a new TimeoutManager.
    * @param export_map an ExportMap to update
    * @param clock the Clock to use.
+   * @param use_timer_wheel use a TimerWheel rather than the priority queue.
    */
-  TimeoutManager(ola::ExportMap *export_map, Clock *clock);
+  TimeoutManager(ola::ExportMap *export_map, Clock *clock,
+                 bool use_timer_wheel = false);
 
   ~TimeoutManager();
 
@@ -89,6 +97,8 @@ class TimeoutManager {
    * @returns true if there are events pending, false otherwise.
    */
   bool EventsPending() const {
+    if (m_timer_wheel.get())
+      return m_timer_wheel->EventsPending();
     return !m_events.empty();
   }
 
@@ -192,6 +202,7 @@ class TimeoutManager {
 
   event_queue_t m_events;
   std::set<ola::thread::timeout_id> m_removed_timeouts;
+  std::auto_ptr<TimerWheel> m_timer_wheel;
 
   DISALLOW_COPY_AND_ASSIGN(TimeoutManager);
 };
@@ -44,13 +44,23 @@ class TimeoutManagerTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testRepeatingTimeouts);
   CPPUNIT_TEST(testAbortedRepeatingTimeouts);
   CPPUNIT_TEST(testPendingEventShutdown);
+  CPPUNIT_TEST(testCancelFromCallback);
+  CPPUNIT_TEST(testLongTimeouts);
+  CPPUNIT_TEST(testCancelEarliest);
+  CPPUNIT_TEST(testRegisterCancelCycles);
   CPPUNIT_TEST_SUITE_END();
 
  public:
+    TimeoutManagerTest() : m_use_timer_wheel(false) {}
+
     void testSingleTimeouts();
     void testRepeatingTimeouts();
     void testAbortedRepeatingTimeouts();
     void testPendingEventShutdown();
+    void testCancelFromCallback();
+    void testLongTimeouts();
+    void testCancelEarliest();
+    void testRegisterCancelCycles();
 
     void HandleEvent(unsigned int event_id) {
       m_event_counters[event_id]++;
@@ -67,24 +77,51 @@ class TimeoutManagerTest: public CppUnit::TestFixture {
       return m_event_counters[event_id] < 2;
     }
 
+    // cancels itself on the first run.
+    bool HandleSelfCancellingEvent(unsigned int event_id) {
+      m_event_counters[event_id]++;
+      m_timeout_manager->CancelTimeout(m_timeout_id);
+      return true;
+    }
+
     unsigned int GetEventCounter(unsigned int event_id) {
       return m_event_counters[event_id];
     }
 
+ protected:
+    bool m_use_timer_wheel;
+
  private:
     ExportMap m_map;
     std::map<unsigned int, unsigned int> m_event_counters;
+    TimeoutManager *m_timeout_manager;
+    timeout_id m_timeout_id;
+};
+
+
+/*
+ * Run the same tests with the timer wheel.
+ */
+class TimerWheelTest: public TimeoutManagerTest {
+  CPPUNIT_TEST_SUB_SUITE(TimerWheelTest, TimeoutManagerTest);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    TimerWheelTest() {
+      m_use_timer_wheel = true;
+    }
 };
 
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TimeoutManagerTest);
+CPPUNIT_TEST_SUITE_REGISTRATION(TimerWheelTest);
 
 /*
  * Check RegisterSingleTimeout works.
  */
 void TimeoutManagerTest::testSingleTimeouts() {
   MockClock clock;
-  TimeoutManager timeout_manager(&m_map, &clock);
+  TimeoutManager timeout_manager(&m_map, &clock, m_use_timer_wheel);
 
   OLA_ASSERT_FALSE(timeout_manager.EventsPending());
 
@@ -138,7 +175,7 @@ void TimeoutManagerTest::testSingleTimeouts() {
  */
 void TimeoutManagerTest::testRepeatingTimeouts() {
   MockClock clock;
-  TimeoutManager timeout_manager(&m_map, &clock);
+  TimeoutManager timeout_manager(&m_map, &clock, m_use_timer_wheel);
 
   OLA_ASSERT_FALSE(timeout_manager.EventsPending());
 
@@ -192,7 +229,7 @@ void TimeoutManagerTest::testRepeatingTimeouts() {
  */
 void TimeoutManagerTest::testAbortedRepeatingTimeouts() {
   MockClock clock;
-  TimeoutManager timeout_manager(&m_map, &clock);
+  TimeoutManager timeout_manager(&m_map, &clock, m_use_timer_wheel);
 
   OLA_ASSERT_FALSE(timeout_manager.EventsPending());
 
@@ -224,7 +261,7 @@ void TimeoutManagerTest::testAbortedRepeatingTimeouts() {
  */
 void TimeoutManagerTest::testPendingEventShutdown() {
   MockClock clock;
-  TimeoutManager timeout_manager(&m_map, &clock);
+  TimeoutManager timeout_manager(&m_map, &clock, m_use_timer_wheel);
 
   OLA_ASSERT_FALSE(timeout_manager.EventsPending());
 
@@ -241,3 +278,172 @@ void TimeoutManagerTest::testPendingEventShutdown() {
 
   OLA_ASSERT_TRUE(timeout_manager.EventsPending());
 }
+
+
+/*
+ * Check a repeating timeout can cancel itself.
+ */
+void TimeoutManagerTest::testCancelFromCallback() {
+  MockClock clock;
+  TimeoutManager timeout_manager(&m_map, &clock, m_use_timer_wheel);
+  m_timeout_manager = &timeout_manager;
+
+  TimeInterval timeout_interval(0, 100000);
+  m_timeout_id = timeout_manager.RegisterRepeatingTimeout(
+      timeout_interval,
+      NewCallback(this, &TimeoutManagerTest::HandleSelfCancellingEvent, 1u));
+  OLA_ASSERT_NE(m_timeout_id, ola::thread::INVALID_TIMEOUT);
+
+  TimeStamp last_checked_time;
+  clock.AdvanceTime(0, 100001);
+  clock.CurrentTime(&last_checked_time);
+  timeout_manager.ExecuteTimeouts(&last_checked_time);
+  OLA_ASSERT_EQ(1u, GetEventCounter(1));
+
+  clock.AdvanceTime(0, 100001);
+  clock.CurrentTime(&last_checked_time);
+  TimeInterval next = timeout_manager.ExecuteTimeouts(&last_checked_time);
+  OLA_ASSERT_TRUE(next.IsZero());
+  OLA_ASSERT_EQ(1u, GetEventCounter(1));
+  OLA_ASSERT_FALSE(timeout_manager.EventsPending());
+}
+
+
+/*
+ * Check timeouts far in the future fire at the right time, and don't delay
+ * the earlier ones.
+ */
+void TimeoutManagerTest::testLongTimeouts() {
+  MockClock clock;
+  TimeoutManager timeout_manager(&m_map, &clock, m_use_timer_wheel);
+
+  timeout_manager.RegisterSingleTimeout(
+      TimeInterval(3600, 0),
+      NewSingleCallback(this, &TimeoutManagerTest::HandleEvent, 1u));
+  timeout_manager.RegisterSingleTimeout(
+      TimeInterval(70, 0),
+      NewSingleCallback(this, &TimeoutManagerTest::HandleEvent, 2u));
+  timeout_manager.RegisterSingleTimeout(
+      TimeInterval(0, 300000),
+      NewSingleCallback(this, &TimeoutManagerTest::HandleEvent, 3u));
+
+  TimeStamp last_checked_time;
+  clock.CurrentTime(&last_checked_time);
+  TimeInterval next = timeout_manager.ExecuteTimeouts(&last_checked_time);
+  OLA_ASSERT_LTE(next, TimeInterval(0, 300000));
+  OLA_ASSERT_GT(next, TimeInterval(0, 200000));
+
+  clock.AdvanceTime(0, 300001);
+  clock.CurrentTime(&last_checked_time);
+  next = timeout_manager.ExecuteTimeouts(&last_checked_time);
+  OLA_ASSERT_EQ(1u, GetEventCounter(3));
+  OLA_ASSERT_LTE(next, TimeInterval(69, 700000));
+  OLA_ASSERT_GT(next, TimeInterval(69, 600000));
+
+  clock.AdvanceTime(69, 600000);
+  clock.CurrentTime(&last_checked_time);
+  next = timeout_manager.ExecuteTimeouts(&last_checked_time);
+  OLA_ASSERT_EQ(0u, GetEventCounter(2));
+  OLA_ASSERT_LTE(next, TimeInterval(0, 100000));
+
+  clock.AdvanceTime(0, 100001);
+  clock.CurrentTime(&last_checked_time);
+  next = timeout_manager.ExecuteTimeouts(&last_checked_time);
+  OLA_ASSERT_EQ(1u, GetEventCounter(2));
+  OLA_ASSERT_LTE(next, TimeInterval(3530, 0));
+  OLA_ASSERT_GT(next, TimeInterval(3529, 0));
+
+  clock.AdvanceTime(3530, 0);
+  clock.CurrentTime(&last_checked_time);
+  next = timeout_manager.ExecuteTimeouts(&last_checked_time);
+  OLA_ASSERT_EQ(1u, GetEventCounter(1));
+  OLA_ASSERT_TRUE(next.IsZero());
+  OLA_ASSERT_FALSE(timeout_manager.EventsPending());
+}
+
+
+/*
+ * Check that cancelling the earliest timeout doesn't delay the next one.
+ */
+void TimeoutManagerTest::testCancelEarliest() {
+  MockClock clock;
+  TimeoutManager timeout_manager(&m_map, &clock, m_use_timer_wheel);
+
+  // The mock clock also follows the real time, so the expiry time of the
+  // timeouts lies between these two.
+  TimeStamp earliest_due, latest_due;
+  clock.CurrentTime(&earliest_due);
+  earliest_due += TimeInterval(0, 700000);
+  timeout_id id = timeout_manager.RegisterSingleTimeout(
+      TimeInterval(0, 600000),
+      NewSingleCallback(this, &TimeoutManagerTest::HandleEvent, 1u));
+  for (unsigned int i = 0; i < 10; i++) {
+    timeout_manager.RegisterSingleTimeout(
+        TimeInterval(0, 700000),
+        NewSingleCallback(this, &TimeoutManagerTest::HandleEvent, 2u));
+  }
+  clock.CurrentTime(&latest_due);
+  latest_due += TimeInterval(0, 700000);
+
+  TimeStamp last_checked_time;
+  clock.CurrentTime(&last_checked_time);
+  TimeInterval next = timeout_manager.ExecuteTimeouts(&last_checked_time);
+  OLA_ASSERT_LTE(next, TimeInterval(0, 600000));
+  timeout_manager.CancelTimeout(id);
+
+  // The timer wheel may ask to be woken early, but never late, and the
+  // timeouts mustn't run until they're due.
+  next = timeout_manager.ExecuteTimeouts(&last_checked_time);
+  while (GetEventCounter(2) < 10) {
+    OLA_ASSERT_FALSE(next.IsZero());
+    OLA_ASSERT_LTE(last_checked_time + next, latest_due);
+    clock.AdvanceTime(next);
+    clock.CurrentTime(&last_checked_time);
+    next = timeout_manager.ExecuteTimeouts(&last_checked_time);
+  }
+  OLA_ASSERT_LTE(earliest_due, last_checked_time);
+  OLA_ASSERT_EQ(10u, GetEventCounter(2));
+  OLA_ASSERT_EQ(0u, GetEventCounter(1));
+  OLA_ASSERT_FALSE(timeout_manager.EventsPending());
+}
+
+
+/*
+ * Check that timeouts which are registered and cancelled before they're due
+ * never run, and don't disturb the other timeouts.
+ */
+void TimeoutManagerTest::testRegisterCancelCycles() {
+  const unsigned int BACKGROUND_TIMEOUTS = 500;
+  const unsigned int CYCLES = 2000;
+  MockClock clock;
+  TimeoutManager timeout_manager(&m_map, &clock, m_use_timer_wheel);
+
+  // Intervals from 1 to 10s, 50 of each.
+  for (unsigned int i = 0; i < BACKGROUND_TIMEOUTS; i++) {
+    timeout_manager.RegisterRepeatingTimeout(
+        TimeInterval(1 + i % 10, 0),
+        NewCallback(this, &TimeoutManagerTest::HandleRepeatingEvent, 1u));
+  }
+
+  TimeStamp last_checked_time;
+  for (unsigned int i = 0; i < CYCLES; i++) {
+    timeout_id id = timeout_manager.RegisterSingleTimeout(
+        TimeInterval(0, 500000),
+        NewSingleCallback(this, &TimeoutManagerTest::HandleEvent, 2u));
+    clock.AdvanceTime(0, 1000);
+    clock.CurrentTime(&last_checked_time);
+    timeout_manager.ExecuteTimeouts(&last_checked_time);
+    timeout_manager.CancelTimeout(id);
+  }
+
+  // Let the queue discard the cancelled timeouts.
+  clock.AdvanceTime(0, 500000);
+  clock.CurrentTime(&last_checked_time);
+  timeout_manager.ExecuteTimeouts(&last_checked_time);
+
+  // After 2.5s the 1s timeouts have run twice and the 2s timeouts once.
+  OLA_ASSERT_EQ(0u, GetEventCounter(2));
+  OLA_ASSERT_EQ(150u, GetEventCounter(1));
+  OLA_ASSERT_EQ(static_cast<int>(BACKGROUND_TIMEOUTS),
+                m_map.GetIntegerVar(TimeoutManager::K_TIMER_VAR)->Get());
+}
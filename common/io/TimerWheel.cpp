@@ -0,0 +1,436 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * TimerWheel.cpp
+ * A hierarchical timing wheel.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <stdint.h>
+#include <algorithm>
+#include <vector>
+
+#include "common/io/TimerWheel.h"
+#include "ola/Logging.h"
+
+namespace ola {
+namespace io {
+
+using ola::ExportMap;
+using ola::thread::INVALID_TIMEOUT;
+using ola::thread::timeout_id;
+
+TimerWheel::TimerWheel(ExportMap *export_map,
+                       Clock *clock,
+                       const char *timer_var)
+    : m_export_map(export_map),
+      m_timer_var(NULL),
+      m_clock(clock),
+      m_current_tick(0),
+      m_event_count(0),
+      m_next_expiry_valid(false),
+      m_free_head(NULL),
+      m_free_tail(NULL) {
+  if (m_export_map) {
+    m_timer_var = m_export_map->GetIntegerVar(timer_var);
+  }
+  m_clock->CurrentTime(&m_epoch);
+
+  for (unsigned int level = 0; level < LEVELS; level++) {
+    m_level_count[level] = 0;
+    for (unsigned int slot = 0; slot < SLOTS; slot++) {
+      InitList(&m_slots[level][slot]);
+    }
+  }
+}
+
+TimerWheel::~TimerWheel() {
+  for (unsigned int level = 0; level < LEVELS; level++) {
+    for (unsigned int slot = 0; slot < SLOTS; slot++) {
+      Node *head = &m_slots[level][slot];
+      for (Node *node = head->next; node != head; node = node->next) {
+        DeleteClosure(node);
+      }
+    }
+  }
+
+  std::vector<Node*>::iterator iter = m_pool_blocks.begin();
+  for (; iter != m_pool_blocks.end(); ++iter) {
+    delete[] *iter;
+  }
+}
+
+timeout_id TimerWheel::RegisterRepeatingTimeout(
+    const TimeInterval &interval,
+    ola::Callback0<bool> *closure) {
+  if (!closure)
+    return INVALID_TIMEOUT;
+
+  Node *node = AllocateNode();
+  node->repeating = true;
+  node->repeating_closure = closure;
+  node->interval = interval;
+  TimeStamp now;
+  m_clock->CurrentTime(&now);
+  node->expiry = now + interval;
+  InsertNode(node);
+  return node;
+}
+
+timeout_id TimerWheel::RegisterSingleTimeout(
+    const TimeInterval &interval,
+    ola::SingleUseCallback0<void> *closure) {
+  if (!closure)
+    return INVALID_TIMEOUT;
+
+  Node *node = AllocateNode();
+  node->repeating = false;
+  node->single_closure = closure;
+  node->interval = interval;
+  TimeStamp now;
+  m_clock->CurrentTime(&now);
+  node->expiry = now + interval;
+  InsertNode(node);
+  return node;
+}
+
+void TimerWheel::CancelTimeout(timeout_id id) {
+  if (id == INVALID_TIMEOUT)
+    return;
+
+  Node *node = static_cast<Node*>(id);
+  switch (node->state) {
+    case NODE_QUEUED:
+      UnlinkNode(node);
+      if (m_next_expiry_valid && node->expiry <= m_next_expiry) {
+        m_next_expiry_valid = false;
+      }
+      DeleteClosure(node);
+      ReleaseNode(node);
+      break;
+    case NODE_RUNNING:
+      // The closure is cleaned up once it returns.
+      node->state = NODE_CANCELLED;
+      break;
+    default:
+      OLA_WARN << "timeout " << id << " has already been removed";
+  }
+}
+
+TimeInterval TimerWheel::ExecuteTimeouts(TimeStamp *now) {
+  if (m_event_count == 0) {
+    m_current_tick = std::max(m_current_tick, TickFor(*now));
+    return TimeInterval();
+  }
+
+  // Events that are registered with a zero interval while we're running
+  // callbacks need to run in this pass, so repeat until nothing fires.
+  bool fired = true;
+  while (fired) {
+    fired = false;
+    while (true) {
+      fired |= RunDueEvents(now);
+      uint64_t target = TickFor(*now);
+      if (m_current_tick >= target)
+        break;
+      Advance(target);
+    }
+  }
+
+  // The earliest expiry may be the start of a slot that has been cascaded.
+  if (m_next_expiry_valid && m_next_expiry <= *now)
+    m_next_expiry_valid = false;
+
+  const TimeStamp *next = NextExpiry();
+  if (!next)
+    return TimeInterval();
+  return *next - *now;
+}
+
+TimerWheel::Node *TimerWheel::AllocateNode() {
+  if (!m_free_head) {
+    Node *block = new Node[POOL_BLOCK_SIZE];
+    m_pool_blocks.push_back(block);
+    for (unsigned int i = 0; i < POOL_BLOCK_SIZE; i++) {
+      block[i].state = NODE_FREE;
+      block[i].next = (i + 1 < POOL_BLOCK_SIZE) ? &block[i + 1] : NULL;
+    }
+    m_free_head = block;
+    m_free_tail = &block[POOL_BLOCK_SIZE - 1];
+  }
+
+  Node *node = m_free_head;
+  m_free_head = node->next;
+  if (!m_free_head)
+    m_free_tail = NULL;
+
+  node->prev = NULL;
+  node->next = NULL;
+  node->state = NODE_QUEUED;
+  node->level = LEVELS;
+  node->single_closure = NULL;
+  node->repeating_closure = NULL;
+
+  m_event_count++;
+  if (m_timer_var)
+    (*m_timer_var)++;
+  return node;
+}
+
+void TimerWheel::ReleaseNode(Node *node) {
+  node->state = NODE_FREE;
+  node->single_closure = NULL;
+  node->repeating_closure = NULL;
+  node->next = NULL;
+  if (m_free_tail) {
+    m_free_tail->next = node;
+  } else {
+    m_free_head = node;
+  }
+  m_free_tail = node;
+
+  m_event_count--;
+  if (m_timer_var)
+    (*m_timer_var)--;
+}
+
+/*
+ * Place a node in the slot for its expiry time.
+ */
+void TimerWheel::InsertNode(Node *node) {
+  uint64_t tick = std::max(TickFor(node->expiry), m_current_tick);
+  uint64_t delta = tick - m_current_tick;
+
+  unsigned int level = 0;
+  while (level < LEVELS - 1 && delta >= (1ULL << (SLOT_BITS * (level + 1)))) {
+    level++;
+  }
+
+  if (delta >= (1ULL << (SLOT_BITS * LEVELS))) {
+    // Further out than the wheel can hold, park it in the furthest slot, it'll
+    // be placed again when that slot is cascaded.
+    tick = m_current_tick + (1ULL << (SLOT_BITS * LEVELS)) - 1;
+  }
+
+  Node *head = &m_slots[level][(tick >> (SLOT_BITS * level)) & SLOT_MASK];
+  if (ListEmpty(head)) {
+    head->expiry = node->expiry;
+    head->earliest_valid = true;
+  } else if (head->earliest_valid && node->expiry < head->expiry) {
+    head->expiry = node->expiry;
+  }
+  node->slot = head;
+  node->level = level;
+  node->prev = head->prev;
+  node->next = head;
+  head->prev->next = node;
+  head->prev = node;
+  m_level_count[level]++;
+
+  if (m_next_expiry_valid) {
+    if (node->expiry < m_next_expiry)
+      m_next_expiry = node->expiry;
+  } else if (m_event_count == 1) {
+    m_next_expiry = node->expiry;
+    m_next_expiry_valid = true;
+  }
+}
+
+void TimerWheel::UnlinkNode(Node *node) {
+  node->prev->next = node->next;
+  node->next->prev = node->prev;
+  node->prev = NULL;
+  node->next = NULL;
+  if (node->level < LEVELS) {
+    m_level_count[node->level]--;
+    node->level = LEVELS;
+    if (node->expiry <= node->slot->expiry) {
+      node->slot->earliest_valid = false;
+    }
+  }
+}
+
+/*
+ * Move the nodes in the current slot of a level to the lower levels.
+ */
+void TimerWheel::Cascade(unsigned int level) {
+  Node *head = &m_slots[level][
+      (m_current_tick >> (SLOT_BITS * level)) & SLOT_MASK];
+  while (!ListEmpty(head)) {
+    Node *node = head->next;
+    UnlinkNode(node);
+    InsertNode(node);
+  }
+}
+
+/*
+ * Run the events in the slot for the current tick which have expired.
+ * @returns true if any events were run.
+ */
+bool TimerWheel::RunDueEvents(TimeStamp *now) {
+  Node *head = &m_slots[0][m_current_tick & SLOT_MASK];
+  if (ListEmpty(head))
+    return false;
+
+  // Move the nodes into a local list, so that the callbacks can add to the
+  // slot and cancel any event while we're working through them.
+  Node pending;
+  InitList(&pending);
+  while (!ListEmpty(head)) {
+    Node *node = head->next;
+    UnlinkNode(node);
+    node->prev = pending.prev;
+    node->next = &pending;
+    pending.prev->next = node;
+    pending.prev = node;
+  }
+
+  bool fired = false;
+  while (!ListEmpty(&pending)) {
+    Node *node = pending.next;
+    UnlinkNode(node);
+    if (node->expiry > *now) {
+      InsertNode(node);
+      continue;
+    }
+
+    fired = true;
+    if (m_next_expiry_valid && node->expiry <= m_next_expiry) {
+      m_next_expiry_valid = false;
+    }
+
+    node->state = NODE_RUNNING;
+    bool run_again = false;
+    if (node->repeating) {
+      run_again = node->repeating_closure->Run();
+    } else {
+      // it deletes itself
+      node->single_closure->Run();
+      node->single_closure = NULL;
+    }
+
+    if (run_again && node->state == NODE_RUNNING) {
+      node->state = NODE_QUEUED;
+      node->expiry = *now + node->interval;
+      InsertNode(node);
+    } else {
+      DeleteClosure(node);
+      ReleaseNode(node);
+    }
+    m_clock->CurrentTime(now);
+  }
+  return fired;
+}
+
+/*
+ * Turn the wheel towards the target tick. If the lower levels are empty we can
+ * skip straight to the next tick where a higher level cascades.
+ */
+void TimerWheel::Advance(uint64_t target) {
+  unsigned int level = 0;
+  while (level < LEVELS && m_level_count[level] == 0) {
+    level++;
+  }
+
+  uint64_t next = target;
+  if (level < LEVELS) {
+    uint64_t span_mask = (1ULL << (SLOT_BITS * level)) - 1;
+    next = std::min(target, (m_current_tick | span_mask) + 1);
+  }
+  m_current_tick = next;
+
+  for (level = 1; level < LEVELS; level++) {
+    if ((m_current_tick >> (SLOT_BITS * (level - 1))) & SLOT_MASK)
+      break;
+    Cascade(level);
+  }
+}
+
+/*
+ * Find the earliest expiry time, the first non-empty slot on each level holds
+ * the earliest events for that level. Each slot caches its earliest expiry.
+ * If the earliest event in a slot on a higher level is removed, the start of
+ * the slot is used instead, so we may wake up early but never late.
+ */
+const TimeStamp *TimerWheel::NextExpiry() {
+  if (m_event_count == 0)
+    return NULL;
+  if (m_next_expiry_valid)
+    return &m_next_expiry;
+
+  for (unsigned int level = 0; level < LEVELS; level++) {
+    if (m_level_count[level] == 0)
+      continue;
+
+    uint64_t position = m_current_tick >> (SLOT_BITS * level);
+    // On the lowest level the current slot may hold events that are due later
+    // in this tick. On the higher levels the current slot has been cascaded.
+    unsigned int offset = level == 0 ? 0 : 1;
+    for (unsigned int i = 0; i < SLOTS; i++) {
+      Node *head = &m_slots[level][(position + offset + i) & SLOT_MASK];
+      if (ListEmpty(head))
+        continue;
+
+      TimeStamp earliest;
+      if (head->earliest_valid) {
+        earliest = head->expiry;
+      } else if (level == 0) {
+        head->expiry = head->next->expiry;
+        for (Node *node = head->next; node != head; node = node->next) {
+          head->expiry = std::min(head->expiry, node->expiry);
+        }
+        head->earliest_valid = true;
+        earliest = head->expiry;
+      } else {
+        // Rather than scan a slot that may hold many events, wake up when
+        // it's cascaded. The events are then on the lower levels.
+        uint64_t start = (position + offset + i) << (SLOT_BITS * level);
+        earliest = m_epoch + TimeInterval(
+            static_cast<int64_t>(start * ONE_THOUSAND));
+      }
+      if (!m_next_expiry_valid || earliest < m_next_expiry) {
+        m_next_expiry = earliest;
+        m_next_expiry_valid = true;
+      }
+      break;
+    }
+  }
+  return &m_next_expiry;
+}
+
+uint64_t TimerWheel::TickFor(const TimeStamp &time) const {
+  if (time <= m_epoch)
+    return 0;
+  return (time - m_epoch).AsInt() / ONE_THOUSAND;
+}
+
+void TimerWheel::DeleteClosure(Node *node) {
+  if (node->repeating) {
+    delete node->repeating_closure;
+    node->repeating_closure = NULL;
+  } else {
+    delete node->single_closure;
+    node->single_closure = NULL;
+  }
+}
+
+void TimerWheel::InitList(Node *head) {
+  head->prev = head;
+  head->next = head;
+  head->level = LEVELS;
+  head->earliest_valid = false;
+}
+}  // namespace io
+}  // namespace ola
@@ -0,0 +1,170 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * TimerWheel.h
+ * A hierarchical timing wheel.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef COMMON_IO_TIMERWHEEL_H_
+#define COMMON_IO_TIMERWHEEL_H_
+
+#include <stdint.h>
+#include <vector>
+
+#include "ola/Callback.h"
+#include "ola/Clock.h"
+#include "ola/ExportMap.h"
+#include "ola/base/Macro.h"
+#include "ola/thread/SchedulerInterface.h"
+
+namespace ola {
+namespace io {
+
+/**
+ * @class TimerWheel
+ * @brief A hierarchical timing wheel for timer events.
+ *
+ * The wheel has four levels of 256 slots, the lowest level has a resolution of
+ * 1ms. Events are placed in the slot for their expiry tick and moved down a
+ * level as the wheel turns. Registering and cancelling an event is O(1), and
+ * the events are allocated from a pool that's reused, so the steady state
+ * doesn't touch the heap.
+ *
+ * Events never fire before their expiry time. Since the wheel keeps the exact
+ * expiry time of each event, it provides the same behaviour as the
+ * priority queue in the TimeoutManager.
+ *
+ * The ids returned are the addresses of pooled nodes. Cancelling a timeout
+ * after it has fired is a no-op, provided the node hasn't been reused. The
+ * free list is FIFO to make reuse of a recently freed node unlikely.
+ */
+class TimerWheel {
+ public :
+  /**
+   * @brief Create a new TimerWheel.
+   * @param export_map an ExportMap to update, may be NULL.
+   * @param clock the Clock to use.
+   * @param timer_var the name of the variable used to count the timers.
+   */
+  TimerWheel(ola::ExportMap *export_map, Clock *clock, const char *timer_var);
+
+  ~TimerWheel();
+
+  /**
+   * @brief Register a repeating timeout.
+   * @param interval the delay before the closure will be run.
+   * @param closure the closure to invoke when the event triggers.
+   * @returns the identifier for this timeout.
+   */
+  ola::thread::timeout_id RegisterRepeatingTimeout(
+      const ola::TimeInterval &interval,
+      ola::Callback0<bool> *closure);
+
+  /**
+   * @brief Register a single use timeout function.
+   * @param interval the delay before the closure will be run.
+   * @param closure the Callback to invoke when the event triggers.
+   * @returns the identifier for this timeout.
+   */
+  ola::thread::timeout_id RegisterSingleTimeout(
+      const ola::TimeInterval &interval,
+      ola::SingleUseCallback0<void> *closure);
+
+  /**
+   * @brief Cancel a timeout.
+   * @param id the id of the timeout
+   */
+  void CancelTimeout(ola::thread::timeout_id id);
+
+  /**
+   * @brief Check if there are any events in the wheel.
+   */
+  bool EventsPending() const { return m_event_count > 0; }
+
+  /**
+   * @brief Execute any expired timeouts.
+   * @param[in,out] now the current time, set to the last time events were
+   * checked.
+   * @returns the time until the next event.
+   */
+  TimeInterval ExecuteTimeouts(TimeStamp *now);
+
+ private:
+  enum NodeState {
+    NODE_FREE,
+    NODE_QUEUED,
+    NODE_RUNNING,
+    NODE_CANCELLED  // cancelled while running
+  };
+
+  struct Node {
+    Node *prev;
+    Node *next;
+    Node *slot;  // the sentinel of the slot the node is in
+    NodeState state;
+    unsigned int level;  // LEVELS if the node isn't in a slot
+    // For a slot sentinel, true if expiry is the earliest expiry in the slot.
+    bool earliest_valid;
+    bool repeating;
+    ola::BaseCallback0<void> *single_closure;
+    ola::Callback0<bool> *repeating_closure;
+    TimeInterval interval;
+    TimeStamp expiry;
+  };
+
+  static const unsigned int LEVELS = 4;
+  static const unsigned int SLOT_BITS = 8;
+  static const unsigned int SLOTS = 1 << SLOT_BITS;
+  static const unsigned int SLOT_MASK = SLOTS - 1;
+  static const unsigned int POOL_BLOCK_SIZE = 64;
+
+  ola::ExportMap *m_export_map;
+  ola::IntegerVariable *m_timer_var;
+  Clock *m_clock;
+  TimeStamp m_epoch;
+  uint64_t m_current_tick;
+  unsigned int m_event_count;
+  unsigned int m_level_count[LEVELS];
+  // Each slot is a circular list, the slot itself is the sentinel.
+  Node m_slots[LEVELS][SLOTS];
+
+  // The earliest expiry time, valid if m_next_expiry_valid is true.
+  TimeStamp m_next_expiry;
+  bool m_next_expiry_valid;
+
+  std::vector<Node*> m_pool_blocks;
+  Node *m_free_head;
+  Node *m_free_tail;
+
+  Node *AllocateNode();
+  void ReleaseNode(Node *node);
+  void InsertNode(Node *node);
+  void UnlinkNode(Node *node);
+  void Cascade(unsigned int level);
+  bool RunDueEvents(TimeStamp *now);
+  void Advance(uint64_t target);
+  const TimeStamp *NextExpiry();
+  uint64_t TickFor(const TimeStamp &time) const;
+  void DeleteClosure(Node *node);
+
+  static void InitList(Node *head);
+  static bool ListEmpty(const Node *head) { return head->next == head; }
+
+  DISALLOW_COPY_AND_ASSIGN(TimerWheel);
+};
+}  // namespace io
+}  // namespace ola
+#endif  // COMMON_IO_TIMERWHEEL_H_
@@ -0,0 +1,121 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * timeout_manager_benchmark.cpp
+ * Compare the cost of registering and cancelling timeouts with the priority
+ * queue and the timer wheel.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <iomanip>
+#include <iostream>
+#include "common/io/TimeoutManager.h"
+#include "ola/Callback.h"
+#include "ola/Clock.h"
+#include "ola/ExportMap.h"
+#include "ola/base/Flags.h"
+#include "ola/base/Init.h"
+
+using ola::Clock;
+using ola::ExportMap;
+using ola::MockClock;
+using ola::NewCallback;
+using ola::NewSingleCallback;
+using ola::TimeInterval;
+using ola::TimeStamp;
+using ola::io::TimeoutManager;
+using ola::thread::timeout_id;
+using std::cout;
+using std::endl;
+
+DEFINE_s_uint32(cycles, c, 100000,
+                "Number of register / cancel cycles per measurement");
+
+static const unsigned int BACKGROUND_COUNTS[] = {0, 100, 1000, 10000};
+
+static void SingleEvent() {}
+
+static bool RepeatingEvent() {
+  return true;
+}
+
+/**
+ * Return the number of nanoseconds each cycle took.
+ */
+double NanoSecondsPerCycle(const Clock &clock,
+                           const TimeStamp &start,
+                           unsigned int cycles) {
+  TimeStamp end;
+  clock.CurrentTime(&end);
+  TimeInterval elapsed = end - start;
+  return elapsed.AsInt() * 1000.0 / cycles;
+}
+
+/**
+ * Register a timeout, let some time pass and then cancel it, the pattern used
+ * for RDM request timeouts. A set of repeating timeouts from 1 to 10s is kept
+ * in the background.
+ */
+double BenchmarkRegisterCancel(const Clock &clock, bool use_timer_wheel,
+                               unsigned int background_timeouts,
+                               unsigned int cycles) {
+  ExportMap export_map;
+  MockClock mock_clock;
+  TimeoutManager timeout_manager(&export_map, &mock_clock, use_timer_wheel);
+
+  for (unsigned int i = 0; i < background_timeouts; i++) {
+    timeout_manager.RegisterRepeatingTimeout(
+        TimeInterval(1 + i % 10, 0), NewCallback(&RepeatingEvent));
+  }
+
+  TimeStamp start, now;
+  clock.CurrentTime(&start);
+  for (unsigned int i = 0; i < cycles; i++) {
+    timeout_id id = timeout_manager.RegisterSingleTimeout(
+        TimeInterval(0, 500000), NewSingleCallback(&SingleEvent));
+    mock_clock.AdvanceTime(0, 100);
+    mock_clock.CurrentTime(&now);
+    timeout_manager.ExecuteTimeouts(&now);
+    timeout_manager.CancelTimeout(id);
+  }
+  return NanoSecondsPerCycle(clock, start, cycles);
+}
+
+int main(int argc, char *argv[]) {
+  ola::AppInit(&argc, argv, "",
+               "Compare the cost of registering and cancelling timeouts.");
+
+  const unsigned int cycles = FLAGS_cycles;
+  if (!cycles) {
+    return -1;
+  }
+
+  Clock clock;
+  cout << "ns per register / cancel cycle, " << cycles << " cycles" << endl;
+  cout << std::setw(12) << "background" << std::setw(10) << "queue"
+       << std::setw(10) << "wheel" << endl;
+  cout << std::fixed << std::setprecision(1);
+  for (unsigned int i = 0;
+       i < sizeof(BACKGROUND_COUNTS) / sizeof(BACKGROUND_COUNTS[0]); i++) {
+    const unsigned int background = BACKGROUND_COUNTS[i];
+    cout << std::setw(12) << background
+         << std::setw(10) << BenchmarkRegisterCancel(clock, false, background,
+                                                     cycles)
+         << std::setw(10) << BenchmarkRegisterCancel(clock, true, background,
+                                                     cycles)
+         << endl;
+  }
+  return 0;
+}
@@ -16,7 +16,9 @@ common_libolacommon_la_SOURCES += \
     common/network/SocketHelper.cpp \
     common/network/SocketHelper.h \
     common/network/TCPConnector.cpp \
-    common/network/TCPSocket.cpp
+    common/network/TCPSocket.cpp \
+    common/network/UDPBatchSender.cpp \
+    common/network/UDPReceiveRing.cpp
 
 common_libolacommon_la_LIBADD += $(RESOLV_LIBS)
 
@@ -49,7 +51,9 @@ common_network_NetworkTester_SOURCES = \
     common/network/MACAddressTest.cpp \
     common/network/NetworkUtilsTest.cpp \
     common/network/SocketAddressTest.cpp \
-    common/network/SocketTest.cpp
+    common/network/SocketTest.cpp \
+    common/network/UDPBatchSenderTest.cpp \
+    common/network/UDPReceiveRingTest.cpp
 common_network_NetworkTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 common_network_NetworkTester_LDADD = $(COMMON_TESTING_LIBS)
 
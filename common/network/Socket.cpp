@@ -48,6 +48,7 @@
 #include <netinet/in.h>
 #endif  // HAVE_NETINET_IN_H
 
+#include <algorithm>
 #include <string>
 
 #include "common/network/SocketHelper.h"
@@ -279,6 +280,79 @@ ssize_t UDPSocket::SendTo(ola::io::IOVecInterface *data,
   return bytes_sent;
 }
 
+unsigned int UDPSocket::SendMany(const OutgoingDatagram *datagrams,
+                                 unsigned int count) const {
+  if (!ValidWriteDescriptor())
+    return 0;
+
+  unsigned int sent = 0;
+#ifdef HAVE_SENDMMSG
+  struct mmsghdr messages[MAX_DATAGRAMS_PER_CALL];
+  struct iovec iovs[MAX_DATAGRAMS_PER_CALL];
+  struct sockaddr_in destinations[MAX_DATAGRAMS_PER_CALL];
+
+  unsigned int offset = 0;
+  while (offset < count) {
+    unsigned int batch_size = std::min(count - offset, MAX_DATAGRAMS_PER_CALL);
+    unsigned int message_count = 0;
+    for (unsigned int i = 0; i < batch_size; i++) {
+      const OutgoingDatagram &datagram = datagrams[offset + i];
+      if (!datagram.destination.ToSockAddr(
+              reinterpret_cast<sockaddr*>(&destinations[message_count]),
+              sizeof(destinations[message_count]))) {
+        // Stop here, the bad datagram is skipped below.
+        break;
+      }
+      iovs[message_count].iov_base = const_cast<uint8_t*>(datagram.data);
+      iovs[message_count].iov_len = datagram.size;
+
+      struct msghdr *header = &messages[message_count].msg_hdr;
+      header->msg_name = &destinations[message_count];
+      header->msg_namelen = sizeof(destinations[message_count]);
+      header->msg_iov = &iovs[message_count];
+      header->msg_iovlen = 1;
+      header->msg_control = NULL;
+      header->msg_controllen = 0;
+      header->msg_flags = 0;
+      messages[message_count].msg_len = 0;
+      message_count++;
+    }
+
+    int messages_sent = 0;
+    if (message_count) {
+      messages_sent = sendmmsg(m_handle, messages, message_count, 0);
+    }
+
+    if (messages_sent > 0) {
+      for (int i = 0; i < messages_sent; i++) {
+        if (messages[i].msg_len == datagrams[offset + i].size) {
+          sent++;
+        }
+      }
+      offset += messages_sent;
+    } else {
+      // The first datagram in the batch couldn't be sent. Fall back to
+      // SendTo(), which logs the error, and move on to the next datagram.
+      const OutgoingDatagram &datagram = datagrams[offset];
+      if (SendTo(datagram.data, datagram.size, datagram.destination) ==
+          static_cast<ssize_t>(datagram.size)) {
+        sent++;
+      }
+      offset++;
+    }
+  }
+#else
+  for (unsigned int i = 0; i < count; i++) {
+    if (SendTo(datagrams[i].data, datagrams[i].size,
+               datagrams[i].destination) ==
+        static_cast<ssize_t>(datagrams[i].size)) {
+      sent++;
+    }
+  }
+#endif  // HAVE_SENDMMSG
+  return sent;
+}
+
 bool UDPSocket::RecvFrom(uint8_t *buffer, ssize_t *data_read) const {
   socklen_t length = 0;
 #ifdef _WIN32
@@ -342,6 +416,76 @@ bool UDPSocket::RecvFrom(uint8_t *buffer,
   return ok;
 }
 
+unsigned int UDPSocket::RecvMany(IncomingDatagram *datagrams,
+                                 unsigned int count) {
+  if (!ValidReadDescriptor())
+    return 0;
+
+  unsigned int received = 0;
+#ifdef HAVE_RECVMMSG
+  struct mmsghdr messages[MAX_DATAGRAMS_PER_CALL];
+  struct iovec iovs[MAX_DATAGRAMS_PER_CALL];
+  struct sockaddr_in sources[MAX_DATAGRAMS_PER_CALL];
+
+  while (received < count) {
+    unsigned int batch_size = std::min(count - received,
+                                       MAX_DATAGRAMS_PER_CALL);
+    for (unsigned int i = 0; i < batch_size; i++) {
+      IncomingDatagram &datagram = datagrams[received + i];
+      iovs[i].iov_base = datagram.data;
+      iovs[i].iov_len = datagram.capacity;
+
+      struct msghdr *header = &messages[i].msg_hdr;
+      header->msg_name = &sources[i];
+      header->msg_namelen = sizeof(sources[i]);
+      header->msg_iov = &iovs[i];
+      header->msg_iovlen = 1;
+      header->msg_control = NULL;
+      header->msg_controllen = 0;
+      header->msg_flags = 0;
+      messages[i].msg_len = 0;
+    }
+
+    int messages_received = recvmmsg(m_handle, messages, batch_size,
+                                     MSG_DONTWAIT, NULL);
+    if (messages_received < 0) {
+      if (errno != EAGAIN && errno != EWOULDBLOCK) {
+        OLA_WARN << "recvmmsg failed: " << strerror(errno);
+      }
+      break;
+    }
+
+    for (int i = 0; i < messages_received; i++) {
+      IncomingDatagram &datagram = datagrams[received + i];
+      datagram.size = messages[i].msg_len;
+      datagram.truncated = (messages[i].msg_hdr.msg_flags & MSG_TRUNC) != 0;
+      datagram.source = IPV4SocketAddress(
+          IPV4Address(sources[i].sin_addr.s_addr),
+          NetworkToHost(sources[i].sin_port));
+    }
+    received += messages_received;
+
+    if (static_cast<unsigned int>(messages_received) < batch_size) {
+      // the socket has been drained
+      break;
+    }
+  }
+#else
+  // Without recvmmsg() we can't tell if a read will block, so only read the
+  // datagram we know is waiting.
+  if (count) {
+    IncomingDatagram &datagram = datagrams[0];
+    ssize_t data_read = datagram.capacity;
+    if (RecvFrom(datagram.data, &data_read, &datagram.source)) {
+      datagram.size = static_cast<unsigned int>(data_read);
+      datagram.truncated = false;
+      received = 1;
+    }
+  }
+#endif  // HAVE_RECVMMSG
+  return received;
+}
+
 bool UDPSocket::EnableBroadcast() {
   if (m_handle == ola::io::INVALID_DESCRIPTOR)
     return false;
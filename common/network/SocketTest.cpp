@@ -18,6 +18,10 @@
  * Copyright (C) 2005 Simon Newton
  */
 
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
 #include <cppunit/extensions/HelperMacros.h>
 #include <stdint.h>
 #include <string.h>
@@ -41,6 +45,8 @@ using ola::io::SelectServer;
 using ola::network::IPV4Address;
 using ola::network::GenericSocketAddress;
 using ola::network::IPV4SocketAddress;
+using ola::network::IncomingDatagram;
+using ola::network::OutgoingDatagram;
 using ola::network::TCPAcceptingSocket;
 using ola::network::TCPSocket;
 using ola::network::UDPSocket;
@@ -56,6 +62,8 @@ class SocketTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testTCPSocketServerClose);
   CPPUNIT_TEST(testUDPSocket);
   CPPUNIT_TEST(testIOQueueUDPSend);
+  CPPUNIT_TEST(testUDPSendMany);
+  CPPUNIT_TEST(testUDPRecvMany);
   CPPUNIT_TEST_SUITE_END();
 
  public:
@@ -65,6 +73,8 @@ class SocketTest: public CppUnit::TestFixture {
     void testTCPSocketServerClose();
     void testUDPSocket();
     void testIOQueueUDPSend();
+    void testUDPSendMany();
+    void testUDPRecvMany();
 
     // timing out indicates something went wrong
     void Timeout() {
@@ -279,6 +289,101 @@ void SocketTest::testIOQueueUDPSend() {
 }
 
 
+/*
+ * Test that a batch of datagrams sent with SendMany() all arrive, in order.
+ */
+void SocketTest::testUDPSendMany() {
+  UDPSocket socket;
+  OLA_ASSERT_TRUE(socket.Init());
+  OLA_ASSERT_TRUE(socket.Bind(IPV4SocketAddress(IPV4Address::Loopback(), 0)));
+  IPV4SocketAddress local_address;
+  OLA_ASSERT_TRUE(socket.GetSocketAddress(&local_address));
+
+  UDPSocket client_socket;
+  OLA_ASSERT_TRUE(client_socket.Init());
+
+  const uint8_t data1[] = {1, 2, 3};
+  const uint8_t data2[] = {4, 5, 6, 7};
+  const uint8_t data3[] = {8};
+  OutgoingDatagram datagrams[3];
+  datagrams[0].data = data1;
+  datagrams[0].size = sizeof(data1);
+  datagrams[0].destination = local_address;
+  datagrams[1].data = data2;
+  datagrams[1].size = sizeof(data2);
+  datagrams[1].destination = local_address;
+  datagrams[2].data = data3;
+  datagrams[2].size = sizeof(data3);
+  datagrams[2].destination = local_address;
+
+  OLA_ASSERT_EQ(0u, client_socket.SendMany(datagrams, 0));
+  OLA_ASSERT_EQ(3u, client_socket.SendMany(datagrams, 3));
+
+  for (unsigned int i = 0; i < 3; i++) {
+    uint8_t buffer[10];
+    ssize_t data_read = sizeof(buffer);
+    OLA_ASSERT_TRUE(socket.RecvFrom(buffer, &data_read));
+    OLA_ASSERT_DATA_EQUALS(datagrams[i].data, datagrams[i].size,
+                           buffer, static_cast<unsigned int>(data_read));
+  }
+}
+
+
+/*
+ * Test receiving a batch of datagrams
+ */
+void SocketTest::testUDPRecvMany() {
+  UDPSocket socket;
+  OLA_ASSERT_TRUE(socket.Init());
+  OLA_ASSERT_TRUE(socket.Bind(IPV4SocketAddress(IPV4Address::Loopback(), 0)));
+  IPV4SocketAddress local_address;
+  OLA_ASSERT_TRUE(socket.GetSocketAddress(&local_address));
+
+  UDPSocket client_socket;
+  OLA_ASSERT_TRUE(client_socket.Init());
+
+  uint8_t buffers[4][4];
+  IncomingDatagram datagrams[4];
+  for (unsigned int i = 0; i < 4; i++) {
+    datagrams[i].data = buffers[i];
+    datagrams[i].capacity = sizeof(buffers[i]);
+  }
+
+#ifdef HAVE_RECVMMSG
+  // Nothing to read, this must not block.
+  OLA_ASSERT_EQ(0u, socket.RecvMany(datagrams, 4));
+#endif  // HAVE_RECVMMSG
+
+  const uint8_t data1[] = {1, 2, 3};
+  const uint8_t data2[] = {4, 5, 6, 7, 8, 9};
+  const uint8_t data3[] = {10};
+  OLA_ASSERT_TRUE(client_socket.SendTo(data1, sizeof(data1), local_address));
+  OLA_ASSERT_TRUE(client_socket.SendTo(data2, sizeof(data2), local_address));
+  OLA_ASSERT_TRUE(client_socket.SendTo(data3, sizeof(data3), local_address));
+
+  // Without recvmmsg() each call only returns a single datagram.
+  unsigned int received = 0;
+  while (received < 3) {
+    unsigned int count = socket.RecvMany(datagrams + received, 4 - received);
+    OLA_ASSERT_TRUE(count);
+    received += count;
+  }
+
+  OLA_ASSERT_DATA_EQUALS(data1, sizeof(data1), datagrams[0].data,
+                         datagrams[0].size);
+  OLA_ASSERT_FALSE(datagrams[0].truncated);
+  OLA_ASSERT_EQ(IPV4Address::Loopback(), datagrams[0].source.Host());
+  OLA_ASSERT_DATA_EQUALS(data2, 4u, datagrams[1].data, datagrams[1].size);
+  OLA_ASSERT_TRUE(datagrams[1].truncated);
+  OLA_ASSERT_DATA_EQUALS(data3, sizeof(data3), datagrams[2].data,
+                         datagrams[2].size);
+  OLA_ASSERT_FALSE(datagrams[2].truncated);
+#ifdef HAVE_RECVMMSG
+  OLA_ASSERT_EQ(0u, socket.RecvMany(datagrams, 4));
+#endif  // HAVE_RECVMMSG
+}
+
+
 /*
  * Receive some data and close the socket
  */
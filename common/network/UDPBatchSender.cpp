@@ -0,0 +1,117 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * UDPBatchSender.cpp
+ * Queue UDP datagrams and send them with as few system calls as possible.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <string.h>
+#include <vector>
+
+#include "ola/Callback.h"
+#include "ola/Clock.h"
+#include "ola/Logging.h"
+#include "ola/network/UDPBatchSender.h"
+
+namespace ola {
+namespace network {
+
+UDPBatchSender::UDPBatchSender(UDPSocketInterface *socket,
+                               ola::thread::SchedulerInterface *scheduler,
+                               unsigned int max_pending)
+    : m_socket(socket),
+      m_scheduler(scheduler),
+      m_max_pending(max_pending ? max_pending : 1),
+      m_flush_timeout(ola::thread::INVALID_TIMEOUT) {
+}
+
+UDPBatchSender::~UDPBatchSender() {
+  Flush();
+}
+
+void UDPBatchSender::Queue(const uint8_t *data,
+                           unsigned int size,
+                           const IPV4SocketAddress &destination) {
+  if (m_pending.size() >= m_max_pending) {
+    Flush();
+  }
+
+  PendingDatagram datagram;
+  datagram.offset = m_data.size();
+  datagram.size = size;
+  datagram.destination = destination;
+  m_data.resize(m_data.size() + size);
+  if (size) {
+    memcpy(&m_data[datagram.offset], data, size);
+  }
+  m_pending.push_back(datagram);
+}
+
+void UDPBatchSender::ScheduleFlush() {
+  if (!m_scheduler) {
+    Flush();
+    return;
+  }
+
+  if (m_pending.empty() || m_flush_timeout != ola::thread::INVALID_TIMEOUT) {
+    return;
+  }
+
+  // Timeouts are run after I/O events, so a zero length timeout fires at the
+  // end of the current iteration of the event loop.
+  m_flush_timeout = m_scheduler->RegisterSingleTimeout(
+      TimeInterval(0, 0),
+      NewSingleCallback(this, &UDPBatchSender::ScheduledFlush));
+}
+
+unsigned int UDPBatchSender::Flush() {
+  if (m_flush_timeout != ola::thread::INVALID_TIMEOUT) {
+    m_scheduler->RemoveTimeout(m_flush_timeout);
+    m_flush_timeout = ola::thread::INVALID_TIMEOUT;
+  }
+
+  if (m_pending.empty()) {
+    return 0;
+  }
+
+  // m_data may have been reallocated as datagrams were queued, so the
+  // pointers are only taken once everything has been queued.
+  m_outgoing.resize(m_pending.size());
+  for (unsigned int i = 0; i < m_pending.size(); i++) {
+    const PendingDatagram &datagram = m_pending[i];
+    m_outgoing[i].data = datagram.size ? &m_data[datagram.offset] : NULL;
+    m_outgoing[i].size = datagram.size;
+    m_outgoing[i].destination = datagram.destination;
+  }
+
+  unsigned int sent = m_socket->SendMany(&m_outgoing[0], m_outgoing.size());
+  if (sent != m_outgoing.size()) {
+    OLA_INFO << "Only sent " << sent << " of " << m_outgoing.size()
+             << " datagrams";
+  }
+
+  // clear() keeps the capacity, so the next frame doesn't allocate.
+  m_data.clear();
+  m_pending.clear();
+  return sent;
+}
+
+void UDPBatchSender::ScheduledFlush() {
+  m_flush_timeout = ola::thread::INVALID_TIMEOUT;
+  Flush();
+}
+}  // namespace network
+}  // namespace ola
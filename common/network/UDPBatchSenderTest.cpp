@@ -0,0 +1,150 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * UDPBatchSenderTest.cpp
+ * Test fixture for the UDPBatchSender class
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <stdint.h>
+
+#include "ola/io/SelectServer.h"
+#include "ola/network/IPV4Address.h"
+#include "ola/network/SocketAddress.h"
+#include "ola/network/UDPBatchSender.h"
+#include "ola/testing/MockUDPSocket.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::io::SelectServer;
+using ola::network::IPV4Address;
+using ola::network::IPV4SocketAddress;
+using ola::network::UDPBatchSender;
+using ola::testing::MockUDPSocket;
+using ola::testing::SocketVerifier;
+
+class UDPBatchSenderTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(UDPBatchSenderTest);
+  CPPUNIT_TEST(testFlush);
+  CPPUNIT_TEST(testMaxPending);
+  CPPUNIT_TEST(testScheduleFlush);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    void setUp();
+    void testFlush();
+    void testMaxPending();
+    void testScheduleFlush();
+
+ private:
+    MockUDPSocket m_socket;
+    IPV4Address m_target;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(UDPBatchSenderTest);
+
+static const uint16_t PORT = 5568;
+
+void UDPBatchSenderTest::setUp() {
+  m_socket.Init();
+  m_target = IPV4Address::FromStringOrDie("10.0.0.1");
+}
+
+
+/*
+ * Check that queued datagrams are copied and sent with a single call.
+ */
+void UDPBatchSenderTest::testFlush() {
+  UDPBatchSender sender(&m_socket);
+  OLA_ASSERT_EQ(0u, sender.Flush());
+  OLA_ASSERT_EQ(0u, m_socket.SendManyCount());
+
+  const uint8_t expected1[] = {1, 2, 3};
+  const uint8_t expected2[] = {4, 5};
+  uint8_t data[] = {1, 2, 3};
+  sender.Queue(data, sizeof(data), IPV4SocketAddress(m_target, PORT));
+  // the data was copied, so changing it has no effect
+  data[0] = 4;
+  data[1] = 5;
+  sender.Queue(data, 2, IPV4SocketAddress(m_target, PORT + 1));
+  OLA_ASSERT_EQ(2u, sender.Pending());
+
+  SocketVerifier verifier(&m_socket);
+  m_socket.AddExpectedData(expected1, sizeof(expected1), m_target, PORT);
+  m_socket.AddExpectedData(expected2, sizeof(expected2), m_target, PORT + 1);
+  OLA_ASSERT_EQ(2u, sender.Flush());
+  OLA_ASSERT_EQ(0u, sender.Pending());
+  OLA_ASSERT_EQ(1u, m_socket.SendManyCount());
+}
+
+
+/*
+ * Check that the queue is flushed once it's full.
+ */
+void UDPBatchSenderTest::testMaxPending() {
+  UDPBatchSender sender(&m_socket, NULL, 2);
+  const uint8_t data[] = {1, 2, 3};
+  IPV4SocketAddress destination(m_target, PORT);
+
+  SocketVerifier verifier(&m_socket);
+  m_socket.AddExpectedData(data, sizeof(data), m_target, PORT);
+  m_socket.AddExpectedData(data, sizeof(data), m_target, PORT);
+  sender.Queue(data, sizeof(data), destination);
+  sender.Queue(data, sizeof(data), destination);
+  OLA_ASSERT_EQ(0u, m_socket.SendManyCount());
+  sender.Queue(data, sizeof(data), destination);
+  OLA_ASSERT_EQ(1u, m_socket.SendManyCount());
+  OLA_ASSERT_EQ(1u, sender.Pending());
+
+  m_socket.AddExpectedData(data, sizeof(data), m_target, PORT);
+  // ScheduleFlush() without a SelectServer sends immediately
+  sender.ScheduleFlush();
+  OLA_ASSERT_EQ(2u, m_socket.SendManyCount());
+  OLA_ASSERT_EQ(0u, sender.Pending());
+}
+
+
+/*
+ * Check that ScheduleFlush() sends everything queued in this iteration of the
+ * event loop in one call.
+ */
+void UDPBatchSenderTest::testScheduleFlush() {
+  SelectServer ss;
+  UDPBatchSender sender(&m_socket, &ss);
+  const uint8_t data[] = {1, 2, 3};
+  IPV4SocketAddress destination(m_target, PORT);
+
+  sender.Queue(data, sizeof(data), destination);
+  sender.ScheduleFlush();
+  sender.Queue(data, sizeof(data), destination);
+  sender.ScheduleFlush();
+  OLA_ASSERT_EQ(2u, sender.Pending());
+  OLA_ASSERT_EQ(0u, m_socket.SendManyCount());
+
+  SocketVerifier verifier(&m_socket);
+  m_socket.AddExpectedData(data, sizeof(data), m_target, PORT);
+  m_socket.AddExpectedData(data, sizeof(data), m_target, PORT);
+  ss.RunOnce();
+  OLA_ASSERT_EQ(0u, sender.Pending());
+  OLA_ASSERT_EQ(1u, m_socket.SendManyCount());
+
+  // An explicit flush cancels the scheduled one.
+  sender.Queue(data, sizeof(data), destination);
+  sender.ScheduleFlush();
+  m_socket.AddExpectedData(data, sizeof(data), m_target, PORT);
+  OLA_ASSERT_EQ(1u, sender.Flush());
+  ss.RunOnce();
+  OLA_ASSERT_EQ(2u, m_socket.SendManyCount());
+}
@@ -0,0 +1,120 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * UDPReceiveRing.cpp
+ * A reusable set of buffers for receiving batches of UDP datagrams.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
+#include <string>
+
+#include "ola/Logging.h"
+#include "ola/network/UDPReceiveRing.h"
+
+namespace ola {
+namespace network {
+
+using std::string;
+
+const char UDPReceiveRing::K_BATCHES_VAR[] = "udp-recv-batches";
+const char UDPReceiveRing::K_DATAGRAMS_VAR[] = "udp-recv-datagrams";
+const char UDPReceiveRing::K_DROPS_VAR[] = "udp-recv-drops";
+const char UDPReceiveRing::K_MAX_BATCH_VAR[] = "udp-recv-max-batch";
+
+UDPReceiveRing::UDPReceiveRing(unsigned int slot_count,
+                               unsigned int slot_size,
+                               ExportMap *export_map,
+                               const string &name)
+    : m_slot_size(slot_size),
+      m_buffer(static_cast<size_t>(slot_count ? slot_count : 1) * slot_size),
+      m_datagrams(slot_count ? slot_count : 1),
+      m_last_batch(0),
+      m_batches(NULL),
+      m_datagram_count(NULL),
+      m_drops(NULL),
+      m_max_batch(NULL) {
+  for (unsigned int i = 0; i < m_datagrams.size(); i++) {
+    m_datagrams[i].data = m_slot_size ? &m_buffer[i * m_slot_size] : NULL;
+    m_datagrams[i].capacity = m_slot_size;
+    m_datagrams[i].size = 0;
+    m_datagrams[i].truncated = false;
+  }
+
+  if (export_map) {
+    m_batches =
+        export_map->GetUIntMapVar(K_BATCHES_VAR, "socket")->Handle(name);
+    m_datagram_count =
+        export_map->GetUIntMapVar(K_DATAGRAMS_VAR, "socket")->Handle(name);
+    m_drops = export_map->GetUIntMapVar(K_DROPS_VAR, "socket")->Handle(name);
+    m_max_batch =
+        export_map->GetUIntMapVar(K_MAX_BATCH_VAR, "socket")->Handle(name);
+  }
+}
+
+unsigned int UDPReceiveRing::Receive(UDPSocketInterface *socket) {
+  unsigned int received = socket->RecvMany(&m_datagrams[0],
+                                           m_datagrams.size());
+  m_last_batch = received;
+  if (!received) {
+    return 0;
+  }
+
+  if (m_batches) {
+    (*m_batches)++;
+    *m_datagram_count += received;
+    if (received > *m_max_batch) {
+      *m_max_batch = received;
+    }
+  }
+
+  // Remove any truncated datagrams, keeping the order of the rest.
+  unsigned int valid = 0;
+  for (unsigned int i = 0; i < received; i++) {
+    if (m_datagrams[i].truncated) {
+      OLA_WARN << "Datagram from " << m_datagrams[i].source
+               << " is larger than " << m_slot_size << " bytes, discarding";
+      CountDrop();
+      continue;
+    }
+    if (valid != i) {
+      // Swap so every slot still points at its own buffer.
+      IncomingDatagram tmp = m_datagrams[valid];
+      m_datagrams[valid] = m_datagrams[i];
+      m_datagrams[i] = tmp;
+    }
+    valid++;
+  }
+  return valid;
+}
+
+void UDPReceiveRing::CountDrop() {
+  if (m_drops) {
+    (*m_drops)++;
+  }
+}
+
+bool UDPReceiveRing::DrainsSocket() {
+#ifdef HAVE_RECVMMSG
+  return true;
+#else
+  return false;
+#endif  // HAVE_RECVMMSG
+}
+}  // namespace network
+}  // namespace ola
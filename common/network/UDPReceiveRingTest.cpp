@@ -0,0 +1,151 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * UDPReceiveRingTest.cpp
+ * Test fixture for the UDPReceiveRing class
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <stdint.h>
+
+#include "ola/ExportMap.h"
+#include "ola/network/IPV4Address.h"
+#include "ola/network/SocketAddress.h"
+#include "ola/network/UDPReceiveRing.h"
+#include "ola/testing/MockUDPSocket.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::ExportMap;
+using ola::network::IPV4Address;
+using ola::network::IPV4SocketAddress;
+using ola::network::IncomingDatagram;
+using ola::network::UDPReceiveRing;
+using ola::testing::MockUDPSocket;
+
+class UDPReceiveRingTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(UDPReceiveRingTest);
+  CPPUNIT_TEST(testReceive);
+  CPPUNIT_TEST(testTruncated);
+  CPPUNIT_TEST(testExportMap);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    void setUp();
+    void testReceive();
+    void testTruncated();
+    void testExportMap();
+
+ private:
+    MockUDPSocket m_socket;
+    IPV4SocketAddress m_source;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(UDPReceiveRingTest);
+
+void UDPReceiveRingTest::setUp() {
+  m_socket.Init();
+  m_source = IPV4SocketAddress(IPV4Address::FromStringOrDie("10.0.0.1"),
+                               5568);
+}
+
+
+/*
+ * Check that datagrams are received in batches of at most SlotCount().
+ */
+void UDPReceiveRingTest::testReceive() {
+  UDPReceiveRing ring(2, 16);
+  OLA_ASSERT_EQ(2u, ring.SlotCount());
+  OLA_ASSERT_EQ(0u, ring.Receive(&m_socket));
+  OLA_ASSERT_FALSE(ring.Full());
+
+  const uint8_t data1[] = {1, 2, 3};
+  const uint8_t data2[] = {4, 5};
+  const uint8_t data3[] = {6};
+  m_socket.InjectData(data1, sizeof(data1), m_source);
+  m_socket.InjectData(data2, sizeof(data2), m_source);
+  m_socket.InjectData(data3, sizeof(data3), m_source);
+
+  OLA_ASSERT_EQ(2u, ring.Receive(&m_socket));
+  OLA_ASSERT_TRUE(ring.Full());
+  const IncomingDatagram &first = ring.Datagram(0);
+  OLA_ASSERT_DATA_EQUALS(data1, sizeof(data1), first.data, first.size);
+  OLA_ASSERT_EQ(m_source, first.source);
+  const IncomingDatagram &second = ring.Datagram(1);
+  OLA_ASSERT_DATA_EQUALS(data2, sizeof(data2), second.data, second.size);
+
+  OLA_ASSERT_EQ(1u, ring.Receive(&m_socket));
+  OLA_ASSERT_FALSE(ring.Full());
+  const IncomingDatagram &third = ring.Datagram(0);
+  OLA_ASSERT_DATA_EQUALS(data3, sizeof(data3), third.data, third.size);
+  // The buffers are reused.
+  OLA_ASSERT_EQ(first.data, third.data);
+
+  OLA_ASSERT_EQ(0u, ring.Receive(&m_socket));
+}
+
+
+/*
+ * Check that datagrams that don't fit in a slot are discarded.
+ */
+void UDPReceiveRingTest::testTruncated() {
+  UDPReceiveRing ring(2, 2);
+  const uint8_t data1[] = {1, 2, 3};
+  const uint8_t data2[] = {4, 5};
+  m_socket.InjectData(data1, sizeof(data1), m_source);
+  m_socket.InjectData(data2, sizeof(data2), m_source);
+  m_socket.InjectData(data2, sizeof(data2), m_source);
+
+  OLA_ASSERT_EQ(1u, ring.Receive(&m_socket));
+  const IncomingDatagram &datagram = ring.Datagram(0);
+  OLA_ASSERT_DATA_EQUALS(data2, sizeof(data2), datagram.data, datagram.size);
+  OLA_ASSERT_FALSE(datagram.truncated);
+  // The discarded datagram still counts, so the caller keeps draining.
+  OLA_ASSERT_TRUE(ring.Full());
+
+  OLA_ASSERT_EQ(1u, ring.Receive(&m_socket));
+  OLA_ASSERT_FALSE(ring.Full());
+}
+
+
+/*
+ * Check the counters are exported.
+ */
+void UDPReceiveRingTest::testExportMap() {
+  ExportMap export_map;
+  UDPReceiveRing ring(2, 2, &export_map, "test");
+  const uint8_t data[] = {1, 2};
+  const uint8_t big_data[] = {1, 2, 3};
+  m_socket.InjectData(data, sizeof(data), m_source);
+  m_socket.InjectData(big_data, sizeof(big_data), m_source);
+  m_socket.InjectData(data, sizeof(data), m_source);
+
+  OLA_ASSERT_EQ(1u, ring.Receive(&m_socket));
+  OLA_ASSERT_EQ(1u, ring.Receive(&m_socket));
+  ring.CountDrop();
+
+  OLA_ASSERT_EQ(
+      2u,
+      (*export_map.GetUIntMapVar(UDPReceiveRing::K_BATCHES_VAR))["test"]);
+  OLA_ASSERT_EQ(
+      3u,
+      (*export_map.GetUIntMapVar(UDPReceiveRing::K_DATAGRAMS_VAR))["test"]);
+  OLA_ASSERT_EQ(
+      2u,
+      (*export_map.GetUIntMapVar(UDPReceiveRing::K_MAX_BATCH_VAR))["test"]);
+  OLA_ASSERT_EQ(
+      2u,
+      (*export_map.GetUIntMapVar(UDPReceiveRing::K_DROPS_VAR))["test"]);
+}
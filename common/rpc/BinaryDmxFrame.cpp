@@ -0,0 +1,62 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * BinaryDmxFrame.cpp
+ * The compact binary frames used for streaming DMX data.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include "common/rpc/BinaryDmxFrame.h"
+#include "ola/Constants.h"
+
+namespace ola {
+namespace rpc {
+
+void BinaryDmxFrame::EncodeHeader(unsigned int universe,
+                                  uint8_t priority,
+                                  unsigned int length,
+                                  uint8_t *header) {
+  header[0] = static_cast<uint8_t>(universe >> 24);
+  header[1] = static_cast<uint8_t>(universe >> 16);
+  header[2] = static_cast<uint8_t>(universe >> 8);
+  header[3] = static_cast<uint8_t>(universe);
+  header[4] = priority;
+  header[5] = 0;
+  header[6] = static_cast<uint8_t>(length >> 8);
+  header[7] = static_cast<uint8_t>(length);
+}
+
+bool BinaryDmxFrame::Decode(const uint8_t *data, unsigned int size,
+                            DmxDataFields *fields) {
+  if (size < HEADER_SIZE) {
+    return false;
+  }
+
+  unsigned int length = (data[6] << 8) | data[7];
+  if (length != size - HEADER_SIZE || length > DMX_UNIVERSE_SIZE) {
+    return false;
+  }
+
+  fields->universe = static_cast<int32_t>(
+      (static_cast<uint32_t>(data[0]) << 24) | (data[1] << 16) |
+      (data[2] << 8) | data[3]);
+  fields->has_priority = true;
+  fields->priority = data[4];
+  fields->data = data + HEADER_SIZE;
+  fields->length = length;
+  return true;
+}
+}  // namespace rpc
+}  // namespace ola
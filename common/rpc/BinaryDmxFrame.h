@@ -0,0 +1,82 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * BinaryDmxFrame.h
+ * The compact binary frames used for streaming DMX data.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef COMMON_RPC_BINARYDMXFRAME_H_
+#define COMMON_RPC_BINARYDMXFRAME_H_
+
+#include <stdint.h>
+#include "common/rpc/DmxDataCodec.h"
+
+namespace ola {
+namespace rpc {
+
+/**
+ * @brief Encode and decode binary DMX frames.
+ *
+ * Once a client has negotiated a binary stream with EnableBinaryStream, it
+ * can send DMX data as RpcChannel raw frames rather than StreamDmxData
+ * requests. Each frame has a fixed header:
+ *
+ * @verbatim
+ *   universe  4 bytes, network byte order
+ *   priority  1 byte
+ *   reserved  1 byte, set to 0
+ *   length    2 bytes, network byte order
+ *   data      length bytes
+ * @endverbatim
+ */
+class BinaryDmxFrame {
+ public:
+  /**
+   * @brief Encode the header of a frame.
+   * @param universe the universe id.
+   * @param priority the priority of the data.
+   * @param length the number of bytes of DMX data that follow the header.
+   * @param[out] header the buffer to write the header to, must be at least
+   *   HEADER_SIZE bytes.
+   */
+  static void EncodeHeader(unsigned int universe,
+                           uint8_t priority,
+                           unsigned int length,
+                           uint8_t *header);
+
+  /**
+   * @brief Decode a frame.
+   * @param data the frame.
+   * @param size the size of the frame.
+   * @param[out] fields the decoded fields, fields->data points into data.
+   * @returns true if the frame was valid, false otherwise.
+   */
+  static bool Decode(const uint8_t *data, unsigned int size,
+                     DmxDataFields *fields);
+
+  /**
+   * @brief The version of the binary stream format.
+   */
+  static const unsigned int STREAM_VERSION = 1;
+
+  /**
+   * @brief The size of the frame header.
+   */
+  static const unsigned int HEADER_SIZE = 8;
+};
+}  // namespace rpc
+}  // namespace ola
+#endif  // COMMON_RPC_BINARYDMXFRAME_H_
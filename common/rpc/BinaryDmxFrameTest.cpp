@@ -0,0 +1,101 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * BinaryDmxFrameTest.cpp
+ * Test fixture for the BinaryDmxFrame class
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "common/rpc/BinaryDmxFrame.h"
+#include "common/rpc/DmxDataCodec.h"
+#include "ola/Constants.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::rpc::BinaryDmxFrame;
+using ola::rpc::DmxDataFields;
+
+class BinaryDmxFrameTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(BinaryDmxFrameTest);
+  CPPUNIT_TEST(testEncodeDecode);
+  CPPUNIT_TEST(testDecodeErrors);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    void testEncodeDecode();
+    void testDecodeErrors();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(BinaryDmxFrameTest);
+
+
+/*
+ * Check that frames round trip.
+ */
+void BinaryDmxFrameTest::testEncodeDecode() {
+  const uint8_t dmx[] = {0, 1, 2, 3, 255};
+  uint8_t frame[BinaryDmxFrame::HEADER_SIZE + sizeof(dmx)];
+  BinaryDmxFrame::EncodeHeader(0x01020304, 150, sizeof(dmx), frame);
+  memcpy(frame + BinaryDmxFrame::HEADER_SIZE, dmx, sizeof(dmx));
+
+  const uint8_t expected_header[] = {1, 2, 3, 4, 150, 0, 0, 5};
+  OLA_ASSERT_DATA_EQUALS(expected_header, sizeof(expected_header),
+                         frame, BinaryDmxFrame::HEADER_SIZE);
+
+  DmxDataFields fields;
+  OLA_ASSERT_TRUE(BinaryDmxFrame::Decode(frame, sizeof(frame), &fields));
+  OLA_ASSERT_EQ(0x01020304, fields.universe);
+  OLA_ASSERT_TRUE(fields.has_priority);
+  OLA_ASSERT_EQ(150, fields.priority);
+  OLA_ASSERT_DATA_EQUALS(dmx, sizeof(dmx), fields.data, fields.length);
+  OLA_ASSERT_TRUE(frame + BinaryDmxFrame::HEADER_SIZE == fields.data);
+
+  // no data
+  BinaryDmxFrame::EncodeHeader(1, 100, 0, frame);
+  OLA_ASSERT_TRUE(
+      BinaryDmxFrame::Decode(frame, BinaryDmxFrame::HEADER_SIZE, &fields));
+  OLA_ASSERT_EQ(1, fields.universe);
+  OLA_ASSERT_EQ(0u, fields.length);
+}
+
+
+/*
+ * Check that invalid frames are rejected.
+ */
+void BinaryDmxFrameTest::testDecodeErrors() {
+  uint8_t frame[BinaryDmxFrame::HEADER_SIZE + ola::DMX_UNIVERSE_SIZE + 1];
+  memset(frame, 0, sizeof(frame));
+  DmxDataFields fields;
+
+  // too short
+  OLA_ASSERT_FALSE(BinaryDmxFrame::Decode(frame, 0, &fields));
+  OLA_ASSERT_FALSE(
+      BinaryDmxFrame::Decode(frame, BinaryDmxFrame::HEADER_SIZE - 1, &fields));
+
+  // length doesn't match the frame size
+  BinaryDmxFrame::EncodeHeader(1, 100, 10, frame);
+  OLA_ASSERT_FALSE(
+      BinaryDmxFrame::Decode(frame, BinaryDmxFrame::HEADER_SIZE + 9, &fields));
+  OLA_ASSERT_FALSE(
+      BinaryDmxFrame::Decode(frame, BinaryDmxFrame::HEADER_SIZE + 11,
+                             &fields));
+
+  // too much data
+  BinaryDmxFrame::EncodeHeader(1, 100, ola::DMX_UNIVERSE_SIZE + 1, frame);
+  OLA_ASSERT_FALSE(BinaryDmxFrame::Decode(frame, sizeof(frame), &fields));
+}
@@ -0,0 +1,127 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * DmxDataCodec.cpp
+ * Encode and decode DmxData messages without copying the DMX data.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/wire_format_lite.h>
+
+#include "common/rpc/DmxDataCodec.h"
+
+namespace ola {
+namespace rpc {
+
+using google::protobuf::internal::WireFormatLite;
+using google::protobuf::io::CodedInputStream;
+using google::protobuf::io::CodedOutputStream;
+using ola::io::IOVec;
+
+namespace {
+// The field numbers from Ola.proto
+enum {
+  UNIVERSE_FIELD = 1,
+  DATA_FIELD = 2,
+  PRIORITY_FIELD = 3,
+};
+
+const uint32_t UNIVERSE_TAG = GOOGLE_PROTOBUF_WIRE_FORMAT_MAKE_TAG(
+    UNIVERSE_FIELD, WireFormatLite::WIRETYPE_VARINT);
+const uint32_t DATA_TAG = GOOGLE_PROTOBUF_WIRE_FORMAT_MAKE_TAG(
+    DATA_FIELD, WireFormatLite::WIRETYPE_LENGTH_DELIMITED);
+const uint32_t PRIORITY_TAG = GOOGLE_PROTOBUF_WIRE_FORMAT_MAKE_TAG(
+    PRIORITY_FIELD, WireFormatLite::WIRETYPE_VARINT);
+}  // namespace
+
+int DmxDataCodec::Encode(unsigned int universe,
+                         uint8_t priority,
+                         const DmxBuffer &buffer,
+                         IOVec *iov) {
+  // Fields are written in field number order, which matches the output of
+  // the generated code.
+  uint8_t *ptr = m_prefix;
+  ptr = CodedOutputStream::WriteTagToArray(UNIVERSE_TAG, ptr);
+  ptr = CodedOutputStream::WriteVarint32SignExtendedToArray(
+      static_cast<int32_t>(universe), ptr);
+  ptr = CodedOutputStream::WriteTagToArray(DATA_TAG, ptr);
+  ptr = CodedOutputStream::WriteVarint32ToArray(buffer.Size(), ptr);
+
+  int iocnt = 0;
+  iov[iocnt].iov_base = m_prefix;
+  iov[iocnt++].iov_len = ptr - m_prefix;
+
+  if (buffer.Size()) {
+    iov[iocnt].iov_base = const_cast<uint8_t*>(buffer.GetRaw());
+    iov[iocnt++].iov_len = buffer.Size();
+  }
+
+  ptr = m_suffix;
+  ptr = CodedOutputStream::WriteTagToArray(PRIORITY_TAG, ptr);
+  ptr = CodedOutputStream::WriteVarint32ToArray(priority, ptr);
+  iov[iocnt].iov_base = m_suffix;
+  iov[iocnt++].iov_len = ptr - m_suffix;
+  return iocnt;
+}
+
+bool DmxDataCodec::Decode(const uint8_t *data, unsigned int size,
+                          DmxDataFields *fields) {
+  CodedInputStream input(data, size);
+  bool has_universe = false;
+  fields->universe = 0;
+  fields->has_priority = false;
+  fields->priority = 0;
+  fields->data = NULL;
+  fields->length = 0;
+
+  uint32_t tag;
+  while ((tag = input.ReadTag()) != 0) {
+    uint32_t value;
+    switch (tag) {
+      case UNIVERSE_TAG:
+        if (!input.ReadVarint32(&value)) {
+          return false;
+        }
+        fields->universe = static_cast<int32_t>(value);
+        has_universe = true;
+        break;
+      case DATA_TAG:
+        if (!input.ReadVarint32(&value)) {
+          return false;
+        }
+        fields->data = data + input.CurrentPosition();
+        fields->length = value;
+        if (!input.Skip(value)) {
+          return false;
+        }
+        break;
+      case PRIORITY_TAG:
+        if (!input.ReadVarint32(&value)) {
+          return false;
+        }
+        fields->priority = static_cast<int32_t>(value);
+        fields->has_priority = true;
+        break;
+      default:
+        if (!WireFormatLite::SkipField(&input, tag)) {
+          return false;
+        }
+    }
+  }
+  return has_universe && input.ExpectAtEnd();
+}
+}  // namespace rpc
+}  // namespace ola
@@ -0,0 +1,96 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * DmxDataCodec.h
+ * Encode and decode DmxData messages without copying the DMX data.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef COMMON_RPC_DMXDATACODEC_H_
+#define COMMON_RPC_DMXDATACODEC_H_
+
+#include <stdint.h>
+#include <ola/DmxBuffer.h>
+#include <ola/base/Macro.h>
+#include <ola/io/IOVecInterface.h>
+
+namespace ola {
+namespace rpc {
+
+/**
+ * @brief The fields of a DmxData message, as returned by
+ * DmxDataCodec::Decode().
+ *
+ * The data member points into the buffer that was decoded.
+ */
+struct DmxDataFields {
+  int32_t universe;
+  bool has_priority;
+  int32_t priority;
+  const uint8_t *data;
+  unsigned int length;
+};
+
+/**
+ * @brief Encode and decode ola.proto.DmxData messages.
+ *
+ * The generated protobuf code copies the DMX data into a std::string when a
+ * message is built, again when it's serialized and again when it's parsed.
+ * This produces the same wire format, but the encoded message is a set of
+ * IOVecs that point at the DmxBuffer's storage, and decoding returns a
+ * pointer into the received data.
+ */
+class DmxDataCodec {
+ public:
+  DmxDataCodec() {}
+
+  /**
+   * @brief Encode a DmxData message.
+   * @param universe the universe id.
+   * @param priority the priority of the data.
+   * @param buffer the DMX data. This must not be modified until the IOVecs
+   *   have been written.
+   * @param[out] iov an array of at least MAX_IOVECS entries, populated with
+   *   the encoded message. These point into both buffer and this object.
+   * @returns the number of IOVecs used.
+   */
+  int Encode(unsigned int universe,
+             uint8_t priority,
+             const DmxBuffer &buffer,
+             ola::io::IOVec *iov);
+
+  /**
+   * @brief Decode a DmxData message.
+   * @param data the serialized message.
+   * @param size the size of the serialized message.
+   * @param[out] fields the decoded fields.
+   * @returns true if the message was valid, false otherwise.
+   */
+  static bool Decode(const uint8_t *data, unsigned int size,
+                     DmxDataFields *fields);
+
+  static const int MAX_IOVECS = 3;
+
+ private:
+  // Tag + 10 byte (sign extended) varint + tag + 5 byte length.
+  uint8_t m_prefix[17];
+  // Tag + 5 byte varint.
+  uint8_t m_suffix[6];
+
+  DISALLOW_COPY_AND_ASSIGN(DmxDataCodec);
+};
+}  // namespace rpc
+}  // namespace ola
+#endif  // COMMON_RPC_DMXDATACODEC_H_
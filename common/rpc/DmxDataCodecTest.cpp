@@ -0,0 +1,173 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * DmxDataCodecTest.cpp
+ * Test fixture for the DmxDataCodec class
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <stdint.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <string>
+
+#include "common/protocol/Ola.pb.h"
+#include "common/rpc/DmxDataCodec.h"
+#include "ola/DmxBuffer.h"
+#include "ola/io/IOVecInterface.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::DmxBuffer;
+using ola::io::IOVec;
+using ola::rpc::DmxDataCodec;
+using ola::rpc::DmxDataFields;
+using std::string;
+
+class DmxDataCodecTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(DmxDataCodecTest);
+  CPPUNIT_TEST(testEncode);
+  CPPUNIT_TEST(testDecode);
+  CPPUNIT_TEST(testDecodeErrors);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    void testEncode();
+    void testDecode();
+    void testDecodeErrors();
+
+ private:
+    string Encode(unsigned int universe, uint8_t priority,
+                  const DmxBuffer &buffer);
+    string Serialize(unsigned int universe, uint8_t priority,
+                     const DmxBuffer &buffer);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(DmxDataCodecTest);
+
+
+string DmxDataCodecTest::Encode(unsigned int universe, uint8_t priority,
+                                const DmxBuffer &buffer) {
+  DmxDataCodec codec;
+  IOVec iov[DmxDataCodec::MAX_IOVECS];
+  int iocnt = codec.Encode(universe, priority, buffer, iov);
+  OLA_ASSERT_TRUE(iocnt <= DmxDataCodec::MAX_IOVECS);
+
+  string output;
+  for (int i = 0; i < iocnt; i++) {
+    output.append(reinterpret_cast<char*>(iov[i].iov_base), iov[i].iov_len);
+  }
+  return output;
+}
+
+
+string DmxDataCodecTest::Serialize(unsigned int universe, uint8_t priority,
+                                   const DmxBuffer &buffer) {
+  ola::proto::DmxData message;
+  message.set_universe(universe);
+  message.set_data(buffer.Get());
+  message.set_priority(priority);
+  string output;
+  message.SerializeToString(&output);
+  return output;
+}
+
+
+/*
+ * Check the encoded messages match the output of the generated code.
+ */
+void DmxDataCodecTest::testEncode() {
+  DmxBuffer buffer;
+  buffer.SetFromString("0,1,2,3,4,5,255");
+  OLA_ASSERT_EQ(Serialize(1, 100, buffer), Encode(1, 100, buffer));
+
+  // A full universe, which needs a two byte length.
+  DmxBuffer full;
+  full.Blackout();
+  OLA_ASSERT_EQ(Serialize(65535, 200, full), Encode(65535, 200, full));
+
+  // Universes above INT32_MAX are negative in the proto.
+  OLA_ASSERT_EQ(Serialize(0xffffffff, 0, buffer),
+                Encode(0xffffffff, 0, buffer));
+
+  DmxBuffer empty;
+  OLA_ASSERT_EQ(Serialize(2, 100, empty), Encode(2, 100, empty));
+}
+
+
+/*
+ * Check we can decode messages from the generated code.
+ */
+void DmxDataCodecTest::testDecode() {
+  DmxBuffer buffer;
+  buffer.SetFromString("0,1,2,3,4,5,255");
+  string serialized = Serialize(10, 150, buffer);
+
+  DmxDataFields fields;
+  OLA_ASSERT_TRUE(DmxDataCodec::Decode(
+      reinterpret_cast<const uint8_t*>(serialized.data()), serialized.size(),
+      &fields));
+  OLA_ASSERT_EQ(10, fields.universe);
+  OLA_ASSERT_TRUE(fields.has_priority);
+  OLA_ASSERT_EQ(150, fields.priority);
+  OLA_ASSERT_DATA_EQUALS(buffer.GetRaw(), buffer.Size(), fields.data,
+                         fields.length);
+  // The data isn't copied
+  OLA_ASSERT_TRUE(
+      fields.data > reinterpret_cast<const uint8_t*>(serialized.data()));
+  OLA_ASSERT_TRUE(
+      fields.data < reinterpret_cast<const uint8_t*>(serialized.data()) +
+                    serialized.size());
+
+  // no priority, and an extra field which should be skipped.
+  ola::proto::DmxData message;
+  message.set_universe(-1);
+  message.set_data(buffer.Get());
+  message.SerializeToString(&serialized);
+  serialized.append("\x78\x01", 2);  // field 15, varint 1
+  OLA_ASSERT_TRUE(DmxDataCodec::Decode(
+      reinterpret_cast<const uint8_t*>(serialized.data()), serialized.size(),
+      &fields));
+  OLA_ASSERT_EQ(-1, fields.universe);
+  OLA_ASSERT_FALSE(fields.has_priority);
+  OLA_ASSERT_DATA_EQUALS(buffer.GetRaw(), buffer.Size(), fields.data,
+                         fields.length);
+}
+
+
+/*
+ * Check invalid messages are rejected.
+ */
+void DmxDataCodecTest::testDecodeErrors() {
+  DmxDataFields fields;
+  OLA_ASSERT_FALSE(DmxDataCodec::Decode(NULL, 0, &fields));
+
+  DmxBuffer buffer;
+  buffer.SetFromString("0,1,2,3,4,5,255");
+  string serialized = Serialize(10, 150, buffer);
+  const uint8_t *data = reinterpret_cast<const uint8_t*>(serialized.data());
+
+  // truncated in the DMX data
+  OLA_ASSERT_FALSE(DmxDataCodec::Decode(data, 6, &fields));
+  // truncated in the priority field
+  OLA_ASSERT_FALSE(
+      DmxDataCodec::Decode(data, serialized.size() - 1, &fields));
+
+  // missing universe
+  ola::proto::DmxData message;
+  message.set_data(buffer.Get());
+  message.SerializePartialToString(&serialized);
+  OLA_ASSERT_FALSE(DmxDataCodec::Decode(
+      reinterpret_cast<const uint8_t*>(serialized.data()), serialized.size(),
+      &fields));
+}
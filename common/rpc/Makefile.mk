@@ -9,6 +9,10 @@ built_sources += \
 # LIBRARIES
 ##################################################
 common_libolacommon_la_SOURCES += \
+    common/rpc/BinaryDmxFrame.cpp \
+    common/rpc/BinaryDmxFrame.h \
+    common/rpc/DmxDataCodec.cpp \
+    common/rpc/DmxDataCodec.h \
     common/rpc/RpcChannel.cpp \
     common/rpc/RpcChannel.h \
     common/rpc/RpcSession.h \
@@ -44,6 +48,8 @@ common_rpc_TEST_SOURCES = \
     common/rpc/TestService.cpp
 
 common_rpc_RpcTester_SOURCES = \
+    common/rpc/BinaryDmxFrameTest.cpp \
+    common/rpc/DmxDataCodecTest.cpp \
     common/rpc/RpcControllerTest.cpp \
     common/rpc/RpcChannelTest.cpp \
     common/rpc/RpcHeaderTest.cpp \
@@ -25,6 +25,10 @@
 #include <google/protobuf/message.h>
 #include <google/protobuf/descriptor.h>
 #include <google/protobuf/dynamic_message.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/wire_format_lite.h>
+#include <string.h>
+#include <algorithm>
 #include <string>
 
 #include "common/rpc/Rpc.pb.h"
@@ -34,7 +38,6 @@
 #include "common/rpc/RpcService.h"
 #include "ola/Callback.h"
 #include "ola/Logging.h"
-#include "ola/base/Array.h"
 #include "ola/stl/STLUtils.h"
 
 namespace ola {
@@ -43,19 +46,41 @@ namespace rpc {
 using google::protobuf::Message;
 using google::protobuf::MethodDescriptor;
 using google::protobuf::ServiceDescriptor;
+using google::protobuf::internal::WireFormatLite;
+using google::protobuf::io::CodedInputStream;
+using google::protobuf::io::CodedOutputStream;
+using ola::io::IOVec;
 using std::auto_ptr;
 using std::string;
 
+namespace {
+// The tags of the RpcMessage fields, used when building or decoding the
+// message by hand.
+const uint32_t TYPE_TAG = GOOGLE_PROTOBUF_WIRE_FORMAT_MAKE_TAG(
+    RpcMessage::kTypeFieldNumber, WireFormatLite::WIRETYPE_VARINT);
+const uint32_t ID_TAG = GOOGLE_PROTOBUF_WIRE_FORMAT_MAKE_TAG(
+    RpcMessage::kIdFieldNumber, WireFormatLite::WIRETYPE_VARINT);
+const uint32_t NAME_TAG = GOOGLE_PROTOBUF_WIRE_FORMAT_MAKE_TAG(
+    RpcMessage::kNameFieldNumber, WireFormatLite::WIRETYPE_LENGTH_DELIMITED);
+const uint32_t BUFFER_TAG = GOOGLE_PROTOBUF_WIRE_FORMAT_MAKE_TAG(
+    RpcMessage::kBufferFieldNumber, WireFormatLite::WIRETYPE_LENGTH_DELIMITED);
+}  // namespace
+
 const char RpcChannel::K_RPC_RECEIVED_TYPE_VAR[] = "rpc-received-type";
 const char RpcChannel::K_RPC_RECEIVED_VAR[] = "rpc-received";
 const char RpcChannel::K_RPC_SENT_ERROR_VAR[] = "rpc-send-errors";
 const char RpcChannel::K_RPC_SENT_VAR[] = "rpc-sent";
 const char RpcChannel::STREAMING_NO_RESPONSE[] = "STREAMING_NO_RESPONSE";
 
-const char *RpcChannel::K_RPC_VARIABLES[] = {
-  K_RPC_RECEIVED_VAR,
-  K_RPC_SENT_ERROR_VAR,
-  K_RPC_SENT_VAR,
+// Indexed by ReceivedType
+const char *RpcChannel::K_RECEIVED_TYPE_NAMES[] = {
+  "raw",
+  "request",
+  "response",
+  "cancelled",
+  "failed",
+  "not-implemented",
+  "stream_request",
 };
 
 class OutstandingRequest {
@@ -117,8 +142,17 @@ RpcChannel::RpcChannel(
       m_buffer_size(0),
       m_expected_size(0),
       m_current_size(0),
+      m_raw_frame(false),
       m_export_map(export_map),
-      m_recv_type_map(NULL) {
+      m_received_var(NULL),
+      m_sent_var(NULL),
+      m_sent_error_var(NULL),
+      m_cork_depth(0),
+      m_corked_messages(0) {
+  for (unsigned int i = 0; i < RECEIVED_TYPE_COUNT; ++i) {
+    m_received_types[i] = NULL;
+  }
+
   if (descriptor) {
     descriptor->SetOnData(
         ola::NewCallback(this, &RpcChannel::DescriptorReady));
@@ -127,11 +161,14 @@ RpcChannel::RpcChannel(
   }
 
   if (m_export_map) {
-    for (unsigned int i = 0; i < arraysize(K_RPC_VARIABLES); ++i) {
-      m_export_map->GetCounterVar(string(K_RPC_VARIABLES[i]));
+    m_received_var = m_export_map->GetCounterVar(K_RPC_RECEIVED_VAR);
+    m_sent_var = m_export_map->GetCounterVar(K_RPC_SENT_VAR);
+    m_sent_error_var = m_export_map->GetCounterVar(K_RPC_SENT_ERROR_VAR);
+    UIntMap *recv_type_map = m_export_map->GetUIntMapVar(
+        K_RPC_RECEIVED_TYPE_VAR, "type");
+    for (unsigned int i = 0; i < RECEIVED_TYPE_COUNT; ++i) {
+      m_received_types[i] = recv_type_map->Handle(K_RECEIVED_TYPE_NAMES[i]);
     }
-    m_recv_type_map = m_export_map->GetUIntMapVar(K_RPC_RECEIVED_TYPE_VAR,
-                                                  "type");
   }
 }
 
@@ -140,26 +177,39 @@ RpcChannel::~RpcChannel() {
 }
 
 void RpcChannel::DescriptorReady() {
+  // Handle every message that has arrived, so the descriptor can use edge
+  // triggered notification.
+  while (ReadMessage() && m_descriptor && m_descriptor->DataRemaining()) {
+  }
+}
+
+/*
+ * Read the next message, or as much of it as has arrived.
+ * @returns true if a message was handled, false otherwise.
+ */
+bool RpcChannel::ReadMessage() {
   if (!m_expected_size) {
     // this is a new msg
     unsigned int version;
     if (ReadHeader(&version, &m_expected_size) < 0)
-      return;
+      return false;
 
     if (!m_expected_size)
-      return;
+      return false;
 
-    if (version != PROTOCOL_VERSION) {
-      OLA_WARN << "protocol mismatch " << version << " != " <<
-        PROTOCOL_VERSION;
-      return;
+    if (version != PROTOCOL_VERSION && version != RAW_FRAME_VERSION) {
+      OLA_WARN << "protocol mismatch " << version << " is neither "
+               << PROTOCOL_VERSION << " (RPC) nor " << RAW_FRAME_VERSION
+               << " (raw frame)";
+      return false;
     }
+    m_raw_frame = version == RAW_FRAME_VERSION;
 
     if (m_expected_size > MAX_BUFFER_SIZE) {
       OLA_WARN << "Incoming message size " << m_expected_size
                 << " is larger than MAX_BUFFER_SIZE: " << MAX_BUFFER_SIZE;
       m_descriptor->Close();
-      return;
+      return false;
     }
 
     m_current_size = 0;
@@ -168,12 +218,12 @@ void RpcChannel::DescriptorReady() {
     if (m_buffer_size < m_expected_size) {
       OLA_WARN << "buffer size to small " << m_buffer_size << " < " <<
         m_expected_size;
-      return;
+      return false;
     }
   }
 
   if (!m_descriptor) {
-    return;
+    return false;
   }
 
   unsigned int data_read;
@@ -181,35 +231,90 @@ void RpcChannel::DescriptorReady() {
                             m_expected_size - m_current_size,
                             data_read) < 0) {
     OLA_WARN << "something went wrong in descriptor recv\n";
-    return;
+    return false;
   }
 
   m_current_size += data_read;
 
-  if (m_current_size == m_expected_size) {
-    // we've got all of this message so parse it.
-    if (!HandleNewMsg(m_buffer, m_expected_size)) {
-      // this probably means we've messed the framing up, close the channel
-      OLA_WARN << "Errors detected on RPC channel, closing";
-      m_descriptor->Close();
-    }
-    m_expected_size = 0;
+  if (m_current_size != m_expected_size) {
+    // The rest of the message hasn't arrived yet.
+    return false;
   }
-  return;
+
+  // we've got all of this message so handle it.
+  bool ok = true;
+  if (m_raw_frame) {
+    HandleRawFrame(m_buffer, m_expected_size);
+  } else if (!HandleNewMsg(m_buffer, m_expected_size)) {
+    // this probably means we've messed the framing up, close the channel
+    OLA_WARN << "Errors detected on RPC channel, closing";
+    m_descriptor->Close();
+    ok = false;
+  }
+  m_expected_size = 0;
+  return ok;
 }
 
 void RpcChannel::SetChannelCloseHandler(CloseCallback *callback) {
   m_on_close.reset(callback);
 }
 
+void RpcChannel::SetRawFrameHandler(RawFrameHandler *handler) {
+  m_raw_frame_handler.reset(handler);
+}
+
+bool RpcChannel::SendRawFrame(const IOVec *iov, int iocnt) {
+  unsigned int length = 0;
+  for (int i = 0; i < iocnt; i++) {
+    length += iov[i].iov_len;
+  }
+
+  uint32_t header;
+  RpcHeader::EncodeHeader(&header, RAW_FRAME_VERSION, length);
+
+  m_send_iov.resize(iocnt + 1);
+  m_send_iov[0].iov_base = &header;
+  m_send_iov[0].iov_len = sizeof(header);
+  std::copy(iov, iov + iocnt, m_send_iov.begin() + 1);
+  return SendIOVec(&m_send_iov[0], m_send_iov.size(),
+                   sizeof(header) + length);
+}
+
+void RpcChannel::Cork() {
+  m_cork_depth++;
+}
+
+bool RpcChannel::Uncork() {
+  if (m_cork_depth == 0) {
+    OLA_WARN << "Uncork() called on a channel which isn't corked";
+    return true;
+  }
+  if (--m_cork_depth) {
+    return true;
+  }
+  return FlushCorkBuffer();
+}
+
 void RpcChannel::CallMethod(const MethodDescriptor *method,
                             RpcController *controller,
                             const Message *request,
                             Message *reply,
                             SingleUseCallback0<void> *done) {
-  // TODO(simonn): reduce the number of copies here
   string output;
-  RpcMessage message;
+  request->SerializeToString(&output);
+
+  IOVec iov;
+  iov.iov_base = const_cast<char*>(output.data());
+  iov.iov_len = output.size();
+  CallMethod(method, controller, &iov, 1, reply, done);
+}
+
+void RpcChannel::CallMethod(const MethodDescriptor *method,
+                            RpcController *controller,
+                            const IOVec *request,
+                            int iocnt,
+                            Message *reply,
+                            SingleUseCallback0<void> *done) {
   bool is_streaming = false;
 
   // Streaming methods are those with a reply set to STREAMING_NO_RESPONSE and
@@ -223,13 +328,8 @@ void RpcChannel::CallMethod(const MethodDescriptor *method,
     is_streaming = true;
   }
 
-  message.set_type(is_streaming ? STREAM_REQUEST : REQUEST);
-  message.set_id(m_sequence.Next());
-  message.set_name(method->name());
-
-  request->SerializeToString(&output);
-  message.set_buffer(output);
-  bool r = SendMsg(&message);
+  uint32_t id = m_sequence.Next();
+  bool r = SendRequest(is_streaming, id, method->name(), request, iocnt);
 
   if (is_streaming)
     return;
@@ -242,10 +342,10 @@ void RpcChannel::CallMethod(const MethodDescriptor *method,
   }
 
   OutstandingResponse *response = new OutstandingResponse(
-      message.id(), controller, done, reply);
+      id, controller, done, reply);
 
   auto_ptr<OutstandingResponse> old_response(
-      STLReplacePtr(&m_responses, message.id(), response));
+      STLReplacePtr(&m_responses, id, response));
 
   if (old_response.get()) {
     // fail any outstanding response with the same id
@@ -284,11 +384,6 @@ RpcSession *RpcChannel::Session() {
  * Write an RpcMessage to the write descriptor.
  */
 bool RpcChannel::SendMsg(RpcMessage *msg) {
-  if (!(m_descriptor && m_descriptor->ValidReadDescriptor())) {
-    OLA_WARN << "RPC descriptor closed, not sending messages";
-    return false;
-  }
-
   uint32_t header;
   // reserve the first 4 bytes for the header
   string output(sizeof(header), 0);
@@ -301,14 +396,130 @@ bool RpcChannel::SendMsg(RpcMessage *msg) {
       0, sizeof(header),
       reinterpret_cast<const char*>(&header), sizeof(header));
 
-  ssize_t ret = m_descriptor->Send(
-      reinterpret_cast<const uint8_t*>(output.data()), length);
+  IOVec iov;
+  iov.iov_base = const_cast<char*>(output.data());
+  iov.iov_len = length;
+  return SendIOVec(&iov, 1, length);
+}
+
+
+/*
+ * Write a request to the write descriptor. The RpcMessage is encoded by hand
+ * so that the serialized request can be written directly after it, rather
+ * than being copied into the buffer field.
+ */
+bool RpcChannel::SendRequest(bool is_streaming,
+                             uint32_t id,
+                             const string &name,
+                             const IOVec *request,
+                             int iocnt) {
+  unsigned int request_size = 0;
+  for (int i = 0; i < iocnt; i++) {
+    request_size += request[i].iov_len;
+  }
+
+  // The fields are written in field number order, which matches the output
+  // of the generated code. Each tag fits in a byte and each varint in 5.
+  uint32_t header;
+  m_envelope.resize(sizeof(header) + 4 * (1 + 5) + name.size());
+  uint8_t *start = &m_envelope[0];
+  uint8_t *ptr = start + sizeof(header);
+  ptr = CodedOutputStream::WriteTagToArray(TYPE_TAG, ptr);
+  ptr = CodedOutputStream::WriteVarint32ToArray(
+      is_streaming ? STREAM_REQUEST : REQUEST, ptr);
+  ptr = CodedOutputStream::WriteTagToArray(ID_TAG, ptr);
+  ptr = CodedOutputStream::WriteVarint32ToArray(id, ptr);
+  ptr = CodedOutputStream::WriteTagToArray(NAME_TAG, ptr);
+  ptr = CodedOutputStream::WriteVarint32ToArray(name.size(), ptr);
+  memcpy(ptr, name.data(), name.size());
+  ptr += name.size();
+  ptr = CodedOutputStream::WriteTagToArray(BUFFER_TAG, ptr);
+  ptr = CodedOutputStream::WriteVarint32ToArray(request_size, ptr);
+
+  unsigned int envelope_size = ptr - start;
+  RpcHeader::EncodeHeader(&header, PROTOCOL_VERSION,
+                          envelope_size - sizeof(header) + request_size);
+  memcpy(start, &header, sizeof(header));
+
+  m_send_iov.resize(iocnt + 1);
+  m_send_iov[0].iov_base = start;
+  m_send_iov[0].iov_len = envelope_size;
+  std::copy(request, request + iocnt, m_send_iov.begin() + 1);
+  return SendIOVec(&m_send_iov[0], m_send_iov.size(),
+                   envelope_size + request_size);
+}
+
+
+/*
+ * Send a complete message, or hold it back if the channel is corked.
+ */
+bool RpcChannel::SendIOVec(const IOVec *iov, int iocnt, unsigned int length) {
+  if (!m_cork_depth) {
+    if (!WriteIOVec(iov, iocnt, length)) {
+      return false;
+    }
+    if (m_sent_var) {
+      (*m_sent_var)++;
+    }
+  } else {
+    if (!(m_descriptor && m_descriptor->ValidReadDescriptor())) {
+      OLA_WARN << "RPC descriptor closed, not sending messages";
+      return false;
+    }
+
+    if (m_cork_buffer.size() + length > MAX_CORK_SIZE &&
+        !FlushCorkBuffer()) {
+      return false;
+    }
+
+    for (int i = 0; i < iocnt; i++) {
+      const uint8_t *data = reinterpret_cast<const uint8_t*>(iov[i].iov_base);
+      m_cork_buffer.insert(m_cork_buffer.end(), data, data + iov[i].iov_len);
+    }
+    m_corked_messages++;
+  }
+  return true;
+}
+
+
+/*
+ * Write the held back messages to the descriptor. They're only counted as
+ * sent once they've been written.
+ */
+bool RpcChannel::FlushCorkBuffer() {
+  if (m_cork_buffer.empty()) {
+    return true;
+  }
+
+  IOVec iov;
+  iov.iov_base = &m_cork_buffer[0];
+  iov.iov_len = m_cork_buffer.size();
+  bool ok = WriteIOVec(&iov, 1, m_cork_buffer.size());
+  if (ok && m_sent_var) {
+    (*m_sent_var) += m_corked_messages;
+  }
+  m_cork_buffer.clear();
+  m_corked_messages = 0;
+  return ok;
+}
+
 
-  if (ret != length) {
+/*
+ * Write data to the write descriptor.
+ */
+bool RpcChannel::WriteIOVec(const IOVec *iov, int iocnt, unsigned int length) {
+  if (!(m_descriptor && m_descriptor->ValidReadDescriptor())) {
+    OLA_WARN << "RPC descriptor closed, not sending messages";
+    return false;
+  }
+
+  ssize_t ret = m_descriptor->Send(iov, iocnt);
+
+  if (ret < 0 || static_cast<unsigned int>(ret) != length) {
     OLA_WARN << "Failed to send full RPC message, closing channel";
 
-    if (m_export_map) {
-      (*m_export_map->GetCounterVar(K_RPC_SENT_ERROR_VAR))++;
+    if (m_sent_error_var) {
+      (*m_sent_error_var)++;
     }
 
     // At this point there is no point using the descriptor since framing has
@@ -320,10 +531,6 @@ bool RpcChannel::SendMsg(RpcMessage *msg) {
     HandleChannelClose();
     return false;
   }
-
-  if (m_export_map) {
-    (*m_export_map->GetCounterVar(K_RPC_SENT_VAR))++;
-  }
   return true;
 }
 
@@ -383,51 +590,61 @@ int RpcChannel::ReadHeader(unsigned int *version,
 }
 
 
+/*
+ * Pass a raw frame to the handler.
+ */
+void RpcChannel::HandleRawFrame(const uint8_t *data, unsigned int size) {
+  CountReceived(RECEIVED_RAW);
+
+  if (m_raw_frame_handler.get()) {
+    m_raw_frame_handler->Run(m_session.get(), data, size);
+  } else {
+    OLA_WARN << "Received a raw frame but no handler is set, discarding";
+  }
+}
+
+
 /*
  * Parse a new message and handle it.
  */
 bool RpcChannel::HandleNewMsg(uint8_t *data, unsigned int size) {
+  if (HandleRawStreamRequest(data, size)) {
+    return true;
+  }
+
   RpcMessage msg;
   if (!msg.ParseFromArray(data, size)) {
     OLA_WARN << "Failed to parse RPC";
     return false;
   }
 
-  if (m_export_map)
-    (*m_export_map->GetCounterVar(K_RPC_RECEIVED_VAR))++;
-
   switch (msg.type()) {
     case REQUEST:
-      if (m_recv_type_map)
-        (*m_recv_type_map)["request"]++;
+      CountReceived(RECEIVED_REQUEST);
       HandleRequest(&msg);
       break;
     case RESPONSE:
-      if (m_recv_type_map)
-        (*m_recv_type_map)["response"]++;
+      CountReceived(RECEIVED_RESPONSE);
       HandleResponse(&msg);
       break;
     case RESPONSE_CANCEL:
-      if (m_recv_type_map)
-        (*m_recv_type_map)["cancelled"]++;
+      CountReceived(RECEIVED_CANCELLED);
       HandleCanceledResponse(&msg);
       break;
     case RESPONSE_FAILED:
-      if (m_recv_type_map)
-        (*m_recv_type_map)["failed"]++;
+      CountReceived(RECEIVED_FAILED);
       HandleFailedResponse(&msg);
       break;
     case RESPONSE_NOT_IMPLEMENTED:
-      if (m_recv_type_map)
-        (*m_recv_type_map)["not-implemented"]++;
+      CountReceived(RECEIVED_NOT_IMPLEMENTED);
       HandleNotImplemented(&msg);
       break;
     case STREAM_REQUEST:
-      if (m_recv_type_map)
-        (*m_recv_type_map)["stream_request"]++;
+      CountReceived(RECEIVED_STREAM_REQUEST);
       HandleStreamRequest(&msg);
       break;
     default:
+      CountReceived(RECEIVED_TYPE_COUNT);
       OLA_WARN << "not sure of msg type " << msg.type();
       break;
   }
@@ -531,6 +748,87 @@ void RpcChannel::HandleStreamRequest(RpcMessage *msg) {
 }
 
 
+/*
+ * Try to pass a streaming request to the service without parsing it. This
+ * avoids copying the request into an RpcMessage and then into the request
+ * message.
+ * @returns true if the service handled the request, false if the message
+ *   should be parsed and handled as normal.
+ */
+bool RpcChannel::HandleRawStreamRequest(const uint8_t *data,
+                                        unsigned int size) {
+  // The type is always the first field, so this quickly rules out everything
+  // other than stream requests.
+  if (!m_service || size < 2 || data[0] != TYPE_TAG ||
+      data[1] != STREAM_REQUEST) {
+    return false;
+  }
+
+  CodedInputStream input(data, size);
+  const uint8_t *name = NULL;
+  unsigned int name_size = 0;
+  const uint8_t *request = NULL;
+  unsigned int request_size = 0;
+
+  uint32_t tag;
+  while ((tag = input.ReadTag()) != 0) {
+    uint32_t value;
+    if (!input.ReadVarint32(&value)) {
+      return false;
+    }
+
+    switch (tag) {
+      case TYPE_TAG:
+        if (value != STREAM_REQUEST) {
+          return false;
+        }
+        break;
+      case ID_TAG:
+        break;
+      case NAME_TAG:
+        name = data + input.CurrentPosition();
+        name_size = value;
+        if (!input.Skip(value)) {
+          return false;
+        }
+        break;
+      case BUFFER_TAG:
+        request = data + input.CurrentPosition();
+        request_size = value;
+        if (!input.Skip(value)) {
+          return false;
+        }
+        break;
+      default:
+        return false;
+    }
+  }
+
+  if (!input.ExpectAtEnd() || !name) {
+    return false;
+  }
+
+  const ServiceDescriptor *service = m_service->GetDescriptor();
+  if (!service) {
+    return false;
+  }
+  const MethodDescriptor *method = service->FindMethodByName(
+      string(reinterpret_cast<const char*>(name), name_size));
+  if (!method || method->output_type()->name() != STREAMING_NO_RESPONSE) {
+    return false;
+  }
+
+  RpcController controller(m_session.get());
+  if (!m_service->HandleRawStreamRequest(method, &controller, request,
+                                         request_size)) {
+    return false;
+  }
+
+  CountReceived(RECEIVED_STREAM_REQUEST);
+  return true;
+}
+
+
 // server side
 /*
  * Notify the caller that the request failed.
@@ -629,5 +927,17 @@ void RpcChannel::HandleChannelClose() {
     m_on_close.release()->Run(m_session.get());
   }
 }
+
+
+/*
+ * Update the stats for a received message. RECEIVED_TYPE_COUNT is used for
+ * messages of an unknown type.
+ */
+void RpcChannel::CountReceived(ReceivedType type) {
+  if (m_received_var)
+    (*m_received_var)++;
+  if (type < RECEIVED_TYPE_COUNT && m_received_types[type])
+    (*m_received_types[type])++;
+}
 }  // namespace rpc
 }  // namespace ola
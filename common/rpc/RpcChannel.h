@@ -29,8 +29,11 @@
 #include <google/protobuf/service.h>
 #include <ola/Callback.h>
 #include <ola/io/Descriptor.h>
+#include <ola/io/IOVecInterface.h>
 #include <ola/util/SequenceNumber.h>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "ola/ExportMap.h"
 
@@ -58,6 +61,16 @@ class RpcChannel {
    */
   typedef SingleUseCallback1<void, class RpcSession*> CloseCallback;
 
+  /**
+   * @brief The callback to run when a raw frame arrives.
+   *
+   * When run, the callback is passed the RpcSession associated with this
+   * channel and the frame data, which is only valid for the duration of the
+   * call.
+   */
+  typedef Callback3<void, class RpcSession*, const uint8_t*, unsigned int>
+      RawFrameHandler;
+
     /**
      * @brief Create a new RpcChannel.
      * @param service the Service to use to handle incoming requests. Ownership
@@ -117,6 +130,64 @@ class RpcChannel {
                     google::protobuf::Message *response,
                     SingleUseCallback0<void> *done);
 
+    /**
+     * @brief Invoke an RPC method with a request that is already serialized.
+     * @param method the method to invoke.
+     * @param controller the RpcController, NULL for streaming methods.
+     * @param request an array of IOVecs containing the serialized request.
+     * @param iocnt the number of IOVecs in request.
+     * @param response the response message, NULL for streaming methods.
+     * @param done the callback to run on completion, NULL for streaming
+     *   methods.
+     *
+     * The RPC header is built in place and written along with the request in
+     * a single call, so the request data isn't copied. This is used to send
+     * DMX data straight from a DmxBuffer, see DmxDataCodec.
+     */
+    void CallMethod(const google::protobuf::MethodDescriptor *method,
+                    class RpcController *controller,
+                    const ola::io::IOVec *request,
+                    int iocnt,
+                    google::protobuf::Message *response,
+                    SingleUseCallback0<void> *done);
+
+    /**
+     * @brief Set the handler for raw frames.
+     * @param handler the handler to run, ownership is transferred. If NULL,
+     *   raw frames are discarded.
+     *
+     * Raw frames carry an application defined payload rather than an
+     * RpcMessage, for high rate data such as DMX where the cost of the
+     * RpcMessage matters. They can be interleaved with RPCs.
+     */
+    void SetRawFrameHandler(RawFrameHandler *handler);
+
+    /**
+     * @brief Send a raw frame.
+     * @param iov the IOVecs containing the frame payload.
+     * @param iocnt the number of IOVecs.
+     * @returns true if the frame was sent, false if the channel is closed.
+     */
+    bool SendRawFrame(const ola::io::IOVec *iov, int iocnt);
+
+    /**
+     * @brief Hold back outgoing messages until Uncork() is called.
+     *
+     * Messages sent while the channel is corked are copied into a buffer,
+     * and written with a single call when it's uncorked. This lets a caller
+     * sending a burst of messages, like DMX for several universes, avoid a
+     * system call per message. Calls can be nested, the messages are written
+     * when the last Uncork() is called.
+     */
+    void Cork();
+
+    /**
+     * @brief Write any messages held back since Cork() was called.
+     * @returns true if the messages were sent, false if the channel is
+     *   closed.
+     */
+    bool Uncork();
+
     /**
      * @brief Invoked by the RPC completion handler when the server side
      * response is ready.
@@ -135,6 +206,11 @@ class RpcChannel {
      */
     static const unsigned int PROTOCOL_VERSION = 1;
 
+    /**
+     * @brief the version used in the header of raw frames.
+     */
+    static const unsigned int RAW_FRAME_VERSION = 2;
+
  private:
     typedef HASH_NAMESPACE::HASH_MAP_CLASS<int, class OutstandingResponse*>
       ResponseMap;
@@ -142,6 +218,7 @@ class RpcChannel {
     std::auto_ptr<RpcSession> m_session;
     RpcService *m_service;  // service to dispatch requests to
     std::auto_ptr<CloseCallback> m_on_close;
+    std::auto_ptr<RawFrameHandler> m_raw_frame_handler;
     // the descriptor to read/write to.
     class ola::io::ConnectedDescriptor *m_descriptor;
     SequenceNumber<uint32_t> m_sequence;
@@ -149,17 +226,53 @@ class RpcChannel {
     unsigned int m_buffer_size;  // size of the buffer
     unsigned int m_expected_size;  // the total size of the current msg
     unsigned int m_current_size;  // the amount of data read for the current msg
+    bool m_raw_frame;  // true if the current msg is a raw frame
     HASH_NAMESPACE::HASH_MAP_CLASS<int, class OutstandingRequest*> m_requests;
     ResponseMap m_responses;
     ExportMap *m_export_map;
-    UIntMap *m_recv_type_map;
+
+    enum ReceivedType {
+      RECEIVED_RAW,
+      RECEIVED_REQUEST,
+      RECEIVED_RESPONSE,
+      RECEIVED_CANCELLED,
+      RECEIVED_FAILED,
+      RECEIVED_NOT_IMPLEMENTED,
+      RECEIVED_STREAM_REQUEST,
+      RECEIVED_TYPE_COUNT
+    };
+
+    // The stats are resolved once, since they're updated for every message.
+    // These are NULL if there is no export map.
+    CounterVariable *m_received_var;
+    CounterVariable *m_sent_var;
+    CounterVariable *m_sent_error_var;
+    unsigned int *m_received_types[RECEIVED_TYPE_COUNT];
+    // Reused when sending pre-serialized requests.
+    std::vector<uint8_t> m_envelope;
+    std::vector<ola::io::IOVec> m_send_iov;
+    // Messages held back while the channel is corked.
+    unsigned int m_cork_depth;
+    std::vector<uint8_t> m_cork_buffer;
+    unsigned int m_corked_messages;
 
     bool SendMsg(RpcMessage *msg);
+    bool SendRequest(bool is_streaming,
+                     uint32_t id,
+                     const std::string &name,
+                     const ola::io::IOVec *request,
+                     int iocnt);
+    bool SendIOVec(const ola::io::IOVec *iov, int iocnt, unsigned int length);
+    bool WriteIOVec(const ola::io::IOVec *iov, int iocnt, unsigned int length);
+    bool FlushCorkBuffer();
     int AllocateMsgBuffer(unsigned int size);
+    bool ReadMessage();
     int ReadHeader(unsigned int *version, unsigned int *size) const;
     bool HandleNewMsg(uint8_t *buffer, unsigned int size);
+    void HandleRawFrame(const uint8_t *buffer, unsigned int size);
     void HandleRequest(RpcMessage *msg);
     void HandleStreamRequest(RpcMessage *msg);
+    bool HandleRawStreamRequest(const uint8_t *data, unsigned int size);
 
     // server end
     void SendRequestFailed(class OutstandingRequest *request);
@@ -173,15 +286,19 @@ class RpcChannel {
     void HandleNotImplemented(RpcMessage *msg);
 
     void HandleChannelClose();
+    void CountReceived(ReceivedType type);
 
     static const char K_RPC_RECEIVED_TYPE_VAR[];
     static const char K_RPC_RECEIVED_VAR[];
     static const char K_RPC_SENT_ERROR_VAR[];
     static const char K_RPC_SENT_VAR[];
-    static const char *K_RPC_VARIABLES[];
+    static const char *K_RECEIVED_TYPE_NAMES[];
     static const char STREAMING_NO_RESPONSE[];
     static const unsigned int INITIAL_BUFFER_SIZE = 1 << 11;  // 2k
     static const unsigned int MAX_BUFFER_SIZE = 1 << 20;  // 1M
+    // The corked messages are flushed early if they'd take the buffer past
+    // this size.
+    static const unsigned int MAX_CORK_SIZE = 1 << 16;  // 64k
 };
 }  // namespace rpc
 }  // namespace ola
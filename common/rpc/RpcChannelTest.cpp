@@ -18,6 +18,7 @@
  * Copyright (C) 2005 Simon Newton
  */
 
+#include <string.h>
 #include <cppunit/extensions/HelperMacros.h>
 #include <google/protobuf/stubs/common.h>
 #include <memory>
@@ -25,16 +26,21 @@
 
 #include "common/rpc/RpcChannel.h"
 #include "common/rpc/RpcController.h"
+#include "common/rpc/RpcSession.h"
 #include "common/rpc/TestService.h"
 #include "common/rpc/TestService.pb.h"
 #include "common/rpc/TestServiceService.pb.h"
 #include "ola/Callback.h"
+#include "ola/ExportMap.h"
+#include "ola/io/IOVecInterface.h"
 #include "ola/io/SelectServer.h"
 #include "ola/network/Socket.h"
 #include "ola/testing/TestUtils.h"
 
 
+using ola::ExportMap;
 using ola::NewSingleCallback;
+using ola::io::IOVec;
 using ola::io::LoopbackDescriptor;
 using ola::io::SelectServer;
 using ola::rpc::EchoReply;
@@ -53,6 +59,10 @@ class RpcChannelTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testEcho);
   CPPUNIT_TEST(testFailedEcho);
   CPPUNIT_TEST(testStreamRequest);
+  CPPUNIT_TEST(testIOVecRequest);
+  CPPUNIT_TEST(testRawStreamRequest);
+  CPPUNIT_TEST(testRawFrame);
+  CPPUNIT_TEST(testCork);
   CPPUNIT_TEST_SUITE_END();
 
  public:
@@ -61,7 +71,14 @@ class RpcChannelTest: public CppUnit::TestFixture {
   void testEcho();
   void testFailedEcho();
   void testStreamRequest();
+  void testIOVecRequest();
+  void testRawStreamRequest();
+  void testRawFrame();
+  void testCork();
   void EchoComplete();
+  void RawFrameReceived(ola::rpc::RpcSession *session,
+                        const uint8_t *data,
+                        unsigned int size);
   void FailedEchoComplete();
 
  private:
@@ -69,6 +86,8 @@ class RpcChannelTest: public CppUnit::TestFixture {
   EchoRequest m_request;
   EchoReply m_reply;
   SelectServer m_ss;
+  ExportMap m_export_map;
+  string m_raw_frame;
 
   auto_ptr<TestServiceImpl> m_service;
   auto_ptr<RpcChannel> m_channel;
@@ -84,7 +103,8 @@ void RpcChannelTest::setUp() {
   m_socket->Init();
 
   m_service.reset(new TestServiceImpl(&m_ss));
-  m_channel.reset(new RpcChannel(m_service.get(), m_socket.get()));
+  m_channel.reset(new RpcChannel(m_service.get(), m_socket.get(),
+                                 &m_export_map));
   m_ss.AddReadDescriptor(m_socket.get());
   m_stub.reset(new TestService_Stub(m_channel.get()));
 }
@@ -99,6 +119,14 @@ void RpcChannelTest::EchoComplete() {
   OLA_ASSERT_EQ(m_reply.data(), m_request.data());
 }
 
+void RpcChannelTest::RawFrameReceived(ola::rpc::RpcSession *session,
+                                      const uint8_t *data,
+                                      unsigned int size) {
+  OLA_ASSERT_EQ(m_channel->Session(), session);
+  m_raw_frame.assign(reinterpret_cast<const char*>(data), size);
+  m_ss.Terminate();
+}
+
 void RpcChannelTest::FailedEchoComplete() {
   m_ss.Terminate();
   OLA_ASSERT_TRUE(m_controller.Failed());
@@ -139,3 +167,100 @@ void RpcChannelTest::testStreamRequest() {
   m_stub->Stream(NULL, &m_request, NULL, NULL);
   m_ss.Run();
 }
+
+
+/*
+ * Check that pre-serialized requests work
+ */
+void RpcChannelTest::testIOVecRequest() {
+  m_request.set_data("foo");
+  m_request.set_session_ptr(0);
+  string serialized;
+  m_request.SerializeToString(&serialized);
+
+  // split the request across two IOVecs
+  IOVec iov[2];
+  iov[0].iov_base = const_cast<char*>(serialized.data());
+  iov[0].iov_len = 2;
+  iov[1].iov_base = const_cast<char*>(serialized.data() + 2);
+  iov[1].iov_len = serialized.size() - 2;
+
+  m_channel->CallMethod(
+      TestService::descriptor()->FindMethodByName("Echo"),
+      &m_controller,
+      iov,
+      2,
+      &m_reply,
+      NewSingleCallback(this, &RpcChannelTest::EchoComplete));
+  m_ss.Run();
+}
+
+/*
+ * Check that a service can handle stream requests without them being parsed.
+ */
+void RpcChannelTest::testRawStreamRequest() {
+  m_service->HandleRawStreams(true);
+  m_request.set_data("foo");
+  m_stub->Stream(NULL, &m_request, NULL, NULL);
+  m_ss.Run();
+  OLA_ASSERT_EQ(1u, m_service->RawStreamRequests());
+}
+
+/*
+ * Check raw frames are passed to the handler, and that RPCs still work
+ * afterwards.
+ */
+void RpcChannelTest::testRawFrame() {
+  m_channel->SetRawFrameHandler(
+      ola::NewCallback(this, &RpcChannelTest::RawFrameReceived));
+
+  const char part1[] = "foo";
+  const char part2[] = "bar";
+  IOVec iov[2];
+  iov[0].iov_base = const_cast<char*>(part1);
+  iov[0].iov_len = strlen(part1);
+  iov[1].iov_base = const_cast<char*>(part2);
+  iov[1].iov_len = strlen(part2);
+  OLA_ASSERT_TRUE(m_channel->SendRawFrame(iov, 2));
+  m_ss.Run();
+  OLA_ASSERT_EQ(string("foobar"), m_raw_frame);
+
+  testEcho();
+}
+
+/*
+ * Check that messages sent while the channel is corked are held back until
+ * it's uncorked.
+ */
+void RpcChannelTest::testCork() {
+  m_service->HandleRawStreams(true);
+  m_request.set_data("foo");
+
+  ola::CounterVariable *sent = m_export_map.GetCounterVar("rpc-sent");
+  unsigned int sent_before = sent->Get();
+
+  m_channel->Cork();
+  m_channel->Cork();
+  m_stub->Stream(NULL, &m_request, NULL, NULL);
+  m_stub->Stream(NULL, &m_request, NULL, NULL);
+  OLA_ASSERT_EQ(0, m_socket->DataRemaining());
+  OLA_ASSERT_TRUE(m_channel->Uncork());
+  OLA_ASSERT_EQ(0, m_socket->DataRemaining());
+  // Messages are only counted once they're written.
+  OLA_ASSERT_EQ(sent_before, sent->Get());
+  OLA_ASSERT_TRUE(m_channel->Uncork());
+  OLA_ASSERT_TRUE(m_socket->DataRemaining() > 0);
+  OLA_ASSERT_EQ(sent_before + 2, sent->Get());
+
+  // Each message terminates the SelectServer.
+  m_ss.Run();
+  m_ss.Run();
+  OLA_ASSERT_EQ(2u, m_service->RawStreamRequests());
+  OLA_ASSERT_EQ(0, m_socket->DataRemaining());
+
+  // Uncorked channels send straight away.
+  m_stub->Stream(NULL, &m_request, NULL, NULL);
+  OLA_ASSERT_TRUE(m_socket->DataRemaining() > 0);
+  m_ss.Run();
+  OLA_ASSERT_EQ(3u, m_service->RawStreamRequests());
+}
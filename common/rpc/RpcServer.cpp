@@ -142,6 +142,8 @@ bool RpcServer::AddClient(ConnectedDescriptor *descriptor) {
     (*m_options.export_map->GetIntegerVar(K_CLIENT_VAR))++;
   }
 
+  // RpcChannel::DescriptorReady() handles every message that has arrived.
+  descriptor->SetDrainsOnRead(true);
   m_ss->AddReadDescriptor(descriptor);
   m_connected_sockets.insert(descriptor);
 
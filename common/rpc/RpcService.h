@@ -23,6 +23,7 @@
 #ifndef COMMON_RPC_RPCSERVICE_H_
 #define COMMON_RPC_RPCSERVICE_H_
 
+#include <stdint.h>
 #include <google/protobuf/service.h>
 #include <string>
 #include "ola/Callback.h"
@@ -53,6 +54,17 @@ class RpcService {
         const google::protobuf::MethodDescriptor *method) const = 0;
     virtual const google::protobuf::Message& GetResponsePrototype(
         const google::protobuf::MethodDescriptor *method) const = 0;
+
+    // Handle a streaming request directly from the serialized message. The
+    // data is only valid for the duration of the call. Return false to have
+    // the request parsed and passed to CallMethod() instead.
+    virtual bool HandleRawStreamRequest(
+        const google::protobuf::MethodDescriptor*,
+        RpcController*,
+        const uint8_t*,
+        unsigned int) {
+      return false;
+    }
 };
 }  // namespace rpc
 }  // namespace ola
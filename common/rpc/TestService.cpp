@@ -76,6 +76,25 @@ void TestServiceImpl::Stream(RpcController* controller,
   m_ss->Terminate();
 }
 
+bool TestServiceImpl::HandleRawStreamRequest(
+    const google::protobuf::MethodDescriptor *method,
+    RpcController *controller,
+    const uint8_t *data,
+    unsigned int size) {
+  if (!m_handle_raw_streams) {
+    return false;
+  }
+
+  OLA_ASSERT_NOT_NULL(controller);
+  OLA_ASSERT_EQ(string("Stream"), method->name());
+  EchoRequest request;
+  OLA_ASSERT_TRUE(request.ParseFromArray(data, size));
+  OLA_ASSERT_EQ(string(TestClient::kTestData), request.data());
+  m_raw_stream_requests++;
+  m_ss->Terminate();
+  return true;
+}
+
 
 TestClient::TestClient(SelectServer *ss,
                        const GenericSocketAddress &server_addr)
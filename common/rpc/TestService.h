@@ -31,7 +31,11 @@
 
 class TestServiceImpl: public ola::rpc::TestService {
  public:
-  explicit TestServiceImpl(ola::io::SelectServer *ss) : m_ss(ss) {}
+  explicit TestServiceImpl(ola::io::SelectServer *ss)
+      : m_ss(ss),
+        m_handle_raw_streams(false),
+        m_raw_stream_requests(0) {
+  }
   ~TestServiceImpl() {}
 
   void Echo(ola::rpc::RpcController* controller,
@@ -48,8 +52,19 @@ class TestServiceImpl: public ola::rpc::TestService {
               const ola::rpc::EchoRequest* request,
               ola::rpc::STREAMING_NO_RESPONSE* response,
               CompletionCallback* done);
+
+  bool HandleRawStreamRequest(const google::protobuf::MethodDescriptor *method,
+                              ola::rpc::RpcController *controller,
+                              const uint8_t *data,
+                              unsigned int size);
+
+  void HandleRawStreams(bool handle) { m_handle_raw_streams = handle; }
+  unsigned int RawStreamRequests() const { return m_raw_stream_requests; }
+
  private:
   ola::io::SelectServer *m_ss;
+  bool m_handle_raw_streams;
+  unsigned int m_raw_stream_requests;
 };
 
 
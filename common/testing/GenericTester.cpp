@@ -39,6 +39,10 @@ using std::string;
 DECLARE_bool(use_epoll);
 #endif  // HAVE_EPOLL
 
+#ifdef HAVE_IO_URING
+DECLARE_bool(use_io_uring);
+#endif  // HAVE_IO_URING
+
 #ifdef HAVE_KQUEUE
 DECLARE_bool(use_kqueue);
 #endif  // HAVE_KQUEUE
@@ -60,6 +64,10 @@ int main(int argc, char* argv[]) {
   FLAGS_use_epoll = GetBoolEnvVar("OLA_USE_EPOLL");
 #endif  // HAVE_EPOLL
 
+#ifdef HAVE_IO_URING
+  FLAGS_use_io_uring = GetBoolEnvVar("OLA_USE_IO_URING");
+#endif  // HAVE_IO_URING
+
 #ifdef HAVE_KQUEUE
   FLAGS_use_kqueue = GetBoolEnvVar("OLA_USE_KQUEUE");
 #endif  // HAVE_KQUEUE
@@ -52,7 +52,8 @@ MockUDPSocket::MockUDPSocket()
       m_broadcast_set(false),
       m_port(0),
       m_tos(0),
-      m_discard_mode(false) {
+      m_discard_mode(false),
+      m_send_many_count(0) {
 }
 
 
@@ -122,6 +123,22 @@ ssize_t MockUDPSocket::SendTo(const uint8_t *buffer,
 }
 
 
+unsigned int MockUDPSocket::SendMany(
+    const ola::network::OutgoingDatagram *datagrams,
+    unsigned int count) const {
+  m_send_many_count++;
+  unsigned int sent = 0;
+  for (unsigned int i = 0; i < count; i++) {
+    if (SendTo(datagrams[i].data, datagrams[i].size,
+               datagrams[i].destination) ==
+        static_cast<ssize_t>(datagrams[i].size)) {
+      sent++;
+    }
+  }
+  return sent;
+}
+
+
 ssize_t MockUDPSocket::SendTo(IOVecInterface *data,
                               const ola::network::IPV4Address &ip_address,
                               unsigned short port) const {
@@ -206,6 +223,31 @@ bool MockUDPSocket::RecvFrom(
 }
 
 
+unsigned int MockUDPSocket::RecvMany(
+    ola::network::IncomingDatagram *datagrams,
+    unsigned int count) {
+  unsigned int received = 0;
+  while (received < count && !m_received_data.empty()) {
+    ola::network::IncomingDatagram &datagram = datagrams[received];
+    const received_data &new_data = m_received_data.front();
+
+    // Like recvmmsg(), datagrams larger than the buffer are truncated.
+    unsigned int size = std::min(new_data.size, datagram.capacity);
+    memcpy(datagram.data, new_data.data, size);
+    datagram.size = size;
+    datagram.truncated = new_data.size > datagram.capacity;
+    datagram.source = IPV4SocketAddress(new_data.address, new_data.port);
+
+    if (new_data.free_data) {
+      delete[] new_data.data;
+    }
+    m_received_data.pop();
+    received++;
+  }
+  return received;
+}
+
+
 bool MockUDPSocket::EnableBroadcast() {
   m_broadcast_set = true;
   return true;
@@ -29,6 +29,7 @@
 #include <ola/Clock.h>
 #include <stdint.h>
 #include <sys/time.h>
+#include <time.h>
 
 #if HAVE_CONFIG_H
 #include <config.h>
@@ -257,6 +258,20 @@ void Clock::CurrentTime(TimeStamp *timestamp) const {
   *timestamp = tv;
 }
 
+void Clock::CurrentMonotonicTime(TimeStamp *timestamp) const {
+#if defined(HAVE_CLOCK_GETTIME) && defined(CLOCK_MONOTONIC)
+  struct timespec ts;
+  if (clock_gettime(CLOCK_MONOTONIC, &ts) == 0) {
+    struct timeval tv;
+    tv.tv_sec = ts.tv_sec;
+    tv.tv_usec = ts.tv_nsec / 1000;
+    *timestamp = tv;
+    return;
+  }
+#endif  // HAVE_CLOCK_GETTIME
+  CurrentTime(timestamp);
+}
+
 void MockClock::AdvanceTime(const TimeInterval &interval) {
   m_offset += interval;
 }
@@ -272,4 +287,8 @@ void MockClock::CurrentTime(TimeStamp *timestamp) const {
   *timestamp = tv;
   *timestamp += m_offset;
 }
+
+void MockClock::CurrentMonotonicTime(TimeStamp *timestamp) const {
+  CurrentTime(timestamp);
+}
 }  // namespace ola
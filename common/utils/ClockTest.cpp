@@ -160,6 +160,11 @@ void ClockTest::testClock() {
   TimeStamp second;
   clock.CurrentTime(&second);
   OLA_ASSERT_LT(first, second);
+
+  TimeStamp monotonic_first, monotonic_second;
+  clock.CurrentMonotonicTime(&monotonic_first);
+  clock.CurrentMonotonicTime(&monotonic_second);
+  OLA_ASSERT_TRUE(monotonic_first <= monotonic_second);
 }
 
 
@@ -187,4 +192,9 @@ void ClockTest::testMockClock() {
   clock.CurrentTime(&third);
   OLA_ASSERT_LT(second, third);
   OLA_ASSERT_TRUE(ten_point_five_seconds <= (third - second));
+
+  // The monotonic time moves with the mock time.
+  TimeStamp monotonic;
+  clock.CurrentMonotonicTime(&monotonic);
+  OLA_ASSERT_TRUE(third <= monotonic);
 }
@@ -36,6 +36,7 @@
 #include "ola/DmxBuffer.h"
 #include "ola/Logging.h"
 #include "ola/StringUtils.h"
+#include "ola/dmx/HTPMerge.h"
 
 namespace ola {
 
@@ -134,6 +135,65 @@ bool DmxBuffer::HTPMerge(const DmxBuffer &other) {
 }
 
 
+bool DmxBuffer::SetFromHTPMerge(const DmxBuffer *const *sources,
+                                unsigned int source_count) {
+  if (m_copy_on_write)
+    CleanupMemory();
+  if (!m_data) {
+    if (!Init())
+      return false;
+  }
+
+  unsigned int min_length = DMX_UNIVERSE_SIZE;
+  unsigned int max_length = 0;
+  for (unsigned int i = 0; i < source_count; i++) {
+    if (sources[i]->m_data && sources[i]->m_length) {
+      min_length = min(min_length, sources[i]->m_length);
+      max_length = max(max_length, sources[i]->m_length);
+    }
+  }
+
+  if (!max_length) {
+    m_length = 0;
+    return true;
+  }
+
+  // All sources have at least min_length slots, so merge those in as few
+  // passes as possible. After the first pass the output is fed back in as
+  // one of the sources.
+  const uint8_t *slots[MAX_SOURCES_PER_PASS];
+  unsigned int slot_count = 0;
+  for (unsigned int i = 0; i < source_count; i++) {
+    if (!sources[i]->m_data || !sources[i]->m_length) {
+      continue;
+    }
+    if (slot_count == MAX_SOURCES_PER_PASS) {
+      ola::dmx::HTPMergeSlots(slots, slot_count, min_length, m_data);
+      slots[0] = m_data;
+      slot_count = 1;
+    }
+    slots[slot_count++] = sources[i]->m_data;
+  }
+  ola::dmx::HTPMergeSlots(slots, slot_count, min_length, m_data);
+
+  // Then take care of any sources that are longer than the others.
+  if (max_length > min_length) {
+    memset(m_data + min_length, DMX_MIN_SLOT_VALUE, max_length - min_length);
+    for (unsigned int i = 0; i < source_count; i++) {
+      const DmxBuffer *source = sources[i];
+      if (!source->m_data) {
+        continue;
+      }
+      for (unsigned int j = min_length; j < source->m_length; j++) {
+        m_data[j] = max(m_data[j], source->m_data[j]);
+      }
+    }
+  }
+  m_length = max_length;
+  return true;
+}
+
+
 bool DmxBuffer::Set(const uint8_t *data, unsigned int length) {
   if (!data)
     return false;
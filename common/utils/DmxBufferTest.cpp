@@ -38,6 +38,7 @@ class DmxBufferTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testAssign);
   CPPUNIT_TEST(testCopy);
   CPPUNIT_TEST(testMerge);
+  CPPUNIT_TEST(testMultiMerge);
   CPPUNIT_TEST(testStringToDmx);
   CPPUNIT_TEST(testCopyOnWrite);
   CPPUNIT_TEST(testSetRange);
@@ -53,6 +54,7 @@ class DmxBufferTest: public CppUnit::TestFixture {
     void testStringGetSet();
     void testCopy();
     void testMerge();
+    void testMultiMerge();
     void testStringToDmx();
     void testCopyOnWrite();
     void testSetRange();
@@ -286,6 +288,64 @@ void DmxBufferTest::testMerge() {
 }
 
 
+/*
+ * Check that merging many buffers in one pass works
+ */
+void DmxBufferTest::testMultiMerge() {
+  DmxBuffer buffer1(TEST_DATA, sizeof(TEST_DATA));
+  DmxBuffer buffer2(TEST_DATA2, sizeof(TEST_DATA2));
+  DmxBuffer buffer3(TEST_DATA3, sizeof(TEST_DATA3));
+  DmxBuffer merge_result(MERGE_RESULT, sizeof(MERGE_RESULT));
+  DmxBuffer merge_result2(MERGE_RESULT2, sizeof(MERGE_RESULT2));
+  DmxBuffer uninitialized_buffer, output;
+
+  // no sources
+  OLA_ASSERT_TRUE(output.SetFromHTPMerge(NULL, 0));
+  OLA_ASSERT_EQ(0u, output.Size());
+
+  // empty sources are skipped
+  const DmxBuffer *sources[] = {&uninitialized_buffer, &buffer1};
+  OLA_ASSERT_TRUE(output.SetFromHTPMerge(sources, 2));
+  OLA_ASSERT_DMX_EQUALS(buffer1, output);
+
+  const DmxBuffer *sources2[] = {&buffer1, &buffer3};
+  OLA_ASSERT_TRUE(output.SetFromHTPMerge(sources2, 2));
+  OLA_ASSERT_DMX_EQUALS(merge_result, output);
+
+  // three sources of different lengths, the output takes the longest
+  const DmxBuffer *sources3[] = {&buffer1, &buffer2, &buffer3};
+  OLA_ASSERT_TRUE(output.SetFromHTPMerge(sources3, 3));
+  OLA_ASSERT_DMX_EQUALS(merge_result2, output);
+
+  // the output shares data with one of the sources
+  output = buffer1;
+  OLA_ASSERT_TRUE(output.SetFromHTPMerge(sources2, 2));
+  OLA_ASSERT_DMX_EQUALS(merge_result, output);
+  OLA_ASSERT_DMX_EQUALS(DmxBuffer(TEST_DATA, sizeof(TEST_DATA)), buffer1);
+
+  // more sources than fit in a single pass, the highest value is in the last
+  // source.
+  const unsigned int SOURCE_COUNT = 70;
+  DmxBuffer full_buffers[SOURCE_COUNT];
+  const DmxBuffer *full_sources[SOURCE_COUNT];
+  for (unsigned int i = 0; i < SOURCE_COUNT; i++) {
+    full_buffers[i].Blackout();
+    full_buffers[i].SetChannel(i, i + 1);
+    full_buffers[i].SetChannel(ola::DMX_UNIVERSE_SIZE - 1, i);
+    full_sources[i] = &full_buffers[i];
+  }
+  OLA_ASSERT_TRUE(output.SetFromHTPMerge(full_sources, SOURCE_COUNT));
+  OLA_ASSERT_EQ(static_cast<unsigned int>(ola::DMX_UNIVERSE_SIZE),
+                output.Size());
+  for (unsigned int i = 0; i < SOURCE_COUNT; i++) {
+    OLA_ASSERT_EQ(static_cast<uint8_t>(i + 1), output.Get(i));
+  }
+  OLA_ASSERT_EQ(static_cast<uint8_t>(0), output.Get(SOURCE_COUNT));
+  OLA_ASSERT_EQ(static_cast<uint8_t>(SOURCE_COUNT - 1),
+                output.Get(ola::DMX_UNIVERSE_SIZE - 1));
+}
+
+
 /*
  * Run the StringToDmxTest
  * @param input the string to parse
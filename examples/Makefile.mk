@@ -72,6 +72,7 @@ examples_ola_rdm_discover_LDADD = $(EXAMPLE_COMMON_LIBS)
 
 examples_ola_recorder_SOURCES = \
     examples/ola-recorder.cpp \
+    examples/ShowFormat.h \
     examples/ShowLoader.h \
     examples/ShowLoader.cpp \
     examples/ShowPlayer.h \
@@ -135,11 +136,38 @@ EXTRA_DIST += \
 
 # TESTS
 ##################################################
+test_programs += examples/ShowLoaderTester \
+                 examples/ShowPlayerTester
+
+examples_ShowLoaderTester_SOURCES = \
+    examples/ShowLoaderTest.cpp \
+    examples/ShowFormat.h \
+    examples/ShowLoader.h \
+    examples/ShowLoader.cpp \
+    examples/ShowSaver.h \
+    examples/ShowSaver.cpp
+examples_ShowLoaderTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
+examples_ShowLoaderTester_LDADD = $(COMMON_TESTING_LIBS)
+
+examples_ShowPlayerTester_SOURCES = \
+    examples/ShowPlayerTest.cpp \
+    examples/ShowFormat.h \
+    examples/ShowLoader.h \
+    examples/ShowLoader.cpp \
+    examples/ShowPlayer.h \
+    examples/ShowPlayer.cpp
+examples_ShowPlayerTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
+examples_ShowPlayerTester_LDADD = $(COMMON_TESTING_LIBS) \
+                                  $(EXAMPLE_COMMON_LIBS)
+
 test_scripts += examples/RecorderVerifyTest.sh
 
 examples/RecorderVerifyTest.sh: examples/Makefile.mk
-	echo "for FILE in ${srcdir}/examples/testdata/dos_line_endings ${srcdir}/examples/testdata/multiple_unis ${srcdir}/examples/testdata/partial_frames ${srcdir}/examples/testdata/single_uni ${srcdir}/examples/testdata/trailing_timeout; do echo \"Checking \$$FILE\"; ${top_builddir}/examples/ola_recorder${EXEEXT} --verify \$$FILE; STATUS=\$$?; if [ \$$STATUS -ne 0 ]; then echo \"FAIL: \$$FILE caused ola_recorder to exit with status \$$STATUS\"; exit \$$STATUS; fi; done; exit 0" > examples/RecorderVerifyTest.sh
+	echo "for FILE in ${srcdir}/examples/testdata/dos_line_endings ${srcdir}/examples/testdata/multiple_unis ${srcdir}/examples/testdata/partial_frames ${srcdir}/examples/testdata/single_uni ${srcdir}/examples/testdata/trailing_timeout; do echo \"Checking \$$FILE\"; ${top_builddir}/examples/ola_recorder${EXEEXT} --verify \$$FILE; STATUS=\$$?; if [ \$$STATUS -ne 0 ]; then echo \"FAIL: \$$FILE caused ola_recorder to exit with status \$$STATUS\"; exit \$$STATUS; fi; ${top_builddir}/examples/ola_recorder${EXEEXT} --convert \$$FILE --record examples/RecorderVerifyTest.show && ${top_builddir}/examples/ola_recorder${EXEEXT} --verify examples/RecorderVerifyTest.show; STATUS=\$$?; if [ \$$STATUS -ne 0 ]; then echo \"FAIL: binary copy of \$$FILE caused ola_recorder to exit with status \$$STATUS\"; exit \$$STATUS; fi; ${top_builddir}/examples/ola_recorder${EXEEXT} --convert \$$FILE --format text --record examples/RecorderVerifyTest.txt && ${top_builddir}/examples/ola_recorder${EXEEXT} --convert examples/RecorderVerifyTest.show --format text --record examples/RecorderVerifyTest.roundtrip && diff examples/RecorderVerifyTest.txt examples/RecorderVerifyTest.roundtrip > /dev/null; STATUS=\$$?; if [ \$$STATUS -ne 0 ]; then echo \"FAIL: \$$FILE changed when converted to binary and back\"; exit \$$STATUS; fi; done; exit 0" > examples/RecorderVerifyTest.sh
 	chmod +x examples/RecorderVerifyTest.sh
 
-CLEANFILES += examples/RecorderVerifyTest.sh
+CLEANFILES += examples/RecorderVerifyTest.sh \
+              examples/RecorderVerifyTest.show \
+              examples/RecorderVerifyTest.txt \
+              examples/RecorderVerifyTest.roundtrip
 endif
@@ -0,0 +1,97 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ShowFormat.h
+ * The layout of binary show files.
+ * Copyright (C) 2026 Simon Newton
+ *
+ * A binary show file starts with a header line, "OLA Binary Show", followed
+ * by a 16 bit version and 16 reserved bits. Then comes a series of records,
+ * each of which is:
+ *   type (8 bits)
+ *   time in ms since the first frame (32 bits)
+ *   universe (32 bits)
+ *   number of slots in the frame (16 bits)
+ *   length of the payload (16 bits)
+ *   payload
+ *
+ * A KEYFRAME record carries all the slots of the frame. A DELTA record
+ * carries the slots that changed since the previous frame for the universe,
+ * as a series of runs, each of which is a 16 bit offset, a 16 bit length and
+ * the slot data. A SNAPSHOT record is the same as a KEYFRAME, but isn't a
+ * new frame; every SNAPSHOT_INTERVAL there's a block of them holding the
+ * state of every universe, so playback can start from there.
+ *
+ * When the file is closed, an index of the snapshot blocks, each entry a 32
+ * bit time and a 64 bit file offset, is appended, followed by a trailer
+ * holding the 64 bit offset of the index, the 32 bit number of entries and
+ * INDEX_MAGIC. If the trailer is missing, say because the recording was
+ * interrupted, the index is rebuilt by scanning the file.
+ *
+ * All values are little endian.
+ */
+
+#ifndef EXAMPLES_SHOWFORMAT_H_
+#define EXAMPLES_SHOWFORMAT_H_
+
+#include <stdint.h>
+
+class BinaryShowFormat {
+ public:
+  typedef enum {
+    KEYFRAME = 1,
+    DELTA = 2,
+    SNAPSHOT = 3,
+  } RecordType;
+
+  static const uint16_t VERSION = 1;
+  // The header line plus the version and reserved fields.
+  static const unsigned int FILE_HEADER_SIZE = 20;
+  static const unsigned int RECORD_HEADER_SIZE = 13;
+  static const unsigned int RUN_HEADER_SIZE = 4;
+  static const unsigned int INDEX_ENTRY_SIZE = 12;
+  static const unsigned int TRAILER_SIZE = 16;
+  static const uint32_t INDEX_MAGIC = 0x5844494f;  // "OIDX"
+  // in ms
+  static const unsigned int SNAPSHOT_INTERVAL = 1000;
+
+  static void PutUInt16(uint8_t *ptr, uint16_t value) {
+    ptr[0] = static_cast<uint8_t>(value);
+    ptr[1] = static_cast<uint8_t>(value >> 8);
+  }
+
+  static void PutUInt32(uint8_t *ptr, uint32_t value) {
+    PutUInt16(ptr, static_cast<uint16_t>(value));
+    PutUInt16(ptr + 2, static_cast<uint16_t>(value >> 16));
+  }
+
+  static void PutUInt64(uint8_t *ptr, uint64_t value) {
+    PutUInt32(ptr, static_cast<uint32_t>(value));
+    PutUInt32(ptr + 4, static_cast<uint32_t>(value >> 32));
+  }
+
+  static uint16_t GetUInt16(const uint8_t *ptr) {
+    return static_cast<uint16_t>(ptr[0] | (ptr[1] << 8));
+  }
+
+  static uint32_t GetUInt32(const uint8_t *ptr) {
+    return GetUInt16(ptr) | (static_cast<uint32_t>(GetUInt16(ptr + 2)) << 16);
+  }
+
+  static uint64_t GetUInt64(const uint8_t *ptr) {
+    return GetUInt32(ptr) | (static_cast<uint64_t>(GetUInt32(ptr + 4)) << 32);
+  }
+};
+#endif  // EXAMPLES_SHOWFORMAT_H_
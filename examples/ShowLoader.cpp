@@ -21,20 +21,35 @@
  * universe-number channel1,channel2,channel3
  * delay-in-ms
  * universe-number channel1,channel2,channel3
+ *
+ * or the binary format described in ShowFormat.h.
  */
 
 #include <errno.h>
+#include <fcntl.h>
 #include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif  // _WIN32
+#include <ola/Constants.h>
 #include <ola/DmxBuffer.h>
 #include <ola/Logging.h>
 #include <ola/StringUtils.h>
+#include <ola/stl/STLUtils.h>
+#include <algorithm>
 #include <fstream>
 #include <ios>
 #include <iostream>
+#include <iterator>
 #include <sstream>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "examples/ShowFormat.h"
 #include "examples/ShowLoader.h"
 
 using std::vector;
@@ -43,10 +58,28 @@ using ola::DmxBuffer;
 
 
 const char ShowLoader::OLA_SHOW_HEADER[] = "OLA Show";
+const char ShowLoader::OLA_BINARY_SHOW_HEADER[] = "OLA Binary Show";
+
+namespace {
+bool IndexEntryBefore(const std::pair<unsigned int, uint64_t> &entry,
+                      unsigned int time) {
+  return entry.first < time;
+}
+}  // namespace
 
 ShowLoader::ShowLoader(const string &filename)
     : m_filename(filename),
-      m_line(0) {
+      m_line(0),
+      m_binary(false),
+      m_text_time(0),
+      m_text_state(OK),
+      m_data(NULL),
+      m_size(0),
+      m_data_end(0),
+      m_offset(0),
+      m_position(0),
+      m_end_time(0),
+      m_next_state(END_OF_FILE) {
 }
 
 
@@ -54,6 +87,7 @@ ShowLoader::~ShowLoader() {
   if (m_show_file.is_open()) {
     m_show_file.close();
   }
+  UnmapFile();
 }
 
 
@@ -70,11 +104,18 @@ bool ShowLoader::Load() {
 
   string line;
   ReadLine(&line);
+  if (line == OLA_BINARY_SHOW_HEADER) {
+    m_show_file.close();
+    m_binary = true;
+    return LoadBinary();
+  }
+
   if (line != OLA_SHOW_HEADER) {
     OLA_WARN << "Invalid show file, expecting " << OLA_SHOW_HEADER << " got "
              << line;
     return false;
   }
+  Reset();
   return true;
 }
 
@@ -83,11 +124,54 @@ bool ShowLoader::Load() {
  * Reset to the start of the show
  */
 void ShowLoader::Reset() {
-  m_show_file.clear();
-  m_show_file.seekg(0, std::ios::beg);
-  // skip over the first line
-  string line;
-  ReadLine(&line);
+  Seek(0);
+}
+
+
+bool ShowLoader::Seek(unsigned int offset) {
+  m_pending.clear();
+  if (m_binary) {
+    // Start from the last snapshot before the offset. Frames with the same
+    // time as a snapshot may have been written before it.
+    m_universe_data.clear();
+    m_offset = BinaryShowFormat::FILE_HEADER_SIZE;
+    Index::const_iterator iter = std::lower_bound(
+        m_index.begin(), m_index.end(), offset, IndexEntryBefore);
+    if (iter != m_index.begin()) {
+      m_offset = (--iter)->second;
+    }
+  } else {
+    m_show_file.clear();
+    m_show_file.seekg(0, std::ios::beg);
+    m_line = 0;
+    // skip over the first line
+    string line;
+    ReadLine(&line);
+    m_text_time = 0;
+    m_text_state = OK;
+  }
+
+  UniverseMap universes;
+  bool snapshot = false;
+  m_next_state = ReadFrame(&m_next, &snapshot);
+  while (m_next_state == OK && m_next.time < offset) {
+    ola::STLReplace(&universes, m_next.universe, m_next.data);
+    m_next_state = ReadFrame(&m_next, &snapshot);
+  }
+  if (m_next_state == OK && snapshot) {
+    m_next_state = ReadPlayableFrame(&m_next);
+  }
+
+  UniverseMap::const_iterator iter = universes.begin();
+  for (; iter != universes.end(); ++iter) {
+    Frame frame;
+    frame.time = offset;
+    frame.universe = iter->first;
+    frame.data = iter->second;
+    m_pending.push_back(frame);
+  }
+  m_position = offset;
+  return m_next_state != INVALID_LINE;
 }
 
 
@@ -96,17 +180,23 @@ void ShowLoader::Reset() {
  * @param timeout a pointer to the timeout in ms
  */
 ShowLoader::State ShowLoader::NextTimeout(unsigned int *timeout) {
-  string line;
-  ReadLine(&line);
-  if (line.empty()) {
-    return END_OF_FILE;
+  if (!m_pending.empty()) {
+    // The universes after a seek are sent together.
+    *timeout = 0;
+    return OK;
   }
 
-  if (!ola::StringToInt(line, timeout, true)) {
-    OLA_WARN << "Line " << m_line << ": Invalid timeout: " << line;
-    return INVALID_LINE;
+  if (m_next_state == OK) {
+    *timeout = m_next.time > m_position ? m_next.time - m_position : 0;
+    return OK;
   }
-  return OK;
+
+  if (m_next_state == END_OF_FILE && m_end_time > m_position) {
+    // A trailing timeout.
+    *timeout = m_end_time - m_position;
+    return OK;
+  }
+  return m_next_state;
 }
 
 
@@ -117,27 +207,338 @@ ShowLoader::State ShowLoader::NextTimeout(unsigned int *timeout) {
  */
 ShowLoader::State ShowLoader::NextFrame(unsigned int *universe,
                                         DmxBuffer *data) {
+  if (!m_pending.empty()) {
+    *universe = m_pending.front().universe;
+    data->Set(m_pending.front().data);
+    m_pending.pop_front();
+    return OK;
+  }
+
+  if (m_next_state != OK) {
+    return m_next_state;
+  }
+
+  *universe = m_next.universe;
+  data->Set(m_next.data);
+  m_position = m_next.time;
+  m_next_state = ReadPlayableFrame(&m_next);
+  return OK;
+}
+
+
+bool ShowLoader::LoadBinary() {
+  if (!MapFile()) {
+    return false;
+  }
+
+  if (m_size < BinaryShowFormat::FILE_HEADER_SIZE) {
+    OLA_WARN << "Invalid show file, " << m_filename << " is too short";
+    return false;
+  }
+
+  const uint16_t version = BinaryShowFormat::GetUInt16(
+      m_data + sizeof(OLA_BINARY_SHOW_HEADER));
+  if (version != BinaryShowFormat::VERSION) {
+    OLA_WARN << "Unknown show file version " << version;
+    return false;
+  }
+
+  if (!LoadIndex()) {
+    OLA_WARN << m_filename << " has no index, the recording may not have "
+             << "finished";
+    BuildIndex();
+  }
+  Reset();
+  return true;
+}
+
+
+bool ShowLoader::MapFile() {
+#ifdef _WIN32
+  std::ifstream file(m_filename.data(), std::ios::in | std::ios::binary);
+  if (!file.is_open()) {
+    OLA_FATAL << "Can't open " << m_filename << ": " << strerror(errno);
+    return false;
+  }
+  m_file_data.assign(std::istreambuf_iterator<char>(file),
+                     std::istreambuf_iterator<char>());
+  m_size = m_file_data.size();
+  m_data = m_file_data.empty() ? NULL : &m_file_data[0];
+  return true;
+#else
+  int fd = open(m_filename.data(), O_RDONLY);
+  if (fd < 0) {
+    OLA_FATAL << "Can't open " << m_filename << ": " << strerror(errno);
+    return false;
+  }
+
+  struct stat file_stat;
+  if (fstat(fd, &file_stat)) {
+    OLA_WARN << "Failed to stat " << m_filename << ": " << strerror(errno);
+    close(fd);
+    return false;
+  }
+
+  if (file_stat.st_size == 0) {
+    close(fd);
+    return true;
+  }
+
+  void *memory = mmap(NULL, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (memory == MAP_FAILED) {
+    OLA_WARN << "Failed to map " << m_filename << ": " << strerror(errno);
+    return false;
+  }
+  m_data = static_cast<const uint8_t*>(memory);
+  m_size = file_stat.st_size;
+  return true;
+#endif  // _WIN32
+}
+
+
+void ShowLoader::UnmapFile() {
+#ifndef _WIN32
+  if (m_data) {
+    munmap(const_cast<uint8_t*>(m_data), m_size);
+  }
+#endif  // _WIN32
+  m_data = NULL;
+  m_size = 0;
+  m_file_data.clear();
+}
+
+
+/*
+ * Read the index from the end of the file.
+ */
+bool ShowLoader::LoadIndex() {
+  if (m_size < BinaryShowFormat::FILE_HEADER_SIZE +
+               BinaryShowFormat::TRAILER_SIZE) {
+    return false;
+  }
+
+  const size_t trailer_offset = m_size - BinaryShowFormat::TRAILER_SIZE;
+  const uint8_t *trailer = m_data + trailer_offset;
+  if (BinaryShowFormat::GetUInt32(trailer + 12) !=
+      BinaryShowFormat::INDEX_MAGIC) {
+    return false;
+  }
+
+  const uint64_t index_offset = BinaryShowFormat::GetUInt64(trailer);
+  const uint32_t count = BinaryShowFormat::GetUInt32(trailer + 8);
+  if (index_offset < BinaryShowFormat::FILE_HEADER_SIZE ||
+      index_offset > trailer_offset ||
+      trailer_offset - index_offset !=
+          static_cast<uint64_t>(count) * BinaryShowFormat::INDEX_ENTRY_SIZE) {
+    return false;
+  }
+
+  m_index.clear();
+  m_index.reserve(count);
+  const uint8_t *entry = m_data + index_offset;
+  for (unsigned int i = 0; i < count; i++) {
+    const uint64_t offset = BinaryShowFormat::GetUInt64(entry + 4);
+    if (offset < BinaryShowFormat::FILE_HEADER_SIZE || offset >= index_offset) {
+      m_index.clear();
+      return false;
+    }
+    m_index.push_back(
+        std::make_pair(BinaryShowFormat::GetUInt32(entry), offset));
+    entry += BinaryShowFormat::INDEX_ENTRY_SIZE;
+  }
+  m_data_end = index_offset;
+  return true;
+}
+
+
+/*
+ * Rebuild the index by walking the records. Any partial record at the end of
+ * the file is ignored.
+ */
+void ShowLoader::BuildIndex() {
+  m_index.clear();
+  m_data_end = m_size;
+  size_t offset = BinaryShowFormat::FILE_HEADER_SIZE;
+  bool in_snapshot = false;
+  unsigned int length;
+  while (CheckRecord(offset, &length)) {
+    const uint8_t *record = m_data + offset;
+    if (record[0] == BinaryShowFormat::SNAPSHOT) {
+      if (!in_snapshot) {
+        m_index.push_back(
+            std::make_pair(BinaryShowFormat::GetUInt32(record + 1), offset));
+      }
+      in_snapshot = true;
+    } else {
+      in_snapshot = false;
+    }
+    offset += BinaryShowFormat::RECORD_HEADER_SIZE + length;
+  }
+  m_data_end = offset;
+}
+
+
+/*
+ * Read the next frame, skipping over snapshots.
+ */
+ShowLoader::State ShowLoader::ReadPlayableFrame(Frame *frame) {
+  bool snapshot = false;
+  State state;
+  do {
+    state = ReadFrame(frame, &snapshot);
+  } while (state == OK && snapshot);
+  return state;
+}
+
+
+ShowLoader::State ShowLoader::ReadFrame(Frame *frame, bool *snapshot) {
+  *snapshot = false;
+  if (m_binary) {
+    return ReadBinaryRecord(frame, snapshot);
+  }
+  return ReadTextFrame(frame);
+}
+
+
+/*
+ * Read a frame line, and the timeout line that follows it.
+ */
+ShowLoader::State ShowLoader::ReadTextFrame(Frame *frame) {
+  if (m_text_state != OK) {
+    return m_text_state;
+  }
+
   string line;
   ReadLine(&line);
-
   if (line.empty()) {
-    return END_OF_FILE;
+    m_text_state = END_OF_FILE;
+    m_end_time = m_text_time;
+    return m_text_state;
   }
 
   vector<string> inputs;
   ola::StringSplit(line, &inputs);
 
-  if (inputs.size() != 2) {
+  if (inputs.size() != 2 ||
+      !ola::StringToInt(inputs[0], &frame->universe, true)) {
     OLA_WARN << "Line " << m_line << " invalid: " << line;
+    m_text_state = INVALID_LINE;
+    return m_text_state;
+  }
+
+  if (!frame->data.SetFromString(inputs[1])) {
+    m_text_state = INVALID_LINE;
+    return m_text_state;
+  }
+  frame->time = m_text_time;
+
+  ReadLine(&line);
+  unsigned int timeout;
+  if (line.empty()) {
+    m_text_state = END_OF_FILE;
+    m_end_time = m_text_time;
+  } else if (!ola::StringToInt(line, &timeout, true)) {
+    OLA_WARN << "Line " << m_line << ": Invalid timeout: " << line;
+    m_text_state = INVALID_LINE;
+  } else {
+    m_text_time += timeout;
+  }
+  return OK;
+}
+
+
+/*
+ * Read the record at m_offset.
+ */
+ShowLoader::State ShowLoader::ReadBinaryRecord(Frame *frame, bool *snapshot) {
+  if (m_offset >= m_data_end) {
+    return END_OF_FILE;
+  }
+
+  unsigned int length;
+  if (!CheckRecord(m_offset, &length)) {
+    OLA_WARN << "Truncated record at offset " << m_offset;
     return INVALID_LINE;
   }
 
-  if (!ola::StringToInt(inputs[0], universe, true)) {
-    OLA_WARN << "Line " << m_line << " invalid: " << line;
+  const uint8_t *record = m_data + m_offset;
+  const uint8_t *payload = record + BinaryShowFormat::RECORD_HEADER_SIZE;
+  const unsigned int size = BinaryShowFormat::GetUInt16(record + 9);
+  frame->time = BinaryShowFormat::GetUInt32(record + 1);
+  frame->universe = BinaryShowFormat::GetUInt32(record + 5);
+
+  bool ok = size <= ola::DMX_UNIVERSE_SIZE;
+  DmxBuffer &data = m_universe_data[frame->universe];
+  switch (record[0]) {
+    case BinaryShowFormat::SNAPSHOT:
+    case BinaryShowFormat::KEYFRAME:
+      *snapshot = record[0] == BinaryShowFormat::SNAPSHOT;
+      ok = ok && length == size;
+      if (ok) {
+        data.Set(payload, size);
+      }
+      break;
+    case BinaryShowFormat::DELTA:
+      ok = ok && ApplyDelta(payload, length, size, &data);
+      break;
+    default:
+      ok = false;
+  }
+
+  if (!ok) {
+    OLA_WARN << "Invalid record at offset " << m_offset;
     return INVALID_LINE;
   }
 
-  return (data->SetFromString(inputs[1]) ? OK : INVALID_LINE);
+  frame->data = data;
+  m_offset += BinaryShowFormat::RECORD_HEADER_SIZE + length;
+  m_end_time = frame->time;
+  return OK;
+}
+
+
+/*
+ * Check there's a complete record at offset.
+ */
+bool ShowLoader::CheckRecord(size_t offset, unsigned int *length) const {
+  if (m_data_end - offset < BinaryShowFormat::RECORD_HEADER_SIZE) {
+    return false;
+  }
+  *length = BinaryShowFormat::GetUInt16(m_data + offset + 11);
+  return m_data_end - offset - BinaryShowFormat::RECORD_HEADER_SIZE >= *length;
+}
+
+
+/*
+ * Apply the runs in a delta record to the previous frame.
+ */
+bool ShowLoader::ApplyDelta(const uint8_t *payload, unsigned int length,
+                            unsigned int size, DmxBuffer *data) {
+  uint8_t slots[ola::DMX_UNIVERSE_SIZE];
+  unsigned int old_size = sizeof(slots);
+  data->Get(slots, &old_size);
+  if (old_size < size) {
+    memset(slots + old_size, 0, size - old_size);
+  }
+
+  unsigned int offset = 0;
+  while (offset < length) {
+    if (length - offset < BinaryShowFormat::RUN_HEADER_SIZE) {
+      return false;
+    }
+    const unsigned int start = BinaryShowFormat::GetUInt16(payload + offset);
+    const unsigned int run_length = BinaryShowFormat::GetUInt16(
+        payload + offset + 2);
+    offset += BinaryShowFormat::RUN_HEADER_SIZE;
+    if (run_length > length - offset || start + run_length > size) {
+      return false;
+    }
+    memcpy(slots + start, payload + offset, run_length);
+    offset += run_length;
+  }
+  data->Set(slots, size);
+  return true;
 }
 
 
@@ -19,15 +19,24 @@
  */
 
 #include <ola/DmxBuffer.h>
+#include <stddef.h>
+#include <stdint.h>
 
-#include <string>
+#include <deque>
 #include <fstream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
 
 #ifndef EXAMPLES_SHOWLOADER_H_
 #define EXAMPLES_SHOWLOADER_H_
 
 /**
  * Loads a show file and reads the DMX data.
+ *
+ * Both the text and the binary formats are supported. Binary files are
+ * memory mapped, and use the index to seek.
  */
 class ShowLoader {
  public:
@@ -43,16 +52,77 @@ class ShowLoader {
   bool Load();
   void Reset();
 
+  /**
+   * @brief Move to a point in the show.
+   * @param offset the time in ms from the start of the show.
+   * @returns false if the show data is invalid.
+   *
+   * The following calls to NextFrame() return the state of each universe at
+   * that point, then the show continues from there.
+   */
+  bool Seek(unsigned int offset);
+
+  /**
+   * @brief The time in ms from the start of the show of the last frame.
+   */
+  unsigned int Position() const { return m_position; }
+
+  bool IsBinary() const { return m_binary; }
+
   State NextTimeout(unsigned int *timeout);
   State NextFrame(unsigned int *universe, ola::DmxBuffer *data);
 
  private:
+  struct Frame {
+    unsigned int time;
+    unsigned int universe;
+    ola::DmxBuffer data;
+  };
+
+  typedef std::map<unsigned int, ola::DmxBuffer> UniverseMap;
+  // time, file offset
+  typedef std::vector<std::pair<unsigned int, uint64_t> > Index;
+
   const std::string m_filename;
   std::ifstream m_show_file;
   unsigned int m_line;
+  bool m_binary;
+
+  // The text format state
+  unsigned int m_text_time;
+  State m_text_state;
+
+  // The binary format state
+  const uint8_t *m_data;
+  size_t m_size;
+  size_t m_data_end;
+  size_t m_offset;
+  Index m_index;
+  UniverseMap m_universe_data;
+  std::vector<uint8_t> m_file_data;
+
+  unsigned int m_position;
+  unsigned int m_end_time;
+  Frame m_next;
+  State m_next_state;
+  std::deque<Frame> m_pending;
 
   static const char OLA_SHOW_HEADER[];
+  static const char OLA_BINARY_SHOW_HEADER[];
+
+  bool LoadBinary();
+  bool MapFile();
+  void UnmapFile();
+  bool LoadIndex();
+  void BuildIndex();
 
+  State ReadPlayableFrame(Frame *frame);
+  State ReadFrame(Frame *frame, bool *snapshot);
+  State ReadTextFrame(Frame *frame);
+  State ReadBinaryRecord(Frame *frame, bool *snapshot);
+  bool CheckRecord(size_t offset, unsigned int *length) const;
+  bool ApplyDelta(const uint8_t *payload, unsigned int length,
+                  unsigned int size, ola::DmxBuffer *data);
   void ReadLine(std::string *line);
 };
 #endif  // EXAMPLES_SHOWLOADER_H_
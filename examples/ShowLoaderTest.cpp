@@ -0,0 +1,188 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ShowLoaderTest.cpp
+ * Test fixture for the ShowLoader class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <unistd.h>
+#include <map>
+
+#include "examples/ShowFormat.h"
+#include "examples/ShowLoader.h"
+#include "examples/ShowSaver.h"
+#include "ola/Clock.h"
+#include "ola/DmxBuffer.h"
+#include "ola/Logging.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::DmxBuffer;
+using ola::TimeInterval;
+using ola::TimeStamp;
+using std::map;
+
+class ShowLoaderTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(ShowLoaderTest);
+  CPPUNIT_TEST(testSeekText);
+  CPPUNIT_TEST(testSeekBinary);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    void setUp();
+    void tearDown();
+    void testSeekText();
+    void testSeekBinary();
+
+ private:
+    typedef map<unsigned int, DmxBuffer> UniverseMap;
+
+    void WriteShow(ShowSaver::Format format);
+    void UniversesAt(unsigned int offset, UniverseMap *universes);
+    void CheckSeek(ShowLoader *loader, unsigned int offset);
+    void CheckSeeks(ShowSaver::Format format);
+
+    static const char SHOW_FILE[];
+    // A frame every 100ms, on universes 1, 2 & 3 in turn.
+    static const unsigned int FRAME_COUNT = 40;
+    static const unsigned int FRAME_INTERVAL = 100;
+    static const unsigned int UNIVERSE_COUNT = 3;
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ShowLoaderTest);
+
+const char ShowLoaderTest::SHOW_FILE[] = TEST_BUILD_DIR
+    "/examples/ShowLoaderTest.show";
+
+namespace {
+/*
+ * The data for frame i. Only one slot changes from the universe's previous
+ * frame, so the binary format uses deltas.
+ */
+void FrameData(unsigned int i, DmxBuffer *buffer) {
+  if (buffer->Size() == 0) {
+    buffer->SetRangeToValue(0, 0, 8);
+  }
+  buffer->SetChannel(i % 8, static_cast<uint8_t>(i + 1));
+}
+}  // namespace
+
+
+void ShowLoaderTest::setUp() {
+  ola::InitLogging(ola::OLA_LOG_INFO, ola::OLA_LOG_STDERR);
+}
+
+
+void ShowLoaderTest::tearDown() {
+  unlink(SHOW_FILE);
+}
+
+
+void ShowLoaderTest::WriteShow(ShowSaver::Format format) {
+  ShowSaver saver(SHOW_FILE, format);
+  OLA_ASSERT_TRUE(saver.Open());
+
+  TimeStamp start;
+  ola::Clock clock;
+  clock.CurrentTime(&start);
+
+  UniverseMap universes;
+  for (unsigned int i = 0; i < FRAME_COUNT; i++) {
+    unsigned int universe = i % UNIVERSE_COUNT + 1;
+    FrameData(i, &universes[universe]);
+    TimeStamp arrival_time = start + TimeInterval(
+        static_cast<int64_t>(i * FRAME_INTERVAL) * 1000);
+    OLA_ASSERT_TRUE(saver.NewFrame(arrival_time, universe,
+                                   universes[universe]));
+  }
+  saver.Close();
+}
+
+
+/*
+ * The state of each universe from the frames before offset.
+ */
+void ShowLoaderTest::UniversesAt(unsigned int offset,
+                                 UniverseMap *universes) {
+  universes->clear();
+  for (unsigned int i = 0; i < FRAME_COUNT && i * FRAME_INTERVAL < offset;
+       i++) {
+    FrameData(i, &(*universes)[i % UNIVERSE_COUNT + 1]);
+  }
+}
+
+
+/*
+ * Seek to offset, and check we get the state of each universe followed by
+ * the rest of the show.
+ */
+void ShowLoaderTest::CheckSeek(ShowLoader *loader, unsigned int offset) {
+  OLA_ASSERT_TRUE(loader->Seek(offset));
+  OLA_ASSERT_EQ(offset, loader->Position());
+
+  UniverseMap expected;
+  UniversesAt(offset, &expected);
+
+  unsigned int universe;
+  DmxBuffer buffer;
+  UniverseMap::const_iterator iter = expected.begin();
+  for (; iter != expected.end(); ++iter) {
+    OLA_ASSERT_EQ(ShowLoader::OK, loader->NextFrame(&universe, &buffer));
+    OLA_ASSERT_EQ(iter->first, universe);
+    OLA_ASSERT_DMX_EQUALS(iter->second, buffer);
+  }
+
+  // Then the frames from the offset onwards.
+  unsigned int first_frame = (offset + FRAME_INTERVAL - 1) / FRAME_INTERVAL;
+  UniverseMap universes = expected;
+  for (unsigned int i = first_frame; i < FRAME_COUNT; i++) {
+    unsigned int timeout;
+    OLA_ASSERT_EQ(ShowLoader::OK, loader->NextTimeout(&timeout));
+    OLA_ASSERT_EQ(ShowLoader::OK, loader->NextFrame(&universe, &buffer));
+    OLA_ASSERT_EQ(i * FRAME_INTERVAL, loader->Position());
+    OLA_ASSERT_EQ(i % UNIVERSE_COUNT + 1, universe);
+    FrameData(i, &universes[universe]);
+    OLA_ASSERT_DMX_EQUALS(universes[universe], buffer);
+  }
+  OLA_ASSERT_EQ(ShowLoader::END_OF_FILE,
+                loader->NextFrame(&universe, &buffer));
+}
+
+
+void ShowLoaderTest::CheckSeeks(ShowSaver::Format format) {
+  WriteShow(format);
+  ShowLoader loader(SHOW_FILE);
+  OLA_ASSERT_TRUE(loader.Load());
+  OLA_ASSERT_EQ(format == ShowSaver::BINARY, loader.IsBinary());
+
+  // Between two frames.
+  CheckSeek(&loader, 1550);
+  // On a frame, which is also the time of a snapshot in the binary format.
+  CheckSeek(&loader, 2 * BinaryShowFormat::SNAPSHOT_INTERVAL);
+  // Back to before the first snapshot.
+  CheckSeek(&loader, 250);
+}
+
+
+void ShowLoaderTest::testSeekText() {
+  CheckSeeks(ShowSaver::TEXT);
+}
+
+
+void ShowLoaderTest::testSeekBinary() {
+  CheckSeeks(ShowSaver::BINARY);
+}
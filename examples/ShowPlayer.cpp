@@ -25,13 +25,19 @@
 
 #include <errno.h>
 #include <string.h>
+#include <unistd.h>
 #include <ola/Callback.h>
+#include <ola/Clock.h>
 #include <ola/DmxBuffer.h>
 #include <ola/Logging.h>
 #include <ola/StringUtils.h>
+#include <ola/base/Array.h>
 #include <ola/base/SysExits.h>
 #include <ola/client/ClientWrapper.h>
 #include <ola/client/OlaClient.h>
+#include <ola/io/Descriptor.h>
+#include <ola/timecode/TimeCode.h>
+#include <ola/timecode/TimeCodeEnums.h>
 #include <fstream>
 #include <iostream>
 #include <string>
@@ -42,16 +48,41 @@
 using std::vector;
 using std::string;
 using ola::DmxBuffer;
+using ola::TimeInterval;
+using ola::TimeStamp;
+using ola::timecode::TimeCode;
+
+const unsigned int ShowPlayer::LATENESS_BUCKETS[] = {
+  1, 2, 5, 10, 20, 50, 100,
+};
 
 
 ShowPlayer::ShowPlayer(const string &filename)
     : m_loader(filename),
       m_infinite_loop(false),
       m_iteration_remaining(0),
-      m_loop_delay(0) {
+      m_loop_delay(0),
+      m_start(0),
+      m_stop(0),
+      m_next_time(0),
+      m_timeout_id(ola::thread::INVALID_TIMEOUT),
+      m_chase(false),
+      m_chase_running(false),
+      m_timecode_type(ola::timecode::TIMECODE_SMPTE),
+      m_timecode_offset(0),
+      m_frames(0),
+      m_batches(0),
+      m_seeks(0),
+      m_max_lateness(0),
+      m_lateness(arraysize(LATENESS_BUCKETS) + 1, 0) {
 }
 
-ShowPlayer::~ShowPlayer() {}
+ShowPlayer::~ShowPlayer() {
+  if (m_stdin_descriptor.get()) {
+    m_client.GetSelectServer()->RemoveReadDescriptor(
+        m_stdin_descriptor.get());
+  }
+}
 
 int ShowPlayer::Init() {
   if (!m_client.Setup()) {
@@ -68,13 +99,31 @@ int ShowPlayer::Init() {
 
 int ShowPlayer::Playback(unsigned int iterations,
                          unsigned int duration,
-                         unsigned int delay) {
+                         unsigned int delay,
+                         unsigned int start,
+                         unsigned int stop) {
   m_infinite_loop = iterations == 0 || duration != 0;
   m_iteration_remaining = iterations;
   m_loop_delay = delay;
-  SendNextFrame();
+  m_start = start;
+  m_stop = stop;
 
   ola::io::SelectServer *ss = m_client.GetSelectServer();
+  if (m_chase) {
+    m_stdin_descriptor.reset(
+        new ola::io::UnmanagedFileDescriptor(STDIN_FILENO));
+    m_stdin_descriptor->SetOnData(
+        ola::NewCallback(this, &ShowPlayer::ReadTimeCode));
+    ss->AddReadDescriptor(m_stdin_descriptor.get());
+  } else {
+    if (m_start && !m_loader.Seek(m_start)) {
+      return ola::EXIT_DATAERR;
+    }
+    TimeStamp now;
+    m_clock.CurrentMonotonicTime(&now);
+    m_epoch = now - TimeInterval(static_cast<int64_t>(m_start) * 1000);
+    ScheduleFrames(m_start);
+  }
 
   if (duration != 0) {
     ss->RegisterSingleTimeout(
@@ -85,30 +134,142 @@ int ShowPlayer::Playback(unsigned int iterations,
   return ola::EXIT_OK;
 }
 
-void ShowPlayer::SendNextFrame() {
-  DmxBuffer buffer;
-  unsigned int universe;
-  ShowLoader::State state = m_loader.NextFrame(&universe, &buffer);
-  switch (state) {
-    case ShowLoader::END_OF_FILE:
-      HandleEndOfFile();
-      return;
-    case ShowLoader::INVALID_LINE:
-      m_client.GetSelectServer()->Terminate();
-      return;
+void ShowPlayer::ChaseTimeCode(ola::timecode::TimeCodeType type,
+                               unsigned int offset) {
+  m_chase = true;
+  m_timecode_type = type;
+  m_timecode_offset = offset;
+}
+
+void ShowPlayer::UpdateTimeCode(const TimeCode &timecode) {
+  if (!timecode.IsValid()) {
+    OLA_WARN << "Invalid timecode " << timecode;
+    return;
+  }
+
+  TimeStamp now;
+  m_clock.CurrentMonotonicTime(&now);
+  m_last_timecode = now;
+
+  unsigned int time = TimeCodeToMilliSeconds(timecode);
+  if (time < m_timecode_offset) {
+    return;
+  }
+  unsigned int show_time = time - m_timecode_offset;
+  if (!m_chase_running) {
+    Locate(show_time);
+    return;
+  }
+
+  // Timecode only has frame resolution, so ignore differences smaller than a
+  // frame, otherwise the timeline would jitter.
+  TimeStamp timecode_time = ShowTimeToMonotonic(show_time);
+  TimeInterval drift = timecode_time > now ? timecode_time - now :
+                       now - timecode_time;
+  int64_t drift_ms = drift.InMilliSeconds();
+  int64_t frame_ms = 1000 / 24;
+  switch (timecode.Type()) {
+    case ola::timecode::TIMECODE_EBU:
+      frame_ms = 1000 / 25;
+      break;
+    case ola::timecode::TIMECODE_DF:
+    case ola::timecode::TIMECODE_SMPTE:
+      frame_ms = 1000 / 30;
+      break;
     default:
       {}
   }
 
-  state = RegisterNextTimeout();
+  if (drift_ms <= frame_ms) {
+    return;
+  } else if (drift_ms > CHASE_SEEK_THRESHOLD) {
+    OLA_INFO << "Timecode jumped by " << drift_ms << "ms, seeking to "
+             << show_time;
+    Locate(show_time);
+  } else {
+    // Shift the timeline to match
+    OLA_DEBUG << "Timecode drifted by " << drift_ms << "ms";
+    m_epoch = now - TimeInterval(static_cast<int64_t>(show_time) * 1000);
+    if (m_timeout_id != ola::thread::INVALID_TIMEOUT) {
+      CancelFrames();
+      ScheduleFrames(m_next_time);
+    }
+  }
+}
 
-  OLA_INFO << "Universe: " << universe << ": " << buffer.ToString();
-  ola::client::SendDMXArgs args;
-  m_client.GetClient()->SendDMX(universe, buffer, args);
+void ShowPlayer::PrintTiming(std::ostream *out) const {
+  *out << "------------ Timing ----------" << std::endl;
+  *out << "Frames sent: " << m_frames << " in " << m_batches << " batches"
+       << std::endl;
+  if (m_chase) {
+    *out << "Timecode seeks: " << m_seeks << std::endl;
+  }
+  *out << "Lateness:" << std::endl;
+  for (unsigned int i = 0; i < arraysize(LATENESS_BUCKETS); i++) {
+    *out << "  < " << LATENESS_BUCKETS[i] << "ms: " << m_lateness[i]
+         << std::endl;
+  }
+  *out << "  >= " << LATENESS_BUCKETS[arraysize(LATENESS_BUCKETS) - 1]
+       << "ms: " << m_lateness[arraysize(LATENESS_BUCKETS)] << std::endl;
+  *out << "Max lateness: " << m_max_lateness / 1000 << "."
+       << m_max_lateness % 1000 / 100 << "ms" << std::endl;
+}
+
+unsigned int ShowPlayer::TimeCodeToMilliSeconds(const TimeCode &timecode) {
+  unsigned int seconds = (timecode.Hours() * 60 + timecode.Minutes()) * 60 +
+                         timecode.Seconds();
+  switch (timecode.Type()) {
+    case ola::timecode::TIMECODE_FILM:
+      return seconds * 1000 + timecode.Frames() * 1000 / 24;
+    case ola::timecode::TIMECODE_EBU:
+      return seconds * 1000 + timecode.Frames() * 1000 / 25;
+    case ola::timecode::TIMECODE_DF:
+      {
+        // Drop frame timecode skips frame numbers 0 and 1 at the start of
+        // each minute, except every tenth minute, to keep the 30 fps labels
+        // in step with the real rate of 29.97 fps.
+        unsigned int minutes = timecode.Hours() * 60 + timecode.Minutes();
+        uint64_t frame = seconds * 30 + timecode.Frames() -
+                         2 * (minutes - minutes / 10);
+        return static_cast<unsigned int>(frame * 1001 / 30);
+      }
+    case ola::timecode::TIMECODE_SMPTE:
+    default:
+      return seconds * 1000 + timecode.Frames() * 1000 / 30;
+  }
+}
+
+/**
+ * Send the frames which are due and schedule the next ones.
+ */
+void ShowPlayer::SendFrames() {
+  m_timeout_id = ola::thread::INVALID_TIMEOUT;
+
+  TimeStamp now;
+  m_clock.CurrentMonotonicTime(&now);
+  if (m_chase && now - m_last_timecode >
+      TimeInterval(static_cast<int64_t>(FREEWHEEL_TIME) * 1000)) {
+    OLA_INFO << "Lost timecode, pausing playback";
+    m_chase_running = false;
+    return;
+  }
+  RecordLateness(now);
+
+  unsigned int timeout = 0;
+  ola::client::OlaClient *client = m_client.GetClient();
+  unsigned int frames = m_frames;
+  client->BeginBatch();
+  ShowLoader::State state = SendBatch(&timeout);
+  if (!client->EndBatch()) {
+    OLA_WARN << "Failed to send the frames to olad";
+  }
+  if (m_frames != frames) {
+    m_batches++;
+  }
 
   switch (state) {
     case ShowLoader::END_OF_FILE:
-      HandleEndOfFile();
+      HandleEndOfFile(m_next_time);
       return;
     case ShowLoader::INVALID_LINE:
       m_client.GetSelectServer()->Terminate();
@@ -116,40 +277,176 @@ void ShowPlayer::SendNextFrame() {
     default:
       {}
   }
+
+  unsigned int next_time = m_loader.Position() + timeout;
+  if (m_stop && next_time >= m_stop) {
+    HandleEndOfFile(m_stop);
+    return;
+  }
+  ScheduleFrames(next_time);
 }
 
+/**
+ * Send all the frames with the same time.
+ * @param timeout set to the time until the next frame.
+ */
+ShowLoader::State ShowPlayer::SendBatch(unsigned int *timeout) {
+  DmxBuffer buffer;
+  unsigned int universe;
+  ola::client::SendDMXArgs args;
+  while (true) {
+    ShowLoader::State state = m_loader.NextFrame(&universe, &buffer);
+    if (state != ShowLoader::OK) {
+      return state;
+    }
+
+    OLA_INFO << "Universe: " << universe << ": " << buffer.ToString();
+    m_client.GetClient()->SendDMX(universe, buffer, args);
+    m_frames++;
+
+    state = m_loader.NextTimeout(timeout);
+    if (state != ShowLoader::OK || *timeout) {
+      return state;
+    }
+  }
+}
 
 /**
- * Get the next time offset
+ * Schedule the frames for a point on the timeline.
  */
-ShowLoader::State ShowPlayer::RegisterNextTimeout() {
-  unsigned int timeout;
-  ShowLoader::State state = m_loader.NextTimeout(&timeout);
-  if (state != ShowLoader::OK) {
-    return state;
+void ShowPlayer::ScheduleFrames(unsigned int show_time) {
+  m_next_time = show_time;
+
+  TimeStamp now;
+  m_clock.CurrentMonotonicTime(&now);
+  TimeStamp target = ShowTimeToMonotonic(show_time);
+  TimeInterval delay;
+  if (target > now) {
+    delay = target - now;
   }
 
-  OLA_INFO << "Registering timeout for " << timeout << "ms";
-  m_client.GetSelectServer()->RegisterSingleTimeout(
-      timeout,
-      ola::NewSingleCallback(this, &ShowPlayer::SendNextFrame));
-  return state;
+  OLA_INFO << "Registering timeout for " << delay;
+  m_timeout_id = m_client.GetSelectServer()->RegisterSingleTimeout(
+      delay,
+      ola::NewSingleCallback(this, &ShowPlayer::SendFrames));
+}
+
+void ShowPlayer::CancelFrames() {
+  if (m_timeout_id != ola::thread::INVALID_TIMEOUT) {
+    m_client.GetSelectServer()->RemoveTimeout(m_timeout_id);
+    m_timeout_id = ola::thread::INVALID_TIMEOUT;
+  }
 }
 
+/**
+ * Move the timeline to a new point, and send the state of each universe
+ * there.
+ */
+void ShowPlayer::Locate(unsigned int show_time) {
+  CancelFrames();
+  if (!m_loader.Seek(show_time)) {
+    m_client.GetSelectServer()->Terminate();
+    return;
+  }
+  m_seeks++;
+
+  TimeStamp now;
+  m_clock.CurrentMonotonicTime(&now);
+  m_epoch = now - TimeInterval(static_cast<int64_t>(show_time) * 1000);
+  m_chase_running = true;
+  ScheduleFrames(show_time);
+}
 
 /**
  * Handle the case where we reach the end of file
+ * @param end_time the show time the iteration ended at.
  */
-void ShowPlayer::HandleEndOfFile() {
+void ShowPlayer::HandleEndOfFile(unsigned int end_time) {
+  if (m_chase) {
+    // Wait for the timecode to move somewhere else.
+    return;
+  }
+
   m_iteration_remaining--;
   if (m_infinite_loop || m_iteration_remaining > 0) {
-    m_loader.Reset();
-    m_client.GetSelectServer()->RegisterSingleTimeout(
-        m_loop_delay,
-        ola::NewSingleCallback(this, &ShowPlayer::SendNextFrame));
+    m_loader.Seek(m_start);
+    // The next iteration starts m_loop_delay after this one ended, on the
+    // same timeline.
+    unsigned int length = end_time > m_start ? end_time - m_start : 0;
+    m_epoch += TimeInterval(static_cast<int64_t>(length + m_loop_delay) *
+                            1000);
+    ScheduleFrames(m_start);
     return;
   } else {
     // stop the show
     m_client.GetSelectServer()->Terminate();
   }
 }
+
+void ShowPlayer::RecordLateness(const TimeStamp &now) {
+  TimeStamp target = ShowTimeToMonotonic(m_next_time);
+  int64_t lateness = 0;
+  if (now > target) {
+    TimeInterval interval = now - target;
+    lateness = interval.Seconds() * 1000000 + interval.MicroSeconds();
+  }
+
+  if (lateness > m_max_lateness) {
+    m_max_lateness = lateness;
+  }
+  unsigned int i = 0;
+  while (i < arraysize(LATENESS_BUCKETS) &&
+         lateness >= LATENESS_BUCKETS[i] * 1000) {
+    i++;
+  }
+  m_lateness[i]++;
+}
+
+/**
+ * Read timecode from stdin.
+ */
+void ShowPlayer::ReadTimeCode() {
+  char data[256];
+  ssize_t data_read = read(STDIN_FILENO, data, sizeof(data));
+  if (data_read < 0 && (errno == EINTR || errno == EAGAIN)) {
+    return;
+  } else if (data_read <= 0) {
+    OLA_INFO << "Timecode input closed";
+    m_client.GetSelectServer()->RemoveReadDescriptor(
+        m_stdin_descriptor.get());
+    m_stdin_descriptor.reset();
+    return;
+  }
+
+  for (ssize_t i = 0; i < data_read; i++) {
+    if (data[i] == '\n') {
+      ParseTimeCode(m_stdin_line);
+      m_stdin_line.clear();
+    } else if (m_stdin_line.size() < sizeof(data)) {
+      m_stdin_line.push_back(data[i]);
+    }
+  }
+}
+
+void ShowPlayer::ParseTimeCode(const string &line) {
+  string value = line;
+  ola::StringTrim(&value);
+  if (value.empty()) {
+    return;
+  }
+
+  // Drop frame timecode is often written with a ; before the frames.
+  vector<string> tokens;
+  ola::StringSplit(value, &tokens, ":;.");
+  uint8_t fields[4];
+  bool ok = tokens.size() == 4;
+  for (unsigned int i = 0; ok && i < tokens.size(); i++) {
+    ok = ola::StringToInt(tokens[i], &fields[i], true);
+  }
+  if (!ok) {
+    OLA_WARN << "Invalid timecode " << value;
+    return;
+  }
+  UpdateTimeCode(TimeCode(m_timecode_type, fields[0], fields[1], fields[2],
+                          fields[3]));
+}
@@ -18,11 +18,20 @@
  * Copyright (C) 2011 Simon Newton
  */
 
+#include <ola/Clock.h>
 #include <ola/DmxBuffer.h>
 #include <ola/client/ClientWrapper.h>
+#include <ola/io/Descriptor.h>
+#include <ola/thread/SchedulerInterface.h>
+#include <ola/timecode/TimeCode.h>
+#include <ola/timecode/TimeCodeEnums.h>
+#include <stdint.h>
 
-#include <string>
 #include <fstream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
 
 #include "examples/ShowLoader.h"
 
@@ -31,6 +40,14 @@
 
 /**
  * @brief A class which plays back recorded show files.
+ *
+ * Frames are scheduled against a fixed timeline, taken from the monotonic
+ * clock, rather than relative to the previous frame, so timer latency doesn't
+ * build up over a long show. All the frames with the same time are sent to
+ * olad together.
+ *
+ * Playback can also chase timecode, in which case the timeline follows the
+ * timecode rather than starting straight away.
  */
 class ShowPlayer {
  public:
@@ -53,10 +70,57 @@ class ShowPlayer {
    * @param duration the duration in seconds after which playback is stopped.
    * @param delay the hold time at the end of a show before playback starts
    * from the beginning again.
+   * @param start the time in ms into the show to start each iteration from.
+   * @param stop the time in ms into the show to end each iteration at, 0
+   * means the end of the show.
    */
   int Playback(unsigned int iterations,
                unsigned int duration,
-               unsigned int delay);
+               unsigned int delay,
+               unsigned int start = 0,
+               unsigned int stop = 0);
+
+  /**
+   * @brief Chase timecode rather than playing the show straight away.
+   * @param type the type of the timecode read from stdin.
+   * @param offset the timecode, in ms, which corresponds to the start of the
+   * show.
+   *
+   * This must be called before Playback(). Timecode is read from stdin, one
+   * Hours:Minutes:Seconds:Frames value per line, for example from an LTC
+   * decoder. If the timecode stops, playback carries on for
+   * FREEWHEEL_TIME and then pauses until it resumes.
+   */
+  void ChaseTimeCode(ola::timecode::TimeCodeType type, unsigned int offset);
+
+  /**
+   * @brief Move the timeline to match a timecode value.
+   * @param timecode the current timecode.
+   *
+   * Small differences are corrected by shifting the timeline, larger ones by
+   * seeking to the new position.
+   */
+  void UpdateTimeCode(const ola::timecode::TimeCode &timecode);
+
+  /**
+   * @brief Print the number of frames sent and how late they were.
+   * @param out the ostream to print to.
+   */
+  void PrintTiming(std::ostream *out) const;
+
+  /**
+   * @brief Convert a timecode value to ms.
+   * @param timecode the timecode to convert.
+   * @returns the time in ms since 00:00:00:00.
+   */
+  static unsigned int TimeCodeToMilliSeconds(
+      const ola::timecode::TimeCode &timecode);
+
+  // in ms
+  static const unsigned int FREEWHEEL_TIME = 1000;
+  // Differences between the timeline and the timecode larger than this, in
+  // ms, cause a seek.
+  static const unsigned int CHASE_SEEK_THRESHOLD = 250;
 
  private:
   ola::client::OlaClientWrapper m_client;
@@ -64,10 +128,48 @@ class ShowPlayer {
   bool m_infinite_loop;
   unsigned int m_iteration_remaining;
   unsigned int m_loop_delay;
+  unsigned int m_start;
+  unsigned int m_stop;
+
+  // The timeline
+  ola::Clock m_clock;
+  // The monotonic time that show time 0 corresponds to.
+  ola::TimeStamp m_epoch;
+  // The show time of the next frames.
+  unsigned int m_next_time;
+  ola::thread::timeout_id m_timeout_id;
+
+  // Timecode chasing
+  bool m_chase;
+  bool m_chase_running;
+  ola::timecode::TimeCodeType m_timecode_type;
+  unsigned int m_timecode_offset;
+  ola::TimeStamp m_last_timecode;
+  std::auto_ptr<ola::io::UnmanagedFileDescriptor> m_stdin_descriptor;
+  std::string m_stdin_line;
+
+  // Stats
+  unsigned int m_frames;
+  unsigned int m_batches;
+  unsigned int m_seeks;
+  int64_t m_max_lateness;
+  std::vector<unsigned int> m_lateness;
+
+  void SendFrames();
+  ShowLoader::State SendBatch(unsigned int *timeout);
+  void ScheduleFrames(unsigned int show_time);
+  void CancelFrames();
+  void Locate(unsigned int show_time);
+  void HandleEndOfFile(unsigned int end_time);
+  void RecordLateness(const ola::TimeStamp &now);
+  void ReadTimeCode();
+  void ParseTimeCode(const std::string &line);
+
+  ola::TimeStamp ShowTimeToMonotonic(unsigned int show_time) const {
+    return m_epoch + ola::TimeInterval(static_cast<int64_t>(show_time) * 1000);
+  }
 
-  void SendNextFrame();
-  ShowLoader::State RegisterNextTimeout();
-  bool ReadNextFrame(unsigned int *universe, ola::DmxBuffer *data);
-  void HandleEndOfFile();
+  // The upper bounds of the lateness buckets, in ms.
+  static const unsigned int LATENESS_BUCKETS[];
 };
 #endif  // EXAMPLES_SHOWPLAYER_H_
@@ -0,0 +1,84 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ShowPlayerTest.cpp
+ * Test fixture for the ShowPlayer class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "examples/ShowPlayer.h"
+#include "ola/testing/TestUtils.h"
+#include "ola/timecode/TimeCode.h"
+#include "ola/timecode/TimeCodeEnums.h"
+
+using ola::timecode::TimeCode;
+
+class ShowPlayerTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(ShowPlayerTest);
+  CPPUNIT_TEST(testTimeCodeToMilliSeconds);
+  CPPUNIT_TEST(testDropFrameTimeCode);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    void testTimeCodeToMilliSeconds();
+    void testDropFrameTimeCode();
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ShowPlayerTest);
+
+
+/*
+ * Check the conversion for the fixed frame rates.
+ */
+void ShowPlayerTest::testTimeCodeToMilliSeconds() {
+  OLA_ASSERT_EQ(0u, ShowPlayer::TimeCodeToMilliSeconds(
+      TimeCode(ola::timecode::TIMECODE_SMPTE, 0, 0, 0, 0)));
+  OLA_ASSERT_EQ(3723500u, ShowPlayer::TimeCodeToMilliSeconds(
+      TimeCode(ola::timecode::TIMECODE_SMPTE, 1, 2, 3, 15)));
+  OLA_ASSERT_EQ(10500u, ShowPlayer::TimeCodeToMilliSeconds(
+      TimeCode(ola::timecode::TIMECODE_FILM, 0, 0, 10, 12)));
+  OLA_ASSERT_EQ(10960u, ShowPlayer::TimeCodeToMilliSeconds(
+      TimeCode(ola::timecode::TIMECODE_EBU, 0, 0, 10, 24)));
+  OLA_ASSERT_EQ(86399966u, ShowPlayer::TimeCodeToMilliSeconds(
+      TimeCode(ola::timecode::TIMECODE_SMPTE, 23, 59, 59, 29)));
+}
+
+
+/*
+ * Check drop frame timecode tracks the 29.97 fps rate.
+ */
+void ShowPlayerTest::testDropFrameTimeCode() {
+  OLA_ASSERT_EQ(0u, ShowPlayer::TimeCodeToMilliSeconds(
+      TimeCode(ola::timecode::TIMECODE_DF, 0, 0, 0, 0)));
+  OLA_ASSERT_EQ(1001u, ShowPlayer::TimeCodeToMilliSeconds(
+      TimeCode(ola::timecode::TIMECODE_DF, 0, 0, 1, 0)));
+
+  // Frames 0 & 1 are skipped at the start of the minute, so 00:00:59;29 and
+  // 00:01:00;02 are adjacent frames.
+  OLA_ASSERT_EQ(60026u, ShowPlayer::TimeCodeToMilliSeconds(
+      TimeCode(ola::timecode::TIMECODE_DF, 0, 0, 59, 29)));
+  OLA_ASSERT_EQ(60060u, ShowPlayer::TimeCodeToMilliSeconds(
+      TimeCode(ola::timecode::TIMECODE_DF, 0, 1, 0, 2)));
+
+  // No frames are skipped in every tenth minute, which keeps the labels in
+  // step with real time.
+  OLA_ASSERT_EQ(599999u, ShowPlayer::TimeCodeToMilliSeconds(
+      TimeCode(ola::timecode::TIMECODE_DF, 0, 10, 0, 0)));
+  OLA_ASSERT_EQ(3599996u, ShowPlayer::TimeCodeToMilliSeconds(
+      TimeCode(ola::timecode::TIMECODE_DF, 1, 0, 0, 0)));
+}
@@ -47,8 +47,9 @@ using std::vector;
 
 
 ShowRecorder::ShowRecorder(const string &filename,
-                           const vector<unsigned int> &universes)
-    : m_saver(filename),
+                           const vector<unsigned int> &universes,
+                           ShowSaver::Format format)
+    : m_saver(filename, format),
       m_universes(universes),
       m_frame_count(0) {
 }
@@ -21,27 +21,37 @@
  * universe-number channel1,channel2,channel3
  * delay-in-ms
  * universe-number channel1,channel2,channel3
+ *
+ * or the binary format described in ShowFormat.h.
  */
 
 #include <errno.h>
 #include <string.h>
+#include <ola/Constants.h>
 #include <ola/DmxBuffer.h>
 #include <ola/Logging.h>
+#include <ola/StringUtils.h>
 #include <fstream>
 #include <iostream>
 #include <string>
 
+#include "examples/ShowFormat.h"
 #include "examples/ShowSaver.h"
 
 using std::string;
 using ola::DmxBuffer;
-using std::endl;
 
 
 const char ShowSaver::OLA_SHOW_HEADER[] = "OLA Show";
+const char ShowSaver::OLA_BINARY_SHOW_HEADER[] = "OLA Binary Show";
 
-ShowSaver::ShowSaver(const string &filename)
-    : m_filename(filename) {
+ShowSaver::ShowSaver(const string &filename, Format format)
+    : m_filename(filename),
+      m_format(format),
+      m_write_buffer(WRITE_BUFFER_SIZE),
+      m_offset(0),
+      m_record(BinaryShowFormat::RECORD_HEADER_SIZE +
+               ola::DMX_UNIVERSE_SIZE) {
 }
 
 
@@ -50,47 +60,210 @@ ShowSaver::~ShowSaver() {
 }
 
 
-/**
- * Open the show file for writing.
- * @returns true if we could open the file, false otherwise.
- */
 bool ShowSaver::Open() {
-  m_show_file.open(m_filename.data());
+  // Frames arrive much faster than we want to write to the disk, so use a
+  // large buffer. This has to be set before the file is opened.
+  m_show_file.rdbuf()->pubsetbuf(&m_write_buffer[0], m_write_buffer.size());
+  m_show_file.open(m_filename.data(), std::ios::out | std::ios::binary);
   if (!m_show_file.is_open()) {
     OLA_FATAL << "Can't open " << m_filename << ": " << strerror(errno);
     return false;
   }
 
-  m_show_file << OLA_SHOW_HEADER << endl;
+  if (m_format == TEXT) {
+    m_show_file << OLA_SHOW_HEADER << "\n";
+    return true;
+  }
+
+  uint8_t header[BinaryShowFormat::FILE_HEADER_SIZE];
+  memcpy(header, OLA_BINARY_SHOW_HEADER, sizeof(OLA_BINARY_SHOW_HEADER) - 1);
+  header[sizeof(OLA_BINARY_SHOW_HEADER) - 1] = '\n';
+  BinaryShowFormat::PutUInt16(header + sizeof(OLA_BINARY_SHOW_HEADER),
+                              BinaryShowFormat::VERSION);
+  BinaryShowFormat::PutUInt16(header + sizeof(OLA_BINARY_SHOW_HEADER) + 2, 0);
+  m_show_file.write(reinterpret_cast<char*>(header), sizeof(header));
+  m_offset = sizeof(header);
   return true;
 }
 
 
 
-/**
- * Close the show file
- */
 void ShowSaver::Close() {
   if (m_show_file.is_open()) {
+    if (m_format == BINARY) {
+      WriteIndex();
+    }
     m_show_file.close();
   }
 }
 
 
-/**
- * Write a new frame
- */
 bool ShowSaver::NewFrame(const ola::TimeStamp &arrival_time,
                          unsigned int universe,
                          const ola::DmxBuffer &data) {
-  // TODO(simon): add much better error handling here
+  if (m_format == BINARY) {
+    if (!m_first_frame.IsSet()) {
+      m_first_frame = arrival_time;
+    }
+    const ola::TimeInterval offset = arrival_time - m_first_frame;
+    return NewBinaryFrame(offset.InMilliSeconds(), universe, data);
+  }
+
   if (m_last_frame.IsSet()) {
     // this is not the first frame so write the delay in ms
     const ola::TimeInterval delta = arrival_time - m_last_frame;
 
-    m_show_file << delta.InMilliSeconds() << endl;
+    m_show_file << delta.InMilliSeconds() << "\n";
   }
   m_last_frame = arrival_time;
-  m_show_file << universe << " " << data.ToString() << endl;
+  m_show_file << universe << " " << data.ToString() << "\n";
+  return m_show_file.good();
+}
+
+
+bool ShowSaver::FormatFromString(const string &value, Format *format) {
+  string type = value;
+  ola::ToLower(&type);
+  if (type == "text") {
+    *format = TEXT;
+  } else if (type == "binary") {
+    *format = BINARY;
+  } else {
+    return false;
+  }
   return true;
 }
+
+
+/*
+ * Write a frame as a delta from the last frame for the universe, or as a
+ * keyframe if that's smaller.
+ */
+bool ShowSaver::NewBinaryFrame(unsigned int time, unsigned int universe,
+                               const DmxBuffer &data) {
+  if (!m_universe_data.empty() &&
+      (m_index.empty() ||
+       time - m_index.back().first >= BinaryShowFormat::SNAPSHOT_INTERVAL)) {
+    WriteSnapshot(time);
+  }
+
+  uint8_t *payload = &m_record[BinaryShowFormat::RECORD_HEADER_SIZE];
+  std::pair<UniverseMap::iterator, bool> result = m_universe_data.insert(
+      UniverseMap::value_type(universe, data));
+  unsigned int length = 0;
+  if (!result.second) {
+    length = EncodeDelta(result.first->second, data, payload);
+    result.first->second.Set(data);
+  }
+
+  if (result.second || length >= data.Size()) {
+    length = data.Size();
+    data.Get(payload, &length);
+    WriteRecord(BinaryShowFormat::KEYFRAME, time, universe, data.Size(),
+                length);
+  } else {
+    WriteRecord(BinaryShowFormat::DELTA, time, universe, data.Size(), length);
+  }
+  return m_show_file.good();
+}
+
+
+/*
+ * Encode the slots which changed as a series of runs. Runs separated by fewer
+ * unchanged slots than a run header are merged.
+ * @returns the length of the payload, or a value >= data.Size() if the delta
+ *   is no smaller than the data.
+ */
+unsigned int ShowSaver::EncodeDelta(const DmxBuffer &old_data,
+                                    const DmxBuffer &data,
+                                    uint8_t *payload) {
+  const uint8_t *old_slots = old_data.GetRaw();
+  const unsigned int old_size = old_data.Size();
+  const uint8_t *slots = data.GetRaw();
+  const unsigned int size = data.Size();
+
+  unsigned int length = 0;
+  unsigned int slot = 0;
+  while (slot < size) {
+    if (slot < old_size && old_slots[slot] == slots[slot]) {
+      slot++;
+      continue;
+    }
+
+    const unsigned int start = slot;
+    unsigned int end = slot + 1;
+    for (unsigned int i = end; i < size; i++) {
+      if (i >= old_size || old_slots[i] != slots[i]) {
+        end = i + 1;
+      } else if (i - end >= BinaryShowFormat::RUN_HEADER_SIZE) {
+        break;
+      }
+    }
+
+    const unsigned int run_length = end - start;
+    if (length + BinaryShowFormat::RUN_HEADER_SIZE + run_length >= size) {
+      return size;
+    }
+    BinaryShowFormat::PutUInt16(payload + length, start);
+    BinaryShowFormat::PutUInt16(payload + length + 2, run_length);
+    memcpy(payload + length + BinaryShowFormat::RUN_HEADER_SIZE,
+           slots + start, run_length);
+    length += BinaryShowFormat::RUN_HEADER_SIZE + run_length;
+    slot = end;
+  }
+  return length;
+}
+
+
+/*
+ * Write the state of all universes, so playback can start from here.
+ */
+void ShowSaver::WriteSnapshot(unsigned int time) {
+  m_index.push_back(std::make_pair(time, m_offset));
+
+  uint8_t *payload = &m_record[BinaryShowFormat::RECORD_HEADER_SIZE];
+  UniverseMap::const_iterator iter = m_universe_data.begin();
+  for (; iter != m_universe_data.end(); ++iter) {
+    unsigned int length = iter->second.Size();
+    iter->second.Get(payload, &length);
+    WriteRecord(BinaryShowFormat::SNAPSHOT, time, iter->first, length,
+                length);
+  }
+}
+
+
+/*
+ * Write the record in m_record, the payload is already in place.
+ */
+void ShowSaver::WriteRecord(uint8_t type, unsigned int time,
+                            unsigned int universe, unsigned int size,
+                            unsigned int length) {
+  uint8_t *header = &m_record[0];
+  header[0] = type;
+  BinaryShowFormat::PutUInt32(header + 1, time);
+  BinaryShowFormat::PutUInt32(header + 5, universe);
+  BinaryShowFormat::PutUInt16(header + 9, size);
+  BinaryShowFormat::PutUInt16(header + 11, length);
+
+  const unsigned int record_size = BinaryShowFormat::RECORD_HEADER_SIZE +
+                                   length;
+  m_show_file.write(reinterpret_cast<char*>(header), record_size);
+  m_offset += record_size;
+}
+
+
+void ShowSaver::WriteIndex() {
+  uint8_t entry[BinaryShowFormat::INDEX_ENTRY_SIZE];
+  Index::const_iterator iter = m_index.begin();
+  for (; iter != m_index.end(); ++iter) {
+    BinaryShowFormat::PutUInt32(entry, iter->first);
+    BinaryShowFormat::PutUInt64(entry + 4, iter->second);
+    m_show_file.write(reinterpret_cast<char*>(entry), sizeof(entry));
+  }
+
+  uint8_t trailer[BinaryShowFormat::TRAILER_SIZE];
+  BinaryShowFormat::PutUInt64(trailer, m_offset);
+  BinaryShowFormat::PutUInt32(trailer + 8, m_index.size());
+  BinaryShowFormat::PutUInt32(trailer + 12, BinaryShowFormat::INDEX_MAGIC);
+  m_show_file.write(reinterpret_cast<char*>(trailer), sizeof(trailer));
+}
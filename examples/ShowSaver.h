@@ -21,8 +21,12 @@
 #include <ola/Clock.h>
 #include <ola/DmxBuffer.h>
 
-#include <string>
+#include <stdint.h>
 #include <fstream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
 
 #ifndef EXAMPLES_SHOWSAVER_H_
 #define EXAMPLES_SHOWSAVER_H_
@@ -32,7 +36,12 @@
  */
 class ShowSaver {
  public:
-  explicit ShowSaver(const std::string &filename);
+  typedef enum {
+    TEXT,
+    BINARY,
+  } Format;
+
+  explicit ShowSaver(const std::string &filename, Format format = TEXT);
   ~ShowSaver();
 
   bool Open();
@@ -42,11 +51,38 @@ class ShowSaver {
                 unsigned int universe,
                 const ola::DmxBuffer &data);
 
+  static bool FormatFromString(const std::string &value, Format *format);
+
  private:
+  typedef std::map<unsigned int, ola::DmxBuffer> UniverseMap;
+  // time, file offset
+  typedef std::vector<std::pair<unsigned int, uint64_t> > Index;
+
   const std::string m_filename;
+  const Format m_format;
   std::ofstream m_show_file;
+  std::vector<char> m_write_buffer;
   ola::TimeStamp m_last_frame;
 
+  // The binary format state
+  ola::TimeStamp m_first_frame;
+  uint64_t m_offset;
+  UniverseMap m_universe_data;
+  Index m_index;
+  std::vector<uint8_t> m_record;
+
+  bool NewBinaryFrame(unsigned int time, unsigned int universe,
+                      const ola::DmxBuffer &data);
+  unsigned int EncodeDelta(const ola::DmxBuffer &old_data,
+                           const ola::DmxBuffer &data,
+                           uint8_t *payload);
+  void WriteSnapshot(unsigned int time);
+  void WriteRecord(uint8_t type, unsigned int time, unsigned int universe,
+                   unsigned int size, unsigned int length);
+  void WriteIndex();
+
   static const char OLA_SHOW_HEADER[];
+  static const char OLA_BINARY_SHOW_HEADER[];
+  static const unsigned int WRITE_BUFFER_SIZE = 1 << 16;
 };
 #endif  // EXAMPLES_SHOWSAVER_H_
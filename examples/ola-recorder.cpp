@@ -19,6 +19,7 @@
  */
 
 #include <ola/Callback.h>
+#include <ola/Clock.h>
 #include <ola/DmxBuffer.h>
 #include <ola/Logging.h>
 #include <ola/StringUtils.h>
@@ -26,6 +27,7 @@
 #include <ola/base/Init.h>
 #include <ola/base/SysExits.h>
 #include <ola/thread/SignalThread.h>
+#include <ola/timecode/TimeCodeEnums.h>
 #include <signal.h>
 #include <iostream>
 #include <map>
@@ -36,6 +38,7 @@
 #include "examples/ShowPlayer.h"
 #include "examples/ShowLoader.h"
 #include "examples/ShowRecorder.h"
+#include "examples/ShowSaver.h"
 
 using std::auto_ptr;
 using std::cout;
@@ -47,6 +50,11 @@ using std::string;
 DEFINE_s_string(playback, p, "", "The show file to playback.");
 DEFINE_s_string(record, r, "", "The show file to record data to.");
 DEFINE_string(verify, "", "The show file to verify.");
+DEFINE_string(convert, "",
+              "The show file to convert, the result is written to the file "
+              "given by --record.");
+DEFINE_string(format, "text",
+              "The format to record or convert to, binary or text.");
 DEFINE_s_string(universes, u, "",
                 "A comma separated list of universes to record");
 DEFINE_s_uint32(delay, d, 0, "The delay in ms between successive iterations.");
@@ -54,11 +62,74 @@ DEFINE_uint32(duration, 0, "The length of time (seconds) to run for.");
 // 0 means infinite looping
 DEFINE_s_uint32(iterations, i, 1,
                 "The number of times to repeat the show, 0 means unlimited.");
+DEFINE_uint32(start, 0,
+              "The time in ms into the show to start playback from.");
+DEFINE_uint32(stop, 0,
+              "The time in ms into the show to stop playback at, 0 means the "
+              "end of the show. Each iteration plays from --start to --stop.");
+DEFINE_default_bool(chase_timecode, false,
+                    "Lock playback to timecode read from stdin, one "
+                    "Hours:Minutes:Seconds:Frames value per line.");
+DEFINE_string(timecode_format, "SMPTE",
+              "The timecode read from stdin, one of FILM, EBU, DF, SMPTE "
+              "(default).");
+DEFINE_uint32(timecode_offset, 0,
+              "The timecode, in ms, which corresponds to the start of the "
+              "show.");
+DEFINE_default_bool(timing, false,
+                    "Print the number of frames sent and how late they were "
+                    "once playback ends.");
 
 void TerminateRecorder(ShowRecorder *recorder) {
   recorder->Stop();
 }
 
+ShowSaver::Format RecordFormat() {
+  ShowSaver::Format format;
+  if (!ShowSaver::FormatFromString(FLAGS_format.str(), &format)) {
+    OLA_FATAL << "Unknown format " << FLAGS_format.str()
+              << ", expected binary or text";
+    exit(ola::EXIT_USAGE);
+  }
+  return format;
+}
+
+/**
+ * Playback a show
+ */
+int PlaybackShow() {
+  ola::timecode::TimeCodeType time_code_type = ola::timecode::TIMECODE_SMPTE;
+  string type = FLAGS_timecode_format;
+  ola::ToLower(&type);
+  if (type == "film") {
+    time_code_type = ola::timecode::TIMECODE_FILM;
+  } else if (type == "ebu") {
+    time_code_type = ola::timecode::TIMECODE_EBU;
+  } else if (type == "df") {
+    time_code_type = ola::timecode::TIMECODE_DF;
+  } else if (type == "smpte") {
+    time_code_type = ola::timecode::TIMECODE_SMPTE;
+  } else {
+    OLA_FATAL << "Invalid timecode format " << FLAGS_timecode_format.str();
+    exit(ola::EXIT_USAGE);
+  }
+
+  ShowPlayer player(FLAGS_playback.str());
+  int status = player.Init();
+  if (status)
+    return status;
+
+  if (FLAGS_chase_timecode) {
+    player.ChaseTimeCode(time_code_type, FLAGS_timecode_offset);
+  }
+  status = player.Playback(FLAGS_iterations, FLAGS_duration, FLAGS_delay,
+                           FLAGS_start, FLAGS_stop);
+  if (FLAGS_timing) {
+    player.PrintTiming(&cout);
+  }
+  return status;
+}
+
 /**
  * Record a show
  */
@@ -81,7 +152,7 @@ int RecordShow() {
     universes.push_back(universe);
   }
 
-  ShowRecorder show_recorder(FLAGS_record.str(), universes);
+  ShowRecorder show_recorder(FLAGS_record.str(), universes, RecordFormat());
   int status = show_recorder.Init();
   if (status)
     return status;
@@ -103,6 +174,47 @@ int RecordShow() {
 }
 
 
+/**
+ * Convert a show file to another format.
+ */
+int ConvertShow(const string &input, const string &output) {
+  ShowLoader loader(input);
+  if (!loader.Load())
+    return ola::EXIT_NOINPUT;
+
+  ShowSaver saver(output, RecordFormat());
+  if (!saver.Open())
+    return ola::EXIT_CANTCREAT;
+
+  // Only the differences between the frame times matter.
+  ola::Clock clock;
+  ola::TimeStamp start;
+  clock.CurrentTime(&start);
+
+  uint64_t frames = 0;
+  unsigned int universe;
+  ola::DmxBuffer buffer;
+  ShowLoader::State state;
+  while ((state = loader.NextFrame(&universe, &buffer)) == ShowLoader::OK) {
+    const ola::TimeStamp arrival_time = start + ola::TimeInterval(
+        static_cast<int64_t>(loader.Position()) * 1000);
+    if (!saver.NewFrame(arrival_time, universe, buffer)) {
+      OLA_FATAL << "Failed to write to " << output;
+      return ola::EXIT_IOERR;
+    }
+    frames++;
+  }
+  saver.Close();
+
+  if (state != ShowLoader::END_OF_FILE) {
+    OLA_FATAL << "Error loading show, got state " << state;
+    return ola::EXIT_DATAERR;
+  }
+  cout << "Converted " << frames << " frames" << endl;
+  return ola::EXIT_OK;
+}
+
+
 /**
  * Verify a show file is valid
  */
@@ -133,6 +245,7 @@ int VerifyShow(const string &filename) {
   map<unsigned int, unsigned int>::const_iterator iter;
   unsigned int total = 0;
   cout << "------------ Summary ----------" << endl;
+  cout << "Format: " << (loader.IsBinary() ? "binary" : "text") << endl;
   for (iter = frames_by_universe.begin(); iter != frames_by_universe.end();
        ++iter) {
     cout << "Universe " << iter->first << ": " << iter->second << " frames" <<
@@ -157,16 +270,18 @@ int VerifyShow(const string &filename) {
 int main(int argc, char *argv[]) {
   ola::AppInit(&argc, argv,
                "[--record <file> --universes <universe_list>] [--playback "
-               "<file>] [--verify <file>]",
+               "<file>] [--verify <file>] [--convert <file> --record <file>]",
                "Record a series of universes, or playback a previously "
                "recorded show.");
 
   if (!FLAGS_playback.str().empty()) {
-    ShowPlayer player(FLAGS_playback.str());
-    int status = player.Init();
-    if (!status)
-      status = player.Playback(FLAGS_iterations, FLAGS_duration, FLAGS_delay);
-    return status;
+    return PlaybackShow();
+  } else if (!FLAGS_convert.str().empty()) {
+    if (FLAGS_record.str().empty()) {
+      OLA_FATAL << "--convert requires --record";
+      exit(ola::EXIT_USAGE);
+    }
+    return ConvertShow(FLAGS_convert.str(), FLAGS_record.str());
   } else if (!FLAGS_record.str().empty()) {
     return RecordShow();
   } else if (!FLAGS_verify.str().empty()) {
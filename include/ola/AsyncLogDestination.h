@@ -0,0 +1,128 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * AsyncLogDestination.h
+ * A LogDestination that writes from a background thread.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+/**
+ * @addtogroup logging
+ * @{
+ * @file AsyncLogDestination.h
+ * @brief A LogDestination that writes from a background thread.
+ * @}
+ */
+
+#ifndef INCLUDE_OLA_ASYNCLOGDESTINATION_H_
+#define INCLUDE_OLA_ASYNCLOGDESTINATION_H_
+
+#include <ola/ExportMap.h>
+#include <ola/Logging.h>
+#include <ola/base/Macro.h>
+#include <ola/thread/Mutex.h>
+#include <stdint.h>
+
+#include <string>
+
+namespace ola {
+
+/**
+ * @addtogroup logging
+ * @{
+ */
+
+/**
+ * @class AsyncLogDestination
+ * @brief A LogDestination that hands lines to a background thread, which
+ *   writes them to another LogDestination.
+ *
+ * Writing to stderr or syslog can block, and log lines are usually produced
+ * by the SelectServer thread. Lines are copied into a fixed size ring, which
+ * any number of threads can add to without taking a lock. If the ring is full
+ * the line is dropped, the number of dropped lines is logged and published in
+ * the ExportMap.
+ *
+ * Lines longer than MAX_LINE_LENGTH are truncated.
+ */
+class AsyncLogDestination: public LogDestination {
+ public:
+  /**
+   * @brief Create a new AsyncLogDestination.
+   * @param destination the LogDestination to write to, ownership is
+   *   transferred.
+   * @param export_map the ExportMap to publish the drop count to, may be NULL.
+   * @param capacity the number of lines the ring holds, this is rounded up to
+   *   a power of two.
+   */
+  explicit AsyncLogDestination(LogDestination *destination,
+                               ExportMap *export_map = NULL,
+                               unsigned int capacity = DEFAULT_CAPACITY);
+
+  /**
+   * @brief Destructor.
+   *
+   * This writes any remaining lines before returning.
+   */
+  ~AsyncLogDestination();
+
+  /**
+   * @brief Start the background thread.
+   * @returns true if the thread started, false otherwise.
+   */
+  bool Init();
+
+  /**
+   * @brief Queue a line to be written.
+   */
+  void Write(log_level level, const std::string &log_line);
+
+  static const unsigned int DEFAULT_CAPACITY = 1024;
+  static const unsigned int MAX_LINE_LENGTH = 512;
+
+  static const char K_LOG_DROPPED_VAR[];
+
+ private:
+  struct Slot;
+  class DrainThread;
+
+  LogDestination *m_destination;
+  CounterVariable *m_dropped_var;
+  DrainThread *m_thread;
+
+  Slot *m_slots;
+  unsigned int m_mask;
+  uint32_t m_enqueue_pos;  // shared by all writers
+  uint32_t m_dequeue_pos;  // only used by the drain thread
+  uint32_t m_dropped;  // dropped since the drain thread last checked
+  std::string m_line;  // reused by the drain thread
+
+  // Used to wake the drain thread when it's idle.
+  ola::thread::Mutex m_mutex;
+  ola::thread::ConditionVariable m_condition;
+  uint32_t m_drain_waiting;
+  bool m_exit;
+
+  bool Push(log_level level, const std::string &log_line);
+  bool Pop();
+  bool Empty() const;
+  void PublishDrops();
+  void Drain();
+
+  DISALLOW_COPY_AND_ASSIGN(AsyncLogDestination);
+};
+/**@}*/
+}  // namespace ola
+#endif  // INCLUDE_OLA_ASYNCLOGDESTINATION_H_
@@ -236,6 +236,20 @@ class Clock {
   virtual ~Clock() {}
   virtual void CurrentTime(TimeStamp *timestamp) const;
 
+  /**
+   * @brief Get the time from a clock which never goes backwards.
+   * @param timestamp set to the current monotonic time.
+   *
+   * Unlike CurrentTime(), this isn't affected by changes to the system time,
+   * so it's the one to use when scheduling against a timeline. The value is
+   * only meaningful when compared to other monotonic times. If the platform
+   * doesn't have a monotonic clock this is the same as CurrentTime().
+   *
+   * This isn't virtual, to keep the libola ABI. A MockClock only returns the
+   * mock time when this is called through the MockClock type.
+   */
+  void CurrentMonotonicTime(TimeStamp *timestamp) const;
+
  private:
   DISALLOW_COPY_AND_ASSIGN(Clock);
 };
@@ -253,6 +267,8 @@ class MockClock: public Clock {
   void AdvanceTime(int32_t sec, int32_t usec);
 
   void CurrentTime(TimeStamp *timestamp) const;
+  // Hides Clock::CurrentMonotonicTime(), so call this on the MockClock.
+  void CurrentMonotonicTime(TimeStamp *timestamp) const;
 
  private:
   TimeInterval m_offset;
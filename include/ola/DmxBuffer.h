@@ -117,6 +117,21 @@ class DmxBuffer {
      */
     bool HTPMerge(const DmxBuffer &other);
 
+    /**
+     * @brief Set the contents of this DmxBuffer to the HTP merge of a set of
+     * buffers.
+     * This merges all the buffers in a single pass, which is much faster than
+     * calling HTPMerge() once per buffer when there are many sources.
+     * @param sources an array of pointers to the DmxBuffers to merge. Sources
+     *   without any data are ignored.
+     * @param source_count the number of entries in sources.
+     * @return true if the merge was successful, false if it failed
+     * @pre this buffer is not one of the sources.
+     * @post Size() is the size of the largest source.
+     */
+    bool SetFromHTPMerge(const DmxBuffer *const *sources,
+                         unsigned int source_count);
+
     /**
      * @brief Set the contents of this DmxBuffer
      * @param data is a pointer to an array of uint8_t values
@@ -265,6 +280,8 @@ class DmxBuffer {
     std::string ToString() const;
 
  private:
+    static const unsigned int MAX_SOURCES_PER_PASS = 32;
+
     bool Init();
     bool DuplicateIfNeeded();
     void CopyFromOther(const DmxBuffer &other);
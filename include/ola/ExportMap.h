@@ -209,6 +209,18 @@ class MapVariable: public BaseVariable {
   void Remove(const std::string &key);
   void Set(const std::string &key, Type value);
   Type &operator[](const std::string &key);
+
+  /**
+   * @brief Lookup or create the value for a key.
+   * @param key the key to lookup.
+   * @returns a pointer to the value, which remains valid until the key is
+   *   removed.
+   *
+   * Values that are updated frequently should be resolved once with this,
+   * rather than looking up the key on each update.
+   */
+  Type *Handle(const std::string &key);
+
   const std::string Value() const;
   const std::string Label() const { return m_label; }
 
@@ -260,6 +272,17 @@ Type &MapVariable<Type>::operator[](const std::string &key) {
 }
 
 
+/*
+ * Return a pointer to the value for key, creating the entry if it doesn't
+ * exist. Entries in a std::map don't move, so the pointer stays valid until
+ * the key is removed.
+ */
+template<typename Type>
+Type *MapVariable<Type>::Handle(const std::string &key) {
+  return &m_variables[key];
+}
+
+
 /*
  * Set a value in the Map variable.
  */
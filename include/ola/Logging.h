@@ -57,7 +57,8 @@
  * @param level the log_level to log at.
  */
 #define OLA_LOG(level) (level <= ola::LogLevel()) && \
-                        ola::LogLine(__FILE__, __LINE__, level).stream()
+    (!ola::log_rate_limit || ola::LogRateCheck(__FILE__, __LINE__, level)) && \
+    ola::LogLine(__FILE__, __LINE__, level).stream()
 /**
  * Provide a stream to log a fatal message. e.g.
  * @code
@@ -92,6 +93,8 @@
 
 namespace ola {
 
+class ExportMap;
+
 /**
  * @brief The OLA log levels.
  * This controls the verbosity of logging. Each level also includes those below
@@ -112,6 +115,13 @@ enum log_level {
  */
 extern log_level logging_level;
 
+/**
+ * @private
+ * @brief The maximum number of lines per second from each log statement, 0 if
+ * there is no limit.
+ */
+extern unsigned int log_rate_limit;
+
 /**
  * @brief The destination to write log messages to
  */
@@ -223,12 +233,24 @@ class LogLine {
   ~LogLine();
   void Write();
 
-  std::ostream &stream() { return m_stream; }
+  std::ostream &stream() { return *m_stream; }
  private:
   log_level m_level;
-  std::ostringstream m_stream;
+  // This is the thread's reusable stream, unless the thread is already
+  // building a line, in which case it's owned by us.
+  std::ostringstream *m_stream;
+  bool m_thread_stream;
   unsigned int m_prefix_length;
 };
+
+/**
+ * @brief Check if a log statement is within the rate limit.
+ * @param file the file containing the statement.
+ * @param line the line of the statement.
+ * @param level the log level of the statement.
+ * @returns true if the line should be logged.
+ */
+bool LogRateCheck(const char *file, int line, log_level level);
 /**@endcond*/
 
 /**
@@ -253,6 +275,16 @@ inline log_level LogLevel() { return logging_level; }
  */
 void IncrementLogLevel();
 
+/**
+ * @brief Limit the rate of logging from each log statement.
+ * @param lines_per_second the maximum number of lines per second from each
+ *   OLA_* statement, or 0 for no limit.
+ *
+ * Lines over the limit are discarded, and a count of them is logged when the
+ * statement is next allowed to log.
+ */
+void SetLogRateLimit(unsigned int lines_per_second);
+
 /**
  * @brief Initialize the OLA logging system from flags.
  * @pre ParseFlags() must have been called before calling this.
@@ -260,6 +292,27 @@ void IncrementLogLevel();
  */
 bool InitLoggingFromFlags();
 
+/**
+ * @brief Move the writing of log lines to a background thread, if the
+ *   --async-log flag was set.
+ * @param export_map an ExportMap to publish the logging stats to, may be NULL.
+ * @pre InitLoggingFromFlags() must have been called before calling this.
+ *
+ * The thread doesn't survive a fork(), so this must be called after
+ * Daemonise().
+ */
+void InitAsyncLoggingFromFlags(ExportMap *export_map);
+
+/**
+ * @brief Stop the logging thread started by InitAsyncLoggingFromFlags().
+ *
+ * Any queued lines are written, and logging goes back to the destination
+ * from the flags. This should be called during shutdown, before the ExportMap
+ * passed to InitAsyncLoggingFromFlags() is destroyed. It does nothing if the
+ * logging thread isn't running.
+ */
+void StopAsyncLogging();
+
 /**
  * @brief Initialize the OLA logging system
  * @param level the level to log at
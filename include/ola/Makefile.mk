@@ -27,6 +27,7 @@ dist_noinst_SCRIPTS += \
 
 pkginclude_HEADERS += \
     include/ola/ActionQueue.h \
+    include/ola/AsyncLogDestination.h \
     include/ola/BaseTypes.h \
     include/ola/Callback.h \
     include/ola/CallbackRunner.h \
@@ -248,6 +248,22 @@ class OlaClient {
                const DmxBuffer &data,
                const SendDMXArgs &args);
 
+  /**
+   * @brief Start a batch of calls.
+   *
+   * Calls made before the matching EndBatch() are held back and written to
+   * the server together, which is cheaper than writing each one on its own.
+   * This is useful when sending DMX for several universes at once.
+   */
+  void BeginBatch();
+
+  /**
+   * @brief Send the calls made since BeginBatch().
+   * @returns false if the calls couldn't be written to the server, in which
+   *   case the connection is closed.
+   */
+  bool EndBatch();
+
   /**
    * @brief Fetch the latest DMX data for a universe.
    * @param universe the universe id to get data for.
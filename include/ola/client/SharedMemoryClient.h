@@ -0,0 +1,131 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * SharedMemoryClient.h
+ * Send DMX data to olad using shared memory.
+ * Copyright (C) 2026 Simon Newton
+ */
+/**
+ * @file
+ * @brief A client for sending DMX512 data to an olad on the same host.
+ */
+
+#ifndef INCLUDE_OLA_CLIENT_SHAREDMEMORYCLIENT_H_
+#define INCLUDE_OLA_CLIENT_SHAREDMEMORYCLIENT_H_
+
+#include <ola/Clock.h>
+#include <ola/Constants.h>
+#include <ola/DmxBuffer.h>
+#include <ola/base/Macro.h>
+#include <ola/client/StreamingClient.h>
+#include <map>
+#include <memory>
+
+namespace ola {
+
+namespace dmx { class SharedDmxRegion; }
+namespace network { class UDPSocket; }
+
+namespace client {
+
+/**
+ * @class SharedMemoryClient ola/client/SharedMemoryClient.h
+ * @brief Send DMX512 data to olad using shared memory.
+ *
+ * SharedMemoryClient writes DMX512 data directly into a shared memory region
+ * that olad reads from. There is no serialization and, when sending many
+ * universes in quick succession, olad is woken at most once per batch. It's
+ * best suited to producers on the same host as olad that update many
+ * universes at a high rate.
+ *
+ * olad must be started with the --shared-memory flag. Only the most recent
+ * frame for each universe is delivered, and data for universes that don't
+ * exist in olad is ignored.
+ */
+class SharedMemoryClient : public StreamingClientInterface {
+ public:
+  /**
+   * Controls the options for the SharedMemoryClient class.
+   */
+  class Options {
+   public:
+    Options()
+        : server_port(OLA_DEFAULT_PORT) {
+    }
+
+    /**
+     * The RPC port olad is listening on. This identifies the olad instance.
+     */
+    uint16_t server_port;
+  };
+
+  /**
+   * Create a new SharedMemoryClient.
+   * @param options an Options structure.
+   */
+  explicit SharedMemoryClient(const Options &options = Options());
+
+  /**
+   * Destructor.
+   */
+  ~SharedMemoryClient();
+
+  /**
+   * Open the shared memory region used by olad.
+   * @returns true if the region was opened, false if olad isn't running or
+   *   doesn't have shared memory enabled.
+   */
+  bool Setup();
+
+  /**
+   * Close the shared memory region.
+   */
+  void Stop();
+
+  /**
+   * Send a DmxBuffer to the olad server.
+   * @param universe the universe to send on.
+   * @param data the DMX512 data.
+   * @returns true if sent sucessfully, false if the region is closed or
+   *   full.
+   */
+  bool SendDmx(unsigned int universe, const DmxBuffer &data);
+
+  /**
+   * @brief Send DMX data.
+   * @param universe the universe to send to.
+   * @param data the DmxBuffer with the data
+   * @param args the SendDMXArgs to use for this call.
+   */
+  bool SendDMX(unsigned int universe,
+               const DmxBuffer &data,
+               const SendArgs &args);
+
+ private:
+  typedef std::map<unsigned int, int> SlotMap;
+
+  const uint16_t m_server_port;
+  std::auto_ptr<ola::dmx::SharedDmxRegion> m_region;
+  std::auto_ptr<ola::network::UDPSocket> m_doorbell;
+  SlotMap m_slots;
+  Clock m_clock;
+
+  void RingDoorbell();
+
+  DISALLOW_COPY_AND_ASSIGN(SharedMemoryClient);
+};
+}  // namespace client
+}  // namespace ola
+#endif  // INCLUDE_OLA_CLIENT_SHAREDMEMORYCLIENT_H_
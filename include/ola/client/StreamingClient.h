@@ -30,6 +30,12 @@
 #include <ola/base/Macro.h>
 #include <ola/dmx/SourcePriorities.h>
 
+namespace google {
+namespace protobuf {
+class MethodDescriptor;
+}
+}
+
 namespace ola {
 
 namespace io { class SelectServer; }
@@ -97,7 +103,11 @@ class StreamingClient : public StreamingClientInterface {
      * Create a new options structure with the default options. This
      * includes automatically starting olad if it's not already running.
      */
-    Options() : auto_start(true), server_port(OLA_DEFAULT_PORT) {}
+    Options()
+        : auto_start(true),
+          server_port(OLA_DEFAULT_PORT),
+          binary_stream(false) {
+    }
 
     /**
      * If true, the client will automatically start olad if it's not
@@ -109,6 +119,14 @@ class StreamingClient : public StreamingClientInterface {
      * The RPC port olad is listening on.
      */
     uint16_t server_port;
+
+    /**
+     * If true, DMX data is sent as compact binary frames rather than RPCs,
+     * provided olad supports it. This reduces the per-frame overhead when
+     * sending many universes at a high rate. Since olad isn't polled before
+     * each send, a closed connection is only detected once a send fails.
+     */
+    bool binary_stream;
   };
 
   /**
@@ -166,16 +184,31 @@ class StreamingClient : public StreamingClientInterface {
 
   void ChannelClosed(ola::rpc::RpcSession *session);
 
+  /**
+   * @brief Check if DMX data is being sent as binary frames.
+   * @returns true if a binary stream was requested and olad supports it.
+   */
+  bool BinaryStreamEnabled() const { return m_binary_stream; }
+
  private:
   bool m_auto_start;
   uint16_t m_server_port;
+  bool m_request_binary_stream;
+  bool m_binary_stream;
   ola::network::TCPSocket *m_socket;
   ola::io::SelectServer *m_ss;
   class ola::rpc::RpcChannel *m_channel;
   class ola::proto::OlaServerService_Stub *m_stub;
+  const google::protobuf::MethodDescriptor *m_stream_dmx_method;
   bool m_socket_closed;
 
   bool Send(unsigned int universe, uint8_t priority, const DmxBuffer &data);
+  bool SendBinary(unsigned int universe, uint8_t priority,
+                  const DmxBuffer &data);
+  bool NegotiateBinaryStream();
+  void BinaryStreamReply(bool *complete);
+
+  static const unsigned int BINARY_STREAM_TIMEOUT_MS = 2000;
 
   DISALLOW_COPY_AND_ASSIGN(StreamingClient);
 };
@@ -0,0 +1,225 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * FrameScheduler.h
+ * Generates the DMX512 frame timing for serial outputs.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+/**
+ * @file FrameScheduler.h
+ * @brief Generates the DMX512 frame timing for serial outputs, where the host
+ * has to produce the break and mark after break itself.
+ */
+
+#ifndef INCLUDE_OLA_DMX_FRAMESCHEDULER_H_
+#define INCLUDE_OLA_DMX_FRAMESCHEDULER_H_
+
+#include <stdint.h>
+#include <ola/DmxBuffer.h>
+#include <ola/ExportMap.h>
+#include <ola/base/Macro.h>
+#include <ola/thread/Mutex.h>
+#include <ola/thread/Thread.h>
+#include <string>
+#include <vector>
+
+namespace ola {
+namespace dmx {
+
+/**
+ * @brief A serial line that the FrameScheduler drives.
+ */
+class SerialDmxOutput {
+ public:
+  virtual ~SerialDmxOutput() {}
+
+  /**
+   * @brief Start or end the break.
+   * @param on true to start the break, false to end it.
+   * @returns true if the line state was changed.
+   */
+  virtual bool SetBreak(bool on) = 0;
+
+  /**
+   * @brief Write the start code and DMX data.
+   * @param buffer the DMX data.
+   * @returns true if the data was written.
+   */
+  virtual bool Write(const DmxBuffer &buffer) = 0;
+};
+
+/**
+ * @brief Generates the DMX512 frame timing for many serial outputs from a
+ * single thread.
+ *
+ * Each port cycles through break, mark after break and data. The thread
+ * sleeps until the next port is due using an absolute deadline on the
+ * monotonic clock, so the frame rate doesn't drift and the thread doesn't
+ * spin between frames.
+ *
+ * Writes can block for as long as the data takes to send, so each port has
+ * a writer thread that the data is handed to after the mark after break.
+ * The break and mark after break times are minimums. The lateness of the
+ * start of each frame is recorded in a per-port histogram in the ExportMap.
+ */
+class FrameScheduler: public ola::thread::Thread {
+ public:
+  /**
+   * @brief Options for the scheduling thread.
+   */
+  struct Options {
+    /**
+     * @brief The SCHED_FIFO priority of the thread, or 0 to use the default
+     *   scheduling policy.
+     */
+    unsigned int realtime_priority;
+
+    /**
+     * @brief The CPU to run the thread on, or -1 to let the OS choose.
+     */
+    int cpu;
+
+    Options() : realtime_priority(0), cpu(-1) {}
+  };
+
+  /**
+   * @brief The timing for a port, in microseconds.
+   */
+  struct PortOptions {
+    /**
+     * @brief The name of the port, used as the key in the ExportMap.
+     */
+    std::string name;
+
+    /**
+     * @brief The break time, defaults to 110uS.
+     */
+    unsigned int break_time;
+
+    /**
+     * @brief The mark after break time, defaults to 16uS.
+     */
+    unsigned int mab_time;
+
+    /**
+     * @brief The minimum time from the end of the data to the next break.
+     *
+     * The scheduler assumes the data is sent at 250kbps from when Write()
+     * returns.
+     */
+    unsigned int mark_after_frame;
+
+    /**
+     * @brief The frames per second, or 0 to send the next frame as soon as
+     *   the timing allows.
+     */
+    unsigned int refresh_rate;
+
+    PortOptions()
+        : break_time(DEFAULT_BREAK_TIME),
+          mab_time(DEFAULT_MAB_TIME),
+          mark_after_frame(0),
+          refresh_rate(0) {}
+  };
+
+  class Port;
+
+  /**
+   * @brief Create a new FrameScheduler.
+   * @param options the Options for the thread.
+   * @param export_map the ExportMap to publish the stats to, may be NULL.
+   */
+  FrameScheduler(const Options &options, ExportMap *export_map);
+
+  /**
+   * @brief Destructor, this stops the thread.
+   * @pre All ports have been removed.
+   */
+  ~FrameScheduler();
+
+  /**
+   * @brief Stop the thread.
+   * @returns true if the thread was stopped.
+   */
+  bool Stop();
+
+  /**
+   * @brief Start generating frames for a serial output.
+   * @param output the SerialDmxOutput to use, ownership isn't transferred.
+   * @param options the timing for the port.
+   * @returns the new Port, which is valid until it's passed to RemovePort().
+   *
+   * Frames start once the first DMX data is written.
+   */
+  Port *AddPort(SerialDmxOutput *output, const PortOptions &options);
+
+  /**
+   * @brief Stop generating frames for a port.
+   * @param port the Port to remove, this is deleted.
+   *
+   * This waits for any call to the SerialDmxOutput that is in progress,
+   * including a write from the port's writer thread. If the port is in the
+   * break, the break is ended so the line is left idle, even though the frame
+   * is incomplete. After this returns the SerialDmxOutput won't be used
+   * again.
+   */
+  void RemovePort(Port *port);
+
+  /**
+   * @brief Set the data for the following frames of a port.
+   * @param port the Port to update.
+   * @param buffer the new DMX data.
+   */
+  void WriteDMX(Port *port, const DmxBuffer &buffer);
+
+  /**
+   * @private
+   */
+  void *Run();
+
+  static const unsigned int DEFAULT_BREAK_TIME = 110;
+  static const unsigned int DEFAULT_MAB_TIME = 16;
+
+  static const char K_FRAME_VAR[];
+  static const char K_JITTER_VAR_PREFIX[];
+
+ private:
+  class PortWriter;
+  typedef std::vector<Port*> PortList;
+
+  const Options m_options;
+  ExportMap *m_export_map;
+
+  // Held while the thread runs a port's events, so RemovePort() can wait for
+  // the port to finish.
+  ola::thread::Mutex m_mutex;
+  PortList m_ports;
+  bool m_exit;
+
+  void ConfigureThread();
+  void RunEvent(Port *port, int64_t now);
+
+  static int64_t Now();
+  static void SleepUntil(int64_t deadline);
+
+  static const unsigned int MAX_SLEEP = 100000;
+  static const unsigned int WRITE_POLL_INTERVAL = 250;
+
+  DISALLOW_COPY_AND_ASSIGN(FrameScheduler);
+};
+}  // namespace dmx
+}  // namespace ola
+#endif  // INCLUDE_OLA_DMX_FRAMESCHEDULER_H_
@@ -0,0 +1,100 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * HTPMerge.h
+ * N-way HTP merge kernels.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+/**
+ * @file HTPMerge.h
+ * @brief Highest-takes-precedence merging of multiple DMX frames in a single
+ * pass.
+ *
+ * The merge is performed with the widest vector unit available on the host.
+ * The implementation is selected at runtime the first time a merge is
+ * performed, with a scalar version used as the fallback.
+ */
+
+#ifndef INCLUDE_OLA_DMX_HTPMERGE_H_
+#define INCLUDE_OLA_DMX_HTPMERGE_H_
+
+#include <stdint.h>
+
+namespace ola {
+namespace dmx {
+
+/**
+ * @brief The HTP merge kernel implementations.
+ */
+typedef enum {
+  HTP_MERGE_SCALAR,  /**< Portable C++ loop */
+  HTP_MERGE_SSE2,  /**< 16 slots at a time using SSE2 */
+  HTP_MERGE_AVX2,  /**< 32 slots at a time using AVX2 */
+  HTP_MERGE_NEON,  /**< 16 slots at a time using ARM NEON */
+} HTPMergeKernel;
+
+/**
+ * @brief HTP merge slots from a number of sources.
+ * @param sources an array of pointers to the slot data to merge. Each source
+ *   must hold at least length slots.
+ * @param source_count the number of entries in sources.
+ * @param length the number of slots to merge.
+ * @param[out] output where to store the merged data, must hold at least length
+ *   slots. output may be the same as one of the sources.
+ *
+ * If source_count is 0, output is left untouched.
+ */
+void HTPMergeSlots(const uint8_t *const *sources,
+                   unsigned int source_count,
+                   unsigned int length,
+                   uint8_t *output);
+
+/**
+ * @brief HTP merge slots using a specific kernel.
+ * @param kernel the kernel to use, this must be supported by the host.
+ * @param sources an array of pointers to the slot data to merge.
+ * @param source_count the number of entries in sources.
+ * @param length the number of slots to merge.
+ * @param[out] output where to store the merged data.
+ *
+ * This is used by the tests and benchmarks, everything else should use
+ * HTPMergeSlots().
+ */
+void HTPMergeSlotsWithKernel(HTPMergeKernel kernel,
+                             const uint8_t *const *sources,
+                             unsigned int source_count,
+                             unsigned int length,
+                             uint8_t *output);
+
+/**
+ * @brief Check if a kernel can run on this host.
+ * @param kernel the kernel to check.
+ * @returns true if the kernel was compiled in and the CPU supports it.
+ */
+bool HTPMergeKernelSupported(HTPMergeKernel kernel);
+
+/**
+ * @brief Return the kernel HTPMergeSlots() uses.
+ */
+HTPMergeKernel ActiveHTPMergeKernel();
+
+/**
+ * @brief Return the name of a kernel, used for logging.
+ */
+const char *HTPMergeKernelName(HTPMergeKernel kernel);
+}  // namespace dmx
+}  // namespace ola
+#endif  // INCLUDE_OLA_DMX_HTPMERGE_H_
@@ -1,4 +1,7 @@
 oladmxincludedir = $(pkgincludedir)/dmx/
 oladmxinclude_HEADERS = \
+    include/ola/dmx/FrameScheduler.h \
+    include/ola/dmx/HTPMerge.h \
     include/ola/dmx/RunLengthEncoder.h \
+    include/ola/dmx/SharedDmxRegion.h \
     include/ola/dmx/SourcePriorities.h
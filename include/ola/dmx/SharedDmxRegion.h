@@ -0,0 +1,241 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * SharedDmxRegion.h
+ * A shared memory region holding the latest DMX frame for many universes.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+/**
+ * @file SharedDmxRegion.h
+ * @brief A shared memory region used to pass DMX data between processes on
+ * the same host.
+ */
+
+#ifndef INCLUDE_OLA_DMX_SHAREDDMXREGION_H_
+#define INCLUDE_OLA_DMX_SHAREDDMXREGION_H_
+
+#include <stdint.h>
+#include <ola/Clock.h>
+#include <ola/Constants.h>
+#include <ola/DmxBuffer.h>
+#include <ola/base/Macro.h>
+#include <string>
+
+class SharedDmxRegionTest;
+
+namespace ola {
+namespace dmx {
+
+/**
+ * @brief A consistent copy of one slot in a SharedDmxRegion.
+ */
+struct SharedDmxFrame {
+  unsigned int universe;  //!< the universe the data belongs to
+  uint8_t priority;  //!< the priority of the data
+  TimeStamp timestamp;  //!< when the writer stored the data
+  unsigned int length;  //!< the number of valid bytes in data
+  int32_t writer;  //!< the pid of the process that wrote the data
+  uint8_t data[DMX_UNIVERSE_SIZE];  //!< the DMX512 data
+};
+
+/**
+ * @brief A shared memory region holding the latest DMX frame for many
+ * universes.
+ *
+ * The region is created by olad and opened by clients on the same host. It
+ * contains a fixed number of slots; each slot is claimed by a universe the
+ * first time data is written for it and holds the most recent frame,
+ * priority and timestamp for that universe. Older frames are overwritten, so
+ * a reader only ever sees the latest data.
+ *
+ * Each slot is protected by a sequence lock. Writers make the sequence number
+ * odd while updating the slot, and readers copy the slot and retry if the
+ * sequence number changed during the copy. Neither side takes a lock or makes
+ * a system call, and many writers may share the region.
+ *
+ * The region also holds a doorbell flag. A writer sets the flag after
+ * updating one or more slots, and only needs to wake the reader if the flag
+ * was previously clear. The reader clears the flag before it scans the slots.
+ * If the wake up is lost the flag stays set and later writers won't wake the
+ * reader, so the reader should also clear the flag and scan periodically.
+ *
+ * Each slot records the pid of the process that last locked it. A writer that
+ * exits part way through Write() leaves the slot locked. The reader should
+ * call RecoverSlot() on each slot when it does the periodic scan, to unlock
+ * slots whose writer has exited.
+ */
+class SharedDmxRegion {
+ public:
+  ~SharedDmxRegion();
+
+  /**
+   * @brief Create a new region, replacing any stale region with the same
+   *   name.
+   * @param name the name of the region, see NameForPort().
+   * @param slot_count the maximum number of universes the region can hold.
+   * @returns a new SharedDmxRegion or NULL if the region couldn't be created.
+   *   The region is removed when the returned object is deleted.
+   */
+  static SharedDmxRegion* Create(const std::string &name,
+                                 unsigned int slot_count);
+
+  /**
+   * @brief Open an existing region.
+   * @param name the name of the region, see NameForPort().
+   * @returns a new SharedDmxRegion or NULL if the region doesn't exist or
+   *   isn't valid.
+   */
+  static SharedDmxRegion* Open(const std::string &name);
+
+  /**
+   * @brief Return the name of the region used by the olad instance that
+   *   listens for RPCs on the given port.
+   */
+  static std::string NameForPort(uint16_t port);
+
+  /**
+   * @brief The number of slots in the region.
+   */
+  unsigned int SlotCount() const { return m_slot_count; }
+
+  /**
+   * @brief The number of slots that have been claimed by a universe.
+   */
+  unsigned int SlotsInUse() const;
+
+  /**
+   * @brief Check if the creator of the region is still using it.
+   * @returns false once the region has been closed by its creator.
+   */
+  bool IsActive() const;
+
+  /**
+   * @brief Find the slot for a universe, claiming a free one if required.
+   * @param universe the universe id.
+   * @returns the index of the slot or -1 if the region is full.
+   */
+  int SlotForUniverse(unsigned int universe);
+
+  /**
+   * @brief Write a frame to a slot.
+   * @param slot the index of the slot, from SlotForUniverse().
+   * @param priority the priority of the data.
+   * @param data the DMX512 data.
+   * @param timestamp the time the data was produced.
+   * @returns true if the frame was written, false if the slot index was
+   *   invalid or another writer held the slot for too long.
+   */
+  bool Write(unsigned int slot, uint8_t priority, const DmxBuffer &data,
+             const TimeStamp &timestamp);
+
+  /**
+   * @brief Copy a slot if it has changed.
+   * @param slot the index of the slot.
+   * @param[in,out] sequence the sequence number of the last copy taken from
+   *   this slot, or 0 if none has been taken. This is updated if a new copy is
+   *   taken.
+   * @param[out] frame the frame to copy into.
+   * @returns true if a consistent copy of new data was taken, false if the
+   *   slot is unchanged, is being written to, or holds invalid data.
+   */
+  bool Read(unsigned int slot, uint32_t *sequence,
+            SharedDmxFrame *frame) const;
+
+  /**
+   * @brief Unlock a slot left locked by a writer that died.
+   *
+   * This should be called at intervals much longer than a write takes. The
+   * slot is only unlocked if it was locked with the same sequence number at
+   * the previous call, and the process that locked it no longer exists. A
+   * writer that is slow but still running is never interrupted.
+   * @param slot the index of the slot.
+   * @param[in,out] locked_sequence the state for this slot, which should be 0
+   *   initially. If the slot is unlocked, this is set to the new sequence
+   *   number. The frame in the slot may be incomplete, so the reader should
+   *   use this as the sequence number of the last copy taken.
+   * @returns true if the slot was unlocked.
+   */
+  bool RecoverSlot(unsigned int slot, uint32_t *locked_sequence);
+
+  /**
+   * @brief Check if the process that wrote a frame is still running.
+   * @param writer the pid from SharedDmxFrame::writer.
+   * @returns true if the process exists, even if it belongs to another user.
+   */
+  static bool WriterIsRunning(int32_t writer);
+
+  /**
+   * @brief Set the doorbell flag.
+   * @returns true if the flag was previously clear, in which case the caller
+   *   is responsible for waking the reader.
+   */
+  bool RingDoorbell();
+
+  /**
+   * @brief Clear the doorbell flag.
+   *
+   * This must be called before the slots are scanned, so that writes made
+   * during the scan ring the doorbell again.
+   */
+  void ClearDoorbell();
+
+  /**
+   * @brief The loopback UDP port the reader is waiting for doorbells on.
+   * @returns the port in host byte order, or 0 if it hasn't been set.
+   */
+  uint16_t DoorbellPort() const;
+
+  /**
+   * @brief Set the loopback UDP port the reader is waiting for doorbells on.
+   * @param port the port in host byte order.
+   */
+  void SetDoorbellPort(uint16_t port);
+
+  static const unsigned int DEFAULT_SLOT_COUNT = 4096;
+  static const unsigned int MAX_SLOT_COUNT = 65536;
+
+ private:
+  struct RegionHeader;
+  struct RegionSlot;
+
+  const std::string m_name;
+  const bool m_owner;
+  void *m_memory;
+  size_t m_size;
+  RegionHeader *m_header;
+  RegionSlot *m_slots;
+  unsigned int m_slot_count;
+
+  SharedDmxRegion(const std::string &name, bool owner, void *memory,
+                  size_t size, unsigned int slot_count);
+
+  bool LockSlot(unsigned int slot, uint32_t *sequence);
+  void UnlockSlot(unsigned int slot, uint32_t sequence);
+
+  static size_t RegionSize(unsigned int slot_count);
+
+  static const uint32_t MAGIC;
+  static const uint32_t REGION_VERSION;
+  static const unsigned int MAX_WRITE_SPINS;
+  static const unsigned int MAX_READ_RETRIES;
+
+  friend class ::SharedDmxRegionTest;
+
+  DISALLOW_COPY_AND_ASSIGN(SharedDmxRegion);
+};
+}  // namespace dmx
+}  // namespace ola
+#endif  // INCLUDE_OLA_DMX_SHAREDDMXREGION_H_
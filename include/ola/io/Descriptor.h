@@ -161,6 +161,14 @@ class ReadFileDescriptor {
    * This is usually called by the SelectServer.
    */
   virtual void PerformRead() = 0;
+
+  /**
+   * @brief Check if PerformRead() reads until the descriptor would block.
+   * @returns true if PerformRead() drains the descriptor.
+   *
+   * Pollers may use edge triggered notification for these descriptors.
+   */
+  virtual bool DrainsOnRead() const { return false; }
 };
 
 
@@ -200,7 +208,11 @@ class WriteFileDescriptor {
 class BidirectionalFileDescriptor: public ReadFileDescriptor,
                                    public WriteFileDescriptor {
  public :
-  BidirectionalFileDescriptor(): m_on_read(NULL), m_on_write(NULL) {}
+  BidirectionalFileDescriptor()
+      : m_on_read(NULL),
+        m_on_write(NULL),
+        m_drains_on_read(false) {
+  }
 
   virtual ~BidirectionalFileDescriptor() {
     if (m_on_read)
@@ -232,12 +244,26 @@ class BidirectionalFileDescriptor: public ReadFileDescriptor,
     m_on_write = on_write;
   }
 
+  /**
+   * @brief Indicate that the on data callback reads until the descriptor
+   *   would block.
+   * @param drains_on_read true if the callback drains the descriptor.
+   *
+   * This must be set before the descriptor is added to the SelectServer.
+   */
+  void SetDrainsOnRead(bool drains_on_read) {
+    m_drains_on_read = drains_on_read;
+  }
+
+  bool DrainsOnRead() const { return m_drains_on_read; }
+
   void PerformRead();
   void PerformWrite();
 
  private:
   ola::Callback0<void> *m_on_read;
   ola::Callback0<void> *m_on_write;
+  bool m_drains_on_read;
 };
 
 
@@ -294,7 +320,7 @@ class ConnectedDescriptor: public BidirectionalFileDescriptor {
    * @brief Write a buffer to the descriptor.
    * @param buffer a pointer to the buffer to write
    * @param size the number of bytes in the buffer to write
-   * @return the number of bytes written
+   * @return the number of bytes written, or -1 on error with errno set.
    */
   virtual ssize_t Send(const uint8_t *buffer, unsigned int size);
 
@@ -306,10 +332,22 @@ class ConnectedDescriptor: public BidirectionalFileDescriptor {
    *
    * This attempts to send as much of the IOQueue data as possible. The IOQueue
    * may be non-empty when this completes if the descriptor buffer is full.
-   * @returns the number of bytes sent.
+   * @returns the number of bytes sent, or -1 on error with errno set.
    */
   virtual ssize_t Send(IOQueue *data);
 
+  /**
+   * @brief Write an array of buffers to the descriptor.
+   * @param iov the array of IOVecs to write.
+   * @param iocnt the number of entries in iov.
+   * @returns the number of bytes sent, or -1 on error with errno set.
+   *
+   * The buffers are written in a single writev() / sendmsg() call where the
+   * platform supports it, so they don't need to be copied into a contiguous
+   * block first.
+   */
+  virtual ssize_t Send(const struct IOVec *iov, int iocnt);
+
 
   /**
    * @brief Read data from this descriptor.
@@ -53,7 +53,8 @@ namespace io {
  *
  * The SelectServer has a number of different implementations depending on the
  * platform. On systems with epoll, the flag --no-use-epoll will disable the
- * use of epoll(), reverting to select(). The PollerInterface defines the
+ * use of epoll(), reverting to select(). On Linux, --use-io-uring selects the
+ * io_uring poller. The PollerInterface defines the
  * contract between the SelectServer and the lower level, platform dependant
  * Poller classes.
  *
@@ -66,6 +67,10 @@ class SelectServer: public SelectServerInterface {
    public:
     Options()
         : force_select(false),
+          use_timer_wheel(false),
+          max_poll_events(0),
+          edge_triggered(false),
+          use_io_uring(false),
           export_map(NULL),
           clock(NULL) {
     }
@@ -76,6 +81,40 @@ class SelectServer: public SelectServerInterface {
      */
     bool force_select;
 
+    /**
+     * @brief Hold timeouts in a hierarchical timing wheel rather than a
+     * priority queue.
+     *
+     * This is faster when many timeouts are registered and cancelled, at the
+     * cost of some fixed memory.
+     */
+    bool use_timer_wheel;
+
+    /**
+     * @brief The maximum number of events to handle per epoll() call.
+     *
+     * 0 uses the value of --epoll-max-events.
+     */
+    unsigned int max_poll_events;
+
+    /**
+     * @brief Use edge triggered epoll() notification for descriptors which
+     * drain on read.
+     *
+     * See ReadFileDescriptor::DrainsOnRead(). This is also enabled with
+     * --epoll-edge-triggered. With io_uring, these descriptors use multishot
+     * poll requests. These include the SelectServer's own wake-up pipe, RPC
+     * connections and the E1.31 and Art-Net sockets.
+     */
+    bool edge_triggered;
+
+    /**
+     * @brief Use io_uring rather than epoll(), as with --use-io-uring.
+     *
+     * If the kernel doesn't support io_uring, epoll() is used instead.
+     */
+    bool use_io_uring;
+
     /**
      * @brief The export map to use.
      */
@@ -12,4 +12,6 @@ olanetworkinclude_HEADERS = \
     include/ola/network/SocketCloser.h \
     include/ola/network/TCPConnector.h \
     include/ola/network/TCPSocket.h \
-    include/ola/network/TCPSocketFactory.h
+    include/ola/network/TCPSocketFactory.h \
+    include/ola/network/UDPBatchSender.h \
+    include/ola/network/UDPReceiveRing.h
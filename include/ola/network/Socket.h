@@ -36,6 +36,26 @@
 namespace ola {
 namespace network {
 
+/**
+ * @brief A datagram passed to UDPSocketInterface::SendMany().
+ */
+struct OutgoingDatagram {
+  const uint8_t *data;  //!< the data to send
+  unsigned int size;  //!< the length of the data
+  IPV4SocketAddress destination;  //!< the IP:Port to send the datagram to
+};
+
+/**
+ * @brief A datagram received with UDPSocketInterface::RecvMany().
+ */
+struct IncomingDatagram {
+  uint8_t *data;  //!< the buffer to receive into, set by the caller
+  unsigned int capacity;  //!< the size of the buffer, set by the caller
+  unsigned int size;  //!< the number of bytes received
+  bool truncated;  //!< true if the datagram didn't fit in the buffer
+  IPV4SocketAddress source;  //!< where the datagram came from
+};
+
 /**
  * @brief The interface for UDPSockets.
  *
@@ -132,6 +152,19 @@ class UDPSocketInterface: public ola::io::BidirectionalFileDescriptor {
   virtual ssize_t SendTo(ola::io::IOVecInterface *data,
                          const IPV4SocketAddress &dest) const = 0;
 
+  /**
+   * @brief Send a batch of datagrams.
+   * @param datagrams an array of datagrams to send.
+   * @param count the number of datagrams in the array.
+   * @return the number of datagrams that were sent in full.
+   *
+   * Where the platform supports it, this sends many datagrams per system call.
+   * A datagram that fails to send doesn't stop the remaining datagrams from
+   * being sent.
+   */
+  virtual unsigned int SendMany(const OutgoingDatagram *datagrams,
+                                unsigned int count) const = 0;
+
   /**
    * @brief Receive data
    * @param buffer the buffer to store the data
@@ -185,6 +218,21 @@ class UDPSocketInterface: public ola::io::BidirectionalFileDescriptor {
                         ssize_t *data_read,
                         IPV4SocketAddress *source) = 0;
 
+  /**
+   * @brief Receive a batch of datagrams.
+   * @param datagrams an array of datagrams to receive into. The data and
+   *   capacity members of each must be set.
+   * @param count the number of datagrams in the array.
+   * @return the number of datagrams received, 0 if none were waiting.
+   *
+   * Where the platform supports it, this receives many datagrams per system
+   * call without blocking, and if fewer than count datagrams are returned the
+   * socket has been drained. Otherwise a single datagram is read, so this
+   * should only be called when the socket is readable.
+   */
+  virtual unsigned int RecvMany(IncomingDatagram *datagrams,
+                                unsigned int count) = 0;
+
   /**
    * @brief Enable broadcasting for this socket.
    * @return true if it worked, false otherwise
@@ -259,6 +307,8 @@ class UDPSocket: public UDPSocketInterface {
                  unsigned short port) const;
   ssize_t SendTo(ola::io::IOVecInterface *data,
                  const IPV4SocketAddress &dest) const;
+  unsigned int SendMany(const OutgoingDatagram *datagrams,
+                        unsigned int count) const;
 
   bool RecvFrom(uint8_t *buffer, ssize_t *data_read) const;
   bool RecvFrom(uint8_t *buffer,
@@ -272,6 +322,7 @@ class UDPSocket: public UDPSocketInterface {
   bool RecvFrom(uint8_t *buffer,
                 ssize_t *data_read,
                 IPV4SocketAddress *source);
+  unsigned int RecvMany(IncomingDatagram *datagrams, unsigned int count);
 
   bool EnableBroadcast();
   bool SetMulticastInterface(const IPV4Address &iface);
@@ -284,6 +335,10 @@ class UDPSocket: public UDPSocketInterface {
   bool SetTos(uint8_t tos);
 
  private:
+  // The maximum number of datagrams passed to a single sendmmsg() or
+  // recvmmsg() call.
+  static const unsigned int MAX_DATAGRAMS_PER_CALL = 64;
+
   ola::io::DescriptorHandle m_handle;
   bool m_bound_to_port;
 
@@ -0,0 +1,139 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * UDPBatchSender.h
+ * Queue UDP datagrams and send them with as few system calls as possible.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+/**
+ * @addtogroup network
+ * @{
+ * @file UDPBatchSender.h
+ * @brief Queue UDP datagrams and send them in batches.
+ * @}
+ */
+
+#ifndef INCLUDE_OLA_NETWORK_UDPBATCHSENDER_H_
+#define INCLUDE_OLA_NETWORK_UDPBATCHSENDER_H_
+
+#include <stdint.h>
+#include <ola/base/Macro.h>
+#include <ola/network/Socket.h>
+#include <ola/network/SocketAddress.h>
+#include <ola/thread/SchedulerInterface.h>
+#include <vector>
+
+namespace ola {
+namespace network {
+
+/**
+ * @addtogroup network
+ * @{
+ */
+
+/**
+ * @brief Queue UDP datagrams and send them with UDPSocketInterface::SendMany.
+ *
+ * Protocols like Art-Net and E1.31 send one datagram per universe, and
+ * sometimes one per universe per receiver. Rather than sending each datagram
+ * as it's produced, callers can Queue() them and then either Flush() once
+ * they are done, or call ScheduleFlush() so that everything queued during the
+ * current iteration of the event loop is sent together.
+ *
+ * The datagram data is copied when it's queued, so the caller may reuse its
+ * buffers straight away. Once the internal buffers have grown to the size of
+ * a typical frame, queuing doesn't allocate any memory.
+ */
+class UDPBatchSender {
+ public:
+  /**
+   * @brief Create a new UDPBatchSender.
+   * @param socket the socket to send on, ownership is not transferred.
+   * @param scheduler the scheduler to use for ScheduleFlush(). If this is
+   *   NULL, ScheduleFlush() sends the queued datagrams immediately.
+   * @param max_pending the number of datagrams to queue before they are
+   *   automatically flushed.
+   */
+  UDPBatchSender(UDPSocketInterface *socket,
+                 ola::thread::SchedulerInterface *scheduler = NULL,
+                 unsigned int max_pending = DEFAULT_MAX_PENDING);
+
+  /**
+   * @brief Destructor.
+   *
+   * Any queued datagrams are sent.
+   */
+  ~UDPBatchSender();
+
+  /**
+   * @brief Queue a datagram for sending.
+   * @param data the datagram data, this is copied.
+   * @param size the size of the datagram.
+   * @param destination the IP:Port to send the datagram to.
+   */
+  void Queue(const uint8_t *data,
+             unsigned int size,
+             const IPV4SocketAddress &destination);
+
+  /**
+   * @brief Send the queued datagrams once the current iteration of the event
+   *   loop completes.
+   *
+   * This is the frame-flush hook; calling it more than once per iteration is
+   * cheap.
+   */
+  void ScheduleFlush();
+
+  /**
+   * @brief Send all queued datagrams now.
+   * @returns the number of datagrams that were sent in full.
+   */
+  unsigned int Flush();
+
+  /**
+   * @brief The number of datagrams waiting to be sent.
+   */
+  unsigned int Pending() const { return m_pending.size(); }
+
+  /**
+   * @brief The default value of max_pending.
+   */
+  static const unsigned int DEFAULT_MAX_PENDING = 256;
+
+ private:
+  struct PendingDatagram {
+    unsigned int offset;
+    unsigned int size;
+    IPV4SocketAddress destination;
+  };
+
+  UDPSocketInterface *m_socket;
+  ola::thread::SchedulerInterface *m_scheduler;
+  const unsigned int m_max_pending;
+  ola::thread::timeout_id m_flush_timeout;
+  std::vector<uint8_t> m_data;
+  std::vector<PendingDatagram> m_pending;
+  std::vector<OutgoingDatagram> m_outgoing;
+
+  void ScheduledFlush();
+
+  DISALLOW_COPY_AND_ASSIGN(UDPBatchSender);
+};
+
+/**@}*/
+}  // namespace network
+}  // namespace ola
+#endif  // INCLUDE_OLA_NETWORK_UDPBATCHSENDER_H_
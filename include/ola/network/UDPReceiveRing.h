@@ -0,0 +1,154 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * UDPReceiveRing.h
+ * A reusable set of buffers for receiving batches of UDP datagrams.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+/**
+ * @addtogroup network
+ * @{
+ * @file UDPReceiveRing.h
+ * @brief Receive batches of UDP datagrams into reusable buffers.
+ * @}
+ */
+
+#ifndef INCLUDE_OLA_NETWORK_UDPRECEIVERING_H_
+#define INCLUDE_OLA_NETWORK_UDPRECEIVERING_H_
+
+#include <stdint.h>
+#include <ola/ExportMap.h>
+#include <ola/base/Macro.h>
+#include <ola/network/Socket.h>
+#include <string>
+#include <vector>
+
+namespace ola {
+namespace network {
+
+/**
+ * @addtogroup network
+ * @{
+ */
+
+/**
+ * @brief Receive batches of datagrams with UDPSocketInterface::RecvMany.
+ *
+ * The ring owns a fixed number of fixed size slots which are reused for every
+ * batch, so receiving doesn't allocate memory. A typical read handler looks
+ * like:
+ *
+ * @code
+ *   unsigned int count;
+ *   do {
+ *     count = ring.Receive(socket);
+ *     for (unsigned int i = 0; i < count; i++) {
+ *       const IncomingDatagram &datagram = ring.Datagram(i);
+ *       ...
+ *     }
+ *   } while (ring.Full());
+ * @endcode
+ *
+ * If an ExportMap is provided, the number of batches, datagrams, the largest
+ * batch and the number of dropped datagrams are exported, keyed by the name
+ * passed to the constructor. The drop count only covers datagrams that were
+ * read from the socket and then discarded, either here because they didn't
+ * fit in a slot or by the caller with CountDrop(). Datagrams dropped by the
+ * kernel because the socket buffer was full aren't included.
+ */
+class UDPReceiveRing {
+ public:
+  /**
+   * @brief Create a new UDPReceiveRing.
+   * @param slot_count the maximum number of datagrams in a batch.
+   * @param slot_size the size of the largest datagram that can be received.
+   * @param export_map the ExportMap to use for the counters, may be NULL.
+   * @param name the key to use in the ExportMap.
+   */
+  UDPReceiveRing(unsigned int slot_count,
+                 unsigned int slot_size,
+                 ExportMap *export_map = NULL,
+                 const std::string &name = "");
+
+  /**
+   * @brief Receive the next batch of datagrams.
+   * @param socket the socket to read from.
+   * @returns the number of datagrams received. Truncated datagrams are
+   *   dropped and not included.
+   */
+  unsigned int Receive(UDPSocketInterface *socket);
+
+  /**
+   * @brief Return a datagram from the last batch.
+   * @param index the index of the datagram, must be less than the value
+   *   returned by the last call to Receive().
+   */
+  const IncomingDatagram &Datagram(unsigned int index) const {
+    return m_datagrams[index];
+  }
+
+  /**
+   * @brief Record a datagram that was received but discarded by the caller.
+   */
+  void CountDrop();
+
+  /**
+   * @brief The maximum number of datagrams in a batch.
+   */
+  unsigned int SlotCount() const { return m_datagrams.size(); }
+
+  /**
+   * @brief Check if the last call to Receive() filled every slot.
+   *
+   * If it did, there may be more datagrams waiting. This counts the
+   * datagrams read from the socket, including any that were discarded, so
+   * use this rather than comparing the result of Receive() to SlotCount().
+   */
+  bool Full() const { return m_last_batch == m_datagrams.size(); }
+
+  /**
+   * @brief Check if the loop above reads until the socket would block.
+   *
+   * If it does, the socket can be marked with
+   * BidirectionalFileDescriptor::SetDrainsOnRead(). This needs recvmmsg(),
+   * without it each Receive() reads a single datagram.
+   */
+  static bool DrainsSocket();
+
+  static const char K_BATCHES_VAR[];
+  static const char K_DATAGRAMS_VAR[];
+  static const char K_DROPS_VAR[];
+  static const char K_MAX_BATCH_VAR[];
+
+ private:
+  const unsigned int m_slot_size;
+  std::vector<uint8_t> m_buffer;
+  std::vector<IncomingDatagram> m_datagrams;
+  unsigned int m_last_batch;
+
+  // These point into the ExportMap, or are NULL if there isn't one.
+  unsigned int *m_batches;
+  unsigned int *m_datagram_count;
+  unsigned int *m_drops;
+  unsigned int *m_max_batch;
+
+  DISALLOW_COPY_AND_ASSIGN(UDPReceiveRing);
+};
+
+/**@}*/
+}  // namespace network
+}  // namespace ola
+#endif  // INCLUDE_OLA_NETWORK_UDPRECEIVERING_H_
@@ -79,6 +79,8 @@ class MockUDPSocket: public ola::network::UDPSocketInterface {
                  const ola::network::IPV4SocketAddress &dest) const {
     return SendTo(data, dest.Host(), dest.Port());
   }
+  unsigned int SendMany(const ola::network::OutgoingDatagram *datagrams,
+                        unsigned int count) const;
 
   bool RecvFrom(uint8_t *buffer, ssize_t *data_read) const;
   bool RecvFrom(
@@ -93,6 +95,8 @@ class MockUDPSocket: public ola::network::UDPSocketInterface {
   bool RecvFrom(uint8_t *buffer,
                 ssize_t *data_read,
                 ola::network::IPV4SocketAddress *source);
+  unsigned int RecvMany(ola::network::IncomingDatagram *datagrams,
+                        unsigned int count);
   bool EnableBroadcast();
   bool SetMulticastInterface(const ola::network::IPV4Address &iface);
   bool JoinMulticast(const ola::network::IPV4Address &iface,
@@ -105,6 +109,9 @@ class MockUDPSocket: public ola::network::UDPSocketInterface {
 
   void SetDiscardMode(bool discard_mode) { m_discard_mode = discard_mode; }
 
+  // The number of times SendMany() has been called.
+  unsigned int SendManyCount() const { return m_send_many_count; }
+
   // these are methods used for verification
   void AddExpectedData(const uint8_t *data,
                        unsigned int size,
@@ -156,6 +163,7 @@ class MockUDPSocket: public ola::network::UDPSocketInterface {
   mutable std::queue<received_data> m_received_data;
   ola::network::IPV4Address m_interface;
   bool m_discard_mode;
+  mutable unsigned int m_send_many_count;
 
   uint8_t* IOQueueToBuffer(ola::io::IOQueue *ioqueue,
                            unsigned int *size) const;
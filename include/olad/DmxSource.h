@@ -101,12 +101,19 @@ class DmxSource {
     const TimeStamp &Timestamp() const { return m_timestamp; }
 
 
+    /*
+     * Get the time at which this source times out
+     */
+    TimeStamp ExpiryTime() const {
+      return m_timestamp + TIMEOUT_INTERVAL;
+    }
+
+
     /*
      * Check if this source has timed out
      */
     bool IsActive(const TimeStamp &now) const {
-      TimeStamp timeout = m_timestamp + TIMEOUT_INTERVAL;
-      return now < timeout;
+      return now < ExpiryTime();
     }
 
 
@@ -102,6 +102,24 @@ class AbstractPlugin {
 
   virtual void ConflictsWith(std::set<ola_plugin_id> *conflict_set) const = 0;
 
+  /**
+   * @brief Check if the plugin should be run on its own thread.
+   * @return true if the plugin should be given its own PluginThread.
+   */
+  virtual bool RunsOnOwnThread() const = 0;
+
+  /**
+   * @brief Get the thread this plugin is running on.
+   * @return the PluginThread, or NULL if the plugin runs on the main thread.
+   */
+  virtual class PluginThread *GetThread() const = 0;
+
+  /**
+   * @brief Set the thread this plugin is running on.
+   * @param thread the PluginThread, or NULL for the main thread.
+   */
+  virtual void SetThread(class PluginThread *thread) = 0;
+
   // used to sort plugins
   virtual bool operator<(const AbstractPlugin &other) const = 0;
 };
@@ -121,7 +139,8 @@ class Plugin: public AbstractPlugin {
     AbstractPlugin(),
     m_plugin_adaptor(plugin_adaptor),
     m_preferences(NULL),
-    m_enabled(false) {
+    m_enabled(false),
+    m_thread(NULL) {
   }
   virtual ~Plugin() {}
 
@@ -133,6 +152,9 @@ class Plugin: public AbstractPlugin {
   virtual bool Stop();
   // return true if this plugin is enabled by default
   virtual bool DefaultMode() const { return true; }
+  bool RunsOnOwnThread() const;
+  class PluginThread *GetThread() const { return m_thread; }
+  void SetThread(class PluginThread *thread) { m_thread = thread; }
   virtual ola_plugin_id Id() const = 0;
 
   /**
@@ -158,12 +180,21 @@ class Plugin: public AbstractPlugin {
    */
   virtual bool SetDefaultPreferences() { return true; }
 
+  /*
+   * Return true if this plugin can be run on its own thread. Such plugins
+   * must only register and unregister devices from StartHook() and
+   * StopHook().
+   */
+  virtual bool SupportsOwnThread() const { return false; }
+
   PluginAdaptor *m_plugin_adaptor;
   class Preferences *m_preferences;  // preferences container
   static const char ENABLED_KEY[];
+  static const char OWN_THREAD_KEY[];
 
  private:
   bool m_enabled;  // are we running
+  class PluginThread *m_thread;
 
   DISALLOW_COPY_AND_ASSIGN(Plugin);
 };
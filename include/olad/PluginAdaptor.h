@@ -38,6 +38,15 @@
 
 namespace ola {
 
+/**
+ * @brief The interface between the plugins and the rest of olad.
+ *
+ * PluginAdaptor is thread safe. Plugins may run on their own PluginThread, in
+ * which case the SelectServerInterface methods apply to the SelectServer of
+ * the calling plugin thread, and otherwise to the main SelectServer. Plugins
+ * running on their own thread may only register devices and create
+ * preferences from their start & stop hooks.
+ */
 class PluginAdaptor: public ola::io::SelectServerInterface {
  public:
   /**
@@ -91,6 +100,15 @@ class PluginAdaptor: public ola::io::SelectServerInterface {
 
   const TimeStamp *WakeUpTime() const;
 
+  /**
+   * @brief Run a callback on the main thread.
+   * @param closure the callback to run.
+   *
+   * Unlike Execute(), this always uses the main SelectServer, even when
+   * called from a plugin thread.
+   */
+  void ExecuteOnMainThread(ola::BaseCallback0<void> *closure);
+
   // These are the extra bits for the plugins
   /**
    * @brief Return the instance name for the OLA server
@@ -135,6 +153,9 @@ class PluginAdaptor: public ola::io::SelectServerInterface {
   class PortBrokerInterface *m_port_broker;
   const std::string *m_instance_name;
 
+  ola::io::SelectServerInterface *CurrentSelectServer() const;
+  bool CanUseMainThread() const;
+
   DISALLOW_COPY_AND_ASSIGN(PluginAdaptor);
 };
 }  // namespace ola
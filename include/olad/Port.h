@@ -220,6 +220,17 @@ class BasicInputPort: public InputPort {
    * @brief Called when there is new data for this port
    */
   void DmxChanged();
+
+  /**
+   * @brief Update the universe with new data for this port.
+   * @param buffer the new data.
+   * @param inherited_priority the priority of the data, used if the port is
+   *   in inherit mode.
+   *
+   * This is called by DmxChanged(), or on the main thread if the plugin is
+   * running on its own thread.
+   */
+  void UpdateSource(const DmxBuffer &buffer, uint8_t inherited_priority);
   const DmxSource &SourceData() const { return m_dmx_source; }
 
   // RDM methods, the child class provides HandleRDMResponse
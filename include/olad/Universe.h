@@ -29,6 +29,7 @@
 #include <ola/rdm/RDMControllerInterface.h>
 #include <ola/rdm/UID.h>
 #include <ola/rdm/UIDSet.h>
+#include <ola/thread/SchedulerInterface.h>
 #include <olad/DmxSource.h>
 
 #include <set>
@@ -51,7 +52,8 @@ class Universe: public ola::rdm::RDMControllerInterface {
 
     Universe(unsigned int uid, class UniverseStore *store,
              ExportMap *export_map,
-             Clock *clock);
+             Clock *clock,
+             ola::thread::SchedulerInterface *scheduler = NULL);
     ~Universe();
 
     // Properties for this universe
@@ -77,10 +79,30 @@ class Universe: public ola::rdm::RDMControllerInterface {
       return m_last_discovery_time;
     }
 
+    /**
+     * @brief Return the maximum rate at which the outputs are updated.
+     * @return the maximum number of frames per second, 0 means the outputs
+     * are updated every time the data changes.
+     */
+    unsigned int MaxOutputRate() const { return m_max_output_rate; }
+
     // Used to adjust the properties
     void SetName(const std::string &name);
     void SetMergeMode(merge_mode merge_mode);
 
+    /**
+     * @brief Limit the rate at which output ports and sink clients are
+     * updated.
+     * @param max_fps the maximum number of frames per second, or 0 to update
+     * the outputs every time the data changes.
+     *
+     * When a limit is set, input changes which arrive less than 1 / max_fps
+     * after the last update mark the universe dirty, and the outputs are
+     * updated once with the merged data when the frame period expires. This
+     * has no effect if the universe was created without a scheduler.
+     */
+    void SetMaxOutputRate(unsigned int max_fps);
+
     /**
      * Set the time between periodic RDM discovery operations.
      */
@@ -138,6 +160,7 @@ class Universe: public ola::rdm::RDMControllerInterface {
     }
 
     static const char K_FPS_VAR[];
+    static const char K_FRAMES_COALESCED_VAR[];
     static const char K_MERGE_HTP_STR[];
     static const char K_MERGE_LTP_STR[];
     static const char K_UNIVERSE_INPUT_PORT_VAR[];
@@ -160,6 +183,16 @@ class Universe: public ola::rdm::RDMControllerInterface {
 
     typedef std::map<Client*, bool> SourceClientMap;
 
+    /*
+     * The index of active sources. Sources are keyed by the InputPort or
+     * Client they came from, and grouped by priority so the highest priority
+     * group is always m_source_index.rbegin(). The index points at the
+     * DmxSource held by the port or client, rather than copying it, so new
+     * data doesn't cause the buffers to be copied on write.
+     */
+    typedef std::map<const void*, const DmxSource*> SourceGroup;
+    typedef std::map<uint8_t, SourceGroup> PriorityIndex;
+
     std::string m_universe_name;
     unsigned int m_universe_id;
     std::string m_universe_id_str;
@@ -176,27 +209,55 @@ class Universe: public ola::rdm::RDMControllerInterface {
     class UniverseStore *m_universe_store;
     DmxBuffer m_buffer;
     ExportMap *m_export_map;
+    // Our entries in the export map, resolved once since some are updated on
+    // every frame. These are NULL if there is no export map.
+    unsigned int *m_fps_counter;
+    unsigned int *m_coalesced_counter;
+    unsigned int *m_rdm_request_counter;
+    unsigned int *m_sink_client_counter;
+    unsigned int *m_source_client_counter;
     std::map<ola::rdm::UID, OutputPort*> m_output_uids;
     Clock *m_clock;
     TimeInterval m_rdm_discovery_interval;
     TimeStamp m_last_discovery_time;
 
+    // The frame clock, used when the output rate is limited.
+    ola::thread::SchedulerInterface *m_scheduler;
+    unsigned int m_max_output_rate;
+    TimeStamp m_last_output_time;
+    ola::thread::timeout_id m_output_timeout;
+
+    PriorityIndex m_source_index;
+    std::map<const void*, uint8_t> m_source_priorities;
+    // The earliest time a source in the index may time out.
+    TimeStamp m_next_source_expiry;
+    ola::thread::timeout_id m_expiry_timeout;
+    std::vector<const DmxBuffer*> m_merge_buffers;
+
     void HandleBroadcastAck(broadcast_request_tracker *tracker,
                             ola::rdm::RDMReply *reply);
     void HandleBroadcastDiscovery(broadcast_request_tracker *tracker,
                                   ola::rdm::RDMReply *reply);
+    bool DataChanged();
+    void OutputFrameDue();
     bool UpdateDependants();
     void UpdateName();
     void UpdateMode();
-    void HTPMergeSources(const std::vector<DmxSource> &sources);
-    bool MergeAll(const InputPort *port, const Client *client);
+    void UpdateSourceIndex(const void *key, const DmxSource &source);
+    void RemoveSource(const void *key);
+    void ExpireSources(const TimeStamp &now);
+    void SourceExpiryTimeout();
+    void ScheduleSourceExpiry(const TimeStamp &now);
+    void HTPMergeSources(const SourceGroup &sources);
+    bool MergeAll(const void *changed_source);
     void PortDiscoveryComplete(BaseCallback0<void> *on_complete,
                                OutputPort *output_port,
                                const ola::rdm::UIDSet &uids);
     void DiscoveryComplete(ola::rdm::RDMDiscoveryCallback *on_complete);
 
-    void SafeIncrement(const std::string &name);
-    void SafeDecrement(const std::string &name);
+    unsigned int *ExportHandle(const char *name);
+    void SafeIncrement(unsigned int *counter);
+    void SafeDecrement(unsigned int *counter);
 
     template<class PortClass>
     bool GenericAddPort(PortClass *port,
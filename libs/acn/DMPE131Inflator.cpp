@@ -153,11 +153,14 @@ bool DMPE131Inflator::HandlePDUData(uint32_t vector,
       break;
     default:
       // HTP Merge
-      universe_iter->second.buffer->Reset();
+      const DmxBuffer *buffers[MAX_MERGE_SOURCES];
+      unsigned int buffer_count = 0;
       std::vector<dmx_source>::const_iterator source_iter =
         universe_iter->second.sources.begin();
-      for (; source_iter != universe_iter->second.sources.end(); ++source_iter)
-        universe_iter->second.buffer->HTPMerge(source_iter->buffer);
+      for (; source_iter != universe_iter->second.sources.end() &&
+             buffer_count < MAX_MERGE_SOURCES; ++source_iter)
+        buffers[buffer_count++] = &source_iter->buffer;
+      universe_iter->second.buffer->SetFromHTPMerge(buffers, buffer_count);
       universe_iter->second.closure->Run();
   }
   return true;
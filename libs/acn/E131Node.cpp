@@ -28,8 +28,10 @@
 #include "ola/Constants.h"
 #include "ola/Logging.h"
 #include "ola/network/InterfacePicker.h"
+#include "ola/network/UDPReceiveRing.h"
 #include "ola/stl/STLUtils.h"
 #include "libs/acn/E131Node.h"
+#include "libs/acn/E131PacketTemplate.h"
 
 namespace ola {
 namespace acn {
@@ -115,11 +117,13 @@ E131Node::E131Node(ola::thread::SchedulerInterface *ss,
       m_options(options),
       m_preferred_ip(ip_address),
       m_cid(cid),
+      m_dmx_sender(&m_socket, ss),
       m_root_sender(m_cid),
       m_e131_sender(&m_socket, &m_root_sender),
       m_dmp_inflator(options.ignore_preview),
       m_discovery_inflator(NewCallback(this, &E131Node::NewDiscoveryPage)),
-      m_incoming_udp_transport(&m_socket, &m_root_inflator),
+      m_incoming_udp_transport(&m_socket, &m_root_inflator,
+                               options.export_map, "e131"),
       m_send_buffer(NULL),
       m_discovery_timeout(ola::thread::INVALID_TIMEOUT) {
 
@@ -155,6 +159,11 @@ E131Node::~E131Node() {
   if (m_send_buffer)
     delete[] m_send_buffer;
 
+  ActiveTxUniverses::iterator tx_iter = m_tx_universes.begin();
+  for (; tx_iter != m_tx_universes.end(); ++tx_iter) {
+    delete tx_iter->second.packet;
+  }
+
   STLDeleteValues(&m_discovered_sources);
 }
 
@@ -183,6 +192,7 @@ bool E131Node::Start() {
 
   m_socket.SetOnData(NewCallback(&m_incoming_udp_transport,
                                  &IncomingUDPTransport::Receive));
+  m_socket.SetDrainsOnRead(ola::network::UDPReceiveRing::DrainsSocket());
 
   if (m_options.enable_draft_discovery) {
     IPV4Address addr;
@@ -200,6 +210,7 @@ bool E131Node::Start() {
 }
 
 bool E131Node::Stop() {
+  m_dmx_sender.Flush();
   m_ss->RemoveTimeout(m_discovery_timeout);
   m_discovery_timeout = ola::thread::INVALID_TIMEOUT;
   return true;
@@ -213,6 +224,9 @@ bool E131Node::SetSourceName(uint16_t universe, const string &source) {
     settings->source = source;
   } else {
     iter->second.source = source;
+    // The source name is part of the packet template, so force a rebuild.
+    delete iter->second.packet;
+    iter->second.packet = NULL;
   }
   return true;
 }
@@ -231,11 +245,15 @@ bool E131Node::StartStream(uint16_t universe) {
 }
 
 bool E131Node::TerminateStream(uint16_t universe, uint8_t priority) {
+  // Any queued data must go out first, otherwise receivers would see it after
+  // the stream terminated packets and restart the stream.
+  m_dmx_sender.Flush();
+
   // The standard says to send this 3 times
   for (unsigned int i = 0; i < 3; i++) {
     SendStreamTerminated(universe, DmxBuffer(), priority);
   }
-  STLRemove(&m_tx_universes, universe);
+  RemoveOutgoingSettings(universe);
   return true;
 }
 
@@ -261,41 +279,37 @@ bool E131Node::SendDMXWithSequenceOffset(uint16_t universe,
     settings = &iter->second;
   }
 
-  const uint8_t *dmp_data;
-  unsigned int dmp_data_length;
+  uint8_t sequence = static_cast<uint8_t>(settings->sequence + sequence_offset);
+  if (!settings->packet) {
+    settings->packet = new E131PacketTemplate();
+  }
 
-  if (m_options.use_rev2) {
-    dmp_data = buffer.GetRaw();
-    dmp_data_length = buffer.Size();
+  E131PacketTemplate *packet = settings->packet;
+  if (packet->CanUpdate(buffer)) {
+    packet->Update(priority, sequence, preview, buffer);
   } else {
-    unsigned int data_size = DMX_UNIVERSE_SIZE;
-    buffer.Get(m_send_buffer + 1, &data_size);
-    dmp_data = m_send_buffer;
-    dmp_data_length = data_size + 1;
+    E131Header header(settings->source,
+                      priority,
+                      sequence,
+                      universe,
+                      preview,  // preview
+                      false,  // terminated
+                      m_options.use_rev2);
+    if (!packet->Build(m_cid, header, buffer)) {
+      return false;
+    }
   }
 
-  TwoByteRangeDMPAddress range_addr(0, 1, (uint16_t) dmp_data_length);
-  DMPAddressData<TwoByteRangeDMPAddress> range_chunk(&range_addr,
-                                                     dmp_data,
-                                                     dmp_data_length);
-  vector<DMPAddressData<TwoByteRangeDMPAddress> > ranged_chunks;
-  ranged_chunks.push_back(range_chunk);
-  const DMPPDU *pdu = NewRangeDMPSetProperty<uint16_t>(true,
-                                                       false,
-                                                       ranged_chunks);
-
-  E131Header header(settings->source,
-                    priority,
-                    static_cast<uint8_t>(settings->sequence + sequence_offset),
-                    universe,
-                    preview,  // preview
-                    false,  // terminated
-                    m_options.use_rev2);
+  bool result = true;
+  if (m_options.batch_dmx) {
+    m_dmx_sender.Queue(packet->Data(), packet->Size(), packet->Destination());
+    m_dmx_sender.ScheduleFlush();
+  } else {
+    result = m_e131_sender.SendPacket(*packet);
+  }
 
-  bool result = m_e131_sender.SendDMP(header, pdu);
   if (result && !sequence_offset)
     settings->sequence++;
-  delete pdu;
   return result;
 }
 
@@ -399,12 +413,25 @@ E131Node::tx_universe *E131Node::SetupOutgoingSettings(uint16_t universe) {
   tx_universe settings;
   settings.source = m_options.source_name;
   settings.sequence = 0;
+  settings.packet = NULL;
   ActiveTxUniverses::iterator iter =
       m_tx_universes.insert(std::make_pair(universe, settings)).first;
   return &iter->second;
 }
 
 
+/*
+ * Remove the settings entry for an outgoing universe
+ */
+void E131Node::RemoveOutgoingSettings(uint16_t universe) {
+  ActiveTxUniverses::iterator iter = m_tx_universes.find(universe);
+  if (iter != m_tx_universes.end()) {
+    delete iter->second.packet;
+    m_tx_universes.erase(iter);
+  }
+}
+
+
 bool E131Node::PerformDiscoveryHousekeeping() {
   // Send the Universe Discovery packets.
   vector<uint16_t> universes;
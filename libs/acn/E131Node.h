@@ -29,6 +29,7 @@
 #include "ola/Callback.h"
 #include "ola/Constants.h"
 #include "ola/DmxBuffer.h"
+#include "ola/ExportMap.h"
 #include "ola/acn/ACNPort.h"
 #include "ola/acn/CID.h"
 #include "ola/base/Macro.h"
@@ -36,6 +37,7 @@
 #include "ola/thread/SchedulerInterface.h"
 #include "ola/network/Interface.h"
 #include "ola/network/Socket.h"
+#include "ola/network/UDPBatchSender.h"
 #include "libs/acn/DMPE131Inflator.h"
 #include "libs/acn/E131DiscoveryInflator.h"
 #include "libs/acn/E131Inflator.h"
@@ -58,7 +60,9 @@ class E131Node {
        : use_rev2(false),
          ignore_preview(true),
          enable_draft_discovery(false),
+         batch_dmx(false),
          dscp(0),
+         export_map(NULL),
          port(ola::acn::ACN_PORT),
          source_name(ola::OLA_DEFAULT_INSTANCE_NAME) {
     }
@@ -66,7 +70,15 @@ class E131Node {
     bool use_rev2;  /**< Use Revision 0.2 of the 2009 draft */
     bool ignore_preview;  /**< Ignore preview data */
     bool enable_draft_discovery;  /**< Enable 2014 draft discovery */
+    /**
+     * Queue data packets and send them together at the end of the current
+     * iteration of the event loop. SendDMX() then returns once the packet is
+     * queued, so send failures aren't reported.
+     */
+    bool batch_dmx;
     uint8_t dscp;  /**< The DSCP value to tag packets with */
+    /** If not NULL, the receive counters are exported here */
+    ola::ExportMap *export_map;
     uint16_t port; /**< The UDP port to use, defaults to ACN_PORT */
     std::string source_name; /**< The source name to use */
   };
@@ -211,6 +223,7 @@ class E131Node {
   struct tx_universe {
     std::string source;
     uint8_t sequence;
+    class E131PacketTemplate *packet;
   };
 
   typedef std::map<uint16_t, tx_universe> ActiveTxUniverses;
@@ -223,6 +236,7 @@ class E131Node {
 
   ola::network::Interface m_interface;
   ola::network::UDPSocket m_socket;
+  ola::network::UDPBatchSender m_dmx_sender;
   // senders
   RootSender m_root_sender;
   E131Sender m_e131_sender;
@@ -242,6 +256,7 @@ class E131Node {
   TrackedSources m_discovered_sources;
 
   tx_universe *SetupOutgoingSettings(uint16_t universe);
+  void RemoveOutgoingSettings(uint16_t universe);
 
   bool PerformDiscoveryHousekeeping();
   void NewDiscoveryPage(const HeaderSet &headers,
@@ -0,0 +1,137 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * E131NodeTest.cpp
+ * Test fixture for the E131Node class
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <stdint.h>
+#include <memory>
+#include <vector>
+
+#include "ola/Callback.h"
+#include "ola/DmxBuffer.h"
+#include "ola/Logging.h"
+#include "ola/acn/ACNPort.h"
+#include "ola/io/SelectServer.h"
+#include "ola/network/IPV4Address.h"
+#include "ola/network/Socket.h"
+#include "ola/network/SocketAddress.h"
+#include "ola/testing/TestUtils.h"
+#include "libs/acn/E131Header.h"
+#include "libs/acn/E131Node.h"
+
+namespace ola {
+namespace acn {
+
+using ola::network::IPV4Address;
+using ola::network::IPV4SocketAddress;
+using std::vector;
+
+class E131NodeTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(E131NodeTest);
+  CPPUNIT_TEST(testTerminateFlushesBatch);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    void setUp();
+    void testTerminateFlushesBatch();
+
+ private:
+    ola::io::SelectServer m_ss;
+    ola::network::UDPSocket m_socket;
+    vector<uint8_t> m_options;
+
+    void ReceiveData();
+    void FatalStop() { OLA_ASSERT(false); }
+
+    static const uint16_t UNIVERSE = 1;
+    static const uint16_t NODE_PORT = 5573;
+    static const unsigned int EXPECTED_PACKETS = 4;
+    static const int ABORT_TIMEOUT_IN_MS = 1000;
+    // The offset of the options field for the 2009 version of E1.31.
+    static const unsigned int OPTIONS_OFFSET = 112;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(E131NodeTest);
+
+
+void E131NodeTest::setUp() {
+  ola::InitLogging(ola::OLA_LOG_INFO, ola::OLA_LOG_STDERR);
+}
+
+
+/*
+ * Record the options field of each E1.31 packet we receive.
+ */
+void E131NodeTest::ReceiveData() {
+  uint8_t data[1500];
+  ssize_t data_read = sizeof(data);
+  if (!m_socket.RecvFrom(data, &data_read) ||
+      data_read <= static_cast<ssize_t>(OPTIONS_OFFSET)) {
+    return;
+  }
+  m_options.push_back(data[OPTIONS_OFFSET]);
+  if (m_options.size() == EXPECTED_PACKETS) {
+    m_ss.Terminate();
+  }
+}
+
+
+/*
+ * Check that queued data is sent before the stream terminated packets.
+ */
+void E131NodeTest::testTerminateFlushesBatch() {
+  E131Node::Options options;
+  options.batch_dmx = true;
+  options.port = NODE_PORT;
+  E131Node node(&m_ss, "", options);
+  if (!node.Start()) {
+    OLA_WARN << "No usable interface, skipping E131NodeTest";
+    return;
+  }
+
+  OLA_ASSERT_TRUE(m_socket.Init());
+  OLA_ASSERT_TRUE(m_socket.Bind(
+      IPV4SocketAddress(IPV4Address::WildCard(), ola::acn::ACN_PORT)));
+  // 239.255.0.1 is the group for universe 1.
+  IPV4Address group;
+  OLA_ASSERT_TRUE(IPV4Address::FromString("239.255.0.1", &group));
+  OLA_ASSERT_TRUE(m_socket.JoinMulticast(node.GetInterface().ip_address,
+                                         group));
+  m_socket.SetOnData(NewCallback(this, &E131NodeTest::ReceiveData));
+  OLA_ASSERT_TRUE(m_ss.AddReadDescriptor(&m_socket));
+
+  DmxBuffer buffer;
+  buffer.SetFromString("1,2,3");
+  OLA_ASSERT_TRUE(node.SendDMX(UNIVERSE, buffer));
+  OLA_ASSERT_TRUE(node.TerminateStream(UNIVERSE));
+
+  m_ss.RegisterSingleTimeout(
+      ABORT_TIMEOUT_IN_MS,
+      NewSingleCallback(this, &E131NodeTest::FatalStop));
+  m_ss.Run();
+  m_ss.RemoveReadDescriptor(&m_socket);
+
+  OLA_ASSERT_EQ(static_cast<size_t>(EXPECTED_PACKETS), m_options.size());
+  OLA_ASSERT_FALSE(m_options[0] & E131Header::STREAM_TERMINATED_MASK);
+  for (unsigned int i = 1; i < EXPECTED_PACKETS; i++) {
+    OLA_ASSERT_TRUE(m_options[i] & E131Header::STREAM_TERMINATED_MASK);
+  }
+}
+}  // namespace acn
+}  // namespace ola
@@ -0,0 +1,138 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * E131PacketTemplate.cpp
+ * A pre-built E1.31 data packet for a single universe.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <stddef.h>
+#include <string.h>
+#include <memory>
+#include <vector>
+
+#include "ola/Constants.h"
+#include "ola/Logging.h"
+#include "ola/acn/ACNPort.h"
+#include "ola/acn/ACNVectors.h"
+#include "ola/network/IPV4Address.h"
+#include "libs/acn/DMPAddress.h"
+#include "libs/acn/DMPPDU.h"
+#include "libs/acn/E131PDU.h"
+#include "libs/acn/E131PacketTemplate.h"
+#include "libs/acn/E131Sender.h"
+#include "libs/acn/RootPDU.h"
+
+namespace ola {
+namespace acn {
+
+using ola::network::IPV4Address;
+using ola::network::IPV4SocketAddress;
+using std::auto_ptr;
+using std::vector;
+
+E131PacketTemplate::E131PacketTemplate()
+    : m_size(0),
+      m_header_offset(0),
+      m_slot_offset(0),
+      m_slot_count(0),
+      m_is_rev2(false) {
+}
+
+
+bool E131PacketTemplate::Build(const ola::acn::CID &cid,
+                               const E131Header &header,
+                               const DmxBuffer &buffer) {
+  m_size = 0;
+
+  IPV4Address addr;
+  if (!E131Sender::UniverseIP(header.Universe(), &addr)) {
+    return false;
+  }
+
+  // Rev 0.2 doesn't include the start code.
+  uint8_t dmp_data[DMX_UNIVERSE_SIZE + 1];
+  unsigned int dmp_data_length = DMX_UNIVERSE_SIZE;
+  if (header.UsingRev2()) {
+    buffer.Get(dmp_data, &dmp_data_length);
+  } else {
+    dmp_data[0] = 0;
+    buffer.Get(dmp_data + 1, &dmp_data_length);
+    dmp_data_length++;
+  }
+
+  TwoByteRangeDMPAddress range_addr(0, 1,
+                                    static_cast<uint16_t>(dmp_data_length));
+  DMPAddressData<TwoByteRangeDMPAddress> range_chunk(&range_addr,
+                                                     dmp_data,
+                                                     dmp_data_length);
+  vector<DMPAddressData<TwoByteRangeDMPAddress> > ranged_chunks;
+  ranged_chunks.push_back(range_chunk);
+  auto_ptr<const DMPPDU> dmp_pdu(
+      NewRangeDMPSetProperty<uint16_t>(true, false, ranged_chunks));
+
+  E131PDU e131_pdu(ola::acn::VECTOR_E131_DATA, header, dmp_pdu.get());
+  PDUBlock<PDU> e131_block;
+  e131_block.AddPDU(&e131_pdu);
+
+  RootPDU root_pdu(header.UsingRev2() ? ola::acn::VECTOR_ROOT_E131_REV2 :
+                                        ola::acn::VECTOR_ROOT_E131,
+                   cid, &e131_block);
+  PDUBlock<PDU> root_block;
+  root_block.AddPDU(&root_pdu);
+
+  memcpy(m_data, PreamblePacker::ACN_HEADER, PreamblePacker::ACN_HEADER_SIZE);
+  unsigned int size = sizeof(m_data) - PreamblePacker::ACN_HEADER_SIZE;
+  if (!root_block.Pack(m_data + PreamblePacker::ACN_HEADER_SIZE, &size)) {
+    OLA_WARN << "Failed to pack E1.31 data packet for universe "
+             << header.Universe();
+    return false;
+  }
+
+  // The DMP PDU is the last thing in the packet, and the E1.31 header
+  // immediately precedes it.
+  m_size = PreamblePacker::ACN_HEADER_SIZE + size;
+  m_slot_count = buffer.Size();
+  m_slot_offset = m_size - m_slot_count;
+  m_header_offset = m_size - dmp_pdu->Size() - e131_pdu.HeaderSize();
+  m_is_rev2 = header.UsingRev2();
+  m_destination = IPV4SocketAddress(addr, ola::acn::ACN_PORT);
+  return true;
+}
+
+
+void E131PacketTemplate::Update(uint8_t priority,
+                                uint8_t sequence,
+                                bool preview,
+                                const DmxBuffer &buffer) {
+  uint8_t *header = m_data + m_header_offset;
+  if (m_is_rev2) {
+    header[offsetof(E131Rev2Header::e131_rev2_pdu_header, priority)] =
+        priority;
+    header[offsetof(E131Rev2Header::e131_rev2_pdu_header, sequence)] =
+        sequence;
+  } else {
+    header[offsetof(E131Header::e131_pdu_header, priority)] = priority;
+    header[offsetof(E131Header::e131_pdu_header, sequence)] = sequence;
+    header[offsetof(E131Header::e131_pdu_header, options)] =
+        preview ? E131Header::PREVIEW_DATA_MASK : 0;
+  }
+
+  if (m_slot_count) {
+    memcpy(m_data + m_slot_offset, buffer.GetRaw(), m_slot_count);
+  }
+}
+}  // namespace acn
+}  // namespace ola
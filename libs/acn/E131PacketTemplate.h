@@ -0,0 +1,116 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * E131PacketTemplate.h
+ * A pre-built E1.31 data packet for a single universe.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef LIBS_ACN_E131PACKETTEMPLATE_H_
+#define LIBS_ACN_E131PACKETTEMPLATE_H_
+
+#include <stdint.h>
+#include "ola/DmxBuffer.h"
+#include "ola/acn/CID.h"
+#include "ola/base/Macro.h"
+#include "ola/network/SocketAddress.h"
+#include "libs/acn/E131Header.h"
+#include "libs/acn/PreamblePacker.h"
+
+namespace ola {
+namespace acn {
+
+/**
+ * @brief A fully packed E1.31 data packet, which can be updated in place.
+ *
+ * Most of an E1.31 data packet, the ACN preamble, the root layer, the source
+ * name, the universe and the DMP layer, doesn't change from one frame to the
+ * next. Building the packet once with the PDU classes and then patching the
+ * priority, sequence number, options and slot data means steady state
+ * transmission doesn't allocate any memory.
+ *
+ * The template has to be rebuilt if the number of slots changes, since that
+ * changes the length fields of every layer.
+ */
+class E131PacketTemplate {
+ public:
+  E131PacketTemplate();
+  ~E131PacketTemplate() {}
+
+  /**
+   * @brief Build the packet.
+   * @param cid the CID of the sender.
+   * @param header the E131Header to use.
+   * @param buffer the DMX data.
+   * @returns true if the packet was built, false otherwise.
+   */
+  bool Build(const ola::acn::CID &cid,
+             const E131Header &header,
+             const DmxBuffer &buffer);
+
+  /**
+   * @brief Check if the packet can be updated with a DmxBuffer.
+   * @param buffer the DMX data that will be sent.
+   * @returns true if Update() can be called, false if the packet needs to be
+   *   rebuilt.
+   */
+  bool CanUpdate(const DmxBuffer &buffer) const {
+    return m_size && buffer.Size() == m_slot_count;
+  }
+
+  /**
+   * @brief Update the per-frame fields of the packet.
+   * @param priority the priority of the data.
+   * @param sequence the sequence number.
+   * @param preview true if this is preview data.
+   * @param buffer the DMX data.
+   * @pre CanUpdate(buffer) is true.
+   */
+  void Update(uint8_t priority,
+              uint8_t sequence,
+              bool preview,
+              const DmxBuffer &buffer);
+
+  /**
+   * @brief The packed data, including the ACN preamble.
+   */
+  const uint8_t *Data() const { return m_data; }
+
+  /**
+   * @brief The size of the packed data.
+   */
+  unsigned int Size() const { return m_size; }
+
+  /**
+   * @brief The address the packet should be sent to.
+   */
+  const ola::network::IPV4SocketAddress &Destination() const {
+    return m_destination;
+  }
+
+ private:
+  uint8_t m_data[PreamblePacker::MAX_DATAGRAM_SIZE];
+  unsigned int m_size;
+  unsigned int m_header_offset;
+  unsigned int m_slot_offset;
+  unsigned int m_slot_count;
+  bool m_is_rev2;
+  ola::network::IPV4SocketAddress m_destination;
+
+  DISALLOW_COPY_AND_ASSIGN(E131PacketTemplate);
+};
+}  // namespace acn
+}  // namespace ola
+#endif  // LIBS_ACN_E131PACKETTEMPLATE_H_
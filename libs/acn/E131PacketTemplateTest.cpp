@@ -0,0 +1,223 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * E131PacketTemplateTest.cpp
+ * Test fixture for the E131PacketTemplate class
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <string>
+#include <vector>
+
+#include "ola/Constants.h"
+#include "ola/DmxBuffer.h"
+#include "ola/acn/ACNPort.h"
+#include "ola/acn/ACNVectors.h"
+#include "ola/acn/CID.h"
+#include "ola/network/SocketAddress.h"
+#include "libs/acn/DMPAddress.h"
+#include "libs/acn/DMPPDU.h"
+#include "libs/acn/E131Header.h"
+#include "libs/acn/E131PDU.h"
+#include "libs/acn/E131PacketTemplate.h"
+#include "libs/acn/PreamblePacker.h"
+#include "libs/acn/RootPDU.h"
+#include "ola/testing/TestUtils.h"
+
+namespace ola {
+namespace acn {
+
+using ola::DmxBuffer;
+using ola::network::IPV4SocketAddress;
+using std::string;
+using std::vector;
+
+class E131PacketTemplateTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(E131PacketTemplateTest);
+  CPPUNIT_TEST(testBuild);
+  CPPUNIT_TEST(testUpdate);
+  CPPUNIT_TEST(testRev2);
+  CPPUNIT_TEST(testSizeChange);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    void testBuild();
+    void testUpdate();
+    void testRev2();
+    void testSizeChange();
+
+ private:
+    CID m_cid;
+
+    void CheckAgainstPDUs(const E131Header &header,
+                          const DmxBuffer &buffer,
+                          const E131PacketTemplate &packet);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(E131PacketTemplateTest);
+
+
+/*
+ * Pack the packet the long way, using the PDU classes, and check it matches
+ * the template.
+ */
+void E131PacketTemplateTest::CheckAgainstPDUs(
+    const E131Header &header,
+    const DmxBuffer &buffer,
+    const E131PacketTemplate &packet) {
+  uint8_t dmp_data[DMX_UNIVERSE_SIZE + 1];
+  unsigned int dmp_data_length = DMX_UNIVERSE_SIZE;
+  if (header.UsingRev2()) {
+    buffer.Get(dmp_data, &dmp_data_length);
+  } else {
+    dmp_data[0] = 0;
+    buffer.Get(dmp_data + 1, &dmp_data_length);
+    dmp_data_length++;
+  }
+
+  TwoByteRangeDMPAddress range_addr(0, 1,
+                                    static_cast<uint16_t>(dmp_data_length));
+  DMPAddressData<TwoByteRangeDMPAddress> range_chunk(&range_addr,
+                                                     dmp_data,
+                                                     dmp_data_length);
+  vector<DMPAddressData<TwoByteRangeDMPAddress> > ranged_chunks;
+  ranged_chunks.push_back(range_chunk);
+  const DMPPDU *dmp_pdu = NewRangeDMPSetProperty<uint16_t>(true, false,
+                                                           ranged_chunks);
+
+  E131PDU e131_pdu(ola::acn::VECTOR_E131_DATA, header, dmp_pdu);
+  PDUBlock<PDU> e131_block;
+  e131_block.AddPDU(&e131_pdu);
+  RootPDU root_pdu(header.UsingRev2() ? ola::acn::VECTOR_ROOT_E131_REV2 :
+                                        ola::acn::VECTOR_ROOT_E131,
+                   m_cid, &e131_block);
+  PDUBlock<PDU> root_block;
+  root_block.AddPDU(&root_pdu);
+
+  PreamblePacker packer;
+  unsigned int length;
+  const uint8_t *expected = packer.Pack(root_block, &length);
+  OLA_ASSERT_NOT_NULL(expected);
+  OLA_ASSERT_DATA_EQUALS(expected, length, packet.Data(), packet.Size());
+  delete dmp_pdu;
+}
+
+
+/*
+ * Check a freshly built template matches the PDU classes.
+ */
+void E131PacketTemplateTest::testBuild() {
+  m_cid = CID::Generate();
+  DmxBuffer buffer;
+  buffer.SetFromString("1,2,3,4,5,255");
+
+  E131PacketTemplate packet;
+  OLA_ASSERT_FALSE(packet.CanUpdate(buffer));
+
+  E131Header header("foo source", 100, 7, 3, false, false, false);
+  OLA_ASSERT(packet.Build(m_cid, header, buffer));
+  OLA_ASSERT(packet.CanUpdate(buffer));
+  CheckAgainstPDUs(header, buffer, packet);
+
+  IPV4SocketAddress expected_destination(
+      ola::network::IPV4Address::FromStringOrDie("239.255.0.3"),
+      ola::acn::ACN_PORT);
+  OLA_ASSERT_EQ(expected_destination, packet.Destination());
+
+  // a full universe
+  buffer.Blackout();
+  buffer.SetChannel(511, 42);
+  OLA_ASSERT(packet.Build(m_cid, header, buffer));
+  CheckAgainstPDUs(header, buffer, packet);
+
+  // no slots
+  buffer.Reset();
+  OLA_ASSERT(packet.Build(m_cid, header, buffer));
+  OLA_ASSERT(packet.CanUpdate(buffer));
+  CheckAgainstPDUs(header, buffer, packet);
+}
+
+
+/*
+ * Check that updating a template in place matches the PDU classes.
+ */
+void E131PacketTemplateTest::testUpdate() {
+  m_cid = CID::Generate();
+  DmxBuffer buffer;
+  buffer.SetFromString("1,2,3,4,5,255");
+
+  E131PacketTemplate packet;
+  E131Header header("foo source", 100, 7, 3, false, false, false);
+  OLA_ASSERT(packet.Build(m_cid, header, buffer));
+
+  buffer.SetFromString("10,20,30,40,50,60");
+  OLA_ASSERT(packet.CanUpdate(buffer));
+  packet.Update(150, 8, true, buffer);
+  CheckAgainstPDUs(E131Header("foo source", 150, 8, 3, true, false, false),
+                   buffer, packet);
+
+  // clear the preview flag
+  packet.Update(150, 9, false, buffer);
+  CheckAgainstPDUs(E131Header("foo source", 150, 9, 3, false, false, false),
+                   buffer, packet);
+}
+
+
+/*
+ * Check that rev 0.2 packets, which don't have a start code or options, can
+ * be updated.
+ */
+void E131PacketTemplateTest::testRev2() {
+  m_cid = CID::Generate();
+  DmxBuffer buffer;
+  buffer.SetFromString("1,2,3,4,5,255");
+
+  E131PacketTemplate packet;
+  E131Header header("foo source", 100, 7, 3, false, false, true);
+  OLA_ASSERT(packet.Build(m_cid, header, buffer));
+  CheckAgainstPDUs(header, buffer, packet);
+
+  buffer.SetFromString("6,5,4,3,2,1");
+  packet.Update(50, 200, false, buffer);
+  CheckAgainstPDUs(E131Header("foo source", 50, 200, 3, false, false, true),
+                   buffer, packet);
+}
+
+
+/*
+ * Check that a change in size requires the template to be rebuilt.
+ */
+void E131PacketTemplateTest::testSizeChange() {
+  m_cid = CID::Generate();
+  DmxBuffer buffer;
+  buffer.SetFromString("1,2,3");
+
+  E131PacketTemplate packet;
+  E131Header header("foo source", 100, 0, 1, false, false, false);
+  OLA_ASSERT(packet.Build(m_cid, header, buffer));
+  OLA_ASSERT(packet.CanUpdate(buffer));
+
+  DmxBuffer larger;
+  larger.SetFromString("1,2,3,4");
+  OLA_ASSERT_FALSE(packet.CanUpdate(larger));
+
+  OLA_ASSERT(packet.Build(m_cid, header, larger));
+  OLA_ASSERT(packet.CanUpdate(larger));
+  OLA_ASSERT_FALSE(packet.CanUpdate(buffer));
+  CheckAgainstPDUs(header, larger, packet);
+}
+}  // namespace acn
+}  // namespace ola
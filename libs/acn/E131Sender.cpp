@@ -27,6 +27,7 @@
 #include "libs/acn/E131Inflator.h"
 #include "libs/acn/E131Sender.h"
 #include "libs/acn/E131PDU.h"
+#include "libs/acn/E131PacketTemplate.h"
 #include "libs/acn/RootSender.h"
 #include "libs/acn/UDPTransport.h"
 
@@ -78,6 +79,16 @@ bool E131Sender::SendDMP(const E131Header &header, const DMPPDU *dmp_pdu) {
   return m_root_sender->SendPDU(vector, pdu, &transport);
 }
 
+/*
+ * Send a pre-built data packet.
+ * @param packet the E131PacketTemplate to send.
+ */
+bool E131Sender::SendPacket(const E131PacketTemplate &packet) {
+  ssize_t bytes_sent = m_socket->SendTo(packet.Data(), packet.Size(),
+                                        packet.Destination());
+  return bytes_sent == static_cast<ssize_t>(packet.Size());
+}
+
 bool E131Sender::SendDiscoveryData(const E131Header &header,
                                    const uint8_t *data,
                                    unsigned int data_size) {
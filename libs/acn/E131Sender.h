@@ -41,6 +41,7 @@ class E131Sender {
   ~E131Sender() {}
 
   bool SendDMP(const E131Header &header, const DMPPDU *pdu);
+  bool SendPacket(const class E131PacketTemplate &packet);
   bool SendDiscoveryData(const E131Header &header, const uint8_t *data,
                          unsigned int data_size);
 
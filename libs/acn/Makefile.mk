@@ -49,6 +49,8 @@ libs_acn_libolae131core_la_SOURCES = \
     libs/acn/E131Node.h \
     libs/acn/E131PDU.cpp \
     libs/acn/E131PDU.h \
+    libs/acn/E131PacketTemplate.cpp \
+    libs/acn/E131PacketTemplate.h \
     libs/acn/E131Sender.cpp \
     libs/acn/E131Sender.h \
     libs/acn/E133Header.h \
@@ -117,7 +119,9 @@ libs_acn_E131Tester_SOURCES = \
     libs/acn/DMPInflatorTest.cpp \
     libs/acn/DMPPDUTest.cpp \
     libs/acn/E131InflatorTest.cpp \
+    libs/acn/E131NodeTest.cpp \
     libs/acn/E131PDUTest.cpp \
+    libs/acn/E131PacketTemplateTest.cpp \
     libs/acn/HeaderSetTest.cpp \
     libs/acn/PDUTest.cpp \
     libs/acn/RootInflatorTest.cpp \
@@ -19,6 +19,7 @@
  */
 
 #include <string.h>
+#include <string>
 
 #include "ola/Callback.h"
 #include "ola/Logging.h"
@@ -63,46 +64,57 @@ bool OutgoingUDPTransportImpl::Send(const PDUBlock<PDU> &pdu_block,
 
 
 IncomingUDPTransport::IncomingUDPTransport(ola::network::UDPSocket *socket,
-                                           BaseInflator *inflator)
+                                           BaseInflator *inflator,
+                                           ola::ExportMap *export_map,
+                                           const std::string &name)
     : m_socket(socket),
       m_inflator(inflator),
-      m_recv_buffer(NULL) {
+      m_ring(RECEIVE_BATCH_SIZE, PreamblePacker::MAX_DATAGRAM_SIZE,
+             export_map, name) {
 }
 
 
 /*
- * Called when new data arrives.
+ * Called when new data arrives. We keep reading until the socket is empty so
+ * a burst of datagrams only costs a single wakeup.
  */
 void IncomingUDPTransport::Receive() {
-  if (!m_recv_buffer)
-    m_recv_buffer = new uint8_t[PreamblePacker::MAX_DATAGRAM_SIZE];
-
-  ssize_t size = PreamblePacker::MAX_DATAGRAM_SIZE;
-  ola::network::IPV4SocketAddress source;
+  unsigned int count;
+  do {
+    count = m_ring.Receive(m_socket);
+    for (unsigned int i = 0; i < count; i++) {
+      HandleDatagram(m_ring.Datagram(i));
+    }
+  } while (m_ring.Full());
+}
 
-  if (!m_socket->RecvFrom(m_recv_buffer, &size, &source))
-    return;
 
+/*
+ * Check the ACN header and pass the rest of the datagram to the inflator.
+ */
+void IncomingUDPTransport::HandleDatagram(
+    const ola::network::IncomingDatagram &datagram) {
   unsigned int header_size = PreamblePacker::ACN_HEADER_SIZE;
-  if (size < static_cast<ssize_t>(header_size)) {
+  if (datagram.size < header_size) {
     OLA_WARN << "short ACN frame, discarding";
+    m_ring.CountDrop();
     return;
   }
 
-  if (memcmp(m_recv_buffer, PreamblePacker::ACN_HEADER, header_size)) {
+  if (memcmp(datagram.data, PreamblePacker::ACN_HEADER, header_size)) {
     OLA_WARN << "ACN header is bad, discarding";
+    m_ring.CountDrop();
     return;
   }
 
   HeaderSet header_set;
-  TransportHeader transport_header(source, TransportHeader::UDP);
+  TransportHeader transport_header(datagram.source, TransportHeader::UDP);
   header_set.SetTransportHeader(transport_header);
 
   m_inflator->InflatePDUBlock(
       &header_set,
-      m_recv_buffer + header_size,
-      static_cast<unsigned int>(size) - header_size);
-  return;
+      datagram.data + header_size,
+      datagram.size - header_size);
 }
 }  // namespace acn
 }  // namespace ola
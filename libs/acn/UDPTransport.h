@@ -21,9 +21,13 @@
 #ifndef LIBS_ACN_UDPTRANSPORT_H_
 #define LIBS_ACN_UDPTRANSPORT_H_
 
+#include <string>
+
+#include "ola/ExportMap.h"
 #include "ola/acn/ACNPort.h"
 #include "ola/network/IPV4Address.h"
 #include "ola/network/Socket.h"
+#include "ola/network/UDPReceiveRing.h"
 #include "libs/acn/PDU.h"
 #include "libs/acn/PreamblePacker.h"
 #include "libs/acn/Transport.h"
@@ -93,19 +97,35 @@ class OutgoingUDPTransportImpl {
  */
 class IncomingUDPTransport {
  public:
+    /**
+     * @brief Create a new IncomingUDPTransport.
+     * @param socket the socket to read from.
+     * @param inflator the inflator to pass received PDUs to.
+     * @param export_map if not NULL, receive counters are exported here.
+     * @param name the name to export the counters under.
+     */
     IncomingUDPTransport(ola::network::UDPSocket *socket,
-                         class BaseInflator *inflator);
-    ~IncomingUDPTransport() {
-      if (m_recv_buffer)
-        delete[] m_recv_buffer;
-    }
+                         class BaseInflator *inflator,
+                         ola::ExportMap *export_map = NULL,
+                         const std::string &name = "acn");
+    ~IncomingUDPTransport() {}
 
+    /**
+     * @brief Called when the socket is readable, this drains the socket.
+     */
     void Receive();
 
+    /**
+     * @brief The maximum number of datagrams read with a single system call.
+     */
+    static const unsigned int RECEIVE_BATCH_SIZE = 16;
+
  private:
     ola::network::UDPSocket *m_socket;
     class BaseInflator *m_inflator;
-    uint8_t *m_recv_buffer;
+    ola::network::UDPReceiveRing m_ring;
+
+    void HandleDatagram(const ola::network::IncomingDatagram &datagram);
 };
 }  // namespace acn
 }  // namespace ola
@@ -20,8 +20,10 @@
 
 #include <stdlib.h>
 #include <algorithm>
+#include <iostream>
 #include <string>
 #include "ola/Callback.h"
+#include "ola/Clock.h"
 #include "ola/DmxBuffer.h"
 #include "ola/Logging.h"
 #include "ola/base/Flags.h"
@@ -29,14 +31,22 @@
 #include "ola/io/SelectServer.h"
 #include "libs/acn/E131Node.h"
 
+using ola::Clock;
 using ola::DmxBuffer;
+using ola::TimeInterval;
+using ola::TimeStamp;
 using ola::io::SelectServer;
 using ola::acn::E131Node;
 using ola::NewCallback;
+using std::cout;
+using std::endl;
 using std::min;
 
 DEFINE_s_uint32(fps, s, 10, "Frames per second per universe [1 - 40]");
 DEFINE_s_uint16(universes, u, 1, "Number of universes to send");
+DEFINE_default_bool(benchmark, false,
+                    "Send as fast as possible and report universes / second");
+DEFINE_uint32(frames, 1000, "Number of frames per universe in benchmark mode");
 
 /**
  * Send N DMX frames using E1.31, where N is given by number_of_universes.
@@ -49,6 +59,40 @@ bool SendFrames(E131Node *node, DmxBuffer *buffer,
   return true;
 }
 
+/**
+ * Send each universe frame_count times, as fast as possible, and report the
+ * rate.
+ */
+int RunBenchmark(E131Node *node, DmxBuffer *buffer,
+                 uint16_t number_of_universes, unsigned int frame_count) {
+  Clock clock;
+  TimeStamp start, end;
+  unsigned int failures = 0;
+
+  clock.CurrentTime(&start);
+  for (unsigned int frame = 0; frame < frame_count; frame++) {
+    // Change the data each frame, so the slot copy isn't optimized away.
+    buffer->SetChannel(0, static_cast<uint8_t>(frame));
+    for (uint16_t i = 1; i < number_of_universes + 1; i++) {
+      if (!node->SendDMX(i, *buffer)) {
+        failures++;
+      }
+    }
+  }
+  clock.CurrentTime(&end);
+
+  TimeInterval elapsed = end - start;
+  uint64_t sent = static_cast<uint64_t>(frame_count) * number_of_universes;
+  double seconds = elapsed.AsInt() / 1000000.0;
+  cout << "Sent " << sent << " universes in " << elapsed << " ("
+       << failures << " failed)" << endl;
+  if (seconds > 0) {
+    cout << static_cast<uint64_t>(sent / seconds) << " universes / sec"
+         << endl;
+  }
+  return failures ? 1 : 0;
+}
+
 int main(int argc, char* argv[]) {
   ola::AppInit(&argc, argv, "", "Run the E1.31 load test.");
 
@@ -66,6 +110,10 @@ int main(int argc, char* argv[]) {
   if (!node.Start())
     return -1;
 
+  if (FLAGS_benchmark) {
+    return RunBenchmark(&node, &output, universes, FLAGS_frames);
+  }
+
   ss.AddReadDescriptor(node.GetSocket());
   ss.RegisterRepeatingTimeout(
       1000 / fps,
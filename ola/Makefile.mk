@@ -26,6 +26,7 @@ ola_libola_la_SOURCES = \
     ola/OlaClientCore.h \
     ola/OlaClientCore.cpp \
     ola/OlaClientWrapper.cpp \
+    ola/SharedMemoryClient.cpp \
     ola/StreamingClient.cpp
 ola_libola_la_CXXFLAGS = $(COMMON_PROTOBUF_CXXFLAGS)
 ola_libola_la_LDFLAGS = -version-info 1:1:0
@@ -164,6 +164,14 @@ void OlaClient::SendDMX(unsigned int universe,
   m_core->SendDMX(universe, data, args);
 }
 
+void OlaClient::BeginBatch() {
+  m_core->BeginBatch();
+}
+
+bool OlaClient::EndBatch() {
+  return m_core->EndBatch();
+}
+
 void OlaClient::FetchDMX(unsigned int universe, DMXCallback *callback) {
   m_core->FetchDMX(universe, callback);
 }
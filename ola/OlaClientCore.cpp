@@ -29,6 +29,7 @@
 #include <vector>
 
 #include "common/protocol/Ola.pb.h"
+#include "common/rpc/DmxDataCodec.h"
 #include "ola/Callback.h"
 #include "ola/ClientTypesFactory.h"
 #include "ola/Constants.h"
@@ -57,7 +58,16 @@ const char OlaClientCore::NOT_CONNECTED_ERROR[] = "Not connected";
 
 OlaClientCore::OlaClientCore(ConnectedDescriptor *descriptor)
     : m_descriptor(descriptor),
-      m_connected(false) {
+      m_connected(false),
+      m_stream_dmx_method(
+          ola::proto::OlaClientService::descriptor()->FindMethodByName(
+              "StreamDmxData")),
+      m_update_dmx_method(
+          OlaServerService_Stub::descriptor()->FindMethodByName(
+              "UpdateDmxData")),
+      m_send_stream_dmx_method(
+          OlaServerService_Stub::descriptor()->FindMethodByName(
+              "StreamDmxData")) {
 }
 
 
@@ -453,6 +463,8 @@ void OlaClientCore::RegisterUniverse(unsigned int universe,
         ola::proto::UNREGISTER);
   request.set_universe(universe);
   request.set_action(action);
+  // We accept StreamDmxData, older servers ignore this and use UpdateDmxData.
+  request.set_streaming(true);
 
   if (m_connected) {
     CompletionCallback *cb = ola::NewSingleCallback(
@@ -469,10 +481,11 @@ void OlaClientCore::RegisterUniverse(unsigned int universe,
 void OlaClientCore::SendDMX(unsigned int universe,
                             const DmxBuffer &data,
                             const SendDMXArgs &args) {
-  ola::proto::DmxData request;
-  request.set_universe(universe);
-  request.set_data(data.Get());
-  request.set_priority(args.priority);
+  // The DMX data is sent straight from the DmxBuffer, rather than being
+  // copied into a DmxData message.
+  ola::rpc::DmxDataCodec codec;
+  ola::io::IOVec iov[ola::rpc::DmxDataCodec::MAX_IOVECS];
+  int iocnt = codec.Encode(universe, args.priority, data, iov);
 
   if (args.callback) {
     // Full request
@@ -484,15 +497,30 @@ void OlaClientCore::SendDMX(unsigned int universe,
           this,
           &OlaClientCore::HandleGeneralAck,
           controller, reply, args.callback);
-      m_stub->UpdateDmxData(controller, &request, reply, cb);
+      m_channel->CallMethod(m_update_dmx_method, controller, iov, iocnt,
+                            reply, cb);
      } else {
       controller->SetFailed(NOT_CONNECTED_ERROR);
       HandleGeneralAck(controller, reply, args.callback);
      }
   } else if (m_connected) {
     // stream data
-    m_stub->StreamDmxData(NULL, &request, NULL, NULL);
+    m_channel->CallMethod(m_send_stream_dmx_method, NULL, iov, iocnt, NULL,
+                          NULL);
+  }
+}
+
+void OlaClientCore::BeginBatch() {
+  if (m_channel.get()) {
+    m_channel->Cork();
+  }
+}
+
+bool OlaClientCore::EndBatch() {
+  if (!m_channel.get()) {
+    return false;
   }
+  return m_channel->Uncork();
 }
 
 void OlaClientCore::FetchDMX(unsigned int universe,
@@ -625,18 +653,40 @@ void OlaClientCore::UpdateDmxData(ola::rpc::RpcController*,
                                   const ola::proto::DmxData *request,
                                   ola::proto::Ack*,
                                   CompletionCallback *done) {
-  if (m_dmx_callback.get()) {
-    DmxBuffer buffer;
-    buffer.Set(request->data());
+  RunDmxCallback(request->universe(), request->has_priority(),
+                 request->priority(),
+                 reinterpret_cast<const uint8_t*>(request->data().data()),
+                 request->data().size());
+  done->Run();
+}
 
-    uint8_t priority = 0;
-    if (request->has_priority()) {
-      priority = request->priority();
-    }
-    DMXMetadata metadata(request->universe(), priority);
-    m_dmx_callback->Run(metadata, buffer);
+void OlaClientCore::StreamDmxData(ola::rpc::RpcController*,
+                                  const ola::proto::DmxData *request,
+                                  ola::proto::STREAMING_NO_RESPONSE*,
+                                  CompletionCallback*) {
+  RunDmxCallback(request->universe(), request->has_priority(),
+                 request->priority(),
+                 reinterpret_cast<const uint8_t*>(request->data().data()),
+                 request->data().size());
+}
+
+bool OlaClientCore::HandleRawStreamRequest(
+    const google::protobuf::MethodDescriptor *method,
+    ola::rpc::RpcController*,
+    const uint8_t *data,
+    unsigned int size) {
+  if (method != m_stream_dmx_method) {
+    return false;
   }
-  done->Run();
+
+  ola::rpc::DmxDataFields fields;
+  if (!ola::rpc::DmxDataCodec::Decode(data, size, &fields)) {
+    // Let the protobuf parser report the error.
+    return false;
+  }
+  RunDmxCallback(fields.universe, fields.has_priority, fields.priority,
+                 fields.data, fields.length);
+  return true;
 }
 
 void OlaClientCore::ChannelClosed(ClosedCallback *callback,
@@ -644,6 +694,20 @@ void OlaClientCore::ChannelClosed(ClosedCallback *callback,
   callback->Run();
 }
 
+void OlaClientCore::RunDmxCallback(unsigned int universe,
+                                   bool has_priority,
+                                   uint8_t priority,
+                                   const uint8_t *data,
+                                   unsigned int length) {
+  if (!m_dmx_callback.get()) {
+    return;
+  }
+
+  m_dmx_buffer.Set(data, length);
+  DMXMetadata metadata(universe, has_priority ? priority : 0);
+  m_dmx_callback->Run(metadata, m_dmx_buffer);
+}
+
 
 // The following are RPC callbacks
 
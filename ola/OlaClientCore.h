@@ -246,6 +246,22 @@ class OlaClientCore: public ola::proto::OlaClientService {
                const DmxBuffer &data,
                const SendDMXArgs &args);
 
+  /**
+   * @brief Start a batch of calls.
+   *
+   * Calls made before the matching EndBatch() are held back and written to
+   * the server together, which is cheaper than writing each one on its own.
+   * This is useful when sending DMX for several universes at once.
+   */
+  void BeginBatch();
+
+  /**
+   * @brief Send the calls made since BeginBatch().
+   * @returns false if the calls couldn't be written to the server, in which
+   *   case the connection is closed.
+   */
+  bool EndBatch();
+
   /**
    * @brief Fetch the latest DMX data for a universe.
    * @param universe the universe id to get data for.
@@ -322,15 +338,45 @@ class OlaClientCore: public ola::proto::OlaClientService {
                      ola::proto::Ack* response,
                      CompletionCallback* done);
 
+  /**
+   * @brief This is called by the channel when streamed DMX data arrives.
+   */
+  void StreamDmxData(ola::rpc::RpcController* controller,
+                     const ola::proto::DmxData* request,
+                     ola::proto::STREAMING_NO_RESPONSE* response,
+                     CompletionCallback* done);
+
+  /**
+   * @brief Handle streamed DMX data without parsing a DmxData message.
+   */
+  bool HandleRawStreamRequest(const google::protobuf::MethodDescriptor *method,
+                              ola::rpc::RpcController *controller,
+                              const uint8_t *data,
+                              unsigned int size);
+
  private:
   ola::io::ConnectedDescriptor *m_descriptor;
   std::auto_ptr<RepeatableDMXCallback> m_dmx_callback;
   std::auto_ptr<ola::rpc::RpcChannel> m_channel;
   std::auto_ptr<ola::proto::OlaServerService_Stub> m_stub;
   int m_connected;
+  const google::protobuf::MethodDescriptor *m_stream_dmx_method;
+  // The methods used to send DMX to olad, looked up once.
+  const google::protobuf::MethodDescriptor *m_update_dmx_method;
+  const google::protobuf::MethodDescriptor *m_send_stream_dmx_method;
+  DmxBuffer m_dmx_buffer;  // reused for incoming DMX data
 
   void ChannelClosed(ClosedCallback *callback, ola::rpc::RpcSession *session);
 
+  /**
+   * @brief Run the DMX callback for new data.
+   */
+  void RunDmxCallback(unsigned int universe,
+                      bool has_priority,
+                      uint8_t priority,
+                      const uint8_t *data,
+                      unsigned int length);
+
   /**
    * @brief Called when GetPlugins() completes.
    */
@@ -0,0 +1,133 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * SharedMemoryClient.cpp
+ * Send DMX data to olad using shared memory.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <ola/Clock.h>
+#include <ola/DmxBuffer.h>
+#include <ola/Logging.h>
+#include <ola/client/SharedMemoryClient.h>
+#include <ola/dmx/SharedDmxRegion.h>
+#include <ola/network/IPV4Address.h>
+#include <ola/network/Socket.h>
+#include <ola/network/SocketAddress.h>
+
+namespace ola {
+namespace client {
+
+using ola::dmx::SharedDmxRegion;
+using ola::network::IPV4Address;
+using ola::network::IPV4SocketAddress;
+using ola::network::UDPSocket;
+using std::auto_ptr;
+
+SharedMemoryClient::SharedMemoryClient(const Options &options)
+    : m_server_port(options.server_port) {
+}
+
+SharedMemoryClient::~SharedMemoryClient() {
+  Stop();
+}
+
+bool SharedMemoryClient::Setup() {
+  if (m_region.get()) {
+    return false;
+  }
+
+  auto_ptr<SharedDmxRegion> region(
+      SharedDmxRegion::Open(SharedDmxRegion::NameForPort(m_server_port)));
+  if (!region.get()) {
+    OLA_WARN << "Failed to open the shared memory region, is olad running "
+             << "with --shared-memory?";
+    return false;
+  }
+
+  auto_ptr<UDPSocket> doorbell(new UDPSocket());
+  if (!doorbell->Init()) {
+    return false;
+  }
+
+  m_region.reset(region.release());
+  m_doorbell.reset(doorbell.release());
+  return true;
+}
+
+void SharedMemoryClient::Stop() {
+  m_slots.clear();
+  m_doorbell.reset();
+  m_region.reset();
+}
+
+bool SharedMemoryClient::SendDmx(unsigned int universe,
+                                 const DmxBuffer &data) {
+  SendArgs args;
+  return SendDMX(universe, data, args);
+}
+
+bool SharedMemoryClient::SendDMX(unsigned int universe,
+                                 const DmxBuffer &data,
+                                 const SendArgs &args) {
+  if (!m_region.get()) {
+    OLA_WARN << "Not connected to the shared memory region";
+    return false;
+  }
+
+  if (!m_region->IsActive()) {
+    // olad has shut down or restarted, Setup() must be called again.
+    OLA_WARN << "The shared memory region has been closed";
+    Stop();
+    return false;
+  }
+
+  int slot;
+  SlotMap::const_iterator iter = m_slots.find(universe);
+  if (iter == m_slots.end()) {
+    slot = m_region->SlotForUniverse(universe);
+    if (slot < 0) {
+      OLA_WARN << "No free shared memory slots for universe " << universe;
+      return false;
+    }
+    m_slots[universe] = slot;
+  } else {
+    slot = iter->second;
+  }
+
+  TimeStamp now;
+  m_clock.CurrentTime(&now);
+  if (!m_region->Write(slot, args.priority, data, now)) {
+    OLA_WARN << "Timed out waiting for shared memory slot " << slot;
+    return false;
+  }
+
+  if (m_region->RingDoorbell()) {
+    RingDoorbell();
+  }
+  return true;
+}
+
+void SharedMemoryClient::RingDoorbell() {
+  uint16_t port = m_region->DoorbellPort();
+  if (!port) {
+    return;
+  }
+  const uint8_t doorbell = 1;
+  m_doorbell->SendTo(&doorbell, sizeof(doorbell),
+                     IPV4SocketAddress(IPV4Address::Loopback(), port));
+}
+}  // namespace client
+}  // namespace ola
@@ -21,6 +21,7 @@
 #include <ola/AutoStart.h>  // NOLINT(build/include)
 // ola/StreamingClient.h deprecated
 #include <ola/Callback.h>
+#include <ola/Clock.h>
 #include <ola/Constants.h>
 #include <ola/DmxBuffer.h>
 #include <ola/Logging.h>
@@ -32,7 +33,10 @@
 
 #include "common/protocol/Ola.pb.h"
 #include "common/protocol/OlaService.pb.h"
+#include "common/rpc/BinaryDmxFrame.h"
+#include "common/rpc/DmxDataCodec.h"
 #include "common/rpc/RpcChannel.h"
+#include "common/rpc/RpcController.h"
 #include "common/rpc/RpcSession.h"
 
 namespace ola {
@@ -41,25 +45,32 @@ namespace client {
 using ola::io::SelectServer;
 using ola::network::TCPSocket;
 using ola::proto::OlaServerService_Stub;
+using ola::rpc::BinaryDmxFrame;
 using ola::rpc::RpcChannel;
 
 StreamingClient::StreamingClient(bool auto_start)
     : m_auto_start(auto_start),
       m_server_port(OLA_DEFAULT_PORT),
+      m_request_binary_stream(false),
+      m_binary_stream(false),
       m_socket(NULL),
       m_ss(NULL),
       m_channel(NULL),
       m_stub(NULL),
+      m_stream_dmx_method(NULL),
       m_socket_closed(false) {
 }
 
 StreamingClient::StreamingClient(const Options &options)
     : m_auto_start(options.auto_start),
       m_server_port(options.server_port),
+      m_request_binary_stream(options.binary_stream),
+      m_binary_stream(false),
       m_socket(NULL),
       m_ss(NULL),
       m_channel(NULL),
       m_stub(NULL),
+      m_stream_dmx_method(NULL),
       m_socket_closed(false) {
 }
 
@@ -93,6 +104,8 @@ bool StreamingClient::Setup() {
   }
 
   m_stub = new OlaServerService_Stub(m_channel);
+  m_stream_dmx_method =
+      OlaServerService_Stub::descriptor()->FindMethodByName("StreamDmxData");
 
   if (!m_stub) {
     delete m_channel;
@@ -105,6 +118,10 @@ bool StreamingClient::Setup() {
   m_channel->SetChannelCloseHandler(
       NewSingleCallback(this, &StreamingClient::ChannelClosed));
 
+  if (m_request_binary_stream && !NegotiateBinaryStream()) {
+    Stop();
+    return false;
+  }
   return true;
 }
 
@@ -125,6 +142,7 @@ void StreamingClient::Stop() {
   m_socket = NULL;
   m_ss = NULL;
   m_stub = NULL;
+  m_binary_stream = false;
 }
 
 bool StreamingClient::SendDmx(unsigned int universe,
@@ -143,6 +161,9 @@ bool StreamingClient::Send(unsigned int universe, uint8_t priority,
   if (!m_stub || !m_socket->ValidReadDescriptor())
     return false;
 
+  if (m_binary_stream)
+    return SendBinary(universe, priority, data);
+
   // We select() on the fd here to see if the remove end has closed the
   // connection. We could skip this and rely on the EPIPE delivered by the
   // write() below, but that introduces a race condition in the unittests.
@@ -154,11 +175,12 @@ bool StreamingClient::Send(unsigned int universe, uint8_t priority,
     return false;
   }
 
-  ola::proto::DmxData request;
-  request.set_universe(universe);
-  request.set_data(data.Get());
-  request.set_priority(priority);
-  m_stub->StreamDmxData(NULL, &request, NULL, NULL);
+  // Send the data straight from the DmxBuffer, rather than copying it into a
+  // DmxData message.
+  ola::rpc::DmxDataCodec codec;
+  ola::io::IOVec iov[ola::rpc::DmxDataCodec::MAX_IOVECS];
+  int iocnt = codec.Encode(universe, priority, data, iov);
+  m_channel->CallMethod(m_stream_dmx_method, NULL, iov, iocnt, NULL, NULL);
 
   if (m_socket_closed) {
     Stop();
@@ -167,6 +189,73 @@ bool StreamingClient::Send(unsigned int universe, uint8_t priority,
   return true;
 }
 
+/*
+ * Send a DmxBuffer as a binary frame. Unlike Send() we don't poll the socket
+ * first, if olad has closed the connection the write will fail.
+ */
+bool StreamingClient::SendBinary(unsigned int universe, uint8_t priority,
+                                 const DmxBuffer &data) {
+  uint8_t header[BinaryDmxFrame::HEADER_SIZE];
+  BinaryDmxFrame::EncodeHeader(universe, priority, data.Size(), header);
+
+  ola::io::IOVec iov[2];
+  iov[0].iov_base = header;
+  iov[0].iov_len = sizeof(header);
+  iov[1].iov_base = const_cast<uint8_t*>(data.GetRaw());
+  iov[1].iov_len = data.Size();
+
+  if (!m_channel->SendRawFrame(iov, data.Size() ? 2 : 1) || m_socket_closed) {
+    Stop();
+    return false;
+  }
+  return true;
+}
+
+/*
+ * Ask olad to accept binary frames. If olad doesn't support them we fall back
+ * to sending StreamDmxData RPCs.
+ * @returns false if olad didn't respond.
+ */
+bool StreamingClient::NegotiateBinaryStream() {
+  ola::rpc::RpcController controller;
+  ola::proto::BinaryStreamRequest request;
+  ola::proto::BinaryStreamReply reply;
+  request.set_version(BinaryDmxFrame::STREAM_VERSION);
+
+  bool complete = false;
+  m_socket_closed = false;
+  m_stub->EnableBinaryStream(
+      &controller, &request, &reply,
+      NewSingleCallback(this, &StreamingClient::BinaryStreamReply, &complete));
+
+  Clock clock;
+  TimeStamp now;
+  clock.CurrentTime(&now);
+  const TimeStamp deadline = now + TimeInterval(
+      static_cast<int64_t>(BINARY_STREAM_TIMEOUT_MS) * ONE_THOUSAND);
+  while (!complete && !m_socket_closed && now < deadline) {
+    m_ss->RunOnce(TimeInterval(0, 100000));
+    clock.CurrentTime(&now);
+  }
+
+  if (!complete) {
+    OLA_WARN << "No response from olad when enabling the binary stream";
+    return false;
+  }
+
+  if (controller.Failed()) {
+    OLA_INFO << "Binary streams aren't supported, using RPCs: "
+             << controller.ErrorText();
+  } else {
+    m_binary_stream = reply.version() == BinaryDmxFrame::STREAM_VERSION;
+  }
+  return true;
+}
+
+void StreamingClient::BinaryStreamReply(bool *complete) {
+  *complete = true;
+}
+
 void StreamingClient::ChannelClosed(OLA_UNUSED ola::rpc::RpcSession *session) {
   m_socket_closed = true;
   OLA_WARN << "The RPC socket has been closed, this is more than likely due"
@@ -45,12 +45,14 @@ using std::auto_ptr;
 class StreamingClientTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(StreamingClientTest);
   CPPUNIT_TEST(testSendDMX);
+  CPPUNIT_TEST(testSendBinaryDMX);
   CPPUNIT_TEST_SUITE_END();
 
  public:
     void setUp();
     void tearDown();
     void testSendDMX();
+    void testSendBinaryDMX();
 
  private:
     class OlaServerThread *m_server_thread;
@@ -221,3 +223,41 @@ void StreamingClientTest::testSendDMX() {
 
   OLA_ASSERT_FALSE(ola_client.Setup());
 }
+
+
+/*
+ * Check that sending with a binary stream works.
+ */
+void StreamingClientTest::testSendBinaryDMX() {
+  m_server_thread->WaitForStart();
+  GenericSocketAddress server_address = m_server_thread->RPCAddress();
+  OLA_ASSERT_EQ(static_cast<uint16_t>(AF_INET), server_address.Family());
+  StreamingClient::Options options;
+  options.auto_start = false;
+  options.server_port = server_address.V4Addr().Port();
+  options.binary_stream = true;
+  StreamingClient ola_client(options);
+
+  ola::DmxBuffer buffer;
+  buffer.Blackout();
+
+  OLA_ASSERT_TRUE(ola_client.Setup());
+  OLA_ASSERT_TRUE(ola_client.BinaryStreamEnabled());
+  OLA_ASSERT_TRUE(ola_client.SendDmx(TEST_UNIVERSE, buffer));
+  ola_client.Stop();
+  OLA_ASSERT_FALSE(ola_client.BinaryStreamEnabled());
+
+  // Now Terminate the server mid flight. Since we don't poll before sending,
+  // the first send after the server has gone may succeed.
+  OLA_ASSERT_TRUE(ola_client.Setup());
+  OLA_ASSERT_TRUE(ola_client.SendDmx(TEST_UNIVERSE, buffer));
+  m_server_thread->Terminate();
+  m_server_thread->Join();
+
+  bool sent = true;
+  for (unsigned int i = 0; i < 10 && sent; i++) {
+    sent = ola_client.SendDmx(TEST_UNIVERSE, buffer);
+  }
+  OLA_ASSERT_FALSE(sent);
+  ola_client.Stop();
+}
@@ -22,7 +22,9 @@ ola_server_sources = \
     olad/PluginLoader.h \
     olad/PluginManager.cpp \
     olad/PluginManager.h \
-    olad/RDMHTTPModule.h
+    olad/RDMHTTPModule.h \
+    olad/SharedMemoryIngest.cpp \
+    olad/SharedMemoryIngest.h
 ola_server_additional_libs =
 
 if HAVE_DNSSD
@@ -76,6 +78,15 @@ if USE_FTDI
 olad_olad_LDADD += -lftdi -lusb
 endif
 
+noinst_PROGRAMS += olad/dmx_stream_benchmark
+olad_dmx_stream_benchmark_SOURCES = olad/dmx_stream_benchmark.cpp
+olad_dmx_stream_benchmark_CXXFLAGS = $(COMMON_PROTOBUF_CXXFLAGS)
+olad_dmx_stream_benchmark_LDADD = $(libprotobuf_LIBS) \
+                                  olad/plugin_api/libolaserverplugininterface.la \
+                                  olad/libolaserver.la \
+                                  common/libolacommon.la \
+                                  ola/libola.la
+
 # TESTS
 ##################################################
 test_programs += \
@@ -88,8 +99,10 @@ COMMON_OLAD_TEST_LDADD = $(COMMON_TESTING_LIBS) $(libprotobuf_LIBS) \
 
 olad_OlaTester_SOURCES = \
     olad/PluginManagerTest.cpp \
-    olad/OlaServerServiceImplTest.cpp
+    olad/OlaServerServiceImplTest.cpp \
+    olad/SharedMemoryIngestTest.cpp
 olad_OlaTester_CXXFLAGS = $(COMMON_TESTING_PROTOBUF_FLAGS)
-olad_OlaTester_LDADD = $(COMMON_OLAD_TEST_LDADD)
+olad_OlaTester_LDADD = $(COMMON_OLAD_TEST_LDADD) \
+                      ola/libola.la
 
 CLEANFILES += olad/ola-output.conf
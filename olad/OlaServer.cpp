@@ -34,6 +34,7 @@
 #include "common/rpc/RpcChannel.h"
 #include "common/rpc/RpcServer.h"
 #include "common/rpc/RpcSession.h"
+#include "ola/Callback.h"
 #include "ola/Constants.h"
 #include "ola/ExportMap.h"
 #include "ola/Logging.h"
@@ -53,6 +54,7 @@
 #include "olad/Port.h"
 #include "olad/PortBroker.h"
 #include "olad/Preferences.h"
+#include "olad/SharedMemoryIngest.h"
 #include "olad/Universe.h"
 #include "olad/plugin_api/Client.h"
 #include "olad/plugin_api/DeviceManager.h"
@@ -67,6 +69,8 @@ DEFINE_s_uint16(rpc_port, r, ola::OlaServer::DEFAULT_RPC_PORT,
                 "The port to listen for RPCs on. Defaults to 9010.");
 DEFINE_default_bool(register_with_dns_sd, true,
                     "Don't register the web service using DNS-SD (Bonjour).");
+DEFINE_default_bool(shared_memory, false,
+                    "Accept DMX data from local clients via shared memory.");
 
 namespace ola {
 
@@ -79,6 +83,12 @@ using std::auto_ptr;
 using std::pair;
 using std::vector;
 
+namespace {
+void DeleteClient(Client *client) {
+  delete client;
+}
+}  // namespace
+
 const char OlaServer::INSTANCE_NAME_KEY[] = "instance-name";
 const char OlaServer::K_INSTANCE_NAME_VAR[] = "server-instance-name";
 const char OlaServer::K_UID_VAR[] = "server-uid";
@@ -123,6 +133,7 @@ OlaServer::~OlaServer() {
   // Order is important during shutdown.
   // Shutdown the RPC server first since it depends on almost everything else.
   m_rpc_server.reset();
+  m_shared_memory_ingest.reset();
 
   if (m_housekeeping_timeout != ola::thread::INVALID_TIMEOUT) {
     m_ss->RemoveTimeout(m_housekeeping_timeout);
@@ -210,7 +221,7 @@ bool OlaServer::Init() {
   universe_preferences->Load();
 
   auto_ptr<UniverseStore> universe_store(
-      new UniverseStore(universe_preferences, m_export_map));
+      new UniverseStore(universe_preferences, m_export_map, m_ss));
 
   auto_ptr<PortBroker> port_broker(new PortBroker());
 
@@ -253,6 +264,17 @@ bool OlaServer::Init() {
     return false;
   }
 
+  auto_ptr<SharedMemoryIngest> shared_memory_ingest;
+  if (FLAGS_shared_memory) {
+    shared_memory_ingest.reset(new SharedMemoryIngest(
+        universe_store.get(), m_ss, m_export_map, m_default_uid));
+    if (!shared_memory_ingest->Init(
+            rpc_server->ListenAddress().V4Addr().Port())) {
+      OLA_WARN << "Failed to init the shared memory transport";
+      return false;
+    }
+  }
+
   // Discovery
   auto_ptr<DiscoveryAgentInterface> discovery_agent;
   if (FLAGS_register_with_dns_sd) {
@@ -304,6 +326,7 @@ bool OlaServer::Init() {
   m_port_manager.reset(port_manager.release());
   m_rpc_server.reset(rpc_server.release());
   m_service_impl.reset(service_impl.release());
+  m_shared_memory_ingest.reset(shared_memory_ingest.release());
   m_universe_store.reset(universe_store.release());
 
   UpdatePidStore(pid_store.release());
@@ -362,10 +385,10 @@ void OlaServer::NewClient(RpcSession *session) {
 }
 
 void OlaServer::ClientRemoved(RpcSession *session) {
-  auto_ptr<Client> client(reinterpret_cast<Client*>(session->GetData()));
+  Client *client = reinterpret_cast<Client*>(session->GetData());
   session->SetData(NULL);
 
-  m_broker->RemoveClient(client.get());
+  m_broker->RemoveClient(client);
 
   vector<Universe*> universe_list;
   m_universe_store->GetList(&universe_list);
@@ -373,9 +396,14 @@ void OlaServer::ClientRemoved(RpcSession *session) {
 
   for (uni_iter = universe_list.begin();
        uni_iter != universe_list.end(); ++uni_iter) {
-    (*uni_iter)->RemoveSourceClient(client.get());
-    (*uni_iter)->RemoveSinkClient(client.get());
+    (*uni_iter)->RemoveSourceClient(client);
+    (*uni_iter)->RemoveSinkClient(client);
   }
+
+  // A failed send from within the client closes the channel, so the client
+  // may be in the call stack. Delete it from the event loop instead, like the
+  // channel itself.
+  m_ss->Execute(NewSingleCallback(DeleteClient, client));
 }
 
 /*
@@ -193,6 +193,7 @@ class OlaServer : public ola::rpc::RpcSessionHandlerInterface {
   std::auto_ptr<const ola::rdm::RootPidStore> m_pid_store;
   std::auto_ptr<class DiscoveryAgentInterface> m_discovery_agent;
   std::auto_ptr<ola::rpc::RpcServer> m_rpc_server;
+  std::auto_ptr<class SharedMemoryIngest> m_shared_memory_ingest;
   class Preferences *m_server_preferences;
   class Preferences *m_universe_preferences;
   std::string m_instance_name;
@@ -23,6 +23,9 @@
 #include <string>
 #include <vector>
 #include "common/protocol/Ola.pb.h"
+#include "common/rpc/BinaryDmxFrame.h"
+#include "common/rpc/DmxDataCodec.h"
+#include "common/rpc/RpcChannel.h"
 #include "common/rpc/RpcSession.h"
 #include "ola/Callback.h"
 #include "ola/CallbackRunner.h"
@@ -43,6 +46,7 @@
 #include "olad/Universe.h"
 #include "olad/plugin_api/Client.h"
 #include "olad/plugin_api/DeviceManager.h"
+#include "olad/plugin_api/PluginThread.h"
 #include "olad/plugin_api/PortManager.h"
 #include "olad/plugin_api/UniverseStore.h"
 
@@ -124,7 +128,8 @@ OlaServerServiceImpl::OlaServerServiceImpl(
       m_port_manager(port_manager),
       m_broker(broker),
       m_wake_up_time(wake_up_time),
-      m_reload_plugins_callback(reload_plugins_callback) {
+      m_reload_plugins_callback(reload_plugins_callback),
+      m_stream_dmx_method(descriptor()->FindMethodByName("StreamDmxData")) {
 }
 
 void OlaServerServiceImpl::GetDmx(
@@ -157,6 +162,9 @@ void OlaServerServiceImpl::RegisterForDmx(
 
   Client *client = GetClient(controller);
   if (request->action() == ola::proto::REGISTER) {
+    if (request->streaming()) {
+      client->SetStreamingDmx(true);
+    }
     universe->AddSinkClient(client);
   } else {
     universe->RemoveSinkClient(client);
@@ -174,21 +182,10 @@ void OlaServerServiceImpl::UpdateDmxData(
     return MissingUniverseError(controller);
   }
 
-  Client *client = GetClient(controller);
-  DmxBuffer buffer;
-  buffer.Set(request->data());
-
-  uint8_t priority = ola::dmx::SOURCE_PRIORITY_DEFAULT;
-  if (request->has_priority()) {
-    priority = request->priority();
-    priority = std::max(static_cast<uint8_t>(ola::dmx::SOURCE_PRIORITY_MIN),
-                        priority);
-    priority = std::min(static_cast<uint8_t>(ola::dmx::SOURCE_PRIORITY_MAX),
-                        priority);
-  }
-  DmxSource source(buffer, *m_wake_up_time, priority);
-  client->DMXReceived(request->universe(), source);
-  universe->SourceClientDataChanged(client);
+  SetSourceData(GetClient(controller), universe,
+                reinterpret_cast<const uint8_t*>(request->data().data()),
+                request->data().size(), request->has_priority(),
+                request->priority());
 }
 
 void OlaServerServiceImpl::StreamDmxData(
@@ -202,21 +199,49 @@ void OlaServerServiceImpl::StreamDmxData(
     return;
   }
 
-  Client *client = GetClient(controller);
-  DmxBuffer buffer;
-  buffer.Set(request->data());
+  SetSourceData(GetClient(controller), universe,
+                reinterpret_cast<const uint8_t*>(request->data().data()),
+                request->data().size(), request->has_priority(),
+                request->priority());
+}
 
-  uint8_t priority = ola::dmx::SOURCE_PRIORITY_DEFAULT;
-  if (request->has_priority()) {
-    priority = request->priority();
-    priority = std::max(static_cast<uint8_t>(ola::dmx::SOURCE_PRIORITY_MIN),
-                        priority);
-    priority = std::min(static_cast<uint8_t>(ola::dmx::SOURCE_PRIORITY_MAX),
-                        priority);
+bool OlaServerServiceImpl::HandleRawStreamRequest(
+    const google::protobuf::MethodDescriptor *method,
+    RpcController *controller,
+    const uint8_t *data,
+    unsigned int size) {
+  if (method != m_stream_dmx_method) {
+    return false;
   }
-  DmxSource source(buffer, *m_wake_up_time, priority);
-  client->DMXReceived(request->universe(), source);
-  universe->SourceClientDataChanged(client);
+
+  ola::rpc::DmxDataFields fields;
+  if (!ola::rpc::DmxDataCodec::Decode(data, size, &fields)) {
+    // Let the protobuf parser report the error.
+    return false;
+  }
+
+  Universe *universe = m_universe_store->GetUniverse(fields.universe);
+  if (universe) {
+    SetSourceData(GetClient(controller), universe, fields.data,
+                  fields.length, fields.has_priority, fields.priority);
+  }
+  return true;
+}
+
+void OlaServerServiceImpl::EnableBinaryStream(
+    RpcController* controller,
+    const ola::proto::BinaryStreamRequest* request,
+    ola::proto::BinaryStreamReply* response,
+    ola::rpc::RpcService::CompletionCallback* done) {
+  ClosureRunner runner(done);
+  if (request->version() < ola::rpc::BinaryDmxFrame::STREAM_VERSION) {
+    controller->SetFailed("Unsupported binary stream version");
+    return;
+  }
+
+  controller->Session()->Channel()->SetRawFrameHandler(
+      NewCallback(this, &OlaServerServiceImpl::HandleBinaryDmxFrame));
+  response->set_version(ola::rpc::BinaryDmxFrame::STREAM_VERSION);
 }
 
 void OlaServerServiceImpl::SetUniverseName(
@@ -658,8 +683,16 @@ void OlaServerServiceImpl::ConfigureDevice(
     return;
   }
 
-  device->Configure(controller, request->data(),
-                    response->mutable_data(), done);
+  PluginThread *thread = PluginThread::ForDevice(device);
+  if (thread) {
+    // The device's plugin runs on its own thread.
+    thread->RunAndWait(NewSingleCallback(
+        device, &AbstractDevice::Configure, controller, request->data(),
+        response->mutable_data(), done));
+  } else {
+    device->Configure(controller, request->data(),
+                      response->mutable_data(), done);
+  }
 }
 
 void OlaServerServiceImpl::GetUIDs(
@@ -1038,4 +1071,42 @@ void OlaServerServiceImpl::SetProtoUID(const ola::rdm::UID &uid,
 Client* OlaServerServiceImpl::GetClient(ola::rpc::RpcController *controller) {
   return reinterpret_cast<Client*>(controller->Session()->GetData());
 }
+
+void OlaServerServiceImpl::HandleBinaryDmxFrame(ola::rpc::RpcSession *session,
+                                                const uint8_t *data,
+                                                unsigned int size) {
+  ola::rpc::DmxDataFields fields;
+  if (!ola::rpc::BinaryDmxFrame::Decode(data, size, &fields)) {
+    OLA_WARN << "Invalid binary DMX frame of size " << size;
+    return;
+  }
+
+  Universe *universe = m_universe_store->GetUniverse(fields.universe);
+  if (universe) {
+    SetSourceData(reinterpret_cast<Client*>(session->GetData()), universe,
+                  fields.data, fields.length, fields.has_priority,
+                  fields.priority);
+  }
+}
+
+void OlaServerServiceImpl::SetSourceData(Client *client,
+                                         Universe *universe,
+                                         const uint8_t *data,
+                                         unsigned int length,
+                                         bool has_priority,
+                                         uint8_t priority) {
+  DmxBuffer buffer(data, length);
+
+  if (has_priority) {
+    priority = std::max(static_cast<uint8_t>(ola::dmx::SOURCE_PRIORITY_MIN),
+                        priority);
+    priority = std::min(static_cast<uint8_t>(ola::dmx::SOURCE_PRIORITY_MAX),
+                        priority);
+  } else {
+    priority = ola::dmx::SOURCE_PRIORITY_DEFAULT;
+  }
+  DmxSource source(buffer, *m_wake_up_time, priority);
+  client->DMXReceived(universe->UniverseId(), source);
+  universe->SourceClientDataChanged(client);
+}
 }  // namespace ola
@@ -99,6 +99,28 @@ class OlaServerServiceImpl : public ola::proto::OlaServerService {
                      ::ola::proto::STREAMING_NO_RESPONSE* response,
                      ola::rpc::RpcService::CompletionCallback* done);
 
+  /**
+   * @brief Switch DMX streaming on this connection to binary frames.
+   *
+   * After this the client can send DMX data as binary frames, see
+   * ola::rpc::BinaryDmxFrame.
+   */
+  void EnableBinaryStream(ola::rpc::RpcController* controller,
+                          const ola::proto::BinaryStreamRequest* request,
+                          ola::proto::BinaryStreamReply* response,
+                          ola::rpc::RpcService::CompletionCallback* done);
+
+  /**
+   * @brief Handle a streaming DMX update directly from the RPC buffer.
+   *
+   * The DMX data is copied straight into the universe's DmxBuffer, rather
+   * than via a DmxData message.
+   */
+  bool HandleRawStreamRequest(const google::protobuf::MethodDescriptor *method,
+                              ola::rpc::RpcController *controller,
+                              const uint8_t *data,
+                              unsigned int size);
+
 
   /**
    * @brief Sets the name of a universe.
@@ -289,6 +311,15 @@ class OlaServerServiceImpl : public ola::proto::OlaServerService {
   void SetProtoUID(const ola::rdm::UID &uid, ola::proto::UID *pb_uid);
 
   class Client* GetClient(ola::rpc::RpcController *controller);
+  void HandleBinaryDmxFrame(ola::rpc::RpcSession *session,
+                           const uint8_t *data,
+                           unsigned int size);
+  void SetSourceData(class Client *client,
+                     Universe *universe,
+                     const uint8_t *data,
+                     unsigned int length,
+                     bool has_priority,
+                     uint8_t priority);
 
   UniverseStore *m_universe_store;
   DeviceManager *m_device_manager;
@@ -297,6 +328,7 @@ class OlaServerServiceImpl : public ola::proto::OlaServerService {
   class ClientBroker *m_broker;
   const class TimeStamp *m_wake_up_time;
   std::auto_ptr<ReloadPluginsCallback> m_reload_plugins_callback;
+  const google::protobuf::MethodDescriptor *m_stream_dmx_method;
 };
 }  // namespace ola
 #endif  // OLAD_OLASERVERSERVICEIMPL_H_
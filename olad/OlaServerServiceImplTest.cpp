@@ -22,9 +22,13 @@
  *  series of Check objects which validate the rpc response.
  */
 
+#include <stdint.h>
 #include <cppunit/extensions/HelperMacros.h>
 #include <string>
 
+#include "common/rpc/BinaryDmxFrame.h"
+#include "common/rpc/DmxDataCodec.h"
+#include "common/rpc/RpcChannel.h"
 #include "common/rpc/RpcController.h"
 #include "common/rpc/RpcSession.h"
 #include "ola/Callback.h"
@@ -33,6 +37,8 @@
 #include "ola/DmxBuffer.h"
 #include "ola/ExportMap.h"
 #include "ola/Logging.h"
+#include "ola/io/Descriptor.h"
+#include "ola/io/IOVecInterface.h"
 #include "ola/rdm/UID.h"
 #include "ola/testing/TestUtils.h"
 #include "olad/OlaServerServiceImpl.h"
@@ -49,6 +55,11 @@ using ola::DmxBuffer;
 using ola::OlaServerServiceImpl;
 using ola::Universe;
 using ola::UniverseStore;
+using ola::io::IOVec;
+using ola::io::LoopbackDescriptor;
+using ola::rpc::BinaryDmxFrame;
+using ola::rpc::DmxDataCodec;
+using ola::rpc::RpcChannel;
 using ola::rpc::RpcController;
 using ola::rpc::RpcSession;
 using std::string;
@@ -58,6 +69,8 @@ class OlaServerServiceImplTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testGetDmx);
   CPPUNIT_TEST(testRegisterForDmx);
   CPPUNIT_TEST(testUpdateDmxData);
+  CPPUNIT_TEST(testBinaryStream);
+  CPPUNIT_TEST(testMixedStreams);
   CPPUNIT_TEST(testSetUniverseName);
   CPPUNIT_TEST(testSetMergeMode);
   CPPUNIT_TEST_SUITE_END();
@@ -74,6 +87,8 @@ class OlaServerServiceImplTest: public CppUnit::TestFixture {
     void testGetDmx();
     void testRegisterForDmx();
     void testUpdateDmxData();
+    void testBinaryStream();
+    void testMixedStreams();
     void testSetUniverseName();
     void testSetMergeMode();
 
@@ -93,6 +108,12 @@ class OlaServerServiceImplTest: public CppUnit::TestFixture {
                            int universe_id,
                            const DmxBuffer &data,
                            class UpdateDmxDataCheck *check);
+    bool CallEnableBinaryStream(OlaServerServiceImpl *service,
+                                RpcChannel *channel,
+                                unsigned int version);
+    void SendBinaryFrame(RpcChannel *channel,
+                         unsigned int universe_id,
+                         const DmxBuffer &data);
     void CallSetUniverseName(OlaServerServiceImpl *service,
                              int universe_id,
                              const string &name,
@@ -422,6 +443,126 @@ void OlaServerServiceImplTest::CallUpdateDmxData(
   service->UpdateDmxData(&controller, &request, &response, closure);
 }
 
+static void NoOp() {}
+
+/*
+ * Check that DMX data can be sent as binary frames once the binary stream is
+ * enabled.
+ */
+void OlaServerServiceImplTest::testBinaryStream() {
+  UniverseStore store(NULL, NULL);
+  ola::TimeStamp time1;
+  m_clock.CurrentTime(&time1);
+  ola::Client client(NULL, m_uid);
+  OlaServerServiceImpl service(&store, NULL, NULL, NULL, NULL,
+                               &time1, NULL);
+  Universe *universe = store.GetUniverseOrCreate(1);
+  DmxBuffer dmx_data("this is a test");
+
+  LoopbackDescriptor socket;
+  socket.Init();
+  RpcChannel channel(&service, &socket);
+  channel.Session()->SetData(&client);
+
+  // frames are discarded until the binary stream is enabled
+  SendBinaryFrame(&channel, 1, dmx_data);
+  OLA_ASSERT_EQ(DmxBuffer(), universe->GetDMX());
+
+  OLA_ASSERT_FALSE(CallEnableBinaryStream(&service, &channel, 0));
+  OLA_ASSERT_TRUE(CallEnableBinaryStream(&service, &channel,
+                                         BinaryDmxFrame::STREAM_VERSION));
+  SendBinaryFrame(&channel, 1, dmx_data);
+  OLA_ASSERT_EQ(dmx_data, universe->GetDMX());
+
+  // a universe that doesn't exist
+  SendBinaryFrame(&channel, 2, dmx_data);
+  OLA_ASSERT_FALSE(store.GetUniverse(2));
+}
+
+/*
+ * Check StreamDmxData requests and binary frames can be interleaved on the
+ * same channel, across several universes.
+ */
+void OlaServerServiceImplTest::testMixedStreams() {
+  const unsigned int UNIVERSE_COUNT = 4;
+
+  UniverseStore store(NULL, NULL);
+  ola::TimeStamp time1;
+  m_clock.CurrentTime(&time1);
+  ola::Client client(NULL, m_uid);
+  OlaServerServiceImpl service(&store, NULL, NULL, NULL, NULL,
+                               &time1, NULL);
+  for (unsigned int i = 1; i <= UNIVERSE_COUNT; i++) {
+    store.GetUniverseOrCreate(i);
+  }
+
+  LoopbackDescriptor socket;
+  socket.Init();
+  RpcChannel channel(&service, &socket);
+  channel.Session()->SetData(&client);
+  OLA_ASSERT_TRUE(CallEnableBinaryStream(&service, &channel,
+                                         BinaryDmxFrame::STREAM_VERSION));
+
+  const google::protobuf::MethodDescriptor *method =
+      ola::proto::OlaServerService::descriptor()->FindMethodByName(
+          "StreamDmxData");
+  DmxBuffer buffer;
+  for (unsigned int i = 1; i <= UNIVERSE_COUNT; i++) {
+    // Odd universes get an RPC then a binary frame, even ones the reverse.
+    for (unsigned int frame = 0; frame < 2; frame++) {
+      buffer.Blackout();
+      buffer.SetChannel(0, i);
+      buffer.SetChannel(1, frame);
+      if ((i + frame) % 2) {
+        DmxDataCodec codec;
+        IOVec iov[DmxDataCodec::MAX_IOVECS];
+        int iocnt = codec.Encode(i, 100, buffer, iov);
+        channel.CallMethod(method, NULL, iov, iocnt, NULL, NULL);
+        channel.DescriptorReady();
+      } else {
+        SendBinaryFrame(&channel, i, buffer);
+      }
+    }
+  }
+
+  for (unsigned int i = 1; i <= UNIVERSE_COUNT; i++) {
+    buffer.Blackout();
+    buffer.SetChannel(0, i);
+    buffer.SetChannel(1, 1);
+    OLA_ASSERT_EQ(buffer, store.GetUniverse(i)->GetDMX());
+  }
+}
+
+bool OlaServerServiceImplTest::CallEnableBinaryStream(
+    OlaServerServiceImpl *service,
+    RpcChannel *channel,
+    unsigned int version) {
+  RpcController controller(channel->Session());
+  ola::proto::BinaryStreamRequest request;
+  ola::proto::BinaryStreamReply response;
+  request.set_version(version);
+  service->EnableBinaryStream(&controller, &request, &response,
+                              NewSingleCallback(&NoOp));
+  return !controller.Failed() && response.version() == version;
+}
+
+/*
+ * Send a binary frame over the loopback channel and process it.
+ */
+void OlaServerServiceImplTest::SendBinaryFrame(RpcChannel *channel,
+                                               unsigned int universe_id,
+                                               const DmxBuffer &data) {
+  uint8_t header[BinaryDmxFrame::HEADER_SIZE];
+  BinaryDmxFrame::EncodeHeader(universe_id, 100, data.Size(), header);
+  IOVec iov[2];
+  iov[0].iov_base = header;
+  iov[0].iov_len = sizeof(header);
+  iov[1].iov_base = const_cast<uint8_t*>(data.GetRaw());
+  iov[1].iov_len = data.Size();
+  OLA_ASSERT_TRUE(channel->SendRawFrame(iov, 2));
+  channel->DescriptorReady();
+}
+
 /*
  * Check the SetUniverseName method works
  */
@@ -169,5 +169,9 @@ int main(int argc, char *argv[]) {
 #endif  // _WIN32
 
   olad->Run();
+  // Destroy the daemon first so the lines it logs while shutting down are
+  // written out.
+  olad.reset();
+  ola::StopAsyncLogging();
   return ola::EXIT_OK;
 }
@@ -27,6 +27,7 @@
 #include "olad/Plugin.h"
 #include "olad/PluginAdaptor.h"
 #include "olad/PluginLoader.h"
+#include "olad/plugin_api/PluginThread.h"
 
 namespace ola {
 
@@ -87,7 +88,7 @@ void PluginManager::LoadAll() {
 void PluginManager::UnloadAll() {
   PluginMap::iterator plugin_iter = m_loaded_plugins.begin();
   for (; plugin_iter != m_loaded_plugins.end(); ++plugin_iter) {
-    plugin_iter->second->Stop();
+    StopPlugin(plugin_iter->second);
   }
   m_loaded_plugins.clear();
   m_active_plugins.clear();
@@ -134,7 +135,7 @@ void PluginManager::DisableAndStopPlugin(ola_plugin_id plugin_id) {
   }
 
   if (STLRemove(&m_active_plugins, plugin_id)) {
-    plugin->Stop();
+    StopPlugin(plugin);
   }
 
   if (STLRemove(&m_enabled_plugins, plugin_id)) {
@@ -193,7 +194,18 @@ bool PluginManager::StartIfSafe(AbstractPlugin *plugin) {
   }
 
   OLA_INFO << "Trying to start " << plugin->Name();
-  bool ok = plugin->Start();
+  bool ok;
+  if (plugin->RunsOnOwnThread()) {
+    PluginThread *thread = new PluginThread(plugin, m_plugin_adaptor);
+    plugin->SetThread(thread);
+    ok = thread->StartPlugin();
+    if (!ok) {
+      plugin->SetThread(NULL);
+      delete thread;
+    }
+  } else {
+    ok = plugin->Start();
+  }
   if (!ok) {
     OLA_WARN << "Failed to start " << plugin->Name();
   } else {
@@ -203,6 +215,24 @@ bool PluginManager::StartIfSafe(AbstractPlugin *plugin) {
   return ok;
 }
 
+/*
+ * @brief Stop a plugin, and its thread if it has one.
+ * @param plugin The plugin to stop
+ */
+void PluginManager::StopPlugin(AbstractPlugin *plugin) {
+  PluginThread *thread = plugin->GetThread();
+  if (!thread) {
+    plugin->Stop();
+    return;
+  }
+
+  thread->StopPlugin();
+  // Run any callbacks the thread sent us before deleting it.
+  m_plugin_adaptor->DrainCallbacks();
+  plugin->SetThread(NULL);
+  delete thread;
+}
+
 /*
  * @brief Check if this plugin conflicts with any of the running plugins.
  * @param plugin The plugin to check
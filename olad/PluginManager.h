@@ -152,6 +152,7 @@ class PluginManager {
   PluginAdaptor *m_plugin_adaptor;
 
   bool StartIfSafe(AbstractPlugin *plugin);
+  void StopPlugin(AbstractPlugin *plugin);
   AbstractPlugin* CheckForRunningConflicts(const AbstractPlugin *plugin) const;
 
   DISALLOW_COPY_AND_ASSIGN(PluginManager);
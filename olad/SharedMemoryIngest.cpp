@@ -0,0 +1,219 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * SharedMemoryIngest.cpp
+ * Accepts DMX data from local clients via a shared memory region.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "ola/Callback.h"
+#include "ola/DmxBuffer.h"
+#include "ola/ExportMap.h"
+#include "ola/Logging.h"
+#include "ola/dmx/SourcePriorities.h"
+#include "ola/network/IPV4Address.h"
+#include "ola/network/SocketAddress.h"
+#include "ola/stl/STLUtils.h"
+#include "olad/DmxSource.h"
+#include "olad/SharedMemoryIngest.h"
+#include "olad/Universe.h"
+#include "olad/plugin_api/UniverseStore.h"
+
+namespace ola {
+
+using ola::dmx::SharedDmxFrame;
+using ola::dmx::SharedDmxRegion;
+using ola::network::IPV4Address;
+using ola::network::IPV4SocketAddress;
+using std::auto_ptr;
+using std::vector;
+
+const char SharedMemoryIngest::K_DOORBELLS_VAR[] = "shm-doorbells";
+const char SharedMemoryIngest::K_FRAMES_VAR[] = "shm-frames";
+
+SharedMemoryIngest::SharedMemoryIngest(UniverseStore *universe_store,
+                                       ola::io::SelectServer *ss,
+                                       ExportMap *export_map,
+                                       const ola::rdm::UID &uid)
+    : m_universe_store(universe_store),
+      m_ss(ss),
+      m_doorbells(NULL),
+      m_frames(NULL),
+      m_uid(uid),
+      m_doorbell_ring(DOORBELL_BATCH_SIZE, 1),
+      m_scan_timeout(ola::thread::INVALID_TIMEOUT) {
+  if (export_map) {
+    m_doorbells = export_map->GetCounterVar(K_DOORBELLS_VAR);
+    m_frames = export_map->GetCounterVar(K_FRAMES_VAR);
+  }
+}
+
+SharedMemoryIngest::~SharedMemoryIngest() {
+  if (m_region.get()) {
+    m_ss->RemoveReadDescriptor(&m_doorbell);
+    m_ss->RemoveTimeout(m_scan_timeout);
+  }
+
+  ProducerMap::iterator iter = m_producers.begin();
+  for (; iter != m_producers.end(); ++iter) {
+    RemoveProducer(iter->second);
+  }
+}
+
+bool SharedMemoryIngest::Init(uint16_t rpc_port, unsigned int slot_count,
+                              unsigned int scan_interval_ms) {
+  if (m_region.get()) {
+    return false;
+  }
+
+  if (!m_doorbell.Init() ||
+      !m_doorbell.Bind(IPV4SocketAddress(IPV4Address::Loopback(), 0))) {
+    return false;
+  }
+
+  IPV4SocketAddress doorbell_address;
+  if (!m_doorbell.GetSocketAddress(&doorbell_address)) {
+    return false;
+  }
+
+  auto_ptr<SharedDmxRegion> region(SharedDmxRegion::Create(
+      SharedDmxRegion::NameForPort(rpc_port), slot_count));
+  if (!region.get()) {
+    return false;
+  }
+  region->SetDoorbellPort(doorbell_address.Port());
+
+  m_doorbell.SetOnData(
+      NewCallback(this, &SharedMemoryIngest::DoorbellRung));
+  if (!m_ss->AddReadDescriptor(&m_doorbell)) {
+    return false;
+  }
+  m_scan_timeout = m_ss->RegisterRepeatingTimeout(
+      scan_interval_ms,
+      NewCallback(this, &SharedMemoryIngest::PeriodicScan));
+  m_region.reset(region.release());
+  OLA_INFO << "Accepting DMX data via shared memory, doorbell on "
+           << doorbell_address;
+  return true;
+}
+
+void SharedMemoryIngest::DoorbellRung() {
+  unsigned int rings = m_doorbell_ring.Receive(&m_doorbell);
+  if (m_doorbells) {
+    (*m_doorbells) += rings;
+  }
+
+  // Clear the flag before scanning, so that a client which writes during the
+  // scan rings again.
+  m_region->ClearDoorbell();
+  Scan();
+}
+
+/*
+ * If a doorbell datagram is lost the flag stays set, and no client will ring
+ * again until we clear it. So every so often clear it and scan anyway.
+ */
+bool SharedMemoryIngest::PeriodicScan() {
+  m_region->ClearDoorbell();
+  Scan();
+
+  const unsigned int slots_in_use = m_sequences.size();
+  if (m_locked_sequences.size() < slots_in_use) {
+    m_locked_sequences.resize(slots_in_use, 0);
+  }
+  for (unsigned int i = 0; i < slots_in_use; i++) {
+    if (m_region->RecoverSlot(i, &m_locked_sequences[i])) {
+      // The frame may be incomplete, so skip it.
+      m_sequences[i] = m_locked_sequences[i];
+    }
+  }
+  RemoveExitedProducers();
+  return true;
+}
+
+void SharedMemoryIngest::Scan() {
+  const unsigned int slots_in_use = m_region->SlotsInUse();
+  if (m_sequences.size() < slots_in_use) {
+    m_sequences.resize(slots_in_use, 0);
+  }
+
+  SharedDmxFrame frame;
+  for (unsigned int i = 0; i < slots_in_use; i++) {
+    if (!m_region->Read(i, &m_sequences[i], &frame)) {
+      continue;
+    }
+
+    Universe *universe = m_universe_store->GetUniverse(frame.universe);
+    if (!universe) {
+      continue;
+    }
+
+    uint8_t priority = std::max(
+        static_cast<uint8_t>(ola::dmx::SOURCE_PRIORITY_MIN), frame.priority);
+    priority = std::min(static_cast<uint8_t>(ola::dmx::SOURCE_PRIORITY_MAX),
+                        priority);
+    DmxSource source(DmxBuffer(frame.data, frame.length), *m_ss->WakeUpTime(),
+                     priority);
+    Client *client = ProducerClient(frame.writer);
+    client->DMXReceived(frame.universe, source);
+    universe->SourceClientDataChanged(client);
+    if (m_frames) {
+      (*m_frames)++;
+    }
+  }
+}
+
+Client *SharedMemoryIngest::ProducerClient(int32_t writer) {
+  Client *client = ola::STLFindOrNull(m_producers, writer);
+  if (!client) {
+    client = new Client(NULL, m_uid);
+    m_producers[writer] = client;
+    OLA_INFO << "New shared memory producer, pid " << writer;
+  }
+  return client;
+}
+
+/*
+ * Unlike an RPC client there is no connection to close, so check if the
+ * producers are still running.
+ */
+void SharedMemoryIngest::RemoveExitedProducers() {
+  ProducerMap::iterator iter = m_producers.begin();
+  while (iter != m_producers.end()) {
+    if (SharedDmxRegion::WriterIsRunning(iter->first)) {
+      ++iter;
+      continue;
+    }
+    OLA_INFO << "Shared memory producer " << iter->first << " exited";
+    RemoveProducer(iter->second);
+    m_producers.erase(iter++);
+  }
+}
+
+void SharedMemoryIngest::RemoveProducer(Client *client) {
+  vector<Universe*> universes;
+  m_universe_store->GetList(&universes);
+  vector<Universe*>::iterator iter = universes.begin();
+  for (; iter != universes.end(); ++iter) {
+    (*iter)->RemoveSourceClient(client);
+  }
+  delete client;
+}
+}  // namespace ola
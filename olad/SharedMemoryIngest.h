@@ -0,0 +1,119 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * SharedMemoryIngest.h
+ * Accepts DMX data from local clients via a shared memory region.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef OLAD_SHAREDMEMORYINGEST_H_
+#define OLAD_SHAREDMEMORYINGEST_H_
+
+#include <stdint.h>
+#include <map>
+#include <memory>
+#include <vector>
+#include "ola/base/Macro.h"
+#include "ola/dmx/SharedDmxRegion.h"
+#include "ola/io/SelectServer.h"
+#include "ola/network/Socket.h"
+#include "ola/network/UDPReceiveRing.h"
+#include "ola/rdm/UID.h"
+#include "ola/thread/SchedulerInterface.h"
+#include "olad/plugin_api/Client.h"
+
+namespace ola {
+
+/**
+ * @brief Accepts DMX data from local clients via a shared memory region.
+ *
+ * This creates the SharedDmxRegion used by
+ * ola::client::SharedMemoryClient. Clients write frames into the region and
+ * then send a datagram to a loopback UDP socket to wake us up, if no other
+ * client has already done so. When woken we scan the region and pass any
+ * new frames to the matching universes. Each producer process gets its own
+ * Client, so frames from different processes are merged like any other
+ * sources.
+ *
+ * The region is also scanned periodically, so frames still arrive if a
+ * wake up datagram is lost. The periodic scan also recovers slots left locked
+ * by a client that died, and removes the sources of producers that have
+ * exited.
+ */
+class SharedMemoryIngest {
+ public:
+  /**
+   * @brief Create a new SharedMemoryIngest.
+   * @param universe_store the UniverseStore to deliver data to.
+   * @param ss the SelectServer to use.
+   * @param export_map the ExportMap to use for the counters, may be NULL.
+   * @param uid the UID of the source clients.
+   */
+  SharedMemoryIngest(class UniverseStore *universe_store,
+                     ola::io::SelectServer *ss,
+                     class ExportMap *export_map,
+                     const ola::rdm::UID &uid);
+
+  ~SharedMemoryIngest();
+
+  /**
+   * @brief Create the shared memory region and start waiting for doorbells.
+   * @param rpc_port the port olad is listening for RPCs on, this is used to
+   *   name the region.
+   * @param slot_count the maximum number of universes clients can send.
+   * @param scan_interval_ms how often to scan the region without being woken.
+   * @returns true if the region was created, false otherwise.
+   */
+  bool Init(uint16_t rpc_port,
+            unsigned int slot_count =
+                ola::dmx::SharedDmxRegion::DEFAULT_SLOT_COUNT,
+            unsigned int scan_interval_ms = DEFAULT_SCAN_INTERVAL_MS);
+
+  static const unsigned int DEFAULT_SCAN_INTERVAL_MS = 1000;
+
+  static const char K_DOORBELLS_VAR[];
+  static const char K_FRAMES_VAR[];
+
+ private:
+  class UniverseStore *m_universe_store;
+  ola::io::SelectServer *m_ss;
+  class CounterVariable *m_doorbells;
+  class CounterVariable *m_frames;
+  const ola::rdm::UID m_uid;
+  // The source client for each producer, keyed by pid.
+  typedef std::map<int32_t, Client*> ProducerMap;
+  ProducerMap m_producers;
+  std::auto_ptr<ola::dmx::SharedDmxRegion> m_region;
+  ola::network::UDPSocket m_doorbell;
+  ola::network::UDPReceiveRing m_doorbell_ring;
+  ola::thread::timeout_id m_scan_timeout;
+  // The sequence number of the last frame read from each slot.
+  std::vector<uint32_t> m_sequences;
+  // Used by SharedDmxRegion::RecoverSlot().
+  std::vector<uint32_t> m_locked_sequences;
+
+  void DoorbellRung();
+  bool PeriodicScan();
+  void Scan();
+  Client *ProducerClient(int32_t writer);
+  void RemoveExitedProducers();
+  void RemoveProducer(Client *client);
+
+  static const unsigned int DOORBELL_BATCH_SIZE = 16;
+
+  DISALLOW_COPY_AND_ASSIGN(SharedMemoryIngest);
+};
+}  // namespace ola
+#endif  // OLAD_SHAREDMEMORYINGEST_H_
@@ -0,0 +1,293 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * SharedMemoryIngestTest.cpp
+ * Test fixture for the SharedMemoryIngest class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
+#include <stdint.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <memory>
+
+#include "ola/Clock.h"
+#include "ola/Constants.h"
+#include "ola/DmxBuffer.h"
+#include "ola/ExportMap.h"
+#include "ola/Logging.h"
+#include "ola/client/SharedMemoryClient.h"
+#include "ola/dmx/SharedDmxRegion.h"
+#include "ola/io/SelectServer.h"
+#include "ola/rdm/UID.h"
+#include "ola/testing/TestUtils.h"
+#include "olad/SharedMemoryIngest.h"
+#include "olad/Universe.h"
+#include "olad/plugin_api/UniverseStore.h"
+
+using ola::DmxBuffer;
+using ola::ExportMap;
+using ola::SharedMemoryIngest;
+using ola::TimeInterval;
+using ola::Universe;
+using ola::UniverseStore;
+using ola::client::SharedMemoryClient;
+using ola::dmx::SharedDmxRegion;
+using ola::io::SelectServer;
+using std::auto_ptr;
+
+class SharedMemoryIngestTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(SharedMemoryIngestTest);
+  CPPUNIT_TEST(testIngest);
+  CPPUNIT_TEST(testServerRestart);
+  CPPUNIT_TEST(testLostDoorbell);
+  CPPUNIT_TEST(testProducers);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    SharedMemoryIngestTest()
+        : m_uid(ola::OPEN_LIGHTING_ESTA_CODE, 0) {
+    }
+
+    void setUp() {
+      ola::InitLogging(ola::OLA_LOG_INFO, ola::OLA_LOG_STDERR);
+    }
+
+    void testIngest();
+    void testServerRestart();
+    void testLostDoorbell();
+    void testProducers();
+
+ private:
+    ola::rdm::UID m_uid;
+    SelectServer m_ss;
+
+    // Region names are derived from the RPC port, olad never uses port 0.
+    static const uint16_t TEST_PORT = 0;
+};
+
+#ifdef HAVE_SHM_OPEN
+CPPUNIT_TEST_SUITE_REGISTRATION(SharedMemoryIngestTest);
+#endif  // HAVE_SHM_OPEN
+
+
+/*
+ * Check that data sent by a SharedMemoryClient reaches the universe.
+ */
+void SharedMemoryIngestTest::testIngest() {
+  ExportMap export_map;
+  UniverseStore store(NULL, NULL);
+  Universe *universe = store.GetUniverseOrCreate(1);
+  OLA_ASSERT_NOT_NULL(universe);
+
+  SharedMemoryClient::Options options;
+  options.server_port = TEST_PORT;
+  SharedMemoryClient client(options);
+  // olad hasn't created the region yet.
+  OLA_ASSERT_FALSE(client.Setup());
+
+  {
+    SharedMemoryIngest ingest(&store, &m_ss, &export_map, m_uid);
+    OLA_ASSERT_TRUE(ingest.Init(TEST_PORT, 4));
+    OLA_ASSERT_TRUE(client.Setup());
+
+    DmxBuffer buffer;
+    buffer.SetFromString("1,2,3,4");
+    SharedMemoryClient::SendArgs args;
+    args.priority = 150;
+    OLA_ASSERT_TRUE(client.SendDMX(1, buffer, args));
+    // Universe 2 doesn't exist, so this is ignored.
+    OLA_ASSERT_TRUE(client.SendDmx(2, buffer));
+
+    m_ss.RunOnce(TimeInterval(1, 0));
+    OLA_ASSERT_EQ(buffer, universe->GetDMX());
+    OLA_ASSERT_EQ(static_cast<uint8_t>(150), universe->ActivePriority());
+    OLA_ASSERT_EQ(1u, universe->SourceClientCount());
+    OLA_ASSERT_EQ(1u, export_map.GetCounterVar(
+        SharedMemoryIngest::K_DOORBELLS_VAR)->Get());
+    OLA_ASSERT_EQ(1u, export_map.GetCounterVar(
+        SharedMemoryIngest::K_FRAMES_VAR)->Get());
+
+    // Many frames only ring the doorbell once, and only the latest is used.
+    DmxBuffer buffer2;
+    buffer2.Blackout();
+    for (unsigned int i = 0; i < 10; i++) {
+      buffer2.SetChannel(0, i);
+      OLA_ASSERT_TRUE(client.SendDmx(1, buffer2));
+    }
+    m_ss.RunOnce(TimeInterval(1, 0));
+    OLA_ASSERT_EQ(buffer2, universe->GetDMX());
+    OLA_ASSERT_EQ(ola::dmx::SOURCE_PRIORITY_DEFAULT,
+                  universe->ActivePriority());
+    OLA_ASSERT_EQ(2u, export_map.GetCounterVar(
+        SharedMemoryIngest::K_DOORBELLS_VAR)->Get());
+    OLA_ASSERT_EQ(2u, export_map.GetCounterVar(
+        SharedMemoryIngest::K_FRAMES_VAR)->Get());
+  }
+
+  // The source is removed along with the ingest.
+  OLA_ASSERT_EQ(0u, universe->SourceClientCount());
+}
+
+
+/*
+ * Check that clients notice when olad goes away.
+ */
+void SharedMemoryIngestTest::testServerRestart() {
+  UniverseStore store(NULL, NULL);
+  auto_ptr<SharedMemoryIngest> ingest(
+      new SharedMemoryIngest(&store, &m_ss, NULL, m_uid));
+  OLA_ASSERT_TRUE(ingest->Init(TEST_PORT, 4));
+
+  SharedMemoryClient::Options options;
+  options.server_port = TEST_PORT;
+  SharedMemoryClient client(options);
+  OLA_ASSERT_TRUE(client.Setup());
+
+  DmxBuffer buffer;
+  buffer.SetFromString("1,2,3,4");
+  OLA_ASSERT_TRUE(client.SendDmx(1, buffer));
+
+  ingest.reset();
+  ingest.reset(new SharedMemoryIngest(&store, &m_ss, NULL, m_uid));
+  OLA_ASSERT_TRUE(ingest->Init(TEST_PORT, 4));
+  OLA_ASSERT_FALSE(client.SendDmx(1, buffer));
+
+  // The client can reconnect to the new region.
+  OLA_ASSERT_TRUE(client.Setup());
+  OLA_ASSERT_TRUE(client.SendDmx(1, buffer));
+}
+
+
+/*
+ * Check that frames still arrive if a doorbell datagram is lost.
+ */
+void SharedMemoryIngestTest::testLostDoorbell() {
+  ExportMap export_map;
+  UniverseStore store(NULL, NULL);
+  Universe *universe = store.GetUniverseOrCreate(1);
+  OLA_ASSERT_NOT_NULL(universe);
+
+  SharedMemoryIngest ingest(&store, &m_ss, &export_map, m_uid);
+  OLA_ASSERT_TRUE(ingest.Init(TEST_PORT, 4, 10));
+
+  // A client that set the doorbell flag, but whose datagram never arrived.
+  auto_ptr<SharedDmxRegion> region(SharedDmxRegion::Open(
+      SharedDmxRegion::NameForPort(TEST_PORT)));
+  OLA_ASSERT_NOT_NULL(region.get());
+  OLA_ASSERT_TRUE(region->RingDoorbell());
+
+  SharedMemoryClient::Options options;
+  options.server_port = TEST_PORT;
+  SharedMemoryClient client(options);
+  OLA_ASSERT_TRUE(client.Setup());
+  DmxBuffer buffer;
+  buffer.SetFromString("1,2,3,4");
+  OLA_ASSERT_TRUE(client.SendDmx(1, buffer));
+
+  // This returns once the periodic scan has run.
+  m_ss.RunOnce(TimeInterval(1, 0));
+  OLA_ASSERT_EQ(buffer, universe->GetDMX());
+  OLA_ASSERT_EQ(0u, export_map.GetCounterVar(
+      SharedMemoryIngest::K_DOORBELLS_VAR)->Get());
+
+  // The flag was cleared, so the next frame rings the doorbell again.
+  DmxBuffer buffer2;
+  buffer2.SetFromString("5,6");
+  OLA_ASSERT_TRUE(client.SendDmx(1, buffer2));
+  m_ss.RunOnce(TimeInterval(1, 0));
+  OLA_ASSERT_EQ(buffer2, universe->GetDMX());
+  OLA_ASSERT_EQ(1u, export_map.GetCounterVar(
+      SharedMemoryIngest::K_DOORBELLS_VAR)->Get());
+}
+
+
+/*
+ * Check that each producer process is a separate source, and that the source
+ * is removed when the process exits.
+ */
+void SharedMemoryIngestTest::testProducers() {
+  UniverseStore store(NULL, NULL);
+  Universe *universe = store.GetUniverseOrCreate(1);
+  OLA_ASSERT_NOT_NULL(universe);
+  universe->SetMergeMode(Universe::MERGE_HTP);
+
+  SharedMemoryIngest ingest(&store, &m_ss, NULL, m_uid);
+  OLA_ASSERT_TRUE(ingest.Init(TEST_PORT, 4, 10));
+
+  // Another process writes a frame, then waits until the exit pipe is closed.
+  int ready_pipe[2], exit_pipe[2];
+  OLA_ASSERT_EQ(0, pipe(ready_pipe));
+  OLA_ASSERT_EQ(0, pipe(exit_pipe));
+  pid_t pid = fork();
+  OLA_ASSERT_TRUE(pid >= 0);
+  if (pid == 0) {
+    close(exit_pipe[1]);
+    SharedDmxRegion *region = SharedDmxRegion::Open(
+        SharedDmxRegion::NameForPort(TEST_PORT));
+    DmxBuffer buffer;
+    buffer.SetFromString("0,0,0,9");
+    uint8_t ok = region && region->Write(region->SlotForUniverse(1), 100,
+                                         buffer, ola::TimeStamp());
+    char c;
+    if (write(ready_pipe[1], &ok, sizeof(ok)) == sizeof(ok)) {
+      while (read(exit_pipe[0], &c, sizeof(c)) > 0) {}
+    }
+    _exit(0);
+  }
+  close(ready_pipe[1]);
+  close(exit_pipe[0]);
+  uint8_t ok = 0;
+  OLA_ASSERT_EQ(static_cast<ssize_t>(sizeof(ok)),
+                read(ready_pipe[0], &ok, sizeof(ok)));
+  close(ready_pipe[0]);
+  OLA_ASSERT_TRUE(ok);
+
+  // This returns once the periodic scan has run.
+  m_ss.RunOnce(TimeInterval(1, 0));
+  DmxBuffer expected;
+  expected.SetFromString("0,0,0,9");
+  OLA_ASSERT_EQ(expected, universe->GetDMX());
+  OLA_ASSERT_EQ(1u, universe->SourceClientCount());
+
+  // Our frame is merged with the other process's frame.
+  SharedMemoryClient::Options options;
+  options.server_port = TEST_PORT;
+  SharedMemoryClient client(options);
+  OLA_ASSERT_TRUE(client.Setup());
+  DmxBuffer buffer;
+  buffer.SetFromString("1,2,3");
+  OLA_ASSERT_TRUE(client.SendDmx(1, buffer));
+  m_ss.RunOnce(TimeInterval(1, 0));
+  expected.SetFromString("1,2,3,9");
+  OLA_ASSERT_EQ(expected, universe->GetDMX());
+  OLA_ASSERT_EQ(2u, universe->SourceClientCount());
+
+  // Once the other process exits, its source is removed.
+  close(exit_pipe[1]);
+  int status;
+  OLA_ASSERT_EQ(pid, waitpid(pid, &status, 0));
+  m_ss.RunOnce(TimeInterval(1, 0));
+  OLA_ASSERT_EQ(1u, universe->SourceClientCount());
+  OLA_ASSERT_TRUE(client.SendDmx(1, buffer));
+  m_ss.RunOnce(TimeInterval(1, 0));
+  OLA_ASSERT_EQ(buffer, universe->GetDMX());
+}
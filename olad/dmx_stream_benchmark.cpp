@@ -0,0 +1,177 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * dmx_stream_benchmark.cpp
+ * Compare the cost of streaming DMX to olad with StreamDmxData RPCs and with
+ * binary frames.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <stdint.h>
+#include <iomanip>
+#include <iostream>
+#include "common/rpc/BinaryDmxFrame.h"
+#include "common/rpc/DmxDataCodec.h"
+#include "common/rpc/RpcChannel.h"
+#include "common/rpc/RpcController.h"
+#include "common/rpc/RpcSession.h"
+#include "ola/Callback.h"
+#include "ola/Clock.h"
+#include "ola/DmxBuffer.h"
+#include "ola/base/Flags.h"
+#include "ola/base/Init.h"
+#include "ola/io/Descriptor.h"
+#include "ola/io/IOVecInterface.h"
+#include "ola/rdm/UID.h"
+#include "olad/OlaServerServiceImpl.h"
+#include "olad/plugin_api/Client.h"
+#include "olad/plugin_api/UniverseStore.h"
+
+using ola::Client;
+using ola::Clock;
+using ola::DmxBuffer;
+using ola::OlaServerServiceImpl;
+using ola::TimeInterval;
+using ola::TimeStamp;
+using ola::UniverseStore;
+using ola::io::IOVec;
+using ola::io::LoopbackDescriptor;
+using ola::rpc::BinaryDmxFrame;
+using ola::rpc::DmxDataCodec;
+using ola::rpc::RpcChannel;
+using ola::rpc::RpcController;
+using std::cout;
+using std::endl;
+
+DEFINE_s_uint32(frames, f, 200, "Number of frames to send to each universe");
+DEFINE_s_uint32(universes, u, 200, "Number of universes to send to");
+
+static const uint8_t PRIORITY = 100;
+
+static void NoOp() {}
+
+/**
+ * Return the number of frames per second.
+ */
+double FramesPerSecond(const Clock &clock, const TimeStamp &start,
+                       unsigned int frames) {
+  TimeStamp end;
+  clock.CurrentTime(&end);
+  TimeInterval elapsed = end - start;
+  return frames * 1000000.0 / (elapsed.AsInt() ? elapsed.AsInt() : 1);
+}
+
+/**
+ * Send each frame as a StreamDmxData RPC, and have the server read it.
+ */
+double BenchmarkRPC(const Clock &clock, RpcChannel *channel) {
+  const google::protobuf::MethodDescriptor *method =
+      ola::proto::OlaServerService::descriptor()->FindMethodByName(
+          "StreamDmxData");
+  DmxBuffer buffer;
+  buffer.Blackout();
+
+  TimeStamp start;
+  clock.CurrentTime(&start);
+  for (unsigned int frame = 0; frame < FLAGS_frames; frame++) {
+    buffer.SetChannel(0, frame);
+    for (unsigned int i = 1; i <= FLAGS_universes; i++) {
+      DmxDataCodec codec;
+      IOVec iov[DmxDataCodec::MAX_IOVECS];
+      int iocnt = codec.Encode(i, PRIORITY, buffer, iov);
+      channel->CallMethod(method, NULL, iov, iocnt, NULL, NULL);
+      channel->DescriptorReady();
+    }
+  }
+  return FramesPerSecond(clock, start, FLAGS_frames * FLAGS_universes);
+}
+
+/**
+ * Send each frame as a binary frame, and have the server read it.
+ */
+double BenchmarkBinary(const Clock &clock, RpcChannel *channel) {
+  DmxBuffer buffer;
+  buffer.Blackout();
+  uint8_t header[BinaryDmxFrame::HEADER_SIZE];
+  IOVec iov[2];
+  iov[0].iov_base = header;
+  iov[0].iov_len = sizeof(header);
+
+  TimeStamp start;
+  clock.CurrentTime(&start);
+  for (unsigned int frame = 0; frame < FLAGS_frames; frame++) {
+    buffer.SetChannel(0, frame);
+    for (unsigned int i = 1; i <= FLAGS_universes; i++) {
+      BinaryDmxFrame::EncodeHeader(i, PRIORITY, buffer.Size(), header);
+      iov[1].iov_base = const_cast<uint8_t*>(buffer.GetRaw());
+      iov[1].iov_len = buffer.Size();
+      channel->SendRawFrame(iov, 2);
+      channel->DescriptorReady();
+    }
+  }
+  return FramesPerSecond(clock, start, FLAGS_frames * FLAGS_universes);
+}
+
+int main(int argc, char *argv[]) {
+  ola::AppInit(&argc, argv, "",
+               "Compare streaming DMX with RPCs and with binary frames.");
+
+  if (!FLAGS_frames || !FLAGS_universes) {
+    return -1;
+  }
+
+  Clock clock;
+  TimeStamp wake_up_time;
+  clock.CurrentTime(&wake_up_time);
+
+  UniverseStore store(NULL, NULL);
+  for (unsigned int i = 1; i <= FLAGS_universes; i++) {
+    store.GetUniverseOrCreate(i);
+  }
+  OlaServerServiceImpl service(&store, NULL, NULL, NULL, NULL,
+                               &wake_up_time, NULL);
+  Client client(NULL, ola::rdm::UID(0x7a70, 1));
+
+  // The server reads from the other end of the loopback descriptor as the
+  // frames are sent.
+  LoopbackDescriptor socket;
+  socket.Init();
+  RpcChannel channel(&service, &socket);
+  channel.Session()->SetData(&client);
+
+  RpcController controller(channel.Session());
+  ola::proto::BinaryStreamRequest request;
+  ola::proto::BinaryStreamReply response;
+  request.set_version(BinaryDmxFrame::STREAM_VERSION);
+  service.EnableBinaryStream(&controller, &request, &response,
+                             ola::NewSingleCallback(&NoOp));
+  if (controller.Failed()) {
+    cout << "Failed to enable the binary stream: " << controller.ErrorText()
+         << endl;
+    return -1;
+  }
+
+  const double rpc_rate = BenchmarkRPC(clock, &channel);
+  const double binary_rate = BenchmarkBinary(clock, &channel);
+
+  cout << FLAGS_frames << " frames to each of " << FLAGS_universes
+       << " universes" << endl;
+  cout << std::fixed << std::setprecision(0);
+  cout << "StreamDmxData: " << rpc_rate << " frames/s" << endl;
+  cout << "Binary frames: " << binary_rate << " frames/s" << endl;
+  cout << std::setprecision(2) << "Speed up: " << binary_rate / rpc_rate
+       << "x" << endl;
+  return 0;
+}
@@ -22,6 +22,8 @@
 #include <utility>
 #include "common/protocol/Ola.pb.h"
 #include "common/protocol/OlaService.pb.h"
+#include "common/rpc/DmxDataCodec.h"
+#include "common/rpc/RpcChannel.h"
 #include "ola/Callback.h"
 #include "ola/Logging.h"
 #include "ola/rdm/UID.h"
@@ -37,7 +39,17 @@ using std::map;
 Client::Client(ola::proto::OlaClientService_Stub *client_stub,
                const ola::rdm::UID &uid)
     : m_client_stub(client_stub),
-      m_uid(uid) {
+      m_uid(uid),
+      m_update_method(
+          ola::proto::OlaClientService_Stub::descriptor()->FindMethodByName(
+              "UpdateDmxData")),
+      m_stream_method(
+          ola::proto::OlaClientService_Stub::descriptor()->FindMethodByName(
+              "StreamDmxData")),
+      m_streaming(false),
+      m_sync_pending(false),
+      m_frames_since_sync(0),
+      m_superseded_frames(0) {
 }
 
 Client::~Client() {
@@ -51,20 +63,41 @@ bool Client::SendDMX(unsigned int universe, uint8_t priority,
     return false;
   }
 
-  RpcController *controller = new RpcController();
-  ola::proto::DmxData dmx_data;
-  ola::proto::Ack *ack = new ola::proto::Ack();
+  if (!m_streaming) {
+    SendAckedDMX(universe, priority, buffer, false);
+    return true;
+  }
 
-  dmx_data.set_priority(priority);
-  dmx_data.set_universe(universe);
-  dmx_data.set_data(buffer.Get());
+  if (m_sync_pending && m_frames_since_sync >= MAX_UNACKED_FRAMES) {
+    // The client is behind, keep the latest frame until it catches up.
+    std::pair<HeldFrameMap::iterator, bool> result = m_held_frames.insert(
+        HeldFrameMap::value_type(universe, HeldFrame()));
+    if (!result.second) {
+      m_superseded_frames++;
+    }
+    result.first->second.priority = priority;
+    result.first->second.buffer = buffer;
+    return true;
+  }
+
+  if (!m_sync_pending && m_frames_since_sync >= SYNC_INTERVAL) {
+    // If the send fails the callback runs straight away, so set the state
+    // first.
+    m_sync_pending = true;
+    m_frames_since_sync = 0;
+    SendAckedDMX(universe, priority, buffer, true);
+    return true;
+  }
 
-  m_client_stub->UpdateDmxData(
-      controller,
-      &dmx_data,
-      ack,
-      ola::NewSingleCallback(this, &ola::Client::SendDMXCallback,
-                             controller, ack));
+  // Send the data straight from the DmxBuffer, rather than copying it into a
+  // DmxData message. A failed send closes the channel, so update the state
+  // first.
+  m_frames_since_sync++;
+  ola::rpc::DmxDataCodec codec;
+  ola::io::IOVec iov[ola::rpc::DmxDataCodec::MAX_IOVECS];
+  int iocnt = codec.Encode(universe, priority, buffer, iov);
+  m_client_stub->channel()->CallMethod(m_stream_method, NULL, iov, iocnt,
+                                       NULL, NULL);
   return true;
 }
 
@@ -72,15 +105,14 @@ void Client::DMXReceived(unsigned int universe, const DmxSource &source) {
   STLReplace(&m_data_map, universe, source);
 }
 
-const DmxSource Client::SourceData(unsigned int universe) const {
+const DmxSource &Client::SourceData(unsigned int universe) const {
   map<unsigned int, DmxSource>::const_iterator iter =
     m_data_map.find(universe);
 
   if (iter != m_data_map.end()) {
     return iter->second;
   } else {
-    DmxSource source;
-    return source;
+    return m_empty_source;
   }
 }
 
@@ -92,6 +124,25 @@ void Client::SetUID(const ola::rdm::UID &uid) {
   m_uid = uid;
 }
 
+/*
+ * Send DMX data with UpdateDmxData, which is acknowledged by the client.
+ */
+void Client::SendAckedDMX(unsigned int universe, uint8_t priority,
+                          const DmxBuffer &buffer, bool is_sync) {
+  RpcController *controller = new RpcController();
+  ola::proto::Ack *ack = new ola::proto::Ack();
+
+  ola::rpc::DmxDataCodec codec;
+  ola::io::IOVec iov[ola::rpc::DmxDataCodec::MAX_IOVECS];
+  int iocnt = codec.Encode(universe, priority, buffer, iov);
+
+  SingleUseCallback0<void> *callback = is_sync ?
+      NewSingleCallback(this, &ola::Client::SyncCallback, controller, ack) :
+      NewSingleCallback(this, &ola::Client::SendDMXCallback, controller, ack);
+  m_client_stub->channel()->CallMethod(m_update_method, controller, iov, iocnt,
+                                       ack, callback);
+}
+
 /*
  * Called when UpdateDmxData completes.
  */
@@ -101,5 +152,27 @@ void Client::SendDMXCallback(RpcController *controller,
   delete reply;
 }
 
+/*
+ * Called when the client acknowledges a sync frame. Send any frames that were
+ * held while we were waiting.
+ */
+void Client::SyncCallback(RpcController *controller, ola::proto::Ack *reply) {
+  const bool failed = controller->Failed();
+  delete controller;
+  delete reply;
+  if (failed) {
+    // The channel has closed and this client is being removed.
+    return;
+  }
+  m_sync_pending = false;
+
+  HeldFrameMap held_frames;
+  held_frames.swap(m_held_frames);
+  HeldFrameMap::const_iterator iter = held_frames.begin();
+  for (; iter != held_frames.end(); ++iter) {
+    SendDMX(iter->first, iter->second.priority, iter->second.buffer);
+  }
+}
+
 
 }  // namespace ola
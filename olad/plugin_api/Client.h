@@ -24,10 +24,17 @@
 #include <map>
 #include <memory>
 #include "common/rpc/RpcController.h"
+#include "ola/DmxBuffer.h"
 #include "ola/base/Macro.h"
 #include "ola/rdm/UID.h"
 #include "olad/DmxSource.h"
 
+namespace google {
+namespace protobuf {
+class MethodDescriptor;
+}
+}
+
 namespace ola {
 namespace proto {
 class OlaClientService_Stub;
@@ -62,11 +69,39 @@ class Client {
    * @param universe_id the universe the DMX data belongs to
    * @param priority the priority of the DMX data
    * @param buffer the DMX data.
-   * @return true if the update was sent, false otherwise
+   * @return true if the update was sent or held, false otherwise
    */
   virtual bool SendDMX(unsigned int universe_id, uint8_t priority,
                        const DmxBuffer &buffer);
 
+  /**
+   * @brief Set if DMX updates are streamed to this client.
+   * @param streaming true if the client accepts StreamDmxData.
+   *
+   * Streamed updates don't get a response. So that a slow client isn't
+   * flooded, every SYNC_INTERVAL frames an UpdateDmxData is sent instead,
+   * and at most MAX_UNACKED_FRAMES frames are streamed while its Ack is
+   * outstanding. Beyond that, the latest frame for each universe is held
+   * until the Ack arrives.
+   */
+  void SetStreamingDmx(bool streaming) { m_streaming = streaming; }
+
+  /**
+   * @brief Check if DMX updates are streamed to this client.
+   */
+  bool StreamingDmx() const { return m_streaming; }
+
+  /**
+   * @brief The number of frames currently held back from this client.
+   */
+  unsigned int HeldFrames() const { return m_held_frames.size(); }
+
+  /**
+   * @brief The number of held frames that were replaced by a newer frame
+   * before they could be sent.
+   */
+  unsigned int SupersededFrames() const { return m_superseded_frames; }
+
   /**
    * @brief Called when this client sends us new data
    * @param universe the id of the universe for the new data
@@ -77,8 +112,10 @@ class Client {
   /**
    * @brief Get the most recent DMX data received from this client.
    * @param universe the id of the universe we're interested in
+   * @returns the DmxSource for the universe. This remains valid, and is
+   *   updated in place by DMXReceived(), until the client is destroyed.
    */
-  const DmxSource SourceData(unsigned int universe) const;
+  const DmxSource &SourceData(unsigned int universe) const;
 
   /**
    * @brief Return the UID associated with this client.
@@ -96,12 +133,36 @@ class Client {
   void SetUID(const ola::rdm::UID &uid);
 
  private:
+  struct HeldFrame {
+    uint8_t priority;
+    DmxBuffer buffer;
+  };
+
+  typedef std::map<unsigned int, HeldFrame> HeldFrameMap;
+
+  void SendAckedDMX(unsigned int universe, uint8_t priority,
+                    const DmxBuffer &buffer, bool is_sync);
   void SendDMXCallback(ola::rpc::RpcController *controller,
                        ola::proto::Ack *ack);
+  void SyncCallback(ola::rpc::RpcController *controller,
+                    ola::proto::Ack *ack);
 
   std::auto_ptr<class ola::proto::OlaClientService_Stub> m_client_stub;
   std::map<unsigned int, DmxSource> m_data_map;
+  const DmxSource m_empty_source;
   ola::rdm::UID m_uid;
+  const google::protobuf::MethodDescriptor *m_update_method;
+  const google::protobuf::MethodDescriptor *m_stream_method;
+
+  // Streaming state
+  bool m_streaming;
+  bool m_sync_pending;
+  unsigned int m_frames_since_sync;
+  unsigned int m_superseded_frames;
+  HeldFrameMap m_held_frames;
+
+  static const unsigned int SYNC_INTERVAL = 64;
+  static const unsigned int MAX_UNACKED_FRAMES = 256;
 
   DISALLOW_COPY_AND_ASSIGN(Client);
 };
@@ -23,11 +23,16 @@
 
 #include "common/protocol/Ola.pb.h"
 #include "common/protocol/OlaService.pb.h"
+#include "common/rpc/RpcChannel.h"
 #include "common/rpc/RpcController.h"
 #include "common/rpc/RpcService.h"
+#include "common/rpc/RpcSession.h"
+#include "ola/Callback.h"
 #include "ola/Clock.h"
 #include "ola/Constants.h"
 #include "ola/DmxBuffer.h"
+#include "ola/io/Descriptor.h"
+#include "ola/io/SelectServer.h"
 #include "ola/rdm/UID.h"
 #include "ola/testing/TestUtils.h"
 #include "olad/DmxSource.h"
@@ -47,14 +52,24 @@ class ClientTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(ClientTest);
   CPPUNIT_TEST(testSendDMX);
   CPPUNIT_TEST(testGetSetDMX);
+  CPPUNIT_TEST(testStreamingSendDMX);
+  CPPUNIT_TEST(testStreamingSendFailure);
   CPPUNIT_TEST_SUITE_END();
 
  public:
-  ClientTest() : m_test_uid(ola::OPEN_LIGHTING_ESTA_CODE, 0) {}
+  ClientTest()
+      : m_channel_closes(0),
+        m_test_uid(ola::OPEN_LIGHTING_ESTA_CODE, 0) {}
   void testSendDMX();
   void testGetSetDMX();
+  void testStreamingSendDMX();
+  void testStreamingSendFailure();
 
  private:
+  unsigned int m_channel_closes;
+
+  void ChannelClosed(ola::rpc::RpcSession*) { m_channel_closes++; }
+
   ola::Clock m_clock;
   ola::rdm::UID m_test_uid;
 };
@@ -63,19 +78,22 @@ class ClientTest: public CppUnit::TestFixture {
 CPPUNIT_TEST_SUITE_REGISTRATION(ClientTest);
 
 /*
- * Mock out the ClientStub for testing
+ * Mock out the client end of the RPC channel for testing
  */
-class MockClientStub: public ola::proto::OlaClientService_Stub {
+class MockClientService: public ola::proto::OlaClientService {
  public:
-  MockClientStub(): ola::proto::OlaClientService_Stub(NULL) {}
+  explicit MockClientService(ola::io::SelectServer *ss) : m_ss(ss) {}
 
   void UpdateDmxData(ola::rpc::RpcController *controller,
                      const ola::proto::DmxData *request,
                      ola::proto::Ack *response,
                      ola::rpc::RpcService::CompletionCallback *done);
+
+ private:
+  ola::io::SelectServer *m_ss;
 };
 
-void MockClientStub::UpdateDmxData(
+void MockClientService::UpdateDmxData(
     ola::rpc::RpcController* controller,
     const ola::proto::DmxData *request,
     OLA_UNUSED ola::proto::Ack *response,
@@ -84,9 +102,42 @@ void MockClientStub::UpdateDmxData(
   OLA_ASSERT_FALSE(controller->Failed());
   OLA_ASSERT_EQ(TEST_UNIVERSE, (unsigned int) request->universe());
   OLA_ASSERT(TEST_DATA == request->data());
+  OLA_ASSERT_EQ(100, request->priority());
   done->Run();
+  m_ss->Terminate();
 }
 
+/*
+ * Counts the DMX updates that arrive at the client end of the channel.
+ */
+class CountingClientService: public ola::proto::OlaClientService {
+ public:
+  CountingClientService() : m_updates(0), m_streamed(0) {}
+
+  void UpdateDmxData(ola::rpc::RpcController*,
+                     const ola::proto::DmxData*,
+                     ola::proto::Ack*,
+                     ola::rpc::RpcService::CompletionCallback *done) {
+    m_updates++;
+    done->Run();
+  }
+
+  void StreamDmxData(ola::rpc::RpcController*,
+                     const ola::proto::DmxData *request,
+                     ola::proto::STREAMING_NO_RESPONSE*,
+                     ola::rpc::RpcService::CompletionCallback*) {
+    OLA_ASSERT(TEST_DATA == request->data());
+    m_streamed++;
+  }
+
+  unsigned int Updates() const { return m_updates; }
+  unsigned int Streamed() const { return m_streamed; }
+
+ private:
+  unsigned int m_updates;
+  unsigned int m_streamed;
+};
+
 /*
  * Check that the SendDMX method works correctly.
  */
@@ -97,9 +148,20 @@ void ClientTest::testSendDMX() {
   Client client(NULL, m_test_uid);
   client.SendDMX(TEST_UNIVERSE, priority, buffer);
 
-  // check the stub is called correctly
-  Client client2(new MockClientStub(), m_test_uid);
+  // check the data arrives at the other end of the channel
+  ola::io::SelectServer ss;
+  ola::io::LoopbackDescriptor socket;
+  socket.Init();
+  MockClientService service(&ss);
+  ola::rpc::RpcChannel channel(&service, &socket);
+  ss.AddReadDescriptor(&socket);
+
+  Client client2(new ola::proto::OlaClientService_Stub(&channel), m_test_uid);
   client2.SendDMX(TEST_UNIVERSE, priority, buffer);
+  ss.Run();
+  // Read the Ack, which runs the completion callback
+  ss.RunOnce(ola::TimeInterval(0, 0));
+  ss.RemoveReadDescriptor(&socket);
 }
 
 /*
@@ -142,3 +204,80 @@ void ClientTest::testGetSetDMX() {
   OLA_ASSERT_FALSE(source4.IsSet());
   OLA_ASSERT_DMX_EQUALS(empty, source4.Data());
 }
+
+
+/*
+ * Check that streaming clients get a sync frame periodically, and frames are
+ * held while the sync is outstanding.
+ */
+void ClientTest::testStreamingSendDMX() {
+  ola::io::SelectServer ss;
+  ola::io::LoopbackDescriptor socket;
+  socket.Init();
+  CountingClientService service;
+  ola::rpc::RpcChannel channel(&service, &socket);
+  ss.AddReadDescriptor(&socket);
+
+  Client client(new ola::proto::OlaClientService_Stub(&channel), m_test_uid);
+  client.SetStreamingDmx(true);
+  OLA_ASSERT_TRUE(client.StreamingDmx());
+
+  // 64 streamed frames, a sync, and then 256 frames while the sync is
+  // outstanding.
+  const DmxBuffer buffer(TEST_DATA);
+  for (unsigned int i = 0; i < 64 + 1 + 256; i++) {
+    OLA_ASSERT_TRUE(client.SendDMX(TEST_UNIVERSE, 100, buffer));
+  }
+  OLA_ASSERT_EQ(0u, client.HeldFrames());
+
+  // These are held, only the latest frame for each universe is kept.
+  client.SendDMX(TEST_UNIVERSE, 100, buffer);
+  client.SendDMX(TEST_UNIVERSE, 100, buffer);
+  client.SendDMX(TEST_UNIVERSE2, 100, buffer);
+  OLA_ASSERT_EQ(2u, client.HeldFrames());
+  OLA_ASSERT_EQ(1u, client.SupersededFrames());
+
+  // Once the sync is acked, the held frames are sent. The first of them is a
+  // sync, since more than 64 frames have been streamed.
+  for (unsigned int i = 0;
+       i < 1000 && (service.Updates() < 2 || service.Streamed() < 321);
+       i++) {
+    ss.RunOnce(ola::TimeInterval(0, 0));
+  }
+  OLA_ASSERT_EQ(2u, service.Updates());
+  OLA_ASSERT_EQ(321u, service.Streamed());
+  OLA_ASSERT_EQ(0u, client.HeldFrames());
+
+  // Read the last Ack
+  ss.RunOnce(ola::TimeInterval(0, 0));
+  ss.RemoveReadDescriptor(&socket);
+}
+
+
+/*
+ * Check that a sync frame which fails to send closes the channel and the
+ * held frames aren't resent.
+ */
+void ClientTest::testStreamingSendFailure() {
+  ola::io::LoopbackDescriptor socket;
+  socket.Init();
+  CountingClientService service;
+  ola::rpc::RpcChannel channel(&service, &socket);
+  channel.SetChannelCloseHandler(
+      ola::NewSingleCallback(this, &ClientTest::ChannelClosed));
+
+  Client client(new ola::proto::OlaClientService_Stub(&channel), m_test_uid);
+  client.SetStreamingDmx(true);
+
+  const DmxBuffer buffer(TEST_DATA);
+  for (unsigned int i = 0; i < 64; i++) {
+    OLA_ASSERT_TRUE(client.SendDMX(TEST_UNIVERSE, 100, buffer));
+  }
+  OLA_ASSERT_EQ(0u, m_channel_closes);
+
+  // The next frame is a sync, which fails and runs the callback inline.
+  socket.CloseClient();
+  OLA_ASSERT_TRUE(client.SendDMX(TEST_UNIVERSE, 100, buffer));
+  OLA_ASSERT_EQ(1u, m_channel_closes);
+  OLA_ASSERT_EQ(0u, client.HeldFrames());
+}
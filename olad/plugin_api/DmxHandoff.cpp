@@ -0,0 +1,79 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * DmxHandoff.cpp
+ * Passes DMX frames between threads without locking.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <stddef.h>
+#include "ola/base/Array.h"
+#include "olad/plugin_api/DmxHandoff.h"
+
+namespace ola {
+
+DmxHandoff::DmxHandoff()
+    : m_back(0),
+      m_superseded(0),
+      m_front(2),
+      m_middle(1) {
+  for (unsigned int i = 0; i < arraysize(m_frames); i++) {
+    m_frames[i].size = 0;
+    m_frames[i].priority = 0;
+  }
+}
+
+bool DmxHandoff::Publish(const DmxBuffer &buffer, uint8_t priority) {
+  Frame *frame = &m_frames[m_back];
+  frame->size = sizeof(frame->data);
+  buffer.Get(frame->data, &frame->size);
+  frame->priority = priority;
+
+  uint32_t previous = Exchange(m_back | FRESH);
+  m_back = previous & INDEX_MASK;
+  if (previous & FRESH) {
+    m_superseded++;
+    return false;
+  }
+  return true;
+}
+
+bool DmxHandoff::Take(DmxBuffer *buffer, uint8_t *priority) {
+  if (!(*static_cast<volatile uint32_t*>(&m_middle) & FRESH)) {
+    return false;
+  }
+  m_front = Exchange(m_front) & INDEX_MASK;
+  const Frame &frame = m_frames[m_front];
+  buffer->Set(frame.data, frame.size);
+  *priority = frame.priority;
+  return true;
+}
+
+/*
+ * Swap the middle buffer, the compare and swap is a full barrier so the
+ * contents of the frame are visible to the other side.
+ */
+uint32_t DmxHandoff::Exchange(uint32_t value) {
+  uint32_t current = *static_cast<volatile uint32_t*>(&m_middle);
+  while (true) {
+    uint32_t previous = __sync_val_compare_and_swap(&m_middle, current,
+                                                    value);
+    if (previous == current) {
+      return previous;
+    }
+    current = previous;
+  }
+}
+}  // namespace ola
@@ -0,0 +1,93 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * DmxHandoff.h
+ * Passes DMX frames between threads without locking.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef OLAD_PLUGIN_API_DMXHANDOFF_H_
+#define OLAD_PLUGIN_API_DMXHANDOFF_H_
+
+#include <stdint.h>
+#include "ola/Constants.h"
+#include "ola/DmxBuffer.h"
+#include "ola/base/Macro.h"
+
+namespace ola {
+
+/**
+ * @brief Passes DMX frames from one thread to another.
+ *
+ * This is a triple buffer with a single producer and a single consumer. The
+ * producer copies each frame into the back buffer and swaps it with the
+ * middle one, the consumer swaps the middle buffer with the front one. Only
+ * the latest frame is kept, so a slow consumer skips frames rather than
+ * falling behind, and neither side ever blocks.
+ *
+ * DmxBuffer uses a reference counted copy-on-write buffer, which isn't safe to
+ * share between threads, so the frames are copied in and out of plain
+ * arrays.
+ */
+class DmxHandoff {
+ public:
+  DmxHandoff();
+
+  /**
+   * @brief Publish a frame, replacing any frame which hasn't been taken yet.
+   * @param buffer the DMX data.
+   * @param priority the priority of the data.
+   * @returns true if the consumer needs to be woken up, false if the previous
+   *   frame hasn't been taken yet, in which case a wake up is already pending.
+   */
+  bool Publish(const DmxBuffer &buffer, uint8_t priority);
+
+  /**
+   * @brief Take the latest frame.
+   * @param[out] buffer the DMX data.
+   * @param[out] priority the priority of the data.
+   * @returns true if there was a new frame, false otherwise.
+   */
+  bool Take(DmxBuffer *buffer, uint8_t *priority);
+
+  /**
+   * @brief The number of frames which were replaced before they were taken.
+   *
+   * This is only updated by the producer.
+   */
+  unsigned int Superseded() const { return m_superseded; }
+
+ private:
+  struct Frame {
+    uint8_t data[DMX_UNIVERSE_SIZE];
+    unsigned int size;
+    uint8_t priority;
+  };
+
+  Frame m_frames[3];
+  unsigned int m_back;  // only used by the producer
+  unsigned int m_superseded;  // only used by the producer
+  unsigned int m_front;  // only used by the consumer
+  uint32_t m_middle;  // shared, the index of the middle buffer | FRESH
+
+  uint32_t Exchange(uint32_t value);
+
+  static const uint32_t INDEX_MASK = 0x3;
+  static const uint32_t FRESH = 0x4;
+
+  DISALLOW_COPY_AND_ASSIGN(DmxHandoff);
+};
+}  // namespace ola
+#endif  // OLAD_PLUGIN_API_DMXHANDOFF_H_
@@ -17,9 +17,13 @@ olad_plugin_api_libolaserverplugininterface_la_SOURCES = \
     olad/plugin_api/Device.cpp \
     olad/plugin_api/DeviceManager.cpp \
     olad/plugin_api/DeviceManager.h \
+    olad/plugin_api/DmxHandoff.cpp \
+    olad/plugin_api/DmxHandoff.h \
     olad/plugin_api/DmxSource.cpp \
     olad/plugin_api/Plugin.cpp \
     olad/plugin_api/PluginAdaptor.cpp \
+    olad/plugin_api/PluginThread.cpp \
+    olad/plugin_api/PluginThread.h \
     olad/plugin_api/Port.cpp \
     olad/plugin_api/PortBroker.cpp \
     olad/plugin_api/PortManager.cpp \
@@ -35,12 +39,26 @@ olad_plugin_api_libolaserverplugininterface_la_LIBADD = \
     common/web/libolaweb.la \
     ola/libola.la
 
+# PROGRAMS
+##################################################
+noinst_PROGRAMS += olad/plugin_api/universe_merge_benchmark
+
+olad_plugin_api_universe_merge_benchmark_SOURCES = \
+    olad/plugin_api/universe_merge_benchmark.cpp
+olad_plugin_api_universe_merge_benchmark_CXXFLAGS = \
+    $(COMMON_PROTOBUF_CXXFLAGS)
+olad_plugin_api_universe_merge_benchmark_LDADD = \
+    $(libprotobuf_LIBS) \
+    olad/plugin_api/libolaserverplugininterface.la \
+    common/libolacommon.la
+
 # TESTS
 ##################################################
 test_programs += \
     olad/plugin_api/ClientTester \
     olad/plugin_api/DeviceTester \
     olad/plugin_api/DmxSourceTester \
+    olad/plugin_api/PluginThreadTester \
     olad/plugin_api/PortTester \
     olad/plugin_api/PreferencesTester \
     olad/plugin_api/UniverseTester
@@ -64,6 +82,11 @@ olad_plugin_api_DmxSourceTester_SOURCES = olad/plugin_api/DmxSourceTest.cpp
 olad_plugin_api_DmxSourceTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 olad_plugin_api_DmxSourceTester_LDADD = $(COMMON_OLAD_PLUGIN_API_TEST_LDADD)
 
+olad_plugin_api_PluginThreadTester_SOURCES = \
+    olad/plugin_api/PluginThreadTest.cpp
+olad_plugin_api_PluginThreadTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
+olad_plugin_api_PluginThreadTester_LDADD = $(COMMON_OLAD_PLUGIN_API_TEST_LDADD)
+
 olad_plugin_api_PortTester_SOURCES = olad/plugin_api/PortTest.cpp \
                                      olad/plugin_api/PortManagerTest.cpp
 olad_plugin_api_PortTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
@@ -29,6 +29,7 @@ namespace ola {
 using std::string;
 
 const char Plugin::ENABLED_KEY[] = "enabled";
+const char Plugin::OWN_THREAD_KEY[] = "use_own_thread";
 
 bool Plugin::LoadPreferences() {
   if (m_preferences) {
@@ -52,6 +53,10 @@ bool Plugin::LoadPreferences() {
       ENABLED_KEY,
       BoolValidator(),
       DefaultMode());
+  if (SupportsOwnThread()) {
+    save |= m_preferences->SetDefaultValue(OWN_THREAD_KEY, BoolValidator(),
+                                           false);
+  }
   if (save) {
     m_preferences->Save();
   }
@@ -71,6 +76,11 @@ bool Plugin::IsEnabled() const {
   return m_preferences->GetValueAsBool(ENABLED_KEY);
 }
 
+bool Plugin::RunsOnOwnThread() const {
+  return (SupportsOwnThread() && m_preferences &&
+          m_preferences->GetValueAsBool(OWN_THREAD_KEY));
+}
+
 void Plugin::SetEnabledState(bool enable) {
   m_preferences->SetValueAsBool(ENABLED_KEY, enable);
   m_preferences->Save();
@@ -21,10 +21,12 @@
 
 #include <string>
 #include "ola/Callback.h"
+#include "ola/Logging.h"
 #include "olad/PluginAdaptor.h"
 #include "olad/PortBroker.h"
 #include "olad/Preferences.h"
 #include "olad/plugin_api/DeviceManager.h"
+#include "olad/plugin_api/PluginThread.h"
 
 namespace ola {
 
@@ -48,85 +50,124 @@ PluginAdaptor::PluginAdaptor(DeviceManager *device_manager,
 
 bool PluginAdaptor::AddReadDescriptor(
     ola::io::ReadFileDescriptor *descriptor) {
-  return m_ss->AddReadDescriptor(descriptor);
+  return CurrentSelectServer()->AddReadDescriptor(descriptor);
 }
 
 bool PluginAdaptor::AddReadDescriptor(
     ola::io::ConnectedDescriptor *descriptor,
     bool delete_on_close) {
-  return m_ss->AddReadDescriptor(descriptor, delete_on_close);
+  return CurrentSelectServer()->AddReadDescriptor(descriptor, delete_on_close);
 }
 
 void PluginAdaptor::RemoveReadDescriptor(
     ola::io::ReadFileDescriptor *descriptor) {
-  m_ss->RemoveReadDescriptor(descriptor);
+  CurrentSelectServer()->RemoveReadDescriptor(descriptor);
 }
 
 void PluginAdaptor::RemoveReadDescriptor(
     ola::io::ConnectedDescriptor *descriptor) {
-  m_ss->RemoveReadDescriptor(descriptor);
+  CurrentSelectServer()->RemoveReadDescriptor(descriptor);
 }
 
 bool PluginAdaptor::AddWriteDescriptor(
     ola::io::WriteFileDescriptor *descriptor) {
-  return m_ss->AddWriteDescriptor(descriptor);
+  return CurrentSelectServer()->AddWriteDescriptor(descriptor);
 }
 
 void PluginAdaptor::RemoveWriteDescriptor(
     ola::io::WriteFileDescriptor *descriptor) {
-  m_ss->RemoveWriteDescriptor(descriptor);
+  CurrentSelectServer()->RemoveWriteDescriptor(descriptor);
 }
 
 timeout_id PluginAdaptor::RegisterRepeatingTimeout(
     unsigned int ms,
     Callback0<bool> *closure) {
-  return m_ss->RegisterRepeatingTimeout(ms, closure);
+  return CurrentSelectServer()->RegisterRepeatingTimeout(ms, closure);
 }
 
 timeout_id PluginAdaptor::RegisterRepeatingTimeout(
     const TimeInterval &interval,
     Callback0<bool> *closure) {
-  return m_ss->RegisterRepeatingTimeout(interval, closure);
+  return CurrentSelectServer()->RegisterRepeatingTimeout(interval, closure);
 }
 
 timeout_id PluginAdaptor::RegisterSingleTimeout(
     unsigned int ms,
     SingleUseCallback0<void> *closure) {
-  return m_ss->RegisterSingleTimeout(ms, closure);
+  return CurrentSelectServer()->RegisterSingleTimeout(ms, closure);
 }
 
 timeout_id PluginAdaptor::RegisterSingleTimeout(
     const TimeInterval &interval,
     SingleUseCallback0<void> *closure) {
-  return m_ss->RegisterSingleTimeout(interval, closure);
+  return CurrentSelectServer()->RegisterSingleTimeout(interval, closure);
 }
 
 void PluginAdaptor::RemoveTimeout(timeout_id id) {
-  m_ss->RemoveTimeout(id);
+  CurrentSelectServer()->RemoveTimeout(id);
 }
 
 void PluginAdaptor::Execute(ola::BaseCallback0<void> *closure) {
+  CurrentSelectServer()->Execute(closure);
+}
+
+void PluginAdaptor::ExecuteOnMainThread(ola::BaseCallback0<void> *closure) {
   m_ss->Execute(closure);
 }
 
 void PluginAdaptor::DrainCallbacks() {
-  m_ss->DrainCallbacks();
+  CurrentSelectServer()->DrainCallbacks();
 }
 
 bool PluginAdaptor::RegisterDevice(AbstractDevice *device) const {
+  if (!CanUseMainThread()) {
+    return false;
+  }
   return m_device_manager->RegisterDevice(device);
 }
 
 bool PluginAdaptor::UnregisterDevice(AbstractDevice *device) const {
+  if (!CanUseMainThread()) {
+    return false;
+  }
   return m_device_manager->UnregisterDevice(device);
 }
 
 Preferences *PluginAdaptor::NewPreference(const string &name) const {
+  if (!CanUseMainThread()) {
+    return NULL;
+  }
   return m_preferences_factory->NewPreference(name);
 }
 
 const TimeStamp *PluginAdaptor::WakeUpTime() const {
-  return m_ss->WakeUpTime();
+  return CurrentSelectServer()->WakeUpTime();
+}
+
+/*
+ * If we're called from a plugin thread, use its SelectServer.
+ */
+SelectServerInterface *PluginAdaptor::CurrentSelectServer() const {
+  PluginThread *thread = PluginThread::Current();
+  if (thread) {
+    return thread->GetSelectServer();
+  }
+  return m_ss;
+}
+
+/*
+ * A plugin thread can only use the objects which belong to the main thread
+ * while the main thread is waiting for it, i.e. from StartHook() and
+ * StopHook().
+ */
+bool PluginAdaptor::CanUseMainThread() const {
+  PluginThread *thread = PluginThread::Current();
+  if (thread && !thread->InSyncCall()) {
+    OLA_WARN << "Plugins running on their own thread can only register "
+             << "devices from StartHook() or StopHook()";
+    return false;
+  }
+  return true;
 }
 
 const std::string PluginAdaptor::InstanceName() {
@@ -0,0 +1,496 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * PluginThread.cpp
+ * Runs a plugin on its own SelectServer thread.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <pthread.h>
+#include <map>
+#include <memory>
+#include "ola/Logging.h"
+#include "ola/rdm/RDMCommand.h"
+#include "ola/rdm/RDMReply.h"
+#include "ola/rdm/UIDSet.h"
+#include "ola/stl/STLUtils.h"
+#include "ola/thread/Mutex.h"
+#include "olad/Device.h"
+#include "olad/Plugin.h"
+#include "olad/PluginAdaptor.h"
+#include "olad/Port.h"
+#include "olad/Universe.h"
+#include "olad/plugin_api/PluginThread.h"
+
+namespace ola {
+
+using ola::rdm::RDMCallback;
+using ola::rdm::RDMDiscoveryCallback;
+using ola::rdm::RDMReply;
+using ola::rdm::RDMRequest;
+using ola::rdm::UIDSet;
+using ola::thread::Future;
+using ola::thread::MutexLocker;
+using ola::timecode::TimeCode;
+using std::auto_ptr;
+
+namespace {
+
+pthread_key_t current_thread_key;
+pthread_once_t current_thread_once = PTHREAD_ONCE_INIT;
+
+void CreateCurrentThreadKey() {
+  pthread_key_create(&current_thread_key, NULL);
+}
+
+// The running plugin threads, keyed by serial. 0 isn't used, so it can mean
+// the main thread.
+typedef std::map<unsigned int, PluginThread*> RunningThreadMap;
+ola::thread::Mutex running_threads_mutex;
+RunningThreadMap running_threads;
+unsigned int next_serial = 1;
+
+unsigned int NextSerial() {
+  MutexLocker lock(&running_threads_mutex);
+  return next_serial++;
+}
+
+template <class PortClass>
+void SetUniverseOnThread(PortClass *port, Universe *universe, bool *ok) {
+  *ok = port->SetUniverse(universe);
+}
+
+// The time code is passed by value, since the caller's copy may be gone by the
+// time this runs.
+void SendTimeCodeOnThread(OutputPort *port, TimeCode timecode) {
+  port->SendTimeCode(timecode);
+}
+
+void RunRDMCallback(RDMCallback *callback, RDMReply *reply_ptr) {
+  auto_ptr<RDMReply> reply(reply_ptr);
+  callback->Run(reply.get());
+}
+
+void RunDiscoveryCallback(RDMDiscoveryCallback *callback, UIDSet *uids_ptr) {
+  auto_ptr<UIDSet> uids(uids_ptr);
+  callback->Run(*uids);
+}
+
+/*
+ * Wraps an RDMCallback so it's run on the other side, either the main thread
+ * or the plugin thread. The reply is only valid for the duration of the
+ * callback, so it's copied.
+ *
+ * The reply may arrive after the plugin thread has been deleted, so the
+ * thread is held by serial, and the reply dropped if it's no longer running.
+ */
+class CrossThreadRDMCallback: public RDMCallback {
+ public:
+  CrossThreadRDMCallback(PluginThread *thread,
+                         PluginAdaptor *plugin_adaptor,
+                         RDMCallback *callback)
+      : m_thread_serial(thread ? thread->Serial() : 0),
+        m_plugin_adaptor(plugin_adaptor),
+        m_callback(callback) {
+  }
+
+  ~CrossThreadRDMCallback() {
+    // If we were never run, the request was dropped.
+    delete m_callback;
+  }
+
+  void Run(RDMReply *reply) {
+    RDMReply *copy = new RDMReply(
+        reply->StatusCode(),
+        reply->Response() ? reply->Response()->Duplicate() : NULL,
+        reply->Frames());
+    ola::BaseCallback0<void> *closure = NewSingleCallback(
+        RunRDMCallback, m_callback, copy);
+    if (!m_thread_serial) {
+      m_plugin_adaptor->ExecuteOnMainThread(closure);
+      m_callback = NULL;
+    } else if (PluginThread::ExecuteIfRunning(m_thread_serial, closure)) {
+      m_callback = NULL;
+    } else {
+      // The plugin has stopped, m_callback is deleted with this object.
+      OLA_INFO << "Plugin stopped, dropping RDM reply";
+      delete closure;
+      delete copy;
+    }
+    delete this;
+  }
+
+ private:
+  const unsigned int m_thread_serial;
+  PluginAdaptor *m_plugin_adaptor;
+  RDMCallback *m_callback;
+};
+
+/*
+ * As above, for discovery.
+ */
+class CrossThreadDiscoveryCallback: public RDMDiscoveryCallback {
+ public:
+  CrossThreadDiscoveryCallback(PluginThread *thread,
+                               PluginAdaptor *plugin_adaptor,
+                               RDMDiscoveryCallback *callback)
+      : m_thread_serial(thread ? thread->Serial() : 0),
+        m_plugin_adaptor(plugin_adaptor),
+        m_callback(callback) {
+  }
+
+  ~CrossThreadDiscoveryCallback() {
+    delete m_callback;
+  }
+
+  void Run(const UIDSet &uids) {
+    UIDSet *copy = new UIDSet(uids);
+    ola::BaseCallback0<void> *closure = NewSingleCallback(
+        RunDiscoveryCallback, m_callback, copy);
+    if (!m_thread_serial) {
+      m_plugin_adaptor->ExecuteOnMainThread(closure);
+      m_callback = NULL;
+    } else if (PluginThread::ExecuteIfRunning(m_thread_serial, closure)) {
+      m_callback = NULL;
+    } else {
+      // The plugin has stopped, m_callback is deleted with this object.
+      OLA_INFO << "Plugin stopped, dropping RDM discovery result";
+      delete closure;
+      delete copy;
+    }
+    delete this;
+  }
+
+ private:
+  const unsigned int m_thread_serial;
+  PluginAdaptor *m_plugin_adaptor;
+  RDMDiscoveryCallback *m_callback;
+};
+}  // namespace
+
+PluginThread::PluginThread(AbstractPlugin *plugin,
+                           PluginAdaptor *plugin_adaptor)
+    : ola::thread::Thread(
+          ola::thread::Thread::Options("plugin-" + plugin->Name())),
+      m_plugin(plugin),
+      m_plugin_adaptor(plugin_adaptor),
+      m_serial(NextSerial()),
+      m_started(false),
+      m_sync_call(false) {
+}
+
+PluginThread::~PluginThread() {
+  if (m_started) {
+    StopPlugin();
+  }
+  STLDeleteValues(&m_input_handoffs);
+  STLDeleteValues(&m_output_handoffs);
+}
+
+bool PluginThread::StartPlugin() {
+  if (!Start()) {
+    return false;
+  }
+
+  bool ok = false;
+  RunAndWait(NewSingleCallback(this, &PluginThread::StartOnThread, &ok));
+  if (ok) {
+    m_started = true;
+    MutexLocker lock(&running_threads_mutex);
+    running_threads[m_serial] = this;
+  } else {
+    m_ss.Terminate();
+    Join();
+  }
+  return ok;
+}
+
+void PluginThread::StopPlugin() {
+  if (!m_started) {
+    return;
+  }
+  RunAndWait(NewSingleCallback(this, &PluginThread::StopOnThread));
+  m_started = false;
+  m_ss.Terminate();
+  Join();
+
+  MutexLocker lock(&running_threads_mutex);
+  running_threads.erase(m_serial);
+}
+
+void PluginThread::Execute(ola::BaseCallback0<void> *closure) {
+  m_ss.Execute(closure);
+}
+
+bool PluginThread::ExecuteIfRunning(unsigned int serial,
+                                    ola::BaseCallback0<void> *closure) {
+  MutexLocker lock(&running_threads_mutex);
+  PluginThread *thread = STLFindOrNull(running_threads, serial);
+  if (!thread) {
+    return false;
+  }
+  thread->Execute(closure);
+  return true;
+}
+
+void PluginThread::RunAndWait(ola::BaseCallback0<void> *closure) {
+  if (Current() == this) {
+    closure->Run();
+    return;
+  }
+
+  // The closure holds its own reference to the Future, so it stays valid
+  // until Set() returns.
+  Future<void> done;
+  m_ss.Execute(NewSingleCallback(this, &PluginThread::RunSync, closure,
+                                 done));
+  done.Get();
+}
+
+void PluginThread::InputChanged(BasicInputPort *port,
+                                const DmxBuffer &buffer,
+                                uint8_t inherited_priority) {
+  DmxHandoff *handoff = GetHandoff(&m_input_handoffs, port);
+  if (handoff->Publish(buffer, inherited_priority)) {
+    ExecuteOnMain(NewSingleCallback(this, &PluginThread::DeliverInput, port,
+                                    handoff));
+  }
+}
+
+void PluginThread::HandleRDMRequest(BasicInputPort *port,
+                                    RDMRequest *request,
+                                    RDMCallback *callback) {
+  ExecuteOnMain(NewSingleCallback(
+      this, &PluginThread::MainHandleRDMRequest, port, request,
+      static_cast<RDMCallback*>(
+          new CrossThreadRDMCallback(this, m_plugin_adaptor, callback))));
+}
+
+void PluginThread::TriggerRDMDiscovery(BasicInputPort *port,
+                                       RDMDiscoveryCallback *on_complete,
+                                       bool full) {
+  ExecuteOnMain(NewSingleCallback(
+      this, &PluginThread::MainTriggerRDMDiscovery, port,
+      static_cast<RDMDiscoveryCallback*>(
+          new CrossThreadDiscoveryCallback(this, m_plugin_adaptor,
+                                           on_complete)),
+      full));
+}
+
+void PluginThread::UpdateUIDs(BasicOutputPort *port, const UIDSet &uids) {
+  ExecuteOnMain(NewSingleCallback(
+      this, &PluginThread::MainNewUIDList, static_cast<OutputPort*>(port),
+      new UIDSet(uids)));
+}
+
+PluginThread *PluginThread::Current() {
+  pthread_once(&current_thread_once, CreateCurrentThreadKey);
+  return static_cast<PluginThread*>(pthread_getspecific(current_thread_key));
+}
+
+PluginThread *PluginThread::ForDevice(const AbstractDevice *device) {
+  if (!device) {
+    return NULL;
+  }
+  AbstractPlugin *owner = device->Owner();
+  return owner ? owner->GetThread() : NULL;
+}
+
+PluginThread *PluginThread::ForPort(const Port *port) {
+  return ForDevice(port->GetDevice());
+}
+
+bool PluginThread::SetUniverse(InputPort *port, Universe *universe) {
+  PluginThread *thread = ForPort(port);
+  if (!thread) {
+    return port->SetUniverse(universe);
+  }
+  bool ok = false;
+  thread->RunAndWait(NewSingleCallback(SetUniverseOnThread<InputPort>, port,
+                                       universe, &ok));
+  return ok;
+}
+
+bool PluginThread::SetUniverse(OutputPort *port, Universe *universe) {
+  PluginThread *thread = ForPort(port);
+  if (!thread) {
+    return port->SetUniverse(universe);
+  }
+  bool ok = false;
+  thread->RunAndWait(NewSingleCallback(SetUniverseOnThread<OutputPort>, port,
+                                       universe, &ok));
+  return ok;
+}
+
+void PluginThread::WriteDMX(OutputPort *port,
+                            const DmxBuffer &buffer,
+                            uint8_t priority) {
+  PluginThread *thread = ForPort(port);
+  if (thread) {
+    thread->QueueOutput(port, buffer, priority);
+  } else {
+    port->WriteDMX(buffer, priority);
+  }
+}
+
+void PluginThread::SendRDMRequest(OutputPort *port,
+                                  RDMRequest *request,
+                                  RDMCallback *callback) {
+  PluginThread *thread = ForPort(port);
+  if (!thread) {
+    port->SendRDMRequest(request, callback);
+    return;
+  }
+  thread->Execute(NewSingleCallback(
+      port, &OutputPort::SendRDMRequest, request,
+      static_cast<RDMCallback*>(new CrossThreadRDMCallback(
+          NULL, thread->m_plugin_adaptor, callback))));
+}
+
+void PluginThread::SendTimeCode(OutputPort *port, const TimeCode &timecode) {
+  PluginThread *thread = ForPort(port);
+  if (thread) {
+    thread->Execute(NewSingleCallback(&SendTimeCodeOnThread, port, timecode));
+  } else {
+    port->SendTimeCode(timecode);
+  }
+}
+
+void PluginThread::RunRDMDiscovery(OutputPort *port,
+                                   RDMDiscoveryCallback *on_complete,
+                                   bool full) {
+  PluginThread *thread = ForPort(port);
+  RDMDiscoveryCallback *callback = on_complete;
+  if (thread) {
+    callback = new CrossThreadDiscoveryCallback(
+        NULL, thread->m_plugin_adaptor, on_complete);
+  }
+
+  ola::BaseCallback0<void> *closure;
+  if (full) {
+    closure = NewSingleCallback(port, &OutputPort::RunFullDiscovery,
+                                callback);
+  } else {
+    closure = NewSingleCallback(port, &OutputPort::RunIncrementalDiscovery,
+                                callback);
+  }
+
+  if (thread) {
+    thread->Execute(closure);
+  } else {
+    closure->Run();
+  }
+}
+
+void *PluginThread::Run() {
+  pthread_once(&current_thread_once, CreateCurrentThreadKey);
+  pthread_setspecific(current_thread_key, this);
+  m_ss.Run();
+  m_ss.DrainCallbacks();
+  pthread_setspecific(current_thread_key, NULL);
+  return NULL;
+}
+
+DmxHandoff *PluginThread::GetHandoff(HandoffMap *handoffs, const Port *port) {
+  DmxHandoff *handoff = STLFindOrNull(*handoffs, port);
+  if (!handoff) {
+    handoff = new DmxHandoff();
+    (*handoffs)[port] = handoff;
+  }
+  return handoff;
+}
+
+void PluginThread::RunSync(ola::BaseCallback0<void> *closure,
+                           Future<void> done) {
+  m_sync_call = true;
+  closure->Run();
+  m_sync_call = false;
+  done.Set();
+}
+
+void PluginThread::StartOnThread(bool *ok) {
+  *ok = m_plugin->Start();
+}
+
+void PluginThread::StopOnThread() {
+  m_plugin->Stop();
+}
+
+void PluginThread::ExecuteOnMain(ola::BaseCallback0<void> *closure) {
+  m_plugin_adaptor->ExecuteOnMainThread(closure);
+}
+
+/*
+ * The following are run on the main thread. The ports may have been deleted
+ * if the plugin has since stopped, in which case the data is dropped.
+ */
+void PluginThread::DeliverInput(BasicInputPort *port, DmxHandoff *handoff) {
+  DmxBuffer buffer;
+  uint8_t priority;
+  if (handoff->Take(&buffer, &priority) && m_started) {
+    port->UpdateSource(buffer, priority);
+  }
+}
+
+void PluginThread::MainHandleRDMRequest(BasicInputPort *port,
+                                        RDMRequest *request,
+                                        RDMCallback *callback) {
+  if (m_started) {
+    port->HandleRDMRequest(request, callback);
+  } else {
+    delete request;
+    delete callback;
+  }
+}
+
+void PluginThread::MainTriggerRDMDiscovery(BasicInputPort *port,
+                                           RDMDiscoveryCallback *on_complete,
+                                           bool full) {
+  if (m_started) {
+    port->TriggerRDMDiscovery(on_complete, full);
+  } else {
+    delete on_complete;
+  }
+}
+
+void PluginThread::MainNewUIDList(OutputPort *port, UIDSet *uids_ptr) {
+  auto_ptr<UIDSet> uids(uids_ptr);
+  Universe *universe = m_started ? port->GetUniverse() : NULL;
+  if (universe) {
+    universe->NewUIDList(port, *uids);
+  }
+}
+
+/*
+ * Run on the plugin thread.
+ */
+void PluginThread::DeliverOutput(OutputPort *port, DmxHandoff *handoff) {
+  DmxBuffer buffer;
+  uint8_t priority;
+  if (handoff->Take(&buffer, &priority)) {
+    port->WriteDMX(buffer, priority);
+  }
+}
+
+void PluginThread::QueueOutput(OutputPort *port,
+                               const DmxBuffer &buffer,
+                               uint8_t priority) {
+  DmxHandoff *handoff = GetHandoff(&m_output_handoffs, port);
+  if (handoff->Publish(buffer, priority)) {
+    m_ss.Execute(NewSingleCallback(this, &PluginThread::DeliverOutput, port,
+                                   handoff));
+  }
+}
+}  // namespace ola
@@ -0,0 +1,238 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * PluginThread.h
+ * Runs a plugin on its own SelectServer thread.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef OLAD_PLUGIN_API_PLUGINTHREAD_H_
+#define OLAD_PLUGIN_API_PLUGINTHREAD_H_
+
+#include <stdint.h>
+#include <map>
+#include "ola/Callback.h"
+#include "ola/DmxBuffer.h"
+#include "ola/base/Macro.h"
+#include "ola/io/SelectServer.h"
+#include "ola/rdm/RDMControllerInterface.h"
+#include "ola/thread/Future.h"
+#include "ola/thread/Thread.h"
+#include "ola/timecode/TimeCode.h"
+#include "olad/plugin_api/DmxHandoff.h"
+
+namespace ola {
+
+/**
+ * @brief Runs a plugin on its own SelectServer thread.
+ *
+ * The plugin's descriptors and timeouts are registered with a SelectServer
+ * owned by this thread, so a slow plugin doesn't hold up the rest of olad,
+ * and the I/O for several plugins can run on different cores. The
+ * PluginAdaptor routes the SelectServerInterface calls to the SelectServer of
+ * the calling thread, so plugins don't need to be changed, other than
+ * opting in with Plugin::SupportsOwnThread().
+ *
+ * The rest of olad, the universes, clients and RPC & HTTP servers, stays on
+ * the main thread. The two sides interact as follows:
+ *  - DMX data in both directions is passed through a DmxHandoff per port.
+ *    The receiving side is woken with an Execute() callback, but only if a
+ *    wake up isn't already pending, so a burst of frames costs one wake up
+ *    and the latest frame wins.
+ *  - Plugin start & stop, port patching and device configuration are run on
+ *    the plugin thread while the main thread waits. While it waits, the
+ *    plugin may call into the main thread's objects, e.g. to register
+ *    devices.
+ *  - RDM requests and discovery are passed to the plugin thread, and the
+ *    results are passed back to the main thread, and vice versa for
+ *    requests from input ports.
+ *  - Time code is passed to the plugin thread.
+ *
+ * The main thread may wait for a plugin thread, but a plugin thread never
+ * waits for the main thread, which prevents deadlocks.
+ */
+class PluginThread: public ola::thread::Thread {
+ public:
+  /**
+   * @brief Create a new PluginThread.
+   * @param plugin the plugin to run.
+   * @param plugin_adaptor the PluginAdaptor, used to reach the main thread.
+   */
+  PluginThread(class AbstractPlugin *plugin,
+               class PluginAdaptor *plugin_adaptor);
+  ~PluginThread();
+
+  /**
+   * @brief Start the thread, and then start the plugin on it.
+   * @returns true if the plugin started, false otherwise, in which case the
+   *   thread is stopped again.
+   */
+  bool StartPlugin();
+
+  /**
+   * @brief Stop the plugin, and then stop the thread.
+   *
+   * This must be called from the main thread, which should then drain its
+   * callbacks before deleting this object.
+   */
+  void StopPlugin();
+
+  /**
+   * @brief The SelectServer for the plugin.
+   */
+  ola::io::SelectServer *GetSelectServer() { return &m_ss; }
+
+  /**
+   * @brief Run a callback on this thread.
+   */
+  void Execute(ola::BaseCallback0<void> *closure);
+
+  /**
+   * @brief Run a callback on a plugin thread, if it's still running.
+   * @param serial the Serial() of the PluginThread.
+   * @param closure the callback to run, ownership is transferred only if
+   *   this returns true.
+   * @returns true if the callback was queued, false if the plugin has
+   *   stopped.
+   *
+   * Use this rather than holding a pointer to the PluginThread for callbacks
+   * that may complete after the plugin stops.
+   */
+  static bool ExecuteIfRunning(unsigned int serial,
+                               ola::BaseCallback0<void> *closure);
+
+  /**
+   * @brief Return the number which identifies this thread. Unlike the
+   *   address, this isn't reused by later threads.
+   */
+  unsigned int Serial() const { return m_serial; }
+
+  /**
+   * @brief Run a callback on this thread and wait for it to complete.
+   *
+   * If called from this thread, the callback is run immediately.
+   */
+  void RunAndWait(ola::BaseCallback0<void> *closure);
+
+  /**
+   * @brief Check if the thread which called RunAndWait() is waiting on us.
+   *
+   * Only meaningful when called from this thread.
+   */
+  bool InSyncCall() const { return m_sync_call; }
+
+  /**
+   * @brief Called on this thread when the data for an input port changes.
+   */
+  void InputChanged(class BasicInputPort *port,
+                    const DmxBuffer &buffer,
+                    uint8_t inherited_priority);
+
+  /**
+   * @brief Pass an RDM request from an input port to the main thread.
+   */
+  void HandleRDMRequest(class BasicInputPort *port,
+                        ola::rdm::RDMRequest *request,
+                        ola::rdm::RDMCallback *callback);
+
+  /**
+   * @brief Pass an RDM discovery request from an input port to the main
+   *   thread.
+   */
+  void TriggerRDMDiscovery(class BasicInputPort *port,
+                           ola::rdm::RDMDiscoveryCallback *on_complete,
+                           bool full);
+
+  /**
+   * @brief Pass a new UID list from an output port to the main thread.
+   */
+  void UpdateUIDs(class BasicOutputPort *port,
+                  const ola::rdm::UIDSet &uids);
+
+  /**
+   * @brief Return the PluginThread the caller is running on.
+   * @returns the PluginThread, or NULL if this isn't a plugin thread.
+   */
+  static PluginThread *Current();
+
+  /**
+   * @brief Return the PluginThread which runs a device.
+   * @returns the PluginThread, or NULL if the device runs on the main thread.
+   */
+  static PluginThread *ForDevice(const class AbstractDevice *device);
+
+  /**
+   * @brief Return the PluginThread which runs a port.
+   * @returns the PluginThread, or NULL if the port runs on the main thread.
+   */
+  static PluginThread *ForPort(const class Port *port);
+
+  /*
+   * The following are used by the main thread to call into ports, they
+   * call the port directly unless it runs on its own thread.
+   */
+  static bool SetUniverse(class InputPort *port, class Universe *universe);
+  static bool SetUniverse(class OutputPort *port, class Universe *universe);
+  static void WriteDMX(class OutputPort *port,
+                       const DmxBuffer &buffer,
+                       uint8_t priority);
+  static void SendRDMRequest(class OutputPort *port,
+                             ola::rdm::RDMRequest *request,
+                             ola::rdm::RDMCallback *callback);
+  static void RunRDMDiscovery(class OutputPort *port,
+                              ola::rdm::RDMDiscoveryCallback *on_complete,
+                              bool full);
+  static void SendTimeCode(class OutputPort *port,
+                           const ola::timecode::TimeCode &timecode);
+
+ protected:
+  void *Run();
+
+ private:
+  typedef std::map<const class Port*, DmxHandoff*> HandoffMap;
+
+  class AbstractPlugin *m_plugin;
+  class PluginAdaptor *m_plugin_adaptor;
+  const unsigned int m_serial;
+  ola::io::SelectServer m_ss;
+  bool m_started;  // only used by the main thread
+  bool m_sync_call;  // only used by this thread
+  HandoffMap m_input_handoffs;  // only used by this thread
+  HandoffMap m_output_handoffs;  // only used by the main thread
+
+  DmxHandoff *GetHandoff(HandoffMap *handoffs, const class Port *port);
+  void RunSync(ola::BaseCallback0<void> *closure,
+               ola::thread::Future<void> done);
+  void StartOnThread(bool *ok);
+  void StopOnThread();
+
+  void ExecuteOnMain(ola::BaseCallback0<void> *closure);
+  void DeliverInput(class BasicInputPort *port, DmxHandoff *handoff);
+  void MainHandleRDMRequest(class BasicInputPort *port,
+                            ola::rdm::RDMRequest *request,
+                            ola::rdm::RDMCallback *callback);
+  void MainTriggerRDMDiscovery(class BasicInputPort *port,
+                               ola::rdm::RDMDiscoveryCallback *on_complete,
+                               bool full);
+  void MainNewUIDList(class OutputPort *port, ola::rdm::UIDSet *uids);
+  void DeliverOutput(class OutputPort *port, DmxHandoff *handoff);
+  void QueueOutput(class OutputPort *port,
+                   const DmxBuffer &buffer,
+                   uint8_t priority);
+
+  DISALLOW_COPY_AND_ASSIGN(PluginThread);
+};
+}  // namespace ola
+#endif  // OLAD_PLUGIN_API_PLUGINTHREAD_H_
@@ -0,0 +1,438 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * PluginThreadTest.cpp
+ * Test fixture for the PluginThread and DmxHandoff classes.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <pthread.h>
+#include <string>
+
+#include "ola/Callback.h"
+#include "ola/Clock.h"
+#include "ola/DmxBuffer.h"
+#include "ola/Logging.h"
+#include "ola/io/SelectServer.h"
+#include "ola/rdm/RDMCommand.h"
+#include "ola/rdm/RDMReply.h"
+#include "ola/rdm/UID.h"
+#include "ola/rdm/UIDSet.h"
+#include "ola/timecode/TimeCode.h"
+#include "olad/PluginAdaptor.h"
+#include "olad/PortBroker.h"
+#include "olad/Preferences.h"
+#include "olad/Universe.h"
+#include "olad/plugin_api/Client.h"
+#include "olad/plugin_api/DeviceManager.h"
+#include "olad/plugin_api/DmxHandoff.h"
+#include "olad/plugin_api/PluginThread.h"
+#include "olad/plugin_api/PortManager.h"
+#include "olad/plugin_api/TestCommon.h"
+#include "olad/plugin_api/UniverseStore.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::DmxBuffer;
+using ola::DmxHandoff;
+using ola::NewSingleCallback;
+using ola::PluginThread;
+using ola::Universe;
+using ola::io::SelectServer;
+using ola::rdm::RDMReply;
+using ola::rdm::UID;
+using ola::rdm::UIDSet;
+using ola::timecode::TimeCode;
+
+/*
+ * An OutputPort which records the thread WriteDMX() and SendTimeCode() were
+ * called on.
+ */
+class ThreadOutputPort: public TestMockRDMOutputPort {
+ public:
+  ThreadOutputPort(ola::AbstractDevice *parent, UIDSet *uids,
+                   ola::PluginAdaptor *plugin_adaptor)
+      : TestMockRDMOutputPort(parent, 1, uids, true),
+        m_plugin_adaptor(plugin_adaptor),
+        m_writes(0),
+        m_timecode(ola::timecode::TIMECODE_FILM, 0, 0, 0, 0) {
+  }
+
+  bool WriteDMX(const DmxBuffer &buffer, uint8_t priority) {
+    TestMockRDMOutputPort::WriteDMX(buffer, priority);
+    m_thread = pthread_self();
+    m_writes++;
+    m_plugin_adaptor->ExecuteOnMainThread(
+        NewSingleCallback(this, &ThreadOutputPort::Done));
+    return true;
+  }
+
+  bool SupportsTimeCode() const { return true; }
+
+  bool SendTimeCode(const TimeCode &timecode) {
+    m_timecode = timecode;
+    m_thread = pthread_self();
+    m_plugin_adaptor->ExecuteOnMainThread(
+        NewSingleCallback(this, &ThreadOutputPort::Done));
+    return true;
+  }
+
+  pthread_t WriteThread() const { return m_thread; }
+  const TimeCode &LastTimeCode() const { return m_timecode; }
+  unsigned int Writes() const { return m_writes; }
+  void SetSelectServer(SelectServer *ss) { m_ss = ss; }
+
+ private:
+  ola::PluginAdaptor *m_plugin_adaptor;
+  SelectServer *m_ss;
+  pthread_t m_thread;
+  unsigned int m_writes;
+  TimeCode m_timecode;
+
+  void Done() { m_ss->Terminate(); }
+};
+
+
+class PluginThreadTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(PluginThreadTest);
+  CPPUNIT_TEST(testHandoff);
+  CPPUNIT_TEST(testStartStop);
+  CPPUNIT_TEST(testInput);
+  CPPUNIT_TEST(testOutput);
+  CPPUNIT_TEST(testTimeCode);
+  CPPUNIT_TEST(testLateRDMReply);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  PluginThreadTest()
+      : m_plugin_adaptor(NULL, &m_ss, NULL, &m_preferences_factory, NULL,
+                         NULL),
+        m_plugin(&m_plugin_adaptor, ola::OLA_PLUGIN_ALL) {
+  }
+
+  void setUp();
+  void tearDown();
+
+  void testHandoff();
+  void testStartStop();
+  void testInput();
+  void testOutput();
+  void testTimeCode();
+  void testLateRDMReply();
+
+ private:
+  SelectServer m_ss;
+  ola::Clock m_clock;
+  ola::MemoryPreferencesFactory m_preferences_factory;
+  ola::PluginAdaptor m_plugin_adaptor;
+  TestMockPlugin m_plugin;
+  ola::MemoryPreferences *m_preferences;
+  ola::UniverseStore *m_store;
+  PluginThread *m_thread;
+  pthread_t m_main_thread;
+  bool m_in_sync_call;
+  bool m_on_plugin_thread;
+  ola::rdm::RDMStatusCode m_rdm_status;
+  pthread_t m_rdm_thread;
+  ola::rdm::RDMCallback *m_held_rdm_callback;
+
+  void RunMain();
+  void CheckSyncCall();
+  void PluginThreadInput(TestMockInputPort *port, const DmxBuffer *buffer);
+  void RDMComplete(RDMReply *reply);
+  void SendRDMFromPlugin(TestMockInputPort *port, UID uid);
+  void HoldRDMRequest(const ola::rdm::RDMRequest *request,
+                      ola::rdm::RDMCallback *callback);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(PluginThreadTest);
+
+static const unsigned int TEST_UNIVERSE = 1;
+
+void PluginThreadTest::setUp() {
+  ola::InitLogging(ola::OLA_LOG_INFO, ola::OLA_LOG_STDERR);
+  m_preferences = new ola::MemoryPreferences("foo");
+  m_store = new ola::UniverseStore(m_preferences, NULL);
+  m_main_thread = pthread_self();
+  m_thread = new PluginThread(&m_plugin, &m_plugin_adaptor);
+}
+
+void PluginThreadTest::tearDown() {
+  m_thread->StopPlugin();
+  m_ss.DrainCallbacks();
+  m_plugin.SetThread(NULL);
+  delete m_thread;
+  m_store->DeleteAll();
+  delete m_store;
+  delete m_preferences;
+}
+
+/*
+ * Run the main SelectServer until something terminates it.
+ */
+void PluginThreadTest::RunMain() {
+  m_ss.RegisterSingleTimeout(
+      2000, NewSingleCallback(&m_ss, &SelectServer::Terminate));
+  m_ss.Run();
+}
+
+void PluginThreadTest::CheckSyncCall() {
+  m_in_sync_call = m_thread->InSyncCall();
+  m_on_plugin_thread = PluginThread::Current() == m_thread;
+}
+
+void PluginThreadTest::PluginThreadInput(TestMockInputPort *port,
+                                         const DmxBuffer *buffer) {
+  port->WriteDMX(*buffer);
+  port->DmxChanged();
+  m_plugin_adaptor.ExecuteOnMainThread(
+      NewSingleCallback(&m_ss, &SelectServer::Terminate));
+}
+
+void PluginThreadTest::RDMComplete(RDMReply *reply) {
+  m_rdm_status = reply->StatusCode();
+  m_rdm_thread = pthread_self();
+  m_ss.Terminate();
+}
+
+void PluginThreadTest::SendRDMFromPlugin(TestMockInputPort *port, UID uid) {
+  port->HandleRDMRequest(
+      new ola::rdm::RDMGetRequest(UID(0x7a70, 100), uid, 0, 0, 0, 0x60, NULL,
+                                  0),
+      NewSingleCallback(this, &PluginThreadTest::RDMComplete));
+  m_plugin_adaptor.ExecuteOnMainThread(
+      NewSingleCallback(&m_ss, &SelectServer::Terminate));
+}
+
+void PluginThreadTest::HoldRDMRequest(const ola::rdm::RDMRequest *request,
+                                      ola::rdm::RDMCallback *callback) {
+  delete request;
+  m_held_rdm_callback = callback;
+}
+
+
+/*
+ * Check the latest frame wins, and only the first frame needs a wake up.
+ */
+void PluginThreadTest::testHandoff() {
+  DmxHandoff handoff;
+  DmxBuffer buffer1, buffer2, output;
+  buffer1.SetFromString("1,2,3");
+  buffer2.SetFromString("4,5,6,7");
+  uint8_t priority = 0;
+
+  OLA_ASSERT_FALSE(handoff.Take(&output, &priority));
+  OLA_ASSERT_TRUE(handoff.Publish(buffer1, 100));
+  OLA_ASSERT_FALSE(handoff.Publish(buffer2, 120));
+  OLA_ASSERT_EQ(1u, handoff.Superseded());
+
+  OLA_ASSERT_TRUE(handoff.Take(&output, &priority));
+  OLA_ASSERT_DMX_EQUALS(buffer2, output);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(120), priority);
+  OLA_ASSERT_FALSE(handoff.Take(&output, &priority));
+
+  // Once the frame has been taken, the next one needs a wake up.
+  OLA_ASSERT_TRUE(handoff.Publish(buffer1, 100));
+  OLA_ASSERT_TRUE(handoff.Take(&output, &priority));
+  OLA_ASSERT_DMX_EQUALS(buffer1, output);
+}
+
+
+/*
+ * Check the plugin is started and stopped on its own thread.
+ */
+void PluginThreadTest::testStartStop() {
+  OLA_ASSERT_NULL(PluginThread::Current());
+  m_plugin.SetThread(m_thread);
+  OLA_ASSERT_TRUE(m_thread->StartPlugin());
+  OLA_ASSERT_TRUE(m_plugin.IsRunning());
+
+  MockDevice device(&m_plugin, "foo");
+  OLA_ASSERT_EQ(m_thread, PluginThread::ForDevice(&device));
+  MockDevice other_device(NULL, "bar");
+  OLA_ASSERT_NULL(PluginThread::ForDevice(&other_device));
+
+  m_in_sync_call = false;
+  m_on_plugin_thread = false;
+  m_thread->RunAndWait(
+      NewSingleCallback(this, &PluginThreadTest::CheckSyncCall));
+  OLA_ASSERT_TRUE(m_in_sync_call);
+  OLA_ASSERT_TRUE(m_on_plugin_thread);
+
+  m_thread->StopPlugin();
+  OLA_ASSERT_FALSE(m_plugin.IsRunning());
+}
+
+
+/*
+ * Check data from an input port on the plugin thread reaches the universe.
+ */
+void PluginThreadTest::testInput() {
+  ola::PortBroker broker;
+  ola::PortManager port_manager(m_store, &broker);
+  m_plugin.SetThread(m_thread);
+  OLA_ASSERT_TRUE(m_thread->StartPlugin());
+
+  MockDevice device(&m_plugin, "foo");
+  TestMockInputPort port(&device, 1, &m_plugin_adaptor);
+  OLA_ASSERT_TRUE(port_manager.PatchPort(&port, TEST_UNIVERSE));
+  Universe *universe = m_store->GetUniverseOrCreate(TEST_UNIVERSE);
+  OLA_ASSERT_EQ(1u, universe->InputPortCount());
+
+  DmxBuffer buffer;
+  buffer.SetFromString("10,20,30");
+  m_thread->Execute(NewSingleCallback(
+      this, &PluginThreadTest::PluginThreadInput, &port,
+      static_cast<const DmxBuffer*>(&buffer)));
+  RunMain();
+  OLA_ASSERT_DMX_EQUALS(buffer, universe->GetDMX());
+
+  port_manager.UnPatchPort(&port);
+  m_thread->StopPlugin();
+}
+
+
+/*
+ * Check universe data and RDM requests are passed to an output port on the
+ * plugin thread, and the RDM responses are passed back.
+ */
+void PluginThreadTest::testOutput() {
+  ola::PortBroker broker;
+  ola::PortManager port_manager(m_store, &broker);
+  m_plugin.SetThread(m_thread);
+  OLA_ASSERT_TRUE(m_thread->StartPlugin());
+
+  UID uid(0x7a70, 1);
+  UIDSet uids;
+  uids.AddUID(uid);
+  MockDevice device(&m_plugin, "foo");
+  ThreadOutputPort port(&device, &uids, &m_plugin_adaptor);
+  port.SetSelectServer(&m_ss);
+  // Discovery runs when the port is patched, the results are passed back to
+  // the main thread.
+  OLA_ASSERT_TRUE(port_manager.PatchPort(&port, TEST_UNIVERSE));
+  m_ss.DrainCallbacks();
+  Universe *universe = m_store->GetUniverseOrCreate(TEST_UNIVERSE);
+  OLA_ASSERT_EQ(1u, universe->UIDCount());
+
+  ola::Client client(NULL, UID(0x7a70, 100));
+  DmxBuffer buffer;
+  buffer.SetFromString("1,2,3,4");
+  ola::TimeStamp now;
+  m_clock.CurrentTime(&now);
+  universe->AddSourceClient(&client);
+  client.DMXReceived(
+      TEST_UNIVERSE,
+      ola::DmxSource(buffer, now, ola::dmx::SOURCE_PRIORITY_DEFAULT));
+  universe->SourceClientDataChanged(&client);
+  RunMain();
+  OLA_ASSERT_EQ(1u, port.Writes());
+  OLA_ASSERT_FALSE(pthread_equal(m_main_thread, port.WriteThread()));
+  OLA_ASSERT_DMX_EQUALS(buffer, port.ReadDMX());
+
+  m_rdm_status = ola::rdm::RDM_COMPLETED_OK;
+  universe->SendRDMRequest(
+      new ola::rdm::RDMGetRequest(UID(0x7a70, 100), uid, 0, 0, 0, 0x60, NULL,
+                                  0),
+      NewSingleCallback(this, &PluginThreadTest::RDMComplete));
+  RunMain();
+  OLA_ASSERT_EQ(ola::rdm::RDM_FAILED_TO_SEND, m_rdm_status);
+  OLA_ASSERT_TRUE(pthread_equal(m_main_thread, m_rdm_thread));
+
+  universe->RemoveSourceClient(&client);
+  port_manager.UnPatchPort(&port);
+  m_thread->StopPlugin();
+}
+
+
+/*
+ * Check time code is sent to the port on the plugin thread.
+ */
+void PluginThreadTest::testTimeCode() {
+  ola::PortBroker broker;
+  ola::PortManager port_manager(m_store, &broker);
+  ola::DeviceManager device_manager(&m_preferences_factory, &port_manager);
+  m_plugin.SetThread(m_thread);
+  OLA_ASSERT_TRUE(m_thread->StartPlugin());
+
+  UIDSet uids;
+  MockDevice device(&m_plugin, "foo");
+  ThreadOutputPort port(&device, &uids, &m_plugin_adaptor);
+  port.SetSelectServer(&m_ss);
+  OLA_ASSERT_TRUE(device.AddPort(&port));
+  OLA_ASSERT_TRUE(device_manager.RegisterDevice(&device));
+
+  {
+    // The caller's time code is gone before the plugin thread uses it.
+    TimeCode timecode(ola::timecode::TIMECODE_EBU, 1, 2, 3, 4);
+    device_manager.SendTimeCode(timecode);
+  }
+  RunMain();
+  OLA_ASSERT_EQ(TimeCode(ola::timecode::TIMECODE_EBU, 1, 2, 3, 4),
+                port.LastTimeCode());
+  OLA_ASSERT_FALSE(pthread_equal(m_main_thread, port.WriteThread()));
+
+  OLA_ASSERT_TRUE(device_manager.UnregisterDevice(&device));
+  m_thread->StopPlugin();
+}
+
+
+/*
+ * Check that an RDM reply for an input port which arrives after the plugin
+ * thread has been deleted is dropped.
+ */
+void PluginThreadTest::testLateRDMReply() {
+  ola::PortBroker broker;
+  ola::PortManager port_manager(m_store, &broker);
+  m_plugin.SetThread(m_thread);
+  OLA_ASSERT_TRUE(m_thread->StartPlugin());
+
+  // The input port needs the PortBroker to send RDM requests.
+  ola::PluginAdaptor plugin_adaptor(NULL, &m_ss, NULL, &m_preferences_factory,
+                                    &broker, NULL);
+  MockDevice device(&m_plugin, "foo");
+  TestMockInputPort input_port(&device, 1, &plugin_adaptor);
+  OLA_ASSERT_TRUE(port_manager.PatchPort(&input_port, TEST_UNIVERSE));
+
+  // The responder is on the main thread, and holds on to the request.
+  UID uid(0x7a70, 1);
+  UIDSet uids;
+  uids.AddUID(uid);
+  MockDevice main_device(NULL, "bar");
+  TestMockRDMOutputPort output_port(
+      &main_device, 1, &uids, true,
+      ola::NewCallback(this, &PluginThreadTest::HoldRDMRequest));
+  OLA_ASSERT_TRUE(port_manager.PatchPort(&output_port, TEST_UNIVERSE));
+
+  m_held_rdm_callback = NULL;
+  m_rdm_status = ola::rdm::RDM_COMPLETED_OK;
+  m_thread->Execute(NewSingleCallback(
+      this, &PluginThreadTest::SendRDMFromPlugin, &input_port, uid));
+  RunMain();
+  OLA_ASSERT_NOT_NULL(m_held_rdm_callback);
+
+  m_thread->StopPlugin();
+  m_plugin.SetThread(NULL);
+  delete m_thread;
+  m_thread = new PluginThread(&m_plugin, &m_plugin_adaptor);
+
+  // The responder times out.
+  ola::rdm::RunRDMCallback(m_held_rdm_callback, ola::rdm::RDM_TIMEOUT);
+  m_ss.DrainCallbacks();
+  OLA_ASSERT_EQ(ola::rdm::RDM_COMPLETED_OK, m_rdm_status);
+
+  port_manager.UnPatchPort(&input_port);
+  port_manager.UnPatchPort(&output_port);
+}
@@ -28,6 +28,7 @@
 #include "olad/Device.h"
 #include "olad/Port.h"
 #include "olad/PortBroker.h"
+#include "olad/plugin_api/PluginThread.h"
 
 namespace ola {
 
@@ -81,11 +82,21 @@ bool BasicInputPort::SetPriority(uint8_t priority) {
 }
 
 void BasicInputPort::DmxChanged() {
+  PluginThread *thread = PluginThread::Current();
+  if (thread) {
+    // The universe belongs to the main thread, so hand the data over.
+    thread->InputChanged(this, ReadDMX(), InheritedPriority());
+  } else if (GetUniverse()) {
+    UpdateSource(ReadDMX(), InheritedPriority());
+  }
+}
+
+void BasicInputPort::UpdateSource(const DmxBuffer &buffer,
+                                  uint8_t inherited_priority) {
   if (GetUniverse()) {
-    const DmxBuffer &buffer = ReadDMX();
     uint8_t priority = (PriorityCapability() == CAPABILITY_FULL &&
                         GetPriorityMode() == PRIORITY_MODE_INHERIT ?
-                        InheritedPriority() :
+                        inherited_priority :
                         GetPriority());
     m_dmx_source.UpdateData(buffer, *m_plugin_adaptor->WakeUpTime(), priority);
     GetUniverse()->PortDataChanged(this);
@@ -94,6 +105,12 @@ void BasicInputPort::DmxChanged() {
 
 void BasicInputPort::HandleRDMRequest(ola::rdm::RDMRequest *request_ptr,
                                       ola::rdm::RDMCallback *callback) {
+  PluginThread *thread = PluginThread::Current();
+  if (thread) {
+    thread->HandleRDMRequest(this, request_ptr, callback);
+    return;
+  }
+
   auto_ptr<ola::rdm::RDMRequest> request(request_ptr);
   if (m_universe) {
     m_plugin_adaptor->GetPortBroker()->SendRDMRequest(
@@ -109,6 +126,12 @@ void BasicInputPort::HandleRDMRequest(ola::rdm::RDMRequest *request_ptr,
 void BasicInputPort::TriggerRDMDiscovery(
     ola::rdm::RDMDiscoveryCallback *on_complete,
     bool full) {
+  PluginThread *thread = PluginThread::Current();
+  if (thread) {
+    thread->TriggerRDMDiscovery(this, on_complete, full);
+    return;
+  }
+
   if (m_universe) {
     m_universe->RunRDMDiscovery(on_complete, full);
   } else {
@@ -192,6 +215,12 @@ void BasicOutputPort::RunIncrementalDiscovery(
 }
 
 void BasicOutputPort::UpdateUIDs(const ola::rdm::UIDSet &uids) {
+  PluginThread *thread = PluginThread::Current();
+  if (thread) {
+    thread->UpdateUIDs(this, uids);
+    return;
+  }
+
   Universe *universe = GetUniverse();
   if (universe)
     universe->NewUIDList(this, uids);
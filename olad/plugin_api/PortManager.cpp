@@ -24,6 +24,7 @@
 #include "ola/Logging.h"
 #include "ola/StringUtils.h"
 #include "olad/Port.h"
+#include "olad/plugin_api/PluginThread.h"
 
 namespace ola {
 
@@ -115,7 +116,7 @@ bool PortManager::GenericPatchPort(PortClass *port,
   if (!universe)
     return false;
 
-  if (port->SetUniverse(universe)) {
+  if (PluginThread::SetUniverse(port, universe)) {
     OLA_INFO << "Patched " << port->UniqueId() << " to universe " <<
       universe->UniverseId();
     m_broker->AddPort(port);
@@ -137,7 +138,7 @@ bool PortManager::GenericUnPatchPort(PortClass *port) {
   m_broker->RemovePort(port);
   if (universe) {
     universe->RemovePort(port);
-    port->SetUniverse(NULL);
+    PluginThread::SetUniverse(port, NULL);
     OLA_INFO << "Unpatched " << port->UniqueId() << " from uni "
       << universe->UniverseId();
   }
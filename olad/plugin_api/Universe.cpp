@@ -49,6 +49,7 @@
 #include "olad/Port.h"
 #include "olad/Universe.h"
 #include "olad/plugin_api/Client.h"
+#include "olad/plugin_api/PluginThread.h"
 #include "olad/plugin_api/UniverseStore.h"
 
 namespace ola {
@@ -68,6 +69,8 @@ using std::vector;
 
 const char Universe::K_UNIVERSE_UID_COUNT_VAR[] = "universe-uids";
 const char Universe::K_FPS_VAR[] = "universe-dmx-frames";
+const char Universe::K_FRAMES_COALESCED_VAR[] =
+    "universe-dmx-frames-coalesced";
 const char Universe::K_MERGE_HTP_STR[] = "htp";
 const char Universe::K_MERGE_LTP_STR[] = "ltp";
 const char Universe::K_UNIVERSE_INPUT_PORT_VAR[] = "universe-input-ports";
@@ -84,19 +87,31 @@ const char Universe::K_UNIVERSE_SOURCE_CLIENTS_VAR[] =
  * @param uid  the universe id of this universe
  * @param store the store this universe came from
  * @param export_map the ExportMap that we update
+ * @param clock the Clock to use
+ * @param scheduler the scheduler to use to limit the output rate, may be NULL
  */
 Universe::Universe(unsigned int universe_id, UniverseStore *store,
                    ExportMap *export_map,
-                   Clock *clock)
+                   Clock *clock,
+                   ola::thread::SchedulerInterface *scheduler)
     : m_universe_name(""),
       m_universe_id(universe_id),
       m_active_priority(ola::dmx::SOURCE_PRIORITY_MIN),
       m_merge_mode(Universe::MERGE_LTP),
       m_universe_store(store),
       m_export_map(export_map),
+      m_fps_counter(NULL),
+      m_coalesced_counter(NULL),
+      m_rdm_request_counter(NULL),
+      m_sink_client_counter(NULL),
+      m_source_client_counter(NULL),
       m_clock(clock),
       m_rdm_discovery_interval(),
-      m_last_discovery_time() {
+      m_last_discovery_time(),
+      m_scheduler(scheduler),
+      m_max_output_rate(0),
+      m_output_timeout(ola::thread::INVALID_TIMEOUT),
+      m_expiry_timeout(ola::thread::INVALID_TIMEOUT) {
   ostringstream universe_id_str, universe_name_str;
   universe_id_str << universe_id;
   m_universe_id_str = universe_id_str.str();
@@ -108,6 +123,7 @@ Universe::Universe(unsigned int universe_id, UniverseStore *store,
 
   const char *vars[] = {
     K_FPS_VAR,
+    K_FRAMES_COALESCED_VAR,
     K_UNIVERSE_INPUT_PORT_VAR,
     K_UNIVERSE_OUTPUT_PORT_VAR,
     K_UNIVERSE_RDM_REQUESTS,
@@ -120,6 +136,11 @@ Universe::Universe(unsigned int universe_id, UniverseStore *store,
     for (unsigned int i = 0; i < arraysize(vars); ++i) {
       (*m_export_map->GetUIntMapVar(vars[i]))[m_universe_id_str] = 0;
     }
+    m_fps_counter = ExportHandle(K_FPS_VAR);
+    m_coalesced_counter = ExportHandle(K_FRAMES_COALESCED_VAR);
+    m_rdm_request_counter = ExportHandle(K_UNIVERSE_RDM_REQUESTS);
+    m_sink_client_counter = ExportHandle(K_UNIVERSE_SINK_CLIENTS_VAR);
+    m_source_client_counter = ExportHandle(K_UNIVERSE_SOURCE_CLIENTS_VAR);
   }
 
   // We set the last discovery time to now, since most ports will trigger
@@ -132,6 +153,13 @@ Universe::Universe(unsigned int universe_id, UniverseStore *store,
  * Delete this universe
  */
 Universe::~Universe() {
+  if (m_output_timeout != ola::thread::INVALID_TIMEOUT) {
+    m_scheduler->RemoveTimeout(m_output_timeout);
+  }
+  if (m_expiry_timeout != ola::thread::INVALID_TIMEOUT) {
+    m_scheduler->RemoveTimeout(m_expiry_timeout);
+  }
+
   const char *string_vars[] = {
     K_UNIVERSE_NAME_VAR,
     K_UNIVERSE_MODE_VAR,
@@ -139,6 +167,7 @@ Universe::~Universe() {
 
   const char *uint_vars[] = {
     K_FPS_VAR,
+    K_FRAMES_COALESCED_VAR,
     K_UNIVERSE_INPUT_PORT_VAR,
     K_UNIVERSE_OUTPUT_PORT_VAR,
     K_UNIVERSE_RDM_REQUESTS,
@@ -184,6 +213,20 @@ void Universe::SetMergeMode(enum merge_mode merge_mode) {
 }
 
 
+/*
+ * Set the maximum output rate
+ * @param max_fps the maximum frames per second, 0 disables rate limiting
+ */
+void Universe::SetMaxOutputRate(unsigned int max_fps) {
+  m_max_output_rate = max_fps;
+  if (!m_max_output_rate && m_output_timeout != ola::thread::INVALID_TIMEOUT) {
+    // send the pending frame now rather than waiting for the timeout
+    m_scheduler->RemoveTimeout(m_output_timeout);
+    OutputFrameDue();
+  }
+}
+
+
 /*
  * Add an InputPort to this universe.
  * @param port the port to add
@@ -208,6 +251,7 @@ bool Universe::AddPort(OutputPort *port) {
  * @return true if the port was removed, false if it didn't exist
  */
 bool Universe::RemovePort(InputPort *port) {
+  RemoveSource(port);
   return GenericRemovePort(port, &m_input_ports);
 }
 
@@ -285,7 +329,7 @@ bool Universe::AddSourceClient(Client *client) {
   OLA_INFO << "Added source client, " << client << " to universe "
            << m_universe_id;
 
-  SafeIncrement(K_UNIVERSE_SOURCE_CLIENTS_VAR);
+  SafeIncrement(m_source_client_counter);
   return true;
 }
 
@@ -301,8 +345,9 @@ bool Universe::RemoveSourceClient(Client *client) {
   if (!STLRemove(&m_source_clients, client)) {
     return false;
   }
+  RemoveSource(client);
 
-  SafeDecrement(K_UNIVERSE_SOURCE_CLIENTS_VAR);
+  SafeDecrement(m_source_client_counter);
 
   OLA_INFO << "Source client " << client << " has been removed from uni "
            << m_universe_id;
@@ -337,7 +382,7 @@ bool Universe::AddSinkClient(Client *client) {
   OLA_INFO << "Added sink client, " << client << " to universe "
            << m_universe_id;
 
-  SafeIncrement(K_UNIVERSE_SINK_CLIENTS_VAR);
+  SafeIncrement(m_sink_client_counter);
   return true;
 }
 
@@ -354,7 +399,7 @@ bool Universe::RemoveSinkClient(Client *client) {
     return false;
   }
 
-  SafeDecrement(K_UNIVERSE_SINK_CLIENTS_VAR);
+  SafeDecrement(m_sink_client_counter);
 
   OLA_INFO << "Sink client " << client << " has been removed from uni "
            << m_universe_id;
@@ -402,8 +447,9 @@ bool Universe::PortDataChanged(InputPort *port) {
              << UniverseId();
     return false;
   }
-  if (MergeAll(port, NULL)) {
-    UpdateDependants();
+  UpdateSourceIndex(port, port->SourceData());
+  if (MergeAll(port)) {
+    DataChanged();
   }
   return true;
 }
@@ -418,8 +464,9 @@ bool Universe::SourceClientDataChanged(Client *client) {
   }
 
   AddSourceClient(client);   // always add since this may be the first call
-  if (MergeAll(NULL, client)) {
-    UpdateDependants();
+  UpdateSourceIndex(client, client->SourceData(UniverseId()));
+  if (MergeAll(client)) {
+    DataChanged();
   }
   return true;
 }
@@ -433,8 +480,9 @@ void Universe::CleanStaleSourceClients() {
   while (iter != m_source_clients.end()) {
     if (iter->second) {
       // if stale remove it
+      RemoveSource(iter->first);
       m_source_clients.erase(iter++);
-      SafeDecrement(K_UNIVERSE_SOURCE_CLIENTS_VAR);
+      SafeDecrement(m_source_client_counter);
       OLA_INFO << "Removed Stale Client";
       if (!IsActive()) {
         m_universe_store->AddUniverseGarbageCollection(this);
@@ -463,7 +511,7 @@ void Universe::SendRDMRequest(RDMRequest *request_ptr,
            << ToHex(request->ParamId()) << ", PDL: "
            << request->ParamDataSize();
 
-  SafeIncrement(K_UNIVERSE_RDM_REQUESTS);
+  SafeIncrement(m_rdm_request_counter);
 
   if (request->DestinationUID().IsBroadcast()) {
     if (m_output_ports.empty()) {
@@ -488,13 +536,15 @@ void Universe::SendRDMRequest(RDMRequest *request_ptr,
          ++port_iter) {
       // because each port deletes the request, we need to copy it here
       if (request->IsDUB()) {
-        (*port_iter)->SendRDMRequest(
+        PluginThread::SendRDMRequest(
+            *port_iter,
             request->Duplicate(),
             NewSingleCallback(this,
                               &Universe::HandleBroadcastDiscovery,
                               tracker));
       } else  {
-        (*port_iter)->SendRDMRequest(
+        PluginThread::SendRDMRequest(
+            *port_iter,
             request->Duplicate(),
             NewSingleCallback(this, &Universe::HandleBroadcastAck, tracker));
       }
@@ -508,7 +558,8 @@ void Universe::SendRDMRequest(RDMRequest *request_ptr,
                << " in the output universe map, dropping request";
       RunRDMCallback(callback, ola::rdm::RDM_UNKNOWN_UID);
     } else {
-      iter->second->SendRDMRequest(request.release(), callback);
+      PluginThread::SendRDMRequest(iter->second, request.release(),
+                                   callback);
     }
   }
 }
@@ -542,19 +593,13 @@ void Universe::RunRDMDiscovery(RDMDiscoveryCallback *on_complete, bool full) {
   // will trigger, running the DiscoveryCallback.
   vector<OutputPort*>::iterator iter;
   for (iter = output_ports.begin(); iter != output_ports.end(); ++iter) {
-    if (full) {
-      (*iter)->RunFullDiscovery(
-          NewSingleCallback(this,
-                            &Universe::PortDiscoveryComplete,
-                            discovery_complete,
-                            *iter));
-    } else {
-      (*iter)->RunIncrementalDiscovery(
-          NewSingleCallback(this,
-                            &Universe::PortDiscoveryComplete,
-                            discovery_complete,
-                            *iter));
-    }
+    PluginThread::RunRDMDiscovery(
+        *iter,
+        NewSingleCallback(this,
+                          &Universe::PortDiscoveryComplete,
+                          discovery_complete,
+                          *iter),
+        full);
   }
 }
 
@@ -622,17 +667,62 @@ bool Universe::IsActive() const {
 //-----------------------------------------------------------------------------
 
 
+/*
+ * Called when the merged data for this universe changes. If the output rate
+ * is limited and the last frame was sent less than a frame period ago, this
+ * schedules the update for the end of the period. Any further changes before
+ * then are coalesced into the same frame.
+ */
+bool Universe::DataChanged() {
+  if (!m_max_output_rate || !m_scheduler) {
+    return UpdateDependants();
+  }
+
+  if (m_output_timeout != ola::thread::INVALID_TIMEOUT) {
+    // A frame is already pending, it'll pick up this change.
+    SafeIncrement(m_coalesced_counter);
+    return true;
+  }
+
+  const int64_t frame_period = USEC_IN_SECONDS / m_max_output_rate;
+  TimeStamp now;
+  m_clock->CurrentTime(&now);
+  int64_t since_last_output = (now - m_last_output_time).AsInt();
+  if (!m_last_output_time.IsSet() || since_last_output >= frame_period) {
+    return UpdateDependants();
+  }
+
+  m_output_timeout = m_scheduler->RegisterSingleTimeout(
+      TimeInterval(frame_period - since_last_output),
+      NewSingleCallback(this, &Universe::OutputFrameDue));
+  return true;
+}
+
+
+/*
+ * Called when the frame period expires with a pending frame.
+ */
+void Universe::OutputFrameDue() {
+  m_output_timeout = ola::thread::INVALID_TIMEOUT;
+  UpdateDependants();
+}
+
+
 /*
  * Called when the dmx data for this universe changes,
  * updates everyone who needs to know (patched ports and network clients)
  */
 bool Universe::UpdateDependants() {
+  if (m_max_output_rate) {
+    m_clock->CurrentTime(&m_last_output_time);
+  }
+
   vector<OutputPort*>::const_iterator iter;
   set<Client*>::const_iterator client_iter;
 
   // write to all ports assigned to this universe
   for (iter = m_output_ports.begin(); iter != m_output_ports.end(); ++iter) {
-    (*iter)->WriteDMX(m_buffer, m_active_priority);
+    PluginThread::WriteDMX(*iter, m_buffer, m_active_priority);
   }
 
   // write to all clients
@@ -642,7 +732,7 @@ bool Universe::UpdateDependants() {
     (*client_iter)->SendDMX(m_universe_id, m_active_priority, m_buffer);
   }
 
-  SafeIncrement(K_FPS_VAR);
+  SafeIncrement(m_fps_counter);
   return true;
 }
 
@@ -673,118 +763,200 @@ void Universe::UpdateMode() {
 
 
 /*
- * HTP Merge all sources (clients/ports)
- * @pre sources.size >= 2
- * @param sources the list of DmxSources to merge
+ * Update the index entry for a source.
+ * @param key the InputPort or Client the data came from
+ * @param source the new data for the source, this must remain valid until
+ *   RemoveSource() is called for the key.
  */
-void Universe::HTPMergeSources(const vector<DmxSource> &sources) {
-  vector<DmxSource>::const_iterator iter;
-  m_buffer.Reset();
+void Universe::UpdateSourceIndex(const void *key, const DmxSource &source) {
+  if (!source.IsSet() || !source.Data().Size()) {
+    RemoveSource(key);
+    return;
+  }
 
-  for (iter = sources.begin(); iter != sources.end(); ++iter) {
-    m_buffer.HTPMerge(iter->Data());
+  const uint8_t priority = source.Priority();
+  map<const void*, uint8_t>::iterator iter = m_source_priorities.find(key);
+  if (iter == m_source_priorities.end()) {
+    m_source_priorities.insert(std::make_pair(key, priority));
+  } else if (iter->second != priority) {
+    // the source moved to a different priority
+    PriorityIndex::iterator group_iter = m_source_index.find(iter->second);
+    group_iter->second.erase(key);
+    if (group_iter->second.empty()) {
+      m_source_index.erase(group_iter);
+    }
+    iter->second = priority;
+  }
+  m_source_index[priority][key] = &source;
+
+  // m_next_source_expiry is a lower bound, so it only needs to move if this
+  // source will time out before it. Since sources are usually updated with
+  // the current time that's rare.
+  TimeStamp expiry = source.ExpiryTime();
+  if (!m_next_source_expiry.IsSet() || expiry < m_next_source_expiry) {
+    m_next_source_expiry = expiry;
+    if (m_scheduler) {
+      TimeStamp now;
+      m_clock->CurrentTime(&now);
+      ScheduleSourceExpiry(now);
+    }
   }
 }
 
 
 /*
- * Merge all port/client sources.
- * This does a priority based merge as documented at:
- * https://wiki.openlighting.org/index.php/OLA_Merging_Algorithms
- * @param port the input port that changed or NULL
- * @param client the client that changed or NULL
- * @returns true if the data for this universe changed, false otherwise
+ * Remove a source from the index.
+ * @param key the InputPort or Client to remove
  */
-bool Universe::MergeAll(const InputPort *port, const Client *client) {
-  vector<DmxSource> active_sources;
+void Universe::RemoveSource(const void *key) {
+  map<const void*, uint8_t>::iterator iter = m_source_priorities.find(key);
+  if (iter == m_source_priorities.end()) {
+    return;
+  }
 
-  vector<InputPort*>::const_iterator iter;
-  SourceClientMap::const_iterator client_iter;
+  PriorityIndex::iterator group_iter = m_source_index.find(iter->second);
+  group_iter->second.erase(key);
+  if (group_iter->second.empty()) {
+    m_source_index.erase(group_iter);
+  }
+  m_source_priorities.erase(iter);
+}
 
-  m_active_priority = ola::dmx::SOURCE_PRIORITY_MIN;
-  TimeStamp now;
-  m_clock->CurrentTime(&now);
-  bool changed_source_is_active = false;
 
-  // Find the highest active ports
-  for (iter = m_input_ports.begin(); iter != m_input_ports.end(); ++iter) {
-    DmxSource source = (*iter)->SourceData();
-    if (!source.IsSet() || !source.IsActive(now) || !source.Data().Size()) {
-      continue;
+/*
+ * Remove the sources that have timed out, and recalculate the next expiry
+ * time.
+ */
+void Universe::ExpireSources(const TimeStamp &now) {
+  m_next_source_expiry = TimeStamp();
+
+  PriorityIndex::iterator group_iter = m_source_index.begin();
+  while (group_iter != m_source_index.end()) {
+    SourceGroup &group = group_iter->second;
+    SourceGroup::iterator iter = group.begin();
+    while (iter != group.end()) {
+      if (iter->second->IsActive(now)) {
+        TimeStamp expiry = iter->second->ExpiryTime();
+        if (!m_next_source_expiry.IsSet() || expiry < m_next_source_expiry) {
+          m_next_source_expiry = expiry;
+        }
+        ++iter;
+      } else {
+        m_source_priorities.erase(iter->first);
+        group.erase(iter++);
+      }
     }
 
-    if (source.Priority() > m_active_priority) {
-      changed_source_is_active = false;
-      active_sources.clear();
-      m_active_priority = source.Priority();
+    if (group.empty()) {
+      m_source_index.erase(group_iter++);
+    } else {
+      ++group_iter;
     }
+  }
+}
 
-    if (source.Priority() == m_active_priority) {
-      active_sources.push_back(source);
-      if (*iter == port) {
-        changed_source_is_active = true;
-      }
-    }
+
+/*
+ * Called when the earliest source may have timed out.
+ */
+void Universe::SourceExpiryTimeout() {
+  m_expiry_timeout = ola::thread::INVALID_TIMEOUT;
+  TimeStamp now;
+  m_clock->CurrentTime(&now);
+  ExpireSources(now);
+  if (m_next_source_expiry.IsSet()) {
+    ScheduleSourceExpiry(now);
   }
+}
 
-  // find the highest priority active clients
-  for (client_iter = m_source_clients.begin();
-       client_iter != m_source_clients.end();
-       ++client_iter) {
-    const DmxSource &source = client_iter->first->SourceData(UniverseId());
 
-    if (!source.IsSet() || !source.IsActive(now) || !source.Data().Size()) {
-      continue;
-    }
+/*
+ * (Re)schedule the timeout for m_next_source_expiry.
+ */
+void Universe::ScheduleSourceExpiry(const TimeStamp &now) {
+  if (m_expiry_timeout != ola::thread::INVALID_TIMEOUT) {
+    m_scheduler->RemoveTimeout(m_expiry_timeout);
+  }
 
-    if (source.Priority() > m_active_priority) {
-      changed_source_is_active = false;
-      active_sources.clear();
-      m_active_priority = source.Priority();
-    }
+  TimeInterval delay;
+  if (m_next_source_expiry > now) {
+    delay = m_next_source_expiry - now;
+  }
+  m_expiry_timeout = m_scheduler->RegisterSingleTimeout(
+      delay,
+      NewSingleCallback(this, &Universe::SourceExpiryTimeout));
+}
 
-    if (source.Priority() == m_active_priority) {
-      active_sources.push_back(source);
-      if (client_iter->first == client) {
-        changed_source_is_active = true;
-      }
+
+/*
+ * HTP Merge all sources (clients/ports)
+ * @pre sources.size >= 2
+ * @param sources the group of sources to merge
+ */
+void Universe::HTPMergeSources(const SourceGroup &sources) {
+  m_merge_buffers.clear();
+
+  SourceGroup::const_iterator iter;
+  for (iter = sources.begin(); iter != sources.end(); ++iter) {
+    m_merge_buffers.push_back(&iter->second->Data());
+  }
+  m_buffer.SetFromHTPMerge(&m_merge_buffers[0], m_merge_buffers.size());
+}
+
+
+/*
+ * Merge all port/client sources.
+ * This does a priority based merge as documented at:
+ * https://wiki.openlighting.org/index.php/OLA_Merging_Algorithms
+ *
+ * The sources come from the index, so only the highest priority group is
+ * examined.
+ * @param changed_source the input port or client that changed
+ * @returns true if the data for this universe changed, false otherwise
+ */
+bool Universe::MergeAll(const void *changed_source) {
+  if (!m_scheduler && m_next_source_expiry.IsSet()) {
+    // Without a scheduler, expire the sources lazily.
+    TimeStamp now;
+    m_clock->CurrentTime(&now);
+    if (now >= m_next_source_expiry) {
+      ExpireSources(now);
     }
   }
 
-  if (active_sources.empty()) {
+  if (m_source_index.empty()) {
+    m_active_priority = ola::dmx::SOURCE_PRIORITY_MIN;
     OLA_WARN << "Something changed but we didn't find any active sources "
              << " for universe " << UniverseId();
     return false;
   }
 
-  if (!changed_source_is_active) {
+  PriorityIndex::const_reverse_iterator top = m_source_index.rbegin();
+  m_active_priority = top->first;
+  const SourceGroup &active_sources = top->second;
+
+  SourceGroup::const_iterator changed = active_sources.find(changed_source);
+  if (changed == active_sources.end()) {
     // this source didn't have any effect, skip
     return false;
   }
 
   // only one source at the active priority
   if (active_sources.size() == 1) {
-    m_buffer.Set(active_sources[0].Data());
+    m_buffer.Set(changed->second->Data());
   } else {
     // multi source merge
     if (m_merge_mode == Universe::MERGE_LTP) {
-      vector<DmxSource>::const_iterator source_iter = active_sources.begin();
-      DmxSource changed_source;
-      if (port) {
-        changed_source = port->SourceData();
-      } else {
-        changed_source = client->SourceData(UniverseId());
-      }
-
       // check that the current port/client is newer than all other active
       // sources
-      for (; source_iter != active_sources.end(); source_iter++) {
-        if (changed_source.Timestamp() < source_iter->Timestamp()) {
+      SourceGroup::const_iterator iter = active_sources.begin();
+      for (; iter != active_sources.end(); ++iter) {
+        if (changed->second->Timestamp() < iter->second->Timestamp()) {
           return false;
         }
       }
       // if we made it to here this is the newest source
-      m_buffer.Set(changed_source.Data());
+      m_buffer.Set(changed->second->Data());
     } else {
       HTPMergeSources(active_sources);
     }
@@ -882,21 +1054,29 @@ void Universe::HandleBroadcastDiscovery(
 }
 
 
+/*
+ * Lookup this universe's entry in an Export Map variable. The entry is valid
+ * until it's removed in the destructor.
+ */
+unsigned int *Universe::ExportHandle(const char *name) {
+  return m_export_map->GetUIntMapVar(name)->Handle(m_universe_id_str);
+}
+
 /*
  * Helper function to increment an Export Map variable
  */
-void Universe::SafeIncrement(const string &name) {
-  if (m_export_map) {
-    (*m_export_map->GetUIntMapVar(name))[m_universe_id_str]++;
+void Universe::SafeIncrement(unsigned int *counter) {
+  if (counter) {
+    (*counter)++;
   }
 }
 
 /*
  * Helper function to decrement an Export Map variable
  */
-void Universe::SafeDecrement(const string &name) {
-  if (m_export_map) {
-    (*m_export_map->GetUIntMapVar(name))[m_universe_id_str]--;
+void Universe::SafeDecrement(unsigned int *counter) {
+  if (counter) {
+    (*counter)--;
   }
 }
 
@@ -45,15 +45,18 @@ using std::vector;
 const unsigned int UniverseStore::MINIMUM_RDM_DISCOVERY_INTERVAL = 30;
 
 UniverseStore::UniverseStore(Preferences *preferences,
-                             ExportMap *export_map)
+                             ExportMap *export_map,
+                             ola::thread::SchedulerInterface *scheduler)
     : m_preferences(preferences),
-      m_export_map(export_map) {
+      m_export_map(export_map),
+      m_scheduler(scheduler) {
   if (export_map) {
     export_map->GetStringMapVar(Universe::K_UNIVERSE_NAME_VAR, "universe");
     export_map->GetStringMapVar(Universe::K_UNIVERSE_MODE_VAR, "universe");
 
     const char *vars[] = {
       Universe::K_FPS_VAR,
+      Universe::K_FRAMES_COALESCED_VAR,
       Universe::K_UNIVERSE_INPUT_PORT_VAR,
       Universe::K_UNIVERSE_OUTPUT_PORT_VAR,
       Universe::K_UNIVERSE_SINK_CLIENTS_VAR,
@@ -80,7 +83,8 @@ Universe *UniverseStore::GetUniverseOrCreate(unsigned int universe_id) {
       &m_universe_map, universe_id);
 
   if (!iter->second) {
-    iter->second = new Universe(universe_id, this, m_export_map, &m_clock);
+    iter->second = new Universe(universe_id, this, m_export_map, &m_clock,
+                                 m_scheduler);
 
     if (iter->second) {
       if (m_preferences) {
@@ -181,6 +185,20 @@ bool UniverseStore::RestoreUniverseSettings(Universe *universe) const {
         universe->UniverseId() << ", value was " << value;
     }
   }
+
+  // load the maximum output rate
+  key = "uni_" + oss.str() + "_max_output_rate";
+  value = m_preferences->GetValue(key);
+
+  if (!value.empty()) {
+    unsigned int max_fps;
+    if (StringToInt(value, &max_fps, true)) {
+      universe->SetMaxOutputRate(max_fps);
+    } else {
+      OLA_WARN << "Invalid max output rate for universe " <<
+        universe->UniverseId() << ", value was " << value;
+    }
+  }
   return 0;
 }
 
@@ -207,8 +225,8 @@ bool UniverseStore::SaveUniverseSettings(Universe *universe) const {
   mode = (universe->MergeMode() == Universe::MERGE_HTP ? "HTP" : "LTP");
   m_preferences->SetValue(key, mode);
 
-  // We don't save the RDM Discovery interval since it can only be set in the
-  // config files for now.
+  // We don't save the RDM Discovery interval or the max output rate since they
+  // can only be set in the config files for now.
 
   m_preferences->Save();
 
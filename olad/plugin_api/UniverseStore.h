@@ -28,6 +28,7 @@
 
 #include "ola/Clock.h"
 #include "ola/base/Macro.h"
+#include "ola/thread/SchedulerInterface.h"
 
 namespace ola {
 
@@ -42,8 +43,11 @@ class UniverseStore {
    * @brief Create a new UniverseStore.
    * @param preferences The Preferences store.
    * @param export_map the ExportMap to use for stats, may be NULL.
+   * @param scheduler the scheduler the universes use to limit their output
+   *   rate, may be NULL.
    */
-  UniverseStore(class Preferences *preferences, class ExportMap *export_map);
+  UniverseStore(class Preferences *preferences, class ExportMap *export_map,
+                ola::thread::SchedulerInterface *scheduler = NULL);
 
   /**
    * @brief Destructor.
@@ -97,6 +101,7 @@ class UniverseStore {
 
   Preferences *m_preferences;
   ExportMap *m_export_map;
+  ola::thread::SchedulerInterface *m_scheduler;
   UniverseMap m_universe_map;
   std::set<Universe*> m_deletion_candiates;  // list of universes we may be
                                              // able to delete
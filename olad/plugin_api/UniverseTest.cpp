@@ -27,6 +27,9 @@
 #include "ola/Constants.h"
 #include "ola/Clock.h"
 #include "ola/DmxBuffer.h"
+#include "ola/ExportMap.h"
+#include "ola/base/Array.h"
+#include "ola/io/SelectServer.h"
 #include "ola/rdm/RDMCommand.h"
 #include "ola/rdm/RDMReply.h"
 #include "ola/rdm/RDMResponseCodes.h"
@@ -47,8 +50,10 @@
 using ola::AbstractDevice;
 using ola::Clock;
 using ola::DmxBuffer;
+using ola::MockClock;
 using ola::NewCallback;
 using ola::NewSingleCallback;
+using ola::TimeInterval;
 using ola::TimeStamp;
 using ola::Universe;
 using ola::rdm::NewDiscoveryUniqueBranchRequest;
@@ -76,6 +81,9 @@ class UniverseTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testSinkClients);
   CPPUNIT_TEST(testLtpMerging);
   CPPUNIT_TEST(testHtpMerging);
+  CPPUNIT_TEST(testOutputRateLimit);
+  CPPUNIT_TEST(testSourceExpiry);
+  CPPUNIT_TEST(testMergeManySources);
   CPPUNIT_TEST(testRDMDiscovery);
   CPPUNIT_TEST(testRDMSend);
   CPPUNIT_TEST_SUITE_END();
@@ -91,6 +99,9 @@ class UniverseTest: public CppUnit::TestFixture {
   void testSinkClients();
   void testLtpMerging();
   void testHtpMerging();
+  void testOutputRateLimit();
+  void testSourceExpiry();
+  void testMergeManySources();
   void testRDMDiscovery();
   void testRDMSend();
 
@@ -135,6 +146,27 @@ class MockClient: public ola::Client {
 };
 
 
+/*
+ * A sink client which records the frames it's sent.
+ */
+class CountingClient: public ola::Client {
+ public:
+  CountingClient()
+      : ola::Client(NULL, UID(ola::OPEN_LIGHTING_ESTA_CODE, 0)),
+        m_frames(0) {
+  }
+
+  bool SendDMX(unsigned int, uint8_t, const DmxBuffer &buffer) {
+    m_frames++;
+    m_last_frame = buffer;
+    return true;
+  }
+
+  unsigned int m_frames;
+  DmxBuffer m_last_frame;
+};
+
+
 CPPUNIT_TEST_SUITE_REGISTRATION(UniverseTest);
 
 
@@ -521,6 +553,194 @@ void UniverseTest::testHtpMerging() {
 }
 
 
+/*
+ * Check that limiting the output rate coalesces changes into a single frame.
+ */
+void UniverseTest::testOutputRateLimit() {
+  MockClock clock;
+  ola::io::SelectServer ss(NULL, &clock);
+  ola::ExportMap export_map;
+  Universe universe(TEST_UNIVERSE, m_store, &export_map, &clock, &ss);
+  universe.SetMaxOutputRate(10);
+  OLA_ASSERT_EQ(10u, universe.MaxOutputRate());
+
+  CountingClient sink;
+  MockClient source;
+  universe.AddSinkClient(&sink);
+
+  DmxBuffer buffer;
+  TimeStamp now;
+  const string frames[] = {"1,2,3", "4,5,6", "7,8,9", "10,11", "12"};
+  DmxBuffer expected[arraysize(frames)];
+  for (unsigned int i = 0; i < arraysize(frames); i++) {
+    expected[i].SetFromString(frames[i]);
+  }
+
+  // The first change is sent immediately.
+  clock.CurrentTime(&now);
+  source.DMXReceived(TEST_UNIVERSE, ola::DmxSource(expected[0], now, 100));
+  universe.SourceClientDataChanged(&source);
+  OLA_ASSERT_EQ(1u, sink.m_frames);
+  OLA_ASSERT_DMX_EQUALS(expected[0], sink.m_last_frame);
+
+  // Changes within the frame period are held back and coalesced.
+  clock.AdvanceTime(0, 10000);
+  clock.CurrentTime(&now);
+  source.DMXReceived(TEST_UNIVERSE, ola::DmxSource(expected[1], now, 100));
+  universe.SourceClientDataChanged(&source);
+  source.DMXReceived(TEST_UNIVERSE, ola::DmxSource(expected[2], now, 100));
+  universe.SourceClientDataChanged(&source);
+  OLA_ASSERT_EQ(1u, sink.m_frames);
+  OLA_ASSERT_DMX_EQUALS(expected[2], universe.GetDMX());
+
+  ss.RunOnce();
+  OLA_ASSERT_EQ(1u, sink.m_frames);
+
+  // Once the period expires, the latest data is sent.
+  clock.AdvanceTime(0, 90000);
+  ss.RunOnce();
+  OLA_ASSERT_EQ(2u, sink.m_frames);
+  OLA_ASSERT_DMX_EQUALS(expected[2], sink.m_last_frame);
+
+  // After a quiet period, changes are sent immediately again.
+  clock.AdvanceTime(0, 200000);
+  clock.CurrentTime(&now);
+  source.DMXReceived(TEST_UNIVERSE, ola::DmxSource(expected[3], now, 100));
+  universe.SourceClientDataChanged(&source);
+  OLA_ASSERT_EQ(3u, sink.m_frames);
+  OLA_ASSERT_DMX_EQUALS(expected[3], sink.m_last_frame);
+
+  // Removing the limit sends a pending frame straight away.
+  source.DMXReceived(TEST_UNIVERSE, ola::DmxSource(expected[4], now, 100));
+  universe.SourceClientDataChanged(&source);
+  OLA_ASSERT_EQ(3u, sink.m_frames);
+  universe.SetMaxOutputRate(0);
+  OLA_ASSERT_EQ(4u, sink.m_frames);
+  OLA_ASSERT_DMX_EQUALS(expected[4], sink.m_last_frame);
+
+  const string universe_id = "1";
+  OLA_ASSERT_EQ(
+      4u, (*export_map.GetUIntMapVar(Universe::K_FPS_VAR))[universe_id]);
+  OLA_ASSERT_EQ(
+      1u,
+      (*export_map.GetUIntMapVar(
+          Universe::K_FRAMES_COALESCED_VAR))[universe_id]);
+}
+
+
+/*
+ * Check that sources which time out no longer take part in the merge.
+ */
+void UniverseTest::testSourceExpiry() {
+  MockClock clock;
+  ola::io::SelectServer ss(NULL, &clock);
+  DmxBuffer high_buffer, low_buffer;
+  high_buffer.SetFromString("1,2,3");
+  low_buffer.SetFromString("4,5,6");
+  TimeStamp now;
+
+  // With a scheduler, sources are expired by a timeout.
+  Universe universe(TEST_UNIVERSE, m_store, NULL, &clock, &ss);
+  MockClient high_client, low_client;
+  clock.CurrentTime(&now);
+  high_client.DMXReceived(TEST_UNIVERSE,
+                          ola::DmxSource(high_buffer, now, 150));
+  universe.SourceClientDataChanged(&high_client);
+  low_client.DMXReceived(TEST_UNIVERSE, ola::DmxSource(low_buffer, now, 100));
+  universe.SourceClientDataChanged(&low_client);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(150), universe.ActivePriority());
+  OLA_ASSERT_DMX_EQUALS(high_buffer, universe.GetDMX());
+
+  clock.AdvanceTime(2, 600000);
+  ss.RunOnce();
+  clock.CurrentTime(&now);
+  low_client.DMXReceived(TEST_UNIVERSE, ola::DmxSource(low_buffer, now, 100));
+  universe.SourceClientDataChanged(&low_client);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(100), universe.ActivePriority());
+  OLA_ASSERT_DMX_EQUALS(low_buffer, universe.GetDMX());
+
+  // The high priority source comes back.
+  high_client.DMXReceived(TEST_UNIVERSE,
+                          ola::DmxSource(high_buffer, now, 150));
+  universe.SourceClientDataChanged(&high_client);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(150), universe.ActivePriority());
+  OLA_ASSERT_DMX_EQUALS(high_buffer, universe.GetDMX());
+
+  // Without a scheduler, sources are expired when the next change arrives.
+  Universe universe2(TEST_UNIVERSE + 1, m_store, NULL, &clock);
+  clock.CurrentTime(&now);
+  high_client.DMXReceived(TEST_UNIVERSE + 1,
+                          ola::DmxSource(high_buffer, now, 150));
+  universe2.SourceClientDataChanged(&high_client);
+  OLA_ASSERT_DMX_EQUALS(high_buffer, universe2.GetDMX());
+
+  clock.AdvanceTime(2, 600000);
+  clock.CurrentTime(&now);
+  low_client.DMXReceived(TEST_UNIVERSE + 1,
+                         ola::DmxSource(low_buffer, now, 100));
+  universe2.SourceClientDataChanged(&low_client);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(100), universe2.ActivePriority());
+  OLA_ASSERT_DMX_EQUALS(low_buffer, universe2.GetDMX());
+}
+
+
+/*
+ * Check HTP merging with many sources, as a source changes priority and is
+ * removed.
+ */
+void UniverseTest::testMergeManySources() {
+  const unsigned int SOURCE_COUNT = 64;
+  const unsigned int ROUNDS = 3;
+  ola::io::SelectServer ss;
+  Universe universe(TEST_UNIVERSE, m_store, NULL, &m_clock, &ss);
+  universe.SetMergeMode(Universe::MERGE_HTP);
+
+  MockClient clients[SOURCE_COUNT];
+  DmxBuffer buffer;
+  TimeStamp now;
+
+  for (unsigned int round = 0; round < ROUNDS; round++) {
+    m_clock.CurrentTime(&now);
+    for (unsigned int i = 0; i < SOURCE_COUNT; i++) {
+      // each source controls a different set of channels
+      buffer.Blackout();
+      buffer.SetChannel(i, round + 1);
+      buffer.SetChannel(i + SOURCE_COUNT, 255 - round);
+      clients[i].DMXReceived(TEST_UNIVERSE, ola::DmxSource(buffer, now, 100));
+      universe.SourceClientDataChanged(&clients[i]);
+    }
+  }
+  OLA_ASSERT_EQ(SOURCE_COUNT, universe.SourceClientCount());
+  OLA_ASSERT_EQ(static_cast<uint8_t>(100), universe.ActivePriority());
+
+  DmxBuffer expected;
+  expected.Blackout();
+  for (unsigned int i = 0; i < SOURCE_COUNT; i++) {
+    expected.SetChannel(i, ROUNDS);
+    expected.SetChannel(i + SOURCE_COUNT, 255 - (ROUNDS - 1));
+  }
+  OLA_ASSERT_DMX_EQUALS(expected, universe.GetDMX());
+
+  // A single source at a higher priority takes over.
+  const unsigned int HIGH = SOURCE_COUNT / 2;
+  buffer.Blackout();
+  buffer.SetChannel(HIGH, 42);
+  clients[HIGH].DMXReceived(TEST_UNIVERSE, ola::DmxSource(buffer, now, 150));
+  universe.SourceClientDataChanged(&clients[HIGH]);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(150), universe.ActivePriority());
+  OLA_ASSERT_DMX_EQUALS(buffer, universe.GetDMX());
+
+  // Once it drops back, all the sources are merged again.
+  buffer.SetChannel(HIGH + SOURCE_COUNT, 7);
+  clients[HIGH].DMXReceived(TEST_UNIVERSE, ola::DmxSource(buffer, now, 100));
+  universe.SourceClientDataChanged(&clients[HIGH]);
+  expected.SetChannel(HIGH, 42);
+  expected.SetChannel(HIGH + SOURCE_COUNT, 7);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(100), universe.ActivePriority());
+  OLA_ASSERT_DMX_EQUALS(expected, universe.GetDMX());
+}
+
+
 /**
  * Test RDM discovery for a universe/
  */
@@ -0,0 +1,205 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * universe_merge_benchmark.cpp
+ * Measure the cost of a source update on a universe with many sources.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <stdint.h>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+#include "ola/Clock.h"
+#include "ola/DmxBuffer.h"
+#include "ola/base/Flags.h"
+#include "ola/base/Init.h"
+#include "ola/rdm/UID.h"
+#include "olad/DmxSource.h"
+#include "olad/Preferences.h"
+#include "olad/Universe.h"
+#include "olad/plugin_api/Client.h"
+#include "olad/plugin_api/UniverseStore.h"
+
+using ola::Client;
+using ola::Clock;
+using ola::DmxBuffer;
+using ola::DmxSource;
+using ola::TimeInterval;
+using ola::TimeStamp;
+using ola::Universe;
+using ola::rdm::UID;
+using std::cout;
+using std::endl;
+using std::vector;
+
+DEFINE_s_uint32(iterations, i, 20000, "Number of updates per measurement");
+
+static const unsigned int MAX_SOURCES = 64;
+static const unsigned int UNIVERSE_ID = 1;
+static const uint8_t PRIORITY = 100;
+
+/**
+ * Return the number of nanoseconds each update took.
+ */
+double NanoSecondsPerUpdate(const Clock &clock,
+                            const TimeStamp &start,
+                            unsigned int iterations) {
+  TimeStamp end;
+  clock.CurrentTime(&end);
+  TimeInterval elapsed = end - start;
+  return elapsed.AsInt() * 1000.0 / iterations;
+}
+
+/**
+ * The data for a source, each source controls a different channel.
+ */
+void SourceData(unsigned int source, unsigned int iteration,
+                DmxBuffer *buffer) {
+  buffer->Blackout();
+  buffer->SetChannel(source, iteration % 256);
+}
+
+/**
+ * Update the sources in turn through a Universe, which uses the priority
+ * index.
+ * @param high_priority if true, add a source at a higher priority so the
+ *   updates don't change the output.
+ */
+double BenchmarkUniverse(Clock *clock, Universe::merge_mode mode,
+                         unsigned int source_count, bool high_priority,
+                         unsigned int iterations) {
+  ola::MemoryPreferences preferences("benchmark");
+  ola::UniverseStore store(&preferences, NULL);
+  Universe universe(UNIVERSE_ID, &store, NULL, clock);
+  universe.SetMergeMode(mode);
+
+  vector<Client*> clients;
+  for (unsigned int i = 0; i < source_count + 1; i++) {
+    clients.push_back(new Client(NULL, UID(0x7a70, i)));
+  }
+
+  TimeStamp now;
+  clock->CurrentTime(&now);
+  DmxBuffer buffer;
+  for (unsigned int i = 0; i < source_count; i++) {
+    SourceData(i, 0, &buffer);
+    clients[i]->DMXReceived(UNIVERSE_ID, DmxSource(buffer, now, PRIORITY));
+    universe.SourceClientDataChanged(clients[i]);
+  }
+  if (high_priority) {
+    buffer.Blackout();
+    clients[source_count]->DMXReceived(
+        UNIVERSE_ID, DmxSource(buffer, now, PRIORITY + 1));
+    universe.SourceClientDataChanged(clients[source_count]);
+  }
+
+  TimeStamp start;
+  clock->CurrentTime(&start);
+  for (unsigned int i = 0; i < iterations; i++) {
+    unsigned int source = i % source_count;
+    SourceData(source, i, &buffer);
+    clients[source]->DMXReceived(UNIVERSE_ID,
+                                 DmxSource(buffer, now, PRIORITY));
+    universe.SourceClientDataChanged(clients[source]);
+  }
+  double result = NanoSecondsPerUpdate(*clock, start, iterations);
+
+  vector<Client*>::iterator iter = clients.begin();
+  for (; iter != clients.end(); ++iter) {
+    universe.RemoveSourceClient(*iter);
+    delete *iter;
+  }
+  return result;
+}
+
+/**
+ * Update the sources in turn, and on each update scan all of them for the
+ * highest priority and HTP merge that group. This is what Universe did before
+ * it kept an index of the sources.
+ */
+double BenchmarkScan(const Clock &clock, unsigned int source_count,
+                     unsigned int iterations) {
+  vector<DmxSource> sources(source_count);
+  vector<const DmxBuffer*> active;
+  DmxBuffer buffer, output;
+
+  TimeStamp now;
+  clock.CurrentTime(&now);
+  for (unsigned int i = 0; i < source_count; i++) {
+    SourceData(i, 0, &buffer);
+    sources[i].UpdateData(buffer, now, PRIORITY);
+  }
+
+  TimeStamp start;
+  clock.CurrentTime(&start);
+  for (unsigned int i = 0; i < iterations; i++) {
+    unsigned int source = i % source_count;
+    SourceData(source, i, &buffer);
+    sources[source].UpdateData(buffer, now, PRIORITY);
+
+    uint8_t priority = 0;
+    active.clear();
+    vector<DmxSource>::const_iterator iter = sources.begin();
+    for (; iter != sources.end(); ++iter) {
+      if (!iter->IsActive(now)) {
+        continue;
+      }
+      if (iter->Priority() > priority) {
+        priority = iter->Priority();
+        active.clear();
+      }
+      if (iter->Priority() == priority) {
+        active.push_back(&iter->Data());
+      }
+    }
+    output.Reset();
+    vector<const DmxBuffer*>::const_iterator buffer_iter = active.begin();
+    for (; buffer_iter != active.end(); ++buffer_iter) {
+      output.HTPMerge(**buffer_iter);
+    }
+  }
+  return NanoSecondsPerUpdate(clock, start, iterations);
+}
+
+int main(int argc, char *argv[]) {
+  ola::AppInit(&argc, argv, "",
+               "Measure the cost of updating a source on a universe.");
+
+  const unsigned int iterations = FLAGS_iterations;
+  if (!iterations) {
+    return -1;
+  }
+
+  Clock clock;
+  cout << "ns per source update, " << iterations << " iterations" << endl;
+  cout << std::setw(8) << "sources" << std::setw(10) << "scan"
+       << std::setw(10) << "htp" << std::setw(10) << "ltp"
+       << std::setw(10) << "shadowed" << endl;
+  cout << std::fixed << std::setprecision(1);
+  for (unsigned int count = 1; count <= MAX_SOURCES; count *= 2) {
+    cout << std::setw(8) << count
+         << std::setw(10) << BenchmarkScan(clock, count, iterations)
+         << std::setw(10) << BenchmarkUniverse(&clock, Universe::MERGE_HTP,
+                                               count, false, iterations)
+         << std::setw(10) << BenchmarkUniverse(&clock, Universe::MERGE_LTP,
+                                               count, false, iterations)
+         << std::setw(10) << BenchmarkUniverse(&clock, Universe::MERGE_HTP,
+                                               count, true, iterations)
+         << endl;
+  }
+  cout << "shadowed: the sources are below a higher priority source." << endl;
+  return 0;
+}
@@ -104,6 +104,9 @@ bool ArtNetDevice::StartHook() {
       K_ALWAYS_BROADCAST_KEY);
   node_options.use_limited_broadcast_address = m_preferences->GetValueAsBool(
       K_LIMITED_BROADCAST_KEY);
+  // Send the ArtDmx packets for all universes once per event loop iteration.
+  node_options.batch_dmx = true;
+  node_options.export_map = m_plugin_adaptor->GetExportMap();
   // OLA Output ports are ArtNet input ports
   node_options.input_port_count = StringToIntOrDefault(
       m_preferences->GetValue(K_OUTPUT_PORT_KEY),
@@ -53,6 +53,7 @@ using ola::network::IPV4Address;
 using ola::network::IPV4SocketAddress;
 using ola::network::LittleEndianToHost;
 using ola::network::NetworkToHost;
+using ola::network::UDPBatchSender;
 using ola::network::UDPSocket;
 using ola::rdm::RDMCallback;
 using ola::rdm::RDMCommand;
@@ -207,15 +208,19 @@ ArtNetNodeImpl::ArtNetNodeImpl(const ola::network::Interface &iface,
       m_ss(ss),
       m_always_broadcast(options.always_broadcast),
       m_use_limited_broadcast_address(options.use_limited_broadcast_address),
+      m_batch_dmx(options.batch_dmx),
       m_in_configuration_mode(false),
       m_artpoll_required(false),
       m_artpollreply_required(false),
       m_interface(iface),
-      m_socket(socket) {
+      m_socket(socket),
+      m_receive_ring(RECEIVE_BATCH_SIZE, sizeof(artnet_packet),
+                     options.export_map, "artnet") {
 
   if (!m_socket.get()) {
     m_socket.reset(new UDPSocket());
   }
+  m_dmx_sender.reset(new UDPBatchSender(m_socket.get(), m_ss));
 
   for (unsigned int i = 0; i < options.input_port_count; i++) {
     m_input_ports.push_back(new InputPort());
@@ -302,6 +307,7 @@ bool ArtNetNodeImpl::Stop() {
     }
   }
 
+  m_dmx_sender->Flush();
   m_ss->RemoveReadDescriptor(m_socket.get());
 
   m_running = false;
@@ -562,12 +568,16 @@ bool ArtNetNodeImpl::SendDMX(uint8_t port_id, const DmxBuffer &buffer) {
   bool sent_ok = false;
   if (port->subscribed_nodes.size() >= m_broadcast_threshold ||
       m_always_broadcast) {
-    sent_ok = SendPacket(
-        packet,
-        size,
-        m_use_limited_broadcast_address ?
+    IPV4Address destination = m_use_limited_broadcast_address ?
         IPV4Address::Broadcast() :
-        m_interface.bcast_address);
+        m_interface.bcast_address;
+    if (m_batch_dmx) {
+      // The flush happens later, so we can only report that it was queued.
+      QueuePacket(packet, size, destination);
+      sent_ok = true;
+    } else {
+      sent_ok = SendPacket(packet, size, destination);
+    }
     port->sequence_number++;
   } else {
     map<IPV4Address, TimeStamp>::iterator iter = port->subscribed_nodes.begin();
@@ -579,7 +589,7 @@ bool ArtNetNodeImpl::SendDMX(uint8_t port_id, const DmxBuffer &buffer) {
         port->subscribed_nodes.erase(iter++);
         continue;
       }
-      sent_ok |= SendPacket(packet, size, iter->first);
+      QueuePacket(packet, size, iter->first);
       ++iter;
     }
 
@@ -591,9 +601,14 @@ bool ArtNetNodeImpl::SendDMX(uint8_t port_id, const DmxBuffer &buffer) {
     } else {
       // We sent at least one packet, increment the sequence number
       port->sequence_number++;
+      sent_ok = m_batch_dmx || m_dmx_sender->Flush() > 0;
     }
   }
 
+  if (m_batch_dmx) {
+    m_dmx_sender->ScheduleFlush();
+  }
+
   if (!sent_ok) {
     OLA_WARN << "Failed to send ArtNet DMX packet";
   }
@@ -851,17 +866,21 @@ bool ArtNetNodeImpl::SendTimeCode(const ola::timecode::TimeCode &timecode) {
 }
 
 void ArtNetNodeImpl::SocketReady() {
-  artnet_packet packet;
-  ssize_t packet_size = sizeof(packet);
-  ola::network::IPV4SocketAddress source;
-
-  if (!m_socket->RecvFrom(reinterpret_cast<uint8_t*>(&packet),
-                          &packet_size,
-                          &source)) {
-    return;
-  }
-
-  HandlePacket(source.Host(), packet, packet_size);
+  // Drain the socket so a burst of packets only costs a single wakeup.
+  // Datagrams larger than an artnet_packet are discarded by the ring and
+  // counted in udp-recv-drops.
+  unsigned int count;
+  do {
+    count = m_receive_ring.Receive(m_socket.get());
+    for (unsigned int i = 0; i < count; i++) {
+      const ola::network::IncomingDatagram &datagram =
+          m_receive_ring.Datagram(i);
+      // artnet_packet is packed, so any slot is suitably aligned.
+      HandlePacket(datagram.source.Host(),
+                   *reinterpret_cast<const artnet_packet*>(datagram.data),
+                   datagram.size);
+    }
+  } while (m_receive_ring.Full());
 }
 
 bool ArtNetNodeImpl::SendPollIfAllowed() {
@@ -1459,6 +1478,15 @@ bool ArtNetNodeImpl::SendPacket(const artnet_packet &packet,
   return true;
 }
 
+void ArtNetNodeImpl::QueuePacket(const artnet_packet &packet,
+                                 unsigned int size,
+                                 const IPV4Address &ip_destination) {
+  size += sizeof(packet.id) + sizeof(packet.op_code);
+  m_dmx_sender->Queue(reinterpret_cast<const uint8_t*>(&packet),
+                      size,
+                      IPV4SocketAddress(ip_destination, ARTNET_PORT));
+}
+
 void ArtNetNodeImpl::TimeoutRDMRequest(InputPort *port) {
   OLA_INFO << "RDM Request timed out.";
   port->rdm_send_timeout = ola::thread::INVALID_TIMEOUT;
@@ -1549,17 +1577,14 @@ void ArtNetNodeImpl::UpdatePortFromSource(OutputPort *port,
     (*port->buffer) = source.buffer;
   } else {
     // HTP merge
-    bool first = true;
+    const DmxBuffer *buffers[MAX_MERGE_SOURCES];
+    unsigned int buffer_count = 0;
     for (unsigned int i = 0; i < MAX_MERGE_SOURCES; i++) {
       if (!port->sources[i].address.IsWildcard()) {
-        if (first) {
-          (*port->buffer) = port->sources[i].buffer;
-          first = false;
-        } else {
-          port->buffer->HTPMerge(port->sources[i].buffer);
-        }
+        buffers[buffer_count++] = &port->sources[i].buffer;
       }
     }
+    port->buffer->SetFromHTPMerge(buffers, buffer_count);
   }
   port->on_data->Run();
 }
@@ -1676,6 +1701,7 @@ bool ArtNetNodeImpl::InitNetwork() {
   }
 
   m_socket->SetOnData(NewCallback(this, &ArtNetNodeImpl::SocketReady));
+  m_socket->SetDrainsOnRead(ola::network::UDPReceiveRing::DrainsSocket());
   m_ss->AddReadDescriptor(m_socket.get());
   return true;
 }
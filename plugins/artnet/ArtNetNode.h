@@ -30,10 +30,13 @@
 #include "ola/Callback.h"
 #include "ola/Clock.h"
 #include "ola/DmxBuffer.h"
+#include "ola/ExportMap.h"
 #include "ola/network/IPV4Address.h"
 #include "ola/network/Interface.h"
 #include "ola/io/SelectServerInterface.h"
 #include "ola/network/Socket.h"
+#include "ola/network/UDPBatchSender.h"
+#include "ola/network/UDPReceiveRing.h"
 #include "ola/rdm/QueueingRDMController.h"
 #include "ola/rdm/RDMCommand.h"
 #include "ola/rdm/RDMFrame.h"
@@ -67,6 +70,8 @@ class ArtNetNodeOptions {
   ArtNetNodeOptions()
       : always_broadcast(false),
         use_limited_broadcast_address(false),
+        batch_dmx(false),
+        export_map(NULL),
         rdm_queue_size(20),
         broadcast_threshold(30),
         input_port_count(4) {
@@ -74,6 +79,13 @@ class ArtNetNodeOptions {
 
   bool always_broadcast;
   bool use_limited_broadcast_address;
+  // If true, ArtDmx packets are queued and sent together at the end of the
+  // current iteration of the event loop. Batched sends are fire-and-forget,
+  // SendDMX() can't report a failure since the packets haven't been sent when
+  // it returns.
+  bool batch_dmx;
+  // If not NULL, the receive counters are exported here.
+  ola::ExportMap *export_map;
   unsigned int rdm_queue_size;
   unsigned int broadcast_threshold;
   uint8_t input_port_count;
@@ -252,7 +264,8 @@ class ArtNetNodeImpl {
    * @brief Send some DMX data
    * @param port_id port to send on
    * @param buffer the DMX data
-   * @return true if it was send successfully, false otherwise
+   * @return true if it was send successfully, false otherwise. If batch_dmx
+   *   is set, true means the data was queued.
    */
   bool SendDMX(uint8_t port_id, const ola::DmxBuffer &buffer);
 
@@ -397,6 +410,7 @@ class ArtNetNodeImpl {
   ola::io::SelectServerInterface *m_ss;
   bool m_always_broadcast;
   bool m_use_limited_broadcast_address;
+  bool m_batch_dmx;
 
   // The following keep track of "Configuration mode"
   bool m_in_configuration_mode;
@@ -407,6 +421,8 @@ class ArtNetNodeImpl {
   OutputPort m_output_ports[ARTNET_MAX_PORTS];
   ola::network::Interface m_interface;
   std::auto_ptr<ola::network::UDPSocketInterface> m_socket;
+  std::auto_ptr<ola::network::UDPBatchSender> m_dmx_sender;
+  ola::network::UDPReceiveRing m_receive_ring;
 
   /**
    * @brief Called when there is data on this socket
@@ -538,6 +554,16 @@ class ArtNetNodeImpl {
                   unsigned int size,
                   const ola::network::IPV4Address &destination);
 
+  /**
+   * @brief Queue an ArtNet packet with the DMX sender
+   * @param packet the packet to queue
+   * @param size the size of the packet, excluding the header portion
+   * @param destination where to send the packet to
+   */
+  void QueuePacket(const artnet_packet &packet,
+                   unsigned int size,
+                   const ola::network::IPV4Address &destination);
+
   /**
    * @brief Timeout a pending RDM request
    * @param port the id of the port to timeout.
@@ -649,6 +675,8 @@ class ArtNetNodeImpl {
   // The maximum number of requests we'll allow in the queue. This is a per
   // port (universe) limit.
   static const unsigned int RDM_REQUEST_QUEUE_LIMIT = 100;
+  // The maximum number of packets read with a single system call.
+  static const unsigned int RECEIVE_BATCH_SIZE = 16;
   // How long to wait for a response to an RDM Request
   static const unsigned int RDM_REQUEST_TIMEOUT_MS = 2000;
 
@@ -53,6 +53,7 @@ class ArtNetPlugin : public Plugin {
   bool StartHook();
   bool StopHook();
   bool SetDefaultPreferences();
+  bool SupportsOwnThread() const { return true; }
 
   ArtNetDevice *m_device;  // only have one device
 
@@ -68,6 +68,9 @@ bool E131Plugin::StartHook() {
       IGNORE_PREVIEW_DATA_KEY);
   options.enable_draft_discovery = m_preferences->GetValueAsBool(
       DRAFT_DISCOVERY_KEY);
+  // Send the data packets for all universes once per event loop iteration.
+  options.batch_dmx = true;
+  options.export_map = m_plugin_adaptor->GetExportMap();
   if (m_preferences->GetValueAsBool(PREPEND_HOSTNAME_KEY)) {
     std::ostringstream str;
     str << ola::network::Hostname() << "-" << m_plugin_adaptor->InstanceName();
@@ -47,6 +47,7 @@ class E131Plugin: public ola::Plugin {
     bool StartHook();
     bool StopHook();
     bool SetDefaultPreferences();
+    bool SupportsOwnThread() const { return true; }
 
     E131Device *m_device;
     static const char CID_KEY[];
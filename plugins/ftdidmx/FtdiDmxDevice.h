@@ -29,6 +29,7 @@
 #include <string>
 #include <memory>
 #include "ola/DmxBuffer.h"
+#include "ola/dmx/FrameScheduler.h"
 #include "olad/Device.h"
 #include "olad/Preferences.h"
 #include "plugins/ftdidmx/FtdiWidget.h"
@@ -41,7 +42,8 @@ class FtdiDmxDevice : public Device {
  public:
   FtdiDmxDevice(AbstractPlugin *owner,
                 const FtdiWidgetInfo &widget_info,
-                unsigned int frequency);
+                unsigned int frequency,
+                ola::dmx::FrameScheduler *scheduler);
   ~FtdiDmxDevice();
 
   std::string DeviceId() const { return m_widget->Serial(); }
@@ -55,6 +57,7 @@ class FtdiDmxDevice : public Device {
   FtdiWidget *m_widget;
   const FtdiWidgetInfo m_widget_info;
   unsigned int m_frequency;
+  ola::dmx::FrameScheduler *m_scheduler;
 };
 }  // namespace ftdidmx
 }  // namespace plugin
@@ -41,7 +41,9 @@ namespace ftdidmx {
 using std::string;
 using std::vector;
 
+const char FtdiDmxPlugin::K_CPU[] = "cpu";
 const char FtdiDmxPlugin::K_FREQUENCY[] = "frequency";
+const char FtdiDmxPlugin::K_REALTIME_PRIORITY[] = "realtime_priority";
 const char FtdiDmxPlugin::PLUGIN_NAME[] = "FTDI USB DMX";
 const char FtdiDmxPlugin::PLUGIN_PREFIX[] = "ftdidmx";
 
@@ -73,9 +75,22 @@ bool FtdiDmxPlugin::StartHook() {
       m_preferences->GetValue(K_FREQUENCY),
       DEFAULT_FREQUENCY);
 
+  // All the widgets share one thread to generate the frames.
+  ola::dmx::FrameScheduler::Options options;
+  options.realtime_priority = StringToIntOrDefault(
+      m_preferences->GetValue(K_REALTIME_PRIORITY), 0u);
+  options.cpu = StringToIntOrDefault(m_preferences->GetValue(K_CPU), -1);
+  m_scheduler.reset(new ola::dmx::FrameScheduler(
+      options, m_plugin_adaptor->GetExportMap()));
+  if (!m_scheduler->Start()) {
+    OLA_WARN << "Failed to start the FTDI frame thread";
+    m_scheduler.reset();
+    return false;
+  }
+
   FtdiWidgetInfoVector::const_iterator iter;
   for (iter = widgets.begin(); iter != widgets.end(); ++iter) {
-    AddDevice(new FtdiDmxDevice(this, *iter, frequency));
+    AddDevice(new FtdiDmxDevice(this, *iter, frequency, m_scheduler.get()));
   }
   return true;
 }
@@ -92,6 +107,11 @@ bool FtdiDmxPlugin::StopHook() {
     delete (*iter);
   }
   m_devices.clear();
+
+  if (m_scheduler.get()) {
+    m_scheduler->Stop();
+    m_scheduler.reset();
+  }
   return true;
 }
 
@@ -112,9 +132,15 @@ bool FtdiDmxPlugin::SetDefaultPreferences() {
     return false;
   }
 
-  if (m_preferences->SetDefaultValue(FtdiDmxPlugin::K_FREQUENCY,
-                                     UIntValidator(1, 44),
-                                     DEFAULT_FREQUENCY)) {
+  bool save = false;
+  save |= m_preferences->SetDefaultValue(FtdiDmxPlugin::K_FREQUENCY,
+                                         UIntValidator(1, 44),
+                                         DEFAULT_FREQUENCY);
+  save |= m_preferences->SetDefaultValue(FtdiDmxPlugin::K_REALTIME_PRIORITY,
+                                         UIntValidator(0, 99), 0);
+  save |= m_preferences->SetDefaultValue(FtdiDmxPlugin::K_CPU,
+                                         IntValidator(-1, 1023), -1);
+  if (save) {
     m_preferences->Save();
   }
 
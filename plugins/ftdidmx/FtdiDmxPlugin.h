@@ -22,10 +22,12 @@
 #define PLUGINS_FTDIDMX_FTDIDMXPLUGIN_H_
 
 #include <set>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "olad/Plugin.h"
+#include "ola/dmx/FrameScheduler.h"
 #include "ola/plugin_id.h"
 
 #include "plugins/ftdidmx/FtdiDmxDevice.h"
@@ -57,6 +59,7 @@ class FtdiDmxPlugin : public Plugin {
  private:
   typedef std::vector<FtdiDmxDevice*> FtdiDeviceVector;
   FtdiDeviceVector m_devices;
+  std::auto_ptr<ola::dmx::FrameScheduler> m_scheduler;
 
   void AddDevice(FtdiDmxDevice *device);
   bool StartHook();
@@ -65,7 +68,9 @@ class FtdiDmxPlugin : public Plugin {
 
   static const uint8_t DEFAULT_FREQUENCY = 30;
 
+  static const char K_CPU[];
   static const char K_FREQUENCY[];
+  static const char K_REALTIME_PRIORITY[];
   static const char PLUGIN_NAME[];
   static const char PLUGIN_PREFIX[];
 };
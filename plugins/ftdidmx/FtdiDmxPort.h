@@ -29,11 +29,12 @@
 #include <string>
 
 #include "ola/DmxBuffer.h"
+#include "ola/dmx/FrameScheduler.h"
+#include "ola/strings/Format.h"
 #include "olad/Port.h"
 #include "olad/Preferences.h"
 #include "plugins/ftdidmx/FtdiDmxDevice.h"
 #include "plugins/ftdidmx/FtdiWidget.h"
-#include "plugins/ftdidmx/FtdiDmxThread.h"
 
 namespace ola {
 namespace plugin {
@@ -44,26 +45,32 @@ class FtdiDmxOutputPort : public ola::BasicOutputPort {
     FtdiDmxOutputPort(FtdiDmxDevice *parent,
                       FtdiInterface *interface,
                       unsigned int id,
-                      unsigned int freq)
+                      unsigned int freq,
+                      ola::dmx::FrameScheduler *scheduler)
         : BasicOutputPort(parent, id),
           m_interface(interface),
-          m_thread(interface, freq) {
-      m_thread.Start();
+          m_scheduler(scheduler) {
+      ola::dmx::FrameScheduler::PortOptions options;
+      options.name = parent->DeviceId() + "-" + ola::strings::IntToString(id);
+      options.refresh_rate = freq;
+      m_port = m_scheduler->AddPort(m_interface, options);
     }
     ~FtdiDmxOutputPort() {
-      m_thread.Stop();
+      m_scheduler->RemovePort(m_port);
       delete m_interface;
     }
 
     bool WriteDMX(const ola::DmxBuffer &buffer, uint8_t) {
-      return m_thread.WriteDMX(buffer);
+      m_scheduler->WriteDMX(m_port, buffer);
+      return true;
     }
 
     std::string Description() const { return m_interface->Description(); }
 
  private:
     FtdiInterface *m_interface;
-    FtdiDmxThread m_thread;
+    ola::dmx::FrameScheduler *m_scheduler;
+    ola::dmx::FrameScheduler::Port *m_port;
 };
 }  // namespace ftdidmx
 }  // namespace plugin
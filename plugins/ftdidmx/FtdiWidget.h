@@ -43,6 +43,7 @@
 #include <vector>
 
 #include "ola/DmxBuffer.h"
+#include "ola/dmx/FrameScheduler.h"
 
 namespace ola {
 namespace plugin {
@@ -171,7 +172,7 @@ class FtdiWidget {
   const uint16_t m_pid;
 };
 
-class FtdiInterface {
+class FtdiInterface : public ola::dmx::SerialDmxOutput {
  public:
   FtdiInterface(const FtdiWidget * parent,
                 const ftdi_interface interface);
@@ -4,8 +4,12 @@ if USE_SPI
 # This is a library which isn't coupled to olad
 lib_LTLIBRARIES += plugins/spi/libolaspicore.la plugins/spi/libolaspi.la
 plugins_spi_libolaspicore_la_SOURCES = \
+    plugins/spi/PixelEncoder.cpp \
+    plugins/spi/PixelEncoder.h \
     plugins/spi/SPIBackend.cpp \
     plugins/spi/SPIBackend.h \
+    plugins/spi/SPIChainOutput.cpp \
+    plugins/spi/SPIChainOutput.h \
     plugins/spi/SPIOutput.cpp \
     plugins/spi/SPIOutput.h \
     plugins/spi/SPIWriter.cpp \
@@ -31,12 +35,22 @@ plugins_spi_libolaspi_la_LIBADD = \
     olad/plugin_api/libolaserverplugininterface.la \
     plugins/spi/libolaspicore.la
 
+# PROGRAMS
+##################################################
+noinst_PROGRAMS += plugins/spi/pixel_encoder_benchmark
+plugins_spi_pixel_encoder_benchmark_SOURCES = \
+    plugins/spi/pixel_encoder_benchmark.cpp
+plugins_spi_pixel_encoder_benchmark_LDADD = common/libolacommon.la \
+                                            plugins/spi/libolaspicore.la
+
 # TESTS
 ##################################################
 test_programs += plugins/spi/SPITester
 
 plugins_spi_SPITester_SOURCES = \
+    plugins/spi/PixelEncoderTest.cpp \
     plugins/spi/SPIBackendTest.cpp \
+    plugins/spi/SPIChainOutputTest.cpp \
     plugins/spi/SPIOutputTest.cpp \
     plugins/spi/FakeSPIWriter.cpp \
     plugins/spi/FakeSPIWriter.h
@@ -0,0 +1,493 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * PixelEncoder.cpp
+ * Converts runs of RGB DMX slots to the wire format of the pixel chips.
+ * Copyright (C) 2026 Simon Newton
+ *
+ * The SIMD kernels load a block of input pixels, move each colour into place
+ * with a single shuffle (or an interleaved load / store on ARM) and then
+ * apply the chip specific bits to the whole block. The pixels that don't fill
+ * a block are handled by the scalar code.
+ */
+
+#include <math.h>
+#include <string.h>
+#include <string>
+
+#include "ola/StringUtils.h"
+#include "plugins/spi/PixelEncoder.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define OLA_PIXEL_ENCODER_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define OLA_PIXEL_ENCODER_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace ola {
+namespace plugin {
+namespace spi {
+
+using std::string;
+
+namespace {
+
+enum {
+  RED,
+  GREEN,
+  BLUE
+};
+
+typedef void (*EncodeFunction)(const uint8_t *input,
+                               unsigned int pixels,
+                               uint8_t *output,
+                               const uint8_t *order,
+                               const uint8_t *table);
+
+struct Encoders {
+  EncodeFunction ws2801;
+  EncodeFunction lpd8806;
+  EncodeFunction p9813;
+  EncodeFunction apa102;
+};
+
+const char *const COLOR_ORDER_NAMES[] = {
+  "RGB", "RBG", "GRB", "GBR", "BRG", "BGR"
+};
+
+// The offset of red, green and blue in the input, for each ColorOrder.
+const uint8_t COLOR_ORDER_OFFSETS[][3] = {
+  {0, 1, 2},  // RGB
+  {0, 2, 1},  // RBG
+  {1, 0, 2},  // GRB
+  {2, 0, 1},  // GBR
+  {1, 2, 0},  // BRG
+  {2, 1, 0},  // BGR
+};
+
+/**
+ * For more information please visit:
+ * https://github.com/CoolNeon/elinux-tcl/blob/master/README.txt
+ */
+inline uint8_t P9813Flag(uint8_t red, uint8_t green, uint8_t blue) {
+  uint8_t flag = (red & 0xc0) >> 6;
+  flag |= (green & 0xc0) >> 4;
+  flag |= (blue & 0xc0) >> 2;
+  return ~flag;
+}
+
+void ScalarWS2801(const uint8_t *input, unsigned int pixels, uint8_t *output,
+                  const uint8_t *order, const uint8_t *table) {
+  for (unsigned int i = 0; i < pixels; i++, input += 3, output += 3) {
+    output[0] = table[input[order[RED]]];
+    output[1] = table[input[order[GREEN]]];
+    output[2] = table[input[order[BLUE]]];
+  }
+}
+
+void ScalarLPD8806(const uint8_t *input, unsigned int pixels, uint8_t *output,
+                   const uint8_t *order, const uint8_t *table) {
+  for (unsigned int i = 0; i < pixels; i++, input += 3, output += 3) {
+    output[0] = 0x80 | (table[input[order[GREEN]]] >> 1);
+    output[1] = 0x80 | (table[input[order[RED]]] >> 1);
+    output[2] = 0x80 | (table[input[order[BLUE]]] >> 1);
+  }
+}
+
+void ScalarP9813(const uint8_t *input, unsigned int pixels, uint8_t *output,
+                 const uint8_t *order, const uint8_t *table) {
+  for (unsigned int i = 0; i < pixels; i++, input += 3, output += 4) {
+    uint8_t red = table[input[order[RED]]];
+    uint8_t green = table[input[order[GREEN]]];
+    uint8_t blue = table[input[order[BLUE]]];
+    output[0] = P9813Flag(red, green, blue);
+    output[1] = blue;
+    output[2] = green;
+    output[3] = red;
+  }
+}
+
+void ScalarAPA102(const uint8_t *input, unsigned int pixels, uint8_t *output,
+                  const uint8_t *order, const uint8_t *table) {
+  for (unsigned int i = 0; i < pixels; i++, input += 3, output += 4) {
+    // 3 bits start mark (111) + 5 bits global brightness, which is fixed at
+    // 31 to reduce flickering.
+    output[0] = 0xFF;
+    output[1] = table[input[order[BLUE]]];
+    output[2] = table[input[order[GREEN]]];
+    output[3] = table[input[order[RED]]];
+  }
+}
+
+#ifdef OLA_PIXEL_ENCODER_X86
+/*
+ * The x86 kernels load 16 bytes, which is 5 1/3 pixels, so they stop while at
+ * least 6 pixels remain to stay within the input. The 3 byte per pixel
+ * formats convert 5 pixels per block and the 4 byte formats convert 4.
+ *
+ * A shuffle index with the high bit set produces a zero byte.
+ */
+const unsigned int SSSE3_MIN_PIXELS = 6;
+
+void BuildShuffle3(const uint8_t *order, unsigned int first,
+                   unsigned int second, unsigned int third, uint8_t *mask) {
+  for (unsigned int i = 0; i < 5; i++) {
+    mask[i * 3] = i * 3 + order[first];
+    mask[i * 3 + 1] = i * 3 + order[second];
+    mask[i * 3 + 2] = i * 3 + order[third];
+  }
+  mask[15] = 0x80;
+}
+
+void BuildShuffle4(const uint8_t *order, uint8_t *mask) {
+  for (unsigned int i = 0; i < 4; i++) {
+    mask[i * 4] = 0x80;
+    mask[i * 4 + 1] = i * 3 + order[BLUE];
+    mask[i * 4 + 2] = i * 3 + order[GREEN];
+    mask[i * 4 + 3] = i * 3 + order[RED];
+  }
+}
+
+__attribute__((target("ssse3")))
+void SSSE3WS2801(const uint8_t *input, unsigned int pixels, uint8_t *output,
+                 const uint8_t *order, const uint8_t *table) {
+  uint8_t mask_bytes[16];
+  BuildShuffle3(order, RED, GREEN, BLUE, mask_bytes);
+  const __m128i mask = _mm_loadu_si128(
+      reinterpret_cast<const __m128i*>(mask_bytes));
+
+  unsigned int i = 0;
+  for (; i + SSSE3_MIN_PIXELS <= pixels; i += 5) {
+    __m128i data = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(input + i * 3));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i * 3),
+                     _mm_shuffle_epi8(data, mask));
+  }
+  ScalarWS2801(input + i * 3, pixels - i, output + i * 3, order, table);
+}
+
+__attribute__((target("ssse3")))
+void SSSE3LPD8806(const uint8_t *input, unsigned int pixels, uint8_t *output,
+                  const uint8_t *order, const uint8_t *table) {
+  uint8_t mask_bytes[16];
+  BuildShuffle3(order, GREEN, RED, BLUE, mask_bytes);
+  const __m128i mask = _mm_loadu_si128(
+      reinterpret_cast<const __m128i*>(mask_bytes));
+  const __m128i high_bit = _mm_set1_epi8(static_cast<char>(0x80));
+
+  unsigned int i = 0;
+  for (; i + SSSE3_MIN_PIXELS <= pixels; i += 5) {
+    __m128i data = _mm_shuffle_epi8(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i * 3)),
+        mask);
+    // The bit shifted in from the neighbouring byte is replaced by the high
+    // bit.
+    data = _mm_or_si128(_mm_srli_epi16(data, 1), high_bit);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i * 3), data);
+  }
+  ScalarLPD8806(input + i * 3, pixels - i, output + i * 3, order, table);
+}
+
+__attribute__((target("ssse3")))
+void SSSE3P9813(const uint8_t *input, unsigned int pixels, uint8_t *output,
+                const uint8_t *order, const uint8_t *table) {
+  uint8_t mask_bytes[16];
+  BuildShuffle4(order, mask_bytes);
+  const __m128i mask = _mm_loadu_si128(
+      reinterpret_cast<const __m128i*>(mask_bytes));
+  const __m128i top_bits = _mm_set1_epi32(static_cast<int>(0xc0c0c000));
+  const __m128i flag_bits = _mm_set1_epi32(0x3f);
+  const __m128i flag_byte = _mm_set1_epi32(0xff);
+
+  unsigned int i = 0;
+  for (; i + SSSE3_MIN_PIXELS <= pixels; i += 4) {
+    __m128i data = _mm_shuffle_epi8(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i * 3)),
+        mask);
+    // Each 32 bit lane is R << 24 | G << 16 | B << 8. Move the top two bits
+    // of each colour down to form the flag, and invert it.
+    __m128i top = _mm_and_si128(data, top_bits);
+    __m128i flag = _mm_or_si128(
+        _mm_srli_epi32(top, 30),
+        _mm_or_si128(_mm_srli_epi32(top, 20), _mm_srli_epi32(top, 10)));
+    flag = _mm_xor_si128(_mm_and_si128(flag, flag_bits), flag_byte);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i * 4),
+                     _mm_or_si128(data, flag));
+  }
+  ScalarP9813(input + i * 3, pixels - i, output + i * 4, order, table);
+}
+
+__attribute__((target("ssse3")))
+void SSSE3APA102(const uint8_t *input, unsigned int pixels, uint8_t *output,
+                 const uint8_t *order, const uint8_t *table) {
+  uint8_t mask_bytes[16];
+  BuildShuffle4(order, mask_bytes);
+  const __m128i mask = _mm_loadu_si128(
+      reinterpret_cast<const __m128i*>(mask_bytes));
+  const __m128i header = _mm_set1_epi32(0xff);
+
+  unsigned int i = 0;
+  for (; i + SSSE3_MIN_PIXELS <= pixels; i += 4) {
+    __m128i data = _mm_shuffle_epi8(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i * 3)),
+        mask);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i * 4),
+                     _mm_or_si128(data, header));
+  }
+  ScalarAPA102(input + i * 3, pixels - i, output + i * 4, order, table);
+}
+#endif  // OLA_PIXEL_ENCODER_X86
+
+#ifdef OLA_PIXEL_ENCODER_NEON
+/*
+ * The NEON kernels de-interleave 16 pixels into one register per colour, and
+ * interleave them again on the store.
+ */
+const unsigned int NEON_PIXELS = 16;
+
+void NEONWS2801(const uint8_t *input, unsigned int pixels, uint8_t *output,
+                const uint8_t *order, const uint8_t *table) {
+  unsigned int i = 0;
+  for (; i + NEON_PIXELS <= pixels; i += NEON_PIXELS) {
+    uint8x16x3_t data = vld3q_u8(input + i * 3);
+    uint8x16x3_t out;
+    out.val[0] = data.val[order[RED]];
+    out.val[1] = data.val[order[GREEN]];
+    out.val[2] = data.val[order[BLUE]];
+    vst3q_u8(output + i * 3, out);
+  }
+  ScalarWS2801(input + i * 3, pixels - i, output + i * 3, order, table);
+}
+
+void NEONLPD8806(const uint8_t *input, unsigned int pixels, uint8_t *output,
+                 const uint8_t *order, const uint8_t *table) {
+  const uint8x16_t high_bit = vdupq_n_u8(0x80);
+  unsigned int i = 0;
+  for (; i + NEON_PIXELS <= pixels; i += NEON_PIXELS) {
+    uint8x16x3_t data = vld3q_u8(input + i * 3);
+    uint8x16x3_t out;
+    out.val[0] = vorrq_u8(vshrq_n_u8(data.val[order[GREEN]], 1), high_bit);
+    out.val[1] = vorrq_u8(vshrq_n_u8(data.val[order[RED]], 1), high_bit);
+    out.val[2] = vorrq_u8(vshrq_n_u8(data.val[order[BLUE]], 1), high_bit);
+    vst3q_u8(output + i * 3, out);
+  }
+  ScalarLPD8806(input + i * 3, pixels - i, output + i * 3, order, table);
+}
+
+void NEONP9813(const uint8_t *input, unsigned int pixels, uint8_t *output,
+               const uint8_t *order, const uint8_t *table) {
+  unsigned int i = 0;
+  for (; i + NEON_PIXELS <= pixels; i += NEON_PIXELS) {
+    uint8x16x3_t data = vld3q_u8(input + i * 3);
+    uint8x16x4_t out;
+    out.val[1] = data.val[order[BLUE]];
+    out.val[2] = data.val[order[GREEN]];
+    out.val[3] = data.val[order[RED]];
+    uint8x16_t flag = vshrq_n_u8(out.val[3], 6);
+    flag = vorrq_u8(flag, vshlq_n_u8(vshrq_n_u8(out.val[2], 6), 2));
+    flag = vorrq_u8(flag, vshlq_n_u8(vshrq_n_u8(out.val[1], 6), 4));
+    out.val[0] = vmvnq_u8(flag);
+    vst4q_u8(output + i * 4, out);
+  }
+  ScalarP9813(input + i * 3, pixels - i, output + i * 4, order, table);
+}
+
+void NEONAPA102(const uint8_t *input, unsigned int pixels, uint8_t *output,
+                const uint8_t *order, const uint8_t *table) {
+  unsigned int i = 0;
+  for (; i + NEON_PIXELS <= pixels; i += NEON_PIXELS) {
+    uint8x16x3_t data = vld3q_u8(input + i * 3);
+    uint8x16x4_t out;
+    out.val[0] = vdupq_n_u8(0xff);
+    out.val[1] = data.val[order[BLUE]];
+    out.val[2] = data.val[order[GREEN]];
+    out.val[3] = data.val[order[RED]];
+    vst4q_u8(output + i * 4, out);
+  }
+  ScalarAPA102(input + i * 3, pixels - i, output + i * 4, order, table);
+}
+#endif  // OLA_PIXEL_ENCODER_NEON
+
+const Encoders SCALAR_ENCODERS = {
+  ScalarWS2801, ScalarLPD8806, ScalarP9813, ScalarAPA102
+};
+
+#ifdef OLA_PIXEL_ENCODER_X86
+const Encoders SSSE3_ENCODERS = {
+  SSSE3WS2801, SSSE3LPD8806, SSSE3P9813, SSSE3APA102
+};
+#endif  // OLA_PIXEL_ENCODER_X86
+
+#ifdef OLA_PIXEL_ENCODER_NEON
+const Encoders NEON_ENCODERS = {
+  NEONWS2801, NEONLPD8806, NEONP9813, NEONAPA102
+};
+#endif  // OLA_PIXEL_ENCODER_NEON
+
+const Encoders &KernelEncoders(PixelKernel kernel) {
+  switch (kernel) {
+#ifdef OLA_PIXEL_ENCODER_X86
+    case PIXEL_KERNEL_SSSE3:
+      return SSSE3_ENCODERS;
+#endif  // OLA_PIXEL_ENCODER_X86
+#ifdef OLA_PIXEL_ENCODER_NEON
+    case PIXEL_KERNEL_NEON:
+      return NEON_ENCODERS;
+#endif  // OLA_PIXEL_ENCODER_NEON
+    default:
+      return SCALAR_ENCODERS;
+  }
+}
+
+/*
+ * The NEON kernels haven't been run on ARM yet, so they aren't selected
+ * automatically. They can still be chosen with SetKernel(), which lets
+ * PixelEncoderTest and the benchmark exercise them.
+ */
+PixelKernel SelectKernel() {
+  const PixelKernel preferred[] = {
+    PIXEL_KERNEL_SSSE3
+  };
+  for (unsigned int i = 0; i < sizeof(preferred) / sizeof(preferred[0]);
+       i++) {
+    if (PixelKernelSupported(preferred[i])) {
+      return preferred[i];
+    }
+  }
+  return PIXEL_KERNEL_SCALAR;
+}
+}  // namespace
+
+
+PixelEncoder::PixelEncoder(const Options &options)
+    : m_options(options),
+      m_kernel(ActivePixelKernel()) {
+  memcpy(m_order, COLOR_ORDER_OFFSETS[options.color_order], sizeof(m_order));
+
+  uint8_t gamma = options.gamma;
+  if (gamma == 0) {
+    gamma = 1;
+  } else if (gamma > MAX_GAMMA) {
+    gamma = MAX_GAMMA;
+  }
+  m_linear = (options.brightness == MAX_BRIGHTNESS && gamma == LINEAR_GAMMA);
+  for (unsigned int i = 0; i < sizeof(m_table); i++) {
+    if (m_linear) {
+      m_table[i] = i;
+    } else {
+      double value = pow(i / 255.0, gamma / 10.0) * options.brightness;
+      m_table[i] = static_cast<uint8_t>(value + 0.5);
+    }
+  }
+}
+
+bool PixelEncoder::SetKernel(PixelKernel kernel) {
+  if (!PixelKernelSupported(kernel)) {
+    return false;
+  }
+  m_kernel = kernel;
+  return true;
+}
+
+PixelKernel PixelEncoder::Kernel() const {
+  return m_linear ? m_kernel : PIXEL_KERNEL_SCALAR;
+}
+
+void PixelEncoder::WS2801(const uint8_t *input, unsigned int pixels,
+                          uint8_t *output) const {
+  if (m_linear && m_options.color_order == RGB) {
+    memcpy(output, input, pixels * 3);
+    return;
+  }
+  KernelEncoders(Kernel()).ws2801(input, pixels, output, m_order, m_table);
+}
+
+void PixelEncoder::LPD8806(const uint8_t *input, unsigned int pixels,
+                           uint8_t *output) const {
+  KernelEncoders(Kernel()).lpd8806(input, pixels, output, m_order, m_table);
+}
+
+void PixelEncoder::P9813(const uint8_t *input, unsigned int pixels,
+                         uint8_t *output) const {
+  KernelEncoders(Kernel()).p9813(input, pixels, output, m_order, m_table);
+}
+
+void PixelEncoder::APA102(const uint8_t *input, unsigned int pixels,
+                          uint8_t *output) const {
+  KernelEncoders(Kernel()).apa102(input, pixels, output, m_order, m_table);
+}
+
+bool PixelEncoder::ColorOrderFromString(const string &value,
+                                        ColorOrder *color_order) {
+  string order = value;
+  ola::ToUpper(&order);
+  for (unsigned int i = 0;
+       i < sizeof(COLOR_ORDER_NAMES) / sizeof(COLOR_ORDER_NAMES[0]); i++) {
+    if (order == COLOR_ORDER_NAMES[i]) {
+      *color_order = static_cast<ColorOrder>(i);
+      return true;
+    }
+  }
+  return false;
+}
+
+string PixelEncoder::ColorOrderToString(ColorOrder color_order) {
+  return COLOR_ORDER_NAMES[color_order];
+}
+
+
+bool PixelKernelSupported(PixelKernel kernel) {
+  switch (kernel) {
+    case PIXEL_KERNEL_SCALAR:
+      return true;
+#ifdef OLA_PIXEL_ENCODER_X86
+    case PIXEL_KERNEL_SSSE3:
+      return __builtin_cpu_supports("ssse3");
+#endif  // OLA_PIXEL_ENCODER_X86
+#ifdef OLA_PIXEL_ENCODER_NEON
+    case PIXEL_KERNEL_NEON:
+      return true;
+#endif  // OLA_PIXEL_ENCODER_NEON
+    default:
+      return false;
+  }
+}
+
+
+PixelKernel ActivePixelKernel() {
+  static const PixelKernel kernel = SelectKernel();
+  return kernel;
+}
+
+
+const char *PixelKernelName(PixelKernel kernel) {
+  switch (kernel) {
+    case PIXEL_KERNEL_SCALAR:
+      return "scalar";
+    case PIXEL_KERNEL_SSSE3:
+      return "ssse3";
+    case PIXEL_KERNEL_NEON:
+      return "neon";
+    default:
+      return "unknown";
+  }
+}
+}  // namespace spi
+}  // namespace plugin
+}  // namespace ola
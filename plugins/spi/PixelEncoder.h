@@ -0,0 +1,145 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * PixelEncoder.h
+ * Converts runs of RGB DMX slots to the wire format of the pixel chips.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef PLUGINS_SPI_PIXELENCODER_H_
+#define PLUGINS_SPI_PIXELENCODER_H_
+
+#include <stdint.h>
+#include <string>
+
+namespace ola {
+namespace plugin {
+namespace spi {
+
+/**
+ * The implementations of the encoders.
+ */
+typedef enum {
+  PIXEL_KERNEL_SCALAR,  // Portable C++, with the colour table
+  PIXEL_KERNEL_SSSE3,  // x86 byte shuffles
+  PIXEL_KERNEL_NEON  // ARM interleaved loads and stores
+} PixelKernel;
+
+/**
+ * Encodes pixel data for the SPI chips.
+ *
+ * The input is 3 slots per pixel, the output is the pixel data for the chip,
+ * without any start or end frame. Each method encodes the whole run in a
+ * single pass over raw pointers, the caller must ensure there are pixels * 3
+ * bytes of input and enough space for the output.
+ *
+ * If brightness and gamma are left at the defaults, the SIMD kernels are
+ * used when the CPU supports them. Otherwise each colour is passed through a
+ * 256 entry table which combines the gamma correction and brightness.
+ */
+class PixelEncoder {
+ public:
+  /**
+   * The order of the colours within each pixel of the DMX data.
+   */
+  enum ColorOrder {
+    RGB,
+    RBG,
+    GRB,
+    GBR,
+    BRG,
+    BGR
+  };
+
+  struct Options {
+    ColorOrder color_order;
+    uint8_t brightness;  // 0 - 255, scales each colour
+    uint8_t gamma;  // in tenths, 10 is linear
+
+    Options()
+        : color_order(RGB),
+          brightness(MAX_BRIGHTNESS),
+          gamma(LINEAR_GAMMA) {
+    }
+  };
+
+  explicit PixelEncoder(const Options &options = Options());
+
+  const Options &GetOptions() const { return m_options; }
+
+  /**
+   * Select the kernel to use, this is used by the tests and benchmarks.
+   * @returns false if the kernel isn't supported on this CPU.
+   */
+  bool SetKernel(PixelKernel kernel);
+
+  /**
+   * The kernel that will be used, this is always PIXEL_KERNEL_SCALAR if
+   * the colour table is in use.
+   */
+  PixelKernel Kernel() const;
+
+  // 3 bytes per pixel, R, G, B
+  void WS2801(const uint8_t *input, unsigned int pixels,
+              uint8_t *output) const;
+  // 3 bytes per pixel, 0x80 | G >> 1, 0x80 | R >> 1, 0x80 | B >> 1
+  void LPD8806(const uint8_t *input, unsigned int pixels,
+               uint8_t *output) const;
+  // 4 bytes per pixel, flag, B, G, R
+  void P9813(const uint8_t *input, unsigned int pixels,
+             uint8_t *output) const;
+  // 4 bytes per pixel, 0xFF, B, G, R
+  void APA102(const uint8_t *input, unsigned int pixels,
+              uint8_t *output) const;
+
+  static bool ColorOrderFromString(const std::string &value,
+                                   ColorOrder *color_order);
+  static std::string ColorOrderToString(ColorOrder color_order);
+
+  static const unsigned int SLOTS_PER_PIXEL = 3;
+  static const uint8_t MAX_BRIGHTNESS = 255;
+  static const uint8_t LINEAR_GAMMA = 10;
+  static const uint8_t MAX_GAMMA = 40;
+
+ private:
+  const Options m_options;
+  PixelKernel m_kernel;
+  bool m_linear;
+  // The offset of red, green and blue within each input pixel.
+  uint8_t m_order[3];
+  uint8_t m_table[256];
+};
+
+/**
+ * @brief Check if a kernel can run on this CPU.
+ */
+bool PixelKernelSupported(PixelKernel kernel);
+
+/**
+ * @brief Return the kernel used by default on this CPU.
+ *
+ * This is the fastest supported kernel, except NEON which is only used if
+ * it's set with PixelEncoder::SetKernel().
+ */
+PixelKernel ActivePixelKernel();
+
+/**
+ * @brief Return the name of a kernel.
+ */
+const char *PixelKernelName(PixelKernel kernel);
+}  // namespace spi
+}  // namespace plugin
+}  // namespace ola
+#endif  // PLUGINS_SPI_PIXELENCODER_H_
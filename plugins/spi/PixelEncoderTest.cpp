@@ -0,0 +1,193 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * PixelEncoderTest.cpp
+ * Test fixture for the PixelEncoder class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <string.h>
+
+#include "ola/base/Array.h"
+#include "ola/testing/TestUtils.h"
+#include "plugins/spi/PixelEncoder.h"
+
+using ola::plugin::spi::PixelEncoder;
+using ola::plugin::spi::PixelKernel;
+using ola::plugin::spi::PixelKernelSupported;
+
+class PixelEncoderTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(PixelEncoderTest);
+  CPPUNIT_TEST(testEncode);
+  CPPUNIT_TEST(testColorOrder);
+  CPPUNIT_TEST(testColorTable);
+  CPPUNIT_TEST(testKernelsAgree);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    void testEncode();
+    void testColorOrder();
+    void testColorTable();
+    void testKernelsAgree();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(PixelEncoderTest);
+
+
+/*
+ * Check the output format for each chip.
+ */
+void PixelEncoderTest::testEncode() {
+  PixelEncoder encoder;
+  const uint8_t input[] = {1, 10, 100, 255, 128, 0};
+  uint8_t output[8];
+
+  encoder.WS2801(input, 2, output);
+  OLA_ASSERT_DATA_EQUALS(input, arraysize(input), output, 6);
+
+  const uint8_t LPD8806[] = {0x85, 0x80, 0xB2, 0xC0, 0xFF, 0x80};
+  encoder.LPD8806(input, 2, output);
+  OLA_ASSERT_DATA_EQUALS(LPD8806, arraysize(LPD8806), output, 6);
+
+  const uint8_t P9813[] = {0xEF, 0x64, 0x0A, 0x01, 0xF4, 0, 0x80, 0xFF};
+  encoder.P9813(input, 2, output);
+  OLA_ASSERT_DATA_EQUALS(P9813, arraysize(P9813), output, 8);
+
+  const uint8_t APA102[] = {0xFF, 0x64, 0x0A, 0x01, 0xFF, 0, 0x80, 0xFF};
+  encoder.APA102(input, 2, output);
+  OLA_ASSERT_DATA_EQUALS(APA102, arraysize(APA102), output, 8);
+}
+
+
+/*
+ * Check the colours are picked from the right slots.
+ */
+void PixelEncoderTest::testColorOrder() {
+  PixelEncoder::Options options;
+  options.color_order = PixelEncoder::GRB;
+  PixelEncoder encoder(options);
+  const uint8_t input[] = {1, 2, 3};  // green, red, blue
+  uint8_t output[4];
+
+  const uint8_t WS2801[] = {2, 1, 3};
+  encoder.WS2801(input, 1, output);
+  OLA_ASSERT_DATA_EQUALS(WS2801, arraysize(WS2801), output, 3);
+
+  const uint8_t APA102[] = {0xFF, 3, 1, 2};
+  encoder.APA102(input, 1, output);
+  OLA_ASSERT_DATA_EQUALS(APA102, arraysize(APA102), output, 4);
+
+  PixelEncoder::ColorOrder order;
+  OLA_ASSERT_TRUE(PixelEncoder::ColorOrderFromString("bgr", &order));
+  OLA_ASSERT_EQ(PixelEncoder::BGR, order);
+  OLA_ASSERT_EQ(std::string("BGR"), PixelEncoder::ColorOrderToString(order));
+  OLA_ASSERT_FALSE(PixelEncoder::ColorOrderFromString("RGBW", &order));
+}
+
+
+/*
+ * Check brightness and gamma.
+ */
+void PixelEncoderTest::testColorTable() {
+  const uint8_t input[] = {0, 128, 255};
+  uint8_t output[3];
+
+  PixelEncoder::Options options;
+  options.brightness = 128;
+  PixelEncoder dimmed(options);
+  OLA_ASSERT_EQ(ola::plugin::spi::PIXEL_KERNEL_SCALAR, dimmed.Kernel());
+  const uint8_t DIMMED[] = {0, 64, 128};
+  dimmed.WS2801(input, 1, output);
+  OLA_ASSERT_DATA_EQUALS(DIMMED, arraysize(DIMMED), output, 3);
+
+  options.brightness = 255;
+  options.gamma = 22;
+  PixelEncoder corrected(options);
+  const uint8_t CORRECTED[] = {0, 56, 255};
+  corrected.WS2801(input, 1, output);
+  OLA_ASSERT_DATA_EQUALS(CORRECTED, arraysize(CORRECTED), output, 3);
+}
+
+
+/*
+ * Check that every kernel supported on this host produces the same result as
+ * the scalar kernel, for each colour order and for lengths that exercise the
+ * tail handling. The bytes after the output must not be touched.
+ */
+void PixelEncoderTest::testKernelsAgree() {
+  const PixelKernel kernels[] = {
+    ola::plugin::spi::PIXEL_KERNEL_SSSE3,
+    ola::plugin::spi::PIXEL_KERNEL_NEON,
+  };
+  const unsigned int MAX_PIXELS = 170;
+  const uint8_t GUARD = 0x5a;
+
+  uint8_t input[MAX_PIXELS * 3];
+  unsigned int seed = 42;
+  for (unsigned int i = 0; i < sizeof(input); i++) {
+    seed = seed * 1103515245 + 12345;
+    input[i] = (seed >> 16) & 0xff;
+  }
+
+  uint8_t expected[MAX_PIXELS * 4 + 1];
+  uint8_t output[MAX_PIXELS * 4 + 1];
+  for (unsigned int k = 0; k < arraysize(kernels); k++) {
+    if (!PixelKernelSupported(kernels[k])) {
+      continue;
+    }
+    for (unsigned int order = PixelEncoder::RGB; order <= PixelEncoder::BGR;
+         order++) {
+      PixelEncoder::Options options;
+      options.color_order = static_cast<PixelEncoder::ColorOrder>(order);
+      PixelEncoder scalar(options);
+      scalar.SetKernel(ola::plugin::spi::PIXEL_KERNEL_SCALAR);
+      PixelEncoder encoder(options);
+      OLA_ASSERT_TRUE(encoder.SetKernel(kernels[k]));
+
+      for (unsigned int pixels = 0; pixels <= MAX_PIXELS; pixels++) {
+        // Copy the input so reads past the end show up under a memory
+        // checker.
+        uint8_t *data = new uint8_t[pixels * 3 + 1];
+        memcpy(data, input, pixels * 3);
+
+        memset(output, GUARD, sizeof(output));
+        scalar.LPD8806(data, pixels, expected);
+        encoder.LPD8806(data, pixels, output);
+        OLA_ASSERT_DATA_EQUALS(expected, pixels * 3, output, pixels * 3);
+        OLA_ASSERT_EQ(GUARD, output[pixels * 3]);
+
+        memset(output, GUARD, sizeof(output));
+        scalar.WS2801(data, pixels, expected);
+        encoder.WS2801(data, pixels, output);
+        OLA_ASSERT_DATA_EQUALS(expected, pixels * 3, output, pixels * 3);
+        OLA_ASSERT_EQ(GUARD, output[pixels * 3]);
+
+        memset(output, GUARD, sizeof(output));
+        scalar.P9813(data, pixels, expected);
+        encoder.P9813(data, pixels, output);
+        OLA_ASSERT_DATA_EQUALS(expected, pixels * 4, output, pixels * 4);
+        OLA_ASSERT_EQ(GUARD, output[pixels * 4]);
+
+        memset(output, GUARD, sizeof(output));
+        scalar.APA102(data, pixels, expected);
+        encoder.APA102(data, pixels, output);
+        OLA_ASSERT_DATA_EQUALS(expected, pixels * 4, output, pixels * 4);
+        OLA_ASSERT_EQ(GUARD, output[pixels * 4]);
+        delete[] data;
+      }
+    }
+  }
+}
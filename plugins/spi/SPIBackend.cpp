@@ -26,12 +26,14 @@
 #include <string.h>
 #include <sys/ioctl.h>
 
+#include <algorithm>
 #include <numeric>
 #include <sstream>
 #include <string>
 #include <vector>
 
 #include "ola/Logging.h"
+#include "ola/base/Array.h"
 #include "ola/io/IOUtils.h"
 #include "ola/network/SocketCloser.h"
 #include "ola/stl/STLUtils.h"
@@ -48,65 +50,110 @@ using std::vector;
 const char SPIBackendInterface::SPI_DROP_VAR[] = "spi-drops";
 const char SPIBackendInterface::SPI_DROP_VAR_KEY[] = "device";
 
-uint8_t *HardwareBackend::OutputData::Resize(unsigned int length) {
-  if (length < m_size) {
-    m_size = length;
-    return m_data;
-  } else if (length == m_size) {
-    return m_data;
+FrameExchange::FrameExchange()
+    : m_back(0),
+      m_last_published(0),
+      m_back_stale(false),
+      m_front(2),
+      m_middle(1) {
+  for (unsigned int i = 0; i < arraysize(m_buffers); i++) {
+    m_buffers[i].data = NULL;
+    m_buffers[i].size = 0;
+    m_buffers[i].capacity = 0;
   }
+}
 
-  if (length <= m_actual_size) {
-    m_size = length;
-    return m_data;
+FrameExchange::~FrameExchange() {
+  for (unsigned int i = 0; i < arraysize(m_buffers); i++) {
+    delete[] m_buffers[i].data;
   }
+}
 
-  delete[] m_data;
-  m_data = new uint8_t[length];
-  if (m_data) {
-    m_size = m_data ? length : 0;
-    m_actual_size = m_size;
-    memset(m_data, 0, length);
+uint8_t *FrameExchange::Checkout() {
+  if (m_back_stale) {
+    // The last published frame is either in the middle or front buffer, the
+    // consumer only reads from it so we can take a copy.
+    const Buffer &last = m_buffers[m_last_published];
+    m_buffers[m_back].size = 0;
+    uint8_t *data = Resize(last.size);
+    if (last.size) {
+      memcpy(data, last.data, last.size);
+    }
+    m_back_stale = false;
   }
-  return m_data;
+  return m_buffers[m_back].data;
 }
 
-void HardwareBackend::OutputData::SetPending() {
-  m_write_pending = true;
+uint8_t *FrameExchange::Resize(unsigned int size) {
+  Buffer *buffer = &m_buffers[m_back];
+  if (size > buffer->capacity) {
+    uint8_t *data = new uint8_t[size];
+    if (buffer->size) {
+      memcpy(data, buffer->data, buffer->size);
+    }
+    delete[] buffer->data;
+    buffer->data = data;
+    buffer->capacity = size;
+  }
+  if (size > buffer->size) {
+    memset(buffer->data + buffer->size, 0, size - buffer->size);
+  }
+  buffer->size = size;
+  return buffer->data;
 }
 
-void HardwareBackend::OutputData::SetLatchBytes(unsigned int latch_bytes) {
-  m_latch_bytes = latch_bytes;
+bool FrameExchange::Publish() {
+  uint32_t previous = Exchange(m_back | FRESH);
+  m_last_published = m_back;
+  m_back = previous & INDEX_MASK;
+  m_back_stale = true;
+  return previous & FRESH;
 }
 
-HardwareBackend::OutputData& HardwareBackend::OutputData::operator=(
-    const HardwareBackend::OutputData &other) {
-  if (this != &other) {
-    uint8_t *data = Resize(other.m_size + other.m_latch_bytes);
-    if (data) {
-      memcpy(data, other.m_data, other.m_size);
-      memset(data + other.m_size, 0, other.m_latch_bytes);
-      m_write_pending = true;
-    } else {
-      m_write_pending = false;
+bool FrameExchange::HasFrame() const {
+  return *static_cast<const volatile uint32_t*>(&m_middle) & FRESH;
+}
+
+bool FrameExchange::Acquire() {
+  if (!HasFrame()) {
+    return false;
+  }
+  m_front = Exchange(m_front) & INDEX_MASK;
+  return true;
+}
+
+/*
+ * Swap the middle buffer, the compare and swap is a full barrier so the
+ * contents of the buffer are visible to the other side.
+ */
+uint32_t FrameExchange::Exchange(uint32_t value) {
+  uint32_t current = *static_cast<volatile uint32_t*>(&m_middle);
+  while (true) {
+    uint32_t previous = __sync_val_compare_and_swap(&m_middle, current,
+                                                    value);
+    if (previous == current) {
+      return previous;
     }
+    current = previous;
   }
-  return *this;
 }
 
 HardwareBackend::HardwareBackend(const Options &options,
                                  SPIWriterInterface *writer,
                                  ExportMap *export_map)
     : m_spi_writer(writer),
-      m_drop_map(NULL),
+      m_drop_count(NULL),
       m_output_count(1 << options.gpio_pins.size()),
+      m_writer_waiting(0),
       m_exit(false),
       m_gpio_pins(options.gpio_pins) {
-  SetupOutputs(&m_output_data);
+  for (unsigned int i = 0; i < m_output_count; i++) {
+    m_output_data.push_back(new FrameExchange());
+  }
   if (export_map) {
-    m_drop_map = export_map->GetUIntMapVar(SPI_DROP_VAR,
-                                           SPI_DROP_VAR_KEY);
-    (*m_drop_map)[m_spi_writer->DevicePath()] = 0;
+    m_drop_count = export_map->GetUIntMapVar(
+        SPI_DROP_VAR, SPI_DROP_VAR_KEY)->Handle(m_spi_writer->DevicePath());
+    *m_drop_count = 0;
   }
 }
 
@@ -143,15 +190,11 @@ uint8_t *HardwareBackend::Checkout(uint8_t output_id,
     return NULL;
   }
 
-  m_mutex.Lock();
-  uint8_t *output = m_output_data[output_id]->Resize(length);
-  if (!output) {
-    m_mutex.Unlock();
-  }
-  m_output_data[output_id]->SetLatchBytes(latch_bytes);
-  // We return with the Mutex locked, the caller must then call Commit()
-  // coverity[LOCK]
-  return output;
+  FrameExchange *output = m_output_data[output_id];
+  output->Checkout();
+  uint8_t *data = output->Resize(length + latch_bytes);
+  memset(data + length, 0, latch_bytes);
+  return data;
 }
 
 void HardwareBackend::Commit(uint8_t output) {
@@ -159,72 +202,58 @@ void HardwareBackend::Commit(uint8_t output) {
     return;
   }
 
-  OutputData *output_data = m_output_data[output];
-  if (output_data->IsPending() && m_drop_map) {
+  if (m_output_data[output]->Publish() && m_drop_count) {
     // There was already another write pending which we're now stomping on
-    (*m_drop_map)[m_spi_writer->DevicePath()]++;
+    (*m_drop_count)++;
+  }
+
+  // Pairs with the barrier in Run(), either we see the writer is waiting, or
+  // it sees the frame we just published.
+  __sync_synchronize();
+  if (m_writer_waiting) {
+    MutexLocker lock(&m_mutex);
+    m_cond_var.Signal();
   }
-  output_data->SetPending();
-  m_mutex.Unlock();
-  m_cond_var.Signal();
 }
 
 void *HardwareBackend::Run() {
-  Outputs outputs;
-  SetupOutputs(&outputs);
-
   while (true) {
-    m_mutex.Lock();
-
-    if (m_exit) {
-      m_mutex.Unlock();
-      STLDeleteElements(&outputs);
-      return NULL;
-    }
-
-    bool action_pending = false;
-    Outputs::const_iterator iter = m_output_data.begin();
-    for (; iter != m_output_data.end(); ++iter) {
-      if ((*iter)->IsPending()) {
-        action_pending = true;
-        break;
+    bool wrote = false;
+    for (unsigned int i = 0; i < m_output_data.size(); i++) {
+      if (m_output_data[i]->Acquire()) {
+        WriteOutput(i, m_output_data[i]);
+        wrote = true;
       }
     }
-    if (!action_pending) {
-      m_cond_var.Wait(&m_mutex);
+    if (wrote) {
+      continue;
     }
 
+    MutexLocker lock(&m_mutex);
     if (m_exit) {
-      m_mutex.Unlock();
-      STLDeleteElements(&outputs);
       return NULL;
     }
-
-    for (unsigned int i = 0; i < m_output_data.size(); i++) {
-      if (m_output_data[i]->IsPending()) {
-        // take a copy
-        *outputs[i] = *m_output_data[i];
-        m_output_data[i]->ResetPending();
-      }
-    }
-    m_mutex.Unlock();
-
-    for (unsigned int i = 0; i < outputs.size(); i++) {
-      if (outputs[i]->IsPending()) {
-        WriteOutput(i, outputs[i]);
-        outputs[i]->ResetPending();
-      }
+    __sync_lock_test_and_set(&m_writer_waiting, 1);
+    __sync_synchronize();
+    if (!HasFrame()) {
+      m_cond_var.Wait(&m_mutex);
     }
+    __sync_lock_test_and_set(&m_writer_waiting, 0);
   }
 }
 
-void HardwareBackend::SetupOutputs(Outputs *outputs) {
-  for (unsigned int i = 0; i < m_output_count; i++) {
-    outputs->push_back(new OutputData());
+bool HardwareBackend::HasFrame() const {
+  Outputs::const_iterator iter = m_output_data.begin();
+  for (; iter != m_output_data.end(); ++iter) {
+    if ((*iter)->HasFrame()) {
+      return true;
+    }
   }
+  return false;
 }
 
-void HardwareBackend::WriteOutput(uint8_t output_id, OutputData *output) {
+void HardwareBackend::WriteOutput(uint8_t output_id,
+                                  const FrameExchange *output) {
   const string on("1");
   const string off("0");
 
@@ -247,7 +276,7 @@ void HardwareBackend::WriteOutput(uint8_t output_id, OutputData *output) {
     }
   }
 
-  m_spi_writer->WriteSPIData(output->GetData(), output->Size());
+  m_spi_writer->WriteSPIData(output->FrontData(), output->FrontSize());
 }
 
 bool HardwareBackend::SetupGPIO() {
@@ -304,18 +333,16 @@ SoftwareBackend::SoftwareBackend(const Options &options,
                                  SPIWriterInterface *writer,
                                  ExportMap *export_map)
     : m_spi_writer(writer),
-      m_drop_map(NULL),
-      m_write_pending(false),
-      m_exit(false),
+      m_drop_count(NULL),
       m_sync_output(options.sync_output),
       m_output_sizes(options.outputs, 0),
       m_latch_bytes(options.outputs, 0),
-      m_output(NULL),
-      m_length(0) {
+      m_writer_waiting(0),
+      m_exit(false) {
   if (export_map) {
-    m_drop_map = export_map->GetUIntMapVar(SPI_DROP_VAR,
-                                           SPI_DROP_VAR_KEY);
-    (*m_drop_map)[m_spi_writer->DevicePath()] = 0;
+    m_drop_count = export_map->GetUIntMapVar(
+        SPI_DROP_VAR, SPI_DROP_VAR_KEY)->Handle(m_spi_writer->DevicePath());
+    *m_drop_count = 0;
   }
 }
 
@@ -327,8 +354,6 @@ SoftwareBackend::~SoftwareBackend() {
 
   m_cond_var.Signal();
   Join();
-
-  delete[] m_output;
 }
 
 bool SoftwareBackend::Init() {
@@ -350,7 +375,8 @@ uint8_t *SoftwareBackend::Checkout(uint8_t output,
     return NULL;
   }
 
-  m_mutex.Lock();
+  m_checkout_mutex.Lock();
+  uint8_t *data = m_frames.Checkout();
 
   unsigned int leading = 0;
   unsigned int trailing = 0;
@@ -369,19 +395,20 @@ uint8_t *SoftwareBackend::Checkout(uint8_t output,
       leading + length + trailing + total_latch_bytes);
 
   // Check if the current buffer is large enough to hold our data.
-  if (required_size != m_length) {
-    // The length changed
-    uint8_t *new_output = new uint8_t[required_size];
-    memcpy(new_output, m_output, leading);
-    memset(new_output + leading, 0, length);
-    memcpy(new_output + leading + length, m_output + leading, trailing);
-    memset(new_output + leading + length + trailing, 0, total_latch_bytes);
-    delete[] m_output;
-    m_output = new_output;
-    m_length = required_size;
+  if (required_size != m_frames.Size()) {
+    // The length changed, move the data for the following outputs.
+    data = m_frames.Resize(std::max(required_size, m_frames.Size()));
+    memmove(data + leading + length,
+            data + leading + m_output_sizes[output],
+            trailing);
+    memset(data + leading, 0, length);
+    memset(data + leading + length + trailing, 0, total_latch_bytes);
+    data = m_frames.Resize(required_size);
     m_output_sizes[output] = length;
   }
-  return m_output + leading;
+  // We return with the Mutex locked, the caller must then call Commit()
+  // coverity[LOCK]
+  return data + leading;
 }
 
 void SoftwareBackend::Commit(uint8_t output) {
@@ -391,59 +418,40 @@ void SoftwareBackend::Commit(uint8_t output) {
   }
 
   bool should_write = m_sync_output < 0 || output == m_sync_output;
-  if (should_write) {
-    if (m_write_pending && m_drop_map) {
-      // There was already another write pending which we're now stomping on
-      (*m_drop_map)[m_spi_writer->DevicePath()]++;
-    }
-    m_write_pending = should_write;
+  if (should_write && m_frames.Publish() && m_drop_count) {
+    // There was already another write pending which we're now stomping on
+    (*m_drop_count)++;
   }
-  m_mutex.Unlock();
+  m_checkout_mutex.Unlock();
+
   if (should_write) {
-    m_cond_var.Signal();
+    // Pairs with the barrier in Run(), either we see the writer is waiting,
+    // or it sees the frame we just published.
+    __sync_synchronize();
+    if (m_writer_waiting) {
+      MutexLocker lock(&m_mutex);
+      m_cond_var.Signal();
+    }
   }
 }
 
 void *SoftwareBackend::Run() {
-  uint8_t *output_data = NULL;
-  unsigned int length = 0;
-
   while (true) {
-    m_mutex.Lock();
-
-    if (m_exit) {
-      m_mutex.Unlock();
-      delete output_data;
-      return NULL;
-    }
-
-    if (!m_write_pending) {
-      m_cond_var.Wait(&m_mutex);
+    if (m_frames.Acquire()) {
+      m_spi_writer->WriteSPIData(m_frames.FrontData(), m_frames.FrontSize());
+      continue;
     }
 
+    MutexLocker lock(&m_mutex);
     if (m_exit) {
-      m_mutex.Unlock();
-      delete[] output_data;
       return NULL;
     }
-
-    bool write_pending = m_write_pending;
-    m_write_pending = false;
-    if (write_pending) {
-      if (length < m_length) {
-        delete[] output_data;
-        output_data = new uint8_t[m_length];
-        length = m_length;
-      }
-      // TODO(simon) Add an actual size here
-      length = m_length;
-      memcpy(output_data, m_output, m_length);
-    }
-    m_mutex.Unlock();
-
-    if (write_pending) {
-      m_spi_writer->WriteSPIData(output_data, length);
+    __sync_lock_test_and_set(&m_writer_waiting, 1);
+    __sync_synchronize();
+    if (!m_frames.HasFrame()) {
+      m_cond_var.Wait(&m_mutex);
     }
+    __sync_lock_test_and_set(&m_writer_waiting, 0);
   }
 }
 
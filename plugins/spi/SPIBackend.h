@@ -23,6 +23,7 @@
 #define PLUGINS_SPI_SPIBACKEND_H_
 
 #include <stdint.h>
+#include <ola/base/Macro.h>
 #include <ola/thread/Mutex.h>
 #include <ola/thread/Thread.h>
 #include <string>
@@ -34,6 +35,85 @@ namespace ola {
 namespace plugin {
 namespace spi {
 
+/**
+ * Passes frames from the thread that builds them to the SPI writer thread
+ * without either side waiting on the other.
+ *
+ * There are three buffers: the back buffer is filled by the producer, the
+ * front buffer is being written by the consumer and the middle buffer holds
+ * the most recent complete frame. Publishing a frame swaps the back and middle
+ * buffers, acquiring a frame swaps the middle and front buffers. If the
+ * producer publishes twice before the consumer acquires, the earlier frame is
+ * dropped.
+ *
+ * There must be only one producer thread and one consumer thread.
+ */
+class FrameExchange {
+ public:
+  FrameExchange();
+  ~FrameExchange();
+
+  /**
+   * Get the back buffer. If a frame was published since the last call, the
+   * back buffer is first loaded with the last published frame, so callers
+   * only need to update the parts that have changed.
+   */
+  uint8_t *Checkout();
+
+  /**
+   * Resize the back buffer. Existing data is kept and any new bytes are
+   * zeroed.
+   */
+  uint8_t *Resize(unsigned int size);
+
+  /**
+   * The size of the back buffer.
+   */
+  unsigned int Size() const { return m_buffers[m_back].size; }
+
+  /**
+   * Publish the back buffer.
+   * @returns true if the previous frame was never acquired.
+   */
+  bool Publish();
+
+  /**
+   * Check if there is a frame to acquire.
+   */
+  bool HasFrame() const;
+
+  /**
+   * Move the latest published frame to the front buffer.
+   * @returns true if there was a new frame, false otherwise.
+   */
+  bool Acquire();
+
+  const uint8_t *FrontData() const { return m_buffers[m_front].data; }
+  unsigned int FrontSize() const { return m_buffers[m_front].size; }
+
+ private:
+  struct Buffer {
+    uint8_t *data;
+    unsigned int size;
+    unsigned int capacity;
+  };
+
+  Buffer m_buffers[3];
+  unsigned int m_back;  // only used by the producer
+  unsigned int m_last_published;  // only used by the producer
+  bool m_back_stale;  // only used by the producer
+  unsigned int m_front;  // only used by the consumer
+  uint32_t m_middle;  // shared, the index of the middle buffer | FRESH
+
+  uint32_t Exchange(uint32_t value);
+
+  static const uint32_t INDEX_MASK = 0x3;
+  static const uint32_t FRESH = 0x4;
+
+  DISALLOW_COPY_AND_ASSIGN(FrameExchange);
+};
+
+
 /**
  * The interface for all SPI Backends.
  */
@@ -91,46 +171,17 @@ class HardwareBackend : public ola::thread::Thread,
   void* Run();
 
  private:
-  class OutputData {
-   public:
-    OutputData()
-        : m_data(NULL),
-          m_write_pending(false),
-          m_size(0),
-          m_actual_size(0),
-          m_latch_bytes(0) {
-    }
-
-    ~OutputData() { delete[] m_data; }
-
-    uint8_t *Resize(unsigned int length);
-    void SetLatchBytes(unsigned int latch_bytes);
-    void SetPending();
-    bool IsPending() const { return m_write_pending; }
-    void ResetPending() { m_write_pending = false; }
-    const uint8_t *GetData() const { return m_data; }
-    unsigned int Size() const { return m_size; }
-
-    OutputData& operator=(const OutputData &other);
-
-   private:
-    uint8_t *m_data;
-    bool m_write_pending;
-    unsigned int m_size;
-    unsigned int m_actual_size;
-    unsigned int m_latch_bytes;
-
-    OutputData(const OutputData&);
-  };
-
   typedef std::vector<int> GPIOFds;
-  typedef std::vector<OutputData*> Outputs;
+  typedef std::vector<FrameExchange*> Outputs;
 
   SPIWriterInterface *m_spi_writer;
-  UIntMap *m_drop_map;
+  unsigned int *m_drop_count;
   const uint8_t m_output_count;
+
+  // Only used to wake the writer thread when it's idle.
   ola::thread::Mutex m_mutex;
   ola::thread::ConditionVariable m_cond_var;
+  uint32_t m_writer_waiting;
   bool m_exit;
 
   Outputs m_output_data;
@@ -140,8 +191,8 @@ class HardwareBackend : public ola::thread::Thread,
   const std::vector<uint16_t> m_gpio_pins;
   std::vector<bool> m_gpio_pin_state;
 
-  void SetupOutputs(Outputs *outputs);
-  void WriteOutput(uint8_t output_id, OutputData *output);
+  bool HasFrame() const;
+  void WriteOutput(uint8_t output_id, const FrameExchange *output);
   bool SetupGPIO();
   void CloseGPIOFDs();
 };
@@ -192,17 +243,21 @@ class SoftwareBackend : public SPIBackendInterface,
 
  private:
   SPIWriterInterface *m_spi_writer;
-  UIntMap *m_drop_map;
-  ola::thread::Mutex m_mutex;
-  ola::thread::ConditionVariable m_cond_var;
-  bool m_write_pending;
-  bool m_exit;
+  unsigned int *m_drop_count;
 
+  // Held from Checkout() to Commit(), this is never taken by the writer
+  // thread.
+  ola::thread::Mutex m_checkout_mutex;
+  FrameExchange m_frames;
   const int16_t m_sync_output;
   std::vector<unsigned int> m_output_sizes;
   std::vector<unsigned int> m_latch_bytes;
-  uint8_t *m_output;
-  unsigned int m_length;
+
+  // Only used to wake the writer thread when it's idle.
+  ola::thread::Mutex m_mutex;
+  ola::thread::ConditionVariable m_cond_var;
+  uint32_t m_writer_waiting;
+  bool m_exit;
 };
 
 
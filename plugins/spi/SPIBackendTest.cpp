@@ -19,9 +19,14 @@
  */
 
 #include <string.h>
+#include <unistd.h>
 #include <cppunit/extensions/HelperMacros.h>
 
+#include <algorithm>
+#include <string>
+
 #include "ola/base/Array.h"
+#include "ola/Clock.h"
 #include "ola/DmxBuffer.h"
 #include "ola/ExportMap.h"
 #include "ola/Logging.h"
@@ -29,8 +34,11 @@
 #include "plugins/spi/FakeSPIWriter.h"
 #include "plugins/spi/SPIBackend.h"
 
+using ola::Clock;
 using ola::DmxBuffer;
 using ola::ExportMap;
+using ola::TimeInterval;
+using ola::TimeStamp;
 using ola::plugin::spi::FakeSPIWriter;
 using ola::plugin::spi::HardwareBackend;
 using ola::plugin::spi::SoftwareBackend;
@@ -44,6 +52,7 @@ class SPIBackendTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testInvalidOutputs);
   CPPUNIT_TEST(testSoftwareDrops);
   CPPUNIT_TEST(testSoftwareVariousFrameLengths);
+  CPPUNIT_TEST(testContention);
   CPPUNIT_TEST_SUITE_END();
 
  public:
@@ -63,8 +72,11 @@ class SPIBackendTest: public CppUnit::TestFixture {
   void testInvalidOutputs();
   void testSoftwareDrops();
   void testSoftwareVariousFrameLengths();
+  void testContention();
 
  private:
+  void RunContention(const std::string &name, SPIBackendInterface *backend);
+
   ExportMap m_export_map;
   FakeSPIWriter m_writer;
   unsigned int m_total_size;
@@ -324,3 +336,66 @@ void SPIBackendTest::testSoftwareVariousFrameLengths() {
   m_writer.CheckDataMatches(OLA_SOURCELINE(), EXPECTED3, arraysize(EXPECTED3));
   m_writer.ResetWrite();
 }
+
+/**
+ * Send frames as fast as we can while the writer thread copies each one, and
+ * check every frame is either written or counted as a drop. This also reports
+ * how long the sending thread spent in Checkout() & Commit().
+ */
+void SPIBackendTest::testContention() {
+  {
+    HardwareBackend backend(HardwareBackend::Options(), &m_writer,
+                            &m_export_map);
+    OLA_ASSERT(backend.Init());
+    RunContention("HardwareBackend", &backend);
+  }
+
+  SoftwareBackend backend(SoftwareBackend::Options(), &m_writer,
+                          &m_export_map);
+  OLA_ASSERT(backend.Init());
+  RunContention("SoftwareBackend", &backend);
+}
+
+void SPIBackendTest::RunContention(const std::string &name,
+                                   SPIBackendInterface *backend) {
+  const unsigned int CONTENTION_FRAMES = 2000;
+  const unsigned int CONTENTION_FRAME_SIZE = 2720 * 4;  // 2720 APA102 pixels
+  Clock clock;
+  TimeStamp start, end, before, after;
+  TimeInterval max_latency;
+
+  const unsigned int initial_writes = m_writer.WriteCount();
+  m_writer.ResetWrite();
+  clock.CurrentTime(&start);
+  for (unsigned int i = 0; i < CONTENTION_FRAMES; i++) {
+    clock.CurrentTime(&before);
+    uint8_t *buffer = backend->Checkout(0, CONTENTION_FRAME_SIZE);
+    OLA_ASSERT_NOT_NULL(buffer);
+    memset(buffer, i & 0xff, CONTENTION_FRAME_SIZE);
+    backend->Commit(0);
+    clock.CurrentTime(&after);
+    max_latency = std::max(max_latency, after - before);
+  }
+  clock.CurrentTime(&end);
+
+  // Wait for the writer to catch up.
+  unsigned int written = 0;
+  for (unsigned int i = 0; i < 1000; i++) {
+    written = m_writer.WriteCount() - initial_writes;
+    if (written + DropCount() >= CONTENTION_FRAMES) {
+      break;
+    }
+    usleep(1000);
+  }
+
+  OLA_INFO << name << ": sent " << CONTENTION_FRAMES << " frames of "
+           << CONTENTION_FRAME_SIZE << " bytes in " << (end - start)
+           << ", max Checkout/Commit " << max_latency << ", " << written
+           << " written, " << DropCount() << " dropped";
+  OLA_ASSERT_EQ(CONTENTION_FRAMES, written + DropCount());
+
+  // The last frame always wins.
+  static uint8_t expected[CONTENTION_FRAME_SIZE];
+  memset(expected, (CONTENTION_FRAMES - 1) & 0xff, CONTENTION_FRAME_SIZE);
+  m_writer.CheckDataMatches(OLA_SOURCELINE(), expected, CONTENTION_FRAME_SIZE);
+}
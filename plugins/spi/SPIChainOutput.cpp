@@ -0,0 +1,217 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * SPIChainOutput.cpp
+ * A pixel string which is fed from several consecutive universes.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <string.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "ola/Callback.h"
+#include "ola/Logging.h"
+#include "ola/StringUtils.h"
+#include "plugins/spi/SPIBackend.h"
+#include "plugins/spi/SPIChainOutput.h"
+
+namespace ola {
+namespace plugin {
+namespace spi {
+
+using std::min;
+using std::string;
+
+const char SPIChainOutput::SPI_CHAIN_TIMEOUT_VAR[] = "spi-chain-timeouts";
+
+namespace {
+const char *const PIXEL_TYPE_NAMES[] = {
+  "ws2801", "lpd8806", "p9813", "apa102"
+};
+}  // namespace
+
+SPIChainOutput::SPIChainOutput(SPIBackendInterface *backend,
+                               ola::thread::SchedulerInterface *scheduler,
+                               const Options &options,
+                               ExportMap *export_map)
+    : m_backend(backend),
+      m_scheduler(scheduler),
+      m_output_number(options.output_number),
+      m_universes(options.universes),
+      m_pixel_count(min(options.pixel_count,
+                        options.universes * PIXELS_PER_UNIVERSE)),
+      m_pixel_type(options.pixel_type),
+      m_frame_timeout(options.frame_timeout),
+      m_encoder(options.encoder_options),
+      m_device_path(backend->DevicePath()),
+      m_slots(m_pixel_count * PixelEncoder::SLOTS_PER_PIXEL, 0),
+      m_arrived(options.universes, false),
+      m_arrived_count(0),
+      m_timeout_id(ola::thread::INVALID_TIMEOUT),
+      m_timeout_count(NULL) {
+  if (export_map) {
+    m_timeout_count = export_map->GetUIntMapVar(
+        SPI_CHAIN_TIMEOUT_VAR, "device")->Handle(m_device_path);
+    *m_timeout_count = 0;
+  }
+}
+
+SPIChainOutput::~SPIChainOutput() {
+  if (m_timeout_id != ola::thread::INVALID_TIMEOUT) {
+    m_scheduler->RemoveTimeout(m_timeout_id);
+  }
+}
+
+unsigned int SPIChainOutput::SegmentPixels(unsigned int segment) const {
+  const unsigned int first_pixel = segment * PIXELS_PER_UNIVERSE;
+  if (first_pixel >= m_pixel_count) {
+    return 0;
+  }
+  unsigned int pixels = m_pixel_count - first_pixel;
+  if (pixels > PIXELS_PER_UNIVERSE) {
+    pixels = PIXELS_PER_UNIVERSE;
+  }
+  return pixels;
+}
+
+bool SPIChainOutput::WriteDMX(unsigned int segment, const DmxBuffer &buffer) {
+  if (segment >= m_universes) {
+    return false;
+  }
+
+  const unsigned int slots = SegmentPixels(segment) *
+                             PixelEncoder::SLOTS_PER_PIXEL;
+  if (slots) {
+    // Partial data leaves the remaining pixels as they were.
+    memcpy(&m_slots[segment * PIXELS_PER_UNIVERSE *
+                    PixelEncoder::SLOTS_PER_PIXEL],
+           buffer.GetRaw(), min(slots, buffer.Size()));
+  }
+
+  if (!m_arrived[segment]) {
+    m_arrived[segment] = true;
+    m_arrived_count++;
+  }
+
+  if (m_arrived_count == m_universes) {
+    SendFrame();
+  } else if (m_timeout_id == ola::thread::INVALID_TIMEOUT) {
+    m_timeout_id = m_scheduler->RegisterSingleTimeout(
+        m_frame_timeout,
+        NewSingleCallback(this, &SPIChainOutput::FrameTimeout));
+  }
+  return true;
+}
+
+bool SPIChainOutput::PixelTypeFromString(const string &value,
+                                         PixelType *pixel_type) {
+  string type = value;
+  ola::ToLower(&type);
+  for (unsigned int i = 0;
+       i < sizeof(PIXEL_TYPE_NAMES) / sizeof(PIXEL_TYPE_NAMES[0]); i++) {
+    if (type == PIXEL_TYPE_NAMES[i]) {
+      *pixel_type = static_cast<PixelType>(i);
+      return true;
+    }
+  }
+  return false;
+}
+
+string SPIChainOutput::PixelTypeToString(PixelType pixel_type) {
+  return PIXEL_TYPE_NAMES[pixel_type];
+}
+
+/*
+ * Called if some segments of the frame didn't arrive in time.
+ */
+void SPIChainOutput::FrameTimeout() {
+  m_timeout_id = ola::thread::INVALID_TIMEOUT;
+  OLA_DEBUG << "SPI chain on " << m_device_path << " timed out with "
+            << m_arrived_count << " of " << m_universes << " universes";
+  if (m_timeout_count) {
+    (*m_timeout_count)++;
+  }
+  SendFrame();
+}
+
+/*
+ * Encode the whole string and hand it to the backend.
+ */
+void SPIChainOutput::SendFrame() {
+  if (m_timeout_id != ola::thread::INVALID_TIMEOUT) {
+    m_scheduler->RemoveTimeout(m_timeout_id);
+    m_timeout_id = ola::thread::INVALID_TIMEOUT;
+  }
+  std::fill(m_arrived.begin(), m_arrived.end(), false);
+  m_arrived_count = 0;
+
+  const uint8_t *input = m_slots.empty() ? NULL : &m_slots[0];
+  uint8_t *output;
+  switch (m_pixel_type) {
+    case WS2801:
+      output = m_backend->Checkout(m_output_number, m_pixel_count * 3);
+      if (!output) {
+        return;
+      }
+      m_encoder.WS2801(input, m_pixel_count, output);
+      break;
+    case LPD8806:
+      output = m_backend->Checkout(m_output_number, m_pixel_count * 3,
+                                   (m_pixel_count + 31) / 32);
+      if (!output) {
+        return;
+      }
+      m_encoder.LPD8806(input, m_pixel_count, output);
+      break;
+    case P9813:
+      output = m_backend->Checkout(m_output_number,
+                                   START_FRAME_BYTES + m_pixel_count * 4,
+                                   P9813_LATCH_BYTES);
+      if (!output) {
+        return;
+      }
+      memset(output, 0, START_FRAME_BYTES);
+      m_encoder.P9813(input, m_pixel_count, output + START_FRAME_BYTES);
+      break;
+    case APA102:
+      {
+        // The end frame needs half a bit per pixel, see
+        // SPIOutput::CalculateAPA102LatchBytes. As with SPIOutput, the start
+        // frame is only sent on the first output.
+        const unsigned int latch_bytes = ((m_pixel_count + 1) / 2 + 7) / 8;
+        unsigned int start_bytes = 0;
+        if (m_output_number == 0) {
+          start_bytes = START_FRAME_BYTES;
+        }
+        output = m_backend->Checkout(m_output_number,
+                                     start_bytes + m_pixel_count * 4,
+                                     latch_bytes);
+        if (!output) {
+          return;
+        }
+        memset(output, 0, start_bytes);
+        m_encoder.APA102(input, m_pixel_count, output + start_bytes);
+      }
+      break;
+    default:
+      return;
+  }
+  m_backend->Commit(m_output_number);
+}
+}  // namespace spi
+}  // namespace plugin
+}  // namespace ola
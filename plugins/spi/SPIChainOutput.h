@@ -0,0 +1,133 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * SPIChainOutput.h
+ * A pixel string which is fed from several consecutive universes.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef PLUGINS_SPI_SPICHAINOUTPUT_H_
+#define PLUGINS_SPI_SPICHAINOUTPUT_H_
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "ola/DmxBuffer.h"
+#include "ola/ExportMap.h"
+#include "ola/base/Macro.h"
+#include "ola/thread/SchedulerInterface.h"
+#include "plugins/spi/PixelEncoder.h"
+
+namespace ola {
+namespace plugin {
+namespace spi {
+
+/**
+ * A single pixel string driven from several universes.
+ *
+ * Each universe is a segment of the string, carrying up to 170 pixels from
+ * slot 1. The segments are copied into one buffer as they arrive, and the
+ * whole string is encoded and committed to the backend once every segment
+ * of the frame has arrived, or the frame timeout expires. This produces one
+ * SPI write per frame, and the string doesn't tear between segments.
+ *
+ * If the timeout expires, the segments which didn't arrive keep their
+ * previous data. These frames are counted in the ExportMap.
+ */
+class SPIChainOutput {
+ public:
+  enum PixelType {
+    WS2801,
+    LPD8806,
+    P9813,
+    APA102
+  };
+
+  struct Options {
+    uint8_t output_number;
+    unsigned int universes;
+    unsigned int pixel_count;  // for the whole string
+    PixelType pixel_type;
+    unsigned int frame_timeout;  // in ms
+    PixelEncoder::Options encoder_options;
+
+    Options()
+        : output_number(0),
+          universes(1),
+          pixel_count(PIXELS_PER_UNIVERSE),
+          pixel_type(APA102),
+          frame_timeout(DEFAULT_FRAME_TIMEOUT) {
+    }
+  };
+
+  SPIChainOutput(class SPIBackendInterface *backend,
+                 ola::thread::SchedulerInterface *scheduler,
+                 const Options &options,
+                 ExportMap *export_map = NULL);
+  ~SPIChainOutput();
+
+  unsigned int Universes() const { return m_universes; }
+  unsigned int PixelCount() const { return m_pixel_count; }
+  PixelType GetPixelType() const { return m_pixel_type; }
+
+  /**
+   * The number of pixels driven by a segment.
+   */
+  unsigned int SegmentPixels(unsigned int segment) const;
+
+  /**
+   * Update the data for one segment of the string.
+   * @param segment the segment, from 0 to Universes() - 1.
+   * @param buffer the DMX data for the segment.
+   */
+  bool WriteDMX(unsigned int segment, const DmxBuffer &buffer);
+
+  static bool PixelTypeFromString(const std::string &value,
+                                  PixelType *pixel_type);
+  static std::string PixelTypeToString(PixelType pixel_type);
+
+  static const unsigned int PIXELS_PER_UNIVERSE = 170;
+  static const unsigned int DEFAULT_FRAME_TIMEOUT = 10;
+  static const char SPI_CHAIN_TIMEOUT_VAR[];
+
+ private:
+  class SPIBackendInterface *m_backend;
+  ola::thread::SchedulerInterface *m_scheduler;
+  const uint8_t m_output_number;
+  const unsigned int m_universes;
+  const unsigned int m_pixel_count;
+  const PixelType m_pixel_type;
+  const unsigned int m_frame_timeout;
+  const PixelEncoder m_encoder;
+  std::string m_device_path;
+
+  std::vector<uint8_t> m_slots;  // 3 per pixel, for the whole string
+  std::vector<bool> m_arrived;
+  unsigned int m_arrived_count;
+  ola::thread::timeout_id m_timeout_id;
+  unsigned int *m_timeout_count;
+
+  void FrameTimeout();
+  void SendFrame();
+
+  static const unsigned int START_FRAME_BYTES = 4;
+  static const unsigned int P9813_LATCH_BYTES = 8;
+
+  DISALLOW_COPY_AND_ASSIGN(SPIChainOutput);
+};
+}  // namespace spi
+}  // namespace plugin
+}  // namespace ola
+#endif  // PLUGINS_SPI_SPICHAINOUTPUT_H_
@@ -0,0 +1,255 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * SPIChainOutputTest.cpp
+ * Test fixture for the SPIChainOutput class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <string.h>
+#include <string>
+
+#include "ola/Callback.h"
+#include "ola/Constants.h"
+#include "ola/DmxBuffer.h"
+#include "ola/ExportMap.h"
+#include "ola/testing/TestUtils.h"
+#include "ola/thread/SchedulerInterface.h"
+#include "plugins/spi/SPIBackend.h"
+#include "plugins/spi/SPIChainOutput.h"
+
+using ola::DmxBuffer;
+using ola::ExportMap;
+using ola::SingleUseCallback0;
+using ola::plugin::spi::FakeSPIBackend;
+using ola::plugin::spi::SPIChainOutput;
+using ola::thread::timeout_id;
+
+/*
+ * Holds a single timeout, which the test runs by hand.
+ */
+class MockScheduler: public ola::thread::SchedulerInterface {
+ public:
+  MockScheduler() : m_callback(NULL), m_delay(0) {}
+  ~MockScheduler() { delete m_callback; }
+
+  timeout_id RegisterRepeatingTimeout(unsigned int,
+                                      ola::Callback0<bool> *callback) {
+    delete callback;
+    return ola::thread::INVALID_TIMEOUT;
+  }
+
+  timeout_id RegisterRepeatingTimeout(const ola::TimeInterval &,
+                                      ola::Callback0<bool> *callback) {
+    delete callback;
+    return ola::thread::INVALID_TIMEOUT;
+  }
+
+  timeout_id RegisterSingleTimeout(unsigned int delay,
+                                   SingleUseCallback0<void> *callback) {
+    delete m_callback;
+    m_callback = callback;
+    m_delay = delay;
+    return this;
+  }
+
+  timeout_id RegisterSingleTimeout(const ola::TimeInterval &delay,
+                                   SingleUseCallback0<void> *callback) {
+    return RegisterSingleTimeout(delay.InMilliSeconds(), callback);
+  }
+
+  void RemoveTimeout(timeout_id) {
+    delete m_callback;
+    m_callback = NULL;
+  }
+
+  bool Pending() const { return m_callback != NULL; }
+  unsigned int Delay() const { return m_delay; }
+
+  void RunTimeout() {
+    SingleUseCallback0<void> *callback = m_callback;
+    m_callback = NULL;
+    callback->Run();
+  }
+
+ private:
+  SingleUseCallback0<void> *m_callback;
+  unsigned int m_delay;
+};
+
+
+class SPIChainOutputTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(SPIChainOutputTest);
+  CPPUNIT_TEST(testCompleteFrames);
+  CPPUNIT_TEST(testTimeout);
+  CPPUNIT_TEST(testFrameFormat);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    void testCompleteFrames();
+    void testTimeout();
+    void testFrameFormat();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(SPIChainOutputTest);
+
+
+/*
+ * Check a frame is only sent once all the universes have arrived.
+ */
+void SPIChainOutputTest::testCompleteFrames() {
+  FakeSPIBackend backend(1);
+  MockScheduler scheduler;
+  SPIChainOutput::Options options;
+  options.universes = 3;
+  options.pixel_count = 400;
+  options.pixel_type = SPIChainOutput::WS2801;
+  SPIChainOutput chain(&backend, &scheduler, options);
+
+  OLA_ASSERT_EQ(400u, chain.PixelCount());
+  OLA_ASSERT_EQ(170u, chain.SegmentPixels(0));
+  OLA_ASSERT_EQ(170u, chain.SegmentPixels(1));
+  OLA_ASSERT_EQ(60u, chain.SegmentPixels(2));
+  OLA_ASSERT_FALSE(chain.WriteDMX(3, DmxBuffer()));
+
+  DmxBuffer buffer;
+  buffer.SetRangeToValue(0, 1, ola::DMX_UNIVERSE_SIZE);
+  OLA_ASSERT_TRUE(chain.WriteDMX(0, buffer));
+  OLA_ASSERT_TRUE(scheduler.Pending());
+  OLA_ASSERT_EQ(options.frame_timeout, scheduler.Delay());
+  buffer.SetRangeToValue(0, 2, ola::DMX_UNIVERSE_SIZE);
+  OLA_ASSERT_TRUE(chain.WriteDMX(1, buffer));
+  // A repeated universe replaces the data, but doesn't complete the frame.
+  buffer.SetRangeToValue(0, 3, ola::DMX_UNIVERSE_SIZE);
+  OLA_ASSERT_TRUE(chain.WriteDMX(1, buffer));
+  OLA_ASSERT_EQ(0u, backend.Writes(0));
+
+  buffer.SetRangeToValue(0, 4, ola::DMX_UNIVERSE_SIZE);
+  OLA_ASSERT_TRUE(chain.WriteDMX(2, buffer));
+  OLA_ASSERT_EQ(1u, backend.Writes(0));
+  OLA_ASSERT_FALSE(scheduler.Pending());
+
+  unsigned int length = 0;
+  const uint8_t *data = backend.GetData(0, &length);
+  OLA_ASSERT_EQ(1200u, length);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(1), data[0]);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(1), data[509]);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(3), data[510]);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(3), data[1019]);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(4), data[1020]);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(4), data[1199]);
+
+  // The next frame starts from scratch.
+  OLA_ASSERT_TRUE(chain.WriteDMX(2, buffer));
+  OLA_ASSERT_TRUE(chain.WriteDMX(1, buffer));
+  OLA_ASSERT_EQ(1u, backend.Writes(0));
+  OLA_ASSERT_TRUE(chain.WriteDMX(0, buffer));
+  OLA_ASSERT_EQ(2u, backend.Writes(0));
+}
+
+
+/*
+ * Check a frame is sent when the timeout expires, with the old data for the
+ * missing universes.
+ */
+void SPIChainOutputTest::testTimeout() {
+  ExportMap export_map;
+  FakeSPIBackend backend(1);
+  MockScheduler scheduler;
+  SPIChainOutput::Options options;
+  options.universes = 2;
+  options.pixel_count = 2 * SPIChainOutput::PIXELS_PER_UNIVERSE;
+  options.pixel_type = SPIChainOutput::WS2801;
+  options.frame_timeout = 25;
+  SPIChainOutput chain(&backend, &scheduler, options, &export_map);
+
+  DmxBuffer buffer;
+  buffer.SetFromString("1,2,3");
+  OLA_ASSERT_TRUE(chain.WriteDMX(1, buffer));
+  OLA_ASSERT_EQ(25u, scheduler.Delay());
+  scheduler.RunTimeout();
+  OLA_ASSERT_EQ(1u, backend.Writes(0));
+  OLA_ASSERT_EQ(1u, (*export_map.GetUIntMapVar(
+      SPIChainOutput::SPI_CHAIN_TIMEOUT_VAR))["/dev/test"]);
+
+  unsigned int length = 0;
+  const uint8_t *data = backend.GetData(0, &length);
+  OLA_ASSERT_EQ(1020u, length);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(0), data[0]);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(1), data[510]);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(3), data[512]);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(0), data[513]);
+}
+
+
+/*
+ * Check the start and end frames for each pixel type.
+ */
+void SPIChainOutputTest::testFrameFormat() {
+  DmxBuffer buffer;
+  buffer.SetFromString("255,128,0");
+
+  SPIChainOutput::Options options;
+  options.universes = 2;
+  options.pixel_count = 2 * SPIChainOutput::PIXELS_PER_UNIVERSE;
+
+  const struct {
+    SPIChainOutput::PixelType type;
+    unsigned int length;
+    unsigned int first_pixel;
+    uint8_t pixel[4];
+  } formats[] = {
+    // 340 pixels, 11 latch bytes
+    {SPIChainOutput::LPD8806, 1020 + 11, 0, {0xC0, 0xFF, 0x80, 0x80}},
+    // start frame, 340 pixels, 8 latch bytes
+    {SPIChainOutput::P9813, 4 + 1360 + 8, 4, {0xF4, 0, 0x80, 0xFF}},
+    // start frame, 340 pixels, 22 latch bytes
+    {SPIChainOutput::APA102, 4 + 1360 + 22, 4, {0xFF, 0, 0x80, 0xFF}},
+  };
+
+  for (unsigned int i = 0; i < sizeof(formats) / sizeof(formats[0]); i++) {
+    FakeSPIBackend backend(1);
+    MockScheduler scheduler;
+    options.pixel_type = formats[i].type;
+    SPIChainOutput chain(&backend, &scheduler, options);
+    chain.WriteDMX(0, buffer);
+    chain.WriteDMX(1, buffer);
+    OLA_ASSERT_EQ(1u, backend.Writes(0));
+
+    unsigned int length = 0;
+    const uint8_t *data = backend.GetData(0, &length);
+    OLA_ASSERT_EQ(formats[i].length, length);
+    for (unsigned int j = 0; j < formats[i].first_pixel; j++) {
+      OLA_ASSERT_EQ(static_cast<uint8_t>(0), data[j]);
+    }
+    const unsigned int pixel_size = formats[i].type == SPIChainOutput::LPD8806 ?
+                                    3 : 4;
+    OLA_ASSERT_DATA_EQUALS(formats[i].pixel, pixel_size,
+                           data + formats[i].first_pixel, pixel_size);
+    // The first pixel of the second universe.
+    OLA_ASSERT_DATA_EQUALS(
+        formats[i].pixel, pixel_size,
+        data + formats[i].first_pixel + 170 * pixel_size, pixel_size);
+    OLA_ASSERT_EQ(static_cast<uint8_t>(0), data[length - 1]);
+  }
+
+  OLA_ASSERT_EQ(std::string("apa102"),
+                SPIChainOutput::PixelTypeToString(SPIChainOutput::APA102));
+  SPIChainOutput::PixelType type;
+  OLA_ASSERT_TRUE(SPIChainOutput::PixelTypeFromString("LPD8806", &type));
+  OLA_ASSERT_EQ(SPIChainOutput::LPD8806, type);
+  OLA_ASSERT_FALSE(SPIChainOutput::PixelTypeFromString("ws2812", &type));
+}
@@ -71,6 +71,9 @@ SPIDevice::SPIDevice(SPIPlugin *owner,
   unsigned int port_count = 0;
 
   string backend_type = m_preferences->GetValue(SPIBackendKey());
+  unsigned int chain_universes = 0;
+  StringToInt(m_preferences->GetValue(ChainUniversesKey()), &chain_universes);
+
   SPIWriter::Options writer_options;
   PopulateWriterOptions(&writer_options);
   m_writer.reset(new SPIWriter(spi_device, writer_options,
@@ -94,6 +97,11 @@ SPIDevice::SPIDevice(SPIPlugin *owner,
 
     SoftwareBackend::Options options;
     PopulateSoftwareBackendOptions(&options);
+    if (chain_universes) {
+      // The chain is a single string on the first output.
+      options.outputs = 1;
+      options.sync_output = 0;
+    }
     m_backend.reset(
         new SoftwareBackend(options, m_writer.get(),
                             plugin_adaptor->GetExportMap()));
@@ -102,6 +110,20 @@ SPIDevice::SPIDevice(SPIPlugin *owner,
              << " ports";
   }
 
+  if (chain_universes) {
+    SPIChainOutput::Options chain_options;
+    chain_options.universes = chain_universes;
+    PopulateChainOptions(&chain_options);
+    m_chain.reset(new SPIChainOutput(m_backend.get(), plugin_adaptor,
+                                     chain_options,
+                                     plugin_adaptor->GetExportMap()));
+    OLA_INFO << m_spi_device_name << ", "
+             << SPIChainOutput::PixelTypeToString(chain_options.pixel_type)
+             << " chain of " << m_chain->PixelCount() << " pixels across "
+             << chain_universes << " universes";
+    return;
+  }
+
   for (uint8_t i = 0; i < port_count; i++) {
     SPIOutput::Options spi_output_options(i, m_spi_device_name);
 
@@ -114,6 +136,8 @@ SPIDevice::SPIDevice(SPIPlugin *owner,
     if (StringToInt(m_preferences->GetValue(PixelCountKey(i)), &pixel_count)) {
       spi_output_options.pixel_count = pixel_count;
     }
+    PopulateEncoderOptions(ColorOrderKey(i), BrightnessKey(i), GammaKey(i),
+                           &spi_output_options.encoder_options);
 
     auto_ptr<UID> uid(uid_allocator->AllocateNext());
     if (!uid.get()) {
@@ -143,6 +167,13 @@ bool SPIDevice::StartHook() {
     return false;
   }
 
+  if (m_chain.get()) {
+    for (unsigned int i = 0; i < m_chain->Universes(); i++) {
+      AddPort(new SPIChainPort(this, m_chain.get(), i));
+    }
+    return true;
+  }
+
   SPIPorts::iterator iter = m_spi_ports.begin();
   for (uint8_t i = 0; iter != m_spi_ports.end(); iter++, i++) {
     uint8_t personality;
@@ -176,6 +207,17 @@ void SPIDevice::PrePortStop() {
     str.str("");
     str << (*iter)->PixelCount();
     m_preferences->SetValue(PixelCountKey(i), str.str());
+
+    const PixelEncoder::Options &encoder_options = (*iter)->EncoderOptions();
+    m_preferences->SetValue(
+        ColorOrderKey(i),
+        PixelEncoder::ColorOrderToString(encoder_options.color_order));
+    str.str("");
+    str << static_cast<int>(encoder_options.brightness);
+    m_preferences->SetValue(BrightnessKey(i), str.str());
+    str.str("");
+    str << static_cast<int>(encoder_options.gamma);
+    m_preferences->SetValue(GammaKey(i), str.str());
   }
   m_preferences->Save();
 }
@@ -204,6 +246,26 @@ string SPIDevice::GPIOPinKey() const {
   return m_spi_device_name + "-gpio-pin";
 }
 
+string SPIDevice::ChainUniversesKey() const {
+  return GetChainKey("universes");
+}
+
+string SPIDevice::ChainPixelTypeKey() const {
+  return GetChainKey("pixel-type");
+}
+
+string SPIDevice::ChainPixelCountKey() const {
+  return GetChainKey("pixel-count");
+}
+
+string SPIDevice::ChainFrameTimeoutKey() const {
+  return GetChainKey("frame-timeout");
+}
+
+string SPIDevice::GetChainKey(const string &suffix) const {
+  return m_spi_device_name + "-chain-" + suffix;
+}
+
 string SPIDevice::DeviceLabelKey(uint8_t port) const {
   return GetPortKey("device-label", port);
 }
@@ -220,6 +282,18 @@ string SPIDevice::PixelCountKey(uint8_t port) const {
   return GetPortKey("pixel-count", port);
 }
 
+string SPIDevice::ColorOrderKey(uint8_t port) const {
+  return GetPortKey("color-order", port);
+}
+
+string SPIDevice::BrightnessKey(uint8_t port) const {
+  return GetPortKey("brightness", port);
+}
+
+string SPIDevice::GammaKey(uint8_t port) const {
+  return GetPortKey("gamma", port);
+}
+
 string SPIDevice::GetPortKey(const string &suffix, uint8_t port) const {
   std::ostringstream str;
   str << m_spi_device_name << "-" << static_cast<int>(port) << "-" << suffix;
@@ -239,6 +313,30 @@ void SPIDevice::SetDefaults() {
   m_preferences->SetDefaultValue(SPICEKey(), BoolValidator(), false);
   m_preferences->SetDefaultValue(PortCountKey(), UIntValidator(1, 8), 1);
   m_preferences->SetDefaultValue(SyncPortKey(), IntValidator(-2, 8), 0);
+
+  // Chain options
+  m_preferences->SetDefaultValue(ChainUniversesKey(),
+                                 UIntValidator(0, MAX_CHAIN_UNIVERSES), 0);
+  set<string> valid_pixel_types;
+  valid_pixel_types.insert(
+      SPIChainOutput::PixelTypeToString(SPIChainOutput::WS2801));
+  valid_pixel_types.insert(
+      SPIChainOutput::PixelTypeToString(SPIChainOutput::LPD8806));
+  valid_pixel_types.insert(
+      SPIChainOutput::PixelTypeToString(SPIChainOutput::P9813));
+  valid_pixel_types.insert(
+      SPIChainOutput::PixelTypeToString(SPIChainOutput::APA102));
+  m_preferences->SetDefaultValue(
+      ChainPixelTypeKey(), SetValidator<string>(valid_pixel_types),
+      SPIChainOutput::PixelTypeToString(SPIChainOutput::APA102));
+  m_preferences->SetDefaultValue(
+      ChainPixelCountKey(),
+      UIntValidator(1, MAX_CHAIN_UNIVERSES *
+                       SPIChainOutput::PIXELS_PER_UNIVERSE),
+      SPIChainOutput::PIXELS_PER_UNIVERSE);
+  m_preferences->SetDefaultValue(ChainFrameTimeoutKey(),
+                                 UIntValidator(1, 1000),
+                                 SPIChainOutput::DEFAULT_FRAME_TIMEOUT);
   m_preferences->Save();
 }
 
@@ -279,6 +377,25 @@ void SPIDevice::PopulateSoftwareBackendOptions(
   }
 }
 
+void SPIDevice::PopulateChainOptions(SPIChainOutput::Options *options) {
+  SPIChainOutput::PixelTypeFromString(
+      m_preferences->GetValue(ChainPixelTypeKey()), &options->pixel_type);
+
+  if (!StringToInt(m_preferences->GetValue(ChainPixelCountKey()),
+                   &options->pixel_count)) {
+    OLA_WARN << "Invalid integer value for " << ChainPixelCountKey();
+  }
+
+  if (!StringToInt(m_preferences->GetValue(ChainFrameTimeoutKey()),
+                   &options->frame_timeout)) {
+    OLA_WARN << "Invalid integer value for " << ChainFrameTimeoutKey();
+  }
+
+  PopulateEncoderOptions(GetChainKey("color-order"),
+                         GetChainKey("brightness"), GetChainKey("gamma"),
+                         &options->encoder_options);
+}
+
 void SPIDevice::PopulateWriterOptions(SPIWriter::Options *options) {
   uint32_t spi_speed;
   if (StringToInt(m_preferences->GetValue(SPISpeedKey()), &spi_speed)) {
@@ -289,6 +406,35 @@ void SPIDevice::PopulateWriterOptions(SPIWriter::Options *options) {
     options->cs_enable_high = ce_high;
   }
 }
+
+void SPIDevice::PopulateEncoderOptions(const string &color_order_key,
+                                       const string &brightness_key,
+                                       const string &gamma_key,
+                                       PixelEncoder::Options *options) {
+  string color_order = m_preferences->GetValue(color_order_key);
+  if (!color_order.empty() &&
+      !PixelEncoder::ColorOrderFromString(color_order,
+                                          &options->color_order)) {
+    OLA_WARN << "Invalid color order " << color_order << " for "
+             << color_order_key;
+  }
+
+  uint8_t brightness;
+  if (StringToInt(m_preferences->GetValue(brightness_key), &brightness)) {
+    options->brightness = brightness;
+  }
+
+  uint8_t gamma;
+  if (StringToInt(m_preferences->GetValue(gamma_key), &gamma)) {
+    if (gamma >= 1 && gamma <= PixelEncoder::MAX_GAMMA) {
+      options->gamma = gamma;
+    } else {
+      OLA_WARN << "Invalid gamma " << static_cast<int>(gamma) << " for "
+               << gamma_key << ", must be between 1 and "
+               << static_cast<int>(PixelEncoder::MAX_GAMMA);
+    }
+  }
+}
 }  // namespace spi
 }  // namespace plugin
 }  // namespace ola
@@ -29,7 +29,9 @@
 #include "ola/io/SelectServer.h"
 #include "ola/rdm/UIDAllocator.h"
 #include "ola/rdm/UID.h"
+#include "plugins/spi/PixelEncoder.h"
 #include "plugins/spi/SPIBackend.h"
+#include "plugins/spi/SPIChainOutput.h"
 #include "plugins/spi/SPIWriter.h"
 
 namespace ola {
@@ -58,6 +60,7 @@ class SPIDevice: public ola::Device {
 
   std::auto_ptr<SPIWriterInterface> m_writer;
   std::auto_ptr<SPIBackendInterface> m_backend;
+  std::auto_ptr<SPIChainOutput> m_chain;
   class Preferences *m_preferences;
   class PluginAdaptor *m_plugin_adaptor;
   SPIPorts m_spi_ports;
@@ -70,23 +73,37 @@ class SPIDevice: public ola::Device {
   std::string PortCountKey() const;
   std::string SyncPortKey() const;
   std::string GPIOPinKey() const;
+  std::string ChainUniversesKey() const;
+  std::string ChainPixelTypeKey() const;
+  std::string ChainPixelCountKey() const;
+  std::string ChainFrameTimeoutKey() const;
+  std::string GetChainKey(const std::string &suffix) const;
 
   // Per port options
   std::string DeviceLabelKey(uint8_t port) const;
   std::string PersonalityKey(uint8_t port) const;
   std::string PixelCountKey(uint8_t port) const;
   std::string StartAddressKey(uint8_t port) const;
+  std::string ColorOrderKey(uint8_t port) const;
+  std::string BrightnessKey(uint8_t port) const;
+  std::string GammaKey(uint8_t port) const;
   std::string GetPortKey(const std::string &suffix, uint8_t port) const;
 
   void SetDefaults();
   void PopulateHardwareBackendOptions(HardwareBackend::Options *options);
   void PopulateSoftwareBackendOptions(SoftwareBackend::Options *options);
   void PopulateWriterOptions(SPIWriter::Options *options);
+  void PopulateEncoderOptions(const std::string &color_order_key,
+                              const std::string &brightness_key,
+                              const std::string &gamma_key,
+                              PixelEncoder::Options *options);
+  void PopulateChainOptions(SPIChainOutput::Options *options);
 
   static const char SPI_DEVICE_NAME[];
   static const char HARDWARE_BACKEND[];
   static const char SOFTWARE_BACKEND[];
   static const uint16_t MAX_GPIO_PIN = 1023;
+  static const unsigned int MAX_CHAIN_UNIVERSES = 32;
 };
 }  // namespace spi
 }  // namespace plugin
@@ -174,6 +174,7 @@ SPIOutput::SPIOutput(const UID &uid, SPIBackendInterface *backend,
       m_output_number(options.output_number),
       m_uid(uid),
       m_pixel_count(options.pixel_count),
+      m_encoder(options.encoder_options),
       m_device_label(options.device_label),
       m_start_address(1),
       m_identify_mode(false) {
@@ -322,6 +323,17 @@ bool SPIOutput::InternalWriteDMX(const DmxBuffer &buffer) {
   return true;
 }
 
+/*
+ * The number of complete pixels in the buffer from the start address.
+ */
+unsigned int SPIOutput::AvailablePixels(const DmxBuffer &buffer) const {
+  const unsigned int first_slot = m_start_address - 1;  // 0 offset
+  if (buffer.Size() <= first_slot) {
+    return 0;
+  }
+  return (buffer.Size() - first_slot) / PixelEncoder::SLOTS_PER_PIXEL;
+}
+
 void SPIOutput::IndividualWS2801Control(const DmxBuffer &buffer) {
   // We always check out the entire string length, even if we only have data
   // for part of it
@@ -331,21 +343,30 @@ void SPIOutput::IndividualWS2801Control(const DmxBuffer &buffer) {
     return;
   }
 
-  unsigned int new_length = output_length;
-  buffer.GetRange(m_start_address - 1, output, &new_length);
+  const unsigned int first_slot = m_start_address - 1;  // 0 offset
+  const unsigned int pixels = min(m_pixel_count, AvailablePixels(buffer));
+  m_encoder.WS2801(buffer.GetRaw() + first_slot, pixels, output);
+
+  // A trailing partial pixel is copied as is.
+  if (pixels < m_pixel_count && buffer.Size() > first_slot) {
+    const unsigned int offset = pixels * WS2801_SLOTS_PER_PIXEL;
+    const unsigned int length = min(output_length - offset,
+                                    buffer.Size() - first_slot - offset);
+    memcpy(output + offset, buffer.GetRaw() + first_slot + offset, length);
+  }
   m_backend->Commit(m_output_number);
 }
 
 void SPIOutput::CombinedWS2801Control(const DmxBuffer &buffer) {
-  unsigned int pixel_data_length = WS2801_SLOTS_PER_PIXEL;
-  uint8_t pixel_data[WS2801_SLOTS_PER_PIXEL];
-  buffer.GetRange(m_start_address - 1, pixel_data, &pixel_data_length);
-  if (pixel_data_length != WS2801_SLOTS_PER_PIXEL) {
+  if (!AvailablePixels(buffer)) {
     OLA_INFO << "Insufficient DMX data, required " << WS2801_SLOTS_PER_PIXEL
-             << ", got " << pixel_data_length;
+             << ", got " << buffer.Size() - (m_start_address - 1);
     return;
   }
 
+  uint8_t pixel_data[WS2801_SLOTS_PER_PIXEL];
+  m_encoder.WS2801(buffer.GetRaw() + m_start_address - 1, 1, pixel_data);
+
   const unsigned int length = m_pixel_count * WS2801_SLOTS_PER_PIXEL;
   uint8_t *output = m_backend->Checkout(m_output_number, length);
   if (!output) {
@@ -354,15 +375,15 @@ void SPIOutput::CombinedWS2801Control(const DmxBuffer &buffer) {
 
   for (unsigned int i = 0; i < m_pixel_count; i++) {
     memcpy(output + (i * WS2801_SLOTS_PER_PIXEL), pixel_data,
-           pixel_data_length);
+           WS2801_SLOTS_PER_PIXEL);
   }
   m_backend->Commit(m_output_number);
 }
 
 void SPIOutput::IndividualLPD8806Control(const DmxBuffer &buffer) {
   const uint8_t latch_bytes = (m_pixel_count + 31) / 32;
-  const unsigned int first_slot = m_start_address - 1;  // 0 offset
-  if (buffer.Size() - first_slot < LPD8806_SLOTS_PER_PIXEL) {
+  const unsigned int pixels = min(m_pixel_count, AvailablePixels(buffer));
+  if (!pixels) {
     // not even 3 bytes of data, don't bother updating
     return;
   }
@@ -375,38 +396,20 @@ void SPIOutput::IndividualLPD8806Control(const DmxBuffer &buffer) {
   if (!output)
     return;
 
-  const unsigned int length = std::min(m_pixel_count * LPD8806_SLOTS_PER_PIXEL,
-                                       buffer.Size() - first_slot);
-
-  for (unsigned int i = 0; i < length / LPD8806_SLOTS_PER_PIXEL; i++) {
-    // Convert RGB to GRB
-    unsigned int offset = first_slot + i * LPD8806_SLOTS_PER_PIXEL;
-    uint8_t r = buffer.Get(offset);
-    uint8_t g = buffer.Get(offset + 1);
-    uint8_t b = buffer.Get(offset + 2);
-    output[i * LPD8806_SLOTS_PER_PIXEL] = 0x80 | (g >> 1);
-    output[i * LPD8806_SLOTS_PER_PIXEL + 1] = 0x80 | (r >> 1);
-    output[i * LPD8806_SLOTS_PER_PIXEL + 2] = 0x80 | (b >> 1);
-  }
+  m_encoder.LPD8806(buffer.GetRaw() + m_start_address - 1, pixels, output);
   m_backend->Commit(m_output_number);
 }
 
 void SPIOutput::CombinedLPD8806Control(const DmxBuffer &buffer) {
   const uint8_t latch_bytes = (m_pixel_count + 31) / 32;
-  unsigned int pixel_data_length = LPD8806_SLOTS_PER_PIXEL;
-
-  uint8_t pixel_data[LPD8806_SLOTS_PER_PIXEL];
-  buffer.GetRange(m_start_address - 1, pixel_data, &pixel_data_length);
-  if (pixel_data_length != LPD8806_SLOTS_PER_PIXEL) {
+  if (!AvailablePixels(buffer)) {
     OLA_INFO << "Insufficient DMX data, required " << LPD8806_SLOTS_PER_PIXEL
-             << ", got " << pixel_data_length;
+             << ", got " << buffer.Size() - (m_start_address - 1);
     return;
   }
 
-  // The leds are GRB format so convert here
-  uint8_t temp = pixel_data[1];
-  pixel_data[1] = pixel_data[0];
-  pixel_data[0] = temp;
+  uint8_t pixel_data[LPD8806_SLOTS_PER_PIXEL];
+  m_encoder.LPD8806(buffer.GetRaw() + m_start_address - 1, 1, pixel_data);
 
   const unsigned int length = m_pixel_count * LPD8806_SLOTS_PER_PIXEL;
   uint8_t *output = m_backend->Checkout(m_output_number, length, latch_bytes);
@@ -414,9 +417,8 @@ void SPIOutput::CombinedLPD8806Control(const DmxBuffer &buffer) {
     return;
 
   for (unsigned int i = 0; i < m_pixel_count; i++) {
-    for (unsigned int j = 0; j < LPD8806_SLOTS_PER_PIXEL; j++) {
-      output[i * LPD8806_SLOTS_PER_PIXEL + j] = 0x80 | (pixel_data[j] >> 1);
-    }
+    memcpy(output + (i * LPD8806_SLOTS_PER_PIXEL), pixel_data,
+           LPD8806_SLOTS_PER_PIXEL);
   }
   m_backend->Commit(m_output_number);
 }
@@ -425,8 +427,8 @@ void SPIOutput::IndividualP9813Control(const DmxBuffer &buffer) {
   // We need 4 bytes of zeros in the beginning and 8 bytes at
   // the end
   const uint8_t latch_bytes = 3 * P9813_SPI_BYTES_PER_PIXEL;
-  const unsigned int first_slot = m_start_address - 1;  // 0 offset
-  if (buffer.Size() - first_slot < P9813_SLOTS_PER_PIXEL) {
+  const unsigned int pixels = min(m_pixel_count, AvailablePixels(buffer));
+  if (!pixels) {
     // not even 3 bytes of data, don't bother updating
     return;
   }
@@ -441,44 +443,31 @@ void SPIOutput::IndividualP9813Control(const DmxBuffer &buffer) {
     return;
   }
 
-  for (unsigned int i = 0; i < m_pixel_count; i++) {
-    // Convert RGB to P9813 Pixel
-    unsigned int offset = first_slot + i * P9813_SLOTS_PER_PIXEL;
-    // We need to avoid the first 4 bytes of the buffer since that acts as a
-    // start of frame delimiter
-    unsigned int spi_offset = (i + 1) * P9813_SPI_BYTES_PER_PIXEL;
-    uint8_t r = 0;
-    uint8_t b = 0;
-    uint8_t g = 0;
-    if (buffer.Size() - offset >= P9813_SLOTS_PER_PIXEL) {
-      r = buffer.Get(offset);
-      g = buffer.Get(offset + 1);
-      b = buffer.Get(offset + 2);
-    }
-    output[spi_offset] = P9813CreateFlag(r, g, b);
-    output[spi_offset + 1] = b;
-    output[spi_offset + 2] = g;
-    output[spi_offset + 3] = r;
+  // We need to avoid the first 4 bytes of the buffer since that acts as a
+  // start of frame delimiter
+  uint8_t *pixel_output = output + P9813_SPI_BYTES_PER_PIXEL;
+  m_encoder.P9813(buffer.GetRaw() + m_start_address - 1, pixels,
+                  pixel_output);
+
+  // Pixels without data are turned off.
+  for (unsigned int i = pixels; i < m_pixel_count; i++) {
+    uint8_t *pixel = pixel_output + i * P9813_SPI_BYTES_PER_PIXEL;
+    pixel[0] = 0xFF;
+    memset(pixel + 1, 0, P9813_SPI_BYTES_PER_PIXEL - 1);
   }
   m_backend->Commit(m_output_number);
 }
 
 void SPIOutput::CombinedP9813Control(const DmxBuffer &buffer) {
   const uint8_t latch_bytes = 3 * P9813_SPI_BYTES_PER_PIXEL;
-  const unsigned int first_slot = m_start_address - 1;  // 0 offset
-
-  if (buffer.Size() - first_slot < P9813_SLOTS_PER_PIXEL) {
+  if (!AvailablePixels(buffer)) {
     OLA_INFO << "Insufficient DMX data, required " << P9813_SLOTS_PER_PIXEL
-             << ", got " << buffer.Size() - first_slot;
+             << ", got " << buffer.Size() - (m_start_address - 1);
     return;
   }
 
   uint8_t pixel_data[P9813_SPI_BYTES_PER_PIXEL];
-  pixel_data[3] = buffer.Get(first_slot);  // Get Red
-  pixel_data[2] = buffer.Get(first_slot + 1);  // Get Green
-  pixel_data[1] = buffer.Get(first_slot + 2);  // Get Blue
-  pixel_data[0] = P9813CreateFlag(pixel_data[3], pixel_data[2],
-                                  pixel_data[1]);
+  m_encoder.P9813(buffer.GetRaw() + m_start_address - 1, 1, pixel_data);
 
   const unsigned int length = m_pixel_count * P9813_SPI_BYTES_PER_PIXEL;
   uint8_t *output = m_backend->Checkout(m_output_number, length, latch_bytes);
@@ -493,19 +482,6 @@ void SPIOutput::CombinedP9813Control(const DmxBuffer &buffer) {
   m_backend->Commit(m_output_number);
 }
 
-/**
- * For more information please visit:
- * https://github.com/CoolNeon/elinux-tcl/blob/master/README.txt
- */
-uint8_t SPIOutput::P9813CreateFlag(uint8_t red, uint8_t green, uint8_t blue) {
-  uint8_t flag = 0;
-  flag =  (red & 0xc0) >> 6;
-  flag |= (green & 0xc0) >> 4;
-  flag |= (blue & 0xc0) >> 2;
-  return ~flag;
-}
-
-
 void SPIOutput::IndividualAPA102Control(const DmxBuffer &buffer) {
   // some detailed information on the protocol:
   // https://cpldcpu.wordpress.com/2014/11/30/understanding-the-apa102-superled/
@@ -514,13 +490,11 @@ void SPIOutput::IndividualAPA102Control(const DmxBuffer &buffer) {
   // LEDFrame: 1 byte FF ; 3 bytes color info (Blue, Green, Red)
   // EndFrame: (n/2)bits; n = pixel_count
 
-  // calculate DMX-start-address
-  const unsigned int first_slot = m_start_address - 1;  // 0 offset
-
   // only do something if at least 1 pixel can be updated..
-  if (buffer.Size() - first_slot < APA102_SLOTS_PER_PIXEL) {
+  const unsigned int pixels = min(m_pixel_count, AvailablePixels(buffer));
+  if (!pixels) {
     OLA_INFO << "Insufficient DMX data, required " << APA102_SLOTS_PER_PIXEL
-             << ", got " << buffer.Size() - first_slot;
+             << ", got " << buffer.Size() - (m_start_address - 1);
     return;
   }
 
@@ -545,34 +519,16 @@ void SPIOutput::IndividualAPA102Control(const DmxBuffer &buffer) {
   if (m_output_number == 0) {
     // set APA102_START_FRAME_BYTES to zero
     memset(output, 0, APA102_START_FRAME_BYTES);
+    // We need to avoid the first 4 bytes of the buffer since that acts as a
+    // start of frame delimiter
+    output += APA102_START_FRAME_BYTES;
   }
 
-  for (uint16_t i = 0; i < m_pixel_count; i++) {
-    // Convert RGB to APA102 Pixel
-    uint16_t offset = first_slot + (i * APA102_SLOTS_PER_PIXEL);
-
+  m_encoder.APA102(buffer.GetRaw() + m_start_address - 1, pixels, output);
 
-    uint16_t spi_offset = (i * APA102_SPI_BYTES_PER_PIXEL);
-    // only skip APA102_START_FRAME_BYTES on the first port!!
-    if (m_output_number == 0) {
-      // We need to avoid the first 4 bytes of the buffer since that acts as a
-      // start of frame delimiter
-      spi_offset += APA102_START_FRAME_BYTES;
-    }
-    // set pixel data
-    // first Byte contains:
-    // 3 bits start mark (111) + 5 bits global brightness
-    // set global brightness fixed to 31 --> that reduces flickering
-    // that can be written as 0xE0 & 0x1F
-    output[spi_offset] = 0xFF;
-    // only write pixel data if buffer has complete data for this pixel:
-    if ((buffer.Size() - offset) >= APA102_SLOTS_PER_PIXEL) {
-      // Convert RGB to APA102 Pixel
-      // skip spi_offset + 0 (is already set)
-      output[spi_offset + 1] = buffer.Get(offset + 2);  // blue
-      output[spi_offset + 2] = buffer.Get(offset + 1);  // green
-      output[spi_offset + 3] = buffer.Get(offset);      // red
-    }
+  // Pixels without data keep their previous colour.
+  for (unsigned int i = pixels; i < m_pixel_count; i++) {
+    output[i * APA102_SPI_BYTES_PER_PIXEL] = 0xFF;
   }
 
   // write output back
@@ -582,13 +538,10 @@ void SPIOutput::IndividualAPA102Control(const DmxBuffer &buffer) {
 void SPIOutput::CombinedAPA102Control(const DmxBuffer &buffer) {
   // for Protocol details see IndividualAPA102Control
 
-  // calculate DMX-start-address
-  const uint16_t first_slot = m_start_address - 1;  // 0 offset
-
   // check if enough data is there.
-  if (buffer.Size() - first_slot < APA102_SLOTS_PER_PIXEL) {
+  if (!AvailablePixels(buffer)) {
     OLA_INFO << "Insufficient DMX data, required " << APA102_SLOTS_PER_PIXEL
-             << ", got " << buffer.Size() - first_slot;
+             << ", got " << buffer.Size() - (m_start_address - 1);
     return;
   }
 
@@ -613,22 +566,16 @@ void SPIOutput::CombinedAPA102Control(const DmxBuffer &buffer) {
   if (m_output_number == 0) {
     // set APA102_START_FRAME_BYTES to zero
     memset(output, 0, APA102_START_FRAME_BYTES);
+    output += APA102_START_FRAME_BYTES;
   }
 
   // create Pixel Data
   uint8_t pixel_data[APA102_SPI_BYTES_PER_PIXEL];
-  pixel_data[0] = 0xFF;
-  pixel_data[1] = buffer.Get(first_slot + 2);  // Get Blue
-  pixel_data[2] = buffer.Get(first_slot + 1);  // Get Green
-  pixel_data[3] = buffer.Get(first_slot);      // Get Red
+  m_encoder.APA102(buffer.GetRaw() + m_start_address - 1, 1, pixel_data);
 
   // set all pixel to same value
   for (uint16_t i = 0; i < m_pixel_count; i++) {
-    uint16_t spi_offset = (i * APA102_SPI_BYTES_PER_PIXEL);
-    if (m_output_number == 0) {
-      spi_offset += APA102_START_FRAME_BYTES;
-    }
-    memcpy(&output[spi_offset], pixel_data,
+    memcpy(&output[i * APA102_SPI_BYTES_PER_PIXEL], pixel_data,
            APA102_SPI_BYTES_PER_PIXEL);
   }
 
@@ -31,6 +31,7 @@
 #include "ola/rdm/ResponderOps.h"
 #include "ola/rdm/ResponderPersonality.h"
 #include "ola/rdm/ResponderSensor.h"
+#include "plugins/spi/PixelEncoder.h"
 
 namespace ola {
 namespace plugin {
@@ -42,6 +43,7 @@ class SPIOutput: public ola::rdm::DiscoverableRDMControllerInterface {
     std::string device_label;
     uint8_t pixel_count;
     uint8_t output_number;
+    PixelEncoder::Options encoder_options;
 
     explicit Options(uint8_t output_number, const std::string &spi_device_name)
         : device_label("SPI Device - " + spi_device_name),
@@ -62,6 +64,9 @@ class SPIOutput: public ola::rdm::DiscoverableRDMControllerInterface {
   uint16_t GetStartAddress() const;
   bool SetStartAddress(uint16_t start_address);
   unsigned int PixelCount() const { return m_pixel_count; }
+  const PixelEncoder::Options &EncoderOptions() const {
+    return m_encoder.GetOptions();
+  }
 
   std::string Description() const;
   bool WriteDMX(const DmxBuffer &buffer);
@@ -94,6 +99,7 @@ class SPIOutput: public ola::rdm::DiscoverableRDMControllerInterface {
   std::string m_spi_device_name;
   const ola::rdm::UID m_uid;
   const unsigned int m_pixel_count;
+  const PixelEncoder m_encoder;
   std::string m_device_label;
   uint16_t m_start_address;  // starts from 1
   bool m_identify_mode;
@@ -116,6 +122,7 @@ class SPIOutput: public ola::rdm::DiscoverableRDMControllerInterface {
 
   unsigned int LPD8806BufferSize() const;
   void WriteSPIData(const uint8_t *data, unsigned int length);
+  unsigned int AvailablePixels(const DmxBuffer &buffer) const;
 
   // RDM methods
   ola::rdm::RDMResponse *GetDeviceInfo(
@@ -172,7 +179,6 @@ class SPIOutput: public ola::rdm::DiscoverableRDMControllerInterface {
       const ola::rdm::RDMRequest *request);
 
   // Helpers
-  uint8_t P9813CreateFlag(uint8_t red, uint8_t green, uint8_t blue);
   static uint8_t CalculateAPA102LatchBytes(uint16_t pixel_count);
 
   static const uint8_t SPI_MODE;
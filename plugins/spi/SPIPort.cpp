@@ -18,6 +18,7 @@
  * Copyright (C) 2013 Simon Newton
  */
 
+#include <sstream>
 #include <string>
 #include "ola/Constants.h"
 #include "ola/rdm/RDMCommand.h"
@@ -72,6 +73,10 @@ unsigned int SPIOutputPort::PixelCount() const {
   return m_spi_output.PixelCount();
 }
 
+const PixelEncoder::Options &SPIOutputPort::EncoderOptions() const {
+  return m_spi_output.EncoderOptions();
+}
+
 string SPIOutputPort::Description() const {
   return m_spi_output.Description();
 }
@@ -92,6 +97,32 @@ void SPIOutputPort::SendRDMRequest(ola::rdm::RDMRequest *request,
                                    ola::rdm::RDMCallback *callback) {
   return m_spi_output.SendRDMRequest(request, callback);
 }
+
+
+SPIChainPort::SPIChainPort(SPIDevice *parent, SPIChainOutput *chain,
+                           unsigned int segment)
+    : BasicOutputPort(parent, segment),
+      m_chain(chain),
+      m_segment(segment) {
+}
+
+string SPIChainPort::Description() const {
+  std::ostringstream str;
+  const unsigned int pixels = m_chain->SegmentPixels(m_segment);
+  str << SPIChainOutput::PixelTypeToString(m_chain->GetPixelType())
+      << " chain, universe " << m_segment + 1 << " of "
+      << m_chain->Universes();
+  if (pixels) {
+    const unsigned int first_pixel =
+        m_segment * SPIChainOutput::PIXELS_PER_UNIVERSE;
+    str << ", pixels " << first_pixel + 1 << " - " << first_pixel + pixels;
+  }
+  return str.str();
+}
+
+bool SPIChainPort::WriteDMX(const DmxBuffer &buffer, uint8_t) {
+  return m_chain->WriteDMX(m_segment, buffer);
+}
 }  // namespace spi
 }  // namespace plugin
 }  // namespace ola
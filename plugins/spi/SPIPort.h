@@ -24,6 +24,7 @@
 #include <string>
 #include "ola/DmxBuffer.h"
 #include "olad/Port.h"
+#include "plugins/spi/SPIChainOutput.h"
 #include "plugins/spi/SPIDevice.h"
 #include "plugins/spi/SPIOutput.h"
 
@@ -44,6 +45,7 @@ class SPIOutputPort: public BasicOutputPort {
   uint16_t GetStartAddress() const;
   bool SetStartAddress(uint16_t start_address);
   unsigned int PixelCount() const;
+  const PixelEncoder::Options &EncoderOptions() const;
 
   std::string Description() const;
   bool WriteDMX(const DmxBuffer &buffer, uint8_t priority);
@@ -56,6 +58,23 @@ class SPIOutputPort: public BasicOutputPort {
  private:
   SPIOutput m_spi_output;
 };
+
+/**
+ * An output port for one universe of a SPIChainOutput.
+ */
+class SPIChainPort: public BasicOutputPort {
+ public:
+  SPIChainPort(SPIDevice *parent, SPIChainOutput *chain,
+               unsigned int segment);
+  ~SPIChainPort() {}
+
+  std::string Description() const;
+  bool WriteDMX(const DmxBuffer &buffer, uint8_t priority);
+
+ private:
+  SPIChainOutput *m_chain;
+  const unsigned int m_segment;
+};
 }  // namespace spi
 }  // namespace plugin
 }  // namespace ola
@@ -54,17 +54,17 @@ SPIWriter::SPIWriter(const string &spi_device,
       m_spi_speed(options.spi_speed),
       m_cs_enable_high(options.cs_enable_high),
       m_fd(-1),
-      m_error_map_var(NULL),
-      m_write_map_var(NULL) {
+      m_error_count(NULL),
+      m_write_count(NULL) {
   OLA_INFO << "Created SPI Writer " << spi_device << " with speed "
            << options.spi_speed << ", CE is " << m_cs_enable_high;
   if (export_map) {
-    m_error_map_var = export_map->GetUIntMapVar(SPI_ERROR_VAR,
-                                                SPI_DEVICE_KEY);
-    (*m_error_map_var)[m_device_path] = 0;
-    m_write_map_var = export_map->GetUIntMapVar(SPI_WRITE_VAR,
-                                                SPI_DEVICE_KEY);
-    (*m_write_map_var)[m_device_path] = 0;
+    m_error_count = export_map->GetUIntMapVar(
+        SPI_ERROR_VAR, SPI_DEVICE_KEY)->Handle(m_device_path);
+    *m_error_count = 0;
+    m_write_count = export_map->GetUIntMapVar(
+        SPI_WRITE_VAR, SPI_DEVICE_KEY)->Handle(m_device_path);
+    *m_write_count = 0;
   }
 }
 
@@ -110,15 +110,15 @@ bool SPIWriter::WriteSPIData(const uint8_t *data, unsigned int length) {
   spi.tx_buf = reinterpret_cast<__u64>(data);
   spi.len = length;
 
-  if (m_write_map_var) {
-    (*m_write_map_var)[m_device_path]++;
+  if (m_write_count) {
+    (*m_write_count)++;
   }
 
   int bytes_written = ioctl(m_fd, SPI_IOC_MESSAGE(1), &spi);
   if (bytes_written != static_cast<int>(length)) {
     OLA_WARN << "Failed to write all the SPI data: " << strerror(errno);
-    if (m_error_map_var) {
-      (*m_error_map_var)[m_device_path]++;
+    if (m_error_count) {
+      (*m_error_count)++;
     }
     return false;
   }
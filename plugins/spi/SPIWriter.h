@@ -76,8 +76,8 @@ class SPIWriter : public SPIWriterInterface {
   const uint32_t m_spi_speed;
   const bool m_cs_enable_high;
   int m_fd;
-  UIntMap *m_error_map_var;
-  UIntMap *m_write_map_var;
+  unsigned int *m_error_count;
+  unsigned int *m_write_count;
 
   static const uint8_t SPI_MODE;
   static const uint8_t SPI_BITS_PER_WORD;
@@ -0,0 +1,181 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * pixel_encoder_benchmark.cpp
+ * Measure the cost of encoding pixel strings for each SPI chip.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <stdint.h>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+#include "ola/Clock.h"
+#include "ola/DmxBuffer.h"
+#include "ola/base/Flags.h"
+#include "ola/base/Init.h"
+#include "plugins/spi/PixelEncoder.h"
+
+using ola::Clock;
+using ola::DmxBuffer;
+using ola::TimeInterval;
+using ola::TimeStamp;
+using ola::plugin::spi::PixelEncoder;
+using ola::plugin::spi::PixelKernel;
+using std::cout;
+using std::endl;
+using std::vector;
+
+DEFINE_s_uint32(iterations, i, 10000, "Number of frames per measurement");
+
+typedef void (PixelEncoder::*EncodeMethod)(const uint8_t *input,
+                                           unsigned int pixels,
+                                           uint8_t *output) const;
+
+/**
+ * Return the number of microseconds each frame took.
+ */
+double MicroSecondsPerFrame(const Clock &clock,
+                            const TimeStamp &start,
+                            unsigned int iterations) {
+  TimeStamp end;
+  clock.CurrentTime(&end);
+  TimeInterval elapsed = end - start;
+  return static_cast<double>(elapsed.AsInt()) / iterations;
+}
+
+/**
+ * Encode the string a pixel at a time from DmxBuffers, the way SPIOutput used
+ * to with the bounds checked DmxBuffer::Get().
+ */
+double BenchmarkDmxBufferGet(const Clock &clock, const vector<DmxBuffer> &data,
+                             unsigned int pixels, unsigned int iterations) {
+  vector<uint8_t> output(pixels * 4);
+  TimeStamp start;
+  clock.CurrentTime(&start);
+  for (unsigned int i = 0; i < iterations; i++) {
+    for (unsigned int j = 0; j < pixels; j++) {
+      const DmxBuffer &buffer = data[j / 170];
+      unsigned int offset = (j % 170) * 3;
+      output[j * 4] = 0xFF;
+      output[j * 4 + 1] = buffer.Get(offset + 2);
+      output[j * 4 + 2] = buffer.Get(offset + 1);
+      output[j * 4 + 3] = buffer.Get(offset);
+    }
+  }
+  return MicroSecondsPerFrame(clock, start, iterations);
+}
+
+double BenchmarkEncoder(const Clock &clock, const PixelEncoder &encoder,
+                        EncodeMethod method, const vector<uint8_t> &input,
+                        unsigned int pixels, unsigned int iterations) {
+  vector<uint8_t> output(pixels * 4);
+  TimeStamp start;
+  clock.CurrentTime(&start);
+  for (unsigned int i = 0; i < iterations; i++) {
+    (encoder.*method)(&input[0], pixels, &output[0]);
+  }
+  return MicroSecondsPerFrame(clock, start, iterations);
+}
+
+int main(int argc, char *argv[]) {
+  ola::AppInit(&argc, argv, "",
+               "Measure the cost of encoding SPI pixel strings.");
+
+  const unsigned int iterations = FLAGS_iterations;
+  if (!iterations) {
+    return -1;
+  }
+
+  const unsigned int pixel_counts[] = {170, 680, 2720};
+  const unsigned int max_pixels = 2720;
+
+  vector<uint8_t> input(max_pixels * 3);
+  for (unsigned int i = 0; i < input.size(); i++) {
+    input[i] = (i * 7) % 256;
+  }
+  vector<DmxBuffer> buffers((max_pixels + 169) / 170);
+  for (unsigned int i = 0; i < buffers.size(); i++) {
+    buffers[i].Set(&input[i * 510], 510);
+  }
+
+  const PixelKernel kernels[] = {
+    ola::plugin::spi::PIXEL_KERNEL_SCALAR,
+    ola::plugin::spi::PIXEL_KERNEL_SSSE3,
+    ola::plugin::spi::PIXEL_KERNEL_NEON,
+  };
+  const unsigned int kernel_count = sizeof(kernels) / sizeof(kernels[0]);
+
+  struct {
+    const char *name;
+    EncodeMethod method;
+  } chips[] = {
+    {"WS2801", &PixelEncoder::WS2801},
+    {"LPD8806", &PixelEncoder::LPD8806},
+    {"P9813", &PixelEncoder::P9813},
+    {"APA102", &PixelEncoder::APA102},
+  };
+
+  PixelEncoder::Options options;
+  options.color_order = PixelEncoder::GRB;
+  PixelEncoder::Options table_options(options);
+  table_options.gamma = 22;
+  PixelEncoder table_encoder(table_options);
+
+  Clock clock;
+  cout << "Active kernel: "
+       << ola::plugin::spi::PixelKernelName(
+           ola::plugin::spi::ActivePixelKernel())
+       << endl;
+  cout << "us per frame, " << iterations << " iterations, GRB input" << endl;
+  cout << std::fixed << std::setprecision(2);
+
+  for (unsigned int c = 0; c < sizeof(chips) / sizeof(chips[0]); c++) {
+    cout << chips[c].name << endl;
+    cout << std::setw(8) << "pixels";
+    if (chips[c].method == &PixelEncoder::APA102) {
+      cout << std::setw(10) << "Get()";
+    }
+    for (unsigned int k = 0; k < kernel_count; k++) {
+      if (ola::plugin::spi::PixelKernelSupported(kernels[k])) {
+        cout << std::setw(10) << ola::plugin::spi::PixelKernelName(kernels[k]);
+      }
+    }
+    cout << std::setw(10) << "gamma" << endl;
+
+    for (unsigned int p = 0; p < sizeof(pixel_counts) / sizeof(pixel_counts[0]);
+         p++) {
+      const unsigned int pixels = pixel_counts[p];
+      cout << std::setw(8) << pixels;
+      if (chips[c].method == &PixelEncoder::APA102) {
+        cout << std::setw(10)
+             << BenchmarkDmxBufferGet(clock, buffers, pixels, iterations);
+      }
+      for (unsigned int k = 0; k < kernel_count; k++) {
+        PixelEncoder encoder(options);
+        if (encoder.SetKernel(kernels[k])) {
+          cout << std::setw(10)
+               << BenchmarkEncoder(clock, encoder, chips[c].method, input,
+                                   pixels, iterations);
+        }
+      }
+      cout << std::setw(10)
+           << BenchmarkEncoder(clock, table_encoder, chips[c].method, input,
+                               pixels, iterations)
+           << endl;
+    }
+  }
+  return 0;
+}
@@ -16,8 +16,6 @@ plugins_uartdmx_libolauartdmx_la_SOURCES = \
     plugins/uartdmx/UartDmxPlugin.cpp \
     plugins/uartdmx/UartDmxPlugin.h \
     plugins/uartdmx/UartDmxPort.h \
-    plugins/uartdmx/UartDmxThread.cpp \
-    plugins/uartdmx/UartDmxThread.h \
     plugins/uartdmx/UartWidget.cpp \
     plugins/uartdmx/UartWidget.h
 plugins_uartdmx_libolauartdmx_la_LIBADD = \
@@ -41,11 +41,13 @@ const unsigned int UartDmxDevice::DEFAULT_MALF = 100;
 UartDmxDevice::UartDmxDevice(AbstractPlugin *owner,
                              class Preferences *preferences,
                              const string &name,
-                             const string &path)
+                             const string &path,
+                             ola::dmx::FrameScheduler *scheduler)
     : Device(owner, name),
       m_preferences(preferences),
       m_name(name),
-      m_path(path) {
+      m_path(path),
+      m_scheduler(scheduler) {
   // set up some per-device default configuration if not already set
   SetDefaults();
   // now read per-device configuration
@@ -67,7 +69,8 @@ UartDmxDevice::~UartDmxDevice() {
 }
 
 bool UartDmxDevice::StartHook() {
-  AddPort(new UartDmxOutputPort(this, 0, m_widget.get(), m_breakt, m_malft));
+  AddPort(new UartDmxOutputPort(this, 0, m_widget.get(), m_breakt, m_malft,
+                                m_scheduler));
   return true;
 }
 
@@ -26,6 +26,7 @@
 #include <sstream>
 #include <memory>
 #include "ola/DmxBuffer.h"
+#include "ola/dmx/FrameScheduler.h"
 #include "olad/Device.h"
 #include "olad/Preferences.h"
 #include "plugins/uartdmx/UartWidget.h"
@@ -39,7 +40,8 @@ class UartDmxDevice : public Device {
   UartDmxDevice(AbstractPlugin *owner,
                 class Preferences *preferences,
                 const std::string &name,
-                const std::string &path);
+                const std::string &path,
+                ola::dmx::FrameScheduler *scheduler);
   ~UartDmxDevice();
 
   std::string DeviceId() const { return m_path; }
@@ -60,6 +62,7 @@ class UartDmxDevice : public Device {
   const std::string m_path;
   unsigned int m_breakt;
   unsigned int m_malft;
+  ola::dmx::FrameScheduler *m_scheduler;
 
   static const unsigned int DEFAULT_MALF;
   static const char K_MALF[];
@@ -44,7 +44,9 @@ using std::vector;
 
 const char UartDmxPlugin::PLUGIN_NAME[] = "UART native DMX";
 const char UartDmxPlugin::PLUGIN_PREFIX[] = "uartdmx";
+const char UartDmxPlugin::K_CPU[] = "cpu";
 const char UartDmxPlugin::K_DEVICE[] = "device";
+const char UartDmxPlugin::K_REALTIME_PRIORITY[] = "realtime_priority";
 const char UartDmxPlugin::DEFAULT_DEVICE[] = "/dev/ttyACM0";
 
 /*
@@ -55,6 +57,19 @@ bool UartDmxPlugin::StartHook() {
   vector<string> devices = m_preferences->GetMultipleValue(K_DEVICE);
   vector<string>::const_iterator iter;  // iterate over devices
 
+  // All the devices share one thread to generate the frames.
+  ola::dmx::FrameScheduler::Options options;
+  options.realtime_priority = StringToIntOrDefault(
+      m_preferences->GetValue(K_REALTIME_PRIORITY), 0u);
+  options.cpu = StringToIntOrDefault(m_preferences->GetValue(K_CPU), -1);
+  m_scheduler.reset(new ola::dmx::FrameScheduler(
+      options, m_plugin_adaptor->GetExportMap()));
+  if (!m_scheduler->Start()) {
+    OLA_WARN << "Failed to start the UART frame thread";
+    m_scheduler.reset();
+    return false;
+  }
+
   // start counting device ids from 0
 
   for (iter = devices.begin(); iter != devices.end(); ++iter) {
@@ -75,7 +90,7 @@ bool UartDmxPlugin::StartHook() {
     // can open device, so shut the temporary file descriptor
     close(fd);
     std::auto_ptr<UartDmxDevice> device(new UartDmxDevice(
-        this, m_preferences, PLUGIN_NAME, *iter));
+        this, m_preferences, PLUGIN_NAME, *iter, m_scheduler.get()));
 
     // got a device, now lets see if we can configure it before we announce
     // it to the world
@@ -108,6 +123,11 @@ bool UartDmxPlugin::StopHook() {
     delete *iter;
   }
   m_devices.clear();
+
+  if (m_scheduler.get()) {
+    m_scheduler->Stop();
+    m_scheduler.reset();
+  }
   return true;
 }
 
@@ -131,6 +151,9 @@ bool UartDmxPlugin::SetDefaultPreferences() {
   // only insert default device name, no others at this stage
   bool save = m_preferences->SetDefaultValue(K_DEVICE, StringValidator(),
                                              DEFAULT_DEVICE);
+  save |= m_preferences->SetDefaultValue(K_REALTIME_PRIORITY,
+                                         UIntValidator(0, 99), 0);
+  save |= m_preferences->SetDefaultValue(K_CPU, IntValidator(-1, 1023), -1);
   if (save) {
     m_preferences->Save();
   }
@@ -22,11 +22,13 @@
 #ifndef PLUGINS_UARTDMX_UARTDMXPLUGIN_H_
 #define PLUGINS_UARTDMX_UARTDMXPLUGIN_H_
 
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
 
 #include "olad/Plugin.h"
+#include "ola/dmx/FrameScheduler.h"
 #include "ola/plugin_id.h"
 
 #include "plugins/uartdmx/UartDmxDevice.h"
@@ -52,6 +54,7 @@ class UartDmxPlugin : public Plugin {
  private:
   typedef std::vector<UartDmxDevice*> UartDeviceVector;
   UartDeviceVector m_devices;
+  std::auto_ptr<ola::dmx::FrameScheduler> m_scheduler;
 
   void AddDevice(UartDmxDevice *device);
   bool StartHook();
@@ -62,7 +65,9 @@ class UartDmxPlugin : public Plugin {
 
   static const char PLUGIN_NAME[];
   static const char PLUGIN_PREFIX[];
+  static const char K_CPU[];
   static const char K_DEVICE[];
+  static const char K_REALTIME_PRIORITY[];
   static const char DEFAULT_DEVICE[];
 
   DISALLOW_COPY_AND_ASSIGN(UartDmxPlugin);
@@ -25,11 +25,11 @@
 #include <string>
 
 #include "ola/DmxBuffer.h"
+#include "ola/dmx/FrameScheduler.h"
 #include "olad/Port.h"
 #include "olad/Preferences.h"
 #include "plugins/uartdmx/UartDmxDevice.h"
 #include "plugins/uartdmx/UartWidget.h"
-#include "plugins/uartdmx/UartDmxThread.h"
 
 namespace ola {
 namespace plugin {
@@ -41,23 +41,30 @@ class UartDmxOutputPort : public ola::BasicOutputPort {
                     unsigned int id,
                     UartWidget *widget,
                     unsigned int breakt,
-                    unsigned int malft)
+                    unsigned int malft,
+                    ola::dmx::FrameScheduler *scheduler)
       : BasicOutputPort(parent, id),
         m_widget(widget),
-        m_thread(widget, breakt, malft) {
-    m_thread.Start();
+        m_scheduler(scheduler) {
+    ola::dmx::FrameScheduler::PortOptions options;
+    options.name = widget->Name();
+    options.break_time = breakt;
+    options.mark_after_frame = malft;
+    m_port = m_scheduler->AddPort(widget, options);
   }
-  ~UartDmxOutputPort() { m_thread.Stop(); }
+  ~UartDmxOutputPort() { m_scheduler->RemovePort(m_port); }
 
   bool WriteDMX(const ola::DmxBuffer &buffer, uint8_t) {
-    return m_thread.WriteDMX(buffer);
+    m_scheduler->WriteDMX(m_port, buffer);
+    return true;
   }
 
   std::string Description() const { return m_widget->Description(); }
 
  private:
   UartWidget *m_widget;
-  UartDmxThread m_thread;
+  ola::dmx::FrameScheduler *m_scheduler;
+  ola::dmx::FrameScheduler::Port *m_port;
 
   DISALLOW_COPY_AND_ASSIGN(UartDmxOutputPort);
 };
@@ -35,6 +35,7 @@
 #include <vector>
 #include "ola/base/Macro.h"
 #include "ola/DmxBuffer.h"
+#include "ola/dmx/FrameScheduler.h"
 
 namespace ola {
 namespace plugin {
@@ -43,7 +44,7 @@ namespace uartdmx {
 /**
  * An UART widget (i.e. a serial port with suitable hardware attached)
  */
-class UartWidget {
+class UartWidget : public ola::dmx::SerialDmxOutput {
  public:
     /**
      * Construct a new UartWidget instance for one widget.
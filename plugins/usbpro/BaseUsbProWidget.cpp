@@ -86,9 +86,9 @@ bool BaseUsbProWidget::SendDMX(const DmxBuffer &buffer) {
   widget_dmx.start_code = DMX512_START_CODE;
   unsigned int length = DMX_UNIVERSE_SIZE;
   buffer.Get(widget_dmx.dmx, &length);
-  return SendMessage(DMX_LABEL,
-                     reinterpret_cast<uint8_t*>(&widget_dmx),
-                     length + 1);
+  return SendDMXMessage(DMX_LABEL,
+                        reinterpret_cast<uint8_t*>(&widget_dmx),
+                        length + 1);
 }
 
 
@@ -99,6 +99,33 @@ bool BaseUsbProWidget::SendDMX(const DmxBuffer &buffer) {
 bool BaseUsbProWidget::SendMessage(uint8_t label,
                                    const uint8_t *data,
                                    unsigned int length) const {
+  return SendFrame(label, data, length, false);
+}
+
+
+/*
+ * Send a DMX msg, this may be superseded by a later one with the same label.
+ * @return true if successful, false otherwise
+ */
+bool BaseUsbProWidget::SendDMXMessage(uint8_t label,
+                                      const uint8_t *data,
+                                      unsigned int length) const {
+  return SendFrame(label, data, length, true);
+}
+
+
+void BaseUsbProWidget::SetWriter(WidgetWriter *writer) {
+  m_writer.reset(writer);
+}
+
+
+/*
+ * Frame the msg and either hand it to the writer or send it directly.
+ */
+bool BaseUsbProWidget::SendFrame(uint8_t label,
+                                 const uint8_t *data,
+                                 unsigned int length,
+                                 bool is_dmx) const {
   if (length && !data)
     return false;
 
@@ -113,6 +140,11 @@ bool BaseUsbProWidget::SendMessage(uint8_t label,
   memcpy(frame + sizeof(message_header), data, length);
   frame[frame_size - 1] = EOM;
 
+  if (m_writer.get()) {
+    return is_dmx ? m_writer->SendDMX(label, frame, frame_size) :
+        m_writer->SendMessage(frame, frame_size);
+  }
+
   ssize_t bytes_sent = m_descriptor->Send(frame, frame_size);
   if (bytes_sent != frame_size)
     // we've probably screwed framing at this point
@@ -23,11 +23,13 @@
 #define PLUGINS_USBPRO_BASEUSBPROWIDGET_H_
 
 #include <stdint.h>
+#include <memory>
 #include <string>
 #include "ola/Callback.h"
 #include "ola/DmxBuffer.h"
 #include "ola/io/Descriptor.h"
 #include "plugins/usbpro/SerialWidgetInterface.h"
+#include "plugins/usbpro/WidgetWriter.h"
 
 namespace ola {
 namespace plugin {
@@ -54,6 +56,21 @@ class BaseUsbProWidget: public SerialWidgetInterface {
                    const uint8_t *data,
                    unsigned int length) const;
 
+  /*
+   * Send a DMX message. Unlike SendMessage, if there is a WidgetWriter and the
+   * previous message with this label hasn't been written yet, it's replaced.
+   */
+  bool SendDMXMessage(uint8_t label,
+                      const uint8_t *data,
+                      unsigned int length) const;
+
+  /*
+   * Set the WidgetWriter used to send messages, ownership is transferred.
+   * Without one, messages are written to the descriptor directly. This must
+   * be reset to NULL before the descriptor is closed.
+   */
+  void SetWriter(WidgetWriter *writer);
+
   static ola::io::ConnectedDescriptor *OpenDevice(const std::string &path);
 
   static const uint8_t DEVICE_LABEL = 78;
@@ -83,12 +100,15 @@ class BaseUsbProWidget: public SerialWidgetInterface {
   } message_header;
 
   ola::io::ConnectedDescriptor *m_descriptor;
+  std::auto_ptr<WidgetWriter> m_writer;
   receive_state m_state;
   unsigned int m_bytes_received;
   message_header m_header;
   uint8_t m_recv_buffer[MAX_DATA_SIZE];
 
   void ReceiveMessage();
+  bool SendFrame(uint8_t label, const uint8_t *data, unsigned int length,
+                 bool is_dmx) const;
   virtual void HandleMessage(uint8_t label,
                              const uint8_t *data,
                              unsigned int length) = 0;
@@ -31,6 +31,7 @@
 #include "ola/network/NetworkUtils.h"
 #include "plugins/usbpro/BaseUsbProWidget.h"
 #include "plugins/usbpro/CommonWidgetTest.h"
+#include "plugins/usbpro/WidgetWriter.h"
 
 
 using ola::DmxBuffer;
@@ -42,6 +43,7 @@ class BaseUsbProWidgetTest: public CommonWidgetTest {
   CPPUNIT_TEST_SUITE(BaseUsbProWidgetTest);
   CPPUNIT_TEST(testSend);
   CPPUNIT_TEST(testSendDMX);
+  CPPUNIT_TEST(testSendWithWriter);
   CPPUNIT_TEST(testReceive);
   CPPUNIT_TEST(testRemove);
   CPPUNIT_TEST_SUITE_END();
@@ -51,6 +53,7 @@ class BaseUsbProWidgetTest: public CommonWidgetTest {
 
     void testSend();
     void testSendDMX();
+    void testSendWithWriter();
     void testReceive();
     void testRemove();
 
@@ -205,6 +208,34 @@ void BaseUsbProWidgetTest::testSendDMX() {
 }
 
 
+/**
+ * Check messages are sent via the WidgetWriter
+ */
+void BaseUsbProWidgetTest::testSendWithWriter() {
+  ola::plugin::usbpro::WidgetWriter::Options options;
+  m_widget->SetWriter(new ola::plugin::usbpro::WidgetWriter(
+      &m_ss, &m_descriptor, options));
+
+  uint8_t expected[] = {0x7e, 0x0a, 0, 0, 0xe7};
+  m_endpoint->AddExpectedData(expected, sizeof(expected));
+  OLA_ASSERT(m_widget->SendMessage(10, NULL, 0));
+
+  DmxBuffer buffer;
+  buffer.SetFromString("0,1,2,3,4");
+  uint8_t dmx_frame_data[] = {ola::DMX512_START_CODE, 0, 1, 2, 3, 4};
+  m_endpoint->AddExpectedUsbProMessage(
+      DMX_FRAME_LABEL,
+      dmx_frame_data,
+      sizeof(dmx_frame_data),
+      ola::NewSingleCallback(this, &BaseUsbProWidgetTest::Terminate));
+  OLA_ASSERT(m_widget->SendDMX(buffer));
+  m_ss.Run();
+  m_endpoint->Verify();
+
+  m_widget->SetWriter(NULL);
+}
+
+
 /*
  * Test receiving works.
  */
@@ -93,8 +93,10 @@ OperationLabels OperationLabels::Port2Operations() {
 }
 
 EnttecPortImpl::EnttecPortImpl(const OperationLabels &ops, const UID &uid,
-                               SendCallback *send_cb)
+                               SendCallback *send_cb,
+                               SendCallback *send_dmx_cb)
     : m_send_cb(send_cb),
+      m_send_dmx_cb(send_dmx_cb),
       m_ops(ops),
       m_active(true),
       m_watchdog(WATCHDOG_LIMIT,
@@ -140,8 +142,9 @@ bool EnttecPortImpl::SendDMX(const DmxBuffer &buffer) {
   widget_dmx.start_code = DMX512_START_CODE;
   unsigned int length = DMX_UNIVERSE_SIZE;
   buffer.Get(widget_dmx.dmx, &length);
-  return m_send_cb->Run(m_ops.send_dmx, reinterpret_cast<uint8_t*>(&widget_dmx),
-                        length + 1);
+  return m_send_dmx_cb->Run(m_ops.send_dmx,
+                            reinterpret_cast<uint8_t*>(&widget_dmx),
+                            length + 1);
 }
 
 
@@ -730,6 +733,8 @@ class EnttecUsbProWidgetImpl : public BaseUsbProWidget {
     EnttecPort *GetPort(unsigned int i);
 
     bool SendCommand(uint8_t label, const uint8_t *data, unsigned int length);
+    bool SendDMXCommand(uint8_t label, const uint8_t *data,
+                        unsigned int length);
 
  private:
     typedef vector<EnttecUsbProWidget::EnttecUsbProPortAssignmentCallback*>
@@ -741,6 +746,7 @@ class EnttecUsbProWidgetImpl : public BaseUsbProWidget {
     vector<EnttecPort*> m_ports;
     vector<EnttecPortImpl*> m_port_impls;
     auto_ptr<EnttecPortImpl::SendCallback> m_send_cb;
+    auto_ptr<EnttecPortImpl::SendCallback> m_send_dmx_cb;
     UID m_uid;
     PortAssignmentCallbacks m_port_assignment_callbacks;
 
@@ -773,6 +779,8 @@ EnttecUsbProWidgetImpl::EnttecUsbProWidgetImpl(
       m_scheduler(scheduler),
       m_watchdog_timer_id(ola::thread::INVALID_TIMEOUT),
       m_send_cb(NewCallback(this, &EnttecUsbProWidgetImpl::SendCommand)),
+      m_send_dmx_cb(
+          NewCallback(this, &EnttecUsbProWidgetImpl::SendDMXCommand)),
       m_uid(options.esta_id ? options.esta_id :
                               EnttecUsbProWidget::ENTTEC_ESTA_ID,
             options.serial) {
@@ -816,6 +824,8 @@ void EnttecUsbProWidgetImpl::GetPortAssignments(
  * Stop this widget
  */
 void EnttecUsbProWidgetImpl::Stop() {
+  SetWriter(NULL);
+
   if (m_watchdog_timer_id != ola::thread::INVALID_TIMEOUT) {
     m_scheduler->RemoveTimeout(m_watchdog_timer_id);
     m_watchdog_timer_id = ola::thread::INVALID_TIMEOUT;
@@ -856,6 +866,16 @@ bool EnttecUsbProWidgetImpl::SendCommand(uint8_t label, const uint8_t *data,
 }
 
 
+/**
+ * Send a DMX frame to the widget
+ */
+bool EnttecUsbProWidgetImpl::SendDMXCommand(uint8_t label,
+                                            const uint8_t *data,
+                                            unsigned int length) {
+  return SendDMXMessage(label, data, length);
+}
+
+
 /*
  * Handle a message received from the widget
  */
@@ -922,7 +942,8 @@ void EnttecUsbProWidgetImpl::HandlePortAssignment(const uint8_t *data,
 void EnttecUsbProWidgetImpl::AddPort(const OperationLabels &ops,
                                      unsigned int queue_size,
                                      bool enable_rdm) {
-  EnttecPortImpl *impl = new EnttecPortImpl(ops, m_uid, m_send_cb.get());
+  EnttecPortImpl *impl = new EnttecPortImpl(ops, m_uid, m_send_cb.get(),
+                                            m_send_dmx_cb.get());
   m_port_impls.push_back(impl);
   EnttecPort *port = new EnttecPort(impl, queue_size, enable_rdm);
   m_ports.push_back(port);
@@ -985,6 +1006,10 @@ EnttecPort *EnttecUsbProWidget::GetPort(unsigned int i) {
 ola::io::ConnectedDescriptor *EnttecUsbProWidget::GetDescriptor() const {
   return m_impl->GetDescriptor();
 }
+
+void EnttecUsbProWidget::SetWriter(WidgetWriter *writer) {
+  m_impl->SetWriter(writer);
+}
 }  // namespace usbpro
 }  // namespace plugin
 }  // namespace ola
@@ -127,6 +127,9 @@ class EnttecUsbProWidget: public SerialWidgetInterface {
     EnttecPort *GetPort(unsigned int i);
     ola::io::ConnectedDescriptor *GetDescriptor() const;
 
+    // See BaseUsbProWidget::SetWriter().
+    void SetWriter(WidgetWriter *writer);
+
     static const uint16_t ENTTEC_ESTA_ID;
 
  private:
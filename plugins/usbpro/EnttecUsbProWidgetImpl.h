@@ -85,8 +85,9 @@ class EnttecPortImpl
     typedef ola::Callback3<bool, uint8_t, const uint8_t*, unsigned int>
       SendCallback;
 
+    // DMX frames are sent with send_dmx_cb, everything else with send_cb.
     EnttecPortImpl(const OperationLabels &ops, const ola::rdm::UID &uid,
-                   SendCallback *send_cb);
+                   SendCallback *send_cb, SendCallback *send_dmx_cb);
 
     void Stop();
 
@@ -123,6 +124,7 @@ class EnttecPortImpl
 
  private:
   SendCallback *m_send_cb;
+  SendCallback *m_send_dmx_cb;
   OperationLabels m_ops;
   bool m_active;
   Watchdog m_watchdog;
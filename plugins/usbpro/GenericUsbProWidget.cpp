@@ -66,6 +66,7 @@ void GenericUsbProWidget::SetDMXCallback(ola::Callback0<void> *callback) {
  */
 void GenericUsbProWidget::GenericStop() {
   m_active = false;
+  SetWriter(NULL);
 
   if (m_dmx_callback) {
     delete m_dmx_callback;
@@ -32,7 +32,9 @@ plugins_usbpro_libolausbprowidget_la_SOURCES = \
     plugins/usbpro/UsbProWidgetDetector.h \
     plugins/usbpro/WidgetDetectorInterface.h \
     plugins/usbpro/WidgetDetectorThread.cpp \
-    plugins/usbpro/WidgetDetectorThread.h
+    plugins/usbpro/WidgetDetectorThread.h \
+    plugins/usbpro/WidgetWriter.cpp \
+    plugins/usbpro/WidgetWriter.h
 plugins_usbpro_libolausbprowidget_la_LIBADD = common/libolacommon.la
 
 if USE_USBPRO
@@ -81,7 +83,8 @@ test_programs += \
     plugins/usbpro/RobeWidgetTester \
     plugins/usbpro/UltraDMXProWidgetTester \
     plugins/usbpro/UsbProWidgetDetectorTester \
-    plugins/usbpro/WidgetDetectorThreadTester
+    plugins/usbpro/WidgetDetectorThreadTester \
+    plugins/usbpro/WidgetWriterTester
 
 COMMON_USBPRO_TEST_LDADD = $(COMMON_TESTING_LIBS) \
                     plugins/usbpro/libolausbprowidget.la
@@ -157,6 +160,11 @@ plugins_usbpro_WidgetDetectorThreadTester_SOURCES = \
     $(common_test_sources)
 plugins_usbpro_WidgetDetectorThreadTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 plugins_usbpro_WidgetDetectorThreadTester_LDADD = $(COMMON_USBPRO_TEST_LDADD)
+
+plugins_usbpro_WidgetWriterTester_SOURCES = \
+    plugins/usbpro/WidgetWriterTest.cpp
+plugins_usbpro_WidgetWriterTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
+plugins_usbpro_WidgetWriterTester_LDADD = $(COMMON_USBPRO_TEST_LDADD)
 endif
 
 EXTRA_DIST += plugins/usbpro/README.md
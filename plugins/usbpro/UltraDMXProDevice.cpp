@@ -30,6 +30,7 @@
 #include "ola/Logging.h"
 #include "plugins/usbpro/UltraDMXProDevice.h"
 #include "plugins/usbpro/UsbProWidgetDetector.h"
+#include "plugins/usbpro/WidgetWriter.h"
 
 namespace ola {
 namespace plugin {
@@ -74,6 +75,12 @@ UltraDMXProDevice::UltraDMXProDevice(ola::PluginAdaptor *plugin_adaptor,
   str << "Serial #: " << m_serial << ", firmware "
       << (firmware_version >> 8) << "." << (firmware_version & 0xff);
 
+  WidgetWriter::Options writer_options;
+  writer_options.name = m_serial;
+  writer_options.max_frame_rate = fps_limit;
+  m_ultra_widget->SetWriter(
+      new WidgetWriter(plugin_adaptor, m_ultra_widget->GetDescriptor(),
+                       writer_options, plugin_adaptor->GetExportMap()));
 
   m_ultra_widget->GetParameters(NewSingleCallback(
     this,
@@ -98,9 +105,6 @@ UltraDMXProDevice::UltraDMXProDevice(ola::PluginAdaptor *plugin_adaptor,
       m_ultra_widget,
       0,
       str.str(),
-      plugin_adaptor->WakeUpTime(),
-      5,  // allow up to 5 burst frames
-      fps_limit,
       true);
   AddPort(output_port);
 
@@ -110,9 +114,6 @@ UltraDMXProDevice::UltraDMXProDevice(ola::PluginAdaptor *plugin_adaptor,
       m_ultra_widget,
       1,
       str.str(),
-      plugin_adaptor->WakeUpTime(),
-      5,  // allow up to 5 burst frames
-      fps_limit,
       false);
   AddPort(output_port);
 }
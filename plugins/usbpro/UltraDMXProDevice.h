@@ -24,7 +24,6 @@
 #include <string>
 #include <sstream>
 #include "ola/DmxBuffer.h"
-#include "olad/TokenBucket.h"
 #include "olad/PluginAdaptor.h"
 #include "olad/Port.h"
 
@@ -127,25 +126,16 @@ class UltraDMXProOutputPort: public BasicOutputPort {
                         UltraDMXProWidget *widget,
                         unsigned int id,
                         const std::string &description,
-                        const TimeStamp *wake_time,
-                        unsigned int max_burst,
-                        unsigned int rate,
                         bool primary)
       : BasicOutputPort(parent, id),
         m_description(description),
         m_widget(widget),
-        m_bucket(max_burst, rate, max_burst, *wake_time),
-        m_wake_time(wake_time),
         m_primary(primary) {}
 
+  // The widget's WidgetWriter takes care of rate limiting.
   bool WriteDMX(const DmxBuffer &buffer, OLA_UNUSED uint8_t priority) {
-    if (m_bucket.GetToken(*m_wake_time)) {
-      return m_primary ? m_widget->SendDMX(buffer)
-          : m_widget->SendSecondaryDMX(buffer);
-    } else {
-      OLA_INFO << "Port rated limited, dropping frame";
-    }
-    return true;
+    return m_primary ? m_widget->SendDMX(buffer)
+        : m_widget->SendSecondaryDMX(buffer);
   }
 
   std::string Description() const { return m_description; }
@@ -153,8 +143,6 @@ class UltraDMXProOutputPort: public BasicOutputPort {
  private:
   const std::string m_description;
   UltraDMXProWidget *m_widget;
-  TokenBucket m_bucket;
-  const TimeStamp *m_wake_time;
   bool m_primary;
 };
 }  // namespace usbpro
@@ -54,9 +54,9 @@ bool UltraDMXProWidget::SendDMXWithLabel(uint8_t label,
   widget_dmx.start_code = DMX512_START_CODE;
   unsigned int length = DMX_UNIVERSE_SIZE;
   data.Get(widget_dmx.dmx, &length);
-  return SendMessage(label,
-                     reinterpret_cast<uint8_t*>(&widget_dmx),
-                     length + 1);
+  return SendDMXMessage(label,
+                        reinterpret_cast<uint8_t*>(&widget_dmx),
+                        length + 1);
 }
 }  // namespace usbpro
 }  // namespace plugin
@@ -32,6 +32,7 @@
 #include "olad/Preferences.h"
 #include "plugins/usbpro/UsbProDevice.h"
 #include "plugins/usbpro/UsbProWidgetDetector.h"
+#include "plugins/usbpro/WidgetWriter.h"
 
 namespace ola {
 namespace plugin {
@@ -64,6 +65,13 @@ UsbProDevice::UsbProDevice(ola::PluginAdaptor *plugin_adaptor,
       << (firmware_version >> 8) << "." << (firmware_version & 0xff);
   SetName(str.str());
 
+  WidgetWriter::Options writer_options;
+  writer_options.name = m_serial;
+  writer_options.max_frame_rate = fps_limit;
+  widget->SetWriter(new WidgetWriter(plugin_adaptor, widget->GetDescriptor(),
+                                     writer_options,
+                                     plugin_adaptor->GetExportMap()));
+
   for (unsigned int i = 0; i < widget->PortCount(); i++) {
     EnttecPort *enttec_port = widget->GetPort(i);
     if (!enttec_port) {
@@ -84,10 +92,7 @@ UsbProDevice::UsbProDevice(ola::PluginAdaptor *plugin_adaptor,
     AddPort(input_port);
 
     OutputPort *output_port = new UsbProOutputPort(
-        this, enttec_port, i, port_description.str(),
-        plugin_adaptor->WakeUpTime(),
-        5,  // allow up to 5 burst frames
-        fps_limit);  // 200 frames per second seems to be the limit
+        this, enttec_port, i, port_description.str());
     AddPort(output_port);
 
     PortParams port_params = {false, 0, 0, 0};
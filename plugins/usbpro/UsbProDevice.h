@@ -24,7 +24,6 @@
 #include <string>
 #include <vector>
 #include "ola/DmxBuffer.h"
-#include "olad/TokenBucket.h"
 #include "olad/PluginAdaptor.h"
 #include "olad/Port.h"
 
@@ -145,23 +144,14 @@ class UsbProOutputPort: public BasicOutputPort {
   UsbProOutputPort(UsbProDevice *parent,
                    EnttecPort *port,
                    unsigned int id,
-                   const std::string &description,
-                   const TimeStamp *wake_time,
-                   unsigned int max_burst,
-                   unsigned int rate)
+                   const std::string &description)
       : BasicOutputPort(parent, id, port->SupportsRDM(), port->SupportsRDM()),
         m_description(description),
-        m_port(port),
-        m_bucket(max_burst, rate, max_burst, *wake_time),
-        m_wake_time(wake_time) {}
+        m_port(port) {}
 
+  // The widget's WidgetWriter takes care of rate limiting.
   bool WriteDMX(const DmxBuffer &buffer, uint8_t) {
-    if (m_bucket.GetToken(*m_wake_time)) {
-      return m_port->SendDMX(buffer);
-    } else {
-      OLA_INFO << "Port rated limited, dropping frame";
-    }
-    return true;
+    return m_port->SendDMX(buffer);
   }
 
   void PostSetUniverse(Universe*, Universe *new_universe) {
@@ -188,8 +178,6 @@ class UsbProOutputPort: public BasicOutputPort {
  private:
   const std::string m_description;
   EnttecPort *m_port;
-  TokenBucket m_bucket;
-  const TimeStamp *m_wake_time;
 };
 }  // namespace usbpro
 }  // namespace plugin
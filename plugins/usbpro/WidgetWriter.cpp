@@ -0,0 +1,322 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * WidgetWriter.cpp
+ * Queue messages for a serial widget and write them when the descriptor is
+ * writable.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "ola/Callback.h"
+#include "ola/Logging.h"
+#include "ola/stl/STLUtils.h"
+#include "plugins/usbpro/WidgetWriter.h"
+
+namespace ola {
+namespace plugin {
+namespace usbpro {
+
+using ola::thread::INVALID_TIMEOUT;
+
+const char WidgetWriter::SUPERSEDED_VAR[] = "usbpro-superseded-frames";
+const char WidgetWriter::DROPPED_VAR[] = "usbpro-dropped-frames";
+const char WidgetWriter::FRAME_INTERVAL_VAR[] = "usbpro-frame-interval-us";
+
+
+WidgetWriter::WidgetWriter(ola::io::SelectServerInterface *ss,
+                           ola::io::ConnectedDescriptor *descriptor,
+                           const Options &options,
+                           ExportMap *export_map)
+    : m_ss(ss),
+      m_descriptor(descriptor),
+      m_max_queued_bytes(options.max_queued_bytes),
+      m_min_interval(static_cast<int64_t>(
+          options.max_frame_rate ? USEC_IN_SECONDS / options.max_frame_rate :
+                                   0)),
+      m_next_frame(0),
+      m_write_registered(false),
+      m_timeout_id(INVALID_TIMEOUT),
+      m_frame_in_flight(false),
+      m_frame_blocked(false),
+      m_frame_interval(0),
+      m_superseded(NULL),
+      m_dropped(NULL),
+      m_frame_interval_var(NULL) {
+  m_descriptor->SetOnWritable(NewCallback(this, &WidgetWriter::Write));
+
+  if (export_map) {
+    m_superseded = export_map->GetUIntMapVar(
+        SUPERSEDED_VAR, "device")->Handle(options.name);
+    m_dropped = export_map->GetUIntMapVar(
+        DROPPED_VAR, "device")->Handle(options.name);
+    m_frame_interval_var = export_map->GetUIntMapVar(
+        FRAME_INTERVAL_VAR, "device")->Handle(options.name);
+    *m_superseded = 0;
+    *m_dropped = 0;
+    *m_frame_interval_var = 0;
+  }
+}
+
+
+WidgetWriter::~WidgetWriter() {
+  if (m_timeout_id != INVALID_TIMEOUT) {
+    m_ss->RemoveTimeout(m_timeout_id);
+  }
+  StopWaitingForWritable();
+  m_descriptor->SetOnWritable(NULL);
+
+  DropQueue();
+  PendingFrames::iterator iter = m_frames.begin();
+  for (; iter != m_frames.end(); ++iter) {
+    if ((*iter)->pending && m_dropped) {
+      (*m_dropped)++;
+    }
+  }
+  STLDeleteElements(&m_frames);
+}
+
+
+bool WidgetWriter::SendMessage(const uint8_t *frame, unsigned int length) {
+  if (m_queue.Size() + length > m_max_queued_bytes) {
+    OLA_WARN << "Widget output queue full, dropping message";
+    if (m_dropped) {
+      (*m_dropped)++;
+    }
+    return false;
+  }
+
+  m_queue.Write(frame, length);
+  if (!m_write_registered) {
+    Write();
+  }
+  return true;
+}
+
+
+bool WidgetWriter::SendDMX(uint8_t label, const uint8_t *frame,
+                           unsigned int length) {
+  PendingFrame *pending = NULL;
+  PendingFrames::iterator iter = m_frames.begin();
+  for (; iter != m_frames.end(); ++iter) {
+    if ((*iter)->label == label) {
+      pending = *iter;
+      break;
+    }
+  }
+
+  if (!pending) {
+    pending = new PendingFrame();
+    pending->label = label;
+    pending->pending = false;
+    m_frames.push_back(pending);
+  }
+
+  if (pending->pending && m_superseded) {
+    (*m_superseded)++;
+  }
+  pending->data.assign(frame, frame + length);
+  pending->pending = true;
+
+  if (!m_write_registered) {
+    Write();
+  }
+  return true;
+}
+
+
+bool WidgetWriter::Idle() const {
+  if (!m_queue.Empty()) {
+    return false;
+  }
+  PendingFrames::const_iterator iter = m_frames.begin();
+  for (; iter != m_frames.end(); ++iter) {
+    if ((*iter)->pending) {
+      return false;
+    }
+  }
+  return true;
+}
+
+
+/**
+ * Write as much as we can without blocking. This is called when new messages
+ * arrive, when the descriptor becomes writable and when the next DMX frame is
+ * due.
+ */
+void WidgetWriter::Write() {
+  if (!m_descriptor->ValidWriteDescriptor()) {
+    StopWaitingForWritable();
+    DropQueue();
+    return;
+  }
+
+  const TimeStamp now = *m_ss->WakeUpTime();
+  while (true) {
+    if (!m_queue.Empty()) {
+      ssize_t bytes_sent = m_descriptor->Send(&m_queue);
+      const int error = errno;
+      if (bytes_sent < 0 && error != EAGAIN && error != EWOULDBLOCK &&
+          error != EINTR) {
+        OLA_WARN << "Failed to write to widget, dropping " << m_queue.Size()
+                 << " bytes";
+        DropQueue();
+      } else if (!m_queue.Empty()) {
+        m_frame_blocked = m_frame_in_flight;
+        WaitForWritable();
+        return;
+      }
+
+      if (m_frame_in_flight) {
+        FrameComplete(now);
+      }
+    }
+
+    TimeStamp next_due;
+    PendingFrame *frame = NextFrame(now, &next_due);
+    if (!frame) {
+      StopWaitingForWritable();
+      if (next_due.IsSet()) {
+        ScheduleWrite(now, next_due);
+      }
+      return;
+    }
+
+    frame->pending = false;
+    frame->next_send = now + m_min_interval;
+    m_link_ready = now + FrameInterval();
+    m_queue.Write(&frame->data[0], frame->data.size());
+    m_frame_in_flight = true;
+    m_frame_blocked = false;
+    m_frame_start = now;
+  }
+}
+
+
+/**
+ * Called once the descriptor has accepted all of a DMX frame. If we had to
+ * wait for the descriptor, the time it took is a measure of how fast the
+ * widget is draining the tty buffer.
+ */
+void WidgetWriter::FrameComplete(const TimeStamp &now) {
+  m_frame_in_flight = false;
+  if (m_frame_blocked) {
+    int64_t elapsed = (now - m_frame_start).AsInt();
+    if (elapsed < 0) {
+      elapsed = 0;
+    } else if (elapsed > MAX_FRAME_INTERVAL) {
+      elapsed = MAX_FRAME_INTERVAL;
+    }
+    m_frame_interval = static_cast<unsigned int>(
+        (m_frame_interval + elapsed) / 2);
+  } else {
+    m_frame_interval -= m_frame_interval / 4;
+    if (m_frame_interval < MIN_FRAME_INTERVAL) {
+      m_frame_interval = 0;
+    }
+  }
+
+  if (m_frame_interval_var) {
+    *m_frame_interval_var = m_frame_interval;
+  }
+}
+
+
+/**
+ * Find the next DMX frame that is due to be sent. The labels are served round
+ * robin so one port can't starve the others.
+ * @param now the current time.
+ * @param next_due if there are frames pending but none are due, this is set
+ *   to the time the earliest one is.
+ * @returns the frame to send, or NULL if there isn't one.
+ */
+WidgetWriter::PendingFrame *WidgetWriter::NextFrame(const TimeStamp &now,
+                                                    TimeStamp *next_due) {
+  const unsigned int count = m_frames.size();
+  for (unsigned int i = 0; i < count; i++) {
+    unsigned int index = (m_next_frame + i) % count;
+    PendingFrame *frame = m_frames[index];
+    if (!frame->pending) {
+      continue;
+    }
+
+    const TimeStamp &due = frame->next_send > m_link_ready ?
+        frame->next_send : m_link_ready;
+    if (due <= now) {
+      m_next_frame = index + 1;
+      return frame;
+    }
+    if (!next_due->IsSet() || due < *next_due) {
+      *next_due = due;
+    }
+  }
+  return NULL;
+}
+
+
+void WidgetWriter::WaitForWritable() {
+  if (!m_write_registered) {
+    m_write_registered = m_ss->AddWriteDescriptor(m_descriptor);
+  }
+}
+
+
+void WidgetWriter::StopWaitingForWritable() {
+  if (m_write_registered) {
+    m_ss->RemoveWriteDescriptor(m_descriptor);
+    m_write_registered = false;
+  }
+}
+
+
+void WidgetWriter::ScheduleWrite(const TimeStamp &now, const TimeStamp &due) {
+  if (m_timeout_id != INVALID_TIMEOUT) {
+    if (m_timeout_due <= due) {
+      return;
+    }
+    m_ss->RemoveTimeout(m_timeout_id);
+  }
+
+  m_timeout_due = due;
+  m_timeout_id = m_ss->RegisterSingleTimeout(
+      due - now,
+      NewSingleCallback(this, &WidgetWriter::WriteTimeout));
+}
+
+
+void WidgetWriter::WriteTimeout() {
+  m_timeout_id = INVALID_TIMEOUT;
+  if (!m_write_registered) {
+    Write();
+  }
+}
+
+
+/**
+ * Throw away anything that was handed to the descriptor but not written.
+ */
+void WidgetWriter::DropQueue() {
+  if (m_frame_in_flight && m_dropped) {
+    (*m_dropped)++;
+  }
+  m_frame_in_flight = false;
+  m_queue.Clear();
+}
+}  // namespace usbpro
+}  // namespace plugin
+}  // namespace ola
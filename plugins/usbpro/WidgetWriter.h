@@ -0,0 +1,182 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * WidgetWriter.h
+ * Queue messages for a serial widget and write them when the descriptor is
+ * writable.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef PLUGINS_USBPRO_WIDGETWRITER_H_
+#define PLUGINS_USBPRO_WIDGETWRITER_H_
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "ola/Clock.h"
+#include "ola/ExportMap.h"
+#include "ola/base/Macro.h"
+#include "ola/io/Descriptor.h"
+#include "ola/io/IOQueue.h"
+#include "ola/io/SelectServerInterface.h"
+#include "ola/thread/SchedulerInterface.h"
+
+namespace ola {
+namespace plugin {
+namespace usbpro {
+
+/**
+ * @brief The output stage for a widget.
+ *
+ * Messages are written to the descriptor without blocking. Whatever doesn't
+ * fit in the tty buffer is held here, and written once the descriptor becomes
+ * writable.
+ *
+ * There are two kinds of message. Control messages (RDM, parameters etc.) are
+ * queued and sent in order. DMX frames are kept in a single slot per label, so
+ * if a new frame arrives before the previous one was written, the old frame
+ * is replaced. These frames are counted as superseded in the ExportMap. A
+ * DMX frame is only handed to the descriptor once the previous one has been
+ * accepted, but that doesn't stop stale frames building up: the kernel's tty
+ * buffer holds several frames, and we only find out the widget is falling
+ * behind once that buffer is full.
+ *
+ * The DMX frame rate adapts to the widget. Each time a frame can't be written
+ * in one go we measure how long the widget took to accept it, and space the
+ * following frames by the average of those times, which limits how many
+ * frames wait in the tty buffer. While frames are accepted immediately the
+ * spacing decays back towards max_frame_rate.
+ */
+class WidgetWriter {
+ public:
+  struct Options {
+    std::string name;  // used as the key in the ExportMap
+    unsigned int max_frame_rate;  // per label, 0 means no limit.
+    unsigned int max_queued_bytes;  // for control messages
+
+    Options()
+        : max_frame_rate(0),
+          max_queued_bytes(DEFAULT_MAX_QUEUED_BYTES) {
+    }
+  };
+
+  /**
+   * @brief Create a new WidgetWriter.
+   * @param ss the SelectServer to register the descriptor with when it needs
+   *   to wait for it to become writable.
+   * @param descriptor the descriptor to write to. This should be non-blocking.
+   * @param options the Options for the writer.
+   * @param export_map the ExportMap to use for the counters, may be NULL.
+   */
+  WidgetWriter(ola::io::SelectServerInterface *ss,
+               ola::io::ConnectedDescriptor *descriptor,
+               const Options &options,
+               ExportMap *export_map = NULL);
+
+  /**
+   * @brief Destroy the writer, anything left unsent is dropped.
+   *
+   * This must be run from the SelectServer's thread, before the descriptor is
+   * closed.
+   */
+  ~WidgetWriter();
+
+  /**
+   * @brief Queue a control message.
+   * @param frame the framed message.
+   * @param length the size of the message.
+   * @returns false if the queue was full and the message was dropped.
+   */
+  bool SendMessage(const uint8_t *frame, unsigned int length);
+
+  /**
+   * @brief Send a DMX frame, replacing any unsent frame with the same label.
+   * @param label the label of the message, one slot is kept for each label.
+   * @param frame the framed message.
+   * @param length the size of the message.
+   */
+  bool SendDMX(uint8_t label, const uint8_t *frame, unsigned int length);
+
+  /**
+   * @brief Check if all messages have been handed to the descriptor.
+   */
+  bool Idle() const;
+
+  /**
+   * @brief The current spacing between DMX frames, based on the measured
+   *   throughput of the widget.
+   */
+  TimeInterval FrameInterval() const {
+    return TimeInterval(static_cast<int64_t>(m_frame_interval));
+  }
+
+  static const unsigned int DEFAULT_MAX_QUEUED_BYTES = 4096;
+  static const char SUPERSEDED_VAR[];
+  static const char DROPPED_VAR[];
+  static const char FRAME_INTERVAL_VAR[];
+
+ private:
+  struct PendingFrame {
+    uint8_t label;
+    bool pending;
+    TimeStamp next_send;  // limited by max_frame_rate
+    std::vector<uint8_t> data;
+  };
+
+  typedef std::vector<PendingFrame*> PendingFrames;
+
+  ola::io::SelectServerInterface *m_ss;
+  ola::io::ConnectedDescriptor *m_descriptor;
+  const unsigned int m_max_queued_bytes;
+  const TimeInterval m_min_interval;
+  ola::io::IOQueue m_queue;
+  PendingFrames m_frames;
+  unsigned int m_next_frame;  // for round robin between the labels
+  bool m_write_registered;
+  ola::thread::timeout_id m_timeout_id;
+  TimeStamp m_timeout_due;
+
+  // The DMX frame currently in m_queue, if any.
+  bool m_frame_in_flight;
+  bool m_frame_blocked;
+  TimeStamp m_frame_start;
+
+  // In microseconds.
+  unsigned int m_frame_interval;
+  TimeStamp m_link_ready;
+
+  unsigned int *m_superseded;
+  unsigned int *m_dropped;
+  unsigned int *m_frame_interval_var;
+
+  void Write();
+  void FrameComplete(const TimeStamp &now);
+  PendingFrame *NextFrame(const TimeStamp &now, TimeStamp *next_due);
+  void WaitForWritable();
+  void StopWaitingForWritable();
+  void ScheduleWrite(const TimeStamp &now, const TimeStamp &due);
+  void WriteTimeout();
+  void DropQueue();
+
+  // in microseconds
+  static const unsigned int MIN_FRAME_INTERVAL = 100;
+  static const unsigned int MAX_FRAME_INTERVAL = 100000;
+
+  DISALLOW_COPY_AND_ASSIGN(WidgetWriter);
+};
+}  // namespace usbpro
+}  // namespace plugin
+}  // namespace ola
+#endif  // PLUGINS_USBPRO_WIDGETWRITER_H_
@@ -0,0 +1,324 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * WidgetWriterTest.cpp
+ * Test fixture for the WidgetWriter.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <string.h>
+#include <unistd.h>
+#include <string>
+
+#include "ola/Clock.h"
+#include "ola/ExportMap.h"
+#include "ola/Logging.h"
+#include "ola/io/Descriptor.h"
+#include "ola/io/SelectServer.h"
+#include "ola/testing/TestUtils.h"
+#include "plugins/usbpro/WidgetWriter.h"
+
+using ola::ExportMap;
+using ola::TimeInterval;
+using ola::TimeStamp;
+using ola::io::ConnectedDescriptor;
+using ola::io::LoopbackDescriptor;
+using ola::io::SelectServer;
+using ola::plugin::usbpro::WidgetWriter;
+using std::string;
+
+
+class WidgetWriterTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(WidgetWriterTest);
+  CPPUNIT_TEST(testWriteThrough);
+  CPPUNIT_TEST(testLatestFrameWins);
+  CPPUNIT_TEST(testQueueLimit);
+  CPPUNIT_TEST(testFrameRate);
+  CPPUNIT_TEST(testAdaptiveFrameRate);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void setUp();
+  void tearDown();
+
+  void testWriteThrough();
+  void testLatestFrameWins();
+  void testQueueLimit();
+  void testFrameRate();
+  void testAdaptiveFrameRate();
+
+ private:
+  SelectServer m_ss;
+  LoopbackDescriptor m_descriptor;
+  ExportMap m_export_map;
+
+  void FillDescriptor();
+  string ReadAll();
+  void RunUntilIdle(const WidgetWriter &writer);
+  void SendBlockedFrame(WidgetWriter *writer, const uint8_t *frame,
+                        unsigned int length, unsigned int block_time);
+  unsigned int Counter(const char *var);
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(WidgetWriterTest);
+
+namespace {
+const uint8_t DMX_LABEL = 6;
+const uint8_t SECONDARY_DMX_LABEL = 135;
+const uint8_t FRAME_A[] = {0x7e, 6, 2, 0, 0, 1, 0xe7};
+const uint8_t FRAME_B[] = {0x7e, 6, 2, 0, 0, 2, 0xe7};
+const uint8_t FRAME_C[] = {0x7e, 6, 2, 0, 0, 3, 0xe7};
+const uint8_t FRAME_D[] = {0x7e, 135, 2, 0, 0, 4, 0xe7};
+const uint8_t MESSAGE[] = {0x7e, 3, 0, 0, 0xe7};
+
+string AsString(const uint8_t *data, unsigned int length) {
+  return string(reinterpret_cast<const char*>(data), length);
+}
+}  // namespace
+
+
+void WidgetWriterTest::setUp() {
+  ola::InitLogging(ola::OLA_LOG_INFO, ola::OLA_LOG_STDERR);
+  OLA_ASSERT_TRUE(m_descriptor.Init());
+  ConnectedDescriptor::SetNonBlocking(m_descriptor.WriteDescriptor());
+  // so the wake up time is valid
+  m_ss.RunOnce(TimeInterval(0, 0));
+}
+
+
+void WidgetWriterTest::tearDown() {
+  m_descriptor.Close();
+}
+
+
+/**
+ * Write to the descriptor until the pipe buffer is full.
+ */
+void WidgetWriterTest::FillDescriptor() {
+  uint8_t data[1024];
+  memset(data, 0, sizeof(data));
+  while (m_descriptor.Send(data, sizeof(data)) > 0) {}
+  while (m_descriptor.Send(data, 1) > 0) {}
+}
+
+
+string WidgetWriterTest::ReadAll() {
+  string output;
+  uint8_t data[1024];
+  unsigned int data_read = 0;
+  do {
+    m_descriptor.Receive(data, sizeof(data), data_read);
+    output.append(reinterpret_cast<char*>(data), data_read);
+  } while (data_read);
+  return output;
+}
+
+
+void WidgetWriterTest::RunUntilIdle(const WidgetWriter &writer) {
+  for (unsigned int i = 0; i < 100 && !writer.Idle(); i++) {
+    m_ss.RunOnce(TimeInterval(0, 10000));
+  }
+}
+
+
+/**
+ * Send a frame while the descriptor is full, and make it writable again
+ * after block_time microseconds.
+ */
+void WidgetWriterTest::SendBlockedFrame(WidgetWriter *writer,
+                                        const uint8_t *frame,
+                                        unsigned int length,
+                                        unsigned int block_time) {
+  FillDescriptor();
+  OLA_ASSERT_TRUE(writer->SendDMX(DMX_LABEL, frame, length));
+  OLA_ASSERT_FALSE(writer->Idle());
+  usleep(block_time);
+  string output = ReadAll();
+  RunUntilIdle(*writer);
+  output += ReadAll();
+  OLA_ASSERT_TRUE(writer->Idle());
+  OLA_ASSERT_TRUE(output.size() >= length);
+  OLA_ASSERT_EQ(AsString(frame, length),
+                output.substr(output.size() - length));
+}
+
+
+unsigned int WidgetWriterTest::Counter(const char *var) {
+  return (*m_export_map.GetUIntMapVar(var))["test"];
+}
+
+
+/**
+ * Check messages are written straight away if there is room.
+ */
+void WidgetWriterTest::testWriteThrough() {
+  WidgetWriter::Options options;
+  options.name = "test";
+  WidgetWriter writer(&m_ss, &m_descriptor, options, &m_export_map);
+
+  OLA_ASSERT_TRUE(writer.SendMessage(MESSAGE, sizeof(MESSAGE)));
+  OLA_ASSERT_TRUE(writer.SendDMX(DMX_LABEL, FRAME_A, sizeof(FRAME_A)));
+  OLA_ASSERT_TRUE(writer.SendDMX(DMX_LABEL, FRAME_B, sizeof(FRAME_B)));
+  OLA_ASSERT_TRUE(writer.Idle());
+
+  string expected = AsString(MESSAGE, sizeof(MESSAGE)) +
+      AsString(FRAME_A, sizeof(FRAME_A)) + AsString(FRAME_B, sizeof(FRAME_B));
+  OLA_ASSERT_EQ(expected, ReadAll());
+  OLA_ASSERT_EQ(0u, Counter(WidgetWriter::SUPERSEDED_VAR));
+  OLA_ASSERT_EQ(0u, Counter(WidgetWriter::DROPPED_VAR));
+  OLA_ASSERT_TRUE(writer.FrameInterval().IsZero());
+}
+
+
+/**
+ * Check that only the newest frame for each label is sent once the
+ * descriptor becomes writable.
+ */
+void WidgetWriterTest::testLatestFrameWins() {
+  WidgetWriter::Options options;
+  options.name = "test";
+  WidgetWriter writer(&m_ss, &m_descriptor, options, &m_export_map);
+
+  FillDescriptor();
+  // A is handed to the descriptor, and so is the message since it's queued
+  // behind A.
+  OLA_ASSERT_TRUE(writer.SendDMX(DMX_LABEL, FRAME_A, sizeof(FRAME_A)));
+  OLA_ASSERT_TRUE(writer.SendMessage(MESSAGE, sizeof(MESSAGE)));
+  OLA_ASSERT_TRUE(writer.SendDMX(DMX_LABEL, FRAME_B, sizeof(FRAME_B)));
+  OLA_ASSERT_TRUE(writer.SendDMX(SECONDARY_DMX_LABEL, FRAME_D,
+                                 sizeof(FRAME_D)));
+  OLA_ASSERT_TRUE(writer.SendDMX(DMX_LABEL, FRAME_C, sizeof(FRAME_C)));
+  OLA_ASSERT_FALSE(writer.Idle());
+  OLA_ASSERT_EQ(1u, Counter(WidgetWriter::SUPERSEDED_VAR));
+
+  // Empty the pipe so the descriptor becomes writable.
+  string output = ReadAll();
+  RunUntilIdle(writer);
+  output += ReadAll();
+  OLA_ASSERT_TRUE(writer.Idle());
+
+  // The labels are served round robin, so D goes before C.
+  string expected = AsString(FRAME_A, sizeof(FRAME_A)) +
+      AsString(MESSAGE, sizeof(MESSAGE)) + AsString(FRAME_D, sizeof(FRAME_D)) +
+      AsString(FRAME_C, sizeof(FRAME_C));
+  OLA_ASSERT_TRUE(output.size() >= expected.size());
+  OLA_ASSERT_EQ(expected, output.substr(output.size() - expected.size()));
+  OLA_ASSERT_EQ(1u, Counter(WidgetWriter::SUPERSEDED_VAR));
+  OLA_ASSERT_EQ(0u, Counter(WidgetWriter::DROPPED_VAR));
+}
+
+
+/**
+ * Check control messages are dropped once the queue is full.
+ */
+void WidgetWriterTest::testQueueLimit() {
+  WidgetWriter::Options options;
+  options.name = "test";
+  options.max_queued_bytes = 2 * sizeof(MESSAGE);
+
+  {
+    WidgetWriter writer(&m_ss, &m_descriptor, options, &m_export_map);
+    FillDescriptor();
+    OLA_ASSERT_TRUE(writer.SendMessage(MESSAGE, sizeof(MESSAGE)));
+    OLA_ASSERT_TRUE(writer.SendMessage(MESSAGE, sizeof(MESSAGE)));
+    OLA_ASSERT_FALSE(writer.SendMessage(MESSAGE, sizeof(MESSAGE)));
+    OLA_ASSERT_EQ(1u, Counter(WidgetWriter::DROPPED_VAR));
+
+    // DMX frames don't count towards the limit
+    OLA_ASSERT_TRUE(writer.SendDMX(DMX_LABEL, FRAME_A, sizeof(FRAME_A)));
+  }
+  // Frame A was never sent.
+  OLA_ASSERT_EQ(2u, Counter(WidgetWriter::DROPPED_VAR));
+}
+
+
+/**
+ * Check max_frame_rate limits the frames for a label.
+ */
+void WidgetWriterTest::testFrameRate() {
+  WidgetWriter::Options options;
+  options.name = "test";
+  options.max_frame_rate = 20;  // 50ms between frames
+  WidgetWriter writer(&m_ss, &m_descriptor, options, &m_export_map);
+
+  OLA_ASSERT_TRUE(writer.SendDMX(DMX_LABEL, FRAME_A, sizeof(FRAME_A)));
+  OLA_ASSERT_TRUE(writer.SendDMX(SECONDARY_DMX_LABEL, FRAME_D,
+                                 sizeof(FRAME_D)));
+  OLA_ASSERT_TRUE(writer.SendDMX(DMX_LABEL, FRAME_B, sizeof(FRAME_B)));
+  OLA_ASSERT_EQ(AsString(FRAME_A, sizeof(FRAME_A)) +
+                AsString(FRAME_D, sizeof(FRAME_D)),
+                ReadAll());
+  OLA_ASSERT_FALSE(writer.Idle());
+
+  // B is replaced before it's due.
+  OLA_ASSERT_TRUE(writer.SendDMX(DMX_LABEL, FRAME_C, sizeof(FRAME_C)));
+  OLA_ASSERT_EQ(1u, Counter(WidgetWriter::SUPERSEDED_VAR));
+
+  TimeStamp start = *m_ss.WakeUpTime();
+  RunUntilIdle(writer);
+  OLA_ASSERT_TRUE(writer.Idle());
+  OLA_ASSERT_TRUE(*m_ss.WakeUpTime() - start >= TimeInterval(0, 40000));
+  OLA_ASSERT_EQ(AsString(FRAME_C, sizeof(FRAME_C)), ReadAll());
+}
+
+
+/**
+ * Check the frame spacing rises while the widget is slow to accept frames,
+ * and decays once it catches up.
+ */
+void WidgetWriterTest::testAdaptiveFrameRate() {
+  WidgetWriter::Options options;
+  options.name = "test";
+  WidgetWriter writer(&m_ss, &m_descriptor, options, &m_export_map);
+
+  // The first blocked frame sets the spacing to half the time it was blocked
+  // for, since it's averaged with the initial spacing of 0.
+  SendBlockedFrame(&writer, FRAME_A, sizeof(FRAME_A), 20000);
+  TimeInterval first_interval = writer.FrameInterval();
+  OLA_ASSERT_TRUE(first_interval >= TimeInterval(0, 10000));
+  OLA_ASSERT_EQ(static_cast<unsigned int>(first_interval.AsInt()),
+                Counter(WidgetWriter::FRAME_INTERVAL_VAR));
+
+  // A longer block raises the average.
+  SendBlockedFrame(&writer, FRAME_B, sizeof(FRAME_B), 40000);
+  TimeInterval second_interval = writer.FrameInterval();
+  OLA_ASSERT_TRUE(second_interval > first_interval);
+  OLA_ASSERT_TRUE(second_interval >= TimeInterval(0, 25000));
+  OLA_ASSERT_EQ(static_cast<unsigned int>(second_interval.AsInt()),
+                Counter(WidgetWriter::FRAME_INTERVAL_VAR));
+
+  // Frames that are accepted straight away decay the spacing to 0.
+  TimeInterval last_interval = second_interval;
+  for (unsigned int i = 0; i < 40 && !writer.FrameInterval().IsZero(); i++) {
+    OLA_ASSERT_TRUE(writer.SendDMX(DMX_LABEL, FRAME_C, sizeof(FRAME_C)));
+    if (i) {
+      // The frame has to wait for the spacing, even though the descriptor is
+      // writable.
+      OLA_ASSERT_FALSE(writer.Idle());
+      OLA_ASSERT_EQ(string(), ReadAll());
+    }
+    RunUntilIdle(writer);
+    OLA_ASSERT_TRUE(writer.Idle());
+    OLA_ASSERT_EQ(AsString(FRAME_C, sizeof(FRAME_C)), ReadAll());
+    OLA_ASSERT_TRUE(writer.FrameInterval() < last_interval);
+    last_interval = writer.FrameInterval();
+  }
+  OLA_ASSERT_TRUE(writer.FrameInterval().IsZero());
+  OLA_ASSERT_EQ(0u, Counter(WidgetWriter::FRAME_INTERVAL_VAR));
+  OLA_ASSERT_EQ(0u, Counter(WidgetWriter::SUPERSEDED_VAR));
+  OLA_ASSERT_EQ(0u, Counter(WidgetWriter::DROPPED_VAR));
+}
@@ -0,0 +1,359 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * DMXLineDecoder.cpp
+ * Decode DMX / RDM frames from logic analyzer samples.
+ * Copyright (C) 2026 Simon Newton
+ *
+ * See E1.11 for the details including timing. It generally goes something
+ * like:
+ *  Mark (Idle) - High
+ *  Break - Low
+ *  Mark After Break - High
+ *  Start bit (low)
+ *  LSB to MSB (8)
+ *  2 stop bits (high)
+ *  Mark between slots (high)
+ *
+ * Each channel has a state machine which is driven by the edges on the line.
+ * Between edges the line holds its level, so the bits of a slot are filled in
+ * from the level of the line whenever an edge, or the end of a block, passes
+ * the middle of the bit.
+ *
+ * Start bit vs Break.
+ *  When the line falls after a mark it could either be a break, indicating
+ *  the previous frame is complete, or a start bit. We treat it as a start bit
+ *  and if the stop bits turn out to be low, keep watching the line. If it
+ *  stays low for long enough it was a break, otherwise it's a framing error.
+ */
+
+#include <ola/Callback.h>
+#include <ola/Logging.h>
+#include <ola/base/Array.h>
+#include <vector>
+
+#include "tools/logic/DMXLineDecoder.h"
+#include "tools/logic/EdgeFinder.h"
+
+using std::vector;
+
+/**
+ * The state machine for one line.
+ */
+class DMXLineDecoder::ChannelDecoder {
+ public:
+  ChannelDecoder(DMXLineDecoder *decoder, unsigned int channel,
+                 const Timing &timing)
+      : m_decoder(decoder),
+        m_channel(channel),
+        m_timing(timing),
+        m_state(WAIT_FOR_BREAK),
+        m_level(true),
+        m_last_edge(0),
+        m_slot_start(0),
+        m_bit(0),
+        m_byte(0) {
+  }
+
+  /**
+   * Start decoding, the line is at level at sample.
+   */
+  void Start(uint64_t sample, bool level) {
+    m_state = WAIT_FOR_BREAK;
+    m_level = level;
+    m_last_edge = sample;
+    m_data.clear();
+  }
+
+  void Edge(uint64_t sample, bool level);
+  void Advance(uint64_t sample);
+  void Flush();
+
+ private:
+  enum State {
+    WAIT_FOR_BREAK,  // we don't know where we are, wait for a break.
+    MAB,
+    SLOT,
+    MARK_BETWEEN_SLOTS,
+    MAYBE_BREAK,  // the stop bits were low, this may be a break.
+    BREAK,
+  };
+
+  DMXLineDecoder *m_decoder;
+  const unsigned int m_channel;
+  const Timing &m_timing;
+
+  State m_state;
+  bool m_level;
+  // The sample of the last edge.
+  uint64_t m_last_edge;
+  uint64_t m_slot_start;
+  // The next bit of the slot to sample.
+  unsigned int m_bit;
+  uint8_t m_byte;
+  vector<uint8_t> m_data;
+
+  void StartSlot(uint64_t sample) {
+    m_state = SLOT;
+    m_slot_start = sample;
+    m_bit = 0;
+    m_byte = 0;
+  }
+
+  void Abort();
+  void HandleFrame();
+  double SamplesAsMicroSeconds(uint64_t samples) const;
+
+  static const unsigned int STOP_BIT = 9;
+  static const unsigned int SLOT_BITS = 11;
+};
+
+
+/**
+ * Handle a change in level at sample.
+ */
+void DMXLineDecoder::ChannelDecoder::Edge(uint64_t sample, bool level) {
+  Advance(sample);
+
+  uint64_t duration = sample - m_last_edge;
+  switch (m_state) {
+    case WAIT_FOR_BREAK:
+      if (level && duration >= m_timing.min_break) {
+        m_data.clear();
+        m_state = MAB;
+      }
+      break;
+    case MAB:
+      if (duration >= m_timing.min_mab) {
+        StartSlot(sample);
+      } else {
+        OLA_WARN << "Mark too short on channel " << m_channel << ", was "
+                 << SamplesAsMicroSeconds(duration) << "us";
+        Abort();
+      }
+      break;
+    case MARK_BETWEEN_SLOTS:
+      StartSlot(sample);
+      break;
+    case MAYBE_BREAK:
+      // If this was a break, Advance() would have moved us to BREAK
+      OLA_WARN << "Framing error in slot " << m_data.size()
+               << " on channel " << m_channel;
+      Abort();
+      break;
+    case BREAK:
+      m_state = MAB;
+      break;
+    case SLOT:
+      // The bits are sampled by Advance()
+      break;
+  }
+  m_level = level;
+  m_last_edge = sample;
+}
+
+
+/**
+ * The line held its level up until sample.
+ */
+void DMXLineDecoder::ChannelDecoder::Advance(uint64_t sample) {
+  if (m_state == SLOT) {
+    while (m_bit < SLOT_BITS &&
+           m_slot_start + m_timing.bit_centre[m_bit] < sample) {
+      if (m_bit == 0) {
+        if (m_level) {
+          OLA_WARN << "Start bit too short on channel " << m_channel;
+          Abort();
+          return;
+        }
+      } else if (m_bit < STOP_BIT) {
+        // LSB first
+        m_byte |= m_level << (m_bit - 1);
+      } else if (!m_level) {
+        m_state = MAYBE_BREAK;
+        break;
+      }
+      m_bit++;
+    }
+
+    if (m_bit == SLOT_BITS) {
+      OLA_DEBUG << "Byte " << m_data.size() << " is "
+                << static_cast<int>(m_byte);
+      m_data.push_back(m_byte);
+      m_state = MARK_BETWEEN_SLOTS;
+    }
+  }
+
+  if (m_state == MAYBE_BREAK && sample - m_last_edge >= m_timing.min_break) {
+    // The line has been low long enough, the frame is complete.
+    HandleFrame();
+    m_state = BREAK;
+  } else if ((m_state == MARK_BETWEEN_SLOTS || m_state == MAB) &&
+             sample - m_last_edge >= m_timing.max_mark) {
+    // ok, that was the end of the frame.
+    HandleFrame();
+    m_state = WAIT_FOR_BREAK;
+  }
+}
+
+
+/**
+ * Send any complete frame.
+ */
+void DMXLineDecoder::ChannelDecoder::Flush() {
+  if (m_state == MARK_BETWEEN_SLOTS) {
+    HandleFrame();
+  }
+  m_data.clear();
+  m_state = WAIT_FOR_BREAK;
+}
+
+
+/**
+ * Something went wrong, pass up any partial frame and wait for the next
+ * break.
+ */
+void DMXLineDecoder::ChannelDecoder::Abort() {
+  m_decoder->Error();
+  HandleFrame();
+  m_state = WAIT_FOR_BREAK;
+}
+
+
+void DMXLineDecoder::ChannelDecoder::HandleFrame() {
+  OLA_DEBUG << "Got frame of size " << m_data.size() << " on channel "
+            << m_channel;
+  if (!m_data.empty()) {
+    m_decoder->FrameReceived(m_channel, &m_data[0], m_data.size());
+  }
+  m_data.clear();
+}
+
+
+double DMXLineDecoder::ChannelDecoder::SamplesAsMicroSeconds(
+    uint64_t samples) const {
+  // min_break is the number of samples in MIN_BREAK_TIME
+  return static_cast<double>(samples) * MIN_BREAK_TIME / m_timing.min_break;
+}
+
+
+DMXLineDecoder::DMXLineDecoder(FrameCallback *callback,
+                               unsigned int sample_rate,
+                               uint8_t channels)
+    : m_callback(callback),
+      m_channel_mask(channels),
+      m_started(false),
+      m_previous(0),
+      m_samples(0),
+      m_edge_count(0),
+      m_frames(0),
+      m_errors(0) {
+  if (sample_rate % DMX_BITRATE) {
+    OLA_WARN << "Sample rate is not a multiple of " << DMX_BITRATE;
+  }
+  if (sample_rate < 2 * DMX_BITRATE) {
+    OLA_WARN << "Sample rate " << sample_rate << " is too low to decode DMX";
+  }
+
+  for (unsigned int i = 0; i < arraysize(m_timing.bit_centre); i++) {
+    m_timing.bit_centre[i] = (static_cast<uint64_t>(2 * i + 1) * sample_rate) /
+                             (2 * DMX_BITRATE);
+  }
+  m_timing.min_break = MicroSecondsToSamples(sample_rate, MIN_BREAK_TIME);
+  m_timing.min_mab = MicroSecondsToSamples(sample_rate, MIN_MAB_TIME);
+  m_timing.max_mark = MicroSecondsToSamples(sample_rate, MAX_MARK_TIME);
+
+  for (unsigned int i = 0; i < MAX_CHANNELS; i++) {
+    m_channels[i] = (m_channel_mask & (1 << i)) ?
+                    new ChannelDecoder(this, i, m_timing) : NULL;
+  }
+  OLA_DEBUG << "Using the " << EdgeFinderKernelName(ActiveEdgeFinderKernel())
+            << " edge finder";
+}
+
+
+DMXLineDecoder::~DMXLineDecoder() {
+  for (unsigned int i = 0; i < MAX_CHANNELS; i++) {
+    delete m_channels[i];
+  }
+}
+
+
+void DMXLineDecoder::Process(const uint8_t *data, unsigned int size) {
+  if (!size) {
+    return;
+  }
+
+  if (!m_started) {
+    for (unsigned int i = 0; i < MAX_CHANNELS; i++) {
+      if (m_channels[i]) {
+        m_channels[i]->Start(m_samples, data[0] & (1 << i));
+      }
+    }
+    m_previous = data[0];
+    m_started = true;
+  }
+
+  m_edges.clear();
+  FindEdges(data, size, m_previous, m_channel_mask, &m_edges);
+  m_edge_count += m_edges.size();
+
+  vector<Edge>::const_iterator iter = m_edges.begin();
+  for (; iter != m_edges.end(); ++iter) {
+    uint8_t changed = iter->changed;
+    uint8_t sample = data[iter->offset];
+    while (changed) {
+      unsigned int channel = __builtin_ctz(changed);
+      m_channels[channel]->Edge(m_samples + iter->offset,
+                                sample & (1 << channel));
+      changed &= changed - 1;
+    }
+  }
+
+  m_samples += size;
+  m_previous = data[size - 1];
+  for (unsigned int i = 0; i < MAX_CHANNELS; i++) {
+    if (m_channels[i]) {
+      m_channels[i]->Advance(m_samples);
+    }
+  }
+}
+
+
+void DMXLineDecoder::Reset() {
+  for (unsigned int i = 0; i < MAX_CHANNELS; i++) {
+    if (m_channels[i]) {
+      m_channels[i]->Flush();
+    }
+  }
+  m_started = false;
+}
+
+
+void DMXLineDecoder::FrameReceived(unsigned int channel, const uint8_t *data,
+                                   unsigned int length) {
+  m_frames++;
+  if (m_callback.get()) {
+    m_callback->Run(channel, data, length);
+  }
+}
+
+
+uint64_t DMXLineDecoder::MicroSecondsToSamples(unsigned int sample_rate,
+                                               unsigned int micro_seconds) {
+  // Round up, so a duration of this many samples is at least micro_seconds.
+  return (static_cast<uint64_t>(micro_seconds) * sample_rate + 999999) /
+         1000000;
+}
@@ -0,0 +1,126 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * DMXLineDecoder.h
+ * Decode DMX / RDM frames from logic analyzer samples.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef TOOLS_LOGIC_DMXLINEDECODER_H_
+#define TOOLS_LOGIC_DMXLINEDECODER_H_
+
+#include <ola/Callback.h>
+#include <ola/base/Macro.h>
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "tools/logic/EdgeFinder.h"
+
+/**
+ * Decode DMX frames from a stream of samples.
+ *
+ * Each sample is a byte, and each bit of the byte is a separate channel, so
+ * up to 8 lines can be decoded from one capture. Rather than running a state
+ * machine for every sample, the decoder finds the edges in each block of
+ * samples, see EdgeFinder.h, and only does work when a line changes. The
+ * bits of a slot are sampled at the middle of each bit period, measured from
+ * the falling edge of the start bit.
+ */
+class DMXLineDecoder {
+ public:
+  /**
+   * Called with the channel and the frame, including the start code.
+   */
+  typedef ola::Callback3<void, unsigned int, const uint8_t*, unsigned int>
+      FrameCallback;
+
+  /**
+   * @brief Create a new DMXLineDecoder.
+   * @param callback the callback to run when a frame is received, ownership
+   *   is transferred.
+   * @param sample_rate the sample rate in Hz.
+   * @param channels the channels to decode, as a bit mask.
+   */
+  DMXLineDecoder(FrameCallback *callback,
+                 unsigned int sample_rate,
+                 uint8_t channels = 0x01);
+  ~DMXLineDecoder();
+
+  /**
+   * @brief Process a block of samples.
+   */
+  void Process(const uint8_t *data, unsigned int size);
+
+  /**
+   * @brief Reset the decoder, used if there is a gap in the stream.
+   *
+   * Frames which have all their slots are passed to the callback, partial
+   * slots are discarded.
+   */
+  void Reset();
+
+  uint64_t SampleCount() const { return m_samples; }
+  uint64_t EdgeCount() const { return m_edge_count; }
+  unsigned int FrameCount() const { return m_frames; }
+  unsigned int ErrorCount() const { return m_errors; }
+
+  static const unsigned int MAX_CHANNELS = 8;
+
+ private:
+  struct Timing {
+    // The middle of the start bit, the 8 data bits and the 2 stop bits, in
+    // samples from the start of the slot.
+    uint64_t bit_centre[11];
+    uint64_t min_break;
+    uint64_t min_mab;
+    uint64_t max_mark;
+  };
+
+  class ChannelDecoder;
+
+  std::auto_ptr<FrameCallback> m_callback;
+  const uint8_t m_channel_mask;
+  Timing m_timing;
+  ChannelDecoder *m_channels[MAX_CHANNELS];
+  std::vector<Edge> m_edges;
+
+  bool m_started;
+  uint8_t m_previous;
+  // The index of the first sample of the next block.
+  uint64_t m_samples;
+  uint64_t m_edge_count;
+  unsigned int m_frames;
+  unsigned int m_errors;
+
+  void FrameReceived(unsigned int channel, const uint8_t *data,
+                     unsigned int length);
+  void Error() { m_errors++; }
+
+  static uint64_t MicroSecondsToSamples(unsigned int sample_rate,
+                                        unsigned int micro_seconds);
+
+  static const unsigned int DMX_BITRATE = 250000;
+  // These are all in microseconds and are the receiver side limits.
+  static const unsigned int MIN_BREAK_TIME = 88;
+  static const unsigned int MIN_MAB_TIME = 8;
+  // The longest mark after break or between slots before the frame is
+  // considered complete.
+  static const unsigned int MAX_MARK_TIME = 1000000;
+
+  DISALLOW_COPY_AND_ASSIGN(DMXLineDecoder);
+};
+#endif  // TOOLS_LOGIC_DMXLINEDECODER_H_
@@ -0,0 +1,402 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * DMXLineDecoderTest.cpp
+ * Test fixture for the DMXLineDecoder.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <ola/Callback.h>
+#include <ola/Logging.h>
+#include <ola/base/Array.h>
+#include <stdint.h>
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ola/testing/TestUtils.h"
+#include "tools/logic/DMXLineDecoder.h"
+
+using std::string;
+using std::vector;
+
+/**
+ * Generates the samples for a single line.
+ */
+class LineGenerator {
+ public:
+  explicit LineGenerator(unsigned int sample_rate)
+      : m_sample_rate(sample_rate),
+        m_time(0) {
+  }
+
+  void Mark(double micro_seconds) { Level(true, micro_seconds); }
+  void Break(double micro_seconds) { Level(false, micro_seconds); }
+
+  void Slot(uint8_t value, bool stop_bits = true) {
+    Level(false, BIT_TIME);
+    for (unsigned int i = 0; i < 8; i++) {
+      Level(value & (1 << i), BIT_TIME);
+    }
+    Level(stop_bits, 2 * BIT_TIME);
+  }
+
+  void Frame(const uint8_t *data, unsigned int length,
+             double break_time = 176, double mab = 12,
+             double inter_slot = 0) {
+    Break(break_time);
+    Mark(mab);
+    for (unsigned int i = 0; i < length; i++) {
+      Slot(data[i]);
+      if (inter_slot > 0) {
+        Mark(inter_slot);
+      }
+    }
+  }
+
+  const vector<bool>& Samples() const { return m_samples; }
+
+ private:
+  const unsigned int m_sample_rate;
+  double m_time;
+  vector<bool> m_samples;
+
+  void Level(bool level, double micro_seconds) {
+    m_time += micro_seconds;
+    size_t end = static_cast<size_t>(m_time * m_sample_rate / 1000000 + 0.5);
+    m_samples.resize(std::max(end, m_samples.size()), level);
+  }
+
+  static const double BIT_TIME;
+};
+
+const double LineGenerator::BIT_TIME = 4.0;
+
+
+class DMXLineDecoderTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(DMXLineDecoderTest);
+  CPPUNIT_TEST(testFrames);
+  CPPUNIT_TEST(testBlockSizes);
+  CPPUNIT_TEST(testSampleRates);
+  CPPUNIT_TEST(testMultipleChannels);
+  CPPUNIT_TEST(testMarkTimeout);
+  CPPUNIT_TEST(testErrors);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void setUp() {
+    ola::InitLogging(ola::OLA_LOG_INFO, ola::OLA_LOG_STDERR);
+  }
+
+  void testFrames();
+  void testBlockSizes();
+  void testSampleRates();
+  void testMultipleChannels();
+  void testMarkTimeout();
+  void testErrors();
+
+ private:
+  struct Frame {
+    unsigned int channel;
+    string data;
+  };
+
+  vector<Frame> m_frames;
+
+  void FrameReceived(unsigned int channel, const uint8_t *data,
+                     unsigned int length) {
+    Frame frame;
+    frame.channel = channel;
+    frame.data.assign(reinterpret_cast<const char*>(data), length);
+    m_frames.push_back(frame);
+  }
+
+  DMXLineDecoder *NewDecoder(unsigned int sample_rate, uint8_t channels) {
+    m_frames.clear();
+    return new DMXLineDecoder(
+        ola::NewCallback(this, &DMXLineDecoderTest::FrameReceived),
+        sample_rate, channels);
+  }
+
+  void Run(DMXLineDecoder *decoder, const vector<uint8_t> &samples,
+           unsigned int block_size) {
+    for (unsigned int i = 0; i < samples.size(); i += block_size) {
+      decoder->Process(&samples[i], std::min(
+          block_size, static_cast<unsigned int>(samples.size() - i)));
+    }
+  }
+
+  void CheckFrame(const ola::testing::SourceLine &source_line,
+                  unsigned int index, unsigned int channel,
+                  const uint8_t *data, unsigned int length);
+
+  static vector<uint8_t> Combine(const vector<LineGenerator*> &lines);
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(DMXLineDecoderTest);
+
+namespace {
+const uint8_t DMX_FRAME[] = {0x00, 0x01, 0x80, 0x55, 0xaa, 0xff, 0xfe, 0x7f};
+const uint8_t RDM_FRAME[] = {
+  0xcc, 0x01, 0x18, 0x7a, 0x70, 0x00, 0x00, 0x00, 0x01, 0x7a, 0x70, 0x12,
+  0x34, 0x56, 0x78, 0x00, 0x01, 0x00, 0x00, 0x20, 0x00, 0x60, 0x00, 0x04,
+  0x40};
+}  // namespace
+
+
+/**
+ * Build the samples from the lines, line n is channel n. Lines are padded
+ * with a mark to the same length.
+ */
+vector<uint8_t> DMXLineDecoderTest::Combine(
+    const vector<LineGenerator*> &lines) {
+  size_t size = 0;
+  for (unsigned int i = 0; i < lines.size(); i++) {
+    size = std::max(size, lines[i]->Samples().size());
+  }
+
+  vector<uint8_t> samples(size, 0);
+  for (unsigned int i = 0; i < lines.size(); i++) {
+    const vector<bool> &line = lines[i]->Samples();
+    for (size_t j = 0; j < size; j++) {
+      if (j >= line.size() || line[j]) {
+        samples[j] |= static_cast<uint8_t>(1 << i);
+      }
+    }
+  }
+  return samples;
+}
+
+
+void DMXLineDecoderTest::CheckFrame(
+    const ola::testing::SourceLine &source_line,
+    unsigned int index, unsigned int channel, const uint8_t *data,
+    unsigned int length) {
+  ola::testing::_FailIf(source_line, index >= m_frames.size(),
+                        "Missing frame");
+  ola::testing::_AssertEquals(source_line, channel, m_frames[index].channel,
+                              "Channels differ");
+  ola::testing::ASSERT_DATA_EQUALS(
+      source_line, data, length,
+      reinterpret_cast<const uint8_t*>(m_frames[index].data.data()),
+      m_frames[index].data.size());
+}
+
+
+/*
+ * Decode DMX and RDM frames at 4MHz.
+ */
+void DMXLineDecoderTest::testFrames() {
+  LineGenerator line(4000000);
+  line.Mark(50);
+  line.Frame(DMX_FRAME, arraysize(DMX_FRAME), 100, 12, 10);
+  line.Mark(30);
+  line.Frame(RDM_FRAME, arraysize(RDM_FRAME));
+  line.Mark(20);
+  // A minimum break and mark after break.
+  line.Frame(DMX_FRAME, arraysize(DMX_FRAME), 92, 12);
+  line.Mark(100);
+
+  vector<LineGenerator*> lines(1, &line);
+  vector<uint8_t> samples = Combine(lines);
+
+  std::auto_ptr<DMXLineDecoder> decoder(NewDecoder(4000000, 0x01));
+  Run(decoder.get(), samples, 4096);
+
+  // The last frame isn't complete until we see the break or a long mark
+  OLA_ASSERT_EQ(static_cast<size_t>(2), m_frames.size());
+  decoder->Reset();
+  OLA_ASSERT_EQ(static_cast<size_t>(3), m_frames.size());
+  CheckFrame(OLA_SOURCELINE(), 0, 0, DMX_FRAME, arraysize(DMX_FRAME));
+  CheckFrame(OLA_SOURCELINE(), 1, 0, RDM_FRAME, arraysize(RDM_FRAME));
+  CheckFrame(OLA_SOURCELINE(), 2, 0, DMX_FRAME, arraysize(DMX_FRAME));
+  OLA_ASSERT_EQ(3u, decoder->FrameCount());
+  OLA_ASSERT_EQ(0u, decoder->ErrorCount());
+  OLA_ASSERT_EQ(static_cast<uint64_t>(samples.size()),
+                decoder->SampleCount());
+}
+
+
+/*
+ * Check that the way the samples are split into blocks doesn't matter.
+ */
+void DMXLineDecoderTest::testBlockSizes() {
+  LineGenerator line(4000000);
+  line.Mark(50);
+  line.Frame(DMX_FRAME, arraysize(DMX_FRAME));
+  line.Frame(RDM_FRAME, arraysize(RDM_FRAME), 176, 12, 3);
+  line.Break(100);
+
+  vector<LineGenerator*> lines(1, &line);
+  vector<uint8_t> samples = Combine(lines);
+
+  const unsigned int block_sizes[] = {1, 3, 16, 17, 33, 1000};
+  for (unsigned int i = 0; i < arraysize(block_sizes); i++) {
+    std::auto_ptr<DMXLineDecoder> decoder(NewDecoder(4000000, 0x01));
+    Run(decoder.get(), samples, block_sizes[i]);
+
+    std::ostringstream str;
+    str << "Block size " << block_sizes[i];
+    OLA_ASSERT_EQ_MSG(static_cast<size_t>(2), m_frames.size(), str.str());
+    CheckFrame(OLA_SOURCELINE(), 0, 0, DMX_FRAME, arraysize(DMX_FRAME));
+    CheckFrame(OLA_SOURCELINE(), 1, 0, RDM_FRAME, arraysize(RDM_FRAME));
+  }
+}
+
+
+/*
+ * Check a range of sample rates.
+ */
+void DMXLineDecoderTest::testSampleRates() {
+  const unsigned int rates[] = {1000000, 2000000, 3000000, 12000000, 24000000};
+  for (unsigned int i = 0; i < arraysize(rates); i++) {
+    LineGenerator line(rates[i]);
+    line.Mark(50);
+    line.Frame(DMX_FRAME, arraysize(DMX_FRAME), 100, 12, 4);
+    line.Frame(RDM_FRAME, arraysize(RDM_FRAME));
+    line.Break(100);
+
+    vector<LineGenerator*> lines(1, &line);
+    vector<uint8_t> samples = Combine(lines);
+
+    std::auto_ptr<DMXLineDecoder> decoder(NewDecoder(rates[i], 0x01));
+    Run(decoder.get(), samples, 512);
+
+    std::ostringstream str;
+    str << "Sample rate " << rates[i];
+    OLA_ASSERT_EQ_MSG(static_cast<size_t>(2), m_frames.size(), str.str());
+    CheckFrame(OLA_SOURCELINE(), 0, 0, DMX_FRAME, arraysize(DMX_FRAME));
+    CheckFrame(OLA_SOURCELINE(), 1, 0, RDM_FRAME, arraysize(RDM_FRAME));
+  }
+}
+
+
+/*
+ * Decode several lines at once, each with different timing.
+ */
+void DMXLineDecoderTest::testMultipleChannels() {
+  LineGenerator generators[DMXLineDecoder::MAX_CHANNELS] = {
+    LineGenerator(4000000), LineGenerator(4000000), LineGenerator(4000000),
+    LineGenerator(4000000), LineGenerator(4000000), LineGenerator(4000000),
+    LineGenerator(4000000), LineGenerator(4000000),
+  };
+  vector<LineGenerator*> lines;
+  for (unsigned int i = 0; i < DMXLineDecoder::MAX_CHANNELS; i++) {
+    LineGenerator *line = &generators[i];
+    line->Mark(10 + 7 * i);
+    // Each channel gets a different length frame.
+    line->Frame(DMX_FRAME, i + 1, 100 + i, 12 + i, i);
+    line->Frame(RDM_FRAME, arraysize(RDM_FRAME));
+    line->Break(100);
+    lines.push_back(line);
+  }
+  vector<uint8_t> samples = Combine(lines);
+
+  std::auto_ptr<DMXLineDecoder> decoder(NewDecoder(4000000, 0xff));
+  Run(decoder.get(), samples, 4096);
+  OLA_ASSERT_EQ(static_cast<size_t>(2 * DMXLineDecoder::MAX_CHANNELS),
+                m_frames.size());
+  OLA_ASSERT_EQ(0u, decoder->ErrorCount());
+
+  vector<unsigned int> dmx_frames(DMXLineDecoder::MAX_CHANNELS, 0);
+  vector<unsigned int> rdm_frames(DMXLineDecoder::MAX_CHANNELS, 0);
+  for (unsigned int i = 0; i < m_frames.size(); i++) {
+    unsigned int channel = m_frames[i].channel;
+    OLA_ASSERT_LT(channel, DMXLineDecoder::MAX_CHANNELS);
+    if (m_frames[i].data[0] == 0) {
+      CheckFrame(OLA_SOURCELINE(), i, channel, DMX_FRAME, channel + 1);
+      dmx_frames[channel]++;
+    } else {
+      CheckFrame(OLA_SOURCELINE(), i, channel, RDM_FRAME,
+                 arraysize(RDM_FRAME));
+      rdm_frames[channel]++;
+    }
+  }
+  for (unsigned int i = 0; i < DMXLineDecoder::MAX_CHANNELS; i++) {
+    OLA_ASSERT_EQ(1u, dmx_frames[i]);
+    OLA_ASSERT_EQ(1u, rdm_frames[i]);
+  }
+
+  // Now only decode some of the channels
+  decoder.reset(NewDecoder(4000000, 0x24));
+  Run(decoder.get(), samples, 4096);
+  OLA_ASSERT_EQ(static_cast<size_t>(4), m_frames.size());
+  for (unsigned int i = 0; i < m_frames.size(); i++) {
+    OLA_ASSERT_TRUE(m_frames[i].channel == 2 || m_frames[i].channel == 5);
+  }
+}
+
+
+/*
+ * A long mark ends the frame.
+ */
+void DMXLineDecoderTest::testMarkTimeout() {
+  LineGenerator line(1000000);
+  line.Mark(50);
+  line.Frame(DMX_FRAME, arraysize(DMX_FRAME));
+  line.Mark(999000);
+
+  vector<LineGenerator*> lines(1, &line);
+  vector<uint8_t> samples = Combine(lines);
+  std::auto_ptr<DMXLineDecoder> decoder(NewDecoder(1000000, 0x01));
+  Run(decoder.get(), samples, 65536);
+  OLA_ASSERT_TRUE(m_frames.empty());
+
+  // Another 1ms of mark
+  vector<uint8_t> mark(1000, 0x01);
+  decoder->Process(&mark[0], mark.size());
+  OLA_ASSERT_EQ(static_cast<size_t>(1), m_frames.size());
+  CheckFrame(OLA_SOURCELINE(), 0, 0, DMX_FRAME, arraysize(DMX_FRAME));
+}
+
+
+/*
+ * Check the decoder recovers from bad frames.
+ */
+void DMXLineDecoderTest::testErrors() {
+  LineGenerator line(4000000);
+  line.Mark(50);
+  // A break that's too short is ignored.
+  line.Break(40);
+  line.Mark(20);
+  line.Slot(0x00);
+  // The mark after break is too short.
+  line.Break(100);
+  line.Mark(4);
+  line.Slot(0x00);
+  line.Slot(0x01);
+  line.Mark(20);
+  // A framing error in the 3rd slot.
+  line.Frame(DMX_FRAME, 2);
+  line.Slot(0x42, false);
+  line.Mark(20);
+  // And finally a good frame.
+  line.Frame(DMX_FRAME, arraysize(DMX_FRAME));
+  line.Break(100);
+
+  vector<LineGenerator*> lines(1, &line);
+  vector<uint8_t> samples = Combine(lines);
+  std::auto_ptr<DMXLineDecoder> decoder(NewDecoder(4000000, 0x01));
+  Run(decoder.get(), samples, 256);
+
+  OLA_ASSERT_EQ(2u, decoder->ErrorCount());
+  // The partial frame is passed on.
+  OLA_ASSERT_EQ(static_cast<size_t>(2), m_frames.size());
+  CheckFrame(OLA_SOURCELINE(), 0, 0, DMX_FRAME, 2);
+  CheckFrame(OLA_SOURCELINE(), 1, 0, DMX_FRAME, arraysize(DMX_FRAME));
+}
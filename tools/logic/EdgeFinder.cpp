@@ -0,0 +1,258 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * EdgeFinder.cpp
+ * Find the transitions in a block of logic analyzer samples.
+ * Copyright (C) 2026 Simon Newton
+ *
+ * Each kernel XORs a vector of samples with the same vector shifted by one
+ * sample, and masks off the channels we don't care about. If the result is
+ * zero, which is the common case, the whole vector is skipped.
+ */
+
+#include <string.h>
+#include <vector>
+
+#include "tools/logic/EdgeFinder.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define OLA_EDGE_FINDER_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define OLA_EDGE_FINDER_NEON 1
+#include <arm_neon.h>
+#endif
+
+using std::vector;
+
+namespace {
+
+typedef void (*FindFunction)(const uint8_t *data, unsigned int size,
+                             uint8_t mask, vector<Edge> *edges);
+
+inline void AddEdge(unsigned int offset, uint8_t changed,
+                    vector<Edge> *edges) {
+  Edge edge;
+  edge.offset = offset;
+  edge.changed = changed;
+  edges->push_back(edge);
+}
+
+/*
+ * Check the samples in the range [offset, end), offset must be at least 1.
+ */
+void ScalarFind(const uint8_t *data, unsigned int offset, unsigned int end,
+                uint8_t mask, vector<Edge> *edges) {
+  for (unsigned int i = offset; i < end; i++) {
+    uint8_t changed = (data[i] ^ data[i - 1]) & mask;
+    if (changed) {
+      AddEdge(i, changed, edges);
+    }
+  }
+}
+
+/*
+ * The kernels compare each sample from data[1] onwards with the one before.
+ */
+void ScalarKernel(const uint8_t *data, unsigned int size, uint8_t mask,
+                  vector<Edge> *edges) {
+  const uint64_t wide_mask = mask * 0x0101010101010101ull;
+  unsigned int i = 1;
+  for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+    uint64_t current, previous;
+    memcpy(&current, data + i, sizeof(current));
+    memcpy(&previous, data + i - 1, sizeof(previous));
+    if ((current ^ previous) & wide_mask) {
+      ScalarFind(data, i, i + sizeof(uint64_t), mask, edges);
+    }
+  }
+  ScalarFind(data, i, size, mask, edges);
+}
+
+#ifdef OLA_EDGE_FINDER_X86
+/*
+ * Add the edges flagged in a movemask result.
+ */
+inline void AddFlaggedEdges(const uint8_t *data, unsigned int offset,
+                            uint32_t flags, uint8_t mask,
+                            vector<Edge> *edges) {
+  while (flags) {
+    unsigned int i = offset + __builtin_ctz(flags);
+    AddEdge(i, (data[i] ^ data[i - 1]) & mask, edges);
+    flags &= flags - 1;
+  }
+}
+
+__attribute__((target("sse2")))
+void SSE2Kernel(const uint8_t *data, unsigned int size, uint8_t mask,
+                vector<Edge> *edges) {
+  static const unsigned int WIDTH = sizeof(__m128i);
+  const __m128i wide_mask = _mm_set1_epi8(static_cast<char>(mask));
+  const __m128i zero = _mm_setzero_si128();
+  unsigned int i = 1;
+  for (; i + WIDTH <= size; i += WIDTH) {
+    __m128i changed = _mm_and_si128(
+        _mm_xor_si128(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)),
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i - 1))),
+        wide_mask);
+    uint32_t flags = ~_mm_movemask_epi8(_mm_cmpeq_epi8(changed, zero)) &
+                     0xffff;
+    AddFlaggedEdges(data, i, flags, mask, edges);
+  }
+  ScalarFind(data, i, size, mask, edges);
+}
+
+__attribute__((target("avx2")))
+void AVX2Kernel(const uint8_t *data, unsigned int size, uint8_t mask,
+                vector<Edge> *edges) {
+  static const unsigned int WIDTH = sizeof(__m256i);
+  const __m256i wide_mask = _mm256_set1_epi8(static_cast<char>(mask));
+  const __m256i zero = _mm256_setzero_si256();
+  unsigned int i = 1;
+  for (; i + WIDTH <= size; i += WIDTH) {
+    __m256i changed = _mm256_and_si256(
+        _mm256_xor_si256(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)),
+            _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(data + i - 1))),
+        wide_mask);
+    uint32_t flags = ~static_cast<uint32_t>(
+        _mm256_movemask_epi8(_mm256_cmpeq_epi8(changed, zero)));
+    AddFlaggedEdges(data, i, flags, mask, edges);
+  }
+  ScalarFind(data, i, size, mask, edges);
+}
+#endif  // OLA_EDGE_FINDER_X86
+
+#ifdef OLA_EDGE_FINDER_NEON
+void NEONKernel(const uint8_t *data, unsigned int size, uint8_t mask,
+                vector<Edge> *edges) {
+  static const unsigned int WIDTH = sizeof(uint8x16_t);
+  const uint8x16_t wide_mask = vdupq_n_u8(mask);
+  unsigned int i = 1;
+  for (; i + WIDTH <= size; i += WIDTH) {
+    uint64x2_t changed = vreinterpretq_u64_u8(vandq_u8(
+        veorq_u8(vld1q_u8(data + i), vld1q_u8(data + i - 1)), wide_mask));
+    if (vgetq_lane_u64(changed, 0) | vgetq_lane_u64(changed, 1)) {
+      ScalarFind(data, i, i + WIDTH, mask, edges);
+    }
+  }
+  ScalarFind(data, i, size, mask, edges);
+}
+#endif  // OLA_EDGE_FINDER_NEON
+
+FindFunction KernelFunction(EdgeFinderKernel kernel) {
+  switch (kernel) {
+#ifdef OLA_EDGE_FINDER_X86
+    case EDGE_FINDER_SSE2:
+      return SSE2Kernel;
+    case EDGE_FINDER_AVX2:
+      return AVX2Kernel;
+#endif  // OLA_EDGE_FINDER_X86
+#ifdef OLA_EDGE_FINDER_NEON
+    case EDGE_FINDER_NEON:
+      return NEONKernel;
+#endif  // OLA_EDGE_FINDER_NEON
+    default:
+      return ScalarKernel;
+  }
+}
+
+EdgeFinderKernel SelectKernel() {
+  const EdgeFinderKernel preferred[] = {
+    EDGE_FINDER_AVX2, EDGE_FINDER_SSE2, EDGE_FINDER_NEON
+  };
+  for (unsigned int i = 0; i < sizeof(preferred) / sizeof(preferred[0]);
+       i++) {
+    if (EdgeFinderKernelSupported(preferred[i])) {
+      return preferred[i];
+    }
+  }
+  return EDGE_FINDER_SCALAR;
+}
+}  // namespace
+
+
+void FindEdges(const uint8_t *data, unsigned int size, uint8_t previous,
+               uint8_t mask, vector<Edge> *edges) {
+  static const FindFunction find = KernelFunction(ActiveEdgeFinderKernel());
+  if (!size) {
+    return;
+  }
+  uint8_t changed = (data[0] ^ previous) & mask;
+  if (changed) {
+    AddEdge(0, changed, edges);
+  }
+  find(data, size, mask, edges);
+}
+
+
+void FindEdgesWithKernel(EdgeFinderKernel kernel, const uint8_t *data,
+                         unsigned int size, uint8_t previous, uint8_t mask,
+                         vector<Edge> *edges) {
+  if (!size) {
+    return;
+  }
+  uint8_t changed = (data[0] ^ previous) & mask;
+  if (changed) {
+    AddEdge(0, changed, edges);
+  }
+  KernelFunction(kernel)(data, size, mask, edges);
+}
+
+
+bool EdgeFinderKernelSupported(EdgeFinderKernel kernel) {
+  switch (kernel) {
+    case EDGE_FINDER_SCALAR:
+      return true;
+#ifdef OLA_EDGE_FINDER_X86
+    case EDGE_FINDER_SSE2:
+      return __builtin_cpu_supports("sse2");
+    case EDGE_FINDER_AVX2:
+      return __builtin_cpu_supports("avx2");
+#endif  // OLA_EDGE_FINDER_X86
+#ifdef OLA_EDGE_FINDER_NEON
+    case EDGE_FINDER_NEON:
+      return true;
+#endif  // OLA_EDGE_FINDER_NEON
+    default:
+      return false;
+  }
+}
+
+
+EdgeFinderKernel ActiveEdgeFinderKernel() {
+  static const EdgeFinderKernel kernel = SelectKernel();
+  return kernel;
+}
+
+
+const char *EdgeFinderKernelName(EdgeFinderKernel kernel) {
+  switch (kernel) {
+    case EDGE_FINDER_SCALAR:
+      return "scalar";
+    case EDGE_FINDER_SSE2:
+      return "sse2";
+    case EDGE_FINDER_AVX2:
+      return "avx2";
+    case EDGE_FINDER_NEON:
+      return "neon";
+    default:
+      return "unknown";
+  }
+}
@@ -0,0 +1,86 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * EdgeFinder.h
+ * Find the transitions in a block of logic analyzer samples.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef TOOLS_LOGIC_EDGEFINDER_H_
+#define TOOLS_LOGIC_EDGEFINDER_H_
+
+#include <stdint.h>
+#include <vector>
+
+/**
+ * Each sample is a byte holding the state of 8 channels. A sample where any
+ * of the channels we're interested in differs from the sample before it is
+ * an edge.
+ *
+ * At typical sample rates the signal is stable for many samples at a time,
+ * so the search compares a vector of samples at once and only looks at the
+ * individual samples when something has changed. The implementation is
+ * selected at runtime, with a scalar version used as the fallback.
+ */
+typedef enum {
+  EDGE_FINDER_SCALAR,  /**< 8 samples at a time in a 64 bit word */
+  EDGE_FINDER_SSE2,  /**< 16 samples at a time using SSE2 */
+  EDGE_FINDER_AVX2,  /**< 32 samples at a time using AVX2 */
+  EDGE_FINDER_NEON,  /**< 16 samples at a time using ARM NEON */
+} EdgeFinderKernel;
+
+struct Edge {
+  // The index of the sample in the block.
+  unsigned int offset;
+  // The channels which changed.
+  uint8_t changed;
+};
+
+/**
+ * @brief Find the edges in a block of samples.
+ * @param data the samples.
+ * @param size the number of samples.
+ * @param previous the last sample of the previous block.
+ * @param mask the channels to look at.
+ * @param edges the edges are appended to this.
+ */
+void FindEdges(const uint8_t *data, unsigned int size, uint8_t previous,
+               uint8_t mask, std::vector<Edge> *edges);
+
+/**
+ * @brief Find the edges using a specific kernel.
+ *
+ * This is used by the tests and benchmarks, everything else should use
+ * FindEdges().
+ */
+void FindEdgesWithKernel(EdgeFinderKernel kernel, const uint8_t *data,
+                         unsigned int size, uint8_t previous, uint8_t mask,
+                         std::vector<Edge> *edges);
+
+/**
+ * @brief Check if a kernel can run on this host.
+ */
+bool EdgeFinderKernelSupported(EdgeFinderKernel kernel);
+
+/**
+ * @brief Return the kernel FindEdges() uses.
+ */
+EdgeFinderKernel ActiveEdgeFinderKernel();
+
+/**
+ * @brief Return the name of a kernel, used for logging.
+ */
+const char *EdgeFinderKernelName(EdgeFinderKernel kernel);
+#endif  // TOOLS_LOGIC_EDGEFINDER_H_
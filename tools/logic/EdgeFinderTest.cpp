@@ -0,0 +1,155 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * EdgeFinderTest.cpp
+ * Test fixture for the edge finder.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <stdint.h>
+#include <sstream>
+#include <vector>
+
+#include "ola/testing/TestUtils.h"
+#include "tools/logic/EdgeFinder.h"
+
+using std::vector;
+
+class EdgeFinderTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(EdgeFinderTest);
+  CPPUNIT_TEST(testEdges);
+  CPPUNIT_TEST(testKernelsAgree);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void testEdges();
+  void testKernelsAgree();
+
+ private:
+  void Reference(const uint8_t *data, unsigned int size, uint8_t previous,
+                 uint8_t mask, vector<Edge> *edges);
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(EdgeFinderTest);
+
+
+void EdgeFinderTest::Reference(const uint8_t *data, unsigned int size,
+                               uint8_t previous, uint8_t mask,
+                               vector<Edge> *edges) {
+  for (unsigned int i = 0; i < size; i++) {
+    uint8_t changed = (data[i] ^ previous) & mask;
+    if (changed) {
+      Edge edge;
+      edge.offset = i;
+      edge.changed = changed;
+      edges->push_back(edge);
+    }
+    previous = data[i];
+  }
+}
+
+
+/*
+ * Check the edges found in a simple block.
+ */
+void EdgeFinderTest::testEdges() {
+  const uint8_t data[] = {0x01, 0x01, 0x00, 0x00, 0x02, 0x03, 0x03, 0x81};
+  vector<Edge> edges;
+
+  FindEdges(data, 0, 0x00, 0xff, &edges);
+  OLA_ASSERT_TRUE(edges.empty());
+
+  FindEdges(data, sizeof(data), 0x00, 0x01, &edges);
+  OLA_ASSERT_EQ(static_cast<size_t>(3), edges.size());
+  OLA_ASSERT_EQ(0u, edges[0].offset);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(0x01), edges[0].changed);
+  OLA_ASSERT_EQ(2u, edges[1].offset);
+  OLA_ASSERT_EQ(5u, edges[2].offset);
+
+  // the previous sample matches, so there's no edge at the start
+  edges.clear();
+  FindEdges(data, sizeof(data), 0x01, 0x01, &edges);
+  OLA_ASSERT_EQ(static_cast<size_t>(2), edges.size());
+  OLA_ASSERT_EQ(2u, edges[0].offset);
+
+  edges.clear();
+  FindEdges(data, sizeof(data), 0x01, 0xff, &edges);
+  OLA_ASSERT_EQ(static_cast<size_t>(4), edges.size());
+  OLA_ASSERT_EQ(4u, edges[1].offset);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(0x02), edges[1].changed);
+  OLA_ASSERT_EQ(7u, edges[3].offset);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(0x82), edges[3].changed);
+
+  // nothing on the masked channels
+  edges.clear();
+  FindEdges(data, sizeof(data), 0x01, 0x70, &edges);
+  OLA_ASSERT_TRUE(edges.empty());
+}
+
+
+/*
+ * Check every kernel this host supports gives the same result as the
+ * reference, over a range of block sizes and alignments.
+ */
+void EdgeFinderTest::testKernelsAgree() {
+  const EdgeFinderKernel kernels[] = {
+    EDGE_FINDER_SCALAR, EDGE_FINDER_SSE2, EDGE_FINDER_AVX2, EDGE_FINDER_NEON
+  };
+  const uint8_t masks[] = {0x01, 0x80, 0x81, 0xff};
+  const unsigned int SIZE = 1000;
+
+  // Mostly long runs with the odd burst of noise, like a real capture.
+  uint8_t data[SIZE];
+  uint32_t seed = 42;
+  uint8_t value = 0;
+  for (unsigned int i = 0; i < SIZE; i++) {
+    seed = seed * 1103515245 + 12345;
+    uint32_t r = seed >> 16;
+    if (r % 13 == 0) {
+      value ^= static_cast<uint8_t>(r >> 8);
+    }
+    data[i] = value;
+  }
+
+  for (unsigned int k = 0; k < sizeof(kernels) / sizeof(kernels[0]); k++) {
+    if (!EdgeFinderKernelSupported(kernels[k])) {
+      continue;
+    }
+    for (unsigned int m = 0; m < sizeof(masks); m++) {
+      for (unsigned int offset = 0; offset < 3; offset++) {
+        for (unsigned int size = 0; size + offset <= SIZE;
+             size += (size < 80 ? 1 : 97)) {
+          vector<Edge> expected, edges;
+          Reference(data + offset, size, 0x55, masks[m], &expected);
+          FindEdgesWithKernel(kernels[k], data + offset, size, 0x55, masks[m],
+                              &edges);
+
+          std::ostringstream str;
+          str << EdgeFinderKernelName(kernels[k]) << ", mask "
+              << static_cast<int>(masks[m]) << ", offset " << offset
+              << ", size " << size;
+          OLA_ASSERT_EQ_MSG(expected.size(), edges.size(), str.str());
+          for (unsigned int i = 0; i < edges.size(); i++) {
+            OLA_ASSERT_EQ_MSG(expected[i].offset, edges[i].offset, str.str());
+            OLA_ASSERT_EQ_MSG(expected[i].changed, edges[i].changed,
+                              str.str());
+          }
+        }
+      }
+    }
+  }
+}
@@ -1,12 +1,33 @@
+# LIBRARIES
+##################################################
+noinst_LTLIBRARIES += tools/logic/liblogicdecoder.la
+tools_logic_liblogicdecoder_la_SOURCES = \
+    tools/logic/DMXLineDecoder.cpp \
+    tools/logic/DMXLineDecoder.h \
+    tools/logic/EdgeFinder.cpp \
+    tools/logic/EdgeFinder.h
+tools_logic_liblogicdecoder_la_LIBADD = common/libolacommon.la
+
+# PROGRAMS
+##################################################
 if HAVE_SALEAE_LOGIC
 bin_PROGRAMS += tools/logic/logic_rdm_sniffer
 endif
 
-tools_logic_logic_rdm_sniffer_SOURCES = \
-    tools/logic/DMXSignalProcessor.cpp \
-    tools/logic/DMXSignalProcessor.h \
-    tools/logic/logic-rdm-sniffer.cpp
+tools_logic_logic_rdm_sniffer_SOURCES = tools/logic/logic-rdm-sniffer.cpp
 tools_logic_logic_rdm_sniffer_LDADD = common/libolacommon.la \
+                                      tools/logic/liblogicdecoder.la \
                                       $(libSaleaeDevice_LIBS)
 
 EXTRA_DIST += tools/logic/README.md
+
+# TESTS
+##################################################
+test_programs += tools/logic/LogicDecoderTester
+
+tools_logic_LogicDecoderTester_SOURCES = \
+    tools/logic/DMXLineDecoderTest.cpp \
+    tools/logic/EdgeFinderTest.cpp
+tools_logic_LogicDecoderTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
+tools_logic_LogicDecoderTester_LDADD = $(COMMON_TESTING_LIBS) \
+                                       tools/logic/liblogicdecoder.la
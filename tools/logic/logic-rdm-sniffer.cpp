@@ -49,6 +49,7 @@
 #include <ola/rdm/UID.h>
 #include <ola/StringUtils.h>
 
+#include <iomanip>
 #include <iostream>
 #include <fstream>
 #include <memory>
@@ -56,7 +57,7 @@
 #include <vector>
 #include <queue>
 
-#include "tools/logic/DMXSignalProcessor.h"
+#include "tools/logic/DMXLineDecoder.h"
 
 using std::auto_ptr;
 using std::cerr;
@@ -89,8 +90,16 @@ DEFINE_s_default_bool(display_dmx, d, false,
 DEFINE_uint16(dmx_slot_limit, ola::DMX_UNIVERSE_SIZE,
               "Only display the first N slots of DMX data.");
 DEFINE_uint32(sample_rate, 4000000, "Sample rate in HZ.");
+DEFINE_uint8(channels, 0x01,
+             "A bit mask of the logic channels to decode, e.g. 3 for channels "
+             "0 & 1.");
 DEFINE_string(pid_location, "",
               "The directory containing the PID definitions.");
+DEFINE_string(capture, "",
+              "Write the raw samples from the device to this file.");
+DEFINE_string(replay, "",
+              "Decode the samples from a file written with --capture, rather "
+              "than reading from a device.");
 
 void OnReadData(U64 device_id, U8 *data, uint32_t data_length,
                 void *user_data);
@@ -104,8 +113,10 @@ class LogicReader {
         m_device_id(0),
         m_logic(NULL),
         m_ss(ss),
-        m_signal_processor(ola::NewCallback(this, &LogicReader::FrameReceived),
-                           sample_rate),
+        m_decoder(ola::NewCallback(this, &LogicReader::FrameReceived),
+                  sample_rate, FLAGS_channels),
+        m_show_channel(FLAGS_channels & (FLAGS_channels - 1)),
+        m_channel(0),
         m_pid_helper(FLAGS_pid_location.str(), 4),
         m_command_printer(&cout, &m_pid_helper) {
       m_pid_helper.Init();
@@ -115,8 +126,11 @@ class LogicReader {
     void DeviceConnected(U64 device, GenericInterface *interface);
     void DeviceDisconnected(U64 device);
     void DataReceived(U64 device, U8 *data, uint32_t data_length);
-    void FrameReceived(const uint8_t *data, unsigned int length);
+    void FrameReceived(unsigned int channel, const uint8_t *data,
+                       unsigned int length);
 
+    bool StartCapture(const string &filename);
+    bool Replay(const string &filename);
     void Stop();
 
     bool IsConnected() const {
@@ -130,17 +144,26 @@ class LogicReader {
     LogicInterface *m_logic;  // GUARDED_BY(m_mu);
     mutable Mutex m_mu;
     SelectServer *m_ss;
-    DMXSignalProcessor m_signal_processor;
+    DMXLineDecoder m_decoder;
+    // true if we're decoding more than one channel
+    const bool m_show_channel;
+    // the channel of the frame being displayed
+    unsigned int m_channel;
+    std::ofstream m_capture;
     PidStoreHelper m_pid_helper;
     CommandPrinter m_command_printer;
     Mutex m_data_mu;
     std::queue<U8*> m_free_data;
 
     void ProcessData(U8 *data, uint32_t data_length);
+    void DisplayChannel();
     void DisplayDMXFrame(const uint8_t *data, unsigned int length);
     void DisplayRDMFrame(const uint8_t *data, unsigned int length);
     void DisplayAlternateFrame(const uint8_t *data, unsigned int length);
     void DisplayRawData(const uint8_t *data, unsigned int length);
+
+    // The number of samples to read from the file at once.
+    static const unsigned int REPLAY_BLOCK_SIZE = 1 << 20;
 };
 
 LogicReader::~LogicReader() {
@@ -217,11 +240,13 @@ void LogicReader::DataReceived(U64 device, U8 *data, uint32_t data_length) {
 }
 
 
-void LogicReader::FrameReceived(const uint8_t *data, unsigned int length) {
+void LogicReader::FrameReceived(unsigned int channel, const uint8_t *data,
+                                unsigned int length) {
   if (!length) {
     return;
   }
 
+  m_channel = channel;
   switch (data[0]) {
     case 0:
       DisplayDMXFrame(data + 1, length - 1);
@@ -235,6 +260,68 @@ void LogicReader::FrameReceived(const uint8_t *data, unsigned int length) {
 }
 
 
+/**
+ * Write the raw samples from the device to a file, so they can be replayed
+ * later.
+ */
+bool LogicReader::StartCapture(const string &filename) {
+  m_capture.open(filename.c_str(), std::ios::out | std::ios::binary);
+  if (!m_capture.is_open()) {
+    OLA_WARN << "Failed to open " << filename;
+    return false;
+  }
+  return true;
+}
+
+
+/**
+ * Decode a file of samples as fast as we can, and report how long it took.
+ */
+bool LogicReader::Replay(const string &filename) {
+  std::ifstream input(filename.c_str(), std::ios::in | std::ios::binary);
+  if (!input.is_open()) {
+    OLA_WARN << "Failed to open " << filename;
+    return false;
+  }
+
+  vector<uint8_t> buffer(REPLAY_BLOCK_SIZE);
+  ola::Clock clock;
+  ola::TimeStamp start, end;
+  clock.CurrentMonotonicTime(&start);
+  while (input.good()) {
+    input.read(reinterpret_cast<char*>(&buffer[0]), buffer.size());
+    if (input.gcount() > 0) {
+      m_decoder.Process(&buffer[0], input.gcount());
+    }
+  }
+  m_decoder.Reset();
+  clock.CurrentMonotonicTime(&end);
+
+  if (input.bad()) {
+    OLA_WARN << "Error reading " << filename;
+    return false;
+  }
+
+  const double seconds = (end - start).InMicroSeconds() / 1000000.0;
+  const double capture_seconds = static_cast<double>(
+      m_decoder.SampleCount()) / m_sample_rate;
+  cout << std::flush;
+  cerr << std::dec << m_decoder.SampleCount() << " samples ("
+       << capture_seconds << "s), " << m_decoder.EdgeCount() << " edges, "
+       << m_decoder.FrameCount() << " frames, " << m_decoder.ErrorCount()
+       << " errors" << endl;
+  cerr << "Decoded in " << seconds << "s using the "
+       << EdgeFinderKernelName(ActiveEdgeFinderKernel()) << " edge finder";
+  if (seconds > 0) {
+    cerr << ", " << m_decoder.SampleCount() / seconds / 1000000
+         << " Msamples/s, " << capture_seconds / seconds
+         << "x real time";
+  }
+  cerr << endl;
+  return true;
+}
+
+
 void LogicReader::Stop() {
   MutexLocker lock(&m_mu);
   if (m_logic) {
@@ -250,7 +337,10 @@ void LogicReader::Stop() {
  * @param data_length the size of the data
  */
 void LogicReader::ProcessData(U8 *data, uint32_t data_length) {
-  m_signal_processor.Process(data, data_length, 0x01);
+  if (m_capture.is_open()) {
+    m_capture.write(reinterpret_cast<const char*>(data), data_length);
+  }
+  m_decoder.Process(data, data_length);
   DevicesManagerInterface::DeleteU8ArrayPtr(data);
 
   /*
@@ -266,11 +356,19 @@ void LogicReader::ProcessData(U8 *data, uint32_t data_length) {
 }
 
 
+void LogicReader::DisplayChannel() {
+  if (m_show_channel) {
+    cout << std::dec << "[" << m_channel << "] ";
+  }
+}
+
+
 void LogicReader::DisplayDMXFrame(const uint8_t *data, unsigned int length) {
   if (!FLAGS_display_dmx) {
     return;
   }
 
+  DisplayChannel();
   cout << "DMX " << std::dec;
   cout << length << ":" << std::hex;
   DisplayRawData(data, length);
@@ -282,8 +380,10 @@ void LogicReader::DisplayRDMFrame(const uint8_t *data, unsigned int length) {
     if (FLAGS_full_rdm) {
       cout << "---------------------------------------" << endl;
     }
+    DisplayChannel();
     command->Print(&m_command_printer, !FLAGS_full_rdm, true);
   } else {
+    DisplayChannel();
     cout << "RDM " << std::dec;
     cout << length << ":" << std::hex;
     DisplayRawData(data, length);
@@ -298,6 +398,7 @@ void LogicReader::DisplayAlternateFrame(const uint8_t *data,
   }
 
   unsigned int slot_count = length - 1;
+  DisplayChannel();
   cout << "SC " << ToHex(static_cast<int>(data[0]))
        << " " << slot_count << ":";
   DisplayRawData(data + 1, slot_count);
@@ -366,9 +467,23 @@ int main(int argc, char *argv[]) {
   ola::AppInit(&argc, argv, "[ options ]",
                "Decode DMX/RDM data from a Saleae Logic device");
 
+  if (!FLAGS_channels) {
+    OLA_FATAL << "No channels selected";
+    exit(ola::EXIT_USAGE);
+  }
+
   SelectServer ss;
   LogicReader reader(&ss, FLAGS_sample_rate);
 
+  if (!FLAGS_replay.str().empty()) {
+    return reader.Replay(FLAGS_replay.str()) ? ola::EXIT_OK : ola::EXIT_NOINPUT;
+  }
+
+  if (!FLAGS_capture.str().empty() &&
+      !reader.StartCapture(FLAGS_capture.str())) {
+    exit(ola::EXIT_CANTCREAT);
+  }
+
   DevicesManagerInterface::RegisterOnConnect(&OnConnect, &reader);
   DevicesManagerInterface::RegisterOnDisconnect(&OnDisconnect, &reader);
   DevicesManagerInterface::BeginConnect();
@@ -30,6 +30,7 @@
 #include <tchar.h>
 #endif  // _WIN32
 
+#include <ola/StringUtils.h>
 #include <ola/stl/STLUtils.h>
 #include "tools/ola_trigger/Action.h"
 #include "tools/ola_trigger/VariableInterpolator.h"
@@ -61,7 +62,25 @@ void VariableAssignmentAction::Execute(Context *context, uint8_t) {
  * @brief Execute the command
  */
 void CommandAction::Execute(Context *context, uint8_t) {
+  if (m_runner) {
+    vector<string> args;
+    if (!InterpolateArguments(context, &args)) {
+      OLA_WARN << "Failed to expand the arguments for " << m_command;
+      return;
+    }
+    OLA_INFO << "Queuing: " << m_command << " : ["
+             << ola::StringJoin(", ", vector<string>(args.begin() + 1,
+                                                     args.end()))
+             << "]";
+    m_runner->Execute(args);
+    return;
+  }
+
   char **args = BuildArgList(context);
+  if (!args) {
+    OLA_WARN << "Failed to expand the arguments for " << m_command;
+    return;
+  }
 
   if (ola::LogLevel() >= ola::OLA_LOG_INFO) {
     std::ostringstream str;
@@ -139,6 +158,28 @@ void CommandAction::Execute(Context *context, uint8_t) {
 }
 
 
+/**
+ * @brief Interpolate all the arguments.
+ * @param context the Context to use.
+ * @param args the command followed by the interpolated arguments.
+ * @returns false if one of the arguments couldn't be interpolated.
+ */
+bool CommandAction::InterpolateArguments(const Context *context,
+                                         vector<string> *args) {
+  args->reserve(m_arguments.size() + 1);
+  args->push_back(m_command);
+  vector<string>::const_iterator iter = m_arguments.begin();
+  for (; iter != m_arguments.end(); iter++) {
+    string result;
+    if (!InterpolateVariables(*iter, &result, *context)) {
+      return false;
+    }
+    args->push_back(result);
+  }
+  return true;
+}
+
+
 /**
  * Interpolate all the arguments, and return a pointer to an array of char*
  * pointers which can be passed to exec()
@@ -247,6 +288,7 @@ bool Slot::AddAction(const ValueInterval &interval_arg,
       new ValueInterval(interval_arg),
       rising_action,
       falling_action);
+  m_action_table.clear();
 
   if (m_actions.empty()) {
     m_actions.push_back(action_interval);
@@ -370,15 +412,12 @@ void Slot::TakeAction(Context *context,
     rising = value > m_old_value;
   }
 
-  Action *action = LocateMatchingAction(value, rising);
+  if (m_action_table.empty()) {
+    BuildActionTable();
+  }
+  Action *action = m_action_table[rising ? value : VALUE_COUNT + value];
   if (action) {
     action->Execute(context, value);
-  } else {
-    if (rising && m_default_rising_action) {
-      m_default_rising_action->Execute(context, value);
-    } else if (!rising && m_default_falling_action) {
-      m_default_falling_action->Execute(context, value);
-    }
   }
 
   m_old_value_defined = true;
@@ -503,6 +542,7 @@ bool Slot::SetDefaultAction(Action **action_to_set,
                             Action *new_action) {
   bool previous_default_set = false;
   new_action->Ref();
+  m_action_table.clear();
 
   if (*action_to_set) {
     previous_default_set = true;
@@ -511,3 +551,20 @@ bool Slot::SetDefaultAction(Action **action_to_set,
   *action_to_set = new_action;
   return previous_default_set;
 }
+
+
+/**
+ * @brief Resolve the action for every value, including the defaults.
+ *
+ * This means TakeAction() doesn't need to search the intervals.
+ */
+void Slot::BuildActionTable() {
+  m_action_table.resize(2 * VALUE_COUNT);
+  for (unsigned int value = 0; value < VALUE_COUNT; value++) {
+    Action *action = LocateMatchingAction(value, true);
+    m_action_table[value] = action ? action : m_default_rising_action;
+    action = LocateMatchingAction(value, false);
+    m_action_table[VALUE_COUNT + value] = (
+        action ? action : m_default_falling_action);
+  }
+}
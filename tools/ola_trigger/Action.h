@@ -27,6 +27,7 @@
 #include <string>
 #include <vector>
 
+#include "tools/ola_trigger/CommandRunner.h"
 #include "tools/ola_trigger/Context.h"
 
 /*
@@ -80,13 +81,18 @@ class VariableAssignmentAction: public Action {
 
 /**
  * @brief Command Action. This action executes a command.
+ *
+ * If a CommandRunner is provided the command is started from one of its
+ * worker threads, otherwise it's started in the calling thread.
  */
 class CommandAction: public Action {
  public:
   CommandAction(const std::string &command,
-                const std::vector<std::string> &arguments)
+                const std::vector<std::string> &arguments,
+                CommandRunner *runner = NULL)
       : m_command(command),
-        m_arguments(arguments) {
+        m_arguments(arguments),
+        m_runner(runner) {
   }
   virtual ~CommandAction() {}
 
@@ -95,7 +101,10 @@ class CommandAction: public Action {
  protected:
   const std::string m_command;
   std::vector<std::string> m_arguments;
+  CommandRunner *m_runner;
 
+  bool InterpolateArguments(const Context *context,
+                            std::vector<std::string> *args);
   char **BuildArgList(const Context *context);
   void FreeArgList(char **args);
   char *StringToDynamicChar(const std::string &str);
@@ -243,6 +252,11 @@ class Slot {
   typedef std::vector<ActionInterval> ActionVector;
   ActionVector m_actions;
 
+  // The action to run for each value, the first half is for rising values,
+  // the second half for falling. Built on the first call to TakeAction() and
+  // cleared whenever an action is added.
+  std::vector<Action*> m_action_table;
+
   bool ValueWithinIntervals(uint8_t value,
                             const ValueInterval &lower_interval,
                             const ValueInterval &upper_interval);
@@ -252,5 +266,8 @@ class Slot {
   std::string IntervalsAsString(const ActionVector::const_iterator &start,
                                 const ActionVector::const_iterator &end) const;
   bool SetDefaultAction(Action **action_to_set, Action *new_action);
+  void BuildActionTable();
+
+  static const unsigned int VALUE_COUNT = 256;
 };
 #endif  // TOOLS_OLA_TRIGGER_ACTION_H_
@@ -0,0 +1,136 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * CommandRunner.cpp
+ * Launch commands from a pool of worker threads.
+ * Copyright (C) 2026 Simon Newton
+ *
+ * fork() has to copy the page tables of the parent, which gets slow as the
+ * trigger config grows. posix_spawn() is allowed to use vfork() or
+ * clone(CLONE_VM) so the cost doesn't depend on the size of the process.
+ */
+
+#include <string.h>
+#ifndef _WIN32
+#include <spawn.h>
+#endif  // _WIN32
+#include <ola/Callback.h>
+#include <ola/Logging.h>
+#include <string>
+#include <vector>
+
+#include "tools/ola_trigger/CommandRunner.h"
+
+#ifndef _WIN32
+extern char **environ;
+#endif  // _WIN32
+
+using ola::thread::MutexLocker;
+using std::string;
+using std::vector;
+
+
+CommandRunner::CommandRunner(unsigned int worker_count,
+                             unsigned int max_queue_size)
+    : m_pool(worker_count),
+      m_max_queue_size(max_queue_size) {
+  memset(&m_stats, 0, sizeof(m_stats));
+}
+
+
+CommandRunner::~CommandRunner() {
+  Stop();
+}
+
+
+bool CommandRunner::Init() {
+  return m_pool.Init();
+}
+
+
+void CommandRunner::Stop() {
+  m_pool.JoinAll();
+}
+
+
+bool CommandRunner::Execute(const vector<string> &args) {
+  if (args.empty()) {
+    return false;
+  }
+
+  {
+    MutexLocker lock(&m_mutex);
+    if (m_stats.queued >= m_max_queue_size) {
+      m_stats.dropped++;
+      OLA_WARN << "Command queue full, dropping " << args[0] << ", "
+               << m_stats.dropped << " commands dropped so far";
+      return false;
+    }
+    m_stats.queued++;
+    if (m_stats.queued > m_stats.max_queued) {
+      m_stats.max_queued = m_stats.queued;
+    }
+  }
+
+  m_pool.Execute(ola::NewSingleCallback(this, &CommandRunner::Spawn,
+                                        new vector<string>(args)));
+  return true;
+}
+
+
+void CommandRunner::GetStats(Stats *stats) const {
+  MutexLocker lock(&m_mutex);
+  *stats = m_stats;
+}
+
+
+/**
+ * @brief Called in one of the worker threads.
+ * @param args the command and its arguments, ownership is transferred.
+ */
+void CommandRunner::Spawn(vector<string> *args) {
+  bool ok = false;
+#ifdef _WIN32
+  OLA_WARN << "posix_spawn isn't available, can't run " << (*args)[0];
+#else
+  vector<char*> argv;
+  argv.reserve(args->size() + 1);
+  vector<string>::const_iterator iter = args->begin();
+  for (; iter != args->end(); ++iter) {
+    // posix_spawn doesn't modify the arguments, the lack of const is
+    // historical.
+    argv.push_back(const_cast<char*>(iter->c_str()));
+  }
+  argv.push_back(NULL);
+
+  pid_t pid;
+  int error = posix_spawnp(&pid, argv[0], NULL, NULL, &argv[0], environ);
+  if (error) {
+    OLA_WARN << "Could not run " << (*args)[0] << ": " << strerror(error);
+  } else {
+    OLA_DEBUG << "Child for " << (*args)[0] << " is " << pid;
+    ok = true;
+  }
+#endif  // _WIN32
+  delete args;
+
+  MutexLocker lock(&m_mutex);
+  m_stats.queued--;
+  if (ok) {
+    m_stats.started++;
+  } else {
+    m_stats.failed++;
+  }
+}
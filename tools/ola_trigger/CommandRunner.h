@@ -0,0 +1,92 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * CommandRunner.h
+ * Launch commands from a pool of worker threads.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef TOOLS_OLA_TRIGGER_COMMANDRUNNER_H_
+#define TOOLS_OLA_TRIGGER_COMMANDRUNNER_H_
+
+#include <ola/base/Macro.h>
+#include <ola/thread/Mutex.h>
+#include <ola/thread/ThreadPool.h>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Runs commands off the DMX receive path.
+ *
+ * Commands are queued and then started by a pool of worker threads using
+ * posix_spawn, so a slow exec doesn't hold up the processing of the next
+ * frame. The queue is bounded, if it's full the command is dropped. Children
+ * aren't waited on, that's left to the SIGCHLD handler.
+ *
+ * With a single worker, commands are started in the order they were queued.
+ * With more than one, a command can be started before one queued ahead of
+ * it, so actions which rely on ordering (e.g. on followed by off) should use
+ * a single worker. In all cases the order the children run in is up to the
+ * scheduler.
+ */
+class CommandRunner {
+ public:
+  struct Stats {
+    unsigned int queued;  // the number of commands waiting to be started
+    unsigned int max_queued;  // the high water mark of queued
+    unsigned int started;
+    unsigned int failed;
+    unsigned int dropped;
+  };
+
+  /**
+   * @brief Create a new CommandRunner.
+   * @param worker_count the number of threads to start commands from. Use 1
+   *   to start commands in the order they're queued.
+   * @param max_queue_size the maximum number of commands waiting to start.
+   */
+  CommandRunner(unsigned int worker_count, unsigned int max_queue_size);
+  ~CommandRunner();
+
+  /**
+   * @brief Start the worker threads.
+   */
+  bool Init();
+
+  /**
+   * @brief Wait for the queued commands to start, and then stop the workers.
+   */
+  void Stop();
+
+  /**
+   * @brief Queue a command.
+   * @param args the command, followed by its arguments.
+   * @returns true if the command was queued, false if the queue was full.
+   */
+  bool Execute(const std::vector<std::string> &args);
+
+  void GetStats(Stats *stats) const;
+
+ private:
+  ola::thread::ThreadPool m_pool;
+  const unsigned int m_max_queue_size;
+  mutable ola::thread::Mutex m_mutex;
+  Stats m_stats;  // GUARDED_BY(m_mutex)
+
+  void Spawn(std::vector<std::string> *args);
+
+  DISALLOW_COPY_AND_ASSIGN(CommandRunner);
+};
+#endif  // TOOLS_OLA_TRIGGER_COMMANDRUNNER_H_
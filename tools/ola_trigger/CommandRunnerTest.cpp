@@ -0,0 +1,122 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * CommandRunnerTest.cpp
+ * Test fixture for the CommandRunner.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <ola/Logging.h>
+#include <ola/testing/TestUtils.h>
+#ifndef _WIN32
+#include <sys/wait.h>
+#endif  // _WIN32
+#include <string>
+#include <vector>
+
+#include "tools/ola_trigger/CommandRunner.h"
+
+using std::string;
+using std::vector;
+
+class CommandRunnerTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(CommandRunnerTest);
+  CPPUNIT_TEST(testQueueLimit);
+#ifndef _WIN32
+  CPPUNIT_TEST(testSpawn);
+#endif  // _WIN32
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void testQueueLimit();
+  void testSpawn();
+
+  void setUp() {
+    ola::InitLogging(ola::OLA_LOG_INFO, ola::OLA_LOG_STDERR);
+  }
+
+  void tearDown() {
+#ifndef _WIN32
+    // reap the children
+    while (waitpid(-1, NULL, 0) > 0) {}
+#endif  // _WIN32
+  }
+
+ private:
+  static vector<string> Command(const string &command) {
+    vector<string> args;
+    args.push_back(command);
+    return args;
+  }
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(CommandRunnerTest);
+
+
+/**
+ * Check commands are dropped once the queue is full.
+ */
+void CommandRunnerTest::testQueueLimit() {
+  // The workers haven't been started, so nothing leaves the queue.
+  CommandRunner runner(1, 3);
+  OLA_ASSERT_FALSE(runner.Execute(vector<string>()));
+  OLA_ASSERT_TRUE(runner.Execute(Command("true")));
+  OLA_ASSERT_TRUE(runner.Execute(Command("true")));
+  OLA_ASSERT_TRUE(runner.Execute(Command("true")));
+  OLA_ASSERT_FALSE(runner.Execute(Command("true")));
+  OLA_ASSERT_FALSE(runner.Execute(Command("true")));
+
+  CommandRunner::Stats stats;
+  runner.GetStats(&stats);
+  OLA_ASSERT_EQ(3u, stats.queued);
+  OLA_ASSERT_EQ(3u, stats.max_queued);
+  OLA_ASSERT_EQ(0u, stats.started);
+  OLA_ASSERT_EQ(2u, stats.dropped);
+
+  // Now start the workers, the queue should drain.
+  OLA_ASSERT_TRUE(runner.Init());
+  runner.Stop();
+  runner.GetStats(&stats);
+  OLA_ASSERT_EQ(0u, stats.queued);
+  OLA_ASSERT_EQ(3u, stats.max_queued);
+  OLA_ASSERT_EQ(3u, stats.started + stats.failed);
+  OLA_ASSERT_EQ(2u, stats.dropped);
+}
+
+
+/**
+ * Check commands are started.
+ */
+void CommandRunnerTest::testSpawn() {
+  CommandRunner runner(2, 10);
+  OLA_ASSERT_TRUE(runner.Init());
+
+  vector<string> args = Command("sh");
+  args.push_back("-c");
+  args.push_back("exit 0");
+  for (unsigned int i = 0; i < 5; i++) {
+    OLA_ASSERT_TRUE(runner.Execute(args));
+  }
+  runner.Stop();
+
+  CommandRunner::Stats stats;
+  runner.GetStats(&stats);
+  OLA_ASSERT_EQ(0u, stats.queued);
+  OLA_ASSERT_EQ(5u, stats.started);
+  OLA_ASSERT_EQ(0u, stats.failed);
+  OLA_ASSERT_EQ(0u, stats.dropped);
+}
@@ -17,15 +17,56 @@
  * Copyright (C) 2011 Simon Newton
  */
 
+#include <ola/Constants.h>
 #include <ola/DmxBuffer.h>
 #include <ola/Logging.h>
+#include <string.h>
 #include <algorithm>
 #include <vector>
 
 #include "tools/ola_trigger/DMXTrigger.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif  // __SSE2__
+
 using ola::DmxBuffer;
 
+namespace {
+
+const unsigned int BLOCK_SIZE = 16;
+
+/*
+ * Return a bit mask of the slots in a block of 16 which differ.
+ */
+inline uint32_t ChangedSlots(const uint8_t *data, const uint8_t *previous) {
+#if defined(__SSE2__)
+  __m128i equal = _mm_cmpeq_epi8(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(data)),
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(previous)));
+  return ~_mm_movemask_epi8(equal) & 0xffff;
+#else
+  uint64_t words[2], previous_words[2];
+  memcpy(words, data, BLOCK_SIZE);
+  memcpy(previous_words, previous, BLOCK_SIZE);
+  if (words[0] == previous_words[0] && words[1] == previous_words[1]) {
+    return 0;
+  }
+  uint32_t changed = 0;
+  for (unsigned int i = 0; i < BLOCK_SIZE; i++) {
+    if (data[i] != previous[i]) {
+      changed |= 1 << i;
+    }
+  }
+  return changed;
+#endif  // __SSE2__
+}
+
+bool SlotLessThan(const Slot *a, const Slot *b) {
+  return *a < *b;
+}
+}  // namespace
+
 
 /**
  * @brief Create a new trigger
@@ -33,22 +74,69 @@ using ola::DmxBuffer;
 DMXTrigger::DMXTrigger(Context *context,
                        const SlotVector &actions)
     : m_context(context),
-      m_slots(actions) {
-  sort(m_slots.begin(), m_slots.end());
+      m_slots(actions),
+      m_slot_index(ola::DMX_UNIVERSE_SIZE + 1),
+      m_last_size(0) {
+  sort(m_slots.begin(), m_slots.end(), SlotLessThan);
+
+  unsigned int index = 0;
+  for (unsigned int offset = 0; offset <= ola::DMX_UNIVERSE_SIZE; offset++) {
+    while (index < m_slots.size() && m_slots[index]->SlotOffset() < offset) {
+      index++;
+    }
+    m_slot_index[offset] = index;
+  }
+  memset(m_last_frame, 0, sizeof(m_last_frame));
 }
 
 
 /**
  * @brief Called when new DMX arrives.
+ *
+ * Most slots don't change from one frame to the next, so we compare 16 slots
+ * at a time against the previous frame and skip the blocks that are the
+ * same.
  */
 void DMXTrigger::NewDMX(const DmxBuffer &data) {
-  SlotVector::iterator iter = m_slots.begin();
-  for (; iter != m_slots.end(); iter++) {
-    uint16_t slot_number = (*iter)->SlotOffset();
-    if (slot_number >= data.Size()) {
-      // the DMX frame was too small
-      break;
+  const unsigned int size = data.Size();
+  if (!size) {
+    return;
+  }
+  const uint8_t *frame = data.GetRaw();
+  const unsigned int compare_size = std::min(size, m_last_size);
+
+  unsigned int offset = 0;
+  for (; offset + BLOCK_SIZE <= compare_size; offset += BLOCK_SIZE) {
+    uint32_t changed = ChangedSlots(frame + offset, m_last_frame + offset);
+    while (changed) {
+      unsigned int slot = offset + __builtin_ctz(changed);
+      SlotChanged(slot, frame[slot]);
+      changed &= changed - 1;
+    }
+  }
+
+  for (; offset < compare_size; offset++) {
+    if (frame[offset] != m_last_frame[offset]) {
+      SlotChanged(offset, frame[offset]);
     }
-    (*iter)->TakeAction(m_context, data.Get(slot_number));
+  }
+
+  // Slots we haven't seen before
+  for (; offset < size; offset++) {
+    SlotChanged(offset, frame[offset]);
+  }
+
+  memcpy(m_last_frame, frame, size);
+  m_last_size = std::max(m_last_size, size);
+}
+
+
+/**
+ * @brief Pass the new value to the Slots for an offset.
+ */
+void DMXTrigger::SlotChanged(unsigned int offset, uint8_t value) {
+  for (unsigned int i = m_slot_index[offset]; i < m_slot_index[offset + 1];
+       i++) {
+    m_slots[i]->TakeAction(m_context, value);
   }
 }
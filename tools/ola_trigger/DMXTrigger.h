@@ -21,13 +21,18 @@
 #ifndef TOOLS_OLA_TRIGGER_DMXTRIGGER_H_
 #define TOOLS_OLA_TRIGGER_DMXTRIGGER_H_
 
+#include <ola/Constants.h>
 #include <ola/DmxBuffer.h>
+#include <stdint.h>
 #include <vector>
 
 #include "tools/ola_trigger/Action.h"
 
 /*
  * @brief The class which manages the triggering.
+ *
+ * Each frame is compared with the previous one, and only the slots which
+ * changed are passed to their Slot objects.
  */
 class DMXTrigger {
  public:
@@ -41,5 +46,15 @@ class DMXTrigger {
  private:
   Context *m_context;
   SlotVector m_slots;  // kept sorted
+  // m_slot_index[i] is the index of the first Slot in m_slots with an
+  // offset >= i.
+  std::vector<unsigned int> m_slot_index;
+  // The last value received for each slot.
+  uint8_t m_last_frame[ola::DMX_UNIVERSE_SIZE];
+  // The size of the largest frame received, any slots after this haven't
+  // been seen yet.
+  unsigned int m_last_size;
+
+  void SlotChanged(unsigned int offset, uint8_t value);
 };
 #endif  // TOOLS_OLA_TRIGGER_DMXTRIGGER_H_
@@ -20,7 +20,10 @@
 
 #include <cppunit/extensions/HelperMacros.h>
 #include <ola/Logging.h>
+#include <ola/Constants.h>
 #include <ola/DmxBuffer.h>
+#include <ola/stl/STLUtils.h>
+#include <string.h>
 #include <vector>
 
 #include "tools/ola_trigger/Action.h"
@@ -37,11 +40,13 @@ class DMXTriggerTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(DMXTriggerTest);
   CPPUNIT_TEST(testRisingEdgeTrigger);
   CPPUNIT_TEST(testFallingEdgeTrigger);
+  CPPUNIT_TEST(testAllSlots);
   CPPUNIT_TEST_SUITE_END();
 
  public:
   void testRisingEdgeTrigger();
   void testFallingEdgeTrigger();
+  void testAllSlots();
 
   void setUp() {
     ola::InitLogging(ola::OLA_LOG_INFO, ola::OLA_LOG_STDERR);
@@ -159,3 +164,91 @@ void DMXTriggerTest::testFallingEdgeTrigger() {
   rising_action->CheckForValue(OLA_SOURCELINE(), 20);
   OLA_ASSERT(falling_action->NoCalls());
 }
+
+
+/**
+ * Check that only the slots which change trigger, with actions on every slot.
+ */
+void DMXTriggerTest::testAllSlots() {
+  vector<Slot*> slots;
+  vector<MockAction*> actions;
+  // add them in reverse order, DMXTrigger should sort them
+  for (int i = ola::DMX_UNIVERSE_SIZE - 1; i >= 0; i--) {
+    Slot *slot = new Slot(i);
+    MockAction *action = new MockAction();
+    slot->SetDefaultRisingAction(action);
+    slot->SetDefaultFallingAction(action);
+    slots.push_back(slot);
+    actions.insert(actions.begin(), action);
+  }
+  // and a second slot at offset 100
+  Slot *extra_slot = new Slot(100);
+  MockAction *extra_action = new MockAction();
+  extra_slot->SetDefaultRisingAction(extra_action);
+  slots.push_back(extra_slot);
+
+  Context context;
+  DMXTrigger trigger(&context, slots);
+  DmxBuffer buffer;
+  uint8_t frame[ola::DMX_UNIVERSE_SIZE];
+  memset(frame, 0, sizeof(frame));
+
+  // the first frame triggers every slot in the frame
+  frame[5] = 1;
+  buffer.Set(frame, 200);
+  trigger.NewDMX(buffer);
+  for (unsigned int i = 0; i < 200; i++) {
+    actions[i]->CheckForValue(OLA_SOURCELINE(), i == 5 ? 1 : 0);
+  }
+  extra_action->CheckForValue(OLA_SOURCELINE(), 0);
+
+  trigger.NewDMX(buffer);
+  for (unsigned int i = 0; i < ola::DMX_UNIVERSE_SIZE; i++) {
+    OLA_ASSERT(actions[i]->NoCalls());
+  }
+
+  // change a few slots, the end of the frame is new
+  frame[5] = 0;
+  frame[16] = 2;
+  frame[100] = 3;
+  frame[199] = 4;
+  buffer.Set(frame, sizeof(frame));
+  trigger.NewDMX(buffer);
+  actions[5]->CheckForValue(OLA_SOURCELINE(), 0);
+  actions[16]->CheckForValue(OLA_SOURCELINE(), 2);
+  actions[100]->CheckForValue(OLA_SOURCELINE(), 3);
+  extra_action->CheckForValue(OLA_SOURCELINE(), 3);
+  actions[199]->CheckForValue(OLA_SOURCELINE(), 4);
+  for (unsigned int i = 200; i < ola::DMX_UNIVERSE_SIZE; i++) {
+    actions[i]->CheckForValue(OLA_SOURCELINE(), 0);
+  }
+  for (unsigned int i = 0; i < ola::DMX_UNIVERSE_SIZE; i++) {
+    OLA_ASSERT(actions[i]->NoCalls());
+  }
+
+  // a short frame, then the full one again with the last slot changed
+  uint8_t short_frame[20];
+  memset(short_frame, 9, sizeof(short_frame));
+  buffer.Set(short_frame, sizeof(short_frame));
+  trigger.NewDMX(buffer);
+  for (unsigned int i = 0; i < 20; i++) {
+    actions[i]->CheckForValue(OLA_SOURCELINE(), 9);
+  }
+
+  memset(frame, 0, sizeof(frame));
+  frame[ola::DMX_UNIVERSE_SIZE - 1] = 255;
+  buffer.Set(frame, sizeof(frame));
+  trigger.NewDMX(buffer);
+  for (unsigned int i = 0; i < 20; i++) {
+    actions[i]->CheckForValue(OLA_SOURCELINE(), 0);
+  }
+  actions[100]->CheckForValue(OLA_SOURCELINE(), 0);
+  actions[199]->CheckForValue(OLA_SOURCELINE(), 0);
+  actions[ola::DMX_UNIVERSE_SIZE - 1]->CheckForValue(OLA_SOURCELINE(), 255);
+  for (unsigned int i = 0; i < ola::DMX_UNIVERSE_SIZE; i++) {
+    OLA_ASSERT(actions[i]->NoCalls());
+  }
+  OLA_ASSERT(extra_action->NoCalls());
+
+  ola::STLDeleteElements(&slots);
+}
@@ -16,6 +16,8 @@ lib_LTLIBRARIES += tools/ola_trigger/libolatrigger.la
 tools_ola_trigger_libolatrigger_la_SOURCES = \
     tools/ola_trigger/Action.cpp \
     tools/ola_trigger/Action.h \
+    tools/ola_trigger/CommandRunner.cpp \
+    tools/ola_trigger/CommandRunner.h \
     tools/ola_trigger/Context.cpp \
     tools/ola_trigger/Context.h \
     tools/ola_trigger/DMXTrigger.cpp \
@@ -61,6 +63,7 @@ test_programs += tools/ola_trigger/ActionTester
 
 tools_ola_trigger_ActionTester_SOURCES = \
     tools/ola_trigger/ActionTest.cpp \
+    tools/ola_trigger/CommandRunnerTest.cpp \
     tools/ola_trigger/ContextTest.cpp \
     tools/ola_trigger/DMXTriggerTest.cpp \
     tools/ola_trigger/IntervalTest.cpp \
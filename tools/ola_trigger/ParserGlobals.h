@@ -28,6 +28,9 @@
 // The context object
 extern class Context *global_context;
 
+// Runs the commands, may be NULL
+extern class CommandRunner *global_command_runner;
+
 // A map of slot offsets to SlotAction objects
 typedef std::map<uint16_t, class Slot*> SlotActionMap;
 extern SlotActionMap global_slots;
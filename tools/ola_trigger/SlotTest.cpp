@@ -35,6 +35,7 @@ class SlotTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testIntervalAddition);
   CPPUNIT_TEST(testActionMatching);
   CPPUNIT_TEST(testDefaultAction);
+  CPPUNIT_TEST(testActionAddedLater);
   CPPUNIT_TEST_SUITE_END();
 
  public:
@@ -42,6 +43,7 @@ class SlotTest: public CppUnit::TestFixture {
   void testIntervalAddition();
   void testActionMatching();
   void testDefaultAction();
+  void testActionAddedLater();
 
   void setUp() {
     ola::InitLogging(ola::OLA_LOG_INFO, ola::OLA_LOG_STDERR);
@@ -314,3 +316,27 @@ void SlotTest::testDefaultAction() {
   default_rising_action->DeRef();
   default_falling_action->DeRef();
 }
+
+
+/**
+ * Check that actions added after values have been received are used.
+ */
+void SlotTest::testActionAddedLater() {
+  Slot slot(0);
+  MockAction *default_action = new MockAction();
+  slot.SetDefaultRisingAction(default_action);
+
+  slot.TakeAction(NULL, 10);
+  default_action->CheckForValue(OLA_SOURCELINE(), 10);
+
+  MockAction *action = new MockAction();
+  OLA_ASSERT(slot.AddAction(ValueInterval(20, 30), action, NULL));
+
+  slot.TakeAction(NULL, 25);
+  OLA_ASSERT(default_action->NoCalls());
+  action->CheckForValue(OLA_SOURCELINE(), 25);
+
+  slot.TakeAction(NULL, 31);
+  default_action->CheckForValue(OLA_SOURCELINE(), 31);
+  OLA_ASSERT(action->NoCalls());
+}
@@ -38,10 +38,12 @@
 
 #include <iostream>
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "tools/ola_trigger/Action.h"
+#include "tools/ola_trigger/CommandRunner.h"
 #include "tools/ola_trigger/Context.h"
 #include "tools/ola_trigger/DMXTrigger.h"
 #include "tools/ola_trigger/ParserGlobals.h"
@@ -59,12 +61,20 @@ DEFINE_s_uint16(offset, o, 0,
 DEFINE_s_uint32(universe, u, 0, "The universe to use, defaults to 0.");
 DEFINE_default_bool(validate, false,
                     "Validate the config file, rather than running it.");
+DEFINE_uint16(command_workers, 1,
+              "The number of threads used to start commands. If 0, commands "
+              "are started from the DMX thread. With more than one thread, "
+              "commands may start out of order.");
+DEFINE_uint16(command_queue_size, 64,
+              "The maximum number of commands waiting to start, any more are "
+              "dropped.");
 
 // prototype of bison-generated parser function
 int yyparse();
 
 // globals modified by the config parser
 Context *global_context;
+CommandRunner *global_command_runner = NULL;
 SlotActionMap global_slots;
 
 // The SelectServer to kill when we catch SIGINT
@@ -184,6 +194,15 @@ int main(int argc, char *argv[]) {
 
   // setup the default context
   global_context = new Context();
+
+#ifndef _WIN32
+  std::auto_ptr<CommandRunner> command_runner;
+  if (FLAGS_command_workers && !FLAGS_validate) {
+    command_runner.reset(new CommandRunner(FLAGS_command_workers,
+                                           FLAGS_command_queue_size));
+    global_command_runner = command_runner.get();
+  }
+#endif  // _WIN32
   OLA_INFO << "Loading config from " << config_file;
 
   // open the config file
@@ -222,6 +241,10 @@ int main(int argc, char *argv[]) {
     exit(ola::EXIT_OSERR);
   }
 
+  if (global_command_runner && !global_command_runner->Init()) {
+    exit(ola::EXIT_OSERR);
+  }
+
   // create the vector of Slot
   SlotList slots;
   if (ApplyOffset(FLAGS_offset, &slots)) {
@@ -240,6 +263,15 @@ int main(int argc, char *argv[]) {
     wrapper.GetSelectServer()->Run();
   }
 
+  if (global_command_runner) {
+    global_command_runner->Stop();
+    CommandRunner::Stats stats;
+    global_command_runner->GetStats(&stats);
+    OLA_INFO << "Started " << stats.started << " commands, " << stats.failed
+             << " failed, " << stats.dropped << " dropped, max queue depth "
+             << stats.max_queued;
+  }
+
   // cleanup
   STLDeleteElements(&slots);
 }